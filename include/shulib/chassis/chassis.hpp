@@ -147,12 +147,14 @@
 
 #include "shulib/control/exit_group.hpp"
 #include "shulib/control/feedforward.hpp"
+#include "shulib/control/wheel_velocity_loop.hpp"
 #include "shulib/core/check.hpp"
 #include "shulib/hal/clock.hpp"
 #include "shulib/diag/debug_record.hpp"
 #include "shulib/math/frame.hpp"
 #include "shulib/math/pose2d.hpp"
 #include "shulib/math/twist2d.hpp"
+#include "shulib/motion/command_limiter.hpp"
 #include "shulib/motion/command_pipeline.hpp"
 #include "shulib/motion/drive_brake.hpp"
 #include "shulib/motion/hold_pose.hpp"
@@ -243,7 +245,11 @@ public:
     /// facade borrows, it does not own (header: construction).
     explicit Chassis(const motion::MotionDeps& deps, motion::ITickPacer& pacer,
                      const ChassisConfig& config = {})
-        : sched_{deps, pacer, config.scheduler}, cfg_{config.motion}, ff_{config.motion.wheelFf} {
+        : sched_{deps, pacer, config.scheduler},
+          cfg_{config.motion},
+          ff_{config.motion.wheelFf},
+          wheelLoop_{config.motion.wheelLoop, deps.validatedClock()},
+          limiter_{config.motion.limiter, deps.ctx->clock(), config.motion.rotationRadius} {
         cfg_.validate();
     }
 
@@ -390,6 +396,14 @@ public:
         if (sched_.hasActiveMotion()) {
             sched_.cancel();  // pre-empt: a manual command supersedes, safely (C2)
         }
+        if (sched_.motionsStarted() != motionsAtLastDrive_) {
+            // A motion had the drivetrain since the last drive(): this call starts a new
+            // stream. The loop's integrators and the limiter's last output belong to the old
+            // one — a motion shorter than the limiter's gap would not re-seed it on its own.
+            wheelLoop_.reset();
+            limiter_.reset();
+            motionsAtLastDrive_ = sched_.motionsStarted();
+        }
         const motion::MotionDeps& d = sched_.deps();
         d.localizer->update();  // the estimate advances FIRST (the loop shape)
         const units::Time now = d.ctx->clock().now();
@@ -416,10 +430,11 @@ public:
         warnedFieldDriveUninit_ = false;  // live again: re-arm the once-per-window warn
 
         const motion::CommandOutcome out =
-            motion::applyCommandPipeline(d, cfg_, ff_, speeds, frame, pose.heading());
+            motion::applyCommandPipeline(d, cfg_, ff_, speeds, frame, pose.heading(), &wheelLoop_,
+                                         &limiter_);
         motion::tickHealthObservables(d, false);
         emitDriveRecord(now, dt, pose, math::robotToField(out.body, pose.heading()),
-                        out.strafeFallback);
+                        out.strafeFallback, true);
     }
 
     // ── control ────────────────────────────────────────────────────────────────────
@@ -560,7 +575,8 @@ private:
     /// fields stay their quiet defaults (the record must not invent). Lazy
     /// via emitRecord (A1 cost contract); rides the stamped sink with id 0.
     void emitDriveRecord(units::Time now, units::Time dt, const math::Pose2d& pose,
-                         const math::ChassisSpeeds& commandedField, bool strafeFallback) {
+                         const math::ChassisSpeeds& commandedField, bool strafeFallback,
+                         bool piped = false) {
         const motion::MotionDeps& d = sched_.deps();
         RobotContext& ctx = *d.ctx;
         const localization::Localizer& loc = *d.localizer;
@@ -580,6 +596,9 @@ private:
                 r.wheelVoltage[i] = motors[i]->commandedVoltage();
                 r.wheelCurrent[i] = motors[i]->current();
             }
+            if (piped) {
+                motion::stampWheelTracking(r, wheelLoop_);
+            }
             r.imuYaw = ctx.imu().heading();
             r.imuYawRate = ctx.imu().yawRate();
             r.deadReckoning = loc.isDeadReckoning();
@@ -593,9 +612,17 @@ private:
     motion::MotionScheduler sched_;
     motion::MotionConfig cfg_;
     control::Feedforward ff_;
+    /// drive()'s inner per-wheel loop. It persists across drive() calls (teleop is one long
+    /// stream) and is reset when a motion — blocking verb or scheduler().async — has had the
+    /// drivetrain since the last one: a new stream starts from zero integrators.
+    control::WheelVelocityLoop wheelLoop_;
+    /// drive()'s rate limiter, persistent and reset the same way: after a gap or a reset it
+    /// re-seeds from the robot's measured motion instead of ramping from a stale command.
+    motion::CommandLimiter limiter_;
     bool warnedFieldDriveUninit_ = false;
     bool hasDriveTick_ = false;
     double lastDriveTime_ = 0.0;
+    int motionsAtLastDrive_ = 0;  // sched_.motionsStarted() as drive() last saw it
 };
 
 }  // namespace shulib::chassis
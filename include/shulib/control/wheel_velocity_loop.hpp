@@ -0,0 +1,195 @@
+#pragma once
+//
+// WheelVelocityLoop — the optional INNER per-wheel velocity loop: feedforward plus PI on the
+// wheel's measured surface speed, run once per tick underneath the outer per-axis pose PIDs.
+//
+// ── Why it exists ───────────────────────────────────────────────────────────────────
+// Without it the command pipeline ends open-loop per wheel: Feedforward → battery ceiling →
+// setVoltage. Whatever the feedforward gets wrong — friction that differs wheel to wheel, a
+// load, a thermally throttled motor, kV measured on a different day — becomes wheel-speed
+// error. The robot then drives a slightly different twist than the one commanded, and the
+// outer PIDs see it only as POSE error, one tick later and through the estimator. This loop
+// closes the gap where it starts: each wheel's own encoder speed against that wheel's own
+// target, every tick. The outer loops then correct only what the wheels cannot.
+//
+// ── The law (per wheel i, volts) ────────────────────────────────────────────────────
+//   e_i  = target_i − measured_i                          (in/s, wheel surface speed)
+//   u_i  = ff_i + clamp(kP·e_i + I_i, ±correctionLimit)
+//   I_i += kI·e_i·dt                                      (subject to the anti-windup below)
+// ff_i is the caller's Feedforward for the same target, so with the loop disabled u_i = ff_i
+// EXACTLY — the disabled loop is a bit-identical pass-through, and that is what lets it sit
+// in the one shared command pipeline without moving any existing suite.
+//
+// ── Anti-windup, tied to the two ceilings the pipeline already has ──────────────────
+//   * BATTERY CEILING: I_i is back-calculated into the band that keeps ff_i + P_i + I_i
+//     inside ±battery. The band always contains 0, so saturation can shrink the integrator
+//     but never flip its sign. An integrator cannot store volts the pack cannot deliver.
+//   * DESATURATION: when ANY wheel's total would exceed the battery in the direction its
+//     error pushes, integration FREEZES ON EVERY WHEEL for that tick. This is the integral
+//     form of kinematics::desaturate's uniform scale. If one wheel is starved and the others
+//     keep integrating, the wheel-speed RATIOS skew, and a ratio error is a curved path.
+//   * correctionLimit bounds P + I together. It is the damage cap for a lying encoder: a dead
+//     one reads 0, so the loop sees a wheel that never moves and would otherwise push it to
+//     the rail.
+// A tick with dt <= 0 or dt > kMaxIntegrationDt (the first tick, or a gap — a drive()
+// stream that stalled) applies P only; the facade also resets its loop when a motion has
+// had the drivetrain in between. A non-finite target or
+// measurement leaves that wheel on its feedforward alone, with its integrator untouched.
+//
+// ── What it cannot fix (said plainly) ───────────────────────────────────────────────
+// The measurement is the drive ENCODER, which reads the wheel's SPIN, not the floor. Under
+// slip the wheel is already turning at its target while the robot undershoots, so this
+// loop cannot see slip, let alone correct it. That is the tracking wheels' and the outer
+// loops' job. Its win is load, friction, thermal droop and feedforward mismatch: everything
+// that makes the SPIN wrong.
+//
+// Units: gains are bare doubles like Pid's, with their units beside them; speeds and volts
+// are typed at the boundary. Single-task by contract. Stateful — reset() between motions.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+
+#include "shulib/core/check.hpp"
+#include "shulib/hal/clock.hpp"
+#include "shulib/kinematics/wheel_speeds.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::control {
+
+/// The inner loop's knobs. Disabled by default, so a config that never mentions it keeps the
+/// open-loop pipeline bit-for-bit. The gains describe ONE wheel against its surface speed,
+/// like FeedforwardGains. PROVISIONAL (A4: HA-126) — tuned on the A2 plant, not a robot.
+struct WheelVelocityLoopConfig {
+    /// Off ⇒ the loop returns the feedforward unchanged and only MEASURES the tracking error.
+    bool enabled = false;
+    /// Volt·s/in — volts per in/s of wheel-speed error. PROVISIONAL (A4: HA-126).
+    double kP = 0.05;
+    /// Volt/in — volts per inch of accumulated wheel-speed error. PROVISIONAL (A4: HA-126).
+    double kI = 1.0;
+    /// Symmetric cap on the correction (P + I) in volts, and on the integrator alone. The
+    /// damage bound for a lying encoder (header note). Must be >= 0. PROVISIONAL (A4: HA-126).
+    units::Voltage correctionLimit{3.0};
+};
+
+/// The per-wheel FF + PI inner velocity loop (header note). One instance serves a whole
+/// drivetrain and keeps one integrator per wheel; dt comes from the injected clock, as Pid's
+/// does.
+class WheelVelocityLoop {
+public:
+    /// Per-wheel capacity, tied to the kinematics contract.
+    static constexpr int kMaxWheels = kinematics::WheelSpeeds::kMaxWheels;
+    /// A tick longer than this (seconds) is a gap, not an interval to integrate over (header
+    /// note). Ten 100 Hz ticks. A host-decidable guard, not a hardware magnitude.
+    static constexpr double kMaxIntegrationDt = 0.1;
+
+    /// `config` is copied; `clock` is NON-OWNING and must outlive the loop. Rejects non-finite
+    /// or negative gains and a negative or non-finite correctionLimit.
+    WheelVelocityLoop(const WheelVelocityLoopConfig& config, hal::IClock& clock)
+        : cfg_{config}, clock_{clock} {
+        SHULIB_PRECONDITION(std::isfinite(cfg_.kP) && std::isfinite(cfg_.kI)
+                                && cfg_.kP >= 0.0 && cfg_.kI >= 0.0,
+                            "WheelVelocityLoop: kP and kI must be finite and >= 0");
+        SHULIB_PRECONDITION(std::isfinite(cfg_.correctionLimit.value())
+                                && cfg_.correctionLimit.value() >= 0.0,
+                            "WheelVelocityLoop: correctionLimit must be finite and >= 0");
+    }
+
+    /// One tick for every wheel at once: `target`, `measured` and `ff` are per wheel (same
+    /// length, at most kMaxWheels); the commanded volts land in `out` (the same length). The
+    /// result is NOT yet battery-clamped — the pipeline's compensateForBattery stays the final
+    /// ceiling. Disabled: `out` = `ff` exactly, and the errors are still recorded.
+    void update(std::span<const units::Velocity> target, std::span<const units::Velocity> measured,
+                std::span<const units::Voltage> ff, units::Voltage battery,
+                std::span<units::Voltage> out) {
+        SHULIB_PRECONDITION(target.size() == measured.size() && target.size() == ff.size()
+                                && target.size() == out.size()
+                                && target.size() <= static_cast<std::size_t>(kMaxWheels),
+                            "WheelVelocityLoop::update: span sizes must match and be <= kMaxWheels");
+        const double now = clock_.now().value();
+        const double dt = hasPrev_ ? now - lastTime_ : 0.0;
+        hasPrev_ = true;
+        lastTime_ = now;
+        const bool integrate = dt > 0.0 && dt <= kMaxIntegrationDt;
+        const double vb = std::abs(battery.value());
+        const double lim = cfg_.correctionLimit.value();
+        n_ = static_cast<int>(target.size());
+
+        std::array<bool, static_cast<std::size_t>(kMaxWheels)> usable{};
+        std::array<double, static_cast<std::size_t>(kMaxWheels)> p{};
+        bool anySaturated = false;
+        for (std::size_t i = 0; i < target.size(); ++i) {
+            const double e = target[i].value() - measured[i].value();
+            usable[i] = std::isfinite(e);
+            error_[i] = usable[i] ? e : 0.0;
+            if (!cfg_.enabled || !usable[i]) {
+                continue;
+            }
+            p[i] = cfg_.kP * e;
+            const double trial = std::clamp(integral_[i] + cfg_.kI * e * (integrate ? dt : 0.0),
+                                            -lim, lim);
+            const double u = ff[i].value() + std::clamp(p[i] + trial, -lim, lim);
+            // Saturated in the direction the error pushes: integrating further only winds up.
+            anySaturated = anySaturated || (std::abs(u) > vb && u * e > 0.0);
+        }
+
+        for (std::size_t i = 0; i < target.size(); ++i) {
+            if (!cfg_.enabled || !usable[i]) {
+                out[i] = ff[i];  // the bit-identical pass-through (header note)
+                continue;
+            }
+            const double f = ff[i].value();
+            double integ = integral_[i];
+            if (integrate && !anySaturated) {
+                integ += cfg_.kI * error_[i] * dt;
+            }
+            // Back-calculation into the battery band — a band that always contains 0.
+            const double hi = std::max(0.0, vb - f - p[i]);
+            const double lo = std::min(0.0, -vb - f - p[i]);
+            integ = std::clamp(std::clamp(integ, lo, hi), -lim, lim);
+            integral_[i] = integ;
+            out[i] = units::Voltage{f + std::clamp(p[i] + integ, -lim, lim)};
+        }
+        saturated_ = anySaturated;
+    }
+
+    /// Clear every integrator and the dt baseline (between motions). Gains unchanged.
+    void reset() noexcept {
+        integral_ = {};
+        error_ = {};
+        hasPrev_ = false;
+        saturated_ = false;
+    }
+
+    /// Wheel `i`'s tracking error (target − measured, in/s) as of the last update(); 0 for a
+    /// wheel whose inputs were non-finite, before the first update() and after reset().
+    [[nodiscard]] units::Velocity trackingError(int i) const {
+        SHULIB_PRECONDITION(i >= 0 && i < kMaxWheels, "WheelVelocityLoop: wheel out of range");
+        return units::Velocity{error_[static_cast<std::size_t>(i)]};
+    }
+    /// Wheel `i`'s integrator, in volts (already the I-term — not error·seconds).
+    [[nodiscard]] units::Voltage integral(int i) const {
+        SHULIB_PRECONDITION(i >= 0 && i < kMaxWheels, "WheelVelocityLoop: wheel out of range");
+        return units::Voltage{integral_[static_cast<std::size_t>(i)]};
+    }
+    /// Wheels covered by the last update().
+    [[nodiscard]] int wheelCount() const noexcept { return n_; }
+    /// True iff the last update() froze integration because a wheel hit the battery ceiling.
+    [[nodiscard]] bool saturated() const noexcept { return saturated_; }
+    /// The configuration this loop was built with.
+    [[nodiscard]] const WheelVelocityLoopConfig& config() const noexcept { return cfg_; }
+
+private:
+    WheelVelocityLoopConfig cfg_;
+    hal::IClock& clock_;
+    std::array<double, static_cast<std::size_t>(kMaxWheels)> integral_{};
+    std::array<double, static_cast<std::size_t>(kMaxWheels)> error_{};
+    double lastTime_ = 0.0;
+    int n_ = 0;
+    bool hasPrev_ = false;
+    bool saturated_ = false;
+};
+
+}  // namespace shulib::control
@@ -0,0 +1,507 @@
+#pragma once
+//
+// The COMPACT TICK STREAM — blackbox format v2's tick encoding: delta frames against the
+// previous tick, with periodic keyframes (diag/blackbox_format.hpp for the file around it).
+//
+// ── Why it exists ───────────────────────────────────────────────────────────────────
+// A v1 tick is 428 bytes of binary64, every tick, whatever changed. sd_sink.hpp states
+// the consequence: a default 200-tick dump is ~87 KB and does not fit the 64 KiB staging
+// buffer (~102 KB with the opt-in estimator inputs), and streaming a whole run is out of
+// the question at competition — which is why streamTicks is off there. But consecutive
+// ticks are nearly the same record: the pose moves by a fraction of an inch, half the
+// wheel and phase slots are constant zeros, the integer block changes a few times per run.
+// Encoding what CHANGED, not what IS, is where the bytes are. Tick frames only: an
+// EstimatorInputs frame (sd_sink.hpp, opt-in) is written beside them as it is,
+// uncompressed.
+//
+// ── The codec works on the v1 BYTES, and that is the whole correctness argument ───────
+// A tick is first encoded with encodeTick() exactly as v1 writes it. The v1 payload is a
+// sequence of 51 binary64 fields and 5 little-endian u32 words (the integer block at
+// offsets 112–131: wheelCount/state/deadReckon/qualityClass, activeCommandId,
+// fault/gateReason/flags, droppedRecords, droppedLines). A delta frame carries each of
+// those against the same field of the previous tick:
+//   * WORDS: the wrapping u32 difference, zigzag-mapped and written as a LEB128 varint
+//     (one byte for "unchanged", which is nearly every tick);
+//   * FLOATS: XOR of the bit patterns, Gorilla-style (Pelkonen et al., VLDB 2015) — one
+//     bit for "unchanged"; otherwise the meaningful bits between the leading and trailing
+//     zeros, reusing the field's previous window when the new bits fit inside it.
+// The decoder rebuilds the v1 bytes and hands them to decodeTick(). So the output is
+// lossless BIT FOR BIT — NaN payloads, signed zeros and infinities included — and the
+// v1 promise "decoded equals encoded, field by field" holds for v2 with no new argument:
+// the v2 round trip IS the v1 round trip plus an exact byte reconstruction. REJECTED:
+// a per-field codec over DebugRecord directly (a second field list to keep in step with
+// debug_record.hpp, and a second place for a field to go missing).
+//
+//   TickKey   payload:  u16 seq | 428 bytes of v1 tick
+//   TickDelta payload:  u16 seq | 5 × varint(zigzag(Δword)) | bitstream, MSB-first,
+//                       zero-padded to a byte — per float field:
+//                         0                          unchanged
+//                         1 0 <n bits>               XOR fits the previous window (n = its width)
+//                         1 1 <5b lead> <6b len-1> <len bits>   a new window
+// The leading-zero count saturates at 31 (5 bits), as in Gorilla. A delta that would not
+// come out SMALLER than a keyframe is written as a keyframe instead, so compact is never
+// worse than v1 by more than the 2-byte sequence.
+//
+// ── Keyframes, and refusing a broken chain ──────────────────────────────────────────
+// A delta is meaningless without the tick before it, and files lose frames: the sink
+// drops a frame that does not fit the budget, a device write can fail, a card can be
+// pulled mid-run. So every frame carries a u16 chain SEQUENCE, and a delta is decoded
+// ONLY if its sequence is exactly one past the last tick the decoder reconstructed.
+// Anything else is counted as unresolved and NOT decoded — refuse, never misread — until
+// the next keyframe restarts the chain. Keyframes come every kDefaultKeyframeInterval
+// ticks, which bounds what one lost frame can cost. The encoder only advances its chain
+// when the caller confirms the frame was staged (commit()), so a frame the sink drops
+// whole never leaves the reader's reference behind the writer's; a device failure, which
+// loses frames already committed, restarts the chain (restartChain()).
+//
+// ── Cost ────────────────────────────────────────────────────────────────────────────
+// Per tick: one v1 encode into scratch, 56 XOR/difference operations, and a bit writer.
+// The measured figures (compression ratio on a closed-loop sim run, host encode time per
+// tick) live in test/blackbox_compact_test.cpp and are reported, not asserted, for the
+// time half — host nanoseconds say little about the brain. State is ~1.5 KB per encoder
+// (the previous tick, the pending tick, the scratch frame, per-field windows), held
+// inside the SdSink that owns it. Allocation-free, never throws.
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "shulib/core/check.hpp"
+#include "shulib/diag/blackbox_format.hpp"
+#include "shulib/diag/debug_record.hpp"
+
+namespace shulib::diag::blackbox {
+
+/// The binary64 fields of a v1 tick payload: 14 before the integer block, 37 after.
+inline constexpr std::size_t kCompactFloatFields = 51;
+/// The little-endian u32 words of a v1 tick payload's integer block (offsets 112–131).
+inline constexpr std::size_t kCompactWordFields = 5;
+/// Smallest possible TickDelta payload: the sequence, one varint byte per word, and one
+/// bit per float field.
+inline constexpr std::size_t kTickDeltaMinPayloadBytes =
+    2 + kCompactWordFields + (kCompactFloatFields + 7) / 8;
+
+/// A keyframe at least every 50 ticks (0.5 s at a 100 Hz loop): one lost frame costs at
+/// most half a second of ticks, for under 1 KB/s of keyframe overhead when streaming.
+/// PROVISIONAL (A4: HA-128) — INVENTED; R4 settles it against the real loss rate.
+inline constexpr std::size_t kDefaultKeyframeInterval = 50;
+
+namespace compact_detail {
+
+/// Offset of the integer block inside a v1 tick payload.
+inline constexpr std::size_t kWordBlockOffset = 112;
+/// Float fields that precede the integer block.
+inline constexpr std::size_t kFloatsBeforeWords = 14;
+/// A Windows slot with no window yet (after a keyframe).
+inline constexpr std::uint8_t kNoWindow = 0xFFU;
+
+/// Byte offset of float field `i` inside a v1 tick payload.
+[[nodiscard]] constexpr std::size_t floatOffset(std::size_t i) noexcept {
+    return i < kFloatsBeforeWords
+               ? 8 * i
+               : kWordBlockOffset + 4 * kCompactWordFields + 8 * (i - kFloatsBeforeWords);
+}
+
+static_assert(floatOffset(kCompactFloatFields - 1) + 8 == kTickPayloadBytes,
+              "the compact field map must cover the v1 tick payload exactly");
+
+/// Load an `n`-byte little-endian value straight from v1 payload bytes.
+[[nodiscard]] inline std::uint64_t loadLe(const std::byte* p, std::size_t n) noexcept {
+    std::uint64_t v = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        v |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+    }
+    return v;
+}
+/// Store the low `n` bytes of `v` little-endian into v1 payload bytes.
+inline void storeLe(std::byte* p, std::size_t n, std::uint64_t v) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        p[i] = static_cast<std::byte>((v >> (8 * i)) & 0xFFU);
+    }
+}
+
+/// MSB-first bit writer with ByteWriter's hard end: an append that would not fit writes
+/// nothing and latches overflow. Bytes are zeroed as they are entered, so the final
+/// partial byte is zero-padded.
+class BitWriter {
+public:
+    /// Write into `out`, starting at its first bit.
+    explicit BitWriter(std::span<std::byte> out) noexcept : out_{out} {}
+
+    /// Append the low `n` bits of `v` (n ≤ 64), most significant first.
+    void bits(std::uint64_t v, unsigned n) noexcept {
+        if (overflow_ || at_ + n > 8 * out_.size()) {
+            overflow_ = true;
+            return;
+        }
+        while (n > 0) {  // a byte-sized chunk at a time: at most 9 steps for 64 bits
+            const auto used = static_cast<unsigned>(at_ % 8);
+            if (used == 0) {
+                out_[at_ / 8] = std::byte{0};
+            }
+            const unsigned take = n < 8 - used ? n : 8 - used;
+            const auto chunk = static_cast<unsigned>((v >> (n - take)) & ((1U << take) - 1U));
+            out_[at_ / 8] |= static_cast<std::byte>(chunk << (8 - used - take));
+            n -= take;
+            at_ += take;
+        }
+    }
+    /// Bytes touched so far, the last one possibly partial.
+    [[nodiscard]] std::size_t bytes() const noexcept { return (at_ + 7) / 8; }
+    /// False once any append did not fit.
+    [[nodiscard]] bool ok() const noexcept { return !overflow_; }
+
+private:
+    std::span<std::byte> out_;
+    std::size_t at_ = 0;
+    bool overflow_ = false;
+};
+
+/// MSB-first bit reader with ByteReader's hard end: a read past the end yields zero and
+/// latches exhaustion.
+class BitReader {
+public:
+    /// Read from `in`, starting at its first bit.
+    explicit BitReader(std::span<const std::byte> in) noexcept : in_{in} {}
+
+    /// Read `n` bits (n ≤ 64), most significant first (0 past the end).
+    [[nodiscard]] std::uint64_t bits(unsigned n) noexcept {
+        if (exhausted_ || at_ + n > 8 * in_.size()) {
+            exhausted_ = true;
+            return 0U;
+        }
+        std::uint64_t v = 0;
+        while (n > 0) {
+            const auto used = static_cast<unsigned>(at_ % 8);
+            const unsigned take = n < 8 - used ? n : 8 - used;
+            const auto byte = static_cast<unsigned>(in_[at_ / 8]);
+            v = (v << take) | ((byte >> (8 - used - take)) & ((1U << take) - 1U));
+            n -= take;
+            at_ += take;
+        }
+        return v;
+    }
+    /// Bytes touched so far, the last one possibly partial.
+    [[nodiscard]] std::size_t bytes() const noexcept { return (at_ + 7) / 8; }
+    /// False once any read ran past the end.
+    [[nodiscard]] bool ok() const noexcept { return !exhausted_; }
+
+private:
+    std::span<const std::byte> in_;
+    std::size_t at_ = 0;
+    bool exhausted_ = false;
+};
+
+/// Write `v` as an unsigned LEB128 varint (1–5 bytes).
+inline void varint(ByteWriter& w, std::uint32_t v) noexcept {
+    while (v >= 0x80U) {
+        w.u8(static_cast<std::uint8_t>((v & 0x7FU) | 0x80U));
+        v >>= 7;
+    }
+    w.u8(static_cast<std::uint8_t>(v));
+}
+
+/// Read an unsigned LEB128 varint. More than 5 bytes, or a 5th byte carrying bits past
+/// 32, is corruption: `bad` is raised and the value is meaningless.
+[[nodiscard]] inline std::uint32_t varint(ByteReader& r, bool& bad) noexcept {
+    std::uint32_t v = 0;
+    for (unsigned i = 0; i < 5; ++i) {
+        const std::uint8_t b = r.u8();
+        if (i == 4 && (b & 0xF0U) != 0U) {
+            bad = true;
+            return 0U;
+        }
+        v |= static_cast<std::uint32_t>(b & 0x7FU) << (7 * i);
+        if ((b & 0x80U) == 0U) {
+            return v;
+        }
+    }
+    bad = true;
+    return 0U;
+}
+
+/// Zigzag: small differences of either sign become small unsigned values. The input is
+/// the WRAPPING u32 difference, so every word delta round-trips exactly.
+[[nodiscard]] constexpr std::uint32_t zigzag(std::uint32_t d) noexcept {
+    return (d << 1) ^ (0U - (d >> 31));
+}
+/// The inverse of zigzag().
+[[nodiscard]] constexpr std::uint32_t unzigzag(std::uint32_t z) noexcept {
+    return (z >> 1) ^ (0U - (z & 1U));
+}
+
+/// Per-float-field Gorilla windows: leading- and trailing-zero counts of the last new
+/// window, kNoWindow until the chain has one.
+struct Windows {
+    std::array<std::uint8_t, kCompactFloatFields> lead{};   ///< leading zeros per field
+    std::array<std::uint8_t, kCompactFloatFields> trail{};  ///< trailing zeros per field
+    /// Forget every window (a keyframe).
+    void clear() noexcept {
+        lead.fill(kNoWindow);
+        trail.fill(kNoWindow);
+    }
+};
+
+}  // namespace compact_detail
+
+/// The encoder half of the compact tick stream (header note). Stateful: it carries the
+/// previous tick of its chain. Two steps per tick, because the chain may only advance
+/// when the frame actually reached the file: encode() builds the frame into internal
+/// scratch WITHOUT advancing, and commit() advances once the caller has staged it. A
+/// frame that is dropped simply never commits, and the next tick is encoded against the
+/// same reference. Allocation-free, never throws; one per SdSink.
+class CompactTickEncoder {
+public:
+    /// One encoded frame: its type (TickKey or TickDelta) and a view of its payload in
+    /// the encoder's scratch, valid until the next encode(). An empty payload means the
+    /// record could not be encoded at all.
+    struct Encoded {
+        FrameType type = FrameType::TickKey;        ///< TickKey or TickDelta
+        std::span<const std::byte> payload{};       ///< the frame payload (empty on failure)
+    };
+
+    /// `keyframeInterval` ≥ 1: a keyframe at least every that many committed ticks
+    /// (1 ⇒ every tick is a keyframe).
+    explicit CompactTickEncoder(std::size_t keyframeInterval = kDefaultKeyframeInterval)
+        : interval_{keyframeInterval} {
+        SHULIB_PRECONDITION(keyframeInterval >= 1,
+                            "CompactTickEncoder: the keyframe interval must be at least 1");
+        pendingWin_.clear();
+        win_.clear();
+    }
+
+    /// Encode `r` as the next frame of the chain. Does NOT advance the chain — call
+    /// commit() once the frame is in the file.
+    [[nodiscard]] Encoded encode(const DebugRecord& r) noexcept {
+        pendingKey_ = false;
+        if (encodeTick(cur_, r) != kTickPayloadBytes) {
+            return Encoded{};
+        }
+        const auto seq = static_cast<std::uint16_t>(seq_ + 1U);
+        if (chained_ && sinceKey_ + 1 < interval_) {
+            const std::size_t n = encodeDelta(seq);
+            if (n != 0) {
+                return Encoded{FrameType::TickDelta, std::span<const std::byte>{scratch_}.first(n)};
+            }
+        }
+        // A keyframe: the sequence, then the v1 bytes verbatim.
+        ByteWriter w{scratch_};
+        w.u16(seq);
+        for (const std::byte b : cur_) {
+            w.u8(static_cast<std::uint8_t>(b));
+        }
+        pendingKey_ = true;
+        pendingWin_.clear();
+        return Encoded{FrameType::TickKey, std::span<const std::byte>{scratch_}};
+    }
+
+    /// The frame encode() last returned reached the file: advance the chain to it.
+    void commit() noexcept {
+        ref_ = cur_;
+        win_ = pendingWin_;
+        seq_ = static_cast<std::uint16_t>(seq_ + 1U);
+        sinceKey_ = pendingKey_ ? 0 : sinceKey_ + 1;
+        // A keyframe starts a chain; a delta only continues one. If restartChain() ran
+        // between encode() and commit() (a flush inside the same staging call failed),
+        // the delta just committed follows a gap, and the NEXT frame must be a keyframe.
+        chained_ = chained_ || pendingKey_;
+        if (pendingKey_) {
+            ++keyframes_;
+        } else {
+            ++deltas_;
+        }
+    }
+
+    /// Frames already committed were LOST (a failed device write): the reader can no
+    /// longer follow this chain, so the next frame is a keyframe.
+    void restartChain() noexcept { chained_ = false; }
+
+    /// Keyframes committed so far.
+    [[nodiscard]] std::uint32_t keyframes() const noexcept { return keyframes_; }
+    /// Delta frames committed so far.
+    [[nodiscard]] std::uint32_t deltas() const noexcept { return deltas_; }
+    /// The configured keyframe interval.
+    [[nodiscard]] std::size_t keyframeInterval() const noexcept { return interval_; }
+
+private:
+    /// Build a delta frame into scratch; 0 if it would not come out smaller than a
+    /// keyframe (the caller then writes a keyframe).
+    [[nodiscard]] std::size_t encodeDelta(std::uint16_t seq) noexcept {
+        using namespace compact_detail;
+        const std::span<std::byte> out =
+            std::span<std::byte>{scratch_}.first(kTickDeltaMaxPayloadBytes);
+        ByteWriter w{out};
+        w.u16(seq);
+        for (std::size_t j = 0; j < kCompactWordFields; ++j) {
+            const std::size_t off = kWordBlockOffset + 4 * j;
+            const auto now = static_cast<std::uint32_t>(loadLe(&cur_[off], 4));
+            const auto was = static_cast<std::uint32_t>(loadLe(&ref_[off], 4));
+            varint(w, zigzag(now - was));
+        }
+        if (!w.ok()) {
+            return 0U;
+        }
+        BitWriter bw{out.subspan(w.offset())};
+        pendingWin_ = win_;
+        for (std::size_t i = 0; i < kCompactFloatFields; ++i) {
+            const std::size_t off = floatOffset(i);
+            const std::uint64_t x = loadLe(&cur_[off], 8) ^ loadLe(&ref_[off], 8);
+            if (x == 0U) {
+                bw.bits(0U, 1);
+                continue;
+            }
+            auto lead = static_cast<unsigned>(std::countl_zero(x));
+            const auto trail = static_cast<unsigned>(std::countr_zero(x));
+            lead = lead > 31U ? 31U : lead;
+            const unsigned wl = pendingWin_.lead[i];
+            const unsigned wt = pendingWin_.trail[i];
+            if (wl != kNoWindow && lead >= wl && trail >= wt) {
+                bw.bits(0b10U, 2);
+                bw.bits(x >> wt, 64U - wl - wt);
+            } else {
+                const unsigned len = 64U - lead - trail;
+                bw.bits(0b11U, 2);
+                bw.bits(lead, 5);
+                bw.bits(len - 1U, 6);
+                bw.bits(x >> trail, len);
+                pendingWin_.lead[i] = static_cast<std::uint8_t>(lead);
+                pendingWin_.trail[i] = static_cast<std::uint8_t>(trail);
+            }
+        }
+        return bw.ok() ? w.offset() + bw.bytes() : 0U;
+    }
+
+    std::size_t interval_;
+    std::array<std::byte, kTickPayloadBytes> ref_{};     // the chain's previous tick (v1 bytes)
+    std::array<std::byte, kTickPayloadBytes> cur_{};     // the tick being encoded
+    std::array<std::byte, kTickKeyPayloadBytes> scratch_{};
+    compact_detail::Windows win_{};
+    compact_detail::Windows pendingWin_{};
+    std::size_t sinceKey_ = 0;
+    std::uint32_t keyframes_ = 0;
+    std::uint32_t deltas_ = 0;
+    std::uint16_t seq_ = 0;
+    bool chained_ = false;
+    bool pendingKey_ = false;
+};
+
+/// The decoder half of the compact tick stream: feed it every TickKey/TickDelta payload
+/// IN FILE ORDER and it rebuilds each tick exactly (header note). A delta whose chain is
+/// broken — a lost frame, or no keyframe yet — is REFUSED and counted in unresolved()
+/// until the next keyframe; a malformed payload is refused and raises `corrupt`.
+/// BlackboxReader owns one (readTick()); it is public for tools that walk frames
+/// themselves. Allocation-free, never throws.
+class CompactTickDecoder {
+public:
+    /// Decode one compact frame into `r`. Returns false — and leaves `r` untouched — for
+    /// a frame that cannot be decoded exactly. `corrupt` is set (never cleared) when the
+    /// payload itself is malformed or decodeTick() flags a field.
+    [[nodiscard]] bool decode(FrameType type, std::span<const std::byte> payload, DebugRecord& r,
+                              bool& corrupt) noexcept {
+        if (type == FrameType::TickKey) {
+            if (payload.size() != kTickKeyPayloadBytes) {
+                corrupt = true;
+                chained_ = false;
+                return false;
+            }
+            ByteReader b{payload};
+            seq_ = b.u16();
+            for (std::byte& v : ref_) {
+                v = static_cast<std::byte>(b.u8());
+            }
+            win_.clear();
+            chained_ = true;
+            return decodeTick(ref_, r, corrupt);
+        }
+        if (type != FrameType::TickDelta) {
+            return false;
+        }
+        ByteReader b{payload};
+        const std::uint16_t seq = b.u16();
+        if (!chained_ || seq != static_cast<std::uint16_t>(seq_ + 1U)) {
+            chained_ = false;  // stays broken until the next keyframe, even if a later seq lines up
+            ++unresolved_;
+            return false;
+        }
+        std::array<std::byte, kTickPayloadBytes> next = ref_;
+        compact_detail::Windows win = win_;
+        if (!applyDelta(b, payload, next, win)) {
+            corrupt = true;
+            chained_ = false;
+            ++unresolved_;
+            return false;
+        }
+        ref_ = next;
+        win_ = win;
+        seq_ = seq;
+        return decodeTick(ref_, r, corrupt);
+    }
+
+    /// Delta frames refused because their chain was broken or the payload was malformed.
+    [[nodiscard]] std::uint32_t unresolved() const noexcept { return unresolved_; }
+    /// Forget the chain (the next delta is refused until a keyframe arrives).
+    void reset() noexcept { chained_ = false; }
+    /// The v1 Tick payload of the last tick decode() rebuilt — what a host tool reads
+    /// fields from by offset without a DebugRecord round trip. Meaningless before the
+    /// first successful decode().
+    [[nodiscard]] std::span<const std::byte, kTickPayloadBytes> tickBytes() const noexcept {
+        return ref_;
+    }
+
+private:
+    [[nodiscard]] static bool applyDelta(ByteReader& b, std::span<const std::byte> payload,
+                                         std::array<std::byte, kTickPayloadBytes>& next,
+                                         compact_detail::Windows& win) noexcept {
+        using namespace compact_detail;
+        bool bad = false;
+        for (std::size_t j = 0; j < kCompactWordFields; ++j) {
+            const std::size_t off = kWordBlockOffset + 4 * j;
+            const auto was = static_cast<std::uint32_t>(loadLe(&next[off], 4));
+            storeLe(&next[off], 4, was + unzigzag(varint(b, bad)));
+        }
+        if (bad || !b.ok()) {
+            return false;
+        }
+        const std::span<const std::byte> stream = payload.subspan(b.offset());
+        BitReader br{stream};
+        for (std::size_t i = 0; i < kCompactFloatFields; ++i) {
+            if (br.bits(1) == 0U) {
+                continue;
+            }
+            std::uint64_t x = 0;
+            if (br.bits(1) == 0U) {
+                const unsigned wl = win.lead[i];
+                const unsigned wt = win.trail[i];
+                if (wl == kNoWindow) {
+                    return false;  // "reuse the window" with no window: malformed
+                }
+                x = br.bits(64U - wl - wt) << wt;
+            } else {
+                const auto lead = static_cast<unsigned>(br.bits(5));
+                const unsigned len = static_cast<unsigned>(br.bits(6)) + 1U;
+                if (lead + len > 64U) {
+                    return false;
+                }
+                const unsigned trail = 64U - lead - len;
+                x = br.bits(len) << trail;
+                win.lead[i] = static_cast<std::uint8_t>(lead);
+                win.trail[i] = static_cast<std::uint8_t>(trail);
+            }
+            const std::size_t off = floatOffset(i);
+            storeLe(&next[off], 8, loadLe(&next[off], 8) ^ x);
+        }
+        // Every payload byte must have been consumed: a frame longer than its own
+        // content is not one this encoder wrote.
+        return br.ok() && br.bytes() == stream.size();
+    }
+
+    std::array<std::byte, kTickPayloadBytes> ref_{};
+    compact_detail::Windows win_{};
+    std::uint32_t unresolved_ = 0;
+    std::uint16_t seq_ = 0;
+    bool chained_ = false;
+};
+
+}  // namespace shulib::diag::blackbox
@@ -44,6 +44,16 @@
 // RECORD, the run SUMMARY, and the fault TRIAGE block. SdSink counts the messages it
 // was handed and writes that count into the end frame, so the omission is visible in
 // the file rather than silent — a reader can always see that N lines existed elsewhere.
+// Deferred lines (diag/deferred_log.hpp) are the exception that fits: a format id and
+// packed binary arguments, no text, so they travel as FormatDef/LogArgs frames and the
+// count covers only the plain log() lines.
+//
+// ── v2: the same records, compact ───────────────────────────────────────────────────
+// A v2 file (kFormatVersionCompact) differs from v1 in ONE place: its ticks travel as
+// TickKey/TickDelta frames (blackbox_compact.hpp) instead of Tick frames. Everything
+// else — header, summary, triage (whose fault tick stays a full v1 record), end — is
+// byte-for-byte v1. The compact codec works on the v1 tick BYTES, so "decoded equals
+// encoded, field by field" is inherited rather than re-promised.
 //
 // ── What H1 (F9, the SHUL/2 wire) inherits ──────────────────────────────────────────
 // This is a PERSISTENCE contract the moment a file exists, but it is deliberately NOT
@@ -60,6 +70,8 @@
 #include <string_view>
 
 #include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/deferred_log.hpp"
+#include "shulib/diag/event_ring.hpp"
 #include "shulib/diag/fault.hpp"
 #include "shulib/diag/run_summary.hpp"
 #include "shulib/diag/session_info.hpp"
@@ -73,6 +85,13 @@ inline constexpr char kMagic[4] = {'S', 'H', 'B', 'B'};
 /// refuses a version it was not built for rather than misreading it (header note).
 inline constexpr std::uint16_t kFormatVersion = 1;
 
+/// The format version of a file whose tick stream is COMPACT (blackbox_compact.hpp):
+/// every layout above is unchanged, but ticks travel as TickKey/TickDelta frames. A
+/// separate number rather than a silent append because a v1 reader would skip every
+/// compact tick by length and report a run with no ticks in it — a confident wrong
+/// answer. Bumping the version makes that reader REFUSE the file instead.
+inline constexpr std::uint16_t kFormatVersionCompact = 2;
+
 /// Size of the fixed file header, in bytes (v1). Fixed width so a reader can seek
 /// past it without parsing, and generous enough to hold full provenance.
 inline constexpr std::size_t kHeaderBytes = 256;
@@ -94,6 +113,56 @@ inline constexpr std::size_t kTriagePayloadBytes = 24 + kTickPayloadBytes;
 /// Payload size of one End frame (v1) — the graceful-end stamp.
 inline constexpr std::size_t kEndPayloadBytes = 28;
 
+/// Payload size of one LoadShed frame (v1, appended) — the run's TickBudget tallies.
+inline constexpr std::size_t kLoadShedPayloadBytes = 28;
+
+/// Payload size of one TickTiming frame (v1, appended) — the run's loop-dt and per-phase
+/// p50/p95/p99/max: a 4-byte prefix, then 40 bytes per distribution (dt + each phase slot).
+inline constexpr std::size_t kTickTimingPayloadBytes =
+    4 + 40 * (1 + static_cast<std::size_t>(kTickPhaseSlots));
+
+/// ZoneTiming payload bytes before the rows: row count, reserved, refused-scope count.
+inline constexpr std::size_t kZoneTimingFixedBytes = 8;
+/// Bytes per zone row in a ZoneTiming frame.
+inline constexpr std::size_t kZoneTimingRowBytes = 64;
+/// The largest ZoneTiming payload: every row of a full profiler table.
+inline constexpr std::size_t kZoneTimingMaxPayloadBytes =
+    kZoneTimingFixedBytes + kZoneTimingRowBytes * kMaxZones;
+
+/// EventLog payload bytes before the events: count, reserved, first event number, recorded.
+inline constexpr std::size_t kEventLogFixedBytes = 12;
+/// Bytes per event in an EventLog frame — an Event's own size.
+inline constexpr std::size_t kEventLogEventBytes = 16;
+/// The most events one EventLog frame carries; a longer ring is written as several frames.
+inline constexpr std::size_t kEventLogMaxEvents = 256;
+/// The largest EventLog payload: a full frame of events.
+inline constexpr std::size_t kEventLogMaxPayloadBytes =
+    kEventLogFixedBytes + kEventLogEventBytes * kEventLogMaxEvents;
+
+/// Payload size of one TickKey frame (v2): a u16 chain sequence, then one tick in
+/// exactly the Tick layout — a keyframe IS a v1 record with a sequence number on it.
+inline constexpr std::size_t kTickKeyPayloadBytes = 2 + kTickPayloadBytes;
+
+/// Largest TickDelta payload (v2). A delta that would not come out smaller than a
+/// keyframe is written AS a keyframe instead, so a delta never costs more than one.
+inline constexpr std::size_t kTickDeltaMaxPayloadBytes = kTickKeyPayloadBytes - 1;
+
+/// Payload size of one EstimatorInputs frame (appended): a 4-byte flag prefix, then the
+/// eight binary64 input values.
+inline constexpr std::size_t kEstimatorInputsPayloadBytes = 4 + 8 * 8;
+
+/// FormatDef payload bytes before the tag: id, tag length, reserved, format length.
+inline constexpr std::size_t kFormatDefFixedBytes = 8;
+/// The largest FormatDef payload: the fixed part, a full tag and a full format.
+inline constexpr std::size_t kFormatDefMaxPayloadBytes =
+    kFormatDefFixedBytes + kMaxDeferredTagBytes + kMaxDeferredFormatBytes;
+/// LogArgs payload bytes before the packed arguments: id, level, reserved, time.
+inline constexpr std::size_t kLogArgsFixedBytes = 16;
+/// The smallest LogArgs payload: no arguments (a count byte of zero).
+inline constexpr std::size_t kLogArgsMinPayloadBytes = kLogArgsFixedBytes + 1;
+/// The largest LogArgs payload: every argument slot in use.
+inline constexpr std::size_t kLogArgsMaxPayloadBytes = kLogArgsFixedBytes + kMaxDeferredArgsBytes;
+
 /// What a frame carries. WIRE-STABLE: explicit values, append-only — an unknown type
 /// is skipped by length, never guessed at.
 enum class FrameType : std::uint8_t {
@@ -101,6 +170,36 @@ enum class FrameType : std::uint8_t {
     Summary = 2,  ///< one RunSummary (kSummaryPayloadBytes)
     Triage = 3,   ///< the D-7 fault triage block + the fault tick's own record
     End = 4,      ///< the graceful-end stamp: counts, brownout latch, end time
+    /// the run's load-shedding tallies (kLoadShedPayloadBytes). APPENDED after E1, so
+    /// an older reader skips it by length — exactly what the skip rule is for.
+    LoadShed = 5,
+    /// the run's tick-timing distributions (kTickTimingPayloadBytes). Appended after
+    /// LoadShed, under the same skip rule.
+    TickTiming = 6,
+    /// one tick as a compact-stream KEYFRAME (kTickKeyPayloadBytes; v2 files only —
+    /// blackbox_compact.hpp). Resets the delta chain.
+    TickKey = 7,
+    /// one tick as a DELTA against the previous tick of its chain (variable length, at
+    /// most kTickDeltaMaxPayloadBytes; v2 files only).
+    TickDelta = 8,
+    /// the estimator's raw inputs for the tick frame just before it
+    /// (kEstimatorInputsPayloadBytes; v1 and v2). Appended for offline replay, under the
+    /// same skip rule as LoadShed.
+    EstimatorInputs = 9,
+    /// one interned format: its id, tag and format string (variable length, at most
+    /// kFormatDefMaxPayloadBytes), written the first time the writer meets the id.
+    /// Appended for deferred log lines, under the same skip rule.
+    FormatDef = 10,
+    /// one deferred log line: its format id, level, time and packed arguments (variable
+    /// length, kLogArgsMinPayloadBytes to kLogArgsMaxPayloadBytes). Appended with FormatDef.
+    LogArgs = 11,
+    /// the run's zone-profiler table (variable length, kZoneTimingFixedBytes plus
+    /// kZoneTimingRowBytes per zone). Appended after TickTiming, under the same skip rule.
+    ZoneTiming = 12,
+    /// a run of flight-recorder events, oldest first (variable length, kEventLogFixedBytes
+    /// plus kEventLogEventBytes per event — diag/event_ring.hpp). Appended after ZoneTiming,
+    /// under the same skip rule.
+    EventLog = 13,
 };
 
 /// The D-7 triage block, as data: which fault, when, on which tick, and how many
@@ -362,9 +461,11 @@ private:
 /// Encode the 256-byte file header into `out`. Returns the bytes written (0 if `out`
 /// is too small). Provenance strings are copied in, truncated to their field widths —
 /// an EMPTY build hash stays empty, because MISSING must stay loud all the way to disk.
+/// `formatVersion` is kFormatVersionCompact only for a file whose ticks are compact.
 [[nodiscard]] inline std::size_t encodeHeader(std::span<std::byte> out, const SessionInfo& info,
                                               double epochSeconds, std::uint32_t ringCapacity,
-                                              std::uint32_t byteBudget) noexcept {
+                                              std::uint32_t byteBudget,
+                                              std::uint16_t formatVersion = kFormatVersion) noexcept {
     if (out.size() < kHeaderBytes) {
         return 0U;  // whole or nothing: never leave a half-written header behind
     }
@@ -372,7 +473,7 @@ private:
     for (const char c : kMagic) {
         w.u8(static_cast<std::uint8_t>(c));
     }
-    w.u16(kFormatVersion);
+    w.u16(formatVersion);
     w.u16(static_cast<std::uint16_t>(kHeaderBytes));
     w.u16(static_cast<std::uint16_t>(kTickPayloadBytes));
     w.u16(0U);  // flags
@@ -742,6 +843,445 @@ private:
     return b.ok() && b.offset() == kEndPayloadBytes;
 }
 
+// ── The load-shed frame (diag/tick_budget.hpp) ──────────────────────────────────────
+//   0 ticksObserved   8 maxLevel(u8)     12 shedTicks[4] (u32, SheddableWork order)
+//   4 escalations     9 classCount(u8)   28 = end
+//                    10 reserved(u16)
+// classCount is written so a reader can tell how many classes the writer knew; v1
+// decodes exactly kSheddableWorkCount and treats any other count as a mis-sized frame.
+
+/// Encode the run's load-shedding tallies from `s`. Returns the bytes written, or 0 on
+/// a layout/space failure.
+[[nodiscard]] inline std::size_t encodeLoadShed(std::span<std::byte> out,
+                                                const RunSummary& s) noexcept {
+    if (out.size() < kLoadShedPayloadBytes) {
+        return 0U;  // whole or nothing (see encodeHeader)
+    }
+    ByteWriter w{out};
+    w.u32(s.shedTicksObserved);
+    w.u32(s.shedEscalations);
+    w.u8(static_cast<std::uint8_t>(s.shedMaxLevel));
+    w.u8(static_cast<std::uint8_t>(kSheddableWorkCount));
+    w.u16(0U);
+    for (const std::uint32_t n : s.shedTicks) {
+        w.u32(n);
+    }
+    return w.ok() && w.offset() == kLoadShedPayloadBytes ? w.offset() : 0U;
+}
+
+/// Decode a LoadShed frame into `s`'s load-shed fields (setting hasLoadShedData) and
+/// touch nothing else. Returns false if the payload is not exactly kLoadShedPayloadBytes
+/// or was written by a build with a different class count.
+[[nodiscard]] inline bool decodeLoadShed(std::span<const std::byte> in, RunSummary& s) noexcept {
+    if (in.size() != kLoadShedPayloadBytes) {
+        return false;
+    }
+    ByteReader b{in};
+    const std::uint32_t observed = b.u32();
+    const std::uint32_t escalations = b.u32();
+    const std::uint8_t maxLevel = b.u8();
+    const std::uint8_t classCount = b.u8();
+    b.skip(2);
+    if (classCount != kSheddableWorkCount) {
+        return false;
+    }
+    s.shedTicksObserved = observed;
+    s.shedEscalations = escalations;
+    s.shedMaxLevel = maxLevel;
+    for (std::uint32_t& n : s.shedTicks) {
+        n = b.u32();
+    }
+    s.hasLoadShedData = true;
+    return b.ok() && b.offset() == kLoadShedPayloadBytes;
+}
+
+// ── The tick-timing frame (diag/tick_histogram.hpp) ─────────────────────────────────
+//   0 slotCount(u8)   1 reserved(u8)   2 reserved(u16)
+//   4 loopDt          then one distribution per phase slot, TickPhase order, 40 bytes each:
+//                       +0 count(u32)  +4 reserved(u32)  +8 p50  +16 p95  +24 p99  +32 max (f64 s)
+// The percentiles are written AS COMPUTED (bin upper edges, clamped to max) — the bins
+// themselves stay on the robot. slotCount plays classCount's role in the LoadShed frame.
+
+/// Encode the run's tick-timing digests from `s`. Returns the bytes written, or 0 on a
+/// layout/space failure.
+[[nodiscard]] inline std::size_t encodeTickTiming(std::span<std::byte> out,
+                                                  const RunSummary& s) noexcept {
+    if (out.size() < kTickTimingPayloadBytes) {
+        return 0U;  // whole or nothing (see encodeHeader)
+    }
+    ByteWriter w{out};
+    w.u8(static_cast<std::uint8_t>(kTickPhaseSlots));
+    w.u8(0U);
+    w.u16(0U);
+    const auto put = [&w](const TickTimingStats& t) {
+        w.u32(t.count);
+        w.u32(0U);
+        w.f64(t.p50.value());
+        w.f64(t.p95.value());
+        w.f64(t.p99.value());
+        w.f64(t.max.value());
+    };
+    put(s.loopDt);
+    for (const TickTimingStats& t : s.phaseTiming) {
+        put(t);
+    }
+    return w.ok() && w.offset() == kTickTimingPayloadBytes ? w.offset() : 0U;
+}
+
+/// Decode a TickTiming frame into `s`'s loopDt and phaseTiming and touch nothing else.
+/// Returns false if the payload is not exactly kTickTimingPayloadBytes or was written by
+/// a build with a different phase-slot count.
+[[nodiscard]] inline bool decodeTickTiming(std::span<const std::byte> in, RunSummary& s) noexcept {
+    if (in.size() != kTickTimingPayloadBytes) {
+        return false;
+    }
+    ByteReader b{in};
+    const std::uint8_t slotCount = b.u8();
+    b.skip(3);
+    if (slotCount != kTickPhaseSlots) {
+        return false;
+    }
+    const auto get = [&b](TickTimingStats& t) {
+        t.count = b.u32();
+        b.skip(4);
+        t.p50 = units::Time{b.f64()};
+        t.p95 = units::Time{b.f64()};
+        t.p99 = units::Time{b.f64()};
+        t.max = units::Time{b.f64()};
+    };
+    get(s.loopDt);
+    for (TickTimingStats& t : s.phaseTiming) {
+        get(t);
+    }
+    return b.ok() && b.offset() == kTickTimingPayloadBytes;
+}
+
+// ── The zone-timing frame (diag/zone_profiler.hpp) ──────────────────────────────────
+//   0 rowCount(u8)   1 reserved(u8)   2 reserved(u16)   4 refused(u32)
+//   8 rowCount rows, depth-first (ZoneProfiler::snapshot order), 64 bytes each:
+//       +0 name(16, NUL-padded)  +16 depth(u8)  +17 reserved(u8)  +18 reserved(u16)
+//      +20 calls(u32)  +24 total  +32 self  +40 p50  +48 p99  +56 max (f64 s)
+// Like TickTiming, the percentiles travel as computed; the histograms stay on the robot.
+
+/// Payload bytes of `s`'s ZoneTiming frame.
+[[nodiscard]] inline std::size_t zoneTimingPayloadBytes(const RunSummary& s) noexcept {
+    const std::size_t rows = s.zoneCount < kMaxZones ? s.zoneCount : kMaxZones;
+    return kZoneTimingFixedBytes + kZoneTimingRowBytes * rows;
+}
+
+/// Encode the run's zone table from `s`. Returns the bytes written, or 0 on a space failure.
+[[nodiscard]] inline std::size_t encodeZoneTiming(std::span<std::byte> out,
+                                                  const RunSummary& s) noexcept {
+    const std::size_t need = zoneTimingPayloadBytes(s);
+    if (out.size() < need) {
+        return 0U;  // whole or nothing (see encodeHeader)
+    }
+    const std::size_t rows = (need - kZoneTimingFixedBytes) / kZoneTimingRowBytes;
+    ByteWriter w{out};
+    w.u8(static_cast<std::uint8_t>(rows));
+    w.u8(0U);
+    w.u16(0U);
+    w.u32(s.zonesRefused);
+    for (std::size_t i = 0; i < rows; ++i) {
+        const ZoneTimingRow& z = s.zones[i];
+        w.text(z.nameView(), kMaxZoneNameBytes + 1);
+        w.u8(z.depth);
+        w.u8(0U);
+        w.u16(0U);
+        w.u32(z.calls);
+        w.f64(z.total.value());
+        w.f64(z.self.value());
+        w.f64(z.p50.value());
+        w.f64(z.p99.value());
+        w.f64(z.max.value());
+    }
+    return w.ok() && w.offset() == need ? w.offset() : 0U;
+}
+
+/// Decode a ZoneTiming frame into `s`'s zone table and touch nothing else. Returns false
+/// if the payload's size disagrees with its row count or the rows exceed kMaxZones.
+[[nodiscard]] inline bool decodeZoneTiming(std::span<const std::byte> in, RunSummary& s) noexcept {
+    if (in.size() < kZoneTimingFixedBytes || in.size() > kZoneTimingMaxPayloadBytes) {
+        return false;
+    }
+    ByteReader b{in};
+    const std::size_t rows = b.u8();
+    b.skip(3);
+    const std::uint32_t refused = b.u32();
+    if (rows > kMaxZones || in.size() != kZoneTimingFixedBytes + kZoneTimingRowBytes * rows) {
+        return false;
+    }
+    s.zoneCount = static_cast<std::uint32_t>(rows);
+    s.zonesRefused = refused;
+    for (std::size_t i = 0; i < rows; ++i) {
+        ZoneTimingRow& z = s.zones[i];
+        b.text(z.name, sizeof z.name, kMaxZoneNameBytes + 1);
+        z.depth = b.u8();
+        b.skip(3);
+        z.calls = b.u32();
+        z.total = units::Time{b.f64()};
+        z.self = units::Time{b.f64()};
+        z.p50 = units::Time{b.f64()};
+        z.p99 = units::Time{b.f64()};
+        z.max = units::Time{b.f64()};
+    }
+    return b.ok() && b.offset() == in.size();
+}
+
+// ── The event-log frame (diag/event_ring.hpp) ───────────────────────────────────────
+//   0 count(u16)   2 reserved(u16)   4 firstNumber(u32)   8 recorded(u32)
+//  12 count events, oldest first, 16 bytes each:
+//       +0 t(f64 s)  +8 kind(u8)  +9 code(u8)  +10 aux(u16)  +12 value(u32)
+// firstNumber is the ring's running number of the first event here (0 = the first event
+// the ring ever recorded) and recorded is the ring's total when the frame was written, so
+// a reader sees both the events the ring had already overwritten and any gap between two
+// frames without being told.
+
+/// The fixed part of an EventLog frame, decoded.
+struct EventLogHeader {
+    std::uint16_t count = 0;        ///< events in the frame
+    std::uint32_t firstNumber = 0;  ///< running number of the first of them
+    std::uint32_t recorded = 0;     ///< the ring's recorded() when the frame was written
+};
+
+/// Payload bytes of an EventLog frame carrying `count` events (clamped to kEventLogMaxEvents).
+[[nodiscard]] inline std::size_t eventLogPayloadBytes(std::size_t count) noexcept {
+    return kEventLogFixedBytes
+           + kEventLogEventBytes * (count < kEventLogMaxEvents ? count : kEventLogMaxEvents);
+}
+
+/// Encode `count` of `ring`'s held events from index `from` (oldest first; at most
+/// kEventLogMaxEvents, and no further than the ring holds). Returns the bytes written, or
+/// 0 on a space failure.
+[[nodiscard]] inline std::size_t encodeEventLog(std::span<std::byte> out, const EventRing& ring,
+                                                std::size_t from, std::size_t count) noexcept {
+    const std::size_t held = from < ring.size() ? ring.size() - from : 0U;
+    const std::size_t n = count < held ? count : held;
+    const std::size_t need = eventLogPayloadBytes(n);
+    if (out.size() < need) {
+        return 0U;  // whole or nothing (see encodeHeader)
+    }
+    const std::size_t rows = (need - kEventLogFixedBytes) / kEventLogEventBytes;
+    ByteWriter w{out};
+    w.u16(static_cast<std::uint16_t>(rows));
+    w.u16(0U);
+    w.u32(ring.overwritten() + static_cast<std::uint32_t>(from));
+    w.u32(ring.recorded());
+    for (std::size_t i = 0; i < rows; ++i) {
+        const Event e = ring.at(from + i);
+        w.f64(e.t);
+        w.u8(static_cast<std::uint8_t>(e.kind));
+        w.u8(e.code);
+        w.u16(e.aux);
+        w.u32(e.value);
+    }
+    return w.ok() && w.offset() == need ? w.offset() : 0U;
+}
+
+/// Decode an EventLog frame: its fixed part into `h` and its events into the front of
+/// `events`. Returns false if the payload's size disagrees with its count, the count
+/// exceeds kEventLogMaxEvents, or `events` is too short to take them.
+[[nodiscard]] inline bool decodeEventLog(std::span<const std::byte> in, EventLogHeader& h,
+                                         std::span<Event> events) noexcept {
+    if (in.size() < kEventLogFixedBytes || in.size() > kEventLogMaxPayloadBytes) {
+        return false;
+    }
+    ByteReader b{in};
+    const std::size_t count = b.u16();
+    b.skip(2);
+    const std::uint32_t first = b.u32();
+    const std::uint32_t recorded = b.u32();
+    if (count > kEventLogMaxEvents || count > events.size()
+        || in.size() != eventLogPayloadBytes(count)) {
+        return false;
+    }
+    h.count = static_cast<std::uint16_t>(count);
+    h.firstNumber = first;
+    h.recorded = recorded;
+    for (std::size_t i = 0; i < count; ++i) {
+        Event& e = events[i];
+        e.t = b.f64();
+        e.kind = static_cast<EventKind>(b.u8());
+        e.code = b.u8();
+        e.aux = b.u16();
+        e.value = b.u32();
+    }
+    return b.ok() && b.offset() == in.size();
+}
+
+// ── The estimator-inputs frame (localization/correction.hpp, EstimatorInputs) ───────
+//   0 flags(u8): 1 imuReady, 2 gpsPresent, 4 gpsFix    1 reserved(u8)   2 reserved(u16)
+//   4 imuHeading   12 imuYawRate   20 forwardShaft   28 lateralShaft
+//  36 gpsX         44 gpsY         52 gpsHeading     60 gpsRmsError    68 = end
+// It belongs to the tick frame written immediately before it. The tick layout itself is
+// unchanged: a reader that does not know this frame skips it and loses only the replay.
+
+/// Encode `r`'s estimator-input slots. Returns the bytes written, or 0 on a layout/space
+/// failure. The caller writes one only for a record with hasEstimatorInputs set.
+[[nodiscard]] inline std::size_t encodeEstimatorInputs(std::span<std::byte> out,
+                                                       const DebugRecord& r) noexcept {
+    if (out.size() < kEstimatorInputsPayloadBytes) {
+        return 0U;  // whole or nothing (see encodeHeader)
+    }
+    ByteWriter w{out};
+    w.u8(static_cast<std::uint8_t>((r.inputImuReady ? 1U : 0U) | (r.inputGpsPresent ? 2U : 0U)
+                                   | (r.inputGpsFix ? 4U : 0U)));
+    w.u8(0U);
+    w.u16(0U);
+    w.f64(r.inputImuHeading.radians());
+    w.f64(r.inputImuYawRate.value());
+    w.f64(r.inputForwardShaft.value());
+    w.f64(r.inputLateralShaft.value());
+    w.f64(r.inputGpsPose.x().value());
+    w.f64(r.inputGpsPose.y().value());
+    w.f64(r.inputGpsPose.heading().radians());
+    w.f64(r.inputGpsRmsError.value());
+    return w.ok() && w.offset() == kEstimatorInputsPayloadBytes ? w.offset() : 0U;
+}
+
+/// Decode an EstimatorInputs frame into `r`'s input slots (setting hasEstimatorInputs) and
+/// touch nothing else. Returns false if the payload is not exactly
+/// kEstimatorInputsPayloadBytes. `corrupt` is set as decodeTick() sets it.
+[[nodiscard]] inline bool decodeEstimatorInputs(std::span<const std::byte> in, DebugRecord& r,
+                                                bool& corrupt) noexcept {
+    if (in.size() != kEstimatorInputsPayloadBytes) {
+        return false;
+    }
+    ByteReader b{in};
+    const std::uint8_t flags = b.u8();
+    b.skip(3);
+    r.hasEstimatorInputs = true;
+    r.inputImuReady = (flags & 1U) != 0U;
+    r.inputGpsPresent = (flags & 2U) != 0U;
+    r.inputGpsFix = (flags & 4U) != 0U;
+    r.inputImuHeading = safeAngle(b.f64(), corrupt);
+    r.inputImuYawRate = units::AngularVelocity{b.f64()};
+    r.inputForwardShaft = units::AngleDim{b.f64()};
+    r.inputLateralShaft = units::AngleDim{b.f64()};
+    {
+        const double x = b.f64();
+        const double y = b.f64();
+        const double h = b.f64();
+        r.inputGpsPose = math::Pose2d{units::Length{x}, units::Length{y}, safeAngle(h, corrupt)};
+    }
+    r.inputGpsRmsError = units::Length{b.f64()};
+    return b.ok() && b.offset() == kEstimatorInputsPayloadBytes;
+}
+
+// ── The deferred-log frames (diag/deferred_log.hpp) ────────────────────────────────
+//   FormatDef:  0 id(u32)  4 tagBytes(u8)  5 reserved(u8)  6 formatBytes(u16)
+//               8 tag  8+tagBytes format                                   = end
+//   LogArgs:    0 id(u32)  4 level(u8)  5 reserved(u8)  6 reserved(u16)  8 t(f64)
+//              16 count(u8)  17 count × (type(u8) value(8 bytes LE))        = end
+// A LogArgs frame is meaningful only after the FormatDef of its id, which a writer emits
+// once, before the id's first line. A reader that meets a line whose definition it never
+// saw (a dropped frame) keeps the id and the arguments, never a guessed text.
+
+/// A FormatDef payload, as views into the payload bytes.
+struct FormatDefView {
+    std::uint32_t id = 0;         ///< formatId(tag, format)
+    std::string_view tag{};       ///< the subsystem tag
+    std::string_view format{};    ///< the format string
+};
+
+/// A LogArgs payload, as views into the payload bytes.
+struct LogArgsView {
+    std::uint32_t id = 0;                ///< the format id
+    std::uint8_t level = 0;              ///< hal::LogLevel as its integer value
+    double t = 0.0;                      ///< the writer's time for the line, seconds
+    std::span<const std::byte> args{};   ///< the packed-argument block (formatDeferred())
+};
+
+/// Payload bytes of `line`'s FormatDef frame.
+[[nodiscard]] inline std::size_t formatDefPayloadBytes(const DeferredLog& line) noexcept {
+    return kFormatDefFixedBytes + line.tag.size() + line.format.size();
+}
+
+/// Encode `line`'s format definition. Returns the bytes written, or 0 on a space failure or
+/// a literal over its cap.
+[[nodiscard]] inline std::size_t encodeFormatDef(std::span<std::byte> out,
+                                                 const DeferredLog& line) noexcept {
+    const std::size_t need = formatDefPayloadBytes(line);
+    if (out.size() < need || line.tag.size() > kMaxDeferredTagBytes
+        || line.format.size() > kMaxDeferredFormatBytes) {
+        return 0U;  // whole or nothing (see encodeHeader)
+    }
+    ByteWriter w{out};
+    w.u32(line.id);
+    w.u8(static_cast<std::uint8_t>(line.tag.size()));
+    w.u8(0U);
+    w.u16(static_cast<std::uint16_t>(line.format.size()));
+    for (const char c : line.tag) {
+        w.u8(static_cast<std::uint8_t>(c));
+    }
+    for (const char c : line.format) {
+        w.u8(static_cast<std::uint8_t>(c));
+    }
+    return w.ok() && w.offset() == need ? w.offset() : 0U;
+}
+
+/// Decode a FormatDef payload into views of `in`. False if its lengths disagree with its
+/// size.
+[[nodiscard]] inline bool decodeFormatDef(std::span<const std::byte> in,
+                                          FormatDefView& out) noexcept {
+    if (in.size() < kFormatDefFixedBytes) {
+        return false;
+    }
+    ByteReader b{in};
+    const std::uint32_t id = b.u32();
+    const std::size_t tagBytes = b.u8();
+    b.skip(1);
+    const std::size_t formatBytes = b.u16();
+    if (!b.ok() || kFormatDefFixedBytes + tagBytes + formatBytes != in.size()) {
+        return false;
+    }
+    const auto* chars = reinterpret_cast<const char*>(in.data());
+    out.id = id;
+    out.tag = std::string_view{chars + kFormatDefFixedBytes, tagBytes};
+    out.format = std::string_view{chars + kFormatDefFixedBytes + tagBytes, formatBytes};
+    return true;
+}
+
+/// Payload bytes of `line`'s LogArgs frame.
+[[nodiscard]] inline std::size_t logArgsPayloadBytes(const DeferredLog& line) noexcept {
+    return kLogArgsFixedBytes + line.argsBytes;
+}
+
+/// Encode one deferred line, stamped `t`. Returns the bytes written, or 0 on a space failure.
+[[nodiscard]] inline std::size_t encodeLogArgs(std::span<std::byte> out, const DeferredLog& line,
+                                               double t) noexcept {
+    const std::size_t need = logArgsPayloadBytes(line);
+    if (out.size() < need || line.argsBytes > kMaxDeferredArgsBytes) {
+        return 0U;  // whole or nothing (see encodeHeader)
+    }
+    ByteWriter w{out};
+    w.u32(line.id);
+    w.u8(static_cast<std::uint8_t>(line.level));
+    w.u8(0U);
+    w.u16(0U);
+    w.f64(t);
+    for (const std::byte b : line.packedArgs()) {
+        w.u8(static_cast<std::uint8_t>(b));
+    }
+    return w.ok() && w.offset() == need ? w.offset() : 0U;
+}
+
+/// Decode a LogArgs payload into views of `in`. False if the argument block's count
+/// disagrees with its size.
+[[nodiscard]] inline bool decodeLogArgs(std::span<const std::byte> in, LogArgsView& out) noexcept {
+    if (in.size() < kLogArgsMinPayloadBytes || in.size() > kLogArgsMaxPayloadBytes) {
+        return false;
+    }
+    ByteReader b{in};
+    out.id = b.u32();
+    out.level = b.u8();
+    b.skip(3);
+    out.t = b.f64();
+    out.args = in.subspan(kLogArgsFixedBytes);
+    const auto count = static_cast<std::size_t>(out.args[0]);
+    return b.ok() && out.args.size() == 1 + count * kDeferredArgBytes;
+}
+
 /// Write a frame prefix {type, reserved, payloadBytes} into `out`. Returns the bytes
 /// written (kFrameHeaderBytes) or 0 if it did not fit.
 [[nodiscard]] inline std::size_t encodeFrameHeader(std::span<std::byte> out, FrameType type,
@@ -51,6 +51,14 @@
 // case, and F9 is exactly that), it must add its own frame check rather than inherit one
 // from here that does not exist. (Boundary verified during E1's independent review.)
 //
+// ── Two versions, one reader ────────────────────────────────────────────────────────
+// v1 files and v2 (compact-tick) files are both read; any other version is refused.
+// Frames come out of next() RAW either way, and readTick() turns any of the three tick
+// kinds (Tick, TickKey, TickDelta) into a DebugRecord. Compact ticks are a CHAIN, so
+// readTick() must see every tick frame in file order — which is exactly what a loop over
+// next() does. A delta whose chain is broken is refused and counted in unresolvedTicks(),
+// never reconstructed against the wrong predecessor (blackbox_compact.hpp).
+//
 // Allocation-free and PROS-free, like everything in this tree: it reads a span the
 // caller already holds (a whole file loaded into a buffer, or the bytes a test just
 // captured), and iterates.
@@ -59,7 +67,9 @@
 #include <cstdint>
 #include <span>
 
+#include "shulib/diag/blackbox_compact.hpp"
 #include "shulib/diag/blackbox_format.hpp"
+#include "shulib/diag/debug_record.hpp"
 
 namespace shulib::diag::blackbox {
 
@@ -97,6 +107,7 @@ enum class ReadStatus : std::uint8_t {
 /// delivered, truncated() is true, sawEnd() is false — the exact signature a brownout
 /// leaves. Frame kinds this build does not know are skipped by their declared length and
 /// counted in skippedFrames(), which is what lets a v1 reader survive a later writer.
+/// Reads v1 and v2 (compact-tick) files; readTick() decodes a tick frame of either kind.
 /// There is deliberately NO per-frame checksum, so a bit flip landing on a merely-wrong
 /// value inside a known frame decodes silently as that value (measured, not assumed — the
 /// header states the boundary in full). A consumer needing end-to-end integrity must add
@@ -126,7 +137,8 @@ public:
             status_ = ReadStatus::BadMagic;
             return;
         }
-        if (header_.formatVersion != kFormatVersion) {
+        if (header_.formatVersion != kFormatVersion
+            && header_.formatVersion != kFormatVersionCompact) {
             status_ = ReadStatus::UnsupportedVersion;
             return;
         }
@@ -187,6 +199,23 @@ public:
         }
     }
 
+    /// Decode a tick frame — Tick (v1), TickKey or TickDelta (v2) — into `r`. Returns
+    /// false for any other frame type, for a malformed payload, and for a delta whose
+    /// chain is broken (counted in unresolvedTicks()). Compact ticks are a chain: call
+    /// this on EVERY tick frame next() delivers, in order (header note). `corrupt` is set
+    /// (never cleared) as decodeTick() sets it, and for a malformed compact payload.
+    [[nodiscard]] bool readTick(const Frame& frame, DebugRecord& r, bool& corrupt) noexcept {
+        if (frame.type == FrameType::Tick) {
+            return decodeTick(frame.payload, r, corrupt);
+        }
+        return compact_.decode(frame.type, frame.payload, r, corrupt);
+    }
+
+    /// Compact delta frames readTick() refused because their chain was broken (a frame
+    /// lost before them) or their payload was malformed. Each one is a tick that exists
+    /// in the file and was NOT reconstructed; the next keyframe ends the gap.
+    [[nodiscard]] std::uint32_t unresolvedTicks() const noexcept { return compact_.unresolved(); }
+
     /// True when the file ended mid-frame — the run was cut short (brownout, pulled
     /// card, a program that never closed). The frames delivered before the cut are all
     /// valid; this says the story stops there.
@@ -207,21 +236,49 @@ public:
     [[nodiscard]] std::size_t bytesConsumed() const noexcept { return at_; }
 
 private:
-    /// A known type whose payload is the size v1 says it must be. A known type with the
-    /// wrong size is treated as unknown (skipped and counted) rather than decoded — a
-    /// mis-sized frame is corruption, and decoding it would be guessing.
+    /// A known type whose payload is the size its layout says it must be (for TickDelta,
+    /// within the bounds a delta can have). A known type with the wrong size is treated
+    /// as unknown (skipped and counted) rather than decoded — a mis-sized frame is
+    /// corruption, and decoding it would be guessing. A skipped compact tick breaks its
+    /// chain, which the next delta's sequence check then catches.
     [[nodiscard]] static bool knownType(std::uint8_t rawType, std::size_t payloadBytes) noexcept {
         switch (rawType) {
             case static_cast<std::uint8_t>(FrameType::Tick): return payloadBytes == kTickPayloadBytes;
             case static_cast<std::uint8_t>(FrameType::Summary): return payloadBytes == kSummaryPayloadBytes;
             case static_cast<std::uint8_t>(FrameType::Triage): return payloadBytes == kTriagePayloadBytes;
             case static_cast<std::uint8_t>(FrameType::End): return payloadBytes == kEndPayloadBytes;
+            case static_cast<std::uint8_t>(FrameType::LoadShed):
+                return payloadBytes == kLoadShedPayloadBytes;
+            case static_cast<std::uint8_t>(FrameType::TickTiming):
+                return payloadBytes == kTickTimingPayloadBytes;
+            case static_cast<std::uint8_t>(FrameType::TickKey):
+                return payloadBytes == kTickKeyPayloadBytes;
+            case static_cast<std::uint8_t>(FrameType::TickDelta):
+                return payloadBytes >= kTickDeltaMinPayloadBytes
+                       && payloadBytes <= kTickDeltaMaxPayloadBytes;
+            case static_cast<std::uint8_t>(FrameType::EstimatorInputs):
+                return payloadBytes == kEstimatorInputsPayloadBytes;
+            case static_cast<std::uint8_t>(FrameType::FormatDef):
+                return payloadBytes >= kFormatDefFixedBytes
+                       && payloadBytes <= kFormatDefMaxPayloadBytes;
+            case static_cast<std::uint8_t>(FrameType::LogArgs):
+                return payloadBytes >= kLogArgsMinPayloadBytes
+                       && payloadBytes <= kLogArgsMaxPayloadBytes;
+            case static_cast<std::uint8_t>(FrameType::ZoneTiming):
+                return payloadBytes >= kZoneTimingFixedBytes
+                       && payloadBytes <= kZoneTimingMaxPayloadBytes
+                       && (payloadBytes - kZoneTimingFixedBytes) % kZoneTimingRowBytes == 0;
+            case static_cast<std::uint8_t>(FrameType::EventLog):
+                return payloadBytes >= kEventLogFixedBytes
+                       && payloadBytes <= kEventLogMaxPayloadBytes
+                       && (payloadBytes - kEventLogFixedBytes) % kEventLogEventBytes == 0;
             default: return false;
         }
     }
 
     std::span<const std::byte> file_;
     BlackboxHeader header_{};
+    CompactTickDecoder compact_{};
     ReadStatus status_ = ReadStatus::Empty;
     std::size_t at_ = 0;
     std::uint32_t frames_ = 0;
@@ -210,6 +210,33 @@ struct DebugRecord {
     /// un-instrumented work rather than a missing phase, and read a sum above `dt` as a
     /// statement about two clocks rather than a broken record. — C5 (scheduler)
     std::array<units::Time, static_cast<std::size_t>(kTickPhaseSlots)> tickPhase{};
+
+    // ── inner velocity loop ─────────────────────────────────────────────────────────
+    /// Per-wheel tracking error, target − measured wheel SURFACE speed (in/s), as the inner
+    /// loop measured it this tick (control/wheel_velocity_loop.hpp) — measured whether or not
+    /// the loop is enabled, so an open-loop run shows what closing it would fix. Valid for
+    /// [0, wheelCount); 0 on records from producers that do not run the command pipeline.
+    /// Appended AFTER tickPhase, so the v1 blackbox tick frame (a fixed 428-byte layout that
+    /// ends at tickPhase) does not carry it. — motion pipeline
+    std::array<units::Velocity, static_cast<std::size_t>(kMaxWheels)> wheelSpeedError{};
+
+    // ── estimator inputs (for offline replay) ───────────────────────────────────────
+    // The raw readings Localizer::update() consumed this tick, so a recorded run can be fed
+    // back through the estimator with a different fusion policy or gate (sim/
+    // estimator_replay.hpp). Stamped by the scheduler from Localizer::lastInputs(); every
+    // field holds its default unless hasEstimatorInputs is set. Appended after
+    // wheelSpeedError, so the fixed v1 tick frame does not carry them — the blackbox writes
+    // them as their own EstimatorInputs frame after the tick. — estimator replay
+    bool hasEstimatorInputs = false;         ///< the fields below were stamped this tick
+    bool inputImuReady = false;              ///< IImu::isReady() as the Localizer read it
+    math::Angle inputImuHeading{};           ///< the RAW IMU heading (before any heading bias)
+    units::AngularVelocity inputImuYawRate{};  ///< the raw IMU yaw rate
+    units::AngleDim inputForwardShaft{};     ///< forward tracking wheel, cumulative shaft angle
+    units::AngleDim inputLateralShaft{};     ///< lateral tracking wheel, cumulative shaft angle
+    bool inputGpsPresent = false;            ///< a GPS corrector was asked this tick
+    bool inputGpsFix = false;                ///< IGps::hasFix() as the corrector read it
+    math::Pose2d inputGpsPose{};             ///< IGps::pose() (meaningful only with a fix)
+    units::Length inputGpsRmsError{};        ///< IGps::rmsError() (meaningful only with a fix)
 };
 
 }  // namespace shulib::diag
@@ -0,0 +1,224 @@
+#pragma once
+//
+// DecimatingSink — forward every Nth tick's record, and EVERY record at a boundary.
+//
+// Why: RateLimitedSink and LevelFilterSink throttle the line channels, but the record
+// channel still reaches a TermSink or a serial wire at the full 100 Hz. During a long
+// tuning session that is the whole console budget spent on ticks nobody reads. A plain
+// "every Nth" decimator fixes the rate and loses the ticks that matter — the one where a
+// motion started, went from running to settling, the gate rejected a fix, or a fault was
+// raised — because those land between samples nine times in ten. So the rule is:
+//   * a record is forwarded when the decimation interval has elapsed, OR
+//   * when any of its KEY fields differs from the last record forwarded: the command id,
+//     the command state (which carries the exit), the gate reason, or the fault. A change
+//     in either direction counts, so a fault tick and the tick after it both go out.
+// The interval restarts at every forwarded record, so a boundary does not leave a short
+// gap before the next periodic one. Which keys count is configurable (watch mask); a gate
+// that alternates Accepted/NoFix every tick would otherwise defeat the decimation.
+//
+// ── wantsRecord(), and the key probe ─────────────────────────────────────────────────
+// The point of the A1 cost contract is that a skipped tick does not even BUILD its record
+// (telemetry_sink.hpp). But the key fields are IN the record, so on its own this decorator
+// cannot know, before population, whether the next record is a boundary. Two postures:
+//   * NO probe attached: wantsRecord() forwards the inner sink's answer on every tick —
+//     every record is built and looked at, and only the forwarded ones reach the inner
+//     sink. Population is paid; the inner sink's formatting and bytes are what is saved.
+//   * A PROBE attached (IRecordKeyProbe — MotionScheduler::recordKeyProbe() is one):
+//     the probe says what the key fields of the next record WILL be, so wantsRecord()
+//     answers exactly "would emit() forward this": true when the interval has elapsed or
+//     the probed keys differ from the last forwarded record's. A skipped tick costs one
+//     clock read and one probe call, and no record is built.
+// The interval is measured on the injected clock, not by counting calls: wantsRecord() is a
+// const query with no call-count contract (the rate_limit_sink.hpp reasoning), and with a
+// probe the skipped ticks never reach emit() to be counted. A record is due when at least
+// (every − ½) tick periods have passed since the last forwarded one, so timestamps that
+// wander by less than a quarter period either way still give exactly one per N ticks.
+//
+// Honest scope: with a probe, everything DOWNSTREAM of this sink sees the decimated
+// stream, and so does anything that shares its wantsRecord() answer — in the scheduler's
+// chain that includes the motion-stats observer, whose overshoot and drift become maxima
+// over the forwarded records (boundaries included, so start and final values are exact).
+// Decimation is configuration, not degradation: a skipped record is not a drop and is not
+// stamped into droppedRecords (the LevelFilterSink distinction). skippedRecords() counts
+// only records that were built and then not forwarded.
+//
+// log(), logDeferred() and summarize() forward untouched. Single-task by contract, no heap.
+
+#include <cmath>
+#include <cstdint>
+#include <string_view>
+
+#include "shulib/core/check.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/fault.hpp"
+#include "shulib/hal/clock.hpp"
+#include "shulib/hal/telemetry_sink.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::diag {
+
+/// The record fields whose change marks a boundary (header note).
+struct RecordKeys {
+    std::uint32_t commandId = 0;                ///< DebugRecord::activeCommandId
+    std::uint8_t commandState = 0;              ///< DebugRecord::activeCommandState
+    GateReason gateReason = GateReason::None;  ///< DebugRecord::gateReason
+    FaultCode fault = FaultCode::None;          ///< DebugRecord::fault
+
+    /// Field-wise equality.
+    friend bool operator==(const RecordKeys&, const RecordKeys&) = default;
+};
+
+/// The key fields of `record`.
+[[nodiscard]] inline RecordKeys recordKeys(const DebugRecord& record) noexcept {
+    return RecordKeys{record.activeCommandId, record.activeCommandState, record.gateReason,
+                      record.fault};
+}
+
+/// Says what the key fields of the NEXT record will be, before it is built — what lets
+/// DecimatingSink answer wantsRecord() precisely (header note). peek() must be cheap and
+/// must agree with the record that is then built; a probe that guesses wrong makes the
+/// decimator skip a boundary, which is the failure it exists to prevent.
+class IRecordKeyProbe {
+public:
+    /// Interface boilerplate, as ITelemetrySink: held by non-owning pointer, never deleted
+    /// through this base by anything in the library.
+    virtual ~IRecordKeyProbe() = default;
+    IRecordKeyProbe() = default;
+    IRecordKeyProbe(const IRecordKeyProbe&) = default;
+    IRecordKeyProbe(IRecordKeyProbe&&) = default;
+    IRecordKeyProbe& operator=(const IRecordKeyProbe&) = default;
+    IRecordKeyProbe& operator=(IRecordKeyProbe&&) = default;
+
+    /// The key fields the next record will carry.
+    [[nodiscard]] virtual RecordKeys peek() const noexcept = 0;
+};
+
+/// One bit per RecordKeys field, for DecimationConfig::watch.
+enum class RecordKey : std::uint8_t {
+    CommandId = 1U << 0,     ///< activeCommandId
+    CommandState = 1U << 1,  ///< activeCommandState (run/settling/exit)
+    GateReason = 1U << 2,    ///< gateReason
+    Fault = 1U << 3,         ///< fault
+};
+
+/// Every key: the default watch mask.
+inline constexpr std::uint8_t kWatchAllKeys = 0x0F;
+
+/// `key`'s bit, for building a watch mask.
+[[nodiscard]] constexpr std::uint8_t watchBit(RecordKey key) noexcept {
+    return static_cast<std::uint8_t>(key);
+}
+
+/// How a DecimatingSink samples. The defaults turn a 100 Hz stream into 10 Hz plus every
+/// boundary — a terminal-bandwidth choice, not a hardware one, so no register entry.
+struct DecimationConfig {
+    /// Forward one record per this many ticks when nothing changes. ≥ 1; 1 forwards all.
+    int every = 10;
+    /// The nominal tick period the interval is measured in. Finite and > 0.
+    units::Time tickPeriod{0.01};
+    /// Which key changes force a record through (RecordKey bits). 0 = pure decimation.
+    std::uint8_t watch = kWatchAllKeys;
+};
+
+/// A record-channel decorator that forwards every Nth tick's record and every record whose
+/// command id, command state, gate reason or fault changed (header). With an IRecordKeyProbe
+/// attached, wantsRecord() answers exactly whether this tick's record would be forwarded, so
+/// skipped ticks build nothing. Lines and the summary pass untouched. Holds `inner`, `clock`
+/// and the probe by NON-OWNING reference. Single-task by contract; allocates nothing.
+class DecimatingSink final : public hal::ITelemetrySink {
+public:
+    /// `inner` and `clock` must outlive the sink.
+    DecimatingSink(hal::ITelemetrySink& inner, hal::IClock& clock,
+                   const DecimationConfig& config = {})
+        : inner_{&inner}, clock_{clock}, cfg_{config} {
+        SHULIB_PRECONDITION(cfg_.every >= 1, "DecimatingSink: every must be >= 1");
+        SHULIB_PRECONDITION(std::isfinite(cfg_.tickPeriod.value()) && cfg_.tickPeriod.value() > 0.0,
+                            "DecimatingSink: tickPeriod must be finite and > 0");
+        interval_ = (static_cast<double>(cfg_.every) - 0.5) * cfg_.tickPeriod.value();
+    }
+
+    /// Forwarded untouched: decimation applies to records only.
+    void log(hal::LogLevel level, std::string_view subsystem,
+             std::string_view message) override {
+        inner_->log(level, subsystem, message);
+    }
+
+    /// Forwarded untouched and still packed.
+    void logDeferred(const DeferredLog& line) override { inner_->logDeferred(line); }
+
+    /// False whenever the inner sink is false. Otherwise: with no probe, true (every record
+    /// must be seen to find the boundaries); with a probe, true iff emit() would forward
+    /// this tick's record — the interval has elapsed, or a watched probed key changed.
+    [[nodiscard]] bool wantsRecord() const noexcept override {
+        if (!inner_->wantsRecord()) {
+            return false;
+        }
+        if (probe_ == nullptr) {
+            return true;
+        }
+        return due(clock_.now().value()) || changed(probe_->peek());
+    }
+
+    /// Forward `record` if it is due or a boundary (header rule); otherwise count it in
+    /// skippedRecords() and drop it here.
+    void emit(const DebugRecord& record) override {
+        const double now = clock_.now().value();
+        const RecordKeys keys = recordKeys(record);
+        const bool boundary = changed(keys);
+        if (!boundary && !due(now)) {
+            ++skipped_;
+            return;
+        }
+        boundaries_ += boundary ? 1U : 0U;
+        ++forwarded_;
+        last_ = keys;
+        lastForwardT_ = now;
+        hasForwarded_ = true;
+        inner_->emit(record);
+    }
+
+    /// Forwarded untouched (the decorator rule in telemetry_sink.hpp).
+    void summarize(const RunSummary& summary) override { inner_->summarize(summary); }
+
+    /// Attach the probe that makes wantsRecord() precise (nullptr detaches — the default).
+    /// NON-OWNING: the probe must outlive the sink or be detached first.
+    void setKeyProbe(const IRecordKeyProbe* probe) noexcept { probe_ = probe; }
+
+    /// Records passed to the inner sink since construction.
+    [[nodiscard]] std::uint32_t forwardedRecords() const noexcept { return forwarded_; }
+    /// Of those, the ones forwarded because a watched key changed (the first record counts).
+    [[nodiscard]] std::uint32_t boundaryRecords() const noexcept { return boundaries_; }
+    /// Records that were built, reached emit() and were not forwarded. A tick skipped by a
+    /// probed wantsRecord() never reaches emit() and is not in this count.
+    [[nodiscard]] std::uint32_t skippedRecords() const noexcept { return skipped_; }
+
+private:
+    [[nodiscard]] bool due(double now) const noexcept {
+        return !hasForwarded_ || now - lastForwardT_ >= interval_;
+    }
+
+    [[nodiscard]] bool changed(const RecordKeys& k) const noexcept {
+        if (!hasForwarded_) {
+            return true;
+        }
+        const auto watched = [this](RecordKey key) { return (cfg_.watch & watchBit(key)) != 0U; };
+        return (watched(RecordKey::CommandId) && k.commandId != last_.commandId)
+               || (watched(RecordKey::CommandState) && k.commandState != last_.commandState)
+               || (watched(RecordKey::GateReason) && k.gateReason != last_.gateReason)
+               || (watched(RecordKey::Fault) && k.fault != last_.fault);
+    }
+
+    hal::ITelemetrySink* inner_;
+    hal::IClock& clock_;
+    DecimationConfig cfg_;
+    const IRecordKeyProbe* probe_ = nullptr;
+    double interval_ = 0.0;
+    double lastForwardT_ = 0.0;
+    bool hasForwarded_ = false;
+    RecordKeys last_{};
+    std::uint32_t forwarded_ = 0;
+    std::uint32_t boundaries_ = 0;
+    std::uint32_t skipped_ = 0;
+};
+
+}  // namespace shulib::diag
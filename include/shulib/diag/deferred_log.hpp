@@ -0,0 +1,356 @@
+#pragma once
+//
+// Deferred-formatting log lines — a message whose FORMAT STRING is interned at compile
+// time and whose arguments travel as binary, so the text is rendered wherever someone
+// reads it rather than on the robot. The defmt idea (Ferrous Systems, 2020), in the
+// shape this tree's sinks already have.
+//
+//     SHULIB_LOGF(sink, hal::LogLevel::Info, "MOT", "settled in {:.2} s, {} retries", t, n);
+//
+// ── What it buys ────────────────────────────────────────────────────────────────────
+// A log() line is formatted on the robot (snprintf plus line_format's renderers) and
+// then carried as text, and the blackbox carries no text at all (blackbox_format.hpp
+// says why). A deferred line is a 32-bit format id plus at most 8 arguments of 9 bytes
+// each — packing one is a handful of stores, and no formatter runs on the robot unless
+// the sink it reaches is a TEXT sink. SdSink and Shul2Sink write the packed line as
+// it is, so the SD file carries log lines at last, at a few dozen bytes each.
+//
+// ── Interning, and where the string table lives ─────────────────────────────────────
+// The id is FNV-1a over the tag and the format string, computed at compile time: the
+// macro passes it as a template argument, so a non-literal format does not compile. A
+// defmt build emits the id→string table at link time; a header-only library has no link
+// step of its own, so the table travels IN-BAND instead. The first time a sink meets an
+// id it writes a FormatDef frame (the tag and the format, once), then only LogArgs
+// frames. A reader joins the two (sim/deferred_log_table.hpp). The format string is in
+// flash either way; what the robot saves is rendering it every time.
+//
+// The same macro also checks, at compile time, that the argument count matches the
+// placeholders and that the tag and format fit their caps (16 and 200 bytes).
+//
+// ── The format language, deliberately small ─────────────────────────────────────────
+//   {}      the argument: integers in decimal, bool as true/false, a double as %g
+//   {:.N}   a double with N decimals (N ≤ 17; ignored for integers)
+//   {{ }}   a literal brace
+// Non-finite doubles render as line_format's tokens ("NaN", "+Inf", "-Inf"). Arguments:
+// any integer, bool, floating-point, enum (as its underlying integer) or units
+// quantity (as its value()). NOT strings — a runtime string has no id to intern, so a
+// line that must carry one goes through log().
+//
+// ── Text sinks still work unchanged ─────────────────────────────────────────────────
+// ITelemetrySink::logDeferred() defaults to rendering the line with formatDeferred() and
+// passing it to log(), so TermSink, FakeTelemetrySink and every sink written before this
+// header show deferred lines as ordinary ones. NullSink overrides it to do nothing, so a
+// competition build renders nothing. Decorators forward it untouched, like the other
+// channels.
+//
+// Allocation-free and never throws. The line is a ~100-byte value built on the caller's
+// stack.
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace shulib::hal {
+/// Declared here, defined in telemetry_sink.hpp (which includes this header).
+enum class LogLevel;
+}  // namespace shulib::hal
+
+namespace shulib::diag {
+
+/// The most arguments one deferred line carries.
+inline constexpr std::size_t kMaxDeferredArgs = 8;
+/// One packed argument: a type byte and 8 little-endian value bytes.
+inline constexpr std::size_t kDeferredArgBytes = 9;
+/// The packed-argument block at its largest: a count byte and every argument.
+inline constexpr std::size_t kMaxDeferredArgsBytes = 1 + kMaxDeferredArgs * kDeferredArgBytes;
+/// The tag cap, in bytes (TermSink's).
+inline constexpr std::size_t kMaxDeferredTagBytes = 16;
+/// The format-string cap, in bytes (TermSink's message cap).
+inline constexpr std::size_t kMaxDeferredFormatBytes = 200;
+/// The largest text formatDeferred() renders for a sink's log(); longer output truncates.
+inline constexpr std::size_t kMaxDeferredTextBytes = 256;
+
+/// A packed argument's type. WIRE-STABLE: explicit values, append-only.
+enum class DeferredArgType : std::uint8_t {
+    Int = 1,     ///< a signed integer, as two's-complement int64
+    Uint = 2,    ///< an unsigned integer, as uint64
+    Double = 3,  ///< a binary64 bit pattern
+    Bool = 4,    ///< 0 or 1
+};
+
+/// The interned id of one (tag, format) pair: 32-bit FNV-1a over the tag, a 0x00
+/// separator and the format. constexpr, so the macro computes it at compile time.
+[[nodiscard]] constexpr std::uint32_t formatId(std::string_view tag,
+                                               std::string_view format) noexcept {
+    std::uint32_t h = 2166136261U;
+    const auto mix = [&h](unsigned char c) {
+        h ^= c;
+        h *= 16777619U;
+    };
+    for (const char c : tag) {
+        mix(static_cast<unsigned char>(c));
+    }
+    mix(0U);
+    for (const char c : format) {
+        mix(static_cast<unsigned char>(c));
+    }
+    return h;
+}
+
+/// The number of `{…}` placeholders in `format` ("{{" and "}}" are literal braces).
+[[nodiscard]] constexpr std::size_t placeholderCount(std::string_view format) noexcept {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < format.size(); ++i) {
+        if (format[i] != '{') {
+            continue;
+        }
+        if (i + 1 < format.size() && format[i + 1] == '{') {
+            ++i;
+            continue;
+        }
+        const std::size_t close = format.find('}', i);
+        if (close == std::string_view::npos) {
+            break;
+        }
+        ++n;
+        i = close;
+    }
+    return n;
+}
+
+/// Whether a tag and a format fit their caps — checked by the macro at compile time.
+[[nodiscard]] constexpr bool deferredLiteralsFit(std::string_view tag,
+                                                 std::string_view format) noexcept {
+    return tag.size() <= kMaxDeferredTagBytes && format.size() <= kMaxDeferredFormatBytes;
+}
+
+/// One deferred log line: the interned id, the literals it was built from (views of
+/// string literals, so valid for the program's life), and the packed arguments.
+struct DeferredLog {
+    hal::LogLevel level{};  ///< the line's level (hal::LogLevel)
+    std::uint32_t id = 0;   ///< formatId(tag, format)
+    std::string_view tag{};     ///< the subsystem tag literal
+    std::string_view format{};  ///< the format literal
+    /// u8 count | count × (u8 DeferredArgType | 8 bytes little-endian).
+    std::array<std::byte, kMaxDeferredArgsBytes> args{};
+    std::size_t argsBytes = 1;  ///< bytes of `args` in use
+
+    /// The packed-argument block, as written to a frame.
+    [[nodiscard]] std::span<const std::byte> packedArgs() const noexcept {
+        return std::span<const std::byte>{args}.first(argsBytes);
+    }
+};
+
+namespace deferred_detail {
+
+/// Append one argument to the packed block and bump its count.
+inline void put(DeferredLog& d, DeferredArgType type, std::uint64_t bits) noexcept {
+    d.args[d.argsBytes] = static_cast<std::byte>(type);
+    for (std::size_t i = 0; i < 8; ++i) {
+        d.args[d.argsBytes + 1 + i] = static_cast<std::byte>((bits >> (8 * i)) & 0xFFU);
+    }
+    d.argsBytes += kDeferredArgBytes;
+    d.args[0] = static_cast<std::byte>(static_cast<unsigned>(d.args[0]) + 1U);
+}
+
+/// Always false; delays pack()'s static_assert until an unsupported type is used.
+template <typename T>
+inline constexpr bool kUnsupported = false;
+
+/// Pack one argument by its type (header note for what is accepted).
+template <typename T>
+inline void pack(DeferredLog& d, const T& v) noexcept {
+    if constexpr (std::is_same_v<T, bool>) {
+        put(d, DeferredArgType::Bool, v ? 1U : 0U);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        put(d, DeferredArgType::Double, std::bit_cast<std::uint64_t>(static_cast<double>(v)));
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        put(d, DeferredArgType::Int, static_cast<std::uint64_t>(static_cast<std::int64_t>(v)));
+    } else if constexpr (std::is_integral_v<T>) {
+        put(d, DeferredArgType::Uint, static_cast<std::uint64_t>(v));
+    } else if constexpr (std::is_enum_v<T>) {
+        pack(d, static_cast<std::underlying_type_t<T>>(v));
+    } else if constexpr (requires { static_cast<double>(v.value()); }) {
+        pack(d, static_cast<double>(v.value()));
+    } else {
+        static_assert(kUnsupported<T>, "SHULIB_LOGF: arguments are integers, bools, floating "
+                                       "point, enums or units quantities — not strings");
+    }
+}
+
+/// Bounded append into a caller buffer; bytes past the end are dropped.
+struct TextOut {
+    std::span<char> out;  ///< the caller's buffer
+    std::size_t at = 0;   ///< bytes written so far
+
+    /// Append `s`, as much as fits.
+    void put(std::string_view s) noexcept {
+        for (const char c : s) {
+            if (at == out.size()) {
+                return;
+            }
+            out[at++] = c;
+        }
+    }
+};
+
+}  // namespace deferred_detail
+
+/// Build a deferred line. Called through SHULIB_LOGF, which supplies the compile-time
+/// template arguments; the static_asserts are the macro's compile-time checks.
+template <std::uint32_t Id, std::size_t Placeholders, bool LiteralsFit, typename... Args>
+[[nodiscard]] inline DeferredLog makeDeferredLog(hal::LogLevel level, std::string_view tag,
+                                                 std::string_view format,
+                                                 const Args&... args) noexcept {
+    static_assert(LiteralsFit, "SHULIB_LOGF: the tag is capped at 16 bytes, the format at 200");
+    static_assert(sizeof...(Args) == Placeholders,
+                  "SHULIB_LOGF: the argument count must match the format's {} placeholders");
+    static_assert(sizeof...(Args) <= kMaxDeferredArgs, "SHULIB_LOGF: at most 8 arguments");
+    DeferredLog d;
+    d.level = level;
+    d.id = Id;
+    d.tag = tag;
+    d.format = format;
+    (deferred_detail::pack(d, args), ...);
+    return d;
+}
+
+/// The ids a binary sink has already defined in its stream — the in-band string table's
+/// writer half (header note). Bounded: once all kSlots are taken, an id not in the table
+/// gets its definition re-sent with every line — more bytes, never a line without one.
+class InternedFormats {
+public:
+    /// How many distinct formats one sink remembers.
+    static constexpr std::size_t kSlots = 64;
+
+    /// Has `id`'s definition already gone into the stream?
+    [[nodiscard]] bool known(std::uint32_t id) const noexcept {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (ids_[i] == id) {
+                return true;
+            }
+        }
+        return false;
+    }
+    /// `id`'s definition is now in the stream. A no-op when the table is full.
+    void remember(std::uint32_t id) noexcept {
+        if (count_ < kSlots) {
+            ids_[count_++] = id;
+        }
+    }
+    /// Forget every definition (a new stream starts).
+    void clear() noexcept { count_ = 0; }
+    /// Ids remembered so far.
+    [[nodiscard]] std::size_t size() const noexcept { return count_; }
+
+private:
+    std::array<std::uint32_t, kSlots> ids_{};
+    std::size_t count_ = 0;
+};
+
+/// Render `format` with the packed arguments `packed` into `out`; returns the bytes
+/// written (truncated at out.size()). A placeholder with no argument, or an argument of
+/// an unknown type, renders "{?}" — the reader sees the line is damaged, not a guess.
+[[nodiscard]] inline std::size_t formatDeferred(std::string_view format,
+                                                std::span<const std::byte> packed,
+                                                std::span<char> out) noexcept {
+    deferred_detail::TextOut text{out};
+    const std::size_t count = packed.empty() ? 0U : static_cast<std::size_t>(packed[0]);
+    std::size_t next = 0;
+    for (std::size_t i = 0; i < format.size(); ++i) {
+        const char c = format[i];
+        if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c) {
+            text.put(std::string_view{&format[i], 1});
+            ++i;
+            continue;
+        }
+        const std::size_t close = c == '{' ? format.find('}', i) : std::string_view::npos;
+        if (close == std::string_view::npos) {
+            text.put(std::string_view{&format[i], 1});
+            continue;
+        }
+        // The one spec understood: ":.N", a double's decimals.
+        const std::string_view spec = format.substr(i + 1, close - i - 1);
+        int decimals = -1;
+        if (spec.size() >= 3 && spec[0] == ':' && spec[1] == '.') {
+            decimals = 0;
+            for (const char d : spec.substr(2)) {
+                if (d >= '0' && d <= '9' && decimals < 100) {
+                    decimals = decimals * 10 + (d - '0');
+                }
+            }
+            decimals = decimals > 17 ? 17 : decimals;
+        }
+        i = close;
+        const std::size_t at = 1 + next * kDeferredArgBytes;
+        if (next >= count || at + kDeferredArgBytes > packed.size()) {
+            text.put("{?}");
+            continue;
+        }
+        ++next;
+        std::uint64_t bits = 0;
+        for (std::size_t k = 0; k < 8; ++k) {
+            bits |= static_cast<std::uint64_t>(packed[at + 1 + k]) << (8 * k);
+        }
+        char buf[48];
+        int n = -1;
+        switch (static_cast<DeferredArgType>(packed[at])) {
+            case DeferredArgType::Int:
+                n = std::snprintf(buf, sizeof buf, "%lld",
+                                  static_cast<long long>(static_cast<std::int64_t>(bits)));
+                break;
+            case DeferredArgType::Uint:
+                n = std::snprintf(buf, sizeof buf, "%llu", static_cast<unsigned long long>(bits));
+                break;
+            case DeferredArgType::Bool:
+                n = std::snprintf(buf, sizeof buf, "%s", bits != 0 ? "true" : "false");
+                break;
+            case DeferredArgType::Double: {
+                const auto v = std::bit_cast<double>(bits);
+                if (std::isnan(v)) {
+                    n = std::snprintf(buf, sizeof buf, "NaN");
+                } else if (std::isinf(v)) {
+                    n = std::snprintf(buf, sizeof buf, "%s", v > 0 ? "+Inf" : "-Inf");
+                } else if (decimals >= 0) {
+                    n = std::snprintf(buf, sizeof buf, "%.*f", decimals, v);
+                } else {
+                    n = std::snprintf(buf, sizeof buf, "%g", v);
+                }
+                break;
+            }
+            default: break;
+        }
+        if (n < 0) {
+            text.put("{?}");
+            continue;
+        }
+        const auto len = static_cast<std::size_t>(n) < sizeof buf ? static_cast<std::size_t>(n)
+                                                                   : sizeof buf - 1;
+        text.put(std::string_view{buf, len});
+    }
+    return text.at;
+}
+
+/// Render a deferred line's text into `out` (formatDeferred() over its own literals).
+[[nodiscard]] inline std::size_t formatDeferred(const DeferredLog& line,
+                                                std::span<char> out) noexcept {
+    return formatDeferred(line.format, line.packedArgs(), out);
+}
+
+}  // namespace shulib::diag
+
+/// Log one deferred-formatting line through `sink` (any ITelemetrySink): the format is
+/// interned at compile time and the arguments are packed, never formatted here (header
+/// note). `tag` and `format` must be string literals; the argument count must match.
+#define SHULIB_LOGF(sink, level, tag, format, ...)                                           \
+    ((sink).logDeferred(::shulib::diag::makeDeferredLog<                                     \
+                        ::shulib::diag::formatId((tag), (format)),                           \
+                        ::shulib::diag::placeholderCount((format)),                          \
+                        ::shulib::diag::deferredLiteralsFit((tag), (format))>(               \
+        (level), (tag), (format)__VA_OPT__(, ) __VA_ARGS__)))
@@ -0,0 +1,178 @@
+#pragma once
+//
+// EventRing — the flight recorder for TRANSITIONS: a compact RAM ring of fault raises and
+// clears, motion starts and exits, fusion-gate verdict changes, IMU ready edges and
+// brownout edges, independent of the per-tick records.
+//
+// ── Why a second ring ───────────────────────────────────────────────────────────────
+// SdSink's D-6 ring holds the last 200 TICKS — about two seconds, at ~430 bytes a tick.
+// That is the right depth for "what was the robot doing when it broke", and the wrong one
+// for "what had already gone wrong before that": the IMU that dropped out forty seconds
+// earlier, the brownout in the first motion, the third motion that timed out. Those are a
+// handful of EDGES spread across a whole run, and a tick ring deep enough to reach them
+// would cost megabytes. An event is 16 bytes, so the default ring holds 512 of them — a
+// whole auton's transitions, and most of a practice session's — in 8 KiB, and it is
+// dumped into the blackbox beside the tick ring (sd_sink.hpp), so the file answers both
+// questions.
+//
+// ── Who records what ────────────────────────────────────────────────────────────────
+// The ring is passive; each producer is handed a pointer (nullptr = off, the default) and
+// records only its own edges:
+//   * FaultLatch::setEventRing — FaultRaised for every raise (the cascade included; the
+//     latch still owns which one was first).
+//   * HealthMonitor::setEventRing — FaultCleared when one of its episodes re-arms, every
+//     IMU isReady() edge (the boot window included, which no fault covers), and the
+//     brownout hysteresis edges with the battery voltage on them.
+//   * MotionSchedulerConfig::events — MotionStart and MotionExit (with the exit reason and
+//     the aborting fault), and GateChange whenever the fusion gate's verdict flips between
+//     accepting and rejecting fixes. Ticks with no verdict (no proposal, no fix, a fix
+//     already folded) do not count as a flip, or a 20 Hz GPS under a 100 Hz loop would
+//     fill the ring with accept/stale pairs.
+// Edges, never levels: nothing records on a tick where nothing changed, so a quiet run
+// costs nothing past the pointer test.
+//
+// ── The layout ──────────────────────────────────────────────────────────────────────
+// Event is exactly 16 bytes, pinned by static_assert: the time as binary64 (the blackbox's
+// no-narrowing rule), a kind, a kind-specific code, a 16-bit aux and a 32-bit value —
+// EventKind's doc says what each carries. The storage is caller-owned (SdSinkStorage's
+// precedent — never a task stack); the ring overwrites its OLDEST event when full and
+// counts every event ever recorded, so a dump can say how many it no longer holds.
+//
+// Single-task by contract, like the rest of diag/. Nothing here allocates, and record() is
+// noexcept — it is called from fault paths.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "shulib/hal/clock.hpp"
+
+namespace shulib::diag {
+
+/// The recommended ring depth: 512 events, 8 KiB. PROVISIONAL (A4: HA-131) — an INVENTED
+/// depth: nobody has yet counted how many transitions a real run produces.
+inline constexpr std::size_t kDefaultEventRingEvents = 512;
+
+/// What an Event records, and what its code/aux/value fields mean for that kind.
+/// WIRE-STABLE: explicit values, append-only — these travel in EventLog blackbox frames.
+enum class EventKind : std::uint8_t {
+    None = 0,          ///< an empty slot; never recorded
+    FaultRaised = 1,   ///< code FaultCode; value the code's raise count, this one included
+    FaultCleared = 2,  ///< code FaultCode — a HealthMonitor episode re-armed
+    MotionStart = 3,   ///< value the motion's command id
+    MotionExit = 4,    ///< code ExitReason; aux the aborting FaultCode (0: none); value the id
+    GateChange = 5,    ///< code the new verdict's GateReason; aux the previous verdict's
+    ImuReady = 6,      ///< the IMU's isReady() went true
+    ImuNotReady = 7,   ///< the IMU's isReady() went false (boot window included)
+    BrownoutOn = 8,    ///< the battery fell to the brownout threshold; value millivolts
+    BrownoutOff = 9,   ///< the battery recovered above the re-arm level; value millivolts
+};
+
+/// A short upper-case name for `kind` ("UNKNOWN" for a value this build does not know).
+[[nodiscard]] constexpr const char* eventKindName(EventKind kind) noexcept {
+    switch (kind) {
+        case EventKind::None: return "NONE";
+        case EventKind::FaultRaised: return "FAULT_RAISED";
+        case EventKind::FaultCleared: return "FAULT_CLEARED";
+        case EventKind::MotionStart: return "MOTION_START";
+        case EventKind::MotionExit: return "MOTION_EXIT";
+        case EventKind::GateChange: return "GATE_CHANGE";
+        case EventKind::ImuReady: return "IMU_READY";
+        case EventKind::ImuNotReady: return "IMU_NOT_READY";
+        case EventKind::BrownoutOn: return "BROWNOUT_ON";
+        case EventKind::BrownoutOff: return "BROWNOUT_OFF";
+    }
+    return "UNKNOWN";
+}
+
+/// One transition (header: "the layout").
+struct Event {
+    double t = 0.0;                      ///< seconds, on the ring's clock
+    EventKind kind = EventKind::None;    ///< what happened
+    std::uint8_t code = 0;               ///< kind-specific (EventKind)
+    std::uint16_t aux = 0;               ///< kind-specific (EventKind)
+    std::uint32_t value = 0;             ///< kind-specific (EventKind)
+
+    /// Field-wise equality.
+    friend bool operator==(const Event&, const Event&) = default;
+};
+static_assert(sizeof(Event) == 16, "an Event is 16 bytes — the ring's whole budget rests on it");
+
+/// A fixed ring of Events over caller-owned storage, overwriting the oldest when full
+/// (header). Holds `clock` by NON-OWNING reference. Single-task; allocates nothing.
+class EventRing {
+public:
+    /// `clock` timestamps every event and must outlive the ring; `storage` is caller-owned
+    /// and may be empty (every record() is then counted and lost).
+    EventRing(hal::IClock& clock, std::span<Event> storage) noexcept
+        : clock_{clock}, storage_{storage} {}
+
+    /// Record one transition, stamped now. Never throws: a throwing clock stamps 0.
+    void record(EventKind kind, std::uint8_t code = 0, std::uint16_t aux = 0,
+                std::uint32_t value = 0) noexcept {
+        ++recorded_;
+        if (storage_.empty()) {
+            return;
+        }
+        double t = 0.0;
+        try {
+            t = clock_.now().value();
+        } catch (...) {
+            // A throwing clock violates its contract; the edge is still worth keeping.
+        }
+        storage_[head_] = Event{t, kind, code, aux, value};
+        head_ = (head_ + 1) % storage_.size();
+        if (count_ < storage_.size()) {
+            ++count_;
+        }
+    }
+
+    /// Events currently held (≤ capacity()).
+    [[nodiscard]] std::size_t size() const noexcept { return count_; }
+    /// The storage's depth.
+    [[nodiscard]] std::size_t capacity() const noexcept { return storage_.size(); }
+    /// The `i`-th held event, OLDEST first (i < size(); out of range reads an empty Event).
+    [[nodiscard]] Event at(std::size_t i) const noexcept {
+        if (i >= count_) {
+            return Event{};
+        }
+        return storage_[(head_ + storage_.size() - count_ + i) % storage_.size()];
+    }
+    /// Events recorded since construction/clear(), held or not. The oldest held event is
+    /// number recorded() − size(), counting from 0 — what lets a reader resume after it.
+    [[nodiscard]] std::uint32_t recorded() const noexcept { return recorded_; }
+    /// Events recorded and since overwritten (or lost to empty storage).
+    [[nodiscard]] std::uint32_t overwritten() const noexcept {
+        return recorded_ - static_cast<std::uint32_t>(count_);
+    }
+
+    /// New-run boundary (mirrors FaultLatch::clear()): forget every event and the count.
+    void clear() noexcept {
+        head_ = 0;
+        count_ = 0;
+        recorded_ = 0;
+    }
+
+private:
+    hal::IClock& clock_;
+    std::span<Event> storage_;
+    std::size_t head_ = 0;   // next slot to write
+    std::size_t count_ = 0;  // slots in use
+    std::uint32_t recorded_ = 0;
+};
+
+/// The one-liner for the common case, as SdSinkBuffers: declare it at file scope (or as a
+/// static) and hand view() to the ring.
+///
+///     static shulib::diag::EventRingBuffer<> eventRam;
+///     shulib::diag::EventRing events{clock, eventRam.view()};
+template <std::size_t Events = kDefaultEventRingEvents>
+struct EventRingBuffer {
+    /// The ring storage.
+    std::array<Event, Events> events{};
+    /// A span over the storage, for the EventRing constructor.
+    [[nodiscard]] std::span<Event> view() noexcept { return std::span<Event>{events}; }
+};
+
+}  // namespace shulib::diag
@@ -33,6 +33,7 @@
 #include <cstdio>
 #include <string_view>
 
+#include "shulib/diag/event_ring.hpp"
 #include "shulib/hal/clock.hpp"
 #include "shulib/hal/telemetry_sink.hpp"
 #include "shulib/units/quantity.hpp"
@@ -120,6 +121,10 @@ public:
         if (isFirst) {
             first_ = code;
         }
+        if (events_ != nullptr) {
+            events_->record(EventKind::FaultRaised, static_cast<std::uint8_t>(code), 0,
+                            static_cast<std::uint32_t>(raiseCount(code)));
+        }
         try {
             if (isFirst) {
                 firstTime_ = clock_.now();
@@ -160,6 +165,11 @@ public:
     /// Total faults raised since construction/clear() (first + cascade).
     [[nodiscard]] int faultCount() const noexcept { return count_; }
 
+    /// Record every raise as a FaultRaised event in `ring` (diag/event_ring.hpp) —
+    /// nullptr detaches, the default. NON-OWNING: the ring must outlive the latch or be
+    /// detached first. clear() leaves the ring alone; it is the caller's to clear.
+    void setEventRing(EventRing* ring) noexcept { events_ = ring; }
+
     /// Reset between runs. The first-fault latch is immutable WITHIN a run by design;
     /// only an explicit new-run boundary may clear it.
     void clear() noexcept {
@@ -183,6 +193,7 @@ private:
     units::Time firstTime_{0.0};
     int count_ = 0;
     std::array<std::uint16_t, kCodeSlots> perCode_{};
+    EventRing* events_ = nullptr;  // optional transition recorder (setEventRing)
 };
 
 }  // namespace shulib::diag
@@ -50,13 +50,18 @@
 //  * brownoutVolts default 10.5 V — PROVISIONAL (A4 register HA-42): the true V5
 //    cutoff behaviour under load is unmeasured until R3/R4.
 //    (Register: docs/hardware-assumptions.md.)
+//  * With an EventRing attached (setEventRing) the EDGES are recorded too — the IMU's
+//    ready/not-ready changes, brownout on/off, and each episode's clear — which is the
+//    half of an episode a fault alone never shows (diag/event_ring.hpp).
 //
 // Single-task by contract, like the rest of diag/ (see fault.hpp).
 
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 
 #include "shulib/core/check.hpp"
+#include "shulib/diag/event_ring.hpp"
 #include "shulib/diag/fault.hpp"
 #include "shulib/units/quantity.hpp"
 
@@ -137,9 +142,14 @@ public:
     /// Evaluate one tick's observables; raise one fault per NEW episode (header).
     void tick(const Observations& o) {
         // IMU: ready-at-least-once → lost. (Boot window: never-ready is not a loss.)
+        if (o.imuReady != imuReadyLast_ || !observed_) {
+            record(o.imuReady ? EventKind::ImuReady : EventKind::ImuNotReady);
+            imuReadyLast_ = o.imuReady;
+        }
+        observed_ = true;
         if (o.imuReady) {
             imuSeenReady_ = true;
-            imuLostActive_ = false;  // recovered → re-arm
+            cleared(imuLostActive_, FaultCode::ImuLost);  // recovered → re-arm
         } else if (imuSeenReady_ && !imuLostActive_) {
             imuLostActive_ = true;
             faults_.raise(FaultCode::ImuLost, "IMU", "isReady dropped mid-run");
@@ -153,7 +163,7 @@ public:
                           o.odomStalled ? "wheels spin but odometry reports no motion"
                                         : "implausible odometry tick");
         } else if (!odoBad) {
-            odoActive_ = false;
+            cleared(odoActive_, FaultCode::OdoStuck);
         }
 
         // Fusion gate: a fix arrived and was rejected (a lying absolute source).
@@ -161,7 +171,7 @@ public:
             gateActive_ = true;
             faults_.raise(FaultCode::GpsGateReject, "LOC", "fix rejected by fusion gate");
         } else if (!o.fixGated) {
-            gateActive_ = false;
+            cleared(gateActive_, FaultCode::GpsGateReject);
         }
 
         // Battery: trip at/below the threshold; re-arm only above the recover level.
@@ -170,12 +180,17 @@ public:
             if (!brownoutActive_) {
                 brownoutActive_ = true;
                 brownedOut_ = true;  // the run-scoped latched marker (E1 semantics)
+                record(EventKind::BrownoutOn, 0, millivolts(v));
                 char buf[48];
                 std::snprintf(buf, sizeof buf, "battery=%.2fV", v);
                 faults_.raise(FaultCode::Brownout, "PWR", buf);
             }
         } else if (v >= cfg_.brownoutRecoverVolts.value()) {
-            brownoutActive_ = false;  // hysteresis: only a real recovery re-arms
+            if (brownoutActive_) {
+                record(EventKind::BrownoutOff, 0, millivolts(v));
+            }
+            // Hysteresis: only a real recovery re-arms.
+            cleared(brownoutActive_, FaultCode::Brownout);
         }
 
         // Motor thermal: any motor at/over the throttle threshold.
@@ -187,7 +202,7 @@ public:
                 faults_.raise(FaultCode::MotorOverTemp, "PWR", buf);
             }
         } else {
-            overTempActive_ = false;
+            cleared(overTempActive_, FaultCode::MotorOverTemp);
         }
     }
 
@@ -196,9 +211,19 @@ public:
     /// True while the IMU is in a lost episode (seen ready, currently not).
     [[nodiscard]] bool imuLost() const noexcept { return imuLostActive_; }
 
+    /// Record this monitor's transitions in `ring` (diag/event_ring.hpp) — nullptr detaches,
+    /// the default. Every IMU isReady() edge (the first tick's state included, so a boot
+    /// window shows as NOT_READY → READY), each brownout hysteresis edge with the battery in
+    /// millivolts, and a FaultCleared whenever an episode re-arms. The raises themselves are
+    /// the latch's to record (FaultLatch::setEventRing). NON-OWNING: the ring must outlive
+    /// the monitor or be detached first.
+    void setEventRing(EventRing* ring) noexcept { events_ = ring; }
+
     /// New-run boundary (mirrors FaultLatch::clear()): forget episodes AND the
     /// brownout marker; the boot-window rule starts over (imuSeenReady resets).
     void reset() noexcept {
+        observed_ = false;
+        imuReadyLast_ = false;
         imuSeenReady_ = false;
         imuLostActive_ = false;
         odoActive_ = false;
@@ -209,6 +234,24 @@ public:
     }
 
 private:
+    void record(EventKind kind, std::uint8_t code = 0, std::uint32_t value = 0) noexcept {
+        if (events_ != nullptr) {
+            events_->record(kind, code, 0, value);
+        }
+    }
+
+    /// End an episode: lower `active` and, if it was up, record the clear.
+    void cleared(bool& active, FaultCode code) noexcept {
+        if (active) {
+            record(EventKind::FaultCleared, static_cast<std::uint8_t>(code));
+        }
+        active = false;
+    }
+
+    [[nodiscard]] static std::uint32_t millivolts(double volts) noexcept {
+        return volts > 0.0 ? static_cast<std::uint32_t>(std::lround(volts * 1000.0)) : 0U;
+    }
+
     FaultLatch& faults_;
     HealthMonitorConfig cfg_;
     bool imuSeenReady_ = false;
@@ -218,6 +261,9 @@ private:
     bool brownoutActive_ = false;
     bool brownedOut_ = false;
     bool overTempActive_ = false;
+    bool observed_ = false;      // a tick has been seen since construction/reset()
+    bool imuReadyLast_ = false;  // last tick's imuReady, for the edge events
+    EventRing* events_ = nullptr;  // optional transition recorder (setEventRing)
 };
 
 }  // namespace shulib::diag
@@ -95,6 +95,13 @@ public:
         }
     }
 
+    /// The same threshold as log(), then forwarded still packed — the filter never renders it.
+    void logDeferred(const DeferredLog& line) override {
+        if (passes(line.level, line.tag)) {
+            inner_->logDeferred(line);
+        }
+    }
+
     /// Whatever the inner sink answers — this decorator never suppresses record POPULATION.
     /// Answered as a PAIR with emit(), which is the seam's rule: overriding one without the
     /// other is how a sink ends up paying to build records it then throws away.
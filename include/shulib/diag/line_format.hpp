@@ -16,6 +16,15 @@
 //     locale/sign-varying spellings; a rendering longer than kCompactThresholdBytes
 //     re-renders compactly as %.3g (the column widens slightly rather than exploding
 //     to 300+ digits).
+//   * appendNum's fixed path: precisions 0–3 over |v| < kFastFixedBound are rendered
+//     by integer arithmetic instead of snprintf — byte-identical, not approximately so.
+//     glibc's %f rounds the EXACT binary value to nearest, ties to even, so the fast
+//     path does the same: it scales the double's 53-bit mantissa by 10^prec in 64-bit
+//     integers (10^3 < 2^10, so it cannot overflow) and rounds on the exact remainder.
+//     Scaling in floating point first (v * 100 + 0.5) would be off by one on values like
+//     2.675 or 0.125, which is the bug the golden tests would catch a year later. A
+//     negative value that rounds to zero keeps its sign ("-0.00"), as %f does. Anything
+//     outside the path, and the %.3g compaction, still goes through snprintf.
 //   * Line: a bounded stack buffer (no heap, hot-path safe); appends that would
 //     overflow truncate silently — the bound is enforced, not assumed.
 //   * appendSanitized: the ONLY entry point for caller-controlled text — control
@@ -28,7 +37,9 @@
 // Concurrency: everything here is stateless free functions plus a caller-owned
 // stack value (Line). Nothing allocates; nothing is shared.
 
+#include <bit>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <string_view>
@@ -39,6 +50,13 @@ namespace shulib::diag::lineformat {
 /// 10 comfortably admits every sane field value (±144.00 coords, ±9999.99 t).
 inline constexpr int kCompactThresholdBytes = 10;
 
+/// appendNum's integer path covers precisions 0..kFastFixedMaxPrecision (header note).
+inline constexpr int kFastFixedMaxPrecision = 3;
+
+/// ...and magnitudes below this. Far above any §18.3 field (±144 in, ±9999.99 s), and low
+/// enough that the scaled value always fits the integer path with room to spare.
+inline constexpr double kFastFixedBound = 1e9;
+
 /// One output line: a bounded stack buffer (no heap, hot-path safe). Appends that
 /// would overflow truncate silently — unreachable with the fixed widths the §18.3
 /// renderers use, but the bound is enforced, not assumed.
@@ -114,6 +132,78 @@ inline void appendPadded(Line& line, const char* s, int width) {
     line.appendRaw(s, static_cast<std::size_t>(len));
 }
 
+namespace detail {
+
+/// Write `v`'s decimal digits ending just before `end`; returns the first digit's address.
+inline char* digitsBackward(char* end, std::uint64_t v) noexcept {
+    do {
+        *--end = static_cast<char>('0' + v % 10U);
+        v /= 10U;
+    } while (v != 0U);
+    return end;
+}
+
+/// |v| × 10^prec rounded to nearest, ties to even, on the EXACT binary value — the rounding
+/// glibc's %f performs (header note). Requires finite |v| < kFastFixedBound, prec 0..3.
+inline std::uint64_t scaledRound(double v, int prec) noexcept {
+    static constexpr std::uint64_t kPow10[] = {1U, 10U, 100U, 1000U};
+    const std::uint64_t bits = std::bit_cast<std::uint64_t>(v) & ~(std::uint64_t{1} << 63);
+    const int biased = static_cast<int>(bits >> 52);
+    if (biased == 0 && (bits & ((std::uint64_t{1} << 52) - 1U)) == 0U) {
+        return 0U;  // ±0
+    }
+    // v = mant × 2^exp exactly, with mant < 2^53.
+    std::uint64_t mant = bits & ((std::uint64_t{1} << 52) - 1U);
+    int exp = 0;
+    if (biased == 0) {
+        exp = -1074;  // subnormal
+    } else {
+        mant |= std::uint64_t{1} << 52;
+        exp = biased - 1075;
+    }
+    const std::uint64_t scaled = mant * kPow10[prec];  // < 2^63
+    if (exp >= 0) {
+        return scaled << exp;  // |v| < 1e9 bounds this far below 2^64
+    }
+    const int shift = -exp;
+    if (shift >= 64) {
+        return 0U;  // below half a unit of the last place: scaled < 2^63 <= half
+    }
+    const std::uint64_t q = scaled >> shift;
+    const std::uint64_t rem = scaled & ((std::uint64_t{1} << shift) - 1U);
+    const std::uint64_t half = std::uint64_t{1} << (shift - 1);
+    return (rem > half || (rem == half && (q & 1U) != 0U)) ? q + 1U : q;
+}
+
+/// %*.*f for finite |v| < kFastFixedBound and prec 0..3, into `out` (≥ 40 bytes); returns
+/// the length, exactly as snprintf would.
+inline int fixedFormat(char* out, double v, int width, int prec) noexcept {
+    static constexpr std::uint64_t kPow10[] = {1U, 10U, 100U, 1000U};
+    const std::uint64_t q = scaledRound(v, prec);
+    char digits[32];
+    char* const end = digits + sizeof digits;
+    char* p = end;
+    if (prec > 0) {
+        std::uint64_t frac = q % kPow10[prec];
+        for (int i = 0; i < prec; ++i) {
+            *--p = static_cast<char>('0' + frac % 10U);
+            frac /= 10U;
+        }
+        *--p = '.';
+    }
+    p = digitsBackward(p, q / kPow10[prec]);
+    if (std::signbit(v)) {
+        *--p = '-';
+    }
+    const int len = static_cast<int>(end - p);
+    const int pad = width > len ? width - len : 0;
+    std::memset(out, ' ', static_cast<std::size_t>(pad));
+    std::memcpy(out + pad, p, static_cast<std::size_t>(len));
+    return pad + len;
+}
+
+}  // namespace detail
+
 /// Fixed-width numeric column (header contract): finite values via %*.*f; non-finite
 /// as deterministic right-aligned tokens; pathologically wide values compacted to %.3g.
 inline void appendNum(Line& line, double v, int width, int prec) {
@@ -126,7 +216,13 @@ inline void appendNum(Line& line, double v, int width, int prec) {
         return;
     }
     char tmp[40];
-    int len = std::snprintf(tmp, sizeof tmp, "%*.*f", width, prec, v);
+    int len = 0;
+    if (prec >= 0 && prec <= kFastFixedMaxPrecision && width >= 0 && width <= 24
+        && std::fabs(v) < kFastFixedBound) {
+        len = detail::fixedFormat(tmp, v, width, prec);
+    } else {
+        len = std::snprintf(tmp, sizeof tmp, "%*.*f", width, prec, v);
+    }
     // "Pathological" means LONGER THAN THE CALLER ASKED FOR, not longer than a fixed 10. A
     // %*.*f rendering is at least `width` bytes, so comparing against the constant alone
     // compacted away every column wider than 10 for perfectly ordinary values —
@@ -147,10 +243,8 @@ inline void appendNum(Line& line, double v, int width, int prec) {
 /// principle but never pathological in practice, so no column can be reserved for them anyway.
 inline void appendUnsigned(Line& line, unsigned long v) {
     char tmp[24];
-    const int len = std::snprintf(tmp, sizeof tmp, "%lu", v);
-    if (len > 0) {
-        line.appendRaw(tmp, static_cast<std::size_t>(len));
-    }
+    const char* const first = detail::digitsBackward(tmp + sizeof tmp, v);
+    line.appendRaw(first, static_cast<std::size_t>(tmp + sizeof tmp - first));
 }
 
 /// The §18.3 "[t=%7.2f] " stamp every timestamped line opens with.
@@ -24,6 +24,11 @@
 // not count toward worstDt(). reset() exists for deliberate pauses (e.g. between runs)
 // so a legitimate gap is not reported as an overrun.
 //
+// worstDt() alone cannot tell a loop that is sometimes 14.9 ms from one that always
+// is, so every measured dt also lands in a fixed-bin histogram (tick_histogram.hpp):
+// dtHistogram() yields p50/p95/p99/max at run end, which is the evidence `budget` is
+// meant to be set from. Baseline ticks are not samples, exactly as for worstDt().
+//
 // Single-task by contract, like the rest of diag/ (see fault.hpp's concurrency note).
 
 #include <algorithm>
@@ -31,6 +36,7 @@
 
 #include "shulib/core/check.hpp"
 #include "shulib/diag/fault.hpp"
+#include "shulib/diag/tick_histogram.hpp"
 #include "shulib/hal/clock.hpp"
 #include "shulib/units/quantity.hpp"
 
@@ -43,6 +49,10 @@ struct LoopMonitorConfig {
     /// The dt at which a tick counts as an overrun (INCLUSIVE — see header). Must be > 0
     /// and strictly greater than the nominal tick period.
     units::Time budget{0.015};
+    /// Span of the dt histogram's log bins (tick_histogram.hpp). The 5–50 ms default
+    /// brackets a 10 ms loop with room for a stall; a dt outside it still counts, in the
+    /// under/overflow bin, and max stays exact.
+    TickHistogramRange dtHistogram{};
 };
 
 /// Loop-overrun detection: it measures the real dt between consecutive tick() calls on the
@@ -58,7 +68,7 @@ public:
     /// greater than the nominal tick period — a tick exactly AT the budget is an overrun, so a
     /// 10 ms budget on a 10 ms loop faults on every tick.
     LoopMonitor(hal::IClock& clock, FaultLatch& faults, const LoopMonitorConfig& config = {})
-        : clock_{clock}, faults_{faults}, config_{config} {
+        : clock_{clock}, faults_{faults}, config_{config}, dtHistogram_{config.dtHistogram} {
         SHULIB_PRECONDITION(config.budget.value() > 0.0, "LoopMonitor: budget must be > 0");
     }
 
@@ -74,6 +84,7 @@ public:
         const units::Time dt = now - lastNow_;
         lastNow_ = now;
         worstDt_ = std::max(worstDt_, dt);
+        dtHistogram_.record(dt);
         if (dt.value() >= config_.budget.value()) {
             ++overrunCount_;
             char buf[64];
@@ -92,8 +103,13 @@ public:
     /// and reset() does not clear it, so this is a whole-run total. Baseline ticks never count.
     [[nodiscard]] int overrunCount() const noexcept { return overrunCount_; }
 
+    /// Every measured dt since construction, binned — the distribution worstDt() is the tip
+    /// of. Like overrunCount(), reset() does not clear it: it is a whole-run record.
+    [[nodiscard]] const TickHistogram& dtHistogram() const noexcept { return dtHistogram_; }
+
     /// Re-baseline after a DELIBERATE gap (run boundary, pause): the next tick() only
-    /// baselines, so the gap is not misreported as an overrun. Keeps worstDt/counts.
+    /// baselines, so the gap is not misreported as an overrun. Keeps worstDt/counts and
+    /// the dt histogram.
     void reset() noexcept { hasLast_ = false; }
 
 private:
@@ -102,6 +118,7 @@ private:
     LoopMonitorConfig config_;
     units::Time lastNow_{0.0};
     units::Time worstDt_{0.0};
+    TickHistogram dtHistogram_;
     int overrunCount_ = 0;
     bool hasLast_ = false;
 };
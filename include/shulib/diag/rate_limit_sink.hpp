@@ -35,6 +35,15 @@
 // the exact failure D-2 exists to prevent. With NullSink inner, wantsRecord() is
 // false and nothing is built or counted: the competition build stays free.
 //
+// Load shedding is the one sanctioned exception (diag/tick_budget.hpp): with a
+// TickBudget attached and RecordPopulation shed THIS tick, wantsRecord() answers false
+// and population is skipped. That is not the invisible drop the paragraph above
+// rejects — the budget counts every shed tick in observe() and the count reaches the
+// summary — and it is what makes a hot loop cheaper rather than merely quieter. A
+// record that arrives anyway (another consumer beside this one paid for it) is not
+// forwarded either, and is counted in shedRecords(), never in droppedRecords(): a
+// deliberate shed and a bandwidth drop are different stories.
+//
 // The default budgets are TERMINAL-BANDWIDTH choices (a 115200-baud serial console
 // renders ~120 of these lines/s; half a stream of 100 Hz records is plenty for a
 // live eye), not hardware claims — logic constants, no register entry, and any
@@ -50,6 +59,7 @@
 
 #include "shulib/core/check.hpp"
 #include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/tick_budget.hpp"
 #include "shulib/hal/clock.hpp"
 #include "shulib/hal/telemetry_sink.hpp"
 
@@ -96,38 +106,28 @@ public:
     /// line, so the gap is explained exactly where it sits.
     void log(hal::LogLevel level, std::string_view subsystem,
              std::string_view message) override {
-        // The error path is never throttled (header contract).
-        if (level == hal::LogLevel::Error || level == hal::LogLevel::Warn) {
+        if (admitLine(level, subsystem)) {
             inner_->log(level, subsystem, message);
-            return;
         }
-        Channel& ch = channelFor(subsystem);
-        refill(ch.bucket, cfg_.linesPerSecondPerChannel);
-        if (ch.bucket.tokens < 1.0) {
-            ++droppedLines_;
-            ++ch.pendingDropped;
-            return;
-        }
-        ch.bucket.tokens -= 1.0;
-        if (ch.pendingDropped > 0) {
-            // The episode ends where the channel resumes: one structured notice,
-            // BEFORE the resuming line, so the gap is explained where it sits.
-            char buf[96];
-            // %lu + cast: uint32_t is unsigned int on the host but unsigned long
-            // on the ARM target — the cast is what keeps -Werror=format clean on
-            // BOTH (caught by the A4 ARM gate at C5).
-            std::snprintf(buf, sizeof buf, "throttled %.*s: dropped %lu lines",
-                          static_cast<int>(subsystem.size()), subsystem.data(),
-                          static_cast<unsigned long>(ch.pendingDropped));
-            inner_->log(hal::LogLevel::Warn, "DIA", buf);
-            ch.pendingDropped = 0;
+    }
+
+    /// The same per-tag budget as log() — a deferred line is a line — then forwarded still
+    /// packed. The throttle notice itself is a plain log() line.
+    void logDeferred(const DeferredLog& line) override {
+        if (admitLine(line.level, line.tag)) {
+            inner_->logDeferred(line);
         }
-        inner_->log(level, subsystem, message);
     }
 
     /// Forwards the INNER answer even when the bucket is empty (header cost note:
-    /// drops must be seen to be counted) — the pair rule, one level up.
-    [[nodiscard]] bool wantsRecord() const noexcept override { return inner_->wantsRecord(); }
+    /// drops must be seen to be counted) — the pair rule, one level up. The one
+    /// exception: false while an attached TickBudget sheds RecordPopulation (header).
+    [[nodiscard]] bool wantsRecord() const noexcept override {
+        if (recordsShed()) {
+            return false;
+        }
+        return inner_->wantsRecord();
+    }
 
     /// Forward one record unless the record bucket is empty, STAMPING the running drop
     /// totals onto the copy that survives — so a gap in the stream carries its own
@@ -135,6 +135,10 @@ public:
     /// caller has ALREADY paid to populate `record` (see wantsRecord()): throttling here
     /// buys bandwidth, not the cost of building it.
     void emit(const DebugRecord& record) override {
+        if (recordsShed()) {
+            ++shedRecords_;  // a shed, not a drop: no token spent, not in droppedRecords()
+            return;
+        }
         refill(recordBucket_, cfg_.recordsPerSecond);
         if (recordBucket_.tokens < 1.0) {
             ++droppedRecords_;
@@ -158,8 +162,52 @@ public:
     /// the shared overflow bucket. Error and Warn are never throttled, so they can never
     /// appear in this number — a non-zero count is always lost detail, never a lost fault.
     [[nodiscard]] std::uint32_t droppedLines() const noexcept { return droppedLines_; }
+    /// Records that reached emit() while RecordPopulation was shed and were not forwarded
+    /// (header). Kept apart from droppedRecords() on purpose; usually 0, because a shed
+    /// tick normally skips population altogether.
+    [[nodiscard]] std::uint32_t shedRecords() const noexcept { return shedRecords_; }
+
+    /// Attach the load shedder whose RecordPopulation class gates this sink (nullptr
+    /// detaches — the default, and then nothing is ever shed). NON-OWNING: the budget
+    /// must outlive the sink or be detached first.
+    void setTickBudget(const TickBudget* budget) noexcept { budget_ = budget; }
 
 private:
+    /// log()'s and logDeferred()'s shared gate: true if the line may go out, after writing
+    /// the resume notice when it ends a throttled episode; false if it was dropped and counted.
+    [[nodiscard]] bool admitLine(hal::LogLevel level, std::string_view subsystem) {
+        // The error path is never throttled (header contract).
+        if (level == hal::LogLevel::Error || level == hal::LogLevel::Warn) {
+            return true;
+        }
+        Channel& ch = channelFor(subsystem);
+        refill(ch.bucket, cfg_.linesPerSecondPerChannel);
+        if (ch.bucket.tokens < 1.0) {
+            ++droppedLines_;
+            ++ch.pendingDropped;
+            return false;
+        }
+        ch.bucket.tokens -= 1.0;
+        if (ch.pendingDropped > 0) {
+            // The episode ends where the channel resumes: one structured notice,
+            // BEFORE the resuming line, so the gap is explained where it sits.
+            char buf[96];
+            // %lu + cast: uint32_t is unsigned int on the host but unsigned long
+            // on the ARM target — the cast is what keeps -Werror=format clean on
+            // BOTH (caught by the A4 ARM gate at C5).
+            std::snprintf(buf, sizeof buf, "throttled %.*s: dropped %lu lines",
+                          static_cast<int>(subsystem.size()), subsystem.data(),
+                          static_cast<unsigned long>(ch.pendingDropped));
+            inner_->log(hal::LogLevel::Warn, "DIA", buf);
+            ch.pendingDropped = 0;
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool recordsShed() const noexcept {
+        return budget_ != nullptr && budget_->shed(SheddableWork::RecordPopulation);
+    }
+
     struct Bucket {
         double tokens = 0.0;
         double lastRefill = 0.0;
@@ -218,6 +266,8 @@ private:
     int channelCount_ = 0;
     std::uint32_t droppedRecords_ = 0;
     std::uint32_t droppedLines_ = 0;
+    std::uint32_t shedRecords_ = 0;
+    const TickBudget* budget_ = nullptr;
 };
 
 }  // namespace shulib::diag
@@ -27,11 +27,17 @@
 // provide one. Renderers must say MISSING, loudly — never invent a plausible value.
 // A wrong hash is worse than an absent one.
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <string_view>
 
+#include "shulib/diag/debug_record.hpp"
 #include "shulib/diag/fault.hpp"
+#include "shulib/diag/tick_budget.hpp"
+#include "shulib/diag/tick_histogram.hpp"
+#include "shulib/diag/zone_profiler.hpp"
 #include "shulib/units/quantity.hpp"
 
 namespace shulib::diag {
@@ -79,6 +85,35 @@ struct RunSummary {
     /// this one only when it is non-zero (TermSink's summarize note). — E1
     std::uint32_t blackboxDropped = 0;
 
+    // ── load shedding (diag/tick_budget.hpp) — deliberate degradation is reported too ──
+    /// True when a TickBudget was attached to the run. False ⇒ the fields below are
+    /// zeros that mean "no shedder", not "shed nothing" — the blackboxDropped reasoning.
+    bool hasLoadShedData = false;
+    /// Ticks each SheddableWork class spent shed, indexed by SheddableWork
+    /// (TickBudget::shedTicks — for health, the SKIPPED ticks only).
+    std::array<std::uint32_t, static_cast<std::size_t>(kSheddableWorkCount)> shedTicks{};
+    std::uint32_t shedTicksObserved = 0;  ///< TickBudget::ticksObserved() — the denominator
+    std::uint32_t shedEscalations = 0;    ///< TickBudget::escalations()
+    int shedMaxLevel = 0;                 ///< TickBudget::maxLevel(), 0..kSheddableWorkCount
+
+    // ── tick timing distributions (diag/tick_histogram.hpp) — what worstLoopDt is the tip of ──
+    /// LoopMonitor::dtHistogram().stats(): p50/p95/p99/max of the measured loop dt. count 0
+    /// means no tick was ever measured, and renderers then show nothing.
+    TickTimingStats loopDt{};
+    /// TickAttribution::phaseHistogram(p).stats() per phase slot, indexed by TickPhase. All
+    /// count 0 when attribution was off (the scheduler's null attribution clock); a slot with
+    /// samples but max 0 had no producer.
+    std::array<TickTimingStats, static_cast<std::size_t>(kTickPhaseSlots)> phaseTiming{};
+
+    // ── the zone profile (diag/zone_profiler.hpp) — inside the phases ────────────────
+    /// ZoneProfiler::snapshot(): one row per zone, depth-first. Only the first zoneCount rows
+    /// mean anything.
+    std::array<ZoneTimingRow, kMaxZones> zones{};
+    /// Rows of `zones` in use. 0 ⇒ no profiler was attached (or nothing entered a zone).
+    std::uint32_t zoneCount = 0;
+    /// ZoneProfiler::refusedScopes(): zones that did not fit the table and are in no row.
+    std::uint32_t zonesRefused = 0;
+
     // ── provenance (§18.5, mirrored from the session header) ────────────────────────
     /// Pack volts READ at session start, never caller-typed: a typed 12.6 that was really
     /// 11.9 is exactly the lying number this record exists to avoid.
@@ -87,6 +122,24 @@ struct RunSummary {
     /// Both are 0 V on a summary nobody filled in — there is no "unset" sentinel here.
     units::Voltage batteryEnd{};
 
+    /// True when loopDt or any phase slot holds samples — the condition for a sink to
+    /// persist the timing digests at all (SdSink's TickTiming frame).
+    [[nodiscard]] bool hasTickTimingData() const noexcept {
+        if (loopDt.count != 0) {
+            return true;
+        }
+        for (const TickTimingStats& p : phaseTiming) {
+            if (p.count != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// True when the zone table holds rows — the condition for a sink to persist it
+    /// (SdSink's ZoneTiming frame) or render it.
+    [[nodiscard]] bool hasZoneData() const noexcept { return zoneCount != 0; }
+
     /// Empty ⇒ MISSING (rendered loudly; header note). 47 bytes admits a full
     /// 40-char git SHA plus a "-dirty" suffix.
     void setBuildHash(std::string_view hash) noexcept { copyBounded(buildHash_, sizeof buildHash_, hash); }
@@ -58,6 +58,66 @@
 // PROS task stack holds, so the storage must be static / file-scope / heap. The
 // SdSinkBuffers helper below is the one-liner for the common case.
 //
+// ── Load shedding: flush() may DEFER, nothing else does ────────────────────────────
+// With a TickBudget attached (setTickBudget) and SdFlush shed this tick, a caller's
+// flush() writes nothing and returns true: the bytes stay staged for the next flush
+// that is not shed, and every deferral is counted (deferredFlushes()). Only the
+// CALLER-PACED flush defers — close() and the fault dump write regardless, because
+// a deadline is worth less than the evidence (diag/tick_budget.hpp). A deferral can
+// still end in drops if staging fills first; those are the ordinary counted drops.
+//
+// ── Compact ticks (format v2) ───────────────────────────────────────────────────────
+// cfg.compactTicks writes every tick — streamed or dumped — through the compact codec
+// (blackbox_compact.hpp) and stamps the file v2; everything else in the file is
+// unchanged. A tick frame is encoded into the codec's scratch first, so its size is
+// known before staging, and the codec's chain advances only once the frame is staged:
+// a tick dropped for want of buffer costs that tick and nothing after it. A failed
+// device write loses frames the chain already counted, so it restarts the chain at a
+// keyframe. Off by default — v1 stays the default format until R4 has read a v2 file
+// off a real card.
+//
+// ── Incremental pumping: a few sectors per tick, at the caller's pace ───────────────
+// A streamed run with flush() at motion boundaries pays the whole backlog in one
+// boundary tick — tens of kilobytes, the HA-60 cost — and a motion longer than the
+// buffer holds drops frames before that boundary arrives. pump() is the same
+// caller-paced write in slices: at most K bytes per call, ending on a 512-byte sector
+// boundary of the FILE, so the card sees whole-sector writes and never a
+// read-modify-write of a half sector (a partial tail waits for the next pump, flush(),
+// close() or dump). Call it once per tick from wherever the tick has slack — on the
+// robot that is the pacer's wait (motion/blackbox_pump_pacer.hpp), so the write spends
+// time the loop was going to sleep anyway. K adapts to a high-water mark: while the
+// staged backlog sits above cfg.pumpHighWater of the buffer, K doubles (up to
+// cfg.pumpMaxBytesPerTick); once it falls below a quarter of that, K halves back toward
+// cfg.pumpBytesPerTick. A shed SdFlush defers a pump exactly as it defers a flush.
+// This is still T1: one task, no writer thread, and no write the caller did not ask
+// for. Off by default (pumpBytesPerTick == 0 ⇒ pump() does nothing).
+//
+// A slice ends on a sector, not on a frame, so the frame it cuts is on the card only in
+// part until the next write finishes it. If that write is refused, the drop count stays
+// exact — a frame the card holds whole is not a drop, every other staged frame is — but
+// the card keeps the torn prefix, and anything written after it lands behind that
+// fragment: a reader stops there as at a truncated tail. The seam has no seek, so this
+// is stated rather than repaired; a device that refused one write seldom takes another.
+//
+// ── Estimator inputs (opt-in) ───────────────────────────────────────────────────────
+// With cfg.recordEstimatorInputs, a record stamped with the estimator's raw inputs (a
+// scheduled run's records all are) gets an EstimatorInputs frame right behind its tick
+// frame, streamed or dumped, so the file can be replayed offline (sim/
+// estimator_replay.hpp). The frame is 72 bytes and is NOT compacted: on a v1 tick frame
+// of 432 it is a sixth again, and in compact mode it is most of the tick. So it is off
+// by default, like streaming — a bench or tuning posture, switched on for the runs that
+// are going to be replayed. Off, a stamped record costs exactly what an unstamped one does.
+//
+// ── The event ring ──────────────────────────────────────────────────────────────────
+// An attached EventRing (setEventRing; diag/event_ring.hpp) is written as EventLog frames,
+// oldest first, in two places: at the end of the fault dump, after the preceding ticks —
+// the ticks say what the robot was doing, the events what had already happened to it —
+// and at close(), before the end frame. Each writes only the events the file does not
+// yet hold, so a dump followed by close() carries each event once. Events come LAST in the
+// dump on purpose: a cut there loses history, never the triage frame or the fault's own
+// ticks. A clean D-6 run still writes nothing at close(): the ring alone does not make a
+// run worth a file.
+//
 // ── Cost when disabled ──────────────────────────────────────────────────────────────
 // With cfg.enabled == false, wantsRecord() is false, so hal::emitRecord never even
 // BUILDS a record (A1's cost contract), no ring is touched and no byte is written.
@@ -68,21 +128,33 @@
 // sink are counted and the count is written into the end frame, so the omission is
 // visible in the file instead of silent.
 //
+// ── Deferred log lines ──────────────────────────────────────────────────────────────
+// A SHULIB_LOGF line (diag/deferred_log.hpp) IS carried when streaming: a LogArgs frame
+// of its format id, level, time and packed arguments — memcpy-sized, no formatting —
+// behind a FormatDef frame the first time the id appears in the file. Like a streamed
+// tick, a line that does not fit is dropped whole and counted; a definition that did not
+// fit takes its line with it and is retried next time. Not streaming (D-6's posture, where
+// a clean run writes nothing), a deferred line is counted like a log() line.
+//
 // Single-task by contract, like every sink in this tree. Nothing here allocates, and
 // nothing here throws.
 
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <span>
 #include <string_view>
 
 #include "shulib/core/check.hpp"
+#include "shulib/diag/blackbox_compact.hpp"
 #include "shulib/diag/blackbox_format.hpp"
 #include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/event_ring.hpp"
 #include "shulib/diag/fault.hpp"
 #include "shulib/diag/run_summary.hpp"
 #include "shulib/diag/session_info.hpp"
+#include "shulib/diag/tick_budget.hpp"
 #include "shulib/hal/block_sink.hpp"
 #include "shulib/hal/clock.hpp"
 #include "shulib/hal/telemetry_sink.hpp"
@@ -99,10 +171,28 @@ inline constexpr std::size_t kDefaultFlightRingTicks = 200;
 /// frames, about 87 KB, so 64 KiB does NOT hold one: a dump of that size writes in two
 /// device calls rather than one (supported and tested). Sizing the buffer to hold a
 /// whole dump costs 88 KB of RAM permanently to save one write() call at the one moment
-/// the run is already compromised, which is the wrong trade. PROVISIONAL (A4: HA-59) —
-/// INVENTED; R4 measures what the brain can spare.
+/// the run is already compromised, which is the wrong trade. With compactTicks the same
+/// dump is a fraction of that and fits in one write (measured in
+/// test/sd_sink_test.cpp). recordEstimatorInputs adds 72 bytes per scheduler-stamped
+/// tick: about 102 KB for the v1 dump, and several times the compact one (measured
+/// there too). PROVISIONAL (A4: HA-59) — INVENTED; R4 measures what the brain can spare.
 inline constexpr std::size_t kRecommendedBufferBytes = 65536;
 
+/// The SD card's write unit. pump() ends every write on a multiple of this many file
+/// bytes, so the card is never asked to rewrite a sector it already holds half of. 512
+/// is the SD specification's block size, not a guess about the V5 brain.
+inline constexpr std::size_t kSectorBytes = 512;
+
+/// The recommended base pump slice: two sectors per tick, 100 KB/s at a 100 Hz loop —
+/// more than twice what a streamed v1 run stages (~43 KB/s), so the backlog drains
+/// without adapting. PROVISIONAL (A4: HA-129) — INVENTED from HA-60's flush-cost
+/// guess; R4 measures what one small /usd/ write actually costs inside a tick.
+inline constexpr std::size_t kDefaultPumpBytesPerTick = 2 * kSectorBytes;
+
+/// The recommended ceiling K may adapt up to under a backlog: sixteen sectors per
+/// tick. PROVISIONAL (A4: HA-129), with the base slice.
+inline constexpr std::size_t kDefaultPumpMaxBytesPerTick = 16 * kSectorBytes;
+
 /// Configuration for SdSink. Every default is the COMPETITION posture: the flight
 /// recorder on, streaming off, dump on the first fault, and write it immediately.
 struct SdSinkConfig {
@@ -120,6 +210,25 @@ struct SdSinkConfig {
     /// the bytes to the caller's next flush(), at the risk of losing them to a power
     /// loss — bounded, counted, and the caller's choice.
     bool flushOnFault = true;
+    /// true ⇒ ticks are written as compact TickKey/TickDelta frames and the file is
+    /// format v2 (header note). false ⇒ v1 Tick frames, byte-identical to before.
+    bool compactTicks = false;
+    /// With compactTicks: a keyframe at least every this many tick frames (≥ 1).
+    std::size_t keyframeInterval = blackbox::kDefaultKeyframeInterval;
+    /// true ⇒ a record stamped with estimator inputs is followed by an EstimatorInputs
+    /// frame, so the file can be replayed offline (header note). false ⇒ the inputs are
+    /// not written, and a stamped record costs what any other does.
+    bool recordEstimatorInputs = false;
+    /// pump()'s base slice in bytes (rounded down to whole sectors; header note). 0 ⇒
+    /// pump() is a no-op and the device is touched only at flush, close and the dump.
+    /// kDefaultPumpBytesPerTick is the recommended value.
+    std::size_t pumpBytesPerTick = 0;
+    /// The ceiling pump()'s slice adapts up to under a backlog (clamped to ≥ the base).
+    std::size_t pumpMaxBytesPerTick = kDefaultPumpMaxBytesPerTick;
+    /// The staged-backlog fraction of the buffer above which pump()'s slice doubles;
+    /// below a quarter of it, the slice halves back toward the base.
+    /// PROVISIONAL (A4: HA-129).
+    double pumpHighWater = 0.5;
 };
 
 /// Caller-owned storage for one SdSink. NEVER put this on a task stack (header note).
@@ -156,8 +265,9 @@ struct SdSinkBuffers {
 /// wherever a few milliseconds of IO is affordable, close() at the end; a clean run that
 /// never had anything to say costs zero bytes. It never allocates, never throws, and —
 /// outside the fault dump — never writes behind your back: a frame that does not fit the
-/// buffer is dropped WHOLE and counted, so the file always explains its own gaps.
-/// Single-task, like every sink here.
+/// buffer is dropped WHOLE and counted, so the file always explains its own gaps. A
+/// streaming caller that cannot afford a boundary flush calls pump() every tick instead
+/// (header note). Single-task, like every sink here.
 class SdSink final : public hal::ITelemetrySink {
 public:
     /// `out` is the block device (R1's /usd/ adapter on the robot, FakeBlockSink in
@@ -165,7 +275,14 @@ public:
     /// (header note). All references must outlive the sink.
     SdSink(hal::IBlockSink& out, hal::IClock& clock, SdSinkStorage storage,
            const SdSinkConfig& config = {})
-        : out_{&out}, clock_{&clock}, storage_{storage}, cfg_{config} {
+        : out_{&out}, clock_{&clock}, storage_{storage}, cfg_{config},
+          compact_{config.keyframeInterval},
+          pumpBase_{config.pumpBytesPerTick / kSectorBytes * kSectorBytes},
+          pumpMax_{config.pumpMaxBytesPerTick / kSectorBytes * kSectorBytes},
+          pumpSlice_{pumpBase_} {
+        if (pumpMax_ < pumpBase_) {
+            pumpMax_ = pumpBase_;
+        }
         SHULIB_PRECONDITION(storage.buffer.size()
                                 >= blackbox::kHeaderBytes + blackbox::kFrameHeaderBytes
                                        + blackbox::kTriagePayloadBytes,
@@ -194,6 +311,34 @@ public:
         ++messages_;
     }
 
+    /// Streaming: stage the line as a LogArgs frame, behind its FormatDef the first time
+    /// (header note). Not streaming: counted like a log() line.
+    void logDeferred(const DeferredLog& line) override {
+        if (!cfg_.enabled) {
+            return;
+        }
+        if (!cfg_.streamTicks) {
+            ++messages_;
+            return;
+        }
+        if (!interned_.known(line.id)) {
+            if (!stage(blackbox::FrameType::FormatDef, blackbox::formatDefPayloadBytes(line),
+                       false, [&](std::span<std::byte> out) {
+                           return blackbox::encodeFormatDef(out, line);
+                       })) {
+                return;
+            }
+            interned_.remember(line.id);
+        }
+        const double t = now();
+        if (stage(blackbox::FrameType::LogArgs, blackbox::logArgsPayloadBytes(line), false,
+                  [&](std::span<std::byte> out) {
+                      return blackbox::encodeLogArgs(out, line, t);
+                  })) {
+            ++logFrames_;
+        }
+    }
+
     /// True while the sink is enabled — the ring needs every record even when nothing
     /// is being streamed. Overridden as a pair with emit(), per the seam contract.
     [[nodiscard]] bool wantsRecord() const noexcept override { return cfg_.enabled; }
@@ -220,7 +365,10 @@ public:
     }
 
     /// The end-of-run summary (§18.3) as a frame. The sink's OWN drop count rides along,
-    /// so the file always explains its own gaps.
+    /// so the file always explains its own gaps. A summary carrying load-shed data is
+    /// followed by a LoadShed frame, so the degradation is on disk beside the run it
+    /// degraded; one carrying tick-timing data, by a TickTiming frame; one carrying a zone
+    /// table, by a ZoneTiming frame.
     void summarize(const RunSummary& summary) override {
         if (!cfg_.enabled) {
             return;
@@ -233,6 +381,24 @@ public:
                     [&](std::span<std::byte> out) {
                         return blackbox::encodeSummary(out, summary, dropped);
                     });
+        if (summary.hasLoadShedData) {
+            (void)stage(blackbox::FrameType::LoadShed, blackbox::kLoadShedPayloadBytes, false,
+                        [&](std::span<std::byte> out) {
+                            return blackbox::encodeLoadShed(out, summary);
+                        });
+        }
+        if (summary.hasTickTimingData()) {
+            (void)stage(blackbox::FrameType::TickTiming, blackbox::kTickTimingPayloadBytes,
+                        false, [&](std::span<std::byte> out) {
+                            return blackbox::encodeTickTiming(out, summary);
+                        });
+        }
+        if (summary.hasZoneData()) {
+            (void)stage(blackbox::FrameType::ZoneTiming, blackbox::zoneTimingPayloadBytes(summary),
+                        false, [&](std::span<std::byte> out) {
+                            return blackbox::encodeZoneTiming(out, summary);
+                        });
+        }
     }
 
     /// Push everything staged to the device. THIS is the caller-paced write (T1): call
@@ -246,45 +412,88 @@ public:
     /// caller-paced at all; PROVISIONAL (A4: HA-60), and R4 measures it. If the real
     /// figure is far worse, the flush POINTS move (fewer of them, or auton-end only) —
     /// the format and the sink do not.
+    ///
+    /// While an attached TickBudget sheds SdFlush this DEFERS: nothing is written, the
+    /// deferral is counted, and the return is true (nothing failed — header note).
     bool flush() noexcept {
-        if (used_ == 0) {
+        if (budget_ != nullptr && budget_->shed(SheddableWork::SdFlush) && pending() != 0) {
+            ++deferredFlushes_;
             return !deviceFailed_;
         }
-        const bool ok = out_->write(storage_.buffer.subspan(0, used_));
-        if (ok) {
-            bytesWritten_ += static_cast<std::uint32_t>(used_);
-        } else {
-            deviceFailed_ = true;
-            dropped_ += pendingFrames_;  // frames that never reached the device ARE drops
+        return writeStaged();
+    }
+
+    /// Write at most one adaptive slice of the staged bytes, ending on a sector boundary
+    /// of the file (header note: incremental pumping). Call once per tick from the tick's
+    /// slack; returns the bytes written (0 when disabled, shed, failed, or when less than
+    /// a sector's worth is staged — the tail waits for flush() or close()). A shed
+    /// SdFlush defers the pump (counted in deferredPumps()). A refused write discards
+    /// everything staged, as flush() does.
+    std::size_t pump() noexcept {
+        if (!cfg_.enabled || pumpBase_ == 0 || pending() == 0) {
+            return 0;
         }
-        used_ = 0;
-        pendingFrames_ = 0;
-        return ok;
+        if (budget_ != nullptr && budget_->shed(SheddableWork::SdFlush)) {
+            ++deferredPumps_;
+            return 0;
+        }
+        adaptPumpSlice();
+        const std::size_t want = pending() < pumpSlice_ ? pending() : pumpSlice_;
+        const std::size_t fileEnd = bytesWritten_ + want;
+        const std::size_t alignedEnd = fileEnd - fileEnd % kSectorBytes;
+        if (alignedEnd <= bytesWritten_) {
+            return 0;
+        }
+        const std::size_t n = alignedEnd - bytesWritten_;
+        if (!out_->write(storage_.buffer.subspan(head_, n))) {
+            failStaged();
+            return 0;
+        }
+        bytesWritten_ += static_cast<std::uint32_t>(n);
+        head_ += n;
+        retireWrittenFrames();
+        if (head_ == used_) {
+            head_ = 0;
+            used_ = 0;
+            pendingFrames_ = 0;
+        }
+        return n;
     }
 
+    /// Attach the load shedder whose SdFlush class may defer flush() (nullptr detaches —
+    /// the default). NON-OWNING: the budget must outlive the sink or be detached first.
+    void setTickBudget(const TickBudget* budget) noexcept { budget_ = budget; }
+
     /// Graceful end: write the end frame, flush, and flush the device. The end frame's
     /// PRESENCE is what tells a reader the run closed cleanly — its absence is how a
     /// truncated file identifies itself. Writes nothing at all if the run never had
-    /// anything to say (D-6's promise: a clean run costs zero bytes).
+    /// anything to say (D-6's promise: a clean run costs zero bytes). Never deferred by
+    /// load shedding.
     void close() noexcept {
         if (!cfg_.enabled || (framesStaged_ == 0 && bytesWritten_ == 0)) {
             return;
         }
+        stageEvents(true);
         blackbox::EndInfo e;
         e.tickFrames = tickFrames_;
         e.droppedFrames = dropped_;
-        e.bytesBefore = bytesWritten_ + static_cast<std::uint32_t>(used_);
+        e.bytesBefore = bytesWritten_ + static_cast<std::uint32_t>(pending());
         e.messagesSeen = messages_;
         e.brownout = brownout_;
         e.deviceFailed = deviceFailed_;
         e.endTime = now();
         (void)stage(blackbox::FrameType::End, blackbox::kEndPayloadBytes, true,
                     [&](std::span<std::byte> out) { return blackbox::encodeEnd(out, e); });
-        (void)flush();
+        (void)writeStaged();
         (void)out_->flush();
         closed_ = true;
     }
 
+    /// Write `ring`'s events into the file at the fault dump and at close() (header note) —
+    /// nullptr detaches, the default. NON-OWNING: the ring must outlive the sink or be
+    /// detached first.
+    void setEventRing(const EventRing* ring) noexcept { events_ = ring; }
+
     /// Latch the brownout marker from outside the record stream (HealthMonitor's
     /// brownedOut(), say). Latched for the run: a battery that recovers does not erase
     /// the fact that it collapsed.
@@ -303,26 +512,48 @@ public:
 
     // ── observation (all cheap, all const) ──────────────────────────────────────────
 
-    /// Frames dropped for want of buffer, plus any staged frames a failed device write
-    /// discarded. THE number for "what is missing from this file".
+    /// Frames dropped for want of buffer, plus the staged frames a failed device write
+    /// discarded before they were on the card whole. The number for "what is missing
+    /// from this file".
     [[nodiscard]] std::uint32_t droppedFrames() const noexcept { return dropped_; }
-    /// Tick frames staged over the run (streamed plus dumped).
+    /// Tick frames staged over the run (streamed plus dumped; keyframes and deltas alike
+    /// when compact).
     [[nodiscard]] std::uint32_t tickFrames() const noexcept { return tickFrames_; }
     /// Records handed to emit() over the run.
     [[nodiscard]] std::uint32_t recordsSeen() const noexcept { return records_; }
-    /// log() lines handed to the sink and not carried by v1 (header note).
+    /// log() lines handed to the sink and not carried by v1, plus deferred lines handed to
+    /// it while not streaming (header note).
     [[nodiscard]] std::uint32_t messagesSeen() const noexcept { return messages_; }
+    /// EventLog frames staged over the run.
+    [[nodiscard]] std::uint32_t eventFrames() const noexcept { return eventFrames_; }
+    /// Deferred lines staged as LogArgs frames.
+    [[nodiscard]] std::uint32_t logFrames() const noexcept { return logFrames_; }
     /// Bytes the device confirmed. After a device failure this is a LOWER BOUND: a
     /// partial write's prefix is unknowable through the seam.
     [[nodiscard]] std::uint32_t bytesWritten() const noexcept { return bytesWritten_; }
     /// Bytes staged and not yet written.
-    [[nodiscard]] std::size_t bytesBuffered() const noexcept { return used_; }
+    [[nodiscard]] std::size_t bytesBuffered() const noexcept { return pending(); }
+    /// The most bytes ever staged and unwritten at once — how close the run came to
+    /// dropping for want of buffer.
+    [[nodiscard]] std::size_t peakBufferedBytes() const noexcept { return peakPending_; }
+    /// pump()'s current slice in bytes (0 when pumping is off). Sits at the configured
+    /// base unless a backlog has pushed it up (header note).
+    [[nodiscard]] std::size_t pumpSliceBytes() const noexcept { return pumpSlice_; }
+    /// pump() calls deferred because SdFlush was shed.
+    [[nodiscard]] std::uint32_t deferredPumps() const noexcept { return deferredPumps_; }
     /// True once the fault dump has fired (first fault only).
     [[nodiscard]] bool dumped() const noexcept { return dumped_; }
     /// The latched brownout marker.
     [[nodiscard]] bool brownout() const noexcept { return brownout_; }
     /// True once any write() or flush() reported failure.
     [[nodiscard]] bool deviceFailed() const noexcept { return deviceFailed_; }
+    /// Caller flush() calls deferred because SdFlush was shed (header note). Each one
+    /// left its bytes staged, not lost.
+    [[nodiscard]] std::uint32_t deferredFlushes() const noexcept { return deferredFlushes_; }
+    /// The compact codec's own counts (keyframes(), deltas()); all zero for a v1 file.
+    [[nodiscard]] const blackbox::CompactTickEncoder& compactEncoder() const noexcept {
+        return compact_;
+    }
     /// True once close() has run.
     [[nodiscard]] bool closed() const noexcept { return closed_; }
     /// How many records the flight ring currently holds.
@@ -351,6 +582,80 @@ private:
         dst[take] = '\0';
     }
 
+    /// Staged bytes not yet written: the buffer holds them in [head_, used_).
+    [[nodiscard]] std::size_t pending() const noexcept { return used_ - head_; }
+
+    /// The write behind flush(), close() and the fault dump — never deferred. Returns
+    /// false if the device refused any byte; staged bytes are dropped (and counted)
+    /// either way.
+    bool writeStaged() noexcept {
+        if (pending() == 0) {
+            return !deviceFailed_;
+        }
+        const bool ok = out_->write(storage_.buffer.subspan(head_, pending()));
+        if (!ok) {
+            failStaged();
+            return false;
+        }
+        bytesWritten_ += static_cast<std::uint32_t>(pending());
+        head_ = 0;
+        used_ = 0;
+        pendingFrames_ = 0;
+        return true;
+    }
+
+    /// A refused write: everything staged is discarded. The frames not yet on the card
+    /// whole count as drops — exactly those: a frame an earlier pump() slice finished is
+    /// not one, a frame a slice cut in two is (header note).
+    void failStaged() noexcept {
+        deviceFailed_ = true;
+        dropped_ += pendingFrames_;  // frames that never reached the device ARE drops
+        compact_.restartChain();     // …and a delta after them would have no predecessor
+        head_ = 0;
+        used_ = 0;
+        pendingFrames_ = 0;
+    }
+
+    /// The high-water rule (header note): double above the mark, halve below a quarter
+    /// of it, never outside [base, max]. Both ends are whole sectors, so the slice stays
+    /// one too.
+    void adaptPumpSlice() noexcept {
+        const double fill = static_cast<double>(pending())
+                            / static_cast<double>(storage_.buffer.size());
+        if (fill > cfg_.pumpHighWater) {
+            pumpSlice_ = pumpSlice_ * 2 < pumpMax_ ? pumpSlice_ * 2 : pumpMax_;
+        } else if (fill < cfg_.pumpHighWater / 4.0) {
+            pumpSlice_ = pumpSlice_ / 2 > pumpBase_ ? pumpSlice_ / 2 : pumpBase_;
+        }
+    }
+
+    /// After a pump() slice: the pending frames whose last byte is now on the card stop
+    /// being pending. Walks the frame headers on from the oldest pending frame's end; each
+    /// header it reads was in this slice, so it is still in the buffer below head_.
+    void retireWrittenFrames() noexcept {
+        while (pendingFrames_ > 0 && oldestPendingEnd_ <= bytesWritten_) {
+            --pendingFrames_;
+            if (pendingFrames_ == 0) {
+                return;
+            }
+            const std::size_t at = head_ - (bytesWritten_ - oldestPendingEnd_);
+            blackbox::ByteReader h{storage_.buffer.subspan(at, blackbox::kFrameHeaderBytes)};
+            h.skip(2);  // type, reserved
+            oldestPendingEnd_ += static_cast<std::uint32_t>(blackbox::kFrameHeaderBytes + h.u16());
+        }
+    }
+
+    /// Slide the unwritten bytes to the front of the buffer, so a pumped prefix becomes
+    /// room again. Only stage() calls it, and only when a frame would not otherwise fit.
+    void compactStaged() noexcept {
+        if (head_ == 0) {
+            return;
+        }
+        std::memmove(storage_.buffer.data(), storage_.buffer.data() + head_, pending());
+        used_ -= head_;
+        head_ = 0;
+    }
+
     /// Stage the 256-byte header, once, before any frame. Lazy on purpose: a run that
     /// never stages a frame never writes a byte.
     void ensureHeader() noexcept {
@@ -370,7 +675,8 @@ private:
         const std::size_t n = blackbox::encodeHeader(
             storage_.buffer.subspan(0, blackbox::kHeaderBytes), info, epoch_,
             static_cast<std::uint32_t>(storage_.ring.size()),
-            static_cast<std::uint32_t>(storage_.buffer.size()));
+            static_cast<std::uint32_t>(storage_.buffer.size()),
+            cfg_.compactTicks ? blackbox::kFormatVersionCompact : blackbox::kFormatVersion);
         used_ = n;
     }
 
@@ -382,13 +688,16 @@ private:
                EncodeFn&& encode) noexcept {
         ensureHeader();
         const std::size_t need = blackbox::kFrameHeaderBytes + payloadBytes;
+        if (storage_.buffer.size() - used_ < need) {
+            compactStaged();
+        }
         if (storage_.buffer.size() - used_ < need) {
             if (allowFlush) {
                 // The file is ONE stream across many write() calls: the header was
                 // already staged (and written) at the front, so a mid-dump flush just
                 // empties the buffer and the next frames append after it. Re-stamping
                 // provenance here would corrupt the stream, not protect it.
-                (void)flush();
+                (void)writeStaged();
             }
             if (storage_.buffer.size() - used_ < need) {
                 ++dropped_;
@@ -409,14 +718,58 @@ private:
         }
         used_ += need;
         ++framesStaged_;
+        if (pendingFrames_ == 0) {
+            oldestPendingEnd_ = bytesWritten_ + static_cast<std::uint32_t>(pending());
+        }
         ++pendingFrames_;
+        if (pending() > peakPending_) {
+            peakPending_ = pending();
+        }
         return true;
     }
 
+    /// One tick, then — when configured, for a record carrying them — its estimator inputs
+    /// in their own frame right behind it (the replay channel; blackbox_format.hpp). A tick
+    /// that did not fit takes its inputs with it.
     bool stageTick(const DebugRecord& r, bool allowFlush) noexcept {
-        const bool ok = stage(blackbox::FrameType::Tick, blackbox::kTickPayloadBytes, allowFlush,
-                              [&](std::span<std::byte> out) { return blackbox::encodeTick(out, r); });
+        bool ok = false;
+        if (cfg_.compactTicks) {
+            ok = stageCompactTick(r, allowFlush);
+        } else {
+            ok = stage(blackbox::FrameType::Tick, blackbox::kTickPayloadBytes, allowFlush,
+                       [&](std::span<std::byte> out) { return blackbox::encodeTick(out, r); });
+            if (ok) {
+                ++tickFrames_;
+            }
+        }
+        if (ok && cfg_.recordEstimatorInputs && r.hasEstimatorInputs) {
+            (void)stage(blackbox::FrameType::EstimatorInputs,
+                        blackbox::kEstimatorInputsPayloadBytes, allowFlush,
+                        [&](std::span<std::byte> out) {
+                            return blackbox::encodeEstimatorInputs(out, r);
+                        });
+        }
+        return ok;
+    }
+
+    /// The compact path: encode into the codec's scratch, stage a copy, and advance the
+    /// chain only if the frame went in (header note).
+    bool stageCompactTick(const DebugRecord& r, bool allowFlush) noexcept {
+        const blackbox::CompactTickEncoder::Encoded enc = compact_.encode(r);
+        if (enc.payload.empty()) {
+            ensureHeader();
+            ++dropped_;
+            return false;
+        }
+        const bool ok = stage(enc.type, enc.payload.size(), allowFlush,
+                              [&](std::span<std::byte> out) {
+                                  for (std::size_t i = 0; i < enc.payload.size(); ++i) {
+                                      out[i] = enc.payload[i];
+                                  }
+                                  return enc.payload.size();
+                              });
         if (ok) {
+            compact_.commit();
             ++tickFrames_;
         }
         return ok;
@@ -448,14 +801,44 @@ private:
                 (void)stageTick(storage_.ring[idx], allowFlush);
             }
         }
+        stageEvents(allowFlush);
         if (allowFlush) {
-            (void)flush();
+            (void)writeStaged();
             if (!out_->flush()) {
                 deviceFailed_ = true;
             }
         }
     }
 
+    /// The attached ring's events the file does not yet hold, oldest first, in frames of
+    /// up to kEventLogMaxEvents. A frame that does not fit is dropped (and counted) and
+    /// takes the rest of this call's events with it — they are retried at the next call.
+    void stageEvents(bool allowFlush) noexcept {
+        if (events_ == nullptr) {
+            return;
+        }
+        if (eventsWritten_ > events_->recorded()) {
+            eventsWritten_ = 0;  // the ring was cleared: its numbering restarted
+        }
+        const std::uint32_t oldest = events_->overwritten();
+        std::size_t from = eventsWritten_ > oldest ? eventsWritten_ - oldest : 0U;
+        while (from < events_->size()) {
+            const std::size_t left = events_->size() - from;
+            const std::size_t n = left < blackbox::kEventLogMaxEvents
+                                      ? left
+                                      : blackbox::kEventLogMaxEvents;
+            if (!stage(blackbox::FrameType::EventLog, blackbox::eventLogPayloadBytes(n),
+                       allowFlush, [&](std::span<std::byte> out) {
+                           return blackbox::encodeEventLog(out, *events_, from, n);
+                       })) {
+                return;
+            }
+            ++eventFrames_;
+            from += n;
+            eventsWritten_ = oldest + static_cast<std::uint32_t>(from);
+        }
+    }
+
     /// Overwrite the OLDEST entry once the ring is full — the whole point of a flight
     /// recorder is that the newest ticks survive.
     void pushRing(const DebugRecord& r) noexcept {
@@ -473,6 +856,8 @@ private:
     hal::IClock* clock_;
     SdSinkStorage storage_;
     SdSinkConfig cfg_;
+    blackbox::CompactTickEncoder compact_;  // unused (and never consulted) for a v1 file
+    InternedFormats interned_;              // format ids already defined in this file
 
     char hash_[48] = "";
     char routine_[32] = "";
@@ -484,16 +869,29 @@ private:
     DebugRecord triageTick_{};       // the record of the tick the fault fired on
 
     double epoch_ = 0.0;
-    std::size_t used_ = 0;        // bytes staged in the buffer
+    std::size_t used_ = 0;        // end of the staged bytes in the buffer
+    std::size_t head_ = 0;        // start of the unwritten bytes (pump() advances it)
+    std::size_t peakPending_ = 0;
+    std::size_t pumpBase_;        // cfg slice and ceiling, rounded to whole sectors
+    std::size_t pumpMax_;
+    std::size_t pumpSlice_;       // the current adaptive slice
     std::size_t ringHead_ = 0;    // next ring slot to write
     std::size_t ringCount_ = 0;   // ring entries in use
     std::uint32_t records_ = 0;
     std::uint32_t messages_ = 0;
+    std::uint32_t logFrames_ = 0;
     std::uint32_t tickFrames_ = 0;
     std::uint32_t framesStaged_ = 0;
-    std::uint32_t pendingFrames_ = 0;  // frames staged since the last successful write
+    std::uint32_t pendingFrames_ = 0;     // staged frames not yet on the card whole
+    std::uint32_t oldestPendingEnd_ = 0;  // file offset just past the oldest of them
     std::uint32_t dropped_ = 0;
     std::uint32_t bytesWritten_ = 0;
+    std::uint32_t deferredFlushes_ = 0;
+    std::uint32_t deferredPumps_ = 0;
+    std::uint32_t eventFrames_ = 0;
+    std::uint32_t eventsWritten_ = 0;  // running number of the next event to write
+    const TickBudget* budget_ = nullptr;  // optional load shedder (header note)
+    const EventRing* events_ = nullptr;   // optional transition ring (header note)
     bool opened_ = false;
     bool headerStaged_ = false;
     bool dumped_ = false;
@@ -0,0 +1,537 @@
+#pragma once
+//
+// Shul2Sink — the SHUL/2 binary telemetry wire over a USB serial character device, and
+// Shul2Decoder, the host half that reads it back. The third rendering of the one
+// DebugRecord schema (TermSink for humans, SdSink for the card, this for a live host).
+//
+// ── What goes on the wire ───────────────────────────────────────────────────────────
+// Every message is ONE frame, and every frame is one ICharSink::write():
+//
+//   raw frame:   u8 wire version | u8 type | u16 seq | payload | u16 CRC-16 (LE)
+//   on the wire: COBS(raw frame) | 0x00
+//
+//   * TICKS reuse the blackbox's compact tick stream (blackbox_compact.hpp) verbatim:
+//     a TickKey payload is the chain sequence plus encodeTick()'s 428 v1 bytes, a
+//     TickDelta is the varint/XOR delta against the previous tick of the chain. So the
+//     wire inherits encodeTick()'s FIELD ORDER — what blackbox_format.hpp's "What H1
+//     inherits" note asks for — and its lossless "decoded equals encoded" argument,
+//     with no second field list to keep in step with debug_record.hpp.
+//   * LOGS carry the level, the tag and the message, truncated (16 and 200 bytes, the
+//     TermSink caps) at a UTF-8 boundary. The bytes are NOT sanitized: COBS framing
+//     cannot be broken by payload content, so a '\n' in a message is just a byte.
+//   * SUMMARY carries encodeSummary()'s payload, with the sink's own drop count.
+//   * DEFERRED LINES (SHULIB_LOGF, diag/deferred_log.hpp) carry the blackbox's own
+//     FormatDef/LogArgs payloads: the definition once per id, then the id, level, time
+//     (the last tick's t — the sink has no clock) and the packed arguments. A definition
+//     the budget drops takes its line with it and is resent with the next one.
+//
+// The master plan sketched SHUL/2 as JSON; it is binary because a 428-byte record at
+// 100 Hz is ~43 KB/s raw and several times that as text, past what the V5 USB serial
+// path carries beside the terminal. The wire version byte (kShul2WireVersion) is this
+// protocol's own; the F9 freeze is still H1's to declare against it.
+//
+// ── Integrity: COBS, CRC-16, sequence ───────────────────────────────────────────────
+// The blackbox has no checksum — a card either holds the bytes or does not. A serial
+// link can lose, duplicate and flip bytes mid-stream, so the wire checks three things:
+//   * FRAMING: COBS (Cheshire & Baker, 1999) removes every 0x00 from the frame, so 0x00
+//     is an unambiguous delimiter and a host that connects mid-stream, or loses bytes,
+//     resynchronises at the next one. Overhead: one byte per 254, plus the delimiter.
+//   * CONTENT: CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over version, type, seq and
+//     payload. A frame that fails it is dropped and counted, never decoded.
+//   * LOSS: a u16 WIRE sequence, one per frame written, so the host counts the frames it
+//     never saw. It is separate from the compact chain's sequence, which advances only
+//     per tick: a lost delta also breaks the chain, and the decoder refuses deltas until
+//     the next keyframe (every keyframeInterval ticks) — refuse, never misread.
+//
+// ── The per-tick byte budget ────────────────────────────────────────────────────────
+// The sink never queues. A token bucket refills by bytesPerTick whenever emit() sees a
+// new record time, capped at burstBytes; a tick or log frame that does not fit the
+// bucket is dropped WHOLE and counted (droppedTicks()/droppedLines()). A dropped tick is
+// never committed to the chain, so the next delta is encoded against the last tick the
+// host actually received and the chain survives the drop intact. burstBytes must hold
+// one keyframe (~440 bytes after COBS), or no keyframe would ever fit; the constructor
+// checks it. The summary is once per run and bypasses the budget.
+//
+// Cost: ~1.5 KB of compact-encoder state plus two ~450-byte frame buffers, inside the
+// sink. A bitwise CRC (no table, no flash) and one COBS pass per frame. Allocation-free,
+// never throws, single-task — like every sink here. The decoder is allocation-free too,
+// so a second brain could read the wire as well as a host tool can.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "shulib/core/check.hpp"
+#include "shulib/diag/blackbox_compact.hpp"
+#include "shulib/diag/blackbox_format.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/deferred_log.hpp"
+#include "shulib/diag/run_summary.hpp"
+#include "shulib/hal/char_sink.hpp"
+#include "shulib/hal/telemetry_sink.hpp"
+
+namespace shulib::diag {
+
+/// The SHUL/2 wire version this header writes and reads. A decoder refuses any other.
+inline constexpr std::uint8_t kShul2WireVersion = 1;
+
+/// What a SHUL/2 frame carries. WIRE-STABLE: explicit values, append-only — a decoder
+/// skips an unknown type, never guesses at it.
+enum class Shul2FrameType : std::uint8_t {
+    TickKey = 1,    ///< a compact-stream keyframe (blackbox::kTickKeyPayloadBytes)
+    TickDelta = 2,  ///< a compact-stream delta (at most blackbox::kTickDeltaMaxPayloadBytes)
+    Log = 3,        ///< u8 level | u8 tag length | tag | message
+    Summary = 4,    ///< encodeSummary()'s payload (blackbox::kSummaryPayloadBytes)
+    FormatDef = 5,  ///< blackbox::encodeFormatDef()'s payload: one interned format
+    LogArgs = 6,    ///< blackbox::encodeLogArgs()'s payload: one deferred line
+};
+
+/// Version, type and sequence: the bytes before every payload.
+inline constexpr std::size_t kShul2HeaderBytes = 4;
+/// The trailing CRC-16.
+inline constexpr std::size_t kShul2CrcBytes = 2;
+/// The log tag cap, in bytes (TermSink's).
+inline constexpr std::size_t kShul2MaxTagBytes = 16;
+/// The log message cap, in bytes (TermSink's).
+inline constexpr std::size_t kShul2MaxMessageBytes = 200;
+/// The largest payload any frame type carries: the keyframe.
+inline constexpr std::size_t kShul2MaxPayloadBytes = blackbox::kTickKeyPayloadBytes;
+/// The largest raw (pre-COBS) frame.
+inline constexpr std::size_t kShul2MaxRawBytes =
+    kShul2HeaderBytes + kShul2MaxPayloadBytes + kShul2CrcBytes;
+/// The largest frame on the wire: COBS adds one byte per 254 (plus one), then the 0x00.
+inline constexpr std::size_t kShul2MaxWireBytes = kShul2MaxRawBytes + kShul2MaxRawBytes / 254 + 2;
+
+static_assert(2 + kShul2MaxTagBytes + kShul2MaxMessageBytes <= kShul2MaxPayloadBytes);
+static_assert(blackbox::kSummaryPayloadBytes <= kShul2MaxPayloadBytes);
+static_assert(blackbox::kFormatDefMaxPayloadBytes <= kShul2MaxPayloadBytes);
+static_assert(blackbox::kLogArgsMaxPayloadBytes <= kShul2MaxPayloadBytes);
+
+/// Bytes the budget refills per tick: 19.2 KB/s at a 100 Hz loop, which carries the
+/// typical 30–80-byte delta plus a few log lines, and leaves the rest of the link to the
+/// terminal. PROVISIONAL (A4: HA-130) — INVENTED; R4 measures the real USB throughput.
+inline constexpr std::size_t kDefaultShul2BytesPerTick = 192;
+/// The bucket's ceiling: two keyframes, so a keyframe fits after a short quiet spell.
+inline constexpr std::size_t kDefaultShul2BurstBytes = 2 * kShul2MaxWireBytes;
+
+/// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, unreflected, no final XOR) of `bytes`.
+/// Bitwise — no table. Check value: "123456789" → 0x29B1.
+[[nodiscard]] constexpr std::uint16_t crc16CcittFalse(std::span<const std::byte> bytes) noexcept {
+    std::uint16_t crc = 0xFFFFU;
+    for (const std::byte b : bytes) {
+        crc = static_cast<std::uint16_t>(crc ^ (static_cast<unsigned>(b) << 8));
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000U) != 0U ? static_cast<std::uint16_t>((crc << 1) ^ 0x1021U)
+                                        : static_cast<std::uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/// COBS-encode `in` into `out` (no delimiter). Returns the bytes written, or 0 when
+/// `out` is too small — it needs in.size() + in.size() / 254 + 1.
+[[nodiscard]] inline std::size_t cobsEncode(std::span<const std::byte> in,
+                                            std::span<std::byte> out) noexcept {
+    if (out.size() < in.size() + in.size() / 254 + 1) {
+        return 0;
+    }
+    std::size_t codeAt = 0;
+    std::size_t at = 1;
+    std::uint8_t code = 1;
+    for (const std::byte b : in) {
+        if (b != std::byte{0}) {
+            out[at++] = b;
+            ++code;
+        }
+        if (b == std::byte{0} || code == 0xFFU) {
+            out[codeAt] = static_cast<std::byte>(code);
+            codeAt = at++;
+            code = 1;
+        }
+    }
+    out[codeAt] = static_cast<std::byte>(code);
+    return at;
+}
+
+/// COBS-decode `in` (one frame, delimiter stripped) into `out`. Returns the bytes
+/// written, or 0 for a malformed frame (a 0x00 inside it, or a code running past its end)
+/// or one that does not fit `out`.
+[[nodiscard]] inline std::size_t cobsDecode(std::span<const std::byte> in,
+                                            std::span<std::byte> out) noexcept {
+    std::size_t at = 0;
+    std::size_t i = 0;
+    while (i < in.size()) {
+        const auto code = static_cast<std::size_t>(in[i++]);
+        if (code == 0 || i + code - 1 > in.size()) {
+            return 0;
+        }
+        for (std::size_t k = 1; k < code; ++k) {
+            if (in[i] == std::byte{0} || at == out.size()) {
+                return 0;
+            }
+            out[at++] = in[i++];
+        }
+        // A short group implies a zero — except after the last group of the frame.
+        if (code < 0xFFU && i < in.size()) {
+            if (at == out.size()) {
+                return 0;
+            }
+            out[at++] = std::byte{0};
+        }
+    }
+    return at;
+}
+
+/// Shul2Sink's knobs.
+struct Shul2SinkConfig {
+    /// false ⇒ the sink is inert: wantsRecord() is false, and no byte is ever written.
+    bool enabled = true;
+    /// Bytes the budget refills per tick (a new record time at emit()).
+    std::size_t bytesPerTick = kDefaultShul2BytesPerTick;
+    /// The budget's ceiling. Must hold one keyframe frame (kShul2MaxWireBytes).
+    std::size_t burstBytes = kDefaultShul2BurstBytes;
+    /// A keyframe at least every this many transmitted ticks (≥ 1).
+    std::size_t keyframeInterval = blackbox::kDefaultKeyframeInterval;
+};
+
+/// The SHUL/2 wire: every DebugRecord as a compact tick frame, every log line and the run
+/// summary as their own frames, each COBS-framed with a CRC-16 and a wire sequence and
+/// handed to the ICharSink as exactly ONE write() (header note). A per-tick token-bucket
+/// budget bounds the link's load; a frame that does not fit is dropped WHOLE and counted,
+/// and a dropped tick never breaks the delta chain. Allocation-free, never throws,
+/// single-task.
+class Shul2Sink final : public hal::ITelemetrySink {
+public:
+    /// `out` is the serial device (R1's USB adapter on the robot, FakeCharSink in tests);
+    /// it must outlive the sink.
+    explicit Shul2Sink(hal::ICharSink& out, const Shul2SinkConfig& config = {})
+        : out_{out}, cfg_{config}, ticks_{config.keyframeInterval},
+          budget_{config.burstBytes} {
+        SHULIB_PRECONDITION(config.burstBytes >= kShul2MaxWireBytes,
+                            "Shul2Sink: burstBytes must hold one keyframe, or none would "
+                            "ever be sent");
+    }
+
+    /// One Log frame, if the budget holds it; otherwise counted in droppedLines().
+    void log(hal::LogLevel level, std::string_view subsystem, std::string_view message) override {
+        if (!cfg_.enabled) {
+            return;
+        }
+        const std::string_view tag = utf8Prefix(subsystem, kShul2MaxTagBytes);
+        const std::string_view text = utf8Prefix(message, kShul2MaxMessageBytes);
+        std::array<std::byte, 2 + kShul2MaxTagBytes + kShul2MaxMessageBytes> payload{};
+        payload[0] = static_cast<std::byte>(level);
+        payload[1] = static_cast<std::byte>(tag.size());
+        std::size_t at = 2;
+        for (const char c : tag) {
+            payload[at++] = static_cast<std::byte>(c);
+        }
+        for (const char c : text) {
+            payload[at++] = static_cast<std::byte>(c);
+        }
+        if (!send(Shul2FrameType::Log, std::span<const std::byte>{payload}.first(at), true)) {
+            ++droppedLines_;
+        }
+    }
+
+    /// One LogArgs frame, behind a FormatDef frame the first time the id is sent (header
+    /// note), both budgeted; a line that does not fit is counted in droppedLines().
+    void logDeferred(const DeferredLog& line) override {
+        if (!cfg_.enabled) {
+            return;
+        }
+        std::array<std::byte, kShul2MaxPayloadBytes> payload{};
+        if (!interned_.known(line.id)) {
+            const std::size_t n = blackbox::encodeFormatDef(payload, line);
+            if (n == 0
+                || !send(Shul2FrameType::FormatDef, std::span<const std::byte>{payload}.first(n),
+                         true)) {
+                ++droppedLines_;
+                return;
+            }
+            interned_.remember(line.id);
+        }
+        const std::size_t n = blackbox::encodeLogArgs(payload, line, lastTickT_);
+        if (n == 0
+            || !send(Shul2FrameType::LogArgs, std::span<const std::byte>{payload}.first(n), true)) {
+            ++droppedLines_;
+        }
+    }
+
+    /// True while the sink is enabled. Overridden as a pair with emit(), per the seam
+    /// contract.
+    [[nodiscard]] bool wantsRecord() const noexcept override { return cfg_.enabled; }
+
+    /// One tick frame — a keyframe or a delta — if the budget holds it; otherwise counted
+    /// in droppedTicks() and NOT committed, so the chain stays on the last tick sent. A
+    /// record with a new `t` refills the budget first.
+    void emit(const DebugRecord& record) override {
+        if (!cfg_.enabled) {
+            return;
+        }
+        const double t = record.t.value();
+        if (!haveTick_ || t != lastTickT_) {
+            budget_ = budget_ + cfg_.bytesPerTick > cfg_.burstBytes
+                          ? cfg_.burstBytes
+                          : budget_ + cfg_.bytesPerTick;
+            lastTickT_ = t;
+            haveTick_ = true;
+        }
+        const blackbox::CompactTickEncoder::Encoded e = ticks_.encode(record);
+        if (e.payload.empty()) {
+            ++droppedTicks_;
+            return;
+        }
+        const Shul2FrameType type = e.type == blackbox::FrameType::TickKey
+                                        ? Shul2FrameType::TickKey
+                                        : Shul2FrameType::TickDelta;
+        if (send(type, e.payload, true)) {
+            ticks_.commit();
+        } else {
+            ++droppedTicks_;
+        }
+    }
+
+    /// The run summary as one frame, outside the budget (once per run). The sink's own
+    /// drop count — ticks plus lines — rides in the blackbox-dropped slot.
+    void summarize(const RunSummary& summary) override {
+        if (!cfg_.enabled) {
+            return;
+        }
+        std::array<std::byte, blackbox::kSummaryPayloadBytes> payload{};
+        const std::size_t n = blackbox::encodeSummary(payload, summary, droppedTicks_ + droppedLines_);
+        if (n != 0) {
+            (void)send(Shul2FrameType::Summary, std::span<const std::byte>{payload}.first(n), false);
+        }
+    }
+
+    /// A new reader joined the link (a host client reconnected): the next tick frame is
+    /// a keyframe, so it decodes from its first tick instead of waiting out the interval.
+    void restartChain() noexcept { ticks_.restartChain(); }
+
+    /// Tick frames dropped by the budget (or unencodable).
+    [[nodiscard]] std::uint32_t droppedTicks() const noexcept { return droppedTicks_; }
+    /// Log and deferred-log frames dropped by the budget.
+    [[nodiscard]] std::uint32_t droppedLines() const noexcept { return droppedLines_; }
+    /// Frames written to the device.
+    [[nodiscard]] std::uint32_t framesSent() const noexcept { return framesSent_; }
+    /// Bytes written to the device, delimiters included.
+    [[nodiscard]] std::uint64_t bytesSent() const noexcept { return bytesSent_; }
+    /// Keyframes sent so far.
+    [[nodiscard]] std::uint32_t keyframesSent() const noexcept { return ticks_.keyframes(); }
+    /// The budget left in the current tick, in bytes.
+    [[nodiscard]] std::size_t budgetLeft() const noexcept { return budget_; }
+
+private:
+    /// The longest prefix of `s` no longer than `cap` that does not split a UTF-8 sequence.
+    [[nodiscard]] static std::string_view utf8Prefix(std::string_view s, std::size_t cap) noexcept {
+        if (s.size() <= cap) {
+            return s;
+        }
+        std::size_t n = cap;
+        while (n > 0 && (static_cast<unsigned char>(s[n]) & 0xC0U) == 0x80U) {
+            --n;
+        }
+        return s.substr(0, n);
+    }
+
+    /// Frame, checksum, stuff and write one message. `budgeted` frames spend the bucket
+    /// and are refused whole when it cannot hold them.
+    [[nodiscard]] bool send(Shul2FrameType type, std::span<const std::byte> payload,
+                            bool budgeted) noexcept {
+        const std::size_t rawBytes = kShul2HeaderBytes + payload.size() + kShul2CrcBytes;
+        if (rawBytes > raw_.size()) {
+            return false;
+        }
+        raw_[0] = static_cast<std::byte>(kShul2WireVersion);
+        raw_[1] = static_cast<std::byte>(type);
+        raw_[2] = static_cast<std::byte>(seq_ & 0xFFU);
+        raw_[3] = static_cast<std::byte>(seq_ >> 8);
+        for (std::size_t i = 0; i < payload.size(); ++i) {
+            raw_[kShul2HeaderBytes + i] = payload[i];
+        }
+        const std::uint16_t crc =
+            crc16CcittFalse(std::span<const std::byte>{raw_}.first(rawBytes - kShul2CrcBytes));
+        raw_[rawBytes - 2] = static_cast<std::byte>(crc & 0xFFU);
+        raw_[rawBytes - 1] = static_cast<std::byte>(crc >> 8);
+        const std::size_t n =
+            cobsEncode(std::span<const std::byte>{raw_}.first(rawBytes), wire_);
+        if (n == 0) {
+            return false;
+        }
+        wire_[n] = std::byte{0};
+        const std::size_t wireBytes = n + 1;
+        if (budgeted) {
+            if (wireBytes > budget_) {
+                return false;
+            }
+            budget_ -= wireBytes;
+        }
+        out_.write(std::string_view{reinterpret_cast<const char*>(wire_.data()), wireBytes});
+        seq_ = static_cast<std::uint16_t>(seq_ + 1U);
+        ++framesSent_;
+        bytesSent_ += wireBytes;
+        return true;
+    }
+
+    hal::ICharSink& out_;
+    Shul2SinkConfig cfg_;
+    blackbox::CompactTickEncoder ticks_;
+    InternedFormats interned_;
+    std::array<std::byte, kShul2MaxRawBytes> raw_{};
+    std::array<std::byte, kShul2MaxWireBytes> wire_{};
+    std::size_t budget_;
+    double lastTickT_ = 0.0;
+    bool haveTick_ = false;
+    std::uint16_t seq_ = 0;
+    std::uint32_t droppedTicks_ = 0;
+    std::uint32_t droppedLines_ = 0;
+    std::uint32_t framesSent_ = 0;
+    std::uint64_t bytesSent_ = 0;
+};
+
+/// The host half of the SHUL/2 wire: feed() it the byte stream as it arrives, in any
+/// chunking, and it yields one verified frame at a time — COBS-decoded, version- and
+/// CRC-checked, with sequence gaps counted as lost frames. The read*() helpers decode the
+/// current frame; readTick() runs the compact chain, so a delta after a loss is REFUSED
+/// until the next keyframe. A stream joined mid-frame resynchronises at the next 0x00.
+/// Allocation-free, never throws.
+class Shul2Decoder {
+public:
+    /// One verified frame; `payload` views the decoder's buffer until the next feed().
+    struct Frame {
+        Shul2FrameType type = Shul2FrameType::TickKey;  ///< what the payload carries
+        std::uint16_t seq = 0;                          ///< the wire sequence
+        std::span<const std::byte> payload{};           ///< the payload, CRC stripped
+    };
+
+    /// One decoded log line; the views point into the current frame's payload.
+    struct LogLine {
+        hal::LogLevel level = hal::LogLevel::Info;  ///< the line's level
+        std::string_view tag{};                     ///< the subsystem tag
+        std::string_view message{};                 ///< the message text
+    };
+
+    /// Push one received byte. True when it completed a VALID frame, now in frame();
+    /// a delimiter ending an invalid one is counted (framingErrors()/crcErrors()).
+    [[nodiscard]] bool feed(std::byte b) noexcept {
+        if (b != std::byte{0}) {
+            if (at_ < stuffed_.size()) {
+                stuffed_[at_] = b;
+            } else {
+                overflow_ = true;  // swallowed until the delimiter, then counted once
+            }
+            ++at_;
+            return false;
+        }
+        const std::size_t len = at_;
+        const bool overflowed = overflow_;
+        at_ = 0;
+        overflow_ = false;
+        if (len == 0) {
+            return false;  // back-to-back delimiters: an idle line, not an error
+        }
+        if (overflowed) {
+            ++framingErrors_;
+            return false;
+        }
+        const std::size_t n = cobsDecode(std::span<const std::byte>{stuffed_}.first(len), raw_);
+        if (n < kShul2HeaderBytes + kShul2CrcBytes) {
+            ++framingErrors_;
+            return false;
+        }
+        const auto crc = static_cast<std::uint16_t>(
+            static_cast<unsigned>(raw_[n - 2]) | (static_cast<unsigned>(raw_[n - 1]) << 8));
+        if (crc16CcittFalse(std::span<const std::byte>{raw_}.first(n - kShul2CrcBytes)) != crc) {
+            ++crcErrors_;
+            return false;
+        }
+        if (static_cast<std::uint8_t>(raw_[0]) != kShul2WireVersion) {
+            ++versionErrors_;
+            return false;
+        }
+        const auto seq = static_cast<std::uint16_t>(static_cast<unsigned>(raw_[2])
+                                                    | (static_cast<unsigned>(raw_[3]) << 8));
+        if (synced_) {
+            lostFrames_ += static_cast<std::uint16_t>(seq - static_cast<std::uint16_t>(lastSeq_ + 1U));
+        }
+        synced_ = true;
+        lastSeq_ = seq;
+        ++frames_;
+        frame_ = Frame{static_cast<Shul2FrameType>(raw_[1]), seq,
+                       std::span<const std::byte>{raw_}.subspan(
+                           kShul2HeaderBytes, n - kShul2HeaderBytes - kShul2CrcBytes)};
+        return true;
+    }
+
+    /// The last valid frame feed() reported.
+    [[nodiscard]] const Frame& frame() const noexcept { return frame_; }
+
+    /// Decode the current frame as a tick. False for a non-tick frame, a delta whose
+    /// chain is broken, or a malformed payload (`corrupt` raised, never cleared).
+    [[nodiscard]] bool readTick(DebugRecord& r, bool& corrupt) noexcept {
+        if (frame_.type == Shul2FrameType::TickKey) {
+            return ticks_.decode(blackbox::FrameType::TickKey, frame_.payload, r, corrupt);
+        }
+        if (frame_.type == Shul2FrameType::TickDelta) {
+            return ticks_.decode(blackbox::FrameType::TickDelta, frame_.payload, r, corrupt);
+        }
+        return false;
+    }
+
+    /// Decode the current frame as a log line. False for any other frame or a malformed one.
+    [[nodiscard]] bool readLog(LogLine& line) const noexcept {
+        const std::span<const std::byte> p = frame_.payload;
+        if (frame_.type != Shul2FrameType::Log || p.size() < 2) {
+            return false;
+        }
+        const auto tagBytes = static_cast<std::size_t>(p[1]);
+        if (2 + tagBytes > p.size()) {
+            return false;
+        }
+        const auto* chars = reinterpret_cast<const char*>(p.data());
+        line.level = static_cast<hal::LogLevel>(p[0]);
+        line.tag = std::string_view{chars + 2, tagBytes};
+        line.message = std::string_view{chars + 2 + tagBytes, p.size() - 2 - tagBytes};
+        return true;
+    }
+
+    /// Decode the current frame as the run summary; `sinkDropped` receives the sender's
+    /// own drop count (ticks plus lines). False for any other frame or a malformed one.
+    [[nodiscard]] bool readSummary(RunSummary& s, std::uint32_t& sinkDropped) const noexcept {
+        return frame_.type == Shul2FrameType::Summary
+               && blackbox::decodeSummary(frame_.payload, s, sinkDropped);
+    }
+
+    /// Valid frames received.
+    [[nodiscard]] std::uint32_t frames() const noexcept { return frames_; }
+    /// Frames the wire sequence says were sent but never arrived intact.
+    [[nodiscard]] std::uint32_t lostFrames() const noexcept { return lostFrames_; }
+    /// Frames that failed the CRC.
+    [[nodiscard]] std::uint32_t crcErrors() const noexcept { return crcErrors_; }
+    /// Frames that were not valid COBS, too short, or too long.
+    [[nodiscard]] std::uint32_t framingErrors() const noexcept { return framingErrors_; }
+    /// CRC-valid frames of a wire version this decoder does not read.
+    [[nodiscard]] std::uint32_t versionErrors() const noexcept { return versionErrors_; }
+    /// Delta frames refused because the compact chain was broken.
+    [[nodiscard]] std::uint32_t unresolvedTicks() const noexcept { return ticks_.unresolved(); }
+
+private:
+    std::array<std::byte, kShul2MaxWireBytes> stuffed_{};
+    std::array<std::byte, kShul2MaxRawBytes> raw_{};
+    std::size_t at_ = 0;
+    bool overflow_ = false;
+    bool synced_ = false;
+    std::uint16_t lastSeq_ = 0;
+    Frame frame_{};
+    blackbox::CompactTickDecoder ticks_;
+    std::uint32_t frames_ = 0;
+    std::uint32_t lostFrames_ = 0;
+    std::uint32_t crcErrors_ = 0;
+    std::uint32_t framingErrors_ = 0;
+    std::uint32_t versionErrors_ = 0;
+};
+
+}  // namespace shulib::diag
@@ -20,7 +20,10 @@
 //                       (nudge clamped), " flt=NAME" (fault this tick). The line shows
 //                       the HEADLINE fields; the full record belongs to SdSink/SHUL/2.
 //   run summary:      summarize(RunSummary) renders the §18.3 one-screen block (chunk
-//                     C5) — six lines, unstamped, byte-pinned by golden test. The
+//                     C5) — six lines, plus up to two tick-timing lines when the run
+//                     measured any (loop dt, per-phase) and one line per profiled zone
+//                     when a ZoneProfiler was attached, unstamped, byte-pinned by
+//                     golden test. The
 //                     per-motion RESULT LINE does not enter here: it rides log() as
 //                     structured Info text (diag/motion_result.hpp formats it), which
 //                     is what gives it the exact "[t=…] [MOT] …" §18.3 shape.
@@ -47,16 +50,20 @@
 // Concurrency contract (the legacy racing-flush, designed OUT rather than fixed): the
 // sink holds NO mutable state — no buffer, no queue, no background flush task. Each LINE
 // is formatted into a stack-local buffer and handed to the device as exactly one write():
-// one for log(), one for emit(), SIX for summarize()'s block. So a line can never be torn
-// or interleaved mid-way — but whole lines can be, summarize()'s six included. If multiple
+// one for log(), one for emit(), SIX OR MORE for summarize()'s block. So a line can never be
+// torn or interleaved mid-way — but whole lines can be, summarize()'s included. If multiple
 // tasks share one TermSink, ordering across writes is whatever the ICharSink's per-call
 // atomicity provides. Nothing here allocates.
 
+#include <cstddef>
 #include <string_view>
 
 #include "shulib/diag/debug_record.hpp"
 #include "shulib/diag/line_format.hpp"
 #include "shulib/diag/run_summary.hpp"
+#include "shulib/diag/tick_attribution.hpp"
+#include "shulib/diag/tick_budget.hpp"
+#include "shulib/diag/tick_histogram.hpp"
 #include "shulib/hal/char_sink.hpp"
 #include "shulib/hal/clock.hpp"
 #include "shulib/hal/telemetry_sink.hpp"
@@ -68,9 +75,9 @@ namespace shulib::diag {
 /// log(), one column-aligned line per DebugRecord from emit(), and the one-screen block from
 /// summarize(). It holds NO mutable state — no buffer, no queue, no background flush — so every
 /// LINE is formatted into a stack-local buffer and handed to the ICharSink as exactly ONE write():
-/// one for log(), one for emit(), six for summarize()'s block. A line can therefore never be torn
+/// one for log(), one for emit(), six or more for summarize()'s block. A line can therefore never be torn
 /// or interleaved mid-way, whatever a caller's string contains; whole LINES can be, so two tasks
-/// sharing a sink can split summarize()'s six. Nothing here allocates. Every line is pinned by a
+/// sharing a sink can split summarize()'s block. Nothing here allocates. Every line is pinned by a
 /// golden test, which is why the character device is injected rather than hard-coded to stdout.
 /// This is a DISPLAY edge: degrees are rendered here and only here, and only the headline fields
 /// appear — the full record belongs to the blackbox and SHUL/2 sinks.
@@ -166,7 +173,7 @@ public:
 
     /// Render the §18.3 one-screen run-summary block. UNSTAMPED by design — the
     /// block is a run artifact, not a timed event (the sketch shows no [t=]); each
-    /// of its six lines is one write() (the framing contract). Field renderings
+    /// of its lines is one write() (the framing contract). Field renderings
     /// (chosen at C5, each pinned by golden test):
     ///   * heading values render "n/a" when hasHeadingData is false — the block
     ///     never fabricates a 0.0° it has no data for
@@ -176,6 +183,12 @@ public:
     ///     is a positive health claim, not noise (D-2: silence is the bug)
     ///   * first fault carries its latch time ("ODO_STUCK@  4.2s") — the 2am
     ///     root-cause line
+    ///   * the loop-dt line (p50/p95/p99/max) appears only when a dt was measured,
+    ///     the phase line (p99/max) only for slots with a producer — never "0.00ms"
+    ///     for something nobody timed
+    ///   * the zone table (one line per zone, indented by depth: calls, total, self,
+    ///     p99/max) appears only when a profiler filled it, with a refused count only
+    ///     when a zone did not fit
     void summarize(const RunSummary& s) override {
         {
             Line line;
@@ -245,9 +258,93 @@ public:
                 line.appendLiteral(" · blackbox dropped ");
                 appendUnsigned(line, s.blackboxDropped);
             }
+            // Load shedding: the same ONLY-when-it-happened rule, for the same reason —
+            // "shed 0" on a run with no TickBudget would describe a shedder that never
+            // ran. Per-class shed TICKS, in shed order.
+            if (s.hasLoadShedData && s.shedMaxLevel > 0) {
+                line.appendLiteral(" · shed");
+                for (std::size_t i = 0; i < s.shedTicks.size(); ++i) {
+                    line.appendLiteral(" ");
+                    line.appendLiteral(sheddableWorkName(static_cast<SheddableWork>(i)));
+                    line.appendLiteral(" ");
+                    appendUnsigned(line, s.shedTicks[i]);
+                }
+            }
+            line.appendLiteral("\n");
+            out_.write(line.view());
+        }
+        // Tick-timing distributions: the same ONLY-when-measured rule. worstLoopDt above is
+        // the tip; these are the shape under it — a loop that is sometimes 14.9 ms and one
+        // that always is differ here and nowhere else.
+        if (s.loopDt.count != 0) {
+            Line line;
+            line.appendLiteral(" loop dt p50 ");
+            appendTimingMs(line, s.loopDt.p50);
+            line.appendLiteral(" · p95 ");
+            appendTimingMs(line, s.loopDt.p95);
+            line.appendLiteral(" · p99 ");
+            appendTimingMs(line, s.loopDt.p99);
+            line.appendLiteral(" · max ");
+            appendTimingMs(line, s.loopDt.max);
+            line.appendLiteral("ms · n ");
+            appendUnsigned(line, s.loopDt.count);
             line.appendLiteral("\n");
             out_.write(line.view());
         }
+        if (anyPhaseMeasured(s)) {
+            Line line;
+            line.appendLiteral(" phase p99/max");
+            const char* sep = " ";
+            for (std::size_t i = 0; i < s.phaseTiming.size(); ++i) {
+                const TickTimingStats& p = s.phaseTiming[i];
+                if (p.count == 0 || p.max.value() <= 0.0) {
+                    continue;  // no producer for this slot: absent, not "0 ms"
+                }
+                line.appendLiteral(sep);
+                line.appendLiteral(tickPhaseName(static_cast<TickPhase>(i)));
+                line.appendLiteral(" ");
+                appendTimingMs(line, p.p99);
+                line.appendLiteral("/");
+                appendTimingMs(line, p.max);
+                sep = " · ";
+            }
+            line.appendLiteral("ms\n");
+            out_.write(line.view());
+        }
+        const std::size_t zoneRows = s.zoneCount < kMaxZones ? s.zoneCount : kMaxZones;
+        for (std::size_t i = 0; i < zoneRows; ++i) {
+            const ZoneTimingRow& z = s.zones[i];
+            Line line;
+            line.appendLiteral(" zone ");
+            std::size_t used = 0;
+            for (std::size_t d = 0; d < z.depth; ++d, used += 2) {
+                line.appendLiteral("  ");
+            }
+            line.appendSanitized(z.nameView(), kMaxZoneNameBytes);
+            used += z.nameView().size();
+            for (; used < kZoneColumnBytes; ++used) {
+                line.appendLiteral(" ");
+            }
+            line.appendLiteral(" n ");
+            appendUnsigned(line, z.calls);
+            line.appendLiteral(" · tot ");
+            appendTimingMs(line, z.total);
+            line.appendLiteral(" · self ");
+            appendTimingMs(line, z.self);
+            line.appendLiteral(" · p99/max ");
+            appendTimingMs(line, z.p99);
+            line.appendLiteral("/");
+            appendTimingMs(line, z.max);
+            line.appendLiteral("ms\n");
+            out_.write(line.view());
+        }
+        if (s.hasZoneData() && s.zonesRefused != 0) {
+            Line line;
+            line.appendLiteral(" zones refused ");
+            appendUnsigned(line, s.zonesRefused);
+            line.appendLiteral(" (table full or too deep)\n");
+            out_.write(line.view());
+        }
         {
             Line line;
             line.appendLiteral(" build ");
@@ -277,6 +374,7 @@ private:
     static constexpr std::size_t kMaxTagBytes = 16;       ///< subsystem tags are short by design
     static constexpr std::size_t kMaxMessageBytes = 200;  ///< structured fields, not essays (§18)
     static constexpr std::size_t kMaxHashBytes = 47;      ///< full SHA + "-dirty" (RunSummary)
+    static constexpr std::size_t kZoneColumnBytes = 19;   ///< indent + name, padded to align
     static constexpr double kRadToDeg = 180.0 / math::Angle::kPi;
 
     /// The bounded line + fixed-width numerics moved to diag/line_format.hpp at C5
@@ -285,6 +383,20 @@ private:
     /// Unqualified appendNum/appendTimestamp/… calls resolve by ADL on lineformat::Line.
     using Line = lineformat::Line;
 
+    /// Seconds → milliseconds at the summary's timing width (%6.2f).
+    static void appendTimingMs(Line& line, units::Time t) { appendNum(line, t.value() * 1000.0, 6, 2); }
+
+    /// True when at least one phase slot has samples AND a producer (max > 0) — the
+    /// condition for the phase line to say anything at all.
+    [[nodiscard]] static bool anyPhaseMeasured(const RunSummary& s) noexcept {
+        for (const TickTimingStats& p : s.phaseTiming) {
+            if (p.count != 0 && p.max.value() > 0.0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     static const char* levelTag(hal::LogLevel level) noexcept {
         switch (level) {
             case hal::LogLevel::Error: return "[ERROR]";
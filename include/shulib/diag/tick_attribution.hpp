@@ -30,6 +30,14 @@
 // total on the same clock; total − attributed = "other" (un-instrumented work +
 // pacing), reported as its own quantity rather than smeared into a named phase.
 //
+// Per-phase DISTRIBUTIONS: the last tick's breakdown answers "who blew THIS tick"; it
+// cannot answer "what does localization usually cost". So endTick() also bins every
+// slot's duration into a fixed-bin histogram (tick_histogram.hpp, kPhaseHistogramRange)
+// — phaseHistogram() gives p50/p95/p99/max per phase at run end. A slot with no producer
+// bins a 0 every tick (underflow, a compare), so its max stays 0: that is how a renderer
+// tells "never measured" from "cheap". abandonTick() bins nothing — a half-measured tick
+// is not a sample.
+//
 // Single-task by contract, like the rest of diag/.
 
 #include <array>
@@ -39,6 +47,7 @@
 
 #include "shulib/core/check.hpp"
 #include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/tick_histogram.hpp"
 #include "shulib/hal/clock.hpp"
 #include "shulib/units/quantity.hpp"
 
@@ -58,8 +67,15 @@ public:
     /// to the vocabulary instead of a reshape of the telemetry wire.
     using Phases = std::array<units::Time, static_cast<std::size_t>(kTickPhaseSlots)>;
 
-    /// `clock` must outlive the instance (see header for WHICH clock).
-    explicit TickAttribution(hal::IClock& clock) noexcept : clock_{clock} {}
+    /// One histogram per phase slot, indexed by TickPhase (header note).
+    using PhaseHistograms = std::array<TickHistogram, static_cast<std::size_t>(kTickPhaseSlots)>;
+
+    /// `clock` must outlive the instance (see header for WHICH clock). Every phase histogram
+    /// spans kPhaseHistogramRange — a constant that meets TickHistogram's preconditions, which
+    /// is what keeps this noexcept.
+    explicit TickAttribution(hal::IClock& clock) noexcept : clock_{clock} {
+        phaseHist_.fill(TickHistogram{kPhaseHistogramRange});
+    }
 
     /// Open a tick: zero the working phases, mark the start instant.
     void beginTick() {
@@ -145,6 +161,9 @@ public:
         last_ = current_;
         lastTotal_ = clock_.now() - tickStart_;
         hasCompleted_ = true;
+        for (std::size_t i = 0; i < last_.size(); ++i) {
+            phaseHist_[i].record(last_[i]);
+        }
     }
 
     /// Discard a half-measured tick (an exception unwound through the tick body):
@@ -192,8 +211,18 @@ public:
         return static_cast<TickPhase>(worst);
     }
 
-    /// Forget everything (run boundary). The next tick starts a fresh story.
+    /// Every completed tick's duration for `p`, binned (header note). Unlike lastPhases() this
+    /// is the whole story since construction or reset(), not one tick of it.
+    [[nodiscard]] const TickHistogram& phaseHistogram(TickPhase p) const noexcept {
+        return phaseHist_[static_cast<std::size_t>(p)];
+    }
+
+    /// Forget everything (run boundary), the phase histograms included. The next tick
+    /// starts a fresh story.
     void reset() noexcept {
+        for (TickHistogram& h : phaseHist_) {
+            h.reset();
+        }
         tickOpen_ = false;
         hasCompleted_ = false;
         current_.fill(units::Time{0.0});
@@ -205,6 +234,7 @@ private:
     hal::IClock& clock_;
     Phases current_{};
     Phases last_{};
+    PhaseHistograms phaseHist_;
     units::Time tickStart_{};
     units::Time lastTotal_{};
     bool tickOpen_ = false;
@@ -0,0 +1,261 @@
+#pragma once
+//
+// TickBudget — deadline-aware LOAD SHEDDING for the control tick (WS13; follows D-3).
+//
+// LoopMonitor DETECTS a blown tick and TickAttribution NAMES who consumed it, but
+// neither ACTS: a loop that runs hot keeps doing every optional thing it did when it
+// ran cool, overruns, and every dt-dependent computation downstream quietly degrades.
+// This is the missing third step. It reads the running tick cost against the SAME
+// budget LoopMonitor enforces and, as the margin closes, sheds OPTIONAL work in a
+// declared priority order — so pressure turns into graceful degradation instead of a
+// corrupted dt.
+//
+// ── The shed order (declared, not discovered) ───────────────────────────────────────
+// Cheapest-to-lose first; each level sheds everything below it as well:
+//   1. RecordPopulation — record building for RATE-LIMITED sinks (RateLimitedSink
+//      answers wantsRecord() = false while shed). The terminal's view of a hot loop is
+//      the least valuable thing it does; the blackbox's flight ring is NOT behind a
+//      rate limiter and keeps every record.
+//   2. SdFlush         — SdSink::flush() defers (counted). Caller-paced IO is the
+//      largest single optional cost in a tick (A4: HA-60), and the bytes stay staged.
+//      close() and the fault dump NEVER defer: the evidence outranks the deadline.
+//   3. VisionPoll      — the caller skips AprilTagCorrector::poll() (or any vision
+//      poll) for the tick. The estimate coasts on odometry + IMU, exactly as it does
+//      between frames anyway; the tree cannot enforce this one structurally because
+//      the poll runs on the caller's cadence, so the caller consults shed().
+//   4. HealthCheck     — DECIMATED, never skipped: HealthMonitor still ticks one tick
+//      in `healthDecimation`, so a pathology is detected at most N-1 ticks late rather
+//      than never. Health is last because it is the one shed class that can delay a
+//      fault.
+// NEVER sheddable, by construction rather than by configuration: localization and
+// control. There is no SheddableWork value for either, so no level can reach them.
+//
+// ── How the level moves ─────────────────────────────────────────────────────────────
+//   * The per-tick cost is smoothed (EWMA, `smoothing` = newest tick's weight) and
+//     compared against `shedAt[i] × budget`; the number of thresholds the smoothed
+//     cost has reached is the TARGET level.
+//   * ESCALATION IS IMMEDIATE: a target above the current level is adopted on the tick
+//     it appears, and a tick whose RAW cost reaches the budget (an overrun, the same
+//     INCLUSIVE boundary as LoopMonitor) jumps straight to full shedding — the smoother
+//     would otherwise take several more late ticks to notice.
+//   * RECOVERY IS SLOW: the level steps DOWN one class only after `recoveryTicks`
+//     consecutive ticks whose target is below it. Hysteresis is the point — a loop
+//     hovering at a threshold must not flap a class on and off every tick.
+//
+// ── Who feeds it, and what "cost" means ─────────────────────────────────────────────
+// MotionScheduler (MotionSchedulerConfig::tickBudget) calls observe() once per tick,
+// right after LoopMonitor: with D-3 attribution on it feeds the last completed tick's
+// measured WORK (lastTotal() — margin visible before any overrun); with attribution
+// off it feeds the measured dt, which only rises once work overflows the period. The
+// scheduler also routes the budget into MotionDeps, which is how tickHealthObservables
+// decimates health for every motion and the idle tick alike. A hand-rolled loop that
+// owns no scheduler calls observe() itself.
+//
+// ── Counted, summarized, on disk ────────────────────────────────────────────────────
+// Principle 5 (silent degradation is a bug) applies to deliberate degradation too:
+// every tick a class spends shed is counted per class, escalations are counted, and
+// the peak level is kept. RunReporter copies them into RunSummary; TermSink shows them
+// only when anything was shed; SdSink writes them as a LoadShed frame beside the
+// summary. The queries are CONST and count nothing — the counting happens once, in
+// observe(), so any number of consumers may ask shed() any number of times (the
+// RateLimitedSink query-must-not-mutate rule).
+//
+// The default thresholds are logic choices relative to the budget (a healthy 10 ms
+// loop against the 15 ms default budget sits at 0.67 and sheds nothing), not hardware
+// claims; what the robot's real tick cost is stays R1's measurement.
+//
+// Single-task by contract, like the rest of diag/. Allocation-free; observe() and every
+// query are noexcept.
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "shulib/core/check.hpp"
+#include "shulib/diag/loop_monitor.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::diag {
+
+/// The optional work a hot tick may shed, IN SHED ORDER (header): a level of N sheds the
+/// first N classes. Control and localization are deliberately absent — nothing can shed
+/// them. Append-only: the values index the per-class counters and the LoadShed frame.
+enum class SheddableWork : std::uint8_t {
+    RecordPopulation = 0,  ///< record building for rate-limited sinks (first to go)
+    SdFlush = 1,           ///< caller-paced SdSink::flush() (deferred, never lost)
+    VisionPoll = 2,        ///< the caller's vision poll (caller-consulted)
+    HealthCheck = 3,       ///< HealthMonitor ticks — DECIMATED, never skipped (last)
+};
+
+/// How many SheddableWork classes exist — the array width of every per-class counter,
+/// and the highest level TickBudget can reach.
+inline constexpr int kSheddableWorkCount = 4;
+
+/// A short fixed token for a SheddableWork class, for log lines and the summary block.
+/// Never returns null.
+[[nodiscard]] constexpr const char* sheddableWorkName(SheddableWork w) noexcept {
+    switch (w) {
+        case SheddableWork::RecordPopulation: return "rec";
+        case SheddableWork::SdFlush: return "sd";
+        case SheddableWork::VisionPoll: return "vis";
+        case SheddableWork::HealthCheck: return "hlt";
+    }
+    return "?";
+}
+
+/// TickBudget's tuning, COPIED at construction. The budget itself is NOT here: it is
+/// LoopMonitorConfig::budget, passed alongside, so the shedder and the overrun detector
+/// can never disagree about what the deadline is.
+struct TickBudgetConfig {
+    /// Per-class shed threshold as a fraction of the budget, indexed by SheddableWork:
+    /// class i is shed once the smoothed cost reaches shedAt[i] × budget. Must be finite,
+    /// in (0, 1], and non-decreasing — the shed ORDER is declared, so the thresholds may
+    /// not reorder it.
+    std::array<double, static_cast<std::size_t>(kSheddableWorkCount)> shedAt{0.75, 0.80, 0.87,
+                                                                               0.93};
+    /// EWMA weight of the newest tick's cost, in (0, 1]. 1 = no smoothing.
+    double smoothing = 0.3;
+    /// Consecutive below-level ticks before the level steps DOWN by one class (header:
+    /// recovery is slow). Must be >= 1.
+    int recoveryTicks = 25;
+    /// While HealthCheck is shed, HealthMonitor still runs one tick in this many. Must
+    /// be >= 2 (1 would shed nothing; "never" is not an option this class offers).
+    int healthDecimation = 4;
+};
+
+/// Deadline-aware load shedding: observe() the tick's cost once per tick, and every
+/// optional-work owner asks shed() before doing its optional work. Escalates immediately
+/// (an overrun sheds everything at once), recovers one class at a time after
+/// `recoveryTicks` calm ticks, decimates health rather than skipping it, and can never
+/// shed control or localization. Every shed tick is counted per class in observe() —
+/// never in a query — so the degradation is reported, not silent. Single-task by
+/// contract; allocation-free.
+class TickBudget {
+public:
+    /// `loop` supplies the deadline (copied — the SAME budget LoopMonitor enforces);
+    /// `config` is copied. Preconditions on both are checked here, once.
+    explicit TickBudget(const LoopMonitorConfig& loop, const TickBudgetConfig& config = {})
+        : budget_{loop.budget}, cfg_{config} {
+        SHULIB_PRECONDITION(std::isfinite(budget_.value()) && budget_.value() > 0.0,
+                            "TickBudget: budget must be finite and > 0");
+        double prev = 0.0;
+        for (const double t : cfg_.shedAt) {
+            SHULIB_PRECONDITION(std::isfinite(t) && t > 0.0 && t <= 1.0,
+                                "TickBudget: shedAt thresholds must be in (0, 1]");
+            SHULIB_PRECONDITION(t >= prev,
+                                "TickBudget: shedAt must be non-decreasing (the shed order "
+                                "is declared)");
+            prev = t;
+        }
+        SHULIB_PRECONDITION(std::isfinite(cfg_.smoothing) && cfg_.smoothing > 0.0
+                                && cfg_.smoothing <= 1.0,
+                            "TickBudget: smoothing must be in (0, 1]");
+        SHULIB_PRECONDITION(cfg_.recoveryTicks >= 1, "TickBudget: recoveryTicks must be >= 1");
+        SHULIB_PRECONDITION(cfg_.healthDecimation >= 2,
+                            "TickBudget: healthDecimation must be >= 2");
+    }
+
+    /// Feed one tick's cost and decide what THIS tick sheds (header: how the level
+    /// moves). Call exactly once per tick, before the optional work runs. A non-finite
+    /// or negative cost (a contract-breaking clock) is read as 0 — it can relax the
+    /// level, never spike it.
+    void observe(units::Time cost) noexcept {
+        const double c = std::isfinite(cost.value()) && cost.value() > 0.0 ? cost.value() : 0.0;
+        smoothed_ = hasSmoothed_ ? smoothed_ + cfg_.smoothing * (c - smoothed_) : c;
+        hasSmoothed_ = true;
+        ++ticks_;
+
+        int target = 0;
+        if (c >= budget_.value()) {
+            target = kSheddableWorkCount;  // an overrun sheds everything, now
+        } else {
+            const double ratio = smoothed_ / budget_.value();
+            while (target < kSheddableWorkCount
+                   && ratio >= cfg_.shedAt[static_cast<std::size_t>(target)]) {
+                ++target;
+            }
+        }
+        if (target > level_) {
+            level_ = target;
+            calmTicks_ = 0;
+            ++escalations_;
+        } else if (target < level_) {
+            if (++calmTicks_ >= cfg_.recoveryTicks) {
+                --level_;
+                calmTicks_ = 0;
+            }
+        } else {
+            calmTicks_ = 0;
+        }
+        if (level_ > maxLevel_) {
+            maxLevel_ = level_;
+        }
+
+        mask_ = 0U;
+        for (int i = 0; i < level_; ++i) {
+            mask_ |= 1U << static_cast<unsigned>(i);
+        }
+        constexpr auto kHealthBit = 1U << static_cast<unsigned>(SheddableWork::HealthCheck);
+        if ((mask_ & kHealthBit) != 0U) {
+            // Decimated, never skipped: the first shed tick is a skip, and one in N runs.
+            healthPhase_ = (healthPhase_ + 1) % cfg_.healthDecimation;
+            if (healthPhase_ == 0) {
+                mask_ &= ~kHealthBit;
+            }
+        } else {
+            healthPhase_ = 0;
+        }
+        for (std::size_t i = 0; i < shedTicks_.size(); ++i) {
+            if ((mask_ & (1U << i)) != 0U) {
+                ++shedTicks_[i];
+            }
+        }
+    }
+
+    /// Whether `work` is shed on THIS tick. Const and uncounted — ask as often as needed.
+    /// False for everything until the first observe().
+    [[nodiscard]] bool shed(SheddableWork work) const noexcept {
+        return (mask_ & (1U << static_cast<unsigned>(work))) != 0U;
+    }
+
+    /// The current shed level: how many classes (in shed order) are under pressure, 0..
+    /// kSheddableWorkCount. HealthCheck at the top level is decimated, so shed() is the
+    /// per-tick truth and this is the posture.
+    [[nodiscard]] int level() const noexcept { return level_; }
+    /// The highest level reached over the run.
+    [[nodiscard]] int maxLevel() const noexcept { return maxLevel_; }
+    /// Upward level transitions over the run — how many times pressure got WORSE. A jump
+    /// of several classes at once (an overrun) counts once.
+    [[nodiscard]] std::uint32_t escalations() const noexcept { return escalations_; }
+    /// Ticks on which `work` was shed. For HealthCheck these are the SKIPPED ticks only;
+    /// the decimated ticks that still ran are not counted.
+    [[nodiscard]] std::uint32_t shedTicks(SheddableWork work) const noexcept {
+        return shedTicks_[static_cast<std::size_t>(work)];
+    }
+    /// observe() calls over the run — the denominator for every shedTicks() figure.
+    [[nodiscard]] std::uint32_t ticksObserved() const noexcept { return ticks_; }
+    /// True once any class has been shed on any tick — the "is there a story" test the
+    /// summary renderers use.
+    [[nodiscard]] bool everShed() const noexcept { return maxLevel_ > 0; }
+    /// The smoothed per-tick cost the level is judged on. 0 before the first observe().
+    [[nodiscard]] units::Time smoothedCost() const noexcept { return units::Time{smoothed_}; }
+    /// The deadline, copied from the LoopMonitorConfig at construction.
+    [[nodiscard]] units::Time budget() const noexcept { return budget_; }
+
+private:
+    units::Time budget_;
+    TickBudgetConfig cfg_;
+    double smoothed_ = 0.0;
+    bool hasSmoothed_ = false;
+    int level_ = 0;
+    int maxLevel_ = 0;
+    int calmTicks_ = 0;
+    int healthPhase_ = 0;
+    unsigned mask_ = 0U;
+    std::uint32_t ticks_ = 0;
+    std::uint32_t escalations_ = 0;
+    std::array<std::uint32_t, static_cast<std::size_t>(kSheddableWorkCount)> shedTicks_{};
+};
+
+}  // namespace shulib::diag
@@ -0,0 +1,194 @@
+#pragma once
+//
+// TickHistogram — the DISTRIBUTION of a tick timing, not just its worst case (WS13
+// follow-up to A1/C5).
+//
+// Why this exists: LoopMonitor kept worstDt() and an overrun count, and those two
+// numbers cannot tell a loop that is SOMETIMES 14.9 ms from one that ALWAYS is — both
+// read "worst 14.9, overruns 0". Setting LoopMonitorConfig::budget from evidence needs
+// the shape: where the bulk sits (p50), where the tail starts (p95/p99), and the one
+// worst tick (max). This is that, at a fixed cost per sample and with nothing allocated.
+//
+// ── The bins ────────────────────────────────────────────────────────────────────────
+// kTickHistogramBins LOG-SPACED bins across [lo, hi), plus an underflow bin (< lo) and
+// an overflow bin (>= hi). Log spacing because a timing question is RELATIVE — 0.5 ms
+// matters at 10 ms and does not at 40 — so every bin is the same ~6% wide in ratio
+// over the default dt range. Two default ranges, one per use:
+//   * loop dt            5 ms .. 50 ms   (a 10 ms loop, with room for a 3× stall)
+//   * per-phase cost   0.1 ms .. 50 ms   (phases are a fraction of a tick; wider ratio,
+//                                         so ~17% bins — coarser, and said so here)
+// A sample landing exactly on an edge belongs to the bin ABOVE it (half-open bins).
+//
+// ── What a percentile here MEANS (pinned by test) ───────────────────────────────────
+// Nearest-rank over the bins: the q-quantile is the sample of rank ceil(q·count), and
+// what is reported is the UPPER EDGE of the bin that holds it, clamped to the exact
+// observed max. So a reported percentile is never BELOW the true one and is at most
+// one bin width above it — the conservative direction for a budget, which is the
+// number this exists to set. A percentile that lands in the overflow bin reports the
+// exact max (the only honest number there is); one in the underflow bin reports lo
+// (or the max, when every sample sat below lo). max() itself is exact, not binned.
+//
+// ── What it costs ───────────────────────────────────────────────────────────────────
+// One std::log per in-range sample; an underflow sample (a zero phase, say) costs a
+// compare. No allocation, no clock, no fault — a histogram OBSERVES, it never raises.
+// A non-finite or negative sample is not binned: it is counted in rejected() and
+// otherwise ignored, so one bad clock read cannot poison a whole run's tail.
+//
+// Single-task by contract, like the rest of diag/.
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "shulib/core/check.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::diag {
+
+/// Log-spaced bins between the range ends (underflow and overflow bins are extra).
+inline constexpr int kTickHistogramBins = 40;
+
+/// The [lo, hi) span the log-spaced bins cover. Both ends must be finite, lo > 0 and
+/// hi > lo (TickHistogram precondition). The default is the loop-dt range.
+struct TickHistogramRange {
+    units::Time lo{0.005};  ///< lower edge of the first bin; anything below is underflow
+    units::Time hi{0.050};  ///< upper edge of the last bin; anything at or above is overflow
+};
+
+/// The default range for per-phase costs (TickAttribution) — header note for why it is
+/// wider, and therefore coarser, than the dt range.
+inline constexpr TickHistogramRange kPhaseHistogramRange{units::Time{0.0001}, units::Time{0.050}};
+
+/// A histogram's end-of-run digest: the numbers a RunSummary carries and a blackbox frame
+/// persists. count == 0 means "no samples", and every other field is then 0 — renderers
+/// show nothing rather than a fabricated 0 ms (the RunSummary honesty rule).
+struct TickTimingStats {
+    std::uint32_t count = 0;  ///< samples binned (rejected samples excluded)
+    units::Time p50{};        ///< median, as an upper bound within one bin (header note)
+    units::Time p95{};        ///< 95th percentile, same rule
+    units::Time p99{};        ///< 99th percentile, same rule
+    units::Time max{};        ///< the exact largest sample
+};
+
+/// A fixed-bin, allocation-free histogram of one tick timing (header note for the bins and
+/// for what its percentiles promise). Copyable value type; single-task by contract.
+class TickHistogram {
+public:
+    /// Bins in counts(): underflow at index 0, the kTickHistogramBins log bins, overflow last.
+    static constexpr std::size_t kSlots = static_cast<std::size_t>(kTickHistogramBins) + 2U;
+
+    /// `range` is copied. Precondition: both ends finite, lo > 0, hi > lo.
+    explicit TickHistogram(const TickHistogramRange& range = {}) : range_{range} {
+        SHULIB_PRECONDITION(std::isfinite(range.lo.value()) && std::isfinite(range.hi.value()),
+                            "TickHistogram: range ends must be finite");
+        SHULIB_PRECONDITION(range.lo.value() > 0.0, "TickHistogram: lo must be > 0");
+        SHULIB_PRECONDITION(range.hi.value() > range.lo.value(), "TickHistogram: hi must be > lo");
+        binsPerLog_ = static_cast<double>(kTickHistogramBins)
+                      / std::log(range.hi.value() / range.lo.value());
+    }
+
+    /// Bin one sample. Non-finite or negative samples are counted in rejected() and not
+    /// binned. Never allocates, never throws.
+    void record(units::Time sample) noexcept {
+        const double x = sample.value();
+        if (!std::isfinite(x) || x < 0.0) {
+            ++rejected_;
+            return;
+        }
+        ++counts_[slotOf(x)];
+        ++count_;
+        if (x > max_) {
+            max_ = x;
+        }
+    }
+
+    /// Samples binned so far (rejected samples excluded).
+    [[nodiscard]] std::uint32_t count() const noexcept { return count_; }
+    /// Samples refused as non-finite or negative.
+    [[nodiscard]] std::uint32_t rejected() const noexcept { return rejected_; }
+    /// The exact largest binned sample; 0 with no samples.
+    [[nodiscard]] units::Time max() const noexcept { return units::Time{max_}; }
+    /// The range this histogram was built with.
+    [[nodiscard]] const TickHistogramRange& range() const noexcept { return range_; }
+    /// Raw per-slot counts: [0] underflow, [1..kTickHistogramBins] the log bins, [last] overflow.
+    [[nodiscard]] const std::array<std::uint32_t, kSlots>& counts() const noexcept { return counts_; }
+
+    /// Upper edge of slot `i` (kSlots − 1 is the overflow slot, whose edge is +inf).
+    /// Precondition: i < kSlots.
+    [[nodiscard]] units::Time slotUpperEdge(std::size_t i) const {
+        SHULIB_PRECONDITION(i < kSlots, "TickHistogram::slotUpperEdge: slot out of range");
+        if (i + 1U == kSlots) {
+            return units::Time{HUGE_VAL};
+        }
+        return units::Time{range_.lo.value() * std::exp(static_cast<double>(i) / binsPerLog_)};
+    }
+
+    /// The q-quantile under the header's nearest-rank, upper-edge, clamped-to-max rule;
+    /// 0 with no samples. Precondition: 0 < q <= 1.
+    [[nodiscard]] units::Time percentile(double q) const {
+        SHULIB_PRECONDITION(q > 0.0 && q <= 1.0, "TickHistogram::percentile: q must be in (0, 1]");
+        if (count_ == 0U) {
+            return units::Time{0.0};
+        }
+        const double exact = std::ceil(q * static_cast<double>(count_));
+        const std::uint32_t rank = exact < 1.0 ? 1U : static_cast<std::uint32_t>(exact);
+        std::uint32_t seen = 0;
+        for (std::size_t i = 0; i < kSlots; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                const double edge = slotUpperEdge(i).value();
+                return units::Time{edge < max_ ? edge : max_};
+            }
+        }
+        return units::Time{max_};  // unreachable: the slots sum to count_
+    }
+
+    /// The end-of-run digest (p50/p95/p99/max). All zeros with no samples.
+    [[nodiscard]] TickTimingStats stats() const {
+        TickTimingStats s;
+        s.count = count_;
+        if (count_ != 0U) {
+            s.p50 = percentile(0.50);
+            s.p95 = percentile(0.95);
+            s.p99 = percentile(0.99);
+            s.max = max();
+        }
+        return s;
+    }
+
+    /// Forget every sample; the range is kept.
+    void reset() noexcept {
+        counts_.fill(0U);
+        count_ = 0;
+        rejected_ = 0;
+        max_ = 0.0;
+    }
+
+private:
+    [[nodiscard]] std::size_t slotOf(double x) const noexcept {
+        if (x < range_.lo.value()) {
+            return 0U;  // underflow: a compare, no log (a zero phase lands here every tick)
+        }
+        if (x >= range_.hi.value()) {
+            return kSlots - 1U;
+        }
+        const double bin = std::floor(std::log(x / range_.lo.value()) * binsPerLog_);
+        if (bin < 0.0) {
+            return 1U;  // rounding just above lo
+        }
+        if (bin >= static_cast<double>(kTickHistogramBins)) {
+            return static_cast<std::size_t>(kTickHistogramBins);  // rounding just below hi
+        }
+        return static_cast<std::size_t>(bin) + 1U;
+    }
+
+    TickHistogramRange range_;
+    double binsPerLog_ = 1.0;
+    std::array<std::uint32_t, kSlots> counts_{};
+    std::uint32_t count_ = 0;
+    std::uint32_t rejected_ = 0;
+    double max_ = 0.0;
+};
+
+}  // namespace shulib::diag
@@ -0,0 +1,385 @@
+#pragma once
+//
+// ZoneProfiler — where the time went INSIDE a phase: nested, named, compile-time zones.
+//
+// TickAttribution (D-3) answers "localization took 4 ms of this tick". It cannot answer the
+// question that raises next — was it odometry, the GPS corrector's gate, or the fusion step? —
+// because a phase is one flat slot. This instrument is the level below it: RAII zones that
+// nest, each accumulating over the whole run
+//   * calls, total time, SELF time (total minus the time of the zones nested inside it),
+//   * the longest single call, and
+//   * a small log2 histogram (kZoneHistogramSlots slots, 1 µs to 16 ms) for p50/p99.
+//
+//     SHULIB_ZONE(profiler_, "fuse");          // times the rest of the enclosing block
+//
+// A zone is identified by its NAME, hashed at compile time (zoneId, FNV-1a) — the macro
+// forces the hash into a constant, so a zone name must be a literal and costs nothing to
+// look up by. Zones are kept as a CALL TREE, not a flat list: "fuse" under "loc" and "fuse"
+// under some user zone are different rows, which is what makes self time meaningful. The
+// tree lives in a fixed table (kMaxZones nodes, kMaxZoneDepth levels); a zone that would
+// not fit is REFUSED and counted (refusedScopes()), never silently merged into its parent —
+// and everything nested under a refused zone is refused with it, so no time is charged to
+// the wrong row.
+//
+// ── Compiled out unless enabled — the SHULIB_TRACE mechanism ─────────────────────────
+// Dev builds pass -DSHULIB_ENABLE_ZONES; the DEFAULT (no define) is the stripped build, in
+// which SHULIB_ZONE expands to a static_assert alone: no object, no clock read, no branch —
+// but the profiler expression and the name are still TYPE-CHECKED (and the name still
+// validated), so a zone cannot bit-rot into an error that surfaces the day someone turns
+// profiling on (trace.hpp's reasoning, verbatim in intent). Enabled, a zone whose profiler
+// pointer is null is one compare on entry and one on exit: the library's own zones
+// (Localizer, MotionScheduler) are always compiled in a dev build and profile nothing until
+// a profiler is attached.
+//
+// Per-TU, like the trace flag — with one difference that matters: library headers USE this
+// macro, inside inline functions, so a program must set the flag the same way in EVERY
+// translation unit (the build system's job, never a per-file #define), or two definitions of
+// Localizer::update() disagree and the linker keeps one at random. The host suite sets it for
+// the whole binary; test/zone_profiler_strip_test.cpp #undefs it and includes nothing but
+// this header, which is the one arrangement that stays ODR-clean.
+//
+// ── Which clock ──────────────────────────────────────────────────────────────────────
+// The same rule as TickAttribution: one that advances DURING a tick (real time on the robot;
+// a scripted fake in tests). The sim clock only moves between ticks and would time every
+// zone at 0 — true, and useless.
+//
+// Honest scope: each zone costs two virtual clock reads and a ≤kMaxZones-entry search on
+// entry. That is microseconds on the V5 — fine around work measured in tenths of a
+// millisecond, and not something to wrap around a single multiply. SHULIB_ZONE_DYNAMIC
+// exists for names only known at run time (a corrector's name()); it hashes on every entry.
+// Single-task by contract; allocates nothing.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "shulib/core/check.hpp"
+#include "shulib/hal/clock.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::diag {
+
+/// Call-tree nodes one profiler can hold. A zone reached by a new path once the table is
+/// full is refused and counted (header note).
+inline constexpr std::size_t kMaxZones = 24;
+
+/// Deepest nesting one profiler tracks; a zone opened deeper than this is refused.
+inline constexpr std::size_t kMaxZoneDepth = 8;
+
+/// Longest zone name, in bytes. The macros reject longer literals at compile time, and
+/// ZoneTimingRow stores names at exactly this bound.
+inline constexpr std::size_t kMaxZoneNameBytes = 15;
+
+/// Slots in a zone's histogram: [0] under 1 µs, [k] for k = 1..14 the interval
+/// [2^(k−1), 2^k) µs, [15] 16.384 ms and above.
+inline constexpr std::size_t kZoneHistogramSlots = 16;
+
+/// A zone name's id: 32-bit FNV-1a of its bytes. constexpr, so SHULIB_ZONE hashes at compile
+/// time; two names that collide share a row (the birthday odds over a few dozen names are
+/// about one in ten million).
+[[nodiscard]] constexpr std::uint32_t zoneId(std::string_view name) noexcept {
+    std::uint32_t h = 2166136261U;
+    for (const char c : name) {
+        h ^= static_cast<std::uint8_t>(c);
+        h *= 16777619U;
+    }
+    return h;
+}
+
+/// True for a usable zone name: 1..kMaxZoneNameBytes bytes.
+[[nodiscard]] constexpr bool isZoneName(std::string_view name) noexcept {
+    return !name.empty() && name.size() <= kMaxZoneNameBytes;
+}
+
+/// One zone's run-end digest, as a VALUE (it owns its name — the RunSummary rule), in the
+/// order ZoneProfiler::snapshot() writes them: depth-first, each zone before its children.
+struct ZoneTimingRow {
+    char name[kMaxZoneNameBytes + 1] = "";  ///< the zone name, NUL-terminated
+    std::uint8_t depth = 0;                 ///< 0 for a root zone, parent depth + 1 below it
+    std::uint32_t calls = 0;                ///< completed entries
+    units::Time total{};                    ///< summed duration of every call
+    units::Time self{};                     ///< total minus the time spent in child zones
+    units::Time p50{};                      ///< median call, as a histogram slot upper edge
+    units::Time p99{};                      ///< 99th-percentile call, same rule
+    units::Time max{};                      ///< the exact longest call
+
+    /// The stored name.
+    [[nodiscard]] std::string_view nameView() const noexcept { return name; }
+};
+
+/// Nested, named, run-long zone timing on an injected clock (header). Open zones with
+/// SHULIB_ZONE, read them with snapshot(). Single-task by contract; allocates nothing.
+class ZoneProfiler {
+public:
+    /// One node of the call tree: a zone as reached through one particular parent.
+    struct Zone {
+        std::uint32_t id = 0;          ///< zoneId(name)
+        const char* name = "";         ///< the name the zone was first opened with (not owned)
+        std::uint8_t parent = kNoZone;  ///< index of the enclosing zone, kNoZone at the root
+        std::uint8_t depth = 0;        ///< nesting depth, 0 at the root
+        std::uint32_t calls = 0;       ///< completed entries
+        double total = 0.0;            ///< summed call duration, s
+        double inChildren = 0.0;       ///< summed duration of the zones nested inside, s
+        double max = 0.0;              ///< longest single call, s
+        /// Calls per histogram slot (kZoneHistogramSlots layout).
+        std::array<std::uint32_t, kZoneHistogramSlots> hist{};
+    };
+
+    /// The parent index of a root zone.
+    static constexpr std::uint8_t kNoZone = 0xFF;
+
+    /// `clock` must outlive the profiler (header note for which clock).
+    explicit ZoneProfiler(hal::IClock& clock) noexcept : clock_{clock} {}
+
+    /// Non-copyable: live scopes point at this object.
+    ZoneProfiler(const ZoneProfiler&) = delete;
+    ZoneProfiler& operator=(const ZoneProfiler&) = delete;
+
+    /// The RAII zone the macros declare: enters on construction, charges its lifetime on
+    /// destruction. Inert when constructed with a null profiler.
+    class Scope {
+    public:
+        /// Enter zone `id` (named `name`, which must outlive the profiler) under whatever
+        /// zone is open. A null `profiler` makes the scope inert.
+        Scope(ZoneProfiler* profiler, std::uint32_t id, const char* name) noexcept
+            : p_{profiler != nullptr && profiler->enter(id, name) ? profiler : nullptr} {}
+
+        /// Charge this call to its zone (nothing if inert or refused).
+        ~Scope() {
+            if (p_ != nullptr) {
+                p_->exit();
+            }
+        }
+
+        /// Non-copyable and non-movable: a scope charges exactly one interval.
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ZoneProfiler* p_;
+    };
+
+    /// Call-tree nodes registered so far, in first-entry order.
+    [[nodiscard]] std::size_t zoneCount() const noexcept { return count_; }
+
+    /// Node `i` in first-entry order. Precondition: i < zoneCount().
+    [[nodiscard]] const Zone& zone(std::size_t i) const {
+        SHULIB_PRECONDITION(i < count_, "ZoneProfiler::zone: index out of range");
+        return zones_[i];
+    }
+
+    /// The node reached by the zone-name path `path` from the root ({"loc", "fuse"}), or
+    /// nullptr if no such zone has been entered.
+    [[nodiscard]] const Zone* find(std::span<const std::string_view> path) const noexcept {
+        std::uint8_t parent = kNoZone;
+        const Zone* found = nullptr;
+        for (const std::string_view step : path) {
+            const std::size_t i = lookup(parent, zoneId(step));
+            if (i == count_) {
+                return nullptr;
+            }
+            found = &zones_[i];
+            parent = static_cast<std::uint8_t>(i);
+        }
+        return found;
+    }
+
+    /// Scopes refused since construction or reset(): opened deeper than kMaxZoneDepth,
+    /// reached by a new path with the table full, or nested inside a refused scope.
+    [[nodiscard]] std::uint32_t refusedScopes() const noexcept { return refused_; }
+
+    /// Zones open right now (refused ones excluded).
+    [[nodiscard]] std::size_t openDepth() const noexcept { return depth_; }
+
+    /// Write one row per zone into `out`, depth-first with each zone before its children and
+    /// siblings in first-entry order; returns the rows written (at most out.size()). Rows are
+    /// value copies: `out` stays valid after the profiler is gone.
+    std::size_t snapshot(std::span<ZoneTimingRow> out) const noexcept {
+        std::size_t n = 0;
+        appendChildren(kNoZone, out, n);
+        return n;
+    }
+
+    /// Forget every zone and count. Precondition: no zone is open (a live scope would close
+    /// into a table that no longer has its row).
+    void reset() {
+        SHULIB_PRECONDITION(depth_ == 0, "ZoneProfiler::reset: a zone is still open");
+        zones_ = {};
+        count_ = 0;
+        refused_ = 0;
+    }
+
+private:
+    /// One open zone on the stack.
+    struct Frame {
+        std::uint8_t node = kNoZone;  // kNoZone: a refused zone holding its children refused
+        double start = 0.0;
+        double inChildren = 0.0;
+    };
+
+    [[nodiscard]] std::size_t lookup(std::uint8_t parent, std::uint32_t id) const noexcept {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (zones_[i].parent == parent && zones_[i].id == id) {
+                return i;
+            }
+        }
+        return count_;
+    }
+
+    bool enter(std::uint32_t id, const char* name) noexcept {
+        if (depth_ == kMaxZoneDepth) {
+            ++refused_;
+            return false;
+        }
+        std::uint8_t node = kNoZone;
+        const std::uint8_t parent = depth_ == 0 ? kNoZone : stack_[depth_ - 1].node;
+        if (depth_ == 0 || parent != kNoZone) {
+            std::size_t i = lookup(parent, id);
+            if (i == count_ && count_ < kMaxZones) {
+                Zone& z = zones_[count_++];
+                z.id = id;
+                z.name = name;
+                z.parent = parent;
+                z.depth = static_cast<std::uint8_t>(depth_);
+            }
+            if (i < count_) {
+                node = static_cast<std::uint8_t>(i);
+            }
+        }
+        if (node == kNoZone) {
+            ++refused_;  // table full, or nested in a refused zone: pushed, never charged
+        }
+        stack_[depth_++] = Frame{node, clock_.now().value(), 0.0};
+        return true;
+    }
+
+    void exit() noexcept {
+        const Frame f = stack_[--depth_];
+        double dt = clock_.now().value() - f.start;
+        dt = dt > 0.0 ? dt : 0.0;  // a clock that stepped back charges 0, not a negative
+        if (depth_ > 0) {
+            stack_[depth_ - 1].inChildren += dt;
+        }
+        if (f.node == kNoZone) {
+            return;
+        }
+        Zone& z = zones_[f.node];
+        ++z.calls;
+        z.total += dt;
+        z.inChildren += f.inChildren;
+        z.max = dt > z.max ? dt : z.max;
+        ++z.hist[slotOf(dt)];
+    }
+
+    [[nodiscard]] static std::size_t slotOf(double seconds) noexcept {
+        double edge = 1e-6;
+        std::size_t slot = 0;
+        while (slot + 1 < kZoneHistogramSlots && seconds >= edge) {
+            edge *= 2.0;
+            ++slot;
+        }
+        return slot;
+    }
+
+    /// The upper edge of histogram slot `slot` below the last, s. The last slot has none;
+    /// quantile() reports the zone's max for it.
+    [[nodiscard]] static double slotEdge(std::size_t slot) noexcept {
+        double edge = 1e-6;
+        for (std::size_t i = 0; i < slot; ++i) {
+            edge *= 2.0;
+        }
+        return edge;
+    }
+
+    /// The q-quantile of `z`'s calls: nearest rank, slot upper edge, clamped to max — the
+    /// TickHistogram rule. 0 with no calls.
+    [[nodiscard]] static double quantile(const Zone& z, double q) noexcept {
+        if (z.calls == 0) {
+            return 0.0;
+        }
+        const double rankD = q * static_cast<double>(z.calls);
+        auto rank = static_cast<std::uint32_t>(rankD);
+        rank += static_cast<double>(rank) < rankD ? 1U : 0U;
+        rank = rank == 0 ? 1U : rank;
+        std::uint32_t seen = 0;
+        for (std::size_t s = 0; s < kZoneHistogramSlots; ++s) {
+            seen += z.hist[s];
+            if (seen >= rank) {
+                if (s + 1 == kZoneHistogramSlots) {
+                    return z.max;
+                }
+                const double edge = slotEdge(s);
+                return edge < z.max ? edge : z.max;
+            }
+        }
+        return z.max;
+    }
+
+    void appendChildren(std::uint8_t parent, std::span<ZoneTimingRow> out,
+                        std::size_t& n) const noexcept {
+        for (std::size_t i = 0; i < count_ && n < out.size(); ++i) {
+            const Zone& z = zones_[i];
+            if (z.parent != parent) {
+                continue;
+            }
+            ZoneTimingRow& row = out[n++];
+            row = ZoneTimingRow{};
+            const std::string_view name{z.name};
+            const std::size_t take = name.size() < kMaxZoneNameBytes ? name.size()
+                                                                     : kMaxZoneNameBytes;
+            for (std::size_t k = 0; k < take; ++k) {
+                row.name[k] = name[k];
+            }
+            row.depth = z.depth;
+            row.calls = z.calls;
+            row.total = units::Time{z.total};
+            const double self = z.total - z.inChildren;
+            row.self = units::Time{self > 0.0 ? self : 0.0};
+            row.p50 = units::Time{quantile(z, 0.50)};
+            row.p99 = units::Time{quantile(z, 0.99)};
+            row.max = units::Time{z.max};
+            appendChildren(static_cast<std::uint8_t>(i), out, n);
+        }
+    }
+
+    hal::IClock& clock_;
+    std::array<Zone, kMaxZones> zones_{};
+    std::array<Frame, kMaxZoneDepth> stack_{};
+    std::size_t count_ = 0;
+    std::size_t depth_ = 0;
+    std::uint32_t refused_ = 0;
+};
+
+namespace detail {
+/// Never defined: the stripped SHULIB_ZONE names it inside sizeof, which type-checks the
+/// profiler argument without evaluating it.
+char zoneArgs(const ZoneProfiler* profiler, const char* name) noexcept;
+}  // namespace detail
+
+}  // namespace shulib::diag
+
+#define SHULIB_ZONE_CAT2(a, b) a##b
+#define SHULIB_ZONE_CAT(a, b) SHULIB_ZONE_CAT2(a, b)
+
+#if defined(SHULIB_ENABLE_ZONES)
+#define SHULIB_ZONE(profiler, name)                                                           \
+    static_assert(::shulib::diag::isZoneName(name), "SHULIB_ZONE: name must be 1..15 bytes"); \
+    const ::shulib::diag::ZoneProfiler::Scope SHULIB_ZONE_CAT(shulibZone_, __LINE__) {        \
+        (profiler), std::integral_constant<std::uint32_t, ::shulib::diag::zoneId(name)>::value, \
+            (name)                                                                            \
+    }
+#define SHULIB_ZONE_DYNAMIC(profiler, name)                                              \
+    const ::shulib::diag::ZoneProfiler::Scope SHULIB_ZONE_CAT(shulibZone_, __LINE__) {   \
+        (profiler), ::shulib::diag::zoneId(name), (name)                                 \
+    }
+#else
+#define SHULIB_ZONE(profiler, name)                                                          \
+    static_assert(sizeof(::shulib::diag::detail::zoneArgs((profiler), (name))) == 1          \
+                      && ::shulib::diag::isZoneName(name),                                   \
+                  "SHULIB_ZONE: name must be 1..15 bytes")
+#define SHULIB_ZONE_DYNAMIC(profiler, name) \
+    static_assert(sizeof(::shulib::diag::detail::zoneArgs((profiler), (name))) == 1, "")
+#endif
@@ -8,12 +8,18 @@
 // the first n bytes of the run and then report failure, keeping the prefix — exactly
 // what a full/yanked/dying SD card leaves behind. That is how the truncated-file case
 // gets tested, and the truncated case is the one that will actually occur in the field.
+//
+// It can also model a SLOW device: setWriteCost(clock, perCall, perByte) advances a
+// FakeClock by a fixed per-call latency plus a per-byte cost on every write(), so a test
+// can read what a write would have cost a tick straight off the clock.
 
 #include <cstddef>
 #include <span>
 #include <vector>
 
 #include "shulib/hal/block_sink.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/units/quantity.hpp"
 
 namespace shulib::hal::fake {
 
@@ -24,9 +30,14 @@ public:
     /// KEPT, which is what a dying device leaves on the card.
     [[nodiscard]] bool write(std::span<const std::byte> bytes) noexcept override {
         ++writeCalls_;
+        if (costClock_ != nullptr) {
+            costClock_->advance(units::Time{perCall_.value()
+                                            + perByte_.value() * static_cast<double>(bytes.size())});
+        }
         const std::size_t room = capacity_ - (bytes_.size() < capacity_ ? bytes_.size() : capacity_);
         const std::size_t take = bytes.size() < room ? bytes.size() : room;
         try {
+            writeSizes_.push_back(bytes.size());
             bytes_.insert(bytes_.end(), bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(take));
         } catch (...) {
             return false;  // the seam is noexcept; an allocation failure is a device failure
@@ -48,6 +59,14 @@ public:
     /// write that crosses the cap keeps its prefix and returns false.
     void setCapacity(std::size_t bytes) noexcept { capacity_ = bytes; }
 
+    /// Make every write() cost time on `clock`: `perCall` plus `perByte` per byte
+    /// offered (header note). NON-OWNING — the clock must outlive the sink.
+    void setWriteCost(FakeClock& clock, units::Time perCall, units::Time perByte) noexcept {
+        costClock_ = &clock;
+        perCall_ = perCall;
+        perByte_ = perByte;
+    }
+
     /// Make flush() report failure (a device that accepted bytes but lost them).
     void setFlushSucceeds(bool ok) noexcept { flushSucceeds_ = ok; }
 
@@ -65,10 +84,16 @@ public:
     [[nodiscard]] int shortWrites() const noexcept { return shortWrites_; }
     /// How many flush() calls the sink made.
     [[nodiscard]] int flushCalls() const noexcept { return flushCalls_; }
+    /// The size of every write() offered, in call order — the write-shape claims
+    /// (sector alignment, slice bounds).
+    [[nodiscard]] const std::vector<std::size_t>& writeSizes() const noexcept {
+        return writeSizes_;
+    }
 
-    /// Forget everything (bytes and counters); the capacity setting is kept.
+    /// Forget everything (bytes and counters); the capacity and cost settings are kept.
     void clear() noexcept {
         bytes_.clear();
+        writeSizes_.clear();
         writeCalls_ = 0;
         shortWrites_ = 0;
         flushCalls_ = 0;
@@ -76,6 +101,10 @@ public:
 
 private:
     std::vector<std::byte> bytes_;
+    std::vector<std::size_t> writeSizes_;
+    FakeClock* costClock_ = nullptr;
+    units::Time perCall_{0.0};
+    units::Time perByte_{0.0};
     std::size_t capacity_ = static_cast<std::size_t>(-1);
     int writeCalls_ = 0;
     int shortWrites_ = 0;
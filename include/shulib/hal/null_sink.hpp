@@ -31,6 +31,9 @@ public:
     /// Discards the message. The parameters are unnamed on purpose — nothing is read, so
     /// nothing is formatted or copied, and the body inlines to nothing.
     void log(LogLevel /*level*/, std::string_view /*subsystem*/, std::string_view /*message*/) override {}
+    /// Discards the deferred line without rendering it — the seam's default would format it
+    /// only to have log() throw the text away.
+    void logDeferred(const diag::DeferredLog& /*line*/) override {}
 };
 
 }  // namespace shulib::hal
@@ -0,0 +1,90 @@
+#pragma once
+//
+// ProsPllTickPacer — motion::ITickPacer with microsecond precision: a phase-locked pacer
+// over pros::micros() + pros::Task::delay_until.
+//
+// ProsTickPacer (tick_pacer.hpp) stays the default and is right for most robots. Its
+// cadence is anchored (HA-102), but each wake is only as precise as the millisecond
+// scheduler tick it lands on, so the dt the loop sees can jitter by up to a millisecond.
+// That is 10% of the 10 ms control tick. This pacer closes the gap. The arithmetic lives in
+// hal/tick_pll.hpp (pure, host-pinned), and this file only binds it:
+//
+//   1. plan(micros())    → the millisecond boundary to wake at, chosen early by the PLL's
+//                          learned wake latency (or "release now" on a late tick)
+//   2. delay_until       → the coarse sleep, to that boundary (skipped if it is not ahead)
+//   3. onWake(micros())  → teaches the PLL how late the RTOS woke us; returns the spin target
+//   4. spin on micros()  → the bounded fine trim to the exact target
+//   5. release(micros()) → the period statistics, and the grid advances one period
+//
+// BINDS: pros::micros() for every measurement (HA-101, settled), pros::millis() + Task::
+// delay_until for the coarse sleep (HA-102). The wake boundary is computed in the micros()
+// domain and slept on in the millis() domain, so the pacer believes both count from the
+// same epoch (HA-124, PROVISIONAL). If they are offset, the PLL's lead absorbs a constant
+// offset of less than 1 ms, and a larger one shows up as a persistent late-tick count.
+//
+// THE COST, said plainly: the trim is a BUSY-WAIT. By default it spins up to 1.2 ms per
+// tick (TickPllConfig::maxTrimUs), which is CPU no equal-or-lower-priority task gets during
+// that window. TickPllConfig::maxTrimUs = 0 removes the spin and keeps a phase-locked
+// millisecond pacer with measured jitter. The spin is also bounded by a POLL COUNT, so a
+// micros() that stopped advancing can cost at most kMaxTrimPolls reads. It can never hang
+// the robot.
+//
+// HA register: HA-101, HA-102, HA-124.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#include "pros/rtos.hpp"
+#pragma GCC diagnostic pop
+
+#include <cstdint>
+
+#include "shulib/hal/tick_pll.hpp"
+#include "shulib/motion/motion_scheduler.hpp"
+
+namespace shulib::hal::pros {
+
+/// ITickPacer on the robot with microsecond precision: sleeps to a millisecond boundary chosen
+/// early by a PLL, then spins the sub-millisecond remainder on pros::micros() — bounded by
+/// TickPllConfig::maxTrimUs — so the release lands on an absolute 100 Hz grid. Reports the
+/// measured period statistics through pll(). Anchors lazily on the first pace(), like
+/// ProsTickPacer, and re-anchors after a tick body overruns a whole period.
+class ProsPllTickPacer final : public motion::ITickPacer {
+public:
+    /// Spin-loop poll cap: the backstop that makes a frozen micros() cost a bounded number of
+    /// reads instead of a hang (header: the cost).
+    static constexpr int kMaxTrimPolls = 1'000'000;
+
+    /// `config` is copied into the PLL (its preconditions apply).
+    explicit ProsPllTickPacer(const TickPllConfig& config = {}) : pll_{config} {}
+
+    /// Block until the next release instant on the grid (header: steps 1–5).
+    void pace() override {
+        const TickPllPlan plan = pll_.plan(::pros::micros());
+        if (!plan.sleep) {
+            pll_.release(::pros::micros());
+            return;
+        }
+        std::uint32_t prevMs = ::pros::millis();
+        const auto wakeMs = static_cast<std::uint32_t>(plan.wakeMs);
+        if (wakeMs > prevMs) {
+            ::pros::Task::delay_until(&prevMs, wakeMs - prevMs);
+        }
+        const std::uint64_t wokeUs = ::pros::micros();
+        const std::uint64_t spinToUs = pll_.onWake(wokeUs);
+        std::uint64_t nowUs = wokeUs;
+        for (int polls = 0; nowUs < spinToUs && polls < kMaxTrimPolls; ++polls) {
+            nowUs = ::pros::micros();
+        }
+        pll_.release(nowUs, nowUs - wokeUs);
+    }
+
+    /// The PLL and its measured statistics (mean period, jitter RMS/max, late ticks, slips,
+    /// spin cost) — the bench's answer to HA-102.
+    [[nodiscard]] const TickPll& pll() const noexcept { return pll_; }
+
+private:
+    TickPll pll_;
+};
+
+}  // namespace shulib::hal::pros
@@ -15,6 +15,10 @@
 //     addition additive and F9-versionable, never a break — a pure-virtual emit() would
 //     have broken NullSink, FakeTelemetrySink, and every future implementer at once.
 //     (Pinned by the message-only-sink additivity test in test/telemetry_sink_test.cpp.)
+//   * logDeferred() — the same leveled channel with the formatting DEFERRED: an interned
+//     format id plus packed arguments (diag/deferred_log.hpp, SHULIB_LOGF). Added by the
+//     same recipe: non-pure, and its default renders the line and hands it to log(), so
+//     every text sink shows it unchanged. Binary sinks override it to keep the bytes.
 //
 // ── The null-sink COST mechanism (§18.2 "NullSink ≈ free"), and why this shape ──────
 // The subtle failure this seam must prevent: if the tick loop always builds a
@@ -45,9 +49,13 @@
 // on the CALLER's task, and implementations must document their own thread-safety (the
 // shipped sinks are single-task by contract). Implementations MUST NOT throw.
 
+#include <array>
+#include <cstddef>
 #include <string_view>
 #include <utility>
 
+#include "shulib/diag/deferred_log.hpp"
+
 namespace shulib::diag {
 // Forward declarations only: the full schemas live in shulib/diag/debug_record.hpp
 // and shulib/diag/run_summary.hpp. The seam stays include-light (a reference
@@ -85,12 +93,13 @@ enum class LogLevel {
 
 /// The ONE diagnostics output seam — NullSink, TermSink, SdSink, Shul2Sink and every decorator
 /// sit behind it, so the same trace reaches the terminal, an SD blackbox or the wire without the
-/// core knowing which. THREE channels ride it: log() (leveled messages, pure virtual), emit()
-/// (per-tick DebugRecord) and summarize() (once per run). Only log() is pure — emit() and
-/// summarize() default to no-ops so a sink written against an older version of this seam keeps
-/// compiling when a channel is added. Everything runs SYNCHRONOUSLY on the caller's task: there
-/// is no background thread and no queue here, implementations MUST NOT throw, and each one
-/// documents its own thread-safety (the shipped sinks are single-task by contract).
+/// core knowing which. FOUR channels ride it: log() (leveled messages, pure virtual),
+/// logDeferred() (the same lines with formatting deferred), emit() (per-tick DebugRecord) and
+/// summarize() (once per run). Only log() is pure — logDeferred() defaults to rendering into
+/// log(), emit() and summarize() to no-ops, so a sink written against an older version of this
+/// seam keeps compiling when a channel is added. Everything runs SYNCHRONOUSLY on the caller's
+/// task: there is no background thread and no queue here, implementations MUST NOT throw, and
+/// each one documents its own thread-safety (the shipped sinks are single-task by contract).
 class ITelemetrySink {
 public:
     /// Abstract base, held and destroyed through ITelemetrySink*. Sinks are referenced, never
@@ -108,6 +117,16 @@ public:
     /// Emit a leveled, subsystem-tagged message (§18.3). Implementations MUST NOT throw.
     virtual void log(LogLevel level, std::string_view subsystem, std::string_view message) = 0;
 
+    /// Emit a deferred-formatting line (diag/deferred_log.hpp). NON-pure: the default renders
+    /// it with formatDeferred() into a stack buffer and passes the text to log(), which is right
+    /// for a text sink. A binary sink overrides it to write the packed line as it is; NullSink
+    /// overrides it to do nothing; a decorator forwards it. Implementations MUST NOT throw.
+    virtual void logDeferred(const diag::DeferredLog& line) {
+        std::array<char, diag::kMaxDeferredTextBytes> text{};
+        const std::size_t n = diag::formatDeferred(line, text);
+        log(line.level, line.tag, std::string_view{text.data(), n});
+    }
+
     /// Would emit() consume a DebugRecord? Callers use this (via emitRecord below) to
     /// skip record POPULATION entirely when nothing consumes it — the null-sink cost
     /// mechanism (header note). Default false, matching the default no-op emit():
@@ -0,0 +1,202 @@
+#pragma once
+//
+// TickPll — the pure timing logic of a microsecond-precision, phase-locked tick pacer
+// (hal/pros/pll_tick_pacer.hpp drives it on the robot; sim/hostile/pacer_jitter.hpp drives
+// it in host sim). No PROS, no clock, no sleeping: every input is a microsecond instant
+// the caller measured, every output is an instant the caller should wait until. That split
+// is what lets the same arithmetic be pinned by test against a scripted clock and then run
+// unchanged on the brain.
+//
+// ── Why it exists ───────────────────────────────────────────────────────────────────
+// ProsTickPacer paces on millis() with delay_until, so its wake instant is only as good as
+// the 1 ms scheduler tick it lands on, plus whatever latency the RTOS adds. A ±1 ms
+// jitter is 10% of the 10 ms control tick, and it feeds straight into every PID derivative
+// and the odometry twist. The cadence is already anchored (HA-102); what is missing is
+// PRECISION inside the millisecond, and a measurement of what the loop actually got.
+//
+// ── How it locks (a first-order PLL, named honestly) ─────────────────────────────────
+//   * REFERENCE: an absolute schedule of release instants, target_ += period each tick.
+//     Errors never accumulate into the period — a late tick is late against the grid,
+//     and the next tick is measured against the same grid.
+//   * COARSE ACTUATOR: sleep to a millisecond boundary (plan()), chosen EARLY by the
+//     current lead so the wake lands before the target.
+//   * PHASE DETECTOR: onWake() measures how late the wake landed relative to the boundary
+//     it asked for. The RTOS's wake latency is the disturbance being tracked.
+//   * LOOP FILTER: lead_ is an EWMA of that lateness (gain `leadGain`) plus a fixed guard.
+//   * FINE ACTUATOR: the caller spins on the µs clock from the wake to the target, and
+//     the spin is BOUNDED by maxTrimUs. The bound is the cost cap — a spin is CPU that no
+//     other task gets. maxTrimUs = 0 turns trimming off and leaves a phase-locked
+//     millisecond pacer.
+//
+// ── Late ticks and slips ─────────────────────────────────────────────────────────────
+// A tick body that finishes past its target is released at once, with no sleep and no
+// spin. Less than a period late, the grid is KEPT: the next target is still ahead, the
+// phase recovers on its own, and the long period counts as jitter (lateTicks()). A whole
+// period or more late cannot be paced back into phase without the catch-up burst that
+// ProsTickPacer's re-anchor exists to prevent. So the grid is RE-ANCHORED at that instant,
+// and the slip is counted. A slipped period is excluded from the jitter statistics —
+// otherwise a 3 s pause between runs would own the RMS forever. slips() reports it.
+//
+// ── What it reports ─────────────────────────────────────────────────────────────────
+// Over non-slipped periods: the mean period, the RMS and the worst |period − nominal|, and
+// the last period. Also late ticks, slips and the total µs spent spinning. These are the
+// numbers that settle HA-102 on the bench: "mean 10000.0 µs, rms 14 µs" is the claim,
+// measured.
+//
+// Integer microseconds throughout (the micros() domain). Single-task by contract.
+
+#include <cmath>
+#include <cstdint>
+
+#include "shulib/core/check.hpp"
+
+namespace shulib::hal {
+
+/// TickPll's knobs, taken BY VALUE at construction. The defaults are a 100 Hz loop with a
+/// 1.2 ms trim cap: enough to cover a full millisecond of coarse quantization plus the guard.
+struct TickPllConfig {
+    std::uint32_t periodUs = 10000;  ///< nominal period (HA-32's 100 Hz). Must be >= 1000.
+    /// Most µs the caller may spin per tick to trim the remainder. 0 disables trimming.
+    /// Must be < periodUs — a spin that could take a whole period is not a trim.
+    std::uint32_t maxTrimUs = 1200;
+    /// Fixed margin added to the learned wake lateness when choosing how early to wake.
+    /// Larger trades spin time for fewer wakes that land after the target.
+    std::uint32_t guardUs = 150;
+    /// EWMA gain on the measured wake lateness, in (0, 1]. Small = a slow, smooth lead.
+    double leadGain = 0.2;
+};
+
+/// What plan() asks of the caller: sleep until the millisecond boundary `wakeMs` (the millis()
+/// domain), or — when `sleep` is false — release immediately (the tick is due or late).
+struct TickPllPlan {
+    bool sleep = false;         ///< false ⇒ skip the sleep AND the spin; call release() now
+    std::uint64_t wakeMs = 0;   ///< absolute millisecond to wake at (valid when `sleep`)
+};
+
+/// The PLL pacing arithmetic (header note). One tick is plan() → [sleep] → onWake() →
+/// [spin] → release(), or plan() → release() when plan() says not to sleep.
+class TickPll {
+public:
+    /// Preconditions: periodUs >= 1000, maxTrimUs < periodUs, leadGain in (0, 1].
+    explicit TickPll(const TickPllConfig& config = {}) : cfg_{config} {
+        SHULIB_PRECONDITION(config.periodUs >= 1000U, "TickPll: periodUs must be >= 1000");
+        SHULIB_PRECONDITION(config.maxTrimUs < config.periodUs,
+                            "TickPll: maxTrimUs must be < periodUs");
+        SHULIB_PRECONDITION(config.leadGain > 0.0 && config.leadGain <= 1.0,
+                            "TickPll: leadGain must be in (0, 1]");
+    }
+
+    /// Decide how to wait for the next release, given the instant the caller is ready.
+    /// The first call anchors the grid one period after `nowUs` (ProsTickPacer's lazy-anchor
+    /// rule). A call at or past the target says not to sleep; a whole period past it also
+    /// re-anchors (header: late ticks and slips).
+    [[nodiscard]] TickPllPlan plan(std::uint64_t nowUs) noexcept {
+        if (!anchored_) {
+            anchored_ = true;
+            target_ = nowUs + cfg_.periodUs;
+        } else if (nowUs >= target_) {
+            if (nowUs - target_ >= cfg_.periodUs) {
+                ++slips_;
+                slipPending_ = true;
+                target_ = nowUs;  // re-anchor: release() re-bases the grid on this instant
+            } else if (nowUs > target_) {
+                ++lateTicks_;  // grid kept: the next target is still ahead
+            }
+            return TickPllPlan{};
+        }
+        const std::uint64_t lead = static_cast<std::uint64_t>(std::llround(lead_)) + cfg_.guardUs;
+        const std::uint64_t wakeAtUs = target_ > nowUs + lead ? target_ - lead : nowUs;
+        requestedWakeUs_ = (wakeAtUs / 1000U) * 1000U;  // the boundary at or before it
+        // A boundary already behind `nowUs` does not block, so the "wake" it produces says
+        // nothing about RTOS latency — it must not train the lead.
+        wakeIsMeasurement_ = requestedWakeUs_ > nowUs;
+        return TickPllPlan{true, requestedWakeUs_ / 1000U};
+    }
+
+    /// The caller woke from plan()'s sleep at `wokeUs`. Updates the lead (phase detector +
+    /// loop filter) and returns the instant to spin until: the target, clamped to at most
+    /// maxTrimUs after the wake. Returns `wokeUs` itself when there is nothing to trim.
+    [[nodiscard]] std::uint64_t onWake(std::uint64_t wokeUs) noexcept {
+        if (wakeIsMeasurement_) {
+            const double lateness = wokeUs > requestedWakeUs_
+                                        ? static_cast<double>(wokeUs - requestedWakeUs_)
+                                        : 0.0;
+            lead_ += cfg_.leadGain * (lateness - lead_);
+        }
+        if (wokeUs >= target_) {
+            return wokeUs;
+        }
+        const std::uint64_t remaining = target_ - wokeUs;
+        return wokeUs + (remaining < cfg_.maxTrimUs ? remaining : cfg_.maxTrimUs);
+    }
+
+    /// The tick was released at `releaseUs` (after any spin). Credits the spin, updates the
+    /// period statistics, and advances the grid one period.
+    void release(std::uint64_t releaseUs, std::uint64_t spunUs = 0) noexcept {
+        trimUs_ += spunUs;
+        if (hasRelease_ && !slipPending_) {
+            const std::uint64_t period = releaseUs - lastReleaseUs_;
+            const double err = static_cast<double>(period) - static_cast<double>(cfg_.periodUs);
+            ++periods_;
+            sumPeriodUs_ += static_cast<double>(period);
+            sumSqErrUs_ += err * err;
+            const double absErr = std::fabs(err);
+            if (absErr > maxAbsErrUs_) {
+                maxAbsErrUs_ = absErr;
+            }
+            lastPeriodUs_ = period;
+        }
+        slipPending_ = false;
+        hasRelease_ = true;
+        lastReleaseUs_ = releaseUs;
+        target_ += cfg_.periodUs;
+    }
+
+    /// The next release instant on the grid (µs). Meaningful once anchored.
+    [[nodiscard]] std::uint64_t targetUs() const noexcept { return target_; }
+    /// The current learned wake lateness (µs, before the guard is added).
+    [[nodiscard]] double leadUs() const noexcept { return lead_; }
+    /// Non-slipped periods measured so far — the denominator of every statistic below.
+    [[nodiscard]] std::uint32_t periods() const noexcept { return periods_; }
+    /// Mean measured period (µs); 0 before the first measured period.
+    [[nodiscard]] double meanPeriodUs() const noexcept {
+        return periods_ == 0 ? 0.0 : sumPeriodUs_ / static_cast<double>(periods_);
+    }
+    /// RMS of (period − nominal) in µs — the jitter figure; 0 before the first period.
+    [[nodiscard]] double jitterRmsUs() const noexcept {
+        return periods_ == 0 ? 0.0 : std::sqrt(sumSqErrUs_ / static_cast<double>(periods_));
+    }
+    /// The worst |period − nominal| seen (µs).
+    [[nodiscard]] double maxJitterUs() const noexcept { return maxAbsErrUs_; }
+    /// The most recent non-slipped period (µs); 0 before the first.
+    [[nodiscard]] std::uint64_t lastPeriodUs() const noexcept { return lastPeriodUs_; }
+    /// Ticks released late but within a period — the grid was kept (header note).
+    [[nodiscard]] std::uint32_t lateTicks() const noexcept { return lateTicks_; }
+    /// Ticks a whole period or more late, which re-anchored the grid (header note).
+    [[nodiscard]] std::uint32_t slips() const noexcept { return slips_; }
+    /// Total µs the caller reported spinning — the CPU the trim cost.
+    [[nodiscard]] std::uint64_t trimUs() const noexcept { return trimUs_; }
+    /// The configuration this PLL was built with.
+    [[nodiscard]] const TickPllConfig& config() const noexcept { return cfg_; }
+
+private:
+    TickPllConfig cfg_;
+    std::uint64_t target_ = 0;
+    std::uint64_t requestedWakeUs_ = 0;
+    std::uint64_t lastReleaseUs_ = 0;
+    std::uint64_t lastPeriodUs_ = 0;
+    std::uint64_t trimUs_ = 0;
+    double lead_ = 0.0;
+    double sumPeriodUs_ = 0.0;
+    double sumSqErrUs_ = 0.0;
+    double maxAbsErrUs_ = 0.0;
+    std::uint32_t periods_ = 0;
+    std::uint32_t lateTicks_ = 0;
+    std::uint32_t slips_ = 0;
+    bool anchored_ = false;
+    bool hasRelease_ = false;
+    bool slipPending_ = false;
+    bool wakeIsMeasurement_ = false;
+};
+
+}  // namespace shulib::hal
@@ -59,6 +59,7 @@
 #include <cmath>
 #include <cstddef>
 #include <initializer_list>
+#include <span>
 
 #include "shulib/core/check.hpp"
 #include "shulib/kinematics/desaturate.hpp"
@@ -222,6 +223,49 @@ public:
                              units::AngularVelocity{g02_ * gh + g12_ * gv + g22_ * gt}};
     }
 
+    /// forward() for `vx.size()` drivetrains at once, structure-of-arrays: wheel i of drivetrain r
+    /// is `wheels[i·count + r]`, and drivetrain r's twist lands in vx[r], vy[r], omega[r]. Each
+    /// drivetrain gets forward()'s sums in forward()'s order, so every result is bit-identical
+    /// to a forward() call on its own wheels; only the loop nest differs — drivetrains innermost,
+    /// where a compiler can vectorise it (sim::BatchPlant's kinematics stage). Preconditions:
+    /// vy and omega are vx's size, and wheels.size() == wheelCount()·vx.size().
+    void forwardBatch(std::span<const double> wheels, std::span<double> vx, std::span<double> vy,
+                      std::span<double> omega) const {
+        const std::size_t count = vx.size();
+        SHULIB_PRECONDITION(vy.size() == count && omega.size() == count,
+                            "MatrixKinematics::forwardBatch: output spans differ in size");
+        SHULIB_PRECONDITION(wheels.size() == static_cast<std::size_t>(n_) * count,
+                            "MatrixKinematics::forwardBatch: wheel-count mismatch");
+        for (std::size_t r = 0; r < count; ++r) {  // Aᵀ·w accumulates in the outputs
+            vx[r] = 0.0;
+            vy[r] = 0.0;
+            omega[r] = 0.0;
+        }
+        for (int i = 0; i < n_; ++i) {
+            const Wheel& row = wheels_[static_cast<std::size_t>(i)];
+            const double* s = wheels.data() + static_cast<std::size_t>(i) * count;
+            for (std::size_t r = 0; r < count; ++r) {
+                vx[r] += row.h * s[r];
+                vy[r] += row.v * s[r];
+                omega[r] += row.turnInches * s[r];
+            }
+        }
+        for (std::size_t r = 0; r < count; ++r) {
+            const double gh = vx[r];
+            const double gv = vy[r];
+            const double gt = omega[r];
+            if (orthogonal_) {
+                vx[r] = gh / sumH2_;
+                vy[r] = gv / sumV2_;
+                omega[r] = gt / sumT2_;
+            } else {
+                vx[r] = g00_ * gh + g01_ * gv + g02_ * gt;
+                vy[r] = g01_ * gh + g11_ * gv + g12_ * gt;
+                omega[r] = g02_ * gh + g12_ * gv + g22_ * gt;
+            }
+        }
+    }
+
     /// Scale EVERY wheel by one common factor until the largest magnitude just reaches
     /// `maxWheelSpeed`, so the commanded direction survives and only speed is traded away. A
     /// command already within budget (all-zero included) is returned unchanged — this never scales
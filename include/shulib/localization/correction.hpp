@@ -132,4 +132,53 @@ struct AppliedCorrection {
     units::AngleDim dtheta{};
 };
 
+/// The raw readings one Localizer::update() consumed — exactly what an offline replay must
+/// feed back to reproduce the tick (sim/estimator_replay.hpp). The Localizer fills the IMU and
+/// tracking-wheel half itself; each corrector that can be replayed adds its own reading through
+/// ICorrector::captureInputs(). Rides to the record through stampEstimatorInputs() below.
+struct EstimatorInputs {
+    bool imuReady = false;                  ///< IImu::isReady()
+    math::Angle imuHeading{};               ///< the RAW IMU heading (no heading bias)
+    units::AngularVelocity imuYawRate{};    ///< the raw IMU yaw rate, non-finite included
+    units::AngleDim forwardShaft{};         ///< forward tracking wheel, cumulative shaft angle
+    units::AngleDim lateralShaft{};         ///< lateral tracking wheel, cumulative shaft angle
+    bool gpsPresent = false;                ///< a GPS corrector was asked this tick
+    bool gpsFix = false;                    ///< IGps::hasFix()
+    math::Pose2d gpsPose{};                 ///< IGps::pose() (meaningful only with a fix)
+    units::Length gpsRmsError{};            ///< IGps::rmsError() (meaningful only with a fix)
+};
+
+/// Copy `in` into the record's estimator-input slots and mark them present.
+inline void stampEstimatorInputs(diag::DebugRecord& r, const EstimatorInputs& in) noexcept {
+    r.hasEstimatorInputs = true;
+    r.inputImuReady = in.imuReady;
+    r.inputImuHeading = in.imuHeading;
+    r.inputImuYawRate = in.imuYawRate;
+    r.inputForwardShaft = in.forwardShaft;
+    r.inputLateralShaft = in.lateralShaft;
+    r.inputGpsPresent = in.gpsPresent;
+    r.inputGpsFix = in.gpsFix;
+    r.inputGpsPose = in.gpsPose;
+    r.inputGpsRmsError = in.gpsRmsError;
+}
+
+/// The inverse of stampEstimatorInputs(): the inputs a record carries (all defaults when
+/// `r.hasEstimatorInputs` is false).
+[[nodiscard]] inline EstimatorInputs estimatorInputsOf(const diag::DebugRecord& r) noexcept {
+    EstimatorInputs in;
+    if (!r.hasEstimatorInputs) {
+        return in;
+    }
+    in.imuReady = r.inputImuReady;
+    in.imuHeading = r.inputImuHeading;
+    in.imuYawRate = r.inputImuYawRate;
+    in.forwardShaft = r.inputForwardShaft;
+    in.lateralShaft = r.inputLateralShaft;
+    in.gpsPresent = r.inputGpsPresent;
+    in.gpsFix = r.inputGpsFix;
+    in.gpsPose = r.inputGpsPose;
+    in.gpsRmsError = r.inputGpsRmsError;
+    return in;
+}
+
 }  // namespace shulib::localization
@@ -203,6 +203,7 @@ public:
     [[nodiscard]] CorrectionProposal propose(const math::Pose2d& predicted,
                                              units::Time /*dt*/) override {
         const double now = clock_.now().value();
+        readFix_ = false;  // replay capture (captureInputs): nothing read yet this tick
         const double px = predicted.x().value();
         const double py = predicted.y().value();
         if (!std::isfinite(now) || !std::isfinite(px) || !std::isfinite(py)) {
@@ -229,7 +230,8 @@ public:
         // low-confidence pull, which would drag the estimate toward whatever stale pose the
         // device happens to be serving (A4 register HA-31 makes that the origin in the model,
         // on purpose, so code that trusts it gets caught).
-        if (!gps_.hasFix()) {
+        readFix_ = gps_.hasFix();
+        if (!readFix_) {
             ++noFixTicks_;
             return decline(diag::GateReason::RejectedNoFix);
         }
@@ -240,6 +242,8 @@ public:
         const double zx = fix.x().value();
         const double zy = fix.y().value();
         const double rms = gps_.rmsError().value();
+        readPose_ = fix;
+        readRms_ = rms;
         if (!std::isfinite(zx) || !std::isfinite(zy) || !std::isfinite(rms) || rms < 0.0) {
             ++noFixTicks_;
             return decline(diag::GateReason::RejectedNoFix);
@@ -323,6 +327,15 @@ public:
     /// the reason the tick dead-reckoned.
     [[nodiscard]] const char* name() const noexcept override { return name_; }
 
+    /// The GPS reading the last propose() took — fix flag, and the pose and rms when it had a
+    /// fix — for offline replay (EstimatorInputs).
+    void captureInputs(EstimatorInputs& inputs) const noexcept override {
+        inputs.gpsPresent = true;
+        inputs.gpsFix = readFix_;
+        inputs.gpsPose = readPose_;
+        inputs.gpsRmsError = units::Length{readRms_};
+    }
+
     // ── per-source accounting (the "visible off-strip" requirement) ─────────────────────────
 
     /// What this corrector decided on the most recent propose() call.
@@ -430,6 +443,10 @@ private:
     double sampleObservedAt_ = 0.0;
     bool haveSample_ = false;
 
+    bool readFix_ = false;      // the last propose()'s GPS reading, for captureInputs()
+    math::Pose2d readPose_{};
+    double readRms_ = 0.0;
+
     diag::GateReason lastVerdict_ = diag::GateReason::None;
     std::uint32_t accepted_ = 0;
     std::uint32_t noFixTicks_ = 0;
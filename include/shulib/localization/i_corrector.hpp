@@ -45,6 +45,12 @@ public:
 
     /// Stable id for telemetry / per-source dead-reckon accounting.
     [[nodiscard]] virtual const char* name() const noexcept = 0;
+
+    /// Add the raw reading the last propose() consumed to `inputs`, so the tick can be
+    /// replayed offline (EstimatorInputs). The Localizer calls it after every propose().
+    /// The default adds nothing: a corrector that does not override it is simply not
+    /// replayable, and a replay runs without it.
+    virtual void captureInputs(EstimatorInputs& /*inputs*/) const noexcept {}
 };
 
 /// The M2 placeholder: a registered source that never has a fix. Lets the fusion pipeline run and
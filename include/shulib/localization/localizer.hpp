@@ -94,6 +94,7 @@
 #include <span>
 
 #include "shulib/core/check.hpp"
+#include "shulib/diag/zone_profiler.hpp"
 #include "shulib/hal/clock.hpp"
 #include "shulib/hal/imu.hpp"
 #include "shulib/localization/correction.hpp"
@@ -232,7 +233,10 @@ public:
         }
         const bool foldDeltas = imuEverReady_ && now >= settleUntil_;
         settled_ = foldDeltas;
-        odom_.update();
+        {
+            SHULIB_ZONE(profiler_, "odom");
+            odom_.update();
+        }
         const math::Pose2d odomNow = odom_.pose();
         double odx = foldDeltas ? (odomNow.x().value() - lastOdomX_) : 0.0;
         double ody = foldDeltas ? (odomNow.y().value() - lastOdomY_) : 0.0;
@@ -249,6 +253,13 @@ public:
         }
         const math::Angle rawHeading = imu_.heading();
         const math::Angle heading = biasedHeading(rawHeading);
+        // Replay capture (lastInputs()): the raw readings this tick consumed — the IMU and the
+        // wheels here, each corrector's own right after its propose() below.
+        inputs_ = EstimatorInputs{};
+        inputs_.imuReady = readyNow;
+        inputs_.imuHeading = rawHeading;
+        inputs_.forwardShaft = odom_.forwardShaft();
+        inputs_.lateralShaft = odom_.lateralShaft();
         const math::Pose2d predicted{units::Length{fusedX_ + odx}, units::Length{fusedY_ + ody}, heading};
 
         // STEP 3 — gather VALID proposals (screened, incl. FINITE confidence so an Inf can't sail
@@ -278,8 +289,14 @@ public:
         const char* selfAuditSource = nullptr;
         bool selfAuditRoutine = false;
         if (foldDeltas) {
+            SHULIB_ZONE(profiler_, "correct");
             for (ICorrector* c : correctors_) {
-                const CorrectionProposal p = c->propose(predicted, units::Time{dt});
+                CorrectionProposal p;
+                {
+                    SHULIB_ZONE_DYNAMIC(profiler_, c->name());
+                    p = c->propose(predicted, units::Time{dt});
+                }
+                c->captureInputs(inputs_);
                 if (p.valid && std::isfinite(p.confidence) && p.confidence > 0.0 &&
                     p.positionStdDev.value() > 0.0 &&
                     std::isfinite(p.fieldPose.x().value()) && std::isfinite(p.fieldPose.y().value()) &&
@@ -301,8 +318,12 @@ public:
         // PREDICTED fused pose (so the innovation shrinks as the fused state converges), plus,
         // since E3, a bounded heading INCREMENT from any proposal that supplies an absolute
         // heading.
-        const FusionResult fr =
-            fusion_.fuse(predicted, std::span<const CorrectionProposal>{buf.data(), n}, units::Time{dt});
+        FusionResult fr;
+        {
+            SHULIB_ZONE(profiler_, "fuse");
+            fr = fusion_.fuse(predicted, std::span<const CorrectionProposal>{buf.data(), n},
+                              units::Time{dt});
+        }
 
         // STEP 5 — heading composed from the IMU as the LAST write + publish.
         //
@@ -331,6 +352,7 @@ public:
         // twist: linear from the fused-pose finite-difference (dt-guarded), omega from the IMU (finite).
         const double rawOmega = imu_.yawRate().value();
         const double omega = std::isfinite(rawOmega) ? rawOmega : 0.0;
+        inputs_.imuYawRate = units::AngularVelocity{rawOmega};
         if (hasLast_ && dt > 0.0) {
             const double vx = dtHealthy ? (fusedX_ - lastFusedX_) / dt : 0.0;  // tiny/huge dt ⇒ 0
             const double vy = dtHealthy ? (fusedY_ - lastFusedY_) / dt : 0.0;
@@ -446,6 +468,9 @@ public:
     /// The last tick's applied correction AND the gate's account of why (`audit`, added
     /// at E1) — the values a record producer stamps into the §18.2 gating slots.
     [[nodiscard]] const AppliedCorrection& lastCorrection() const noexcept { return lastCorrection_; }
+    /// The raw readings the last update() consumed (EstimatorInputs) — what a record producer
+    /// stamps so the tick can be replayed offline. All defaults before the first update().
+    [[nodiscard]] const EstimatorInputs& lastInputs() const noexcept { return inputs_; }
     /// Forwarding accessor for PilonsOdometry::lastDeltaImplausible() — added at C1
     /// (additive) so the motion loop can feed HealthMonitor's odomImplausible
     /// observable without holding the odometry itself. Raising stays POLICY: this
@@ -485,6 +510,13 @@ public:
         hasLast_ = false;  // next tick re-establishes dt (no phantom velocity from the jump)
     }
 
+    /// Attach a zone profiler (diag/zone_profiler.hpp) to update(): its "odom", "correct" (one
+    /// child per corrector, named by name()) and "fuse" zones then nest under whatever zone
+    /// encloses the call — MotionScheduler's "loc". nullptr detaches (the default). Compiled
+    /// out entirely unless SHULIB_ENABLE_ZONES. NON-OWNING: must outlive the Localizer or be
+    /// detached first, and every corrector's name() must outlive the profiler.
+    void setProfiler(diag::ZoneProfiler* profiler) noexcept { profiler_ = profiler; }
+
 private:
     /// The published heading: the raw IMU reading plus the learned bias (E3, header note). The
     /// zero-bias early-out makes a tree with no heading-providing corrector bit-identical to
@@ -538,11 +570,13 @@ private:
     IFusionPolicy& fusion_;
     std::span<ICorrector* const> correctors_;
     LocalizerConfig config_;
+    diag::ZoneProfiler* profiler_ = nullptr;
 
     math::Pose2d pose_{};
     math::Twist2d twist_{};
     units::Length distanceSinceCorrection_{0.0};
     AppliedCorrection lastCorrection_{};
+    EstimatorInputs inputs_{};
     Quality qualityClass_ = Quality::Uninitialized;
     double quality_ = 0.0;
     bool deadReckoning_ = true;
@@ -182,6 +182,13 @@ public:
     /// True iff the last update() was untrustworthy (oversized Δθ OR non-finite integration).
     [[nodiscard]] bool lastDeltaImplausible() const noexcept { return implausible_; }
 
+    /// The forward wheel's cumulative shaft reading as of the last update() — the raw input a
+    /// replay feeds back (TrackingWheel::lastShaft()).
+    [[nodiscard]] units::AngleDim forwardShaft() const noexcept { return forward_.lastShaft(); }
+
+    /// The lateral wheel's cumulative shaft reading as of the last update().
+    [[nodiscard]] units::AngleDim lateralShaft() const noexcept { return lateral_.lastShaft(); }
+
 private:
     hal::IImu& imu_;
     TrackingWheel forward_;
@@ -83,6 +83,10 @@ public:
     /// Whether this wheel rolls forward (+X body) or laterally (+Y body) — checked by PilonsOdometry.
     [[nodiscard]] Role role() const noexcept { return role_; }
 
+    /// The cumulative shaft reading taken by the last travelDelta() or reset() (radians) — the
+    /// raw input an offline replay feeds back (EstimatorInputs). Reads nothing.
+    [[nodiscard]] units::AngleDim lastShaft() const noexcept { return units::AngleDim{lastShaft_}; }
+
     /// Resync the baseline to the current reading, so the next travelDelta() starts from zero
     /// (used when odometry is (re)initialized, so a pre-existing shaft total isn't counted).
     void reset() { lastShaft_ = sensor_.position().value(); }
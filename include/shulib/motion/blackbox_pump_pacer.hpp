@@ -0,0 +1,72 @@
+#pragma once
+//
+// BlackboxPumpPacer — runs SdSink::pump() in the tick's slack: an ITickPacer decorator
+// that pumps one slice of the blackbox's staged bytes and then hands the tick to the
+// real pacer.
+//
+// ── Why a pacer, and why BEFORE the inner pace() ────────────────────────────────────
+// The pacer is the one seam that runs every tick after the tick's work is done and
+// before the next tick begins (RunGuard's precedent, sequence/run_guard.hpp). On the
+// robot the inner pacer SLEEPS to the tick boundary, so a pump placed ahead of it spends
+// time the loop was going to sleep anyway: a 1 ms sector write inside a 3 ms tick body
+// is invisible to a 10 ms cadence, where the same bytes written by a boundary flush()
+// are one tick of tens of milliseconds. Pumping AFTER the inner pace() would put the
+// write at the start of the next tick's budget instead — the exact placement this file
+// exists to avoid. On the host the inner pacer steps the plant; the order is the same.
+//
+// ── What it does NOT do ─────────────────────────────────────────────────────────────
+// It does not measure the slack and skip the pump when there is none: the scheduler's
+// TickBudget already answers "is this tick over budget", and pump() honours its SdFlush
+// class (counted as a deferred pump). One shedding policy, not two.
+//
+// Single-task, like the scheduler it paces. Nothing here allocates or throws beyond
+// what the inner pacer does.
+
+#include <cstddef>
+
+#include "shulib/diag/sd_sink.hpp"
+#include "shulib/motion/motion_scheduler.hpp"
+
+namespace shulib::motion {
+
+/// An ITickPacer that pumps a blackbox slice, then paces (file banner). Wrap the real
+/// pacer and hand the wrapper to the Chassis; configure the sink with a non-zero
+/// SdSinkConfig::pumpBytesPerTick, or the pump is a no-op and this is a pass-through.
+///
+///     motion::ITickPacer& real = ...;               // plant pacer / R1's delay
+///     motion::BlackboxPumpPacer pumped{real, blackbox};
+///     chassis::Chassis chassis{deps, pumped, cfg};
+///
+/// Not copyable/movable: the Chassis holds a reference to it as the pacer.
+class BlackboxPumpPacer final : public ITickPacer {
+public:
+    /// `inner` advances the real world; `sink` is the blackbox to pump. Both must
+    /// outlive the pacer.
+    BlackboxPumpPacer(ITickPacer& inner, diag::SdSink& sink) noexcept
+        : inner_{&inner}, sink_{&sink} {}
+
+    /// Pinned where it is constructed: the Chassis holds this object BY REFERENCE as its
+    /// pacer. The destructor releases nothing — both pointers are non-owning.
+    BlackboxPumpPacer(const BlackboxPumpPacer&) = delete;
+    BlackboxPumpPacer(BlackboxPumpPacer&&) = delete;
+    BlackboxPumpPacer& operator=(const BlackboxPumpPacer&) = delete;
+    BlackboxPumpPacer& operator=(BlackboxPumpPacer&&) = delete;
+    ~BlackboxPumpPacer() override = default;
+
+    /// Pump one slice, THEN pace — the write spends the wait, not the next tick (file
+    /// banner).
+    void pace() override {
+        pumped_ += sink_->pump();
+        inner_->pace();
+    }
+
+    /// Bytes this pacer's pumps have written.
+    [[nodiscard]] std::size_t bytesPumped() const noexcept { return pumped_; }
+
+private:
+    ITickPacer* inner_;
+    diag::SdSink* sink_;
+    std::size_t pumped_ = 0;
+};
+
+}  // namespace shulib::motion
@@ -0,0 +1,287 @@
+#pragma once
+//
+// CommandLimiter — the optional acceleration/jerk limit on the BODY-frame command, with
+// traction control: step 4' of applyCommandPipeline, after every budget clamp and before
+// kinematics.
+//
+// ── Why it exists ───────────────────────────────────────────────────────────────────
+// The pipeline caps SPEED, never its rate of change. A fresh motion can step from rest to
+// maxLinearSpeed in one tick, and on a kA = 0-ish drive the wheels try to follow. That is
+// the launch behaviour sim/hostile/slip_hostility.hpp models (traction breaks above a spin
+// acceleration, HA-37): the drive encoders overcount, the robot undershoots, and the
+// estimator and OdoStallCheck have to clean up afterwards. Limiting the command's rate of
+// change keeps the wheels under the traction limit, so there is nothing to clean up.
+//
+// ── The limit: one uniform scale on the tick's change ───────────────────────────────
+// Let Δ = target − previous output (body frame: vx, vy, ω). Every limit becomes a ratio
+// "allowed / requested" and the tightest wins:
+//   * PER AXIS: |Δvx| ≤ aX·dt, |Δvy| ≤ aY·dt, |Δω| ≤ aω·dt, where each a ramps up from the
+//     axis's previous acceleration at most at a/jerkTime — the jerk limit. It bounds the
+//     ONSET of acceleration, not its end: reaching the target ends the ramp at once, which
+//     is a torque DROP, not a spike.
+//   * PER WHEEL: toWheels(Δ) must change no wheel by more than maxWheelAccel·dt. Every F5
+//     drive's toWheels is linear (a matrix), so the wheel change of s·Δ is s·toWheels(Δ).
+// The output is previous + s·Δ with s ≤ 1: one uniform scale, as desaturate() scales
+// wheels. Two consequences follow by construction. The commanded direction of change is
+// kept, so a diagonal ramp does not bend. And the output lies on the segment between two
+// in-budget commands. The norm cap, the strafe-authority slab and the ω clamp are all
+// convex, so the D-5 invariant-2 audit that follows is still a pure pass-through.
+//
+// ── Traction control: spin vs motion ────────────────────────────────────────────────
+// Each tick the caller hands in what the wheels SPIN (forward kinematics of the drive
+// encoders) and what the robot MOVES (the localizer's twist, which the unpowered tracking
+// wheels and the IMU drive), both in the body frame. Spin exceeding motion by more than
+// slipThreshold, while the wheels spin at least slipMinSpeed, is slip. This is the same
+// cross-check OdoStallCheck windows over, read per tick and acted on rather than reported.
+// While slipping, every limit above drops to slipLimitScale of itself. Once the slip ends the
+// scale recovers linearly over slipRecoveryTime. A frozen tracking wheel reads as slip too; it
+// can only make the ramps gentler, never stop the robot.
+//
+// ── Ticks with no interval ──────────────────────────────────────────────────────────
+// The first tick after reset(), or a tick after a gap longer than kMaxLimitDt, has no
+// interval to limit over. It re-seeds the previous output from the robot's MEASURED
+// motion, clamped into the same budgets, and commands that. A chained motion therefore
+// ramps from what the robot is actually doing, not from a stale command or from rest. A
+// second call at the same instant (dt = 0) repeats the previous output.
+//
+// Units: accelerations are typed where units/ has a type; rad/s² and seconds are bare
+// doubles with their units beside them, like the gains. Single-task. Stateful: reset()
+// between motions.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "shulib/core/check.hpp"
+#include "shulib/hal/clock.hpp"
+#include "shulib/kinematics/kinematics.hpp"
+#include "shulib/kinematics/wheel_speeds.hpp"
+#include "shulib/math/twist2d.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::motion {
+
+/// The limiter's knobs. Disabled by default, so a config that never mentions it keeps the
+/// pipeline bit-for-bit. PROVISIONAL (A4: HA-127) — set just under the plant's HA-37
+/// traction threshold, which is itself invented.
+struct CommandLimiterConfig {
+    /// Off ⇒ limit() returns its target unchanged and touches no state.
+    bool enabled = false;
+    /// Body forward acceleration limit, in/s². PROVISIONAL (A4: HA-127).
+    units::Acceleration maxAccelX{100.0};
+    /// Body strafe acceleration limit, in/s². PROVISIONAL (A4: HA-127).
+    units::Acceleration maxAccelY{60.0};
+    /// Yaw acceleration limit, rad/s². PROVISIONAL (A4: HA-127).
+    double maxAngularAccel = 12.0;
+    /// Per-wheel surface acceleration limit, in/s² — the one traction actually sees.
+    /// PROVISIONAL (A4: HA-127).
+    units::Acceleration maxWheelAccel{70.0};
+    /// Seconds for an axis's acceleration to ramp from 0 to its limit (jerk = limit /
+    /// jerkTime). 0 = no jerk limit. PROVISIONAL (A4: HA-127).
+    double jerkTime = 0.05;
+    /// (spin − motion) / spin above which the wheels are slipping. In (0, 1).
+    /// PROVISIONAL (A4: HA-127).
+    double slipThreshold = 0.2;
+    /// Spin speed (|v| + rotationRadius·|ω|, in/s) below which slip is not judged — the
+    /// ratio of two small, noisy speeds means nothing. PROVISIONAL (A4: HA-127).
+    units::Velocity slipMinSpeed{6.0};
+    /// Every limit is multiplied by this while slipping. In (0, 1]. PROVISIONAL (A4: HA-127).
+    double slipLimitScale = 0.5;
+    /// Seconds for the scale to climb back from slipLimitScale to 1 after the slip ends.
+    /// > 0. PROVISIONAL (A4: HA-127).
+    double slipRecoveryTime = 0.5;
+};
+
+/// What the robot is doing this tick, as the limiter reads it (header note). Both BODY
+/// frame; `spin` from the drive encoders, `motion` from the fused estimate.
+struct LimiterObservation {
+    math::ChassisSpeeds spin{};    ///< forward kinematics of the drive encoders' surface speeds
+    math::ChassisSpeeds motion{};  ///< the fused estimate's twist, rotated into the body frame
+};
+
+/// The budgets the pipeline has already clamped the target into, handed over so a re-seed
+/// from measured motion is clamped into the same convex set (header note).
+struct LimiterBudget {
+    double maxLinear = 0.0;   ///< in/s — the norm cap
+    double maxStrafe = 0.0;   ///< in/s — |body vy| after the strafe-authority clamp
+    double maxAngular = 0.0;  ///< rad/s — |ω|
+};
+
+/// The body-frame acceleration/jerk limiter with slip-reactive limits (header note).
+class CommandLimiter {
+public:
+    /// A tick longer than this (seconds) is a gap, and the limiter re-seeds (header note).
+    /// Ten 100 Hz ticks, matching WheelVelocityLoop's guard. Host-decidable.
+    static constexpr double kMaxLimitDt = 0.1;
+
+    /// `config` is copied; `clock` is NON-OWNING and must outlive the limiter; `rotationRadius`
+    /// (in) converts |ω| to linear speed in the slip test, as DriveBrake's norm does. Rejects
+    /// non-finite or non-positive limits and out-of-range slip knobs.
+    CommandLimiter(const CommandLimiterConfig& config, hal::IClock& clock,
+                   units::Length rotationRadius)
+        : cfg_{config}, clock_{clock}, rotationRadius_{rotationRadius.value()} {
+        auto positive = [](double v) { return std::isfinite(v) && v > 0.0; };
+        SHULIB_PRECONDITION(positive(cfg_.maxAccelX.value()) && positive(cfg_.maxAccelY.value())
+                                && positive(cfg_.maxAngularAccel)
+                                && positive(cfg_.maxWheelAccel.value()),
+                            "CommandLimiter: acceleration limits must be finite and > 0");
+        SHULIB_PRECONDITION(std::isfinite(cfg_.jerkTime) && cfg_.jerkTime >= 0.0,
+                            "CommandLimiter: jerkTime must be finite and >= 0");
+        SHULIB_PRECONDITION(cfg_.slipThreshold > 0.0 && cfg_.slipThreshold < 1.0,
+                            "CommandLimiter: slipThreshold must be in (0, 1)");
+        SHULIB_PRECONDITION(std::isfinite(cfg_.slipMinSpeed.value())
+                                && cfg_.slipMinSpeed.value() >= 0.0,
+                            "CommandLimiter: slipMinSpeed must be finite and >= 0");
+        SHULIB_PRECONDITION(cfg_.slipLimitScale > 0.0 && cfg_.slipLimitScale <= 1.0,
+                            "CommandLimiter: slipLimitScale must be in (0, 1]");
+        SHULIB_PRECONDITION(positive(cfg_.slipRecoveryTime),
+                            "CommandLimiter: slipRecoveryTime must be finite and > 0");
+        SHULIB_PRECONDITION(positive(rotationRadius_),
+                            "CommandLimiter: rotationRadius must be finite and > 0");
+    }
+
+    /// One tick: the command to send instead of `target` (already budget-clamped, body
+    /// frame). Disabled: `target` itself, bit for bit, with no state touched.
+    [[nodiscard]] math::ChassisSpeeds limit(const math::ChassisSpeeds& target,
+                                            const LimiterObservation& seen,
+                                            const kinematics::IKinematics& kin,
+                                            const LimiterBudget& budget) {
+        if (!cfg_.enabled) {
+            return target;
+        }
+        const double now = clock_.now().value();
+        const double dt = hasPrev_ ? now - lastTime_ : 0.0;
+        lastTime_ = now;
+        bound_ = false;
+        if (!hasPrev_ || dt > kMaxLimitDt) {
+            hasPrev_ = true;
+            prev_ = seed(seen.motion, budget);
+            accel_ = {};
+            judgeSlip(seen, 0.0);
+            return prev_;
+        }
+        if (dt <= 0.0) {
+            return prev_;  // no time has passed: nothing may change
+        }
+        judgeSlip(seen, dt);
+
+        const std::array<double, 3> d = {target.vx().value() - prev_.vx().value(),
+                                         target.vy().value() - prev_.vy().value(),
+                                         target.omega().value() - prev_.omega().value()};
+        const std::array<double, 3> maxA = {cfg_.maxAccelX.value() * scale_,
+                                            cfg_.maxAccelY.value() * scale_,
+                                            cfg_.maxAngularAccel * scale_};
+        double s = 1.0;
+        for (std::size_t k = 0; k < 3; ++k) {
+            double a = maxA[k];
+            if (cfg_.jerkTime > 0.0) {
+                a = std::min(a, std::abs(accel_[k]) + maxA[k] / cfg_.jerkTime * dt);
+            }
+            s = std::min(s, ratio(a * dt, d[k]));
+        }
+        const kinematics::WheelSpeeds dw = kin.toWheels(math::ChassisSpeeds{
+            units::Velocity{d[0]}, units::Velocity{d[1]}, units::AngularVelocity{d[2]}});
+        const double wheelStep = cfg_.maxWheelAccel.value() * scale_ * dt;
+        for (int i = 0; i < dw.size(); ++i) {
+            s = std::min(s, ratio(wheelStep, dw[i].value()));
+        }
+
+        if (s >= 1.0) {
+            prev_ = target;  // within every limit: the target itself, exactly
+        } else {
+            bound_ = true;
+            prev_ = math::ChassisSpeeds{units::Velocity{prev_.vx().value() + s * d[0]},
+                                        units::Velocity{prev_.vy().value() + s * d[1]},
+                                        units::AngularVelocity{prev_.omega().value() + s * d[2]}};
+        }
+        const double applied = std::min(s, 1.0);
+        for (std::size_t k = 0; k < 3; ++k) {
+            accel_[k] = applied * d[k] / dt;
+        }
+        return prev_;
+    }
+
+    /// Forget the previous output, the acceleration history and the slip state (between
+    /// motions). The next limit() re-seeds from measured motion.
+    void reset() noexcept {
+        hasPrev_ = false;
+        prev_ = {};
+        accel_ = {};
+        scale_ = 1.0;
+        slipping_ = false;
+        slipRatio_ = 0.0;
+        bound_ = false;
+    }
+
+    /// True iff the last limit() held the command short of its target.
+    [[nodiscard]] bool bound() const noexcept { return bound_; }
+    /// True iff the last limit() judged the wheels to be slipping (header note).
+    [[nodiscard]] bool slipping() const noexcept { return slipping_; }
+    /// (spin − motion) / spin as of the last limit(); 0 when the wheels spun too slowly to say.
+    [[nodiscard]] double slipRatio() const noexcept { return slipRatio_; }
+    /// The factor every limit is currently multiplied by, in [slipLimitScale, 1].
+    [[nodiscard]] double limitScale() const noexcept { return scale_; }
+    /// The configuration this limiter was built with.
+    [[nodiscard]] const CommandLimiterConfig& config() const noexcept { return cfg_; }
+
+private:
+    /// allowed / |requested|, or +inf when nothing is requested.
+    [[nodiscard]] static double ratio(double allowed, double requested) noexcept {
+        const double r = std::abs(requested);
+        return r > 0.0 ? allowed / r : std::numeric_limits<double>::infinity();
+    }
+
+    /// Measured motion, clamped into the pipeline's budgets in the pipeline's own order.
+    [[nodiscard]] static math::ChassisSpeeds seed(const math::ChassisSpeeds& motion,
+                                                  const LimiterBudget& b) {
+        auto finite = [](double v) { return std::isfinite(v) ? v : 0.0; };
+        double vx = finite(motion.vx().value());
+        double vy = finite(motion.vy().value());
+        const double w = std::clamp(finite(motion.omega().value()), -b.maxAngular, b.maxAngular);
+        const double norm = std::hypot(vx, vy);
+        if (norm > b.maxLinear) {
+            vx *= b.maxLinear / norm;
+            vy *= b.maxLinear / norm;
+        }
+        vy = std::clamp(vy, -b.maxStrafe, b.maxStrafe);
+        return math::ChassisSpeeds{units::Velocity{vx}, units::Velocity{vy},
+                                   units::AngularVelocity{w}};
+    }
+
+    /// Spin vs motion → slipping_, slipRatio_, and the limit scale's drop or recovery.
+    void judgeSlip(const LimiterObservation& seen, double dt) {
+        auto norm = [this](const math::ChassisSpeeds& c) {
+            return std::hypot(c.vx().value(), c.vy().value())
+                   + rotationRadius_ * std::abs(c.omega().value());
+        };
+        const double spin = norm(seen.spin);
+        const double motion = norm(seen.motion);
+        slipRatio_ = (std::isfinite(spin) && std::isfinite(motion)
+                      && spin >= cfg_.slipMinSpeed.value() && spin > 0.0)
+                         ? std::max(0.0, (spin - motion) / spin)
+                         : 0.0;
+        slipping_ = slipRatio_ > cfg_.slipThreshold;
+        if (slipping_) {
+            scale_ = std::min(scale_, cfg_.slipLimitScale);
+        } else {
+            scale_ = std::min(1.0, scale_ + (1.0 - cfg_.slipLimitScale) * dt
+                                                / cfg_.slipRecoveryTime);
+        }
+    }
+
+    CommandLimiterConfig cfg_;
+    hal::IClock& clock_;
+    double rotationRadius_;
+    math::ChassisSpeeds prev_{};
+    std::array<double, 3> accel_{};  ///< vx, vy, ω — last tick's applied acceleration
+    double lastTime_ = 0.0;
+    double scale_ = 1.0;
+    double slipRatio_ = 0.0;
+    bool hasPrev_ = false;
+    bool slipping_ = false;
+    bool bound_ = false;
+};
+
+}  // namespace shulib::motion
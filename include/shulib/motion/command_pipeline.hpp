@@ -30,9 +30,21 @@
 //      The strafeFallback flag reports when the clamp BOUND meaningfully
 //      (> kStrafeFallbackNoiseFraction·maxLinearSpeed removed — the C3
 //      telemetry-visibility contract; rationale at the constant below).
+//   4'. With a CommandLimiter passed in (and enabled): the body-frame
+//      acceleration/jerk limit, per axis and per wheel, scaled down while the
+//      drive encoders' spin outruns the estimate's motion (slip). It moves the
+//      command along the segment from last tick's, so every budget above still
+//      holds; disabled or null, the clamped command passes bit-identically
+//      (motion/command_limiter.hpp).
 //   5. IKinematics::toWheels — pure, unclamped inverse kinematics.
 //   6. IKinematics::desaturate(maxWheelSpeed) — the downstream uniform scale.
 //   7. Feedforward → compensateForBattery → IMotor::setVoltage, per wheel.
+//      With a WheelVelocityLoop passed in, step 7 becomes Feedforward → the inner
+//      per-wheel PI on encoder speed → compensateForBattery → setVoltage. The loop
+//      reads each drive motor's velocity() × cfg.stall.wheelRadius (the same shaft →
+//      surface conversion the stall check uses), and a DISABLED loop hands the
+//      feedforward back unchanged — bit-identical volts, errors still measured
+//      (control/wheel_velocity_loop.hpp).
 //
 // ── The D-5 self-audit (chunk C5; diag/plausibility_guard.hpp carries the why) ──────
 // After the clamps, the pipeline AUDITS its own output: the final body command
@@ -56,13 +68,19 @@
 // this function is the hot path and adds none of its own.
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <span>
 
 #include "shulib/control/feedforward.hpp"
+#include "shulib/control/wheel_velocity_loop.hpp"
+#include "shulib/diag/debug_record.hpp"
 #include "shulib/diag/plausibility_guard.hpp"
 #include "shulib/kinematics/wheel_speeds.hpp"
 #include "shulib/math/frame.hpp"
 #include "shulib/math/twist2d.hpp"
+#include "shulib/motion/command_limiter.hpp"
 #include "shulib/motion/motion.hpp"
 #include "shulib/motion/motion_config.hpp"
 #include "shulib/units/quantity.hpp"
@@ -94,13 +112,19 @@ struct CommandOutcome {
 /// Run the full choreography above and command the motors. `command` is
 /// expressed in `frame`; `heading` is the robot's current estimated heading
 /// (used only for the Field→Body rotation — pass the pose the caller already
-/// read this tick, so the whole tick acts on ONE snapshot).
+/// read this tick, so the whole tick acts on ONE snapshot). `wheelLoop`, when
+/// non-null, is the caller's inner per-wheel velocity loop (step 7, header note);
+/// null keeps the open-loop step 7 exactly as C1 wrote it. `limiter`, when non-null
+/// and enabled, is the caller's step-4' rate limiter; null or disabled skips it.
 [[nodiscard]] inline CommandOutcome applyCommandPipeline(const MotionDeps& deps,
                                                          const MotionConfig& cfg,
                                                          const control::Feedforward& ff,
                                                          const math::ChassisSpeeds& command,
                                                          math::Frame frame,
-                                                         math::Angle heading) {
+                                                         math::Angle heading,
+                                                         control::WheelVelocityLoop* wheelLoop =
+                                                             nullptr,
+                                                         CommandLimiter* limiter = nullptr) {
     // 1. ω clamp (frame-invariant).
     const double w = std::clamp(command.omega().value(), -cfg.maxAngularSpeed.value(),
                                 cfg.maxAngularSpeed.value());
@@ -130,28 +154,81 @@ struct CommandOutcome {
     const bool strafeFallback =
         std::abs(body.vy().value()) - vyLimit > kStrafeFallbackNoiseFraction * maxLin;
 
+    // 4'. the rate limiter (header note): spin from the drive encoders, motion from the
+    // estimate, both body frame. Skipped entirely unless enabled — bit-identical.
+    const auto motors = deps.ctx->driveMotors();
+    const double radius = cfg.stall.wheelRadius.value();
+    math::ChassisSpeeds bodyOut = bodyClamped;
+    if (limiter != nullptr && limiter->config().enabled) {
+        kinematics::WheelSpeeds spinWheels{deps.kinematics->wheelCount()};
+        for (int i = 0; i < spinWheels.size(); ++i) {
+            spinWheels.set(i, units::Velocity{
+                                  motors[static_cast<std::size_t>(i)]->velocity().value() * radius});
+        }
+        const math::Twist2d spin = deps.kinematics->forward(spinWheels);
+        const math::Twist2d moved = deps.localizer->twist();
+        const LimiterObservation seen{
+            .spin = math::ChassisSpeeds{spin.vx(), spin.vy(), spin.omega()},
+            .motion = math::fieldToRobot(
+                math::ChassisSpeeds{moved.vx(), moved.vy(), moved.omega()}, heading)};
+        bodyOut = limiter->limit(bodyClamped, seen, *deps.kinematics,
+                                 LimiterBudget{.maxLinear = maxLin,
+                                               .maxStrafe = vyLimit,
+                                               .maxAngular = cfg.maxAngularSpeed.value()});
+    }
+
     // D-5 invariant 2 (self-audit; header note): the clamps above make this a
     // pass-through — a false here is a pipeline regression, raised as IMPLAUSIBLE.
-    (void)diag::commandWithinCapability(bodyClamped, cfg.maxLinearSpeed,
+    (void)diag::commandWithinCapability(bodyOut, cfg.maxLinearSpeed,
                                         cfg.maxAngularSpeed, *deps.faults, "MOT");
 
     // 5–6. wheels: unclamped inverse kinematics, then the uniform desaturate.
-    kinematics::WheelSpeeds wheels = deps.kinematics->toWheels(bodyClamped);
+    kinematics::WheelSpeeds wheels = deps.kinematics->toWheels(bodyOut);
     wheels = deps.kinematics->desaturate(wheels, cfg.maxWheelSpeed);
 
     // 7. volts: feedforward, then the battery ceiling, per wheel — each volt
     // passed through the D-5 invariant-3 recovery (untouched when healthy; a
     // non-finite/over-ceiling volt is zeroed/clamped and raised, never commanded).
     const units::Voltage vb = deps.ctx->battery().voltage();
-    const auto motors = deps.ctx->driveMotors();
-    for (int i = 0; i < wheels.size(); ++i) {
-        const control::CompensatedVoltage cv =
-            control::compensateForBattery(ff.calculate(wheels[i]), vb);
-        motors[static_cast<std::size_t>(i)]->setVoltage(
-            diag::recoverWheelVoltage(cv.voltage, vb, *deps.faults, "MOT"));
+    if (wheelLoop == nullptr) {
+        for (int i = 0; i < wheels.size(); ++i) {
+            const control::CompensatedVoltage cv =
+                control::compensateForBattery(ff.calculate(wheels[i]), vb);
+            motors[static_cast<std::size_t>(i)]->setVoltage(
+                diag::recoverWheelVoltage(cv.voltage, vb, *deps.faults, "MOT"));
+        }
+        return CommandOutcome{.body = bodyOut, .strafeFallback = strafeFallback};
+    }
+
+    // 7'. the inner loop (header note): encoder surface speed against each wheel's target.
+    constexpr auto kCap = static_cast<std::size_t>(control::WheelVelocityLoop::kMaxWheels);
+    std::array<units::Velocity, kCap> target{};
+    std::array<units::Velocity, kCap> measured{};
+    std::array<units::Voltage, kCap> ffVolts{};
+    std::array<units::Voltage, kCap> volts{};
+    const auto n = static_cast<std::size_t>(wheels.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        target[i] = wheels[static_cast<int>(i)];
+        measured[i] = units::Velocity{motors[i]->velocity().value() * radius};
+        ffVolts[i] = ff.calculate(target[i]);
+    }
+    wheelLoop->update(std::span{target}.first(n), std::span{measured}.first(n),
+                      std::span{ffVolts}.first(n), vb, std::span{volts}.first(n));
+    for (std::size_t i = 0; i < n; ++i) {
+        const control::CompensatedVoltage cv = control::compensateForBattery(volts[i], vb);
+        motors[i]->setVoltage(diag::recoverWheelVoltage(cv.voltage, vb, *deps.faults, "MOT"));
     }
 
-    return CommandOutcome{.body = bodyClamped, .strafeFallback = strafeFallback};
+    return CommandOutcome{.body = bodyOut, .strafeFallback = strafeFallback};
+}
+
+/// Copy the inner loop's per-wheel tracking errors onto a record (DebugRecord::
+/// wheelSpeedError). Callers stamp it only on ticks that ran the pipeline, so an exit or
+/// waiting record never carries a stale error.
+inline void stampWheelTracking(diag::DebugRecord& r, const control::WheelVelocityLoop& loop) {
+    for (int i = 0; i < loop.wheelCount() && i < diag::DebugRecord::kMaxWheels; ++i) {
+        r.wheelSpeedError[static_cast<std::size_t>(i)] = loop.trackingError(i);
+    }
 }
 
 }  // namespace shulib::motion
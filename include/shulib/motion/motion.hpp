@@ -133,6 +133,7 @@
 #include "shulib/core/check.hpp"
 #include "shulib/diag/fault.hpp"
 #include "shulib/diag/health_monitor.hpp"
+#include "shulib/diag/tick_budget.hpp"
 #include "shulib/kinematics/kinematics.hpp"
 #include "shulib/localization/localizer.hpp"
 
@@ -180,6 +181,10 @@ struct MotionDeps {
     const kinematics::IKinematics* kinematics = nullptr;  ///< the F5 drivetrain contract
     diag::FaultLatch* faults = nullptr;               ///< run-scoped latch (MotionTimeout, …)
     diag::HealthMonitor* health = nullptr;            ///< the A3 pathology→fault policy
+    /// OPTIONAL load shedder (diag/tick_budget.hpp): when set, tickHealthObservables
+    /// decimates health while HealthCheck is shed. nullptr = never shed — NOT checked by
+    /// validate(). MotionScheduler fills it from its config; nothing else needs to.
+    const diag::TickBudget* budget = nullptr;
 
     /// Trip SHULIB_PRECONDITION on the FIRST null pointer, naming which one. Every motion
     /// calls this from its constructor (through validatedClock()), so a dependency the
@@ -220,7 +225,14 @@ struct MotionDeps {
 /// active motion feeds its OdoStallCheck verdict; idle/teleop callers pass
 /// false — nothing (or nothing closed-loop) is commanded, so there is no
 /// spin to cross-check (the DriveBrake-exemption reasoning).
+///
+/// Load shedding lands here for the same one-place reason: with a TickBudget in the
+/// deps and HealthCheck shed this tick, the whole health tick is skipped, so every
+/// caller decimates identically (tick_budget.hpp: decimated, never skipped outright).
 inline void tickHealthObservables(const MotionDeps& deps, bool odomStalled) {
+    if (deps.budget != nullptr && deps.budget->shed(diag::SheddableWork::HealthCheck)) {
+        return;
+    }
     chassis::RobotContext& ctx = *deps.ctx;
     localization::Localizer& loc = *deps.localizer;
     double maxTemp = 0.0;
@@ -44,7 +44,9 @@
 
 #include "shulib/control/feedforward.hpp"
 #include "shulib/control/settled_util.hpp"
+#include "shulib/control/wheel_velocity_loop.hpp"
 #include "shulib/core/check.hpp"
+#include "shulib/motion/command_limiter.hpp"
 #include "shulib/motion/odo_stall_check.hpp"
 #include "shulib/units/quantity.hpp"
 
@@ -118,16 +120,29 @@ struct MotionConfig {
     /// The spin-vs-motion cross-check thresholds (A4: HA-52).
     OdoStallCheckConfig stall{};
 
+    /// The optional inner per-wheel velocity loop (control/wheel_velocity_loop.hpp). OFF by
+    /// default: the pipeline stays open-loop per wheel, bit-for-bit. It converts encoder shaft
+    /// speed to surface speed with `stall.wheelRadius` — one drive-wheel radius for both.
+    /// PROVISIONAL (A4: HA-126).
+    control::WheelVelocityLoopConfig wheelLoop{};
+
+    /// The optional body-frame acceleration/jerk limiter with slip-reactive limits
+    /// (motion/command_limiter.hpp). OFF by default: no rate limit, bit-for-bit. It judges
+    /// slip with `rotationRadius` and reads encoder speed through `stall.wheelRadius`.
+    /// PROVISIONAL (A4: HA-127).
+    CommandLimiterConfig limiter{};
+
     /// Re-check the invariants the motions rely on and RAISE on the first violation:
-    /// feedforward and PID gains finite, integral limits non-negative, and all FIVE speed /
+    /// feedforward, PID and wheel-loop gains finite, integral limits non-negative, and all FIVE speed /
     /// timeout / geometry scalars strictly positive (maxLinearSpeed, maxAngularSpeed,
     /// maxWheelSpeed, defaultTimeout, rotationRadius — 0 is rejected, never read as
     /// "unset"). Every C1 motion calls this from its own constructor, so it is a backstop
     /// rather than a step you can forget — call it yourself only when validating a config
     /// you have not yet handed to a motion.
-    /// It deliberately does NOT descend into the SettleConfig or OdoStallCheckConfig
-    /// members: those are checked by SettledUtil and OdoStallCheck when the motion builds
-    /// them, which is the only place their own invariants are known.
+    /// It deliberately does NOT descend into the SettleConfig, OdoStallCheckConfig or
+    /// CommandLimiterConfig members: those are checked by SettledUtil, OdoStallCheck and
+    /// CommandLimiter when the motion builds them, which is the only place their own
+    /// invariants are known.
     void validate() const {
         auto finiteGains = [](const AxisGains& g) {
             return std::isfinite(g.kP) && std::isfinite(g.kI) && std::isfinite(g.kD)
@@ -138,6 +153,11 @@ struct MotionConfig {
                             "MotionConfig: wheelFf gains must be finite");
         SHULIB_PRECONDITION(finiteGains(translation), "MotionConfig: translation gains invalid");
         SHULIB_PRECONDITION(finiteGains(heading), "MotionConfig: heading gains invalid");
+        SHULIB_PRECONDITION(std::isfinite(wheelLoop.kP) && std::isfinite(wheelLoop.kI)
+                                && wheelLoop.kP >= 0.0 && wheelLoop.kI >= 0.0
+                                && std::isfinite(wheelLoop.correctionLimit.value())
+                                && wheelLoop.correctionLimit.value() >= 0.0,
+                            "MotionConfig: wheelLoop gains invalid");
         // FINITE and > 0, not merely > 0: infinity satisfies `> 0.0`, and an infinite
         // defaultTimeout builds a Watchdog that can never expire — which defeats the one
         // guarantee the watchdog exists to provide ("a motion can never hang", watchdog.hpp).
@@ -154,8 +174,8 @@ struct MotionConfig {
                             "MotionConfig: defaultTimeout must be finite and > 0");
         SHULIB_PRECONDITION(std::isfinite(rotationRadius.value()) && rotationRadius.value() > 0.0,
                             "MotionConfig: rotationRadius must be finite and > 0");
-        // SettleConfig / OdoStallCheckConfig fields are validated by their owners
-        // (SettledUtil / OdoStallCheck) at construction.
+        // SettleConfig / OdoStallCheckConfig / CommandLimiterConfig fields are validated by
+        // their owners (SettledUtil / OdoStallCheck / CommandLimiter) at construction.
     }
 };
 
@@ -15,6 +15,7 @@
 //
 //     localizer.update();          // the estimate advances FIRST (sees time t)
 //     loopMonitor.tick();          // timing pathology → LOOP_OVERRUN, visibly
+//     tickBudget.observe(cost);    // optional: decide what this tick SHEDS
 //     active ? active->tick()      // the motion reads the world and commands
 //            : idle work;          // no motion: HealthMonitor + an idle record
 //     <the world advances to t+dt> // via the injected ITickPacer (below)
@@ -158,7 +159,9 @@
 // skips record population entirely. Idle ticks emit a quiet record (no
 // invented target) so the stream stays continuous between motions; motion
 // boundaries surface as CompletedMotion + per-exit counters, NOT as formatted
-// result lines — that formatting is C5's, deliberately not built here.
+// result lines — that formatting is C5's, deliberately not built here. With an
+// EventRing configured, the same boundaries (and the gate's accept/reject flips)
+// are also recorded as 16-byte events that outlive the tick ring (event_ring.hpp).
 //
 // Single-task by contract, like everything it composes. Not copyable/movable:
 // it holds a self-referential context (the stamped telemetry route).
@@ -173,10 +176,14 @@
 #include "shulib/control/exit_group.hpp"
 #include "shulib/core/check.hpp"
 #include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/decimating_sink.hpp"
+#include "shulib/diag/event_ring.hpp"
 #include "shulib/diag/fault.hpp"
 #include "shulib/diag/loop_monitor.hpp"
 #include "shulib/diag/plausibility_guard.hpp"
 #include "shulib/diag/tick_attribution.hpp"
+#include "shulib/diag/zone_profiler.hpp"
+#include "shulib/diag/tick_budget.hpp"
 #include "shulib/hal/telemetry_sink.hpp"
 #include "shulib/motion/motion.hpp"
 #include "shulib/units/quantity.hpp"
@@ -249,6 +256,33 @@ struct MotionSchedulerConfig {
     /// episode-gated — plausibility_guard.hpp). Defaults are generous physical
     /// upper bounds (PROVISIONAL, A4: HA-56).
     diag::PlausibilityConfig plausibility{};
+
+    /// Load shedding (diag/tick_budget.hpp). nullptr = OFF — nothing is ever shed, and
+    /// the tick is exactly what it was without one. When set, the scheduler observe()s
+    /// it once per tick right after the loop monitor (attribution's measured work when
+    /// D-3 is on, else the measured dt), logs each level change, and routes it into
+    /// deps() so health is decimated for every motion. Its budget must EQUAL
+    /// loopMonitor.budget (precondition) — one deadline, two instruments. Caller-owned,
+    /// so the sinks that shed (RateLimitedSink, SdSink) can be pointed at it too; must
+    /// outlive the scheduler.
+    diag::TickBudget* tickBudget = nullptr;
+
+    /// Nested zone profiling (diag/zone_profiler.hpp). nullptr = OFF; with SHULIB_ENABLE_ZONES
+    /// undefined the zones are compiled out and this is never read. When set, every tick opens
+    /// a root zone "loc" around localization and "mot" around the motion (or idle) phase —
+    /// the same spans as TickAttribution's phases — so a Localizer given the same profiler
+    /// (Localizer::setProfiler) nests its zones under "loc". RunReporter copies the table into
+    /// the run summary. Needs a clock that advances during a tick, as attributionClock does.
+    /// Must outlive the scheduler.
+    diag::ZoneProfiler* profiler = nullptr;
+
+    /// Transition recorder (diag/event_ring.hpp). nullptr = OFF. When set, the scheduler
+    /// records MotionStart and MotionExit at every motion boundary, and a GateChange each
+    /// time the fusion gate flips between accepting and rejecting fixes — ticks with no
+    /// verdict (no proposal, no fix, a fix already folded) leave the last verdict standing.
+    /// Hand the same ring to the FaultLatch and HealthMonitor for the rest of the story.
+    /// Must outlive the scheduler.
+    diag::EventRing* events = nullptr;
 };
 
 /// ITelemetrySink decorator that stamps DebugRecord.activeCommandId with the
@@ -283,6 +317,10 @@ struct MotionSchedulerConfig {
 /// Honest scope: the stamped fault is the most recent fault raised during this tick
 /// BEFORE this record was emitted — a fault raised later in the same tick lands on the
 /// next record. The FaultLatch remains the authority on the first-fault root cause.
+///
+/// It also stamps the estimator's raw INPUTS (Localizer::lastInputs()) for the same
+/// reason: every record passes through here, so every record of a scheduled run can be
+/// fed back through the estimator offline (sim/estimator_replay.hpp).
 class CommandIdStampSink final : public hal::ITelemetrySink {
 public:
     /// `faults` (optional) supplies the per-tick fault stamp; nullptr disables it.
@@ -297,14 +335,17 @@ public:
         inner_->log(level, subsystem, message);
     }
 
+    /// Pass-through, unstamped and still packed, like log().
+    void logDeferred(const diag::DeferredLog& line) override { inner_->logDeferred(line); }
+
     /// Forwards the inner sink's answer — the A1 pair rule. A NullSink run therefore
     /// still skips record population entirely, and this decorator costs one bool query.
     [[nodiscard]] bool wantsRecord() const noexcept override { return inner_->wantsRecord(); }
 
     /// Stamp one record and forward it: the command id (UNCONDITIONALLY — this scheduler
     /// is the id assigner, so an incoming nonzero id is a bug, not information), the last
-    /// completed tick's phase breakdown, the estimator's gate audit, and — only if the
-    /// producer left it None — the fault raised so far this tick. Costs one DebugRecord
+    /// completed tick's phase breakdown, the estimator's gate audit and raw inputs, and —
+    /// only if the producer left it None — the fault raised so far this tick. Costs one DebugRecord
     /// copy, paid only when a sink downstream actually wants records.
     void emit(const diag::DebugRecord& record) override {
         diag::DebugRecord stamped = record;
@@ -321,6 +362,9 @@ public:
         stamped.gateMahalanobis = audit_.audit.mahalanobis;
         stamped.covarianceTrace = audit_.audit.covarianceTrace;
         stamped.gateReason = audit_.audit.reason;
+        if (hasInputs_) {
+            localization::stampEstimatorInputs(stamped, inputs_);
+        }
         if (stamped.fault == diag::FaultCode::None) {
             stamped.fault = tickFault();
         }
@@ -354,12 +398,27 @@ public:
         audit_ = audit;
     }
 
+    /// The raw readings the tick just localized consumed (Localizer::lastInputs()), stamped
+    /// onto every subsequent record so the run can be replayed offline. The scheduler calls
+    /// this beside setEstimatorAudit(); until the first call, records carry none.
+    void setEstimatorInputs(const localization::EstimatorInputs& inputs) noexcept {
+        inputs_ = inputs;
+        hasInputs_ = true;
+    }
+
     /// Open a new tick for the fault stamp: everything raised from here on belongs to
     /// this tick. Cheap (one counter read) and a no-op without a latch.
     void beginTick() noexcept {
         faultsAtTickStart_ = faults_ != nullptr ? faults_->faultCount() : 0;
     }
 
+    /// The key fields (diag/decimating_sink.hpp) this sink would stamp onto a record emitted
+    /// now: the id, the gate reason and the tick's fault. commandState is left 0 — the
+    /// producer owns it, and MotionScheduler's probe fills it from the active motion.
+    [[nodiscard]] diag::RecordKeys stampedKeys() const noexcept {
+        return diag::RecordKeys{id_, 0, audit_.audit.reason, tickFault()};
+    }
+
 private:
     /// The fault raised during this tick so far, or None (header note).
     [[nodiscard]] diag::FaultCode tickFault() const noexcept {
@@ -374,6 +433,8 @@ private:
     std::uint32_t id_ = 0;
     std::array<units::Time, static_cast<std::size_t>(diag::kTickPhaseSlots)> phases_{};
     localization::AppliedCorrection audit_{};
+    localization::EstimatorInputs inputs_{};
+    bool hasInputs_ = false;
     int faultsAtTickStart_ = 0;
 };
 
@@ -416,6 +477,9 @@ public:
         inner_->log(level, subsystem, message);
     }
 
+    /// Pass-through, still packed, like log().
+    void logDeferred(const diag::DeferredLog& line) override { inner_->logDeferred(line); }
+
     /// Forwards the inner sink's answer, which is also the honest limit of this sink:
     /// behind a sink that wants no records, nothing is ever aggregated, hasData() stays
     /// false, and the derived result-line fields render "n/a" rather than a made-up 0.
@@ -613,12 +677,19 @@ public:
                                 .localizer = deps.localizer,
                                 .kinematics = deps.kinematics,
                                 .faults = deps.faults,
-                                .health = deps.health}},
+                                .health = deps.health,
+                                .budget = config.tickBudget != nullptr ? config.tickBudget
+                                                                       : deps.budget}},
           loopMonitor_{deps.ctx->clock(), *deps.faults, config.loopMonitor},
           poseGuard_{config.plausibility} {
         if (cfg_.attributionClock != nullptr) {
             att_.emplace(*cfg_.attributionClock);  // absent = off = zero cost (D-3)
         }
+        SHULIB_PRECONDITION(cfg_.tickBudget == nullptr
+                                || cfg_.tickBudget->budget().value()
+                                       == cfg_.loopMonitor.budget.value(),
+                            "MotionScheduler: tickBudget's budget must equal "
+                            "loopMonitor.budget");
     }
 
     /// Neither copyable nor movable, and not by taste: the context this scheduler hands
@@ -692,6 +763,9 @@ public:
         active_ = &motion;
         currentId_ = ++idCounter_;
         stamperSink_.setActiveId(currentId_);
+        if (cfg_.events != nullptr) {
+            cfg_.events->record(diag::EventKind::MotionStart, 0, 0, currentId_);
+        }
         statsHolder_.sink.beginMotion();  // fresh result-line aggregates (C5)
         activeStart_ = schedDeps_.ctx->clock().now();
         snapshotFaultCounts();
@@ -891,6 +965,25 @@ public:
         return att_.has_value() ? &*att_ : nullptr;
     }
 
+    /// The zone profiler this scheduler opens its "loc"/"mot" zones on
+    /// (MotionSchedulerConfig::profiler), or nullptr when profiling is off.
+    [[nodiscard]] const diag::ZoneProfiler* profiler() const noexcept { return cfg_.profiler; }
+
+    /// The load shedder this scheduler feeds (MotionSchedulerConfig::tickBudget), or
+    /// nullptr when shedding is off. The caller's vision loop consults
+    /// `shed(SheddableWork::VisionPoll)` through this before polling.
+    [[nodiscard]] const diag::TickBudget* tickBudget() const noexcept { return cfg_.tickBudget; }
+
+    /// What the next record emitted through this scheduler will carry in its key fields —
+    /// the probe a DecimatingSink needs to skip record population on quiet ticks
+    /// (diag/decimating_sink.hpp). The id, gate reason and fault come from the stamp this
+    /// scheduler applies; the state from the active motion's state(), which every motion
+    /// writes into its record (0 between motions, as the idle and drive records carry).
+    /// Lives as long as the scheduler.
+    [[nodiscard]] const diag::IRecordKeyProbe& recordKeyProbe() const noexcept {
+        return keyProbe_;
+    }
+
     /// Consecutive pace() calls that may fail to advance the clock before the
     /// scheduler declares the pacer broken (header: nothing may hang). Pure
     /// logic constant — no hardware claim, hence no register entry.
@@ -1008,11 +1101,14 @@ private:
         stamperSink_.beginTick();
         {
             const auto phaseScope = phase(diag::TickPhase::Localization);
+            SHULIB_ZONE(cfg_.profiler, "loc");
             schedDeps_.localizer->update();
         }
         // E1: the estimator's account of the tick just localized, stamped onto every
         // record this tick emits (motion or idle) — see CommandIdStampSink's header.
         stamperSink_.setEstimatorAudit(schedDeps_.localizer->lastCorrection());
+        stamperSink_.setEstimatorInputs(schedDeps_.localizer->lastInputs());
+        recordGateVerdict(schedDeps_.localizer->lastCorrection().audit.reason);
         const units::Time dt = loopMonitor_.tick();
         // D-3 payoff: when this tick's dt says the PREVIOUS tick overran
         // (LoopMonitor just raised), name who consumed it — the last completed
@@ -1029,6 +1125,7 @@ private:
                           diag::tickPhaseName(att_->lastWorstPhase()));
             schedDeps_.ctx->telemetry().log(hal::LogLevel::Warn, "SCH", buf);
         }
+        observeTickBudget(dt);
         // D-5 invariant 1: the estimate must move like a robot, not a glitch.
         // Advisory (never rewrites the pose), episode-gated, dt-scaled. NOT
         // judged during the boot window: while Uninitialized the published
@@ -1047,6 +1144,7 @@ private:
         }
         if (active_ == nullptr) {
             const auto phaseScope = phase(diag::TickPhase::Motion);
+            SHULIB_ZONE(cfg_.profiler, "mot");
             tickIdleHealth();
             emitIdleRecord(schedDeps_.ctx->clock().now(), dt);
             return;
@@ -1055,6 +1153,7 @@ private:
         control::ExitReason reason = control::ExitReason::Running;
         try {
             const auto phaseScope = phase(diag::TickPhase::Motion);
+            SHULIB_ZONE(cfg_.profiler, "mot");
             reason = active_->tick();
         } catch (const PreconditionError& e) {
             // The task-boundary conversion check.hpp promises (header note).
@@ -1082,6 +1181,22 @@ private:
         }
     }
 
+    /// GateChange on a flip between an accepting and a rejecting verdict (config note).
+    void recordGateVerdict(diag::GateReason reason) noexcept {
+        if (cfg_.events == nullptr || reason == diag::GateReason::None
+            || reason == diag::GateReason::RejectedNoFix
+            || reason == diag::GateReason::RejectedStaleFix) {
+            return;
+        }
+        const bool accepted = reason == diag::GateReason::Accepted;
+        const bool wasAccepted = lastVerdict_ == diag::GateReason::Accepted;
+        if (lastVerdict_ == diag::GateReason::None || accepted != wasAccepted) {
+            cfg_.events->record(diag::EventKind::GateChange, static_cast<std::uint8_t>(reason),
+                                static_cast<std::uint16_t>(lastVerdict_));
+        }
+        lastVerdict_ = reason;
+    }
+
     void finalize(control::ExitReason exit, diag::FaultCode abortFault,
                   bool preempted = false) {
         const MotionStatsSink& stats = statsHolder_.sink;
@@ -1101,6 +1216,10 @@ private:
                                 .overshoot = hasData ? stats.overshoot() : units::Length{0.0},
                                 .drift = hasData ? stats.drift() : units::AngleDim{0.0}};
         lastExit_ = exit;
+        if (cfg_.events != nullptr) {
+            cfg_.events->record(diag::EventKind::MotionExit, static_cast<std::uint8_t>(exit),
+                                static_cast<std::uint16_t>(abortFault), last_.id);
+        }
         switch (exit) {
             case control::ExitReason::Settled: ++settledCount_; break;
             case control::ExitReason::TimedOut: ++timedOutCount_; break;
@@ -1156,6 +1275,38 @@ private:
         return diag::FaultCode::None;
     }
 
+    /// Feed the load shedder this tick's cost, BEFORE any optional work runs, and say
+    /// so when the level moves: escalation is a Warn (the loop is degrading on purpose
+    /// and the terminal must show it), recovery an Info. Cost = the last completed
+    /// tick's measured work when attribution is on — the margin is visible before an
+    /// overrun — else the measured dt. The baseline tick (dt 0, nothing measured) feeds
+    /// nothing rather than a fabricated zero.
+    void observeTickBudget(units::Time dt) {
+        diag::TickBudget* budget = cfg_.tickBudget;
+        if (budget == nullptr) {
+            return;
+        }
+        units::Time cost = dt;
+        if (att_.has_value() && att_->hasCompletedTick()) {
+            cost = att_->lastTotal();
+        } else if (dt.value() <= 0.0) {
+            return;
+        }
+        const int before = budget->level();
+        budget->observe(cost);
+        const int after = budget->level();
+        if (after == before) {
+            return;
+        }
+        char buf[96];
+        std::snprintf(buf, sizeof buf, "load shed: level %d→%d (cost %.1fms · budget %.1fms)",
+                      before, after, budget->smoothedCost().value() * 1000.0,
+                      budget->budget().value() * 1000.0);
+        schedDeps_.ctx->telemetry().log(after > before ? hal::LogLevel::Warn
+                                                       : hal::LogLevel::Info,
+                                        "SCH", buf);
+    }
+
     /// Between motions the scheduler owns the HealthMonitor (C1's named
     /// handoff): every observable it can reach, with odomStalled = false —
     /// nothing is commanded, so there is no spin to cross-check (the same
@@ -1236,11 +1387,30 @@ private:
     double runMaxDriftRad_ = 0.0;
     double runFinalDriftRad_ = 0.0;
     bool runHasHeadingData_ = false;
+    diag::GateReason lastVerdict_ = diag::GateReason::None;  // last gate verdict (events)
 
     bool inTick_ = false;
     bool inWait_ = false;
     bool inBoundary_ = false;  // observer callback in progress (re-entrancy guard)
     int stalledPaces_ = 0;
+
+    // recordKeyProbe()'s implementation; a back-pointer is safe because the scheduler is
+    // neither copyable nor movable.
+    class KeyProbe final : public diag::IRecordKeyProbe {
+    public:
+        explicit KeyProbe(const MotionScheduler& s) noexcept : s_{&s} {}
+        [[nodiscard]] diag::RecordKeys peek() const noexcept override {
+            diag::RecordKeys k = s_->stamperSink_.stampedKeys();
+            if (s_->active_ != nullptr) {
+                k.commandState = static_cast<std::uint8_t>(s_->active_->state());
+            }
+            return k;
+        }
+
+    private:
+        const MotionScheduler* s_;
+    };
+    KeyProbe keyProbe_{*this};
 };
 
 }  // namespace shulib::motion
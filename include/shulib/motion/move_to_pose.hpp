@@ -54,10 +54,12 @@
 #include "shulib/control/pid.hpp"
 #include "shulib/control/settled_util.hpp"
 #include "shulib/control/watchdog.hpp"
+#include "shulib/control/wheel_velocity_loop.hpp"
 #include "shulib/diag/debug_record.hpp"
 #include "shulib/math/frame.hpp"
 #include "shulib/math/pose2d.hpp"
 #include "shulib/math/twist2d.hpp"
+#include "shulib/motion/command_limiter.hpp"
 #include "shulib/motion/command_pipeline.hpp"
 #include "shulib/motion/motion.hpp"
 #include "shulib/motion/motion_config.hpp"
@@ -100,6 +102,8 @@ public:
         pidX_.reset();
         pidY_.reset();
         pidH_.reset();
+        wheelLoop_.reset();
+        limiter_.reset();
         settledTrans_.reset();
         settledHead_.reset();
         stall_.reset();
@@ -217,7 +221,7 @@ public:
             deps_, cfg_, ff_,
             math::ChassisSpeeds{units::Velocity{vxF}, units::Velocity{vyF},
                                 units::AngularVelocity{w}},
-            math::Frame::Field, pose.heading());
+            math::Frame::Field, pose.heading(), &wheelLoop_, &limiter_);
 
         // ── A3 containment: stall cross-check + health observables ────────────
         const auto motors = ctx.driveMotors();
@@ -229,6 +233,7 @@ public:
             diag::DebugRecord r = baseRecord(ctx, loc, now, dt, pose, errX, errY, errH);
             r.commanded = math::robotToField(cmd.body, pose.heading());
             r.strafeFallbackActive = cmd.strafeFallback;  // C3 — never silent (TermSink "SFB")
+            stampWheelTracking(r, wheelLoop_);
             for (std::size_t i = 0; i < motors.size()
                                     && i < static_cast<std::size_t>(diag::DebugRecord::kMaxWheels);
                  ++i) {
@@ -311,6 +316,8 @@ protected:
           pidY_{pidConfig(config.translation), deps.ctx->clock()},
           pidH_{pidConfig(config.heading), deps.ctx->clock()},
           ff_{config.wheelFf},
+          wheelLoop_{config.wheelLoop, deps.ctx->clock()},
+          limiter_{config.limiter, deps.ctx->clock(), config.rotationRadius},
           settledTrans_{config.translationSettle, deps.ctx->clock()},
           settledHead_{config.headingSettle, deps.ctx->clock()},
           watchdog_{options.holdFor > 0.0
@@ -450,6 +457,8 @@ protected:
     control::Pid pidY_;  // FIELD y: inches → in/s
     control::Pid pidH_;  // heading: radians → rad/s
     control::Feedforward ff_;
+    control::WheelVelocityLoop wheelLoop_;  // inner per-wheel loop (off unless cfg enables it)
+    CommandLimiter limiter_;                // step-4' rate limiter (off unless cfg enables it)
     control::SettledUtil settledTrans_;
     control::SettledUtil settledHead_;
     control::Watchdog watchdog_;
@@ -42,9 +42,11 @@
 // recommended wiring never puts them there.)
 //
 // ── What the summary reads, and one-run scope ───────────────────────────────────────
-// Counters/latch/health/battery are read LIVE at finishRun() from the scheduler
-// and its deps (battery END is a reading, not a memory). Scheduler counters are
-// lifetime-cumulative and FaultLatch clears only at explicit run boundaries, so:
+// Counters/latch/health/battery/load-shed tallies and the tick-timing
+// distributions (loop dt; per phase when attribution is on; per zone when a profiler
+// is attached) are read LIVE at finishRun() from the scheduler and its deps (battery END
+// is a reading, not a memory). Scheduler counters are lifetime-cumulative and FaultLatch
+// clears only at explicit run boundaries, so:
 // ONE reporter + ONE scheduler per run — the normal auton shape. gatingRejects
 // counts GPS_GATE_REJECT raises (HealthMonitor raises once per EPISODE, so this
 // is episodes, not raw rejected fixes — honest label, E2 refines it).
@@ -52,6 +54,8 @@
 // Single-task by contract, like everything it composes. Never throws into the
 // scheduler (IMotionObserver contract): it only formats and logs.
 
+#include <cstddef>
+#include <cstdint>
 #include <string_view>
 
 #include "shulib/diag/motion_result.hpp"
@@ -59,6 +63,8 @@
 #include "shulib/diag/run_summary.hpp"
 #include "shulib/diag/sd_sink.hpp"
 #include "shulib/diag/session_info.hpp"
+#include "shulib/diag/tick_attribution.hpp"
+#include "shulib/diag/tick_budget.hpp"
 #include "shulib/diag/triage.hpp"
 #include "shulib/motion/motion_scheduler.hpp"
 
@@ -163,6 +169,16 @@ public:
         s.gatingRejects = faults.raiseCount(diag::FaultCode::GpsGateReject);
         s.brownout = sched_->deps().health->brownedOut();
         s.worstLoopDt = sched_->loopMonitor().worstDt();
+        s.loopDt = sched_->loopMonitor().dtHistogram().stats();
+        if (const diag::TickAttribution* att = sched_->attribution(); att != nullptr) {
+            for (std::size_t i = 0; i < s.phaseTiming.size(); ++i) {
+                s.phaseTiming[i] = att->phaseHistogram(static_cast<diag::TickPhase>(i)).stats();
+            }
+        }
+        if (const diag::ZoneProfiler* prof = sched_->profiler(); prof != nullptr) {
+            s.zoneCount = static_cast<std::uint32_t>(prof->snapshot(s.zones));
+            s.zonesRefused = prof->refusedScopes();
+        }
         s.firstFault = faults.firstFault();
         s.firstFaultTime = faults.firstFaultTime();
         if (limiter_ != nullptr) {
@@ -172,6 +188,15 @@ public:
         if (blackbox_ != nullptr) {
             s.blackboxDropped = blackbox_->droppedFrames();
         }
+        if (const diag::TickBudget* budget = sched_->tickBudget(); budget != nullptr) {
+            s.hasLoadShedData = true;
+            for (std::size_t i = 0; i < s.shedTicks.size(); ++i) {
+                s.shedTicks[i] = budget->shedTicks(static_cast<diag::SheddableWork>(i));
+            }
+            s.shedTicksObserved = budget->ticksObserved();
+            s.shedEscalations = budget->escalations();
+            s.shedMaxLevel = budget->maxLevel();
+        }
         s.batteryStart = batteryStart_;
         s.batteryEnd = sched_->deps().ctx->battery().voltage();
         out_->summarize(s);
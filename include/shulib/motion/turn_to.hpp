@@ -25,10 +25,12 @@
 #include "shulib/control/exit_group.hpp"
 #include "shulib/control/feedforward.hpp"
 #include "shulib/control/pid.hpp"
+#include "shulib/control/wheel_velocity_loop.hpp"
 #include "shulib/diag/debug_record.hpp"
 #include "shulib/math/frame.hpp"
 #include "shulib/math/pose2d.hpp"
 #include "shulib/math/twist2d.hpp"
+#include "shulib/motion/command_limiter.hpp"
 #include "shulib/motion/command_pipeline.hpp"
 #include "shulib/motion/motion.hpp"
 #include "shulib/motion/motion_config.hpp"
@@ -57,6 +59,8 @@ public:
                                    .integralLimit = config.heading.integralLimit},
                 deps.validatedClock()},
           ff_{config.wheelFf},
+          wheelLoop_{config.wheelLoop, deps.ctx->clock()},
+          limiter_{config.limiter, deps.ctx->clock(), config.rotationRadius},
           exit_{config.headingSettle, timeout > 0.0 ? timeout : config.defaultTimeout,
                 deps.ctx->clock()},
           stall_{config.stall} {
@@ -76,6 +80,8 @@ public:
     /// estimator.
     void start() override {
         pidH_.reset();
+        wheelLoop_.reset();
+        limiter_.reset();
         stall_.reset();
         exit_.start();
         reason_ = control::ExitReason::Running;
@@ -150,14 +156,14 @@ public:
             deps_, cfg_, ff_,
             math::ChassisSpeeds{units::Velocity{0.0}, units::Velocity{0.0},
                                 units::AngularVelocity{w}},
-            math::Frame::Body, pose.heading());
+            math::Frame::Body, pose.heading(), &wheelLoop_, &limiter_);
 
         // A3 containment wiring
         const auto motors = ctx.driveMotors();
         const bool stalled = stall_.update(now, motors, pose);
         tickHealthObservables(deps_, stalled);
 
-        emitRecordFor(now, dt, pose, errH, cmd.body);  // body == field for pure ω
+        emitRecordFor(now, dt, pose, errH, cmd.body, true);  // body == field for pure ω
         return control::ExitReason::Running;
     }
 
@@ -214,8 +220,10 @@ private:
         return reason_;
     }
 
+    /// `piped` marks a tick that ran the command pipeline — the only records that carry the
+    /// inner loop's wheel tracking errors.
     void emitRecordFor(units::Time now, units::Time dt, const math::Pose2d& pose, double errH,
-                       const math::ChassisSpeeds& commanded) {
+                       const math::ChassisSpeeds& commanded, bool piped = false) {
         chassis::RobotContext& ctx = *deps_.ctx;
         const localization::Localizer& loc = *deps_.localizer;
         hal::emitRecord(ctx.telemetry(), [&] {
@@ -234,6 +242,9 @@ private:
                 r.wheelVoltage[i] = motors[i]->commandedVoltage();
                 r.wheelCurrent[i] = motors[i]->current();
             }
+            if (piped) {
+                stampWheelTracking(r, wheelLoop_);
+            }
             r.imuYaw = ctx.imu().heading();
             r.imuYawRate = ctx.imu().yawRate();
             r.activeCommandState = static_cast<std::uint8_t>(state_);
@@ -250,6 +261,8 @@ private:
     math::Angle target_;
     control::Pid pidH_;
     control::Feedforward ff_;
+    control::WheelVelocityLoop wheelLoop_;  // inner per-wheel loop (off unless cfg enables it)
+    CommandLimiter limiter_;                // step-4' rate limiter (off unless cfg enables it)
     control::ExitGroup exit_;
     OdoStallCheck stall_;
     control::ExitReason reason_ = control::ExitReason::Running;
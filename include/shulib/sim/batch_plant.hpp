@@ -0,0 +1,496 @@
+#pragma once
+//
+// sim::BatchPlant — N DrivePlants' physics in one object, stepped together. Every robot's
+// state lives in structure-of-arrays form and each stage of the tick is one loop over ROBOTS
+// innermost, so a parameter sweep or a Monte-Carlo batch pays one pass per stage instead of
+// N plants each dispatching through fakes, seams and a record builder.
+//
+// ── Bit-identical to DrivePlant, per robot ──────────────────────────────────────────
+// Robot r is DrivePlant(kin, …, robots[r].plant) under robots[r].degradation (the identity
+// when null) with the same tracking-wheel geometry: given the same voltages and dt schedule,
+// truthState(), trueBodyTwist(), trueWheelSpin() and readings() agree BIT FOR BIT every tick
+// (sim_batch_plant_test.cpp pins it against SimHarness). That holds because each stage does
+// DrivePlant's arithmetic in DrivePlant's order, only over arrays:
+//   * MOTOR — MotorModel::advance restated: the steady-state inversion, then the exponential
+//     approach. e^(−dt·kV/kA) depends only on a robot's gains and dt, so it is computed once
+//     per robot whenever dt changes, not once per wheel per tick.
+//   * KINEMATICS — MatrixKinematics::forwardBatch (forward()'s sums in forward()'s order,
+//     drivetrains innermost) when the constructor is handed a MatrixKinematics; any other
+//     IKinematics falls back to one forward() call per robot.
+//   * TRUTH — under the default TruthIntegrator::Adaptive, every robot whose tick the
+//     Gauss–Legendre path covers (truthQuadratureCovers: driving straight, a heading hold)
+//     takes that step in one pass over robots — the same two functions advanceTruthAdaptive
+//     calls, so the same bits. The rest run advanceTruthAdaptive one robot at a time: their
+//     Dormand–Prince step counts are each robot's own, so there is no lockstep to share, and
+//     a batch of turning robots gains nothing at this stage. Under FixedRk4, advanceTruth's
+//     expressions substep by substep, robots innermost. One saving there is exact: a
+//     substep's start heading IS the previous substep's end heading, so its cos/sin are
+//     carried over rather than recomputed, and a heading that did not move at all (ω == 0,
+//     driving straight) reuses them for every stage — libm returns the same bits for the
+//     same argument, so neither saving can move a result.
+//   * TIME — one FakeClock, advanced exactly as DrivePlant advances its own.
+//
+// ── Hostility ───────────────────────────────────────────────────────────────────────
+// Each robot owns an Rng seeded from its config.seed, as DrivePlant seeds its one. A robot
+// with a DegradationModel leaves the array path for its seams and calls them in DrivePlant's
+// order — per wheel effectiveVoltage, advance, wheelMotionVelocity; the sensor seams after
+// the pose — because the draw ORDER is part of the stream: batching one robot's draws across
+// its wheels would hand every hook a different number. The sensor seams run even though a
+// batch has no fakes to push into (their results are kept for readings()) for the same
+// reason: a skipped IMU-noise draw would shift every slip draw after it. Identity robots never
+// touch a seam; their readings() are derived from truth on demand.
+//
+// NOT produced, on purpose: DebugRecords (a batch has no sink — a robot worth a trace is
+// re-run in a SimHarness, which the identity above makes exact) and fakes (code under test
+// still runs against a DrivePlant; a batch serves sweeps that read truth). Tracking-wheel
+// geometry is shared by every robot (TrackingWheelSpec::sensor is ignored and may be null),
+// and so is the truth integrator (with truthSubsteps — the RK4 loop runs in lockstep).
+// A batch is the KINEMATIC plant's: a RigidBody robot (rigid_body.hpp) is refused, and so
+// is one on a field (field_geometry.hpp) — contact runs in a DrivePlant.
+//
+// Identity assumes both paths are compiled alike: a toolchain that contracts a·b + c into an
+// FMA in the batch loops but not in DrivePlant's (-ffp-contract=fast on an FMA target) can
+// differ in the last ulp — the same class of caveat as DrivePlant's cross-libm note. The host
+// suite targets no FMA. Single-task; allocates at construction only.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <vector>
+
+#include "shulib/core/check.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/hal/motor.hpp"
+#include "shulib/kinematics/kinematics.hpp"
+#include "shulib/kinematics/matrix_kinematics.hpp"
+#include "shulib/kinematics/wheel_speeds.hpp"
+#include "shulib/math/angle.hpp"
+#include "shulib/math/pose2d.hpp"
+#include "shulib/math/twist2d.hpp"
+#include "shulib/sim/degradation.hpp"
+#include "shulib/sim/drive_plant.hpp"
+#include "shulib/sim/motor_model.hpp"
+#include "shulib/sim/rng.hpp"
+#include "shulib/sim/truth_integrator.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::sim {
+
+/// One robot of a batch: the DrivePlant it stands for.
+struct BatchRobot {
+    /// Its gains, start pose, nominal sensor values and seed — DrivePlantConfig's meaning.
+    DrivePlantConfig plant{};
+    /// Its A3 model, NON-OWNING (must outlive the batch); nullptr is the identity, and keeps
+    /// the robot on the array path.
+    DegradationModel* degradation = nullptr;
+};
+
+/// What a robot's sensors would read this tick — the values DrivePlant pushes into its fakes,
+/// each through the robot's seam.
+struct BatchReadings {
+    math::Angle imuHeading{};                  ///< FakeImu::heading()
+    units::AngularVelocity imuYawRate{};       ///< FakeImu::yawRate()
+    bool imuReady = true;                      ///< FakeImu::isReady()
+    /// FakeMotor::position() per drive wheel, in the drivetrain's wheel order.
+    std::array<units::AngleDim, static_cast<std::size_t>(kinematics::WheelSpeeds::kMaxWheels)>
+        driveEncoder{};
+    /// FakeRotation::position() per tracking wheel, in the constructor's order.
+    std::array<units::AngleDim, static_cast<std::size_t>(DrivePlant::kMaxTrackingWheels)>
+        trackingEncoder{};
+    GpsTruth gps{};                            ///< FakeGps pose, rms and fix
+    units::Voltage batteryVoltage{};           ///< FakeBattery::voltage()
+};
+
+/// N DrivePlants' physics in structure-of-arrays form (header). Holds the kinematics and every
+/// robot's DegradationModel by NON-OWNING reference. Single-task.
+class BatchPlant {
+public:
+    /// The vectorised-kinematics form: `kinematics` must outlive the batch.
+    BatchPlant(const kinematics::MatrixKinematics& kinematics, std::span<const BatchRobot> robots,
+               std::span<const TrackingWheelSpec> trackingWheels = {})
+        : BatchPlant(kinematics, &kinematics, robots, trackingWheels) {}
+
+    /// Any other drivetrain: one forward() call per robot per tick.
+    BatchPlant(const kinematics::IKinematics& kinematics, std::span<const BatchRobot> robots,
+               std::span<const TrackingWheelSpec> trackingWheels = {})
+        : BatchPlant(kinematics, nullptr, robots, trackingWheels) {}
+
+    /// Robot `robot`'s wheel `wheel` voltage for the next step(), clamped to ±kMaxMotorVoltage
+    /// exactly as FakeMotor::setVoltage clamps. Preconditions: indices in range, volts finite.
+    void setVoltage(std::size_t robot, int wheel, units::Voltage volts) {
+        SHULIB_PRECONDITION(robot < count_ && wheel >= 0 && wheel < n_,
+                            "BatchPlant::setVoltage: index out of range");
+        SHULIB_PRECONDITION(std::isfinite(volts.value()),
+                            "BatchPlant::setVoltage: voltage must be finite");
+        volts_[at(wheel, robot)] = std::clamp(volts.value(), -hal::kMaxMotorVoltage.value(),
+                                              hal::kMaxMotorVoltage.value());
+    }
+    /// The clamped voltage setVoltage() last stored (0 before the first).
+    [[nodiscard]] units::Voltage commandedVoltage(std::size_t robot, int wheel) const {
+        SHULIB_PRECONDITION(robot < count_ && wheel >= 0 && wheel < n_,
+                            "BatchPlant::commandedVoltage: index out of range");
+        return units::Voltage{volts_[at(wheel, robot)]};
+    }
+
+    /// One tick for every robot — DrivePlant::step's pipeline, stage by stage across the batch.
+    /// dt finite, >= 0; dt == 0 is the same explicit no-op.
+    void step(units::Time dt) {
+        SHULIB_PRECONDITION(std::isfinite(dt.value()) && dt.value() >= 0.0,
+                            "BatchPlant::step: dt must be finite and >= 0");
+        if (dt.value() == 0.0) {
+            return;
+        }
+        const units::Time now = clock_.now();
+        const double d = dt.value();
+        if (d != decayDt_) {
+            for (std::size_t r = 0; r < count_; ++r) {
+                decay_[r] = kA_[r] > 0.0 ? std::exp(-d * kV_[r] / kA_[r]) : 0.0;
+            }
+            decayDt_ = d;
+        }
+
+        // 1–4, hostile robots: their seams in DrivePlant's order, from the pre-step spin, into
+        // scratch — the array pass below overwrites spin_ for every robot.
+        for (std::size_t k = 0; k < hostile_.size(); ++k) {
+            const std::size_t r = hostile_[k];
+            DegradationModel& model = *robots_[r].degradation;
+            for (int i = 0; i < n_; ++i) {
+                const units::Voltage effective =
+                    model.effectiveVoltage(i, units::Voltage{volts_[at(i, r)]}, now, rngs_[r]);
+                const units::Velocity spin =
+                    models_[r].advance(units::Velocity{spin_[at(i, r)]}, effective, dt);
+                const std::size_t slot =
+                    k * static_cast<std::size_t>(n_) + static_cast<std::size_t>(i);
+                hostileSpin_[slot] = spin.value();
+                hostileMotion_[slot] = model.wheelMotionVelocity(i, spin, now, rngs_[r]).value();
+            }
+        }
+
+        // 1–4, the array pass: MotorModel::advance with the identity seams, every robot.
+        for (int i = 0; i < n_; ++i) {
+            double* spin = spin_.data() + at(i, 0);
+            double* motion = motion_.data() + at(i, 0);
+            const double* volts = volts_.data() + at(i, 0);
+            for (std::size_t r = 0; r < count_; ++r) {
+                const double v = volts[r];
+                const double magnitude = (std::abs(v) - kS_[r]) / kV_[r];
+                const double vss =
+                    std::abs(v) <= kS_[r] ? 0.0 : (v > 0.0 ? magnitude : -magnitude);
+                const double next = kA_[r] > 0.0 ? vss + (spin[r] - vss) * decay_[r] : vss;
+                spin[r] = next;
+                motion[r] = next;
+            }
+        }
+        for (std::size_t k = 0; k < hostile_.size(); ++k) {
+            for (int i = 0; i < n_; ++i) {
+                const std::size_t slot =
+                    k * static_cast<std::size_t>(n_) + static_cast<std::size_t>(i);
+                spin_[at(i, hostile_[k])] = hostileSpin_[slot];
+                motion_[at(i, hostile_[k])] = hostileMotion_[slot];
+            }
+        }
+
+        // 5: the TRUE body twists.
+        if (matrix_ != nullptr) {
+            matrix_->forwardBatch(motion_, vx_, vy_, omega_);
+        } else {
+            for (std::size_t r = 0; r < count_; ++r) {
+                kinematics::WheelSpeeds wheels{n_};
+                for (int i = 0; i < n_; ++i) {
+                    wheels.set(i, units::Velocity{motion_[at(i, r)]});
+                }
+                const math::Twist2d t = kin_.forward(wheels);
+                vx_[r] = t.vx().value();
+                vy_[r] = t.vy().value();
+                omega_[r] = t.omega().value();
+            }
+        }
+
+        // 6: the TRUE poses — the robots' shared integrator.
+        if (integrator_ == TruthIntegrator::FixedRk4) {
+            advanceFixedRk4(d);
+        } else {
+            advanceAdaptive(dt);
+        }
+
+        // 7: time.
+        clock_.advance(dt);
+
+        // 8: the encoder shafts; hostile robots' sensor seams.
+        for (int i = 0; i < n_; ++i) {
+            double* shaft = driveShaft_.data() + at(i, 0);
+            const double* spin = spin_.data() + at(i, 0);
+            for (std::size_t r = 0; r < count_; ++r) {
+                shaft[r] += spin[r] * d / driveRadius_[r];
+            }
+        }
+        for (int i = 0; i < nTracking_; ++i) {
+            const TrackingWheelSpec& tw = tracking_[static_cast<std::size_t>(i)];
+            const double offset = tw.offset.value();
+            const double radius = 0.5 * tw.diameter.value();
+            double* shaft = trackingShaft_.data() + at(i, 0);
+            for (std::size_t r = 0; r < count_; ++r) {
+                const double pointVel = (tw.axis == TrackingAxis::Forward)
+                                            ? (vx_[r] - omega_[r] * offset)
+                                            : (vy_[r] + omega_[r] * offset);
+                shaft[r] += pointVel * d / radius;
+            }
+        }
+        for (const std::size_t r : hostile_) {
+            synthesize(r, *robots_[r].degradation, rngs_[r], readings_[r]);
+        }
+    }
+
+    /// Robots in the batch.
+    [[nodiscard]] std::size_t robotCount() const noexcept { return count_; }
+    /// Drive wheels per robot (the kinematics' wheelCount()).
+    [[nodiscard]] int wheelCount() const noexcept { return n_; }
+
+    // ── Ground truth — for sweeps and assertions ONLY (DrivePlant's constraint 3) ──────
+    /// Robot `robot`'s true (x, y, θ), θ unwrapped.
+    [[nodiscard]] TruthState truthState(std::size_t robot) const {
+        SHULIB_PRECONDITION(robot < count_, "BatchPlant::truthState: robot out of range");
+        return TruthState{x_[robot], y_[robot], theta_[robot]};
+    }
+    /// Robot `robot`'s true pose, wrapped.
+    [[nodiscard]] math::Pose2d truePose(std::size_t robot) const {
+        return truthState(robot).pose();
+    }
+    /// Robot `robot`'s true body twist over the last tick.
+    [[nodiscard]] math::Twist2d trueBodyTwist(std::size_t robot) const {
+        SHULIB_PRECONDITION(robot < count_, "BatchPlant::trueBodyTwist: robot out of range");
+        return math::Twist2d{units::Velocity{vx_[robot]}, units::Velocity{vy_[robot]},
+                             units::AngularVelocity{omega_[robot]}};
+    }
+    /// Robot `robot`'s true per-wheel SPIN surface speeds (pre-slip).
+    [[nodiscard]] kinematics::WheelSpeeds trueWheelSpin(std::size_t robot) const {
+        SHULIB_PRECONDITION(robot < count_, "BatchPlant::trueWheelSpin: robot out of range");
+        kinematics::WheelSpeeds w{n_};
+        for (int i = 0; i < n_; ++i) {
+            w.set(i, units::Velocity{spin_[at(i, robot)]});
+        }
+        return w;
+    }
+    /// What robot `robot`'s sensors read now: the seams' results for a hostile robot, truth
+    /// through the identity otherwise.
+    [[nodiscard]] BatchReadings readings(std::size_t robot) const {
+        SHULIB_PRECONDITION(robot < count_, "BatchPlant::readings: robot out of range");
+        if (robots_[robot].degradation != nullptr) {
+            return readings_[robot];
+        }
+        DegradationModel identity;
+        Rng unused{0};
+        BatchReadings out;
+        synthesize(robot, identity, unused, out);
+        return out;
+    }
+
+    /// Robot `robot`'s seeded random source (DrivePlant::rng()'s role).
+    [[nodiscard]] Rng& rng(std::size_t robot) {
+        SHULIB_PRECONDITION(robot < count_, "BatchPlant::rng: robot out of range");
+        return rngs_[robot];
+    }
+    /// The batch's one clock: every robot shares the time axis.
+    [[nodiscard]] hal::fake::FakeClock& clock() noexcept { return clock_; }
+
+private:
+    BatchPlant(const kinematics::IKinematics& kinematics,
+               const kinematics::MatrixKinematics* matrix, std::span<const BatchRobot> robots,
+               std::span<const TrackingWheelSpec> trackingWheels)
+        : kin_{kinematics},
+          matrix_{matrix},
+          count_{robots.size()},
+          n_{kinematics.wheelCount()},
+          robots_(robots.begin(), robots.end()) {
+        SHULIB_PRECONDITION(count_ >= 1u, "BatchPlant: at least one robot");
+        SHULIB_PRECONDITION(n_ >= 1 && n_ <= kinematics::WheelSpeeds::kMaxWheels,
+                            "BatchPlant: wheel count must be in [1, kMaxWheels]");
+        SHULIB_PRECONDITION(trackingWheels.size()
+                                <= static_cast<std::size_t>(DrivePlant::kMaxTrackingWheels),
+                            "BatchPlant: too many tracking wheels");
+        nTracking_ = static_cast<int>(trackingWheels.size());
+        for (std::size_t i = 0; i < trackingWheels.size(); ++i) {
+            SHULIB_PRECONDITION(trackingWheels[i].diameter.value() > 0.0,
+                                "BatchPlant: tracking-wheel diameter must be > 0");
+            tracking_[i] = trackingWheels[i];
+        }
+        integrator_ = robots_[0].plant.truthIntegrator;
+        substeps_ = robots_[0].plant.truthSubsteps;
+        SHULIB_PRECONDITION(substeps_ >= 1, "BatchPlant: truthSubsteps must be >= 1");
+
+        const auto wheels = static_cast<std::size_t>(n_);
+        volts_.assign(wheels * count_, 0.0);
+        spin_.assign(wheels * count_, 0.0);
+        motion_.assign(wheels * count_, 0.0);
+        driveShaft_.assign(wheels * count_, 0.0);
+        trackingShaft_.assign(static_cast<std::size_t>(nTracking_) * count_, 0.0);
+        for (std::vector<double>* v : {&kS_, &kV_, &kA_, &decay_, &driveRadius_, &x_, &y_, &theta_,
+                                       &vx_, &vy_, &omega_, &cos_, &sin_}) {
+            v->assign(count_, 0.0);
+        }
+        readings_.resize(count_);
+        dormandPrince_.reserve(count_);
+        models_.reserve(count_);
+        rngs_.reserve(count_);
+        for (std::size_t r = 0; r < count_; ++r) {
+            const DrivePlantConfig& cfg = robots_[r].plant;
+            SHULIB_PRECONDITION(cfg.truthIntegrator == integrator_
+                                    && cfg.truthSubsteps == substeps_,
+                                "BatchPlant: every robot must share its truth integrator");
+            SHULIB_PRECONDITION(cfg.dynamics == PlantDynamics::Kinematic,
+                                "BatchPlant: batches the kinematic plant only "
+                                "(RigidBody runs in a DrivePlant)");
+            SHULIB_PRECONDITION(cfg.field == nullptr,
+                                "BatchPlant: batches the open floor only "
+                                "(a field runs in a DrivePlant)");
+            SHULIB_PRECONDITION(cfg.driveWheelDiameter.value() > 0.0,
+                                "BatchPlant: driveWheelDiameter must be > 0");
+            SHULIB_PRECONDITION(cfg.batteryVoltage.value() >= 0.0,
+                                "BatchPlant: batteryVoltage must be >= 0");
+            models_.emplace_back(cfg.wheelFf);  // validates the gains as DrivePlant's does
+            rngs_.emplace_back(cfg.seed);
+            kS_[r] = cfg.wheelFf.kS;
+            kV_[r] = cfg.wheelFf.kV;
+            kA_[r] = cfg.wheelFf.kA;
+            driveRadius_[r] = 0.5 * cfg.driveWheelDiameter.value();
+            x_[r] = cfg.initialPose.x().value();
+            y_[r] = cfg.initialPose.y().value();
+            theta_[r] = cfg.initialPose.heading().radians();
+            if (robots_[r].degradation != nullptr) {
+                hostile_.push_back(r);
+            }
+        }
+        hostileSpin_.assign(hostile_.size() * wheels, 0.0);
+        hostileMotion_.assign(hostile_.size() * wheels, 0.0);
+        // DrivePlant seeds its sensors at construction — through the seams, so draws happen.
+        for (const std::size_t r : hostile_) {
+            synthesize(r, *robots_[r].degradation, rngs_[r], readings_[r]);
+        }
+    }
+
+    /// advanceTruthAdaptive for every robot (header: TRUTH): the Gauss–Legendre ticks in one
+    /// pass, robots innermost; then the Dormand–Prince ones, one robot at a time.
+    void advanceAdaptive(units::Time dt) {
+        const double d = dt.value();
+        dormandPrince_.clear();
+        for (std::size_t r = 0; r < count_; ++r) {
+            const double vx = vx_[r];
+            const double vy = vy_[r];
+            const double w = omega_[r];
+            if (truthQuadratureCovers(vx, vy, w, d, kTruthTolerance)) {
+                truthQuadratureStep(theta_[r], vx, vy, w, d, x_[r], y_[r]);
+                theta_[r] += w * d;
+            } else {
+                dormandPrince_.push_back(r);  // within the capacity reserved at construction
+            }
+        }
+        for (const std::size_t r : dormandPrince_) {
+            const TruthState next = advanceTruthAdaptive(TruthState{x_[r], y_[r], theta_[r]},
+                                                         trueBodyTwist(r), dt);
+            x_[r] = next.x;
+            y_[r] = next.y;
+            theta_[r] = next.theta;
+        }
+    }
+
+    /// advanceTruth's RK4 for every robot, robots innermost (header: the carried trig).
+    void advanceFixedRk4(double d) {
+        const double h = d / static_cast<double>(substeps_);
+        for (std::size_t r = 0; r < count_; ++r) {
+            cos_[r] = std::cos(theta_[r]);
+            sin_[r] = std::sin(theta_[r]);
+        }
+        for (int sub = 0; sub < substeps_; ++sub) {
+            for (std::size_t r = 0; r < count_; ++r) {
+                const double vx = vx_[r];
+                const double vy = vy_[r];
+                const double w = omega_[r];
+                const double thMid = theta_[r] + 0.5 * h * w;
+                const double th1 = theta_[r] + h * w;
+                // A heading that did not move (ω == 0 to the last bit) needs no new trig.
+                const bool still = std::bit_cast<std::uint64_t>(th1) ==
+                                       std::bit_cast<std::uint64_t>(theta_[r])
+                                   && std::bit_cast<std::uint64_t>(thMid) ==
+                                          std::bit_cast<std::uint64_t>(theta_[r]);
+                const double cosMid = still ? cos_[r] : std::cos(thMid);
+                const double sinMid = still ? sin_[r] : std::sin(thMid);
+                const double cos1 = still ? cos_[r] : std::cos(th1);
+                const double sin1 = still ? sin_[r] : std::sin(th1);
+
+                const double k1x = vx * cos_[r] - vy * sin_[r];
+                const double k1y = vx * sin_[r] + vy * cos_[r];
+                const double k23x = vx * cosMid - vy * sinMid;
+                const double k23y = vx * sinMid + vy * cosMid;
+                const double k4x = vx * cos1 - vy * sin1;
+                const double k4y = vx * sin1 + vy * cos1;
+
+                x_[r] += (h / 6.0) * (k1x + 4.0 * k23x + k4x);
+                y_[r] += (h / 6.0) * (k1y + 4.0 * k23y + k4y);
+                theta_[r] = th1;
+                cos_[r] = cos1;
+                sin_[r] = sin1;
+            }
+        }
+    }
+
+    /// Index of wheel-or-channel `i` of robot `r` in a per-wheel array (wheel-major, so one
+    /// wheel's robots are contiguous).
+    [[nodiscard]] std::size_t at(int i, std::size_t r) const noexcept {
+        return static_cast<std::size_t>(i) * count_ + r;
+    }
+
+    /// DrivePlant::synthesizeSensors for robot `r`, into `out` instead of fakes — the same
+    /// seams in the same order, so the same draws.
+    void synthesize(std::size_t r, DegradationModel& model, Rng& rng, BatchReadings& out) const {
+        const units::Time now = clock_.now();
+        const DrivePlantConfig& cfg = robots_[r].plant;
+        out.imuHeading = model.imuHeading(math::Angle::radians(theta_[r]), now, rng);
+        out.imuYawRate = model.imuYawRate(units::AngularVelocity{omega_[r]}, now, rng);
+        out.imuReady = model.imuReady(true, now);
+        for (int i = 0; i < n_; ++i) {
+            out.driveEncoder[static_cast<std::size_t>(i)] =
+                model.driveEncoderPosition(i, units::AngleDim{driveShaft_[at(i, r)]}, now, rng);
+        }
+        for (int i = 0; i < nTracking_; ++i) {
+            out.trackingEncoder[static_cast<std::size_t>(i)] = model.trackingEncoderPosition(
+                i, units::AngleDim{trackingShaft_[at(i, r)]}, now, rng);
+        }
+        out.gps = model.gps(GpsTruth{truthState(r).pose(), cfg.gpsRmsError, cfg.gpsHasFix}, now,
+                            rng);
+        out.batteryVoltage = model.batteryVoltage(cfg.batteryVoltage, now, rng);
+    }
+
+    const kinematics::IKinematics& kin_;
+    const kinematics::MatrixKinematics* matrix_;  // non-null: the forwardBatch path
+    hal::fake::FakeClock clock_{};
+    std::size_t count_;
+    int n_;
+    int nTracking_ = 0;
+    TruthIntegrator integrator_ = TruthIntegrator::Adaptive;
+    int substeps_ = 1;
+    std::array<TrackingWheelSpec, static_cast<std::size_t>(DrivePlant::kMaxTrackingWheels)>
+        tracking_{};
+    std::vector<BatchRobot> robots_;
+    std::vector<MotorModel> models_;  // the hostile path's advance(); validates every robot
+    std::vector<Rng> rngs_;
+    std::vector<std::size_t> hostile_;  // robots with a DegradationModel, ascending
+    std::vector<BatchReadings> readings_;
+
+    // Per robot.
+    std::vector<double> kS_, kV_, kA_, decay_, driveRadius_;
+    std::vector<double> x_, y_, theta_, vx_, vy_, omega_;
+    std::vector<double> cos_, sin_;  // RK4: cos/sin of theta_ at the current substep's start
+    std::vector<std::size_t> dormandPrince_;  // Adaptive: this tick's robots past quadrature
+    double decayDt_ = -1.0;          // the dt decay_ was computed for (none yet)
+
+    // Per wheel (or tracking channel), wheel-major: see at().
+    std::vector<double> volts_, spin_, motion_, driveShaft_, trackingShaft_;
+    std::vector<double> hostileSpin_, hostileMotion_;  // hostile_.size() × n_ scratch
+};
+
+}  // namespace shulib::sim
@@ -0,0 +1,737 @@
+#pragma once
+//
+// sim::BlackboxIndex + columns — random access into blackbox files, and a columnar
+// export of their ticks, for analysing a weekend's worth of runs on a laptop.
+//
+// ── Why this exists next to BlackboxReader ──────────────────────────────────────────
+// BlackboxReader is the robot-side contract: borrow a span, walk it front to back, never
+// throw, never allocate. That is the right shape for one file read once, and the wrong
+// one for "show me the second motion of every run on Saturday": every question walks
+// every file from byte 256. This file adds the three things analysis needs and the robot
+// never will:
+//   * MappedFile — the file's bytes mmap()ed read-only, so a 100 MB run costs no read
+//     and no copy before the first question. Where <sys/mman.h> does not exist it reads
+//     the file into memory instead (same interface; mapped() says which).
+//   * BlackboxIndex — ONE pass over a file, recording each tick frame's offset, time and
+//     command id. After that, seekTime() and seekCommand() are binary searches and
+//     readTick(i) decodes exactly one tick — for a compact (v2) file, the chain from its
+//     keyframe, at most kDefaultKeyframeInterval frames, not the file.
+//   * TickColumns — every persisted tick field as one contiguous array of doubles
+//     (gatherColumns()), written as CSV (writeCsv()) or as a flat binary columnar file
+//     (writeColumnar()) that a plotting tool can mmap and use in place (ColumnarView).
+//
+// ── Zero copies, where alignment allows ─────────────────────────────────────────────
+// The tick frame IS a fixed little-endian row (blackbox_format.hpp's layout table), so
+// the gather reads each field straight from the mapped bytes at its documented offset —
+// no read buffer, no DebugRecord round trip; a compact tick is gathered from the
+// decoder's rebuilt row (CompactTickDecoder::tickBytes()). Turning rows into columns is
+// a transpose, so that step is one load and one store per value, and cannot be fewer.
+// The columnar file is laid out so the NEXT consumer pays nothing: every column starts
+// on an 8-byte boundary, so a page-aligned mapping of it is already an array of doubles
+// and ColumnarView hands out spans into the mapping itself. A buffer that is not 8-byte
+// aligned, or a big-endian host, is refused rather than copied behind the caller's back.
+//
+// ── What is a column ────────────────────────────────────────────────────────────────
+// The fields the Tick frame carries (kTickColumns, in layout order; the wheel and phase
+// arrays flattened to wheelVoltage0..7 and so on). DebugRecord fields that never reach
+// the tick frame are not columns, because they are not in the file. A triage frame's
+// own fault-tick record is not a tick frame and is not indexed; the dumped ring ticks
+// that follow it are. Ticks dumped after a streamed run repeat earlier times, so a file
+// need not be time-ordered: seekTime() falls back to a linear scan when it is not.
+//
+// tools/shulib_bbx is the command line over all of it: index any number of files, seek,
+// export, and report the throughput.
+//
+// Host-only: allocation, stdio and POSIX mmap are fine here; this never runs on the
+// V5 (and degrades to plain reads where the platform has no mmap).
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>) \
+    && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHULIB_SIM_HAVE_MMAP 1
+#else
+#define SHULIB_SIM_HAVE_MMAP 0
+#endif
+
+#include "shulib/diag/blackbox_compact.hpp"
+#include "shulib/diag/blackbox_format.hpp"
+#include "shulib/diag/blackbox_reader.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::sim {
+
+/// A file's bytes, read-only, for as long as this object lives: mmap()ed where the
+/// platform has it, read into memory where it does not (file banner). Not copyable or
+/// movable — the spans it hands out point into it.
+class MappedFile {
+public:
+    /// Map `path`. Never throws; ok() says whether it worked. An empty file is ok() with
+    /// no bytes.
+    explicit MappedFile(const char* path) noexcept {
+#if SHULIB_SIM_HAVE_MMAP
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && st.st_size >= 0) {
+            size_ = static_cast<std::size_t>(st.st_size);
+            if (size_ == 0) {
+                ok_ = true;
+            } else {
+                void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    data_ = static_cast<const std::byte*>(p);
+                    mapped_ = true;
+                    ok_ = true;
+                }
+            }
+        }
+        ::close(fd);
+#else
+        std::FILE* f = std::fopen(path, "rb");
+        if (f == nullptr) {
+            return;
+        }
+        std::byte chunk[65536];
+        std::size_t n = 0;
+        while ((n = std::fread(chunk, 1, sizeof chunk, f)) > 0) {
+            copy_.insert(copy_.end(), chunk, chunk + n);
+        }
+        ok_ = std::ferror(f) == 0;
+        std::fclose(f);
+        data_ = copy_.data();
+        size_ = copy_.size();
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;             ///< spans point into this object
+    MappedFile& operator=(const MappedFile&) = delete;  ///< spans point into this object
+    MappedFile(MappedFile&&) = delete;                  ///< spans point into this object
+    MappedFile& operator=(MappedFile&&) = delete;       ///< spans point into this object
+
+    /// Unmaps (or frees) the bytes; every span from bytes() dies here.
+    ~MappedFile() {
+#if SHULIB_SIM_HAVE_MMAP
+        if (mapped_) {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+#endif
+    }
+
+    /// Whether the file could be opened and mapped (or read).
+    [[nodiscard]] bool ok() const noexcept { return ok_; }
+    /// True when the bytes are an mmap() of the file rather than a read copy.
+    [[nodiscard]] bool mapped() const noexcept { return mapped_; }
+    /// The file's bytes; empty when !ok(). Valid while this object lives.
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept {
+        return ok_ ? std::span<const std::byte>{data_, size_} : std::span<const std::byte>{};
+    }
+
+private:
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool ok_ = false;
+    bool mapped_ = false;
+#if !SHULIB_SIM_HAVE_MMAP
+    std::vector<std::byte> copy_;
+#endif
+};
+
+// ── The tick row as columns ─────────────────────────────────────────────────────────
+
+/// How one column's value is stored in the tick row.
+enum class ColumnType : std::uint8_t {
+    F64,  ///< IEEE-754 binary64, little-endian
+    U8,   ///< one unsigned byte
+    U16,  ///< unsigned 16-bit, little-endian
+    U32,  ///< unsigned 32-bit, little-endian
+};
+
+/// One persisted tick field: its column name, byte offset in the Tick payload, and type.
+struct TickColumn {
+    std::string_view name;   ///< the DebugRecord field, arrays suffixed 0..7
+    std::uint16_t offset;    ///< byte offset in the v1 Tick payload
+    ColumnType type;         ///< storage type at that offset
+};
+
+/// Every field of the Tick payload, in layout order (blackbox_format.hpp's table).
+/// `flags` is the raw bit set (bit 0 clampedThisTick, bit 1 strafeFallbackActive).
+inline constexpr std::array<TickColumn, 61> kTickColumns{{
+    {"t", 0, ColumnType::F64},
+    {"dt", 8, ColumnType::F64},
+    {"targetX", 16, ColumnType::F64},
+    {"targetY", 24, ColumnType::F64},
+    {"targetHeading", 32, ColumnType::F64},
+    {"measuredX", 40, ColumnType::F64},
+    {"measuredY", 48, ColumnType::F64},
+    {"measuredHeading", 56, ColumnType::F64},
+    {"errorX", 64, ColumnType::F64},
+    {"errorY", 72, ColumnType::F64},
+    {"errorHeading", 80, ColumnType::F64},
+    {"commandedVx", 88, ColumnType::F64},
+    {"commandedVy", 96, ColumnType::F64},
+    {"commandedOmega", 104, ColumnType::F64},
+    {"wheelCount", 112, ColumnType::U8},
+    {"activeCommandState", 113, ColumnType::U8},
+    {"deadReckoning", 114, ColumnType::U8},
+    {"qualityClass", 115, ColumnType::U8},
+    {"activeCommandId", 116, ColumnType::U32},
+    {"fault", 120, ColumnType::U16},
+    {"gateReason", 122, ColumnType::U8},
+    {"flags", 123, ColumnType::U8},
+    {"droppedRecords", 124, ColumnType::U32},
+    {"droppedLines", 128, ColumnType::U32},
+    {"wheelVoltage0", 132, ColumnType::F64},
+    {"wheelVoltage1", 140, ColumnType::F64},
+    {"wheelVoltage2", 148, ColumnType::F64},
+    {"wheelVoltage3", 156, ColumnType::F64},
+    {"wheelVoltage4", 164, ColumnType::F64},
+    {"wheelVoltage5", 172, ColumnType::F64},
+    {"wheelVoltage6", 180, ColumnType::F64},
+    {"wheelVoltage7", 188, ColumnType::F64},
+    {"wheelCurrent0", 196, ColumnType::F64},
+    {"wheelCurrent1", 204, ColumnType::F64},
+    {"wheelCurrent2", 212, ColumnType::F64},
+    {"wheelCurrent3", 220, ColumnType::F64},
+    {"wheelCurrent4", 228, ColumnType::F64},
+    {"wheelCurrent5", 236, ColumnType::F64},
+    {"wheelCurrent6", 244, ColumnType::F64},
+    {"wheelCurrent7", 252, ColumnType::F64},
+    {"imuYaw", 260, ColumnType::F64},
+    {"imuYawRate", 268, ColumnType::F64},
+    {"quality", 276, ColumnType::F64},
+    {"covarianceTrace", 284, ColumnType::F64},
+    {"gateResidualX", 292, ColumnType::F64},
+    {"gateResidualY", 300, ColumnType::F64},
+    {"gateResidualHeading", 308, ColumnType::F64},
+    {"gateMahalanobis", 316, ColumnType::F64},
+    {"correctionDx", 324, ColumnType::F64},
+    {"correctionDy", 332, ColumnType::F64},
+    {"correctionDTheta", 340, ColumnType::F64},
+    {"batteryVoltage", 348, ColumnType::F64},
+    {"batteryCurrent", 356, ColumnType::F64},
+    {"tickPhase0", 364, ColumnType::F64},
+    {"tickPhase1", 372, ColumnType::F64},
+    {"tickPhase2", 380, ColumnType::F64},
+    {"tickPhase3", 388, ColumnType::F64},
+    {"tickPhase4", 396, ColumnType::F64},
+    {"tickPhase5", 404, ColumnType::F64},
+    {"tickPhase6", 412, ColumnType::F64},
+    {"tickPhase7", 420, ColumnType::F64},
+}};
+static_assert(kTickColumns.back().offset + 8 == diag::blackbox::kTickPayloadBytes,
+              "kTickColumns must cover the Tick payload exactly — update it with the layout");
+
+/// Implementation details of the index and the columns. Not API.
+namespace blackbox_index_detail {
+
+/// Reverse the byte order of `v` (std::byteswap is C++23).
+[[nodiscard]] constexpr std::uint64_t swap64(std::uint64_t v) noexcept {
+    std::uint64_t out = 0;
+    for (int b = 0; b < 8; ++b) {
+        out = (out << 8U) | (v & 0xFFU);
+        v >>= 8U;
+    }
+    return out;
+}
+
+/// Column `c`'s value in the v1 tick row starting at `row`, as a double.
+[[nodiscard]] inline double fieldValue(const std::byte* row, const TickColumn& c) noexcept {
+    const std::byte* p = row + c.offset;
+    switch (c.type) {
+        case ColumnType::F64: {
+            std::uint64_t bits = 0;
+            std::memcpy(&bits, p, 8);
+            if constexpr (std::endian::native == std::endian::big) {
+                bits = swap64(bits);
+            }
+            return std::bit_cast<double>(bits);
+        }
+        case ColumnType::U8: return static_cast<double>(std::to_integer<std::uint8_t>(p[0]));
+        case ColumnType::U16:
+            return static_cast<double>(std::to_integer<unsigned>(p[0])
+                                       | (std::to_integer<unsigned>(p[1]) << 8U));
+        case ColumnType::U32:
+            return static_cast<double>(std::to_integer<std::uint32_t>(p[0])
+                                       | (std::to_integer<std::uint32_t>(p[1]) << 8U)
+                                       | (std::to_integer<std::uint32_t>(p[2]) << 16U)
+                                       | (std::to_integer<std::uint32_t>(p[3]) << 24U));
+    }
+    return 0.0;
+}
+
+/// The frame starting at `offset` in `file`: its type byte and payload. False when the
+/// offset does not hold a whole frame.
+[[nodiscard]] inline bool frameAt(std::span<const std::byte> file, std::size_t offset,
+                                  std::uint8_t& type, std::span<const std::byte>& payload) noexcept {
+    if (offset > file.size() || file.size() - offset < diag::blackbox::kFrameHeaderBytes) {
+        return false;
+    }
+    diag::blackbox::ByteReader head{file.subspan(offset, diag::blackbox::kFrameHeaderBytes)};
+    type = head.u8();
+    head.skip(1);
+    const std::size_t bytes = head.u16();
+    if (file.size() - offset - diag::blackbox::kFrameHeaderBytes < bytes) {
+        return false;
+    }
+    payload = file.subspan(offset + diag::blackbox::kFrameHeaderBytes, bytes);
+    return true;
+}
+
+}  // namespace blackbox_index_detail
+
+// ── The index ───────────────────────────────────────────────────────────────────────
+
+/// Where one tick lives in its file.
+struct TickIndexEntry {
+    std::size_t offset = 0;       ///< file offset of the tick's frame
+    std::size_t chainOffset = 0;  ///< its keyframe's offset (v2); == offset for a v1 tick
+    double t = 0.0;               ///< the tick's time (s)
+    std::uint32_t commandId = 0;  ///< activeCommandId; 0 between motions
+};
+
+/// A one-pass index of a blackbox file's tick frames (file banner): seek by time or by
+/// command id, then decode just the tick you asked for. Borrows the span, which must
+/// outlive it — a MappedFile's bytes(), typically. Reads v1 and v2 files; a file the
+/// reader refuses indexes nothing and says why in status().
+class BlackboxIndex {
+public:
+    /// No such tick (seekCommand() for an id the file never ran, seekTime() past the end).
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// Index `file` in one pass. Never throws except for allocation.
+    explicit BlackboxIndex(std::span<const std::byte> file) : file_{file} {
+        namespace bb = diag::blackbox;
+        bb::BlackboxReader reader{file};
+        status_ = reader.status();
+        compact_ = reader.header().formatVersion == bb::kFormatVersionCompact;
+        bb::BlackboxReader::Frame frame;
+        diag::blackbox::CompactTickDecoder decoder;
+        diag::DebugRecord r;
+        std::size_t chain = 0;
+        bool corrupt = false;
+        while (reader.next(frame)) {
+            const std::size_t offset = frameOffset(frame);
+            if (frame.type == bb::FrameType::Tick) {
+                // The v1 fast path: time and command id straight from the row.
+                const std::byte* row = frame.payload.data();
+                ticks_.push_back({offset, offset,
+                                  blackbox_index_detail::fieldValue(row, kTickColumns[0]),
+                                  static_cast<std::uint32_t>(blackbox_index_detail::fieldValue(
+                                      row, kTickColumns[kCommandIdColumn]))});
+            } else if (frame.type == bb::FrameType::TickKey
+                       || frame.type == bb::FrameType::TickDelta) {
+                if (frame.type == bb::FrameType::TickKey) {
+                    chain = offset;
+                }
+                if (decoder.decode(frame.type, frame.payload, r, corrupt)) {
+                    ticks_.push_back({offset, chain, r.t.value(), r.activeCommandId});
+                } else {
+                    ++unresolved_;
+                }
+            }
+        }
+        truncated_ = reader.truncated();
+        for (std::size_t i = 1; i < ticks_.size(); ++i) {
+            timeOrdered_ = timeOrdered_ && ticks_[i].t >= ticks_[i - 1].t;
+        }
+        for (std::size_t i = 0; i < ticks_.size(); ++i) {
+            if (ticks_[i].commandId != 0U) {
+                commands_.emplace_back(ticks_[i].commandId, i);
+            }
+        }
+        // First tick per id: a stable sort keeps file order within an id.
+        std::stable_sort(commands_.begin(), commands_.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+        commands_.erase(std::unique(commands_.begin(), commands_.end(),
+                                    [](const auto& a, const auto& b) { return a.first == b.first; }),
+                        commands_.end());
+    }
+
+    /// The reader's verdict on the file; anything but Ok means no ticks.
+    [[nodiscard]] diag::blackbox::ReadStatus status() const noexcept { return status_; }
+    /// True for a compact (v2) file.
+    [[nodiscard]] bool compact() const noexcept { return compact_; }
+    /// True when the file ended mid-frame (the ticks before the cut are all indexed).
+    [[nodiscard]] bool truncated() const noexcept { return truncated_; }
+    /// Compact ticks whose chain was broken — present in the file, not in the index.
+    [[nodiscard]] std::size_t unresolvedTicks() const noexcept { return unresolved_; }
+    /// Ticks indexed.
+    [[nodiscard]] std::size_t size() const noexcept { return ticks_.size(); }
+    /// Every indexed tick, in file order.
+    [[nodiscard]] std::span<const TickIndexEntry> entries() const noexcept { return ticks_; }
+    /// True when tick times never go backwards (a dump after a streamed run breaks it).
+    [[nodiscard]] bool timeOrdered() const noexcept { return timeOrdered_; }
+
+    /// The first tick at or after `t`, or npos. A binary search when timeOrdered(),
+    /// a scan in file order otherwise.
+    [[nodiscard]] std::size_t seekTime(units::Time t) const noexcept {
+        const double target = t.value();
+        if (timeOrdered_) {
+            const auto it = std::lower_bound(
+                ticks_.begin(), ticks_.end(), target,
+                [](const TickIndexEntry& e, double v) { return e.t < v; });
+            return it == ticks_.end() ? npos : static_cast<std::size_t>(it - ticks_.begin());
+        }
+        for (std::size_t i = 0; i < ticks_.size(); ++i) {
+            if (ticks_[i].t >= target) {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    /// The first tick stamped with command `id`, or npos (and always npos for 0, which
+    /// means "between motions", not a command).
+    [[nodiscard]] std::size_t seekCommand(std::uint32_t id) const noexcept {
+        const auto it = std::lower_bound(
+            commands_.begin(), commands_.end(), id,
+            [](const std::pair<std::uint32_t, std::size_t>& e, std::uint32_t v) { return e.first < v; });
+        return it != commands_.end() && it->first == id ? it->second : npos;
+    }
+
+    /// Decode tick `i` into `r`. A v1 tick is one decode; a compact tick replays its
+    /// chain from the keyframe. False for an out-of-range index or a tick that no longer
+    /// decodes (the span changed under the index).
+    [[nodiscard]] bool readTick(std::size_t i, diag::DebugRecord& r) const noexcept {
+        std::array<std::byte, diag::blackbox::kTickPayloadBytes> row{};
+        if (!tickRow(i, row)) {
+            return false;
+        }
+        bool corrupt = false;
+        return diag::blackbox::decodeTick(row, r, corrupt);
+    }
+
+    /// Tick `i`'s v1 row bytes (for a compact tick, the rebuilt row) into `row`.
+    [[nodiscard]] bool tickRow(std::size_t i,
+                               std::span<std::byte, diag::blackbox::kTickPayloadBytes> row) const noexcept {
+        namespace bb = diag::blackbox;
+        if (i >= ticks_.size()) {
+            return false;
+        }
+        const TickIndexEntry& e = ticks_[i];
+        std::uint8_t type = 0;
+        std::span<const std::byte> payload;
+        if (!compact_) {
+            if (!blackbox_index_detail::frameAt(file_, e.offset, type, payload)
+                || type != static_cast<std::uint8_t>(bb::FrameType::Tick)
+                || payload.size() != bb::kTickPayloadBytes) {
+                return false;
+            }
+            std::memcpy(row.data(), payload.data(), row.size());
+            return true;
+        }
+        diag::blackbox::CompactTickDecoder decoder;
+        diag::DebugRecord scratch;
+        bool corrupt = false;
+        for (std::size_t at = e.chainOffset; at <= e.offset;
+             at += bb::kFrameHeaderBytes + payload.size()) {
+            if (!blackbox_index_detail::frameAt(file_, at, type, payload)) {
+                return false;
+            }
+            const auto ft = static_cast<bb::FrameType>(type);
+            if (ft != bb::FrameType::TickKey && ft != bb::FrameType::TickDelta) {
+                continue;  // an interleaved frame (inputs, load-shed) is not in the chain
+            }
+            if (!decoder.decode(ft, payload, scratch, corrupt)) {
+                return false;
+            }
+            if (at == e.offset) {
+                const auto rebuilt = decoder.tickBytes();
+                std::memcpy(row.data(), rebuilt.data(), row.size());
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// The file span this index was built over.
+    [[nodiscard]] std::span<const std::byte> file() const noexcept { return file_; }
+
+private:
+    static constexpr std::size_t kCommandIdColumn = 18;  // kTickColumns' activeCommandId
+    static_assert(kTickColumns[kCommandIdColumn].name == "activeCommandId");
+
+    [[nodiscard]] std::size_t frameOffset(const diag::blackbox::BlackboxReader::Frame& f) const noexcept {
+        return static_cast<std::size_t>(f.payload.data() - file_.data())
+               - diag::blackbox::kFrameHeaderBytes;
+    }
+
+    std::span<const std::byte> file_;
+    std::vector<TickIndexEntry> ticks_;
+    std::vector<std::pair<std::uint32_t, std::size_t>> commands_;  // (id, first tick), by id
+    diag::blackbox::ReadStatus status_ = diag::blackbox::ReadStatus::Empty;
+    std::size_t unresolved_ = 0;
+    bool compact_ = false;
+    bool truncated_ = false;
+    bool timeOrdered_ = true;
+};
+
+// ── Columns ─────────────────────────────────────────────────────────────────────────
+
+/// Ticks as columns: kTickColumns.size() arrays of rows() doubles, each contiguous, in
+/// one column-major allocation.
+class TickColumns {
+public:
+    /// No rows.
+    TickColumns() = default;
+    /// `rows` rows of zeros.
+    explicit TickColumns(std::size_t rows) : rows_{rows}, values_(rows * kTickColumns.size()) {}
+
+    /// Rows (ticks) held.
+    [[nodiscard]] std::size_t rows() const noexcept { return rows_; }
+    /// Column `c` (kTickColumns order), contiguous.
+    [[nodiscard]] std::span<const double> column(std::size_t c) const noexcept {
+        return std::span<const double>{values_}.subspan(c * rows_, rows_);
+    }
+    /// The column named `name`; empty if there is none.
+    [[nodiscard]] std::span<const double> column(std::string_view name) const noexcept {
+        for (std::size_t c = 0; c < kTickColumns.size(); ++c) {
+            if (kTickColumns[c].name == name) {
+                return column(c);
+            }
+        }
+        return {};
+    }
+    /// Column `c`, writable (for the gather).
+    [[nodiscard]] std::span<double> column(std::size_t c) noexcept {
+        return std::span<double>{values_}.subspan(c * rows_, rows_);
+    }
+
+private:
+    std::size_t rows_ = 0;
+    std::vector<double> values_;
+};
+
+/// Every indexed tick of `index`, as columns — read straight from the file's rows (file
+/// banner). Rows are in index order; a compact tick that no longer decodes is a row of
+/// zeros.
+[[nodiscard]] inline TickColumns gatherColumns(const BlackboxIndex& index) {
+    namespace bb = diag::blackbox;
+    TickColumns cols{index.size()};
+    std::array<std::span<double>, kTickColumns.size()> out{};
+    for (std::size_t c = 0; c < kTickColumns.size(); ++c) {
+        out[c] = cols.column(c);
+    }
+    const auto gatherRow = [&](std::size_t i, const std::byte* row) {
+        for (std::size_t c = 0; c < kTickColumns.size(); ++c) {
+            out[c][i] = blackbox_index_detail::fieldValue(row, kTickColumns[c]);
+        }
+    };
+    const std::span<const TickIndexEntry> entries = index.entries();
+    if (!index.compact()) {
+        // v1: each row is read in place from the (mapped) file.
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            gatherRow(i, index.file().data() + entries[i].offset + bb::kFrameHeaderBytes);
+        }
+        return cols;
+    }
+    // v2: one forward walk of the chain, gathering from the decoder's rebuilt row.
+    diag::blackbox::CompactTickDecoder decoder;
+    diag::DebugRecord scratch;
+    bool corrupt = false;
+    std::size_t next = 0;
+    std::uint8_t type = 0;
+    std::span<const std::byte> payload;
+    for (std::size_t at = entries.empty() ? 0 : entries.front().chainOffset;
+         next < entries.size() && blackbox_index_detail::frameAt(index.file(), at, type, payload);
+         at += bb::kFrameHeaderBytes + payload.size()) {
+        const auto ft = static_cast<bb::FrameType>(type);
+        if (ft != bb::FrameType::TickKey && ft != bb::FrameType::TickDelta) {
+            continue;
+        }
+        const bool ok = decoder.decode(ft, payload, scratch, corrupt);
+        if (at == entries[next].offset) {
+            if (ok) {
+                gatherRow(next, decoder.tickBytes().data());
+            }
+            ++next;
+        }
+    }
+    return cols;
+}
+
+/// Write `cols` as CSV: a header row of column names, then one row per tick, every value
+/// at round-trip precision (%.17g). Returns false on a write error.
+inline bool writeCsv(std::FILE* out, const TickColumns& cols) {
+    for (std::size_t c = 0; c < kTickColumns.size(); ++c) {
+        if (std::fprintf(out, c == 0 ? "%.*s" : ",%.*s",
+                         static_cast<int>(kTickColumns[c].name.size()),
+                         kTickColumns[c].name.data()) < 0) {
+            return false;
+        }
+    }
+    if (std::fputc('\n', out) == EOF) {
+        return false;
+    }
+    for (std::size_t i = 0; i < cols.rows(); ++i) {
+        for (std::size_t c = 0; c < kTickColumns.size(); ++c) {
+            if (std::fprintf(out, c == 0 ? "%.17g" : ",%.17g", cols.column(c)[i]) < 0) {
+                return false;
+            }
+        }
+        if (std::fputc('\n', out) == EOF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ── The binary columnar file ────────────────────────────────────────────────────────
+//   0  u8[8]  magic "SHULCOL1"      24  directory: per column 32 bytes —
+//   8  u32    columnCount                u8[24] name (NUL-padded), u64 dataOffset
+//  12  u32    reserved (0)          …   data: each column rows × f64, little-endian,
+//  16  u64    rows                       8-byte aligned, in directory order
+
+/// The columnar file's magic.
+inline constexpr std::array<char, 8> kColumnarMagic{'S', 'H', 'U', 'L', 'C', 'O', 'L', '1'};
+/// Bytes before the column directory.
+inline constexpr std::size_t kColumnarHeaderBytes = 24;
+/// Bytes per directory entry.
+inline constexpr std::size_t kColumnarEntryBytes = 32;
+/// Longest column name the directory holds (the rest of its 24 bytes is the NUL).
+inline constexpr std::size_t kColumnarMaxName = 23;
+
+/// Write `cols` in the binary columnar layout above. Returns false on a write error.
+inline bool writeColumnar(std::FILE* out, const TickColumns& cols) {
+    const std::size_t n = kTickColumns.size();
+    std::vector<std::byte> head(kColumnarHeaderBytes + n * kColumnarEntryBytes);
+    const auto put = [&](std::size_t at, std::uint64_t v, std::size_t bytes) {
+        for (std::size_t b = 0; b < bytes; ++b) {
+            head[at + b] = static_cast<std::byte>((v >> (8U * b)) & 0xFFU);
+        }
+    };
+    std::memcpy(head.data(), kColumnarMagic.data(), kColumnarMagic.size());
+    put(8, n, 4);
+    put(16, cols.rows(), 8);
+    for (std::size_t c = 0; c < n; ++c) {
+        const std::size_t at = kColumnarHeaderBytes + c * kColumnarEntryBytes;
+        const std::string_view name = kTickColumns[c].name;
+        std::memcpy(&head[at], name.data(), std::min(name.size(), kColumnarMaxName));
+        put(at + 24, head.size() + c * cols.rows() * 8U, 8);
+    }
+    if (std::fwrite(head.data(), 1, head.size(), out) != head.size()) {
+        return false;
+    }
+    for (std::size_t c = 0; c < n; ++c) {
+        const std::span<const double> col = cols.column(c);
+        if constexpr (std::endian::native == std::endian::little) {
+            if (std::fwrite(col.data(), sizeof(double), col.size(), out) != col.size()) {
+                return false;
+            }
+        } else {
+            for (const double v : col) {
+                const std::uint64_t bits =
+                    blackbox_index_detail::swap64(std::bit_cast<std::uint64_t>(v));
+                if (std::fwrite(&bits, sizeof bits, 1, out) != 1) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/// A columnar file, read in place: columns are spans INTO the caller's bytes (file
+/// banner). Refuses (ok() false) a buffer that is not 8-byte aligned, a big-endian
+/// host, a bad magic, or a directory that points outside the buffer — it never copies.
+class ColumnarView {
+public:
+    /// Parse `bytes`, which must outlive the view.
+    explicit ColumnarView(std::span<const std::byte> bytes) noexcept : bytes_{bytes} {
+        if constexpr (std::endian::native != std::endian::little) {
+            return;
+        }
+        if (bytes.size() < kColumnarHeaderBytes
+            || std::memcmp(bytes.data(), kColumnarMagic.data(), kColumnarMagic.size()) != 0
+            || reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(double) != 0U) {
+            return;
+        }
+        diag::blackbox::ByteReader head{bytes.subspan(8)};
+        columns_ = head.u32();
+        head.skip(4);
+        const std::uint32_t lo = head.u32();
+        const std::uint32_t hi = head.u32();
+        rows_ = static_cast<std::size_t>((static_cast<std::uint64_t>(hi) << 32U) | lo);
+        if (columns_ > (bytes.size() - kColumnarHeaderBytes) / kColumnarEntryBytes) {
+            return;
+        }
+        for (std::size_t c = 0; c < columns_; ++c) {
+            const std::uint64_t off = dataOffset(c);
+            if (off % 8U != 0U || off > bytes.size() || rows_ > (bytes.size() - off) / 8U) {
+                return;
+            }
+        }
+        ok_ = true;
+    }
+
+    /// Whether the bytes are a columnar file this host can read in place.
+    [[nodiscard]] bool ok() const noexcept { return ok_; }
+    /// Rows per column.
+    [[nodiscard]] std::size_t rows() const noexcept { return ok_ ? rows_ : 0U; }
+    /// Columns in the file.
+    [[nodiscard]] std::size_t columns() const noexcept { return ok_ ? columns_ : 0U; }
+    /// Column `c`'s name.
+    [[nodiscard]] std::string_view name(std::size_t c) const noexcept {
+        if (!ok_ || c >= columns_) {
+            return {};
+        }
+        const auto* p = reinterpret_cast<const char*>(bytes_.data() + kColumnarHeaderBytes
+                                                      + c * kColumnarEntryBytes);
+        const std::string_view field{p, kColumnarMaxName + 1};
+        return field.substr(0, field.find('\0'));
+    }
+    /// Column `c`, pointing into the bytes themselves (no copy); empty if out of range.
+    [[nodiscard]] std::span<const double> column(std::size_t c) const noexcept {
+        if (!ok_ || c >= columns_) {
+            return {};
+        }
+        // The bytes are a little-endian f64 array at an 8-aligned offset of an 8-aligned
+        // buffer (checked at construction): reading them as doubles in place is the point.
+        return {reinterpret_cast<const double*>(bytes_.data() + dataOffset(c)), rows_};
+    }
+    /// The column named `name`; empty if there is none.
+    [[nodiscard]] std::span<const double> column(std::string_view wanted) const noexcept {
+        for (std::size_t c = 0; c < columns(); ++c) {
+            if (name(c) == wanted) {
+                return column(c);
+            }
+        }
+        return {};
+    }
+
+private:
+    [[nodiscard]] std::uint64_t dataOffset(std::size_t c) const noexcept {
+        diag::blackbox::ByteReader e{
+            bytes_.subspan(kColumnarHeaderBytes + c * kColumnarEntryBytes + 24, 8)};
+        const std::uint32_t lo = e.u32();
+        const std::uint32_t hi = e.u32();
+        return (static_cast<std::uint64_t>(hi) << 32U) | lo;
+    }
+
+    std::span<const std::byte> bytes_;
+    std::size_t rows_ = 0;
+    std::size_t columns_ = 0;
+    bool ok_ = false;
+};
+
+}  // namespace shulib::sim
+
+#undef SHULIB_SIM_HAVE_MMAP
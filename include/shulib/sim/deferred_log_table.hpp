@@ -0,0 +1,133 @@
+#pragma once
+//
+// sim::DeferredLogTable — the host half of deferred-formatting log lines: the in-band
+// string table a reader rebuilds from FormatDef frames, and the formatting the robot
+// skipped (diag/deferred_log.hpp).
+//
+// The writer sends each format's definition once, before the first line that uses it, so
+// a reader that sees the stream in order always meets the definition first: define() every
+// FormatDef payload, render() every LogArgs payload. The payloads are the same bytes in a
+// blackbox file and on the SHUL/2 wire, so one table serves both. readDeferredLines()
+// walks a whole blackbox file.
+//
+// A line whose definition was never seen — its FormatDef frame was dropped, or the reader
+// joined a SHUL/2 stream late — is NOT guessed at: it renders as the id and its raw
+// arguments, marked known = false. Host-only (allocates).
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "shulib/diag/blackbox_format.hpp"
+#include "shulib/diag/blackbox_reader.hpp"
+#include "shulib/diag/deferred_log.hpp"
+#include "shulib/hal/telemetry_sink.hpp"
+
+namespace shulib::sim {
+
+/// The format table rebuilt from a stream's FormatDef frames, and the renderer for its
+/// LogArgs frames (file banner).
+class DeferredLogTable {
+public:
+    /// One rendered line.
+    struct Line {
+        std::uint32_t id = 0;                      ///< the format id
+        hal::LogLevel level = hal::LogLevel::Info;  ///< the line's level
+        double t = 0.0;                            ///< the writer's time for the line, s
+        std::string tag;                           ///< the subsystem tag ("" if unknown)
+        std::string text;                          ///< the rendered message
+        bool known = false;                        ///< false ⇒ the format was never defined
+    };
+
+    /// Add one FormatDef payload to the table. False if it is malformed. A repeated id
+    /// replaces the earlier entry.
+    bool define(std::span<const std::byte> formatDefPayload) {
+        diag::blackbox::FormatDefView def;
+        if (!diag::blackbox::decodeFormatDef(formatDefPayload, def)) {
+            return false;
+        }
+        formats_[def.id] = Entry{std::string{def.tag}, std::string{def.format}};
+        return true;
+    }
+
+    /// Render one LogArgs payload into `out`. False if it is malformed; true — with
+    /// `out.known` false and the raw arguments as text — for an id the table lacks.
+    bool render(std::span<const std::byte> logArgsPayload, Line& out) const {
+        diag::blackbox::LogArgsView args;
+        if (!diag::blackbox::decodeLogArgs(logArgsPayload, args)) {
+            return false;
+        }
+        out.id = args.id;
+        out.level = static_cast<hal::LogLevel>(args.level);
+        out.t = args.t;
+        const auto it = formats_.find(args.id);
+        out.known = it != formats_.end();
+        std::array<char, diag::kMaxDeferredTextBytes> text{};
+        if (out.known) {
+            out.tag = it->second.tag;
+            const std::size_t n = diag::formatDeferred(it->second.format, args.args, text);
+            out.text.assign(text.data(), n);
+            return true;
+        }
+        // No definition: the id and the arguments, never a guessed text.
+        char id[24];
+        std::snprintf(id, sizeof id, "<format %08lx>", static_cast<unsigned long>(args.id));
+        out.tag.clear();
+        out.text = id;
+        const auto count = static_cast<std::size_t>(args.args[0]);
+        for (std::size_t i = 0; i < count; ++i) {
+            // Render argument i alone: a one-argument block around its 9 bytes.
+            std::array<std::byte, 1 + diag::kDeferredArgBytes> one{};
+            one[0] = std::byte{1};
+            for (std::size_t k = 0; k < diag::kDeferredArgBytes; ++k) {
+                one[1 + k] = args.args[1 + i * diag::kDeferredArgBytes + k];
+            }
+            const std::size_t m = diag::formatDeferred(" {}", one, text);
+            out.text.append(text.data(), m);
+        }
+        return true;
+    }
+
+    /// Formats defined so far.
+    [[nodiscard]] std::size_t size() const noexcept { return formats_.size(); }
+
+private:
+    struct Entry {
+        std::string tag;
+        std::string format;
+    };
+    std::unordered_map<std::uint32_t, Entry> formats_;
+};
+
+/// Every deferred line in a blackbox file, in file order, rendered through a table built
+/// from the same file. A file that does not open yields no lines.
+[[nodiscard]] inline std::vector<DeferredLogTable::Line> readDeferredLines(
+    std::span<const std::byte> file) {
+    std::vector<DeferredLogTable::Line> lines;
+    diag::blackbox::BlackboxReader reader{file};
+    if (reader.status() != diag::blackbox::ReadStatus::Ok) {
+        return lines;
+    }
+    DeferredLogTable table;
+    diag::blackbox::BlackboxReader::Frame frame;
+    while (reader.next(frame)) {
+        if (frame.type == diag::blackbox::FrameType::FormatDef) {
+            (void)table.define(frame.payload);
+        } else if (frame.type == diag::blackbox::FrameType::LogArgs) {
+            DeferredLogTable::Line line;
+            if (table.render(frame.payload, line)) {
+                lines.push_back(std::move(line));
+            }
+        }
+    }
+    return lines;
+}
+
+}  // namespace shulib::sim
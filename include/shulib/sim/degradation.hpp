@@ -51,10 +51,29 @@
 // from wall-clock, never from a private unseeded source), so a hostile run replays
 // byte-identically from its seed. The identity model draws nothing.
 //
+// ── Checkpointing (saveState / restoreState) ────────────────────────────────────────
+// A SimHarness snapshot (scenario.hpp) must carry the model's CALL-HISTORY state —
+// latency rings, held GPS samples, thermal integrators, the drawn per-boot bias — or a
+// restored run would replay the right physics through a freshly booted model. So a
+// model writes its mutable state, field by field, into a StateWriter, and reads it
+// back in the SAME order from a StateReader. Configuration is NOT state: a branch is
+// restored into a model constructed from the same config, and only what the hooks
+// have changed since travels. The identity model (and any stateless subclass) writes
+// nothing. A stateful subclass that does not override both hooks is not checkpointable
+// — its restored branches would silently diverge — so every sim/hostile/ model does.
+// The bytes are opaque and same-build only: raw object representations, no versioning.
+//
 // Ownership/lifetime: non-owning reference held by DrivePlant; single-task, like the
 // rest of the harness. Virtual-call cost is irrelevant here — this is host-only test
 // infrastructure, never robot code.
 
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "shulib/core/check.hpp"
 #include "shulib/math/angle.hpp"
 #include "shulib/math/pose2d.hpp"
 #include "shulib/sim/rng.hpp"
@@ -70,6 +89,61 @@ struct GpsTruth {
     bool hasFix = true;
 };
 
+/// The bytes a SimSnapshot reserves for the degradation model's state — enough for
+/// FullHostility (its latency rings are ~70 KiB of it), with headroom for a test model.
+inline constexpr std::size_t kDegradationStateBytes = 96 * 1024;
+
+/// The fixed blob a model's state is written into (header: "Checkpointing").
+using DegradationStateBlob = std::array<std::byte, kDegradationStateBytes>;
+
+/// Appends trivially copyable values to a byte span, in call order.
+class StateWriter {
+public:
+    /// Writes into `out`, which must outlive the writer.
+    explicit StateWriter(std::span<std::byte> out) noexcept : out_{out} {}
+
+    /// Append `value`'s object representation. Precondition: it fits.
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "StateWriter: state must be trivially copyable");
+        SHULIB_PRECONDITION(sizeof(T) <= out_.size() - used_,
+                            "StateWriter: the state outgrew kDegradationStateBytes");
+        std::memcpy(out_.data() + used_, &value, sizeof(T));
+        used_ += sizeof(T);
+    }
+
+    /// Bytes written so far.
+    [[nodiscard]] std::size_t used() const noexcept { return used_; }
+
+private:
+    std::span<std::byte> out_;
+    std::size_t used_ = 0;
+};
+
+/// Reads back what a StateWriter wrote, in the same order.
+class StateReader {
+public:
+    /// Reads from `in`, which must outlive the reader.
+    explicit StateReader(std::span<const std::byte> in) noexcept : in_{in} {}
+
+    /// Overwrite `value` with the next sizeof(T) bytes. Precondition: they exist.
+    template <typename T>
+    void read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "StateReader: state must be trivially copyable");
+        SHULIB_PRECONDITION(sizeof(T) <= in_.size() - used_,
+                            "StateReader: the saved state is shorter than this model's");
+        std::memcpy(&value, in_.data() + used_, sizeof(T));
+        used_ += sizeof(T);
+    }
+
+    /// Bytes consumed so far.
+    [[nodiscard]] std::size_t used() const noexcept { return used_; }
+
+private:
+    std::span<const std::byte> in_;
+    std::size_t used_ = 0;
+};
+
 class DegradationModel {
 public:
     virtual ~DegradationModel() = default;
@@ -129,6 +203,12 @@ public:
                                                         Rng& /*rng*/) {
         return nominal;
     }
+
+    /// Checkpoint: write every field the hooks mutate (header). Identity: nothing.
+    virtual void saveState(StateWriter& /*out*/) const {}
+
+    /// Restore what saveState wrote, in the same order. Identity: nothing.
+    virtual void restoreState(StateReader& /*in*/) {}
 };
 
 }  // namespace shulib::sim
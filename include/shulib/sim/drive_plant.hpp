@@ -16,7 +16,7 @@
 //   3. MotorModel::advance() per wheel            (the inverted-feedforward "dynamics")
 //   4. DegradationModel::wheelMotionVelocity()    (A3 slip seam; identity today)
 //   5. IKinematics::forward(motion wheels)        → the TRUE body twist
-//   6. advanceTruth() (RK4 sub-stepping)          → the TRUE pose   [NEVER arcStep —
+//   6. advanceTruthAdaptive() (or fixed RK4)      → the TRUE pose   [NEVER arcStep —
 //        see truth_integrator.hpp; that independence is constraint 2, the one that
 //        keeps every Phase E localization test meaningful]
 //   7. clock.advance(dt)                          (the plant is the ONE time authority,
@@ -25,6 +25,27 @@
 //   9. emitRecord() — one DebugRecord per tick    (A1's lazy-build contract: a
 //        NullSink run never even populates the record)
 //
+// Under PlantDynamics::RigidBody (DrivePlantConfig::dynamics) steps 3–6 become
+// rigid_body.hpp's substep loop: the voltage seam still runs per wheel, the slip seam's
+// motion/spin ratio becomes that wheel's grip for the tick (a slip window is a slick
+// patch), and each substep advances spin and twist by force, integrates truth over the
+// substep and accumulates the encoders. The kinematic default is untouched bit for bit.
+//
+// ── Field contact (DrivePlantConfig::field) ─────────────────────────────────────────
+// With a FieldGeometry (field_geometry.hpp) attached, step 6 is followed by contact: when
+// the new truth overlaps a wall or obstacle it is pushed back out along each contact
+// normal, so a head-on approach ends AT the face and an oblique one keeps its slide. The
+// tracking wheels roll the displacement the body actually made, and the held twist loses
+// its velocity INTO each normal. The wheel spin is NOT touched: against a wall the motors
+// keep turning and the drive encoders keep counting while the tracking wheels stop —
+// exactly the disagreement OdoStallCheck watches. Under RigidBody it runs per substep, so
+// the clipped velocity is momentum lost to the wall, and whether the wheels then scrub or
+// stall is traction against motor force. Distance sensors
+// (attachDistanceSensor) ray-cast the same geometry in step 8; they have no A3 seam.
+// setBodies() adds the other robots of a multi-robot world (sim_world.hpp) as moving
+// boxes: contact and the distance rays treat them as they treat an obstacle, with or
+// without a field. No field and no bodies (the default) is the open floor, bit for bit.
+//
 // DISCRETE-TIME SEMANTICS (zero-order hold, a documented contract): each tick, the
 // wheel velocities advance to their END-of-tick values (steps 3–4) and THAT twist is
 // held constant across the tick for the pose integral (step 6). For kA = 0 configs —
@@ -63,6 +84,7 @@
 //       so a sign error cannot cancel end-to-end.  (→ FakeRotation, cumulative shaft)
 //   * GPS: the true robot-center pose + configured rms/fix      (→ FakeGps)
 //   * Battery: the configured nominal voltage                   (→ FakeBattery)
+//   * Distance: a ray cast against the field, if one is attached (→ FakeDistance)
 //
 // ── Ground truth is the product — and must never leak (constraint 3) ────────────────
 // truePose()/trueBodyTwist()/truthState() exist for the HARNESS and ASSERTIONS only.
@@ -78,20 +100,26 @@
 // IDENTITY ACROSS DIFFERENT libm implementations is not, since cos/sin/exp may differ
 // in the last ulp between C libraries. The suite pins run-to-run identity.)
 //
-// NOT modeled here, on purpose: mass, inertia, torque curves, friction, slip physics
-// (see motor_model.hpp's honesty boundary — this plant proves LOGIC, not CONSTANTS);
+// NOT modeled here by default, on purpose: mass, inertia, torque curves, friction, slip
+// physics (see motor_model.hpp's honesty boundary — this plant proves LOGIC, not
+// CONSTANTS). The opt-in RigidBody mode models them on invented constants (HA-132);
 // hostile behaviours (A3 populates the DegradationModel seams); motion primitives
 // (C1). Single-task by contract, like everything it drives.
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <optional>
 #include <span>
+#include <tuple>
+#include <type_traits>
 
 #include "shulib/core/check.hpp"
 #include "shulib/diag/debug_record.hpp"
 #include "shulib/hal/fake/fake_battery.hpp"
 #include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/hal/fake/fake_distance.hpp"
 #include "shulib/hal/fake/fake_gps.hpp"
 #include "shulib/hal/fake/fake_imu.hpp"
 #include "shulib/hal/fake/fake_motor.hpp"
@@ -103,7 +131,9 @@
 #include "shulib/math/pose2d.hpp"
 #include "shulib/math/twist2d.hpp"
 #include "shulib/sim/degradation.hpp"
+#include "shulib/sim/field_geometry.hpp"
 #include "shulib/sim/motor_model.hpp"
+#include "shulib/sim/rigid_body.hpp"
 #include "shulib/sim/rng.hpp"
 #include "shulib/sim/truth_integrator.hpp"
 #include "shulib/units/quantity.hpp"
@@ -136,7 +166,17 @@ struct DrivePlantConfig {
     /// For drive-encoder synthesis (inches). Diameter AND the implied 1:1 wheel↔shaft
     /// gearing are unmeasured guesses until the drivetrain exists (A4 register HA-13/HA-14).
     units::Length driveWheelDiameter{3.25};
-    int truthSubsteps = 32;                  ///< RK4 substeps per tick (see truth_integrator.hpp)
+    /// How truth is integrated (truth_integrator.hpp): the adaptive integrator by default;
+    /// FixedRk4 reproduces the pre-adaptive plant bit for bit.
+    TruthIntegrator truthIntegrator = TruthIntegrator::Adaptive;
+    int truthSubsteps = 32;                  ///< RK4 substeps per tick — FixedRk4 only
+    /// Kinematic (the default) or RigidBody (rigid_body.hpp: mass, inertia, traction).
+    PlantDynamics dynamics = PlantDynamics::Kinematic;
+    RigidBodyConfig rigidBody{};             ///< RigidBody only
+    /// The walls and obstacles the body collides with (header: "Field contact"); null is
+    /// the open floor. Must outlive the plant; several plants may share one.
+    const FieldGeometry* field = nullptr;
+    RobotFootprint footprint{};              ///< the body's collision rectangle (field, bodies)
     math::Pose2d initialPose{};              ///< truth starts here; sensors seeded to match
     units::Voltage batteryVoltage{12.6};     ///< nominal pack voltage (A3 sags it via the seam; A4 register HA-46)
     units::Length gpsRmsError{1.0};          ///< reported GPS rms (A3 inflates via the seam)
@@ -144,9 +184,38 @@ struct DrivePlantConfig {
     std::uint64_t seed = 1;                  ///< the run's ONE random seed (rng.hpp)
 };
 
+/// Everything a DrivePlant carries from one tick to the next, as one trivially copyable
+/// value — the plant's share of a SimSnapshot (scenario.hpp). The configuration, the
+/// kinematics and the wiring are NOT in it: a state is restored into a plant built the
+/// same way.
+struct DrivePlantState {
+    TruthState truth{};          ///< the true pose
+    math::Twist2d bodyTwist{};   ///< the true body twist held over the last tick
+    /// True per-wheel spin surface speeds (the motor model's state).
+    std::array<units::Velocity, static_cast<std::size_t>(kinematics::WheelSpeeds::kMaxWheels)>
+        wheelSpin{};
+    /// Cumulative drive-encoder shafts (rad).
+    std::array<double, static_cast<std::size_t>(kinematics::WheelSpeeds::kMaxWheels)>
+        driveShaft{};
+    std::array<double, 4> trackingShaft{};  ///< cumulative tracking shafts (rad)
+    /// RigidBody only: the last substep's body-frame linear acceleration (in/s²), which
+    /// load transfer reads. Zero under the kinematic plant.
+    std::array<double, 2> bodyAccel{};
+    bool inContact = false;                 ///< the last tick touched the field
+    Rng rng{0};                             ///< the run's random stream, mid-sequence
+    int wheelCount = 0;                     ///< the plant's wheel count (a restore check)
+    int trackingCount = 0;                  ///< its tracking-wheel count (a restore check)
+};
+static_assert(std::is_trivially_copyable_v<DrivePlantState>,
+              "DrivePlantState must stay trivially copyable (a snapshot is a memcpy)");
+
 class DrivePlant {
 public:
     static constexpr int kMaxTrackingWheels = 4;
+    static constexpr int kMaxDistanceSensors = 4;
+    static_assert(std::tuple_size_v<decltype(DrivePlantState::trackingShaft)>
+                      == static_cast<std::size_t>(kMaxTrackingWheels),
+                  "DrivePlantState::trackingShaft must hold kMaxTrackingWheels shafts");
 
     /// All references/pointees must outlive the plant. `motors` must match
     /// kinematics.wheelCount() and be in the drivetrain's canonical wheel order.
@@ -194,6 +263,9 @@ public:
         SHULIB_PRECONDITION(cfg_.truthSubsteps >= 1, "DrivePlant: truthSubsteps must be >= 1");
         SHULIB_PRECONDITION(cfg_.batteryVoltage.value() >= 0.0,
                             "DrivePlant: batteryVoltage must be >= 0");
+        if (cfg_.dynamics == PlantDynamics::RigidBody) {
+            rigid_.emplace(kin_, cfg_.rigidBody, cfg_.wheelFf);
+        }
 
         // Seed every sensor from the INITIAL truth before any controller runs, so the
         // first tick reads a consistent world (odometry seeded from imu.heading() sees
@@ -212,28 +284,39 @@ public:
         }
         const units::Time now = clock_.now();
 
-        // 1–4: voltage → spin → motion, per wheel, through the A3 seams.
-        kinematics::WheelSpeeds motion{n_};
-        for (int i = 0; i < n_; ++i) {
-            const auto idx = static_cast<std::size_t>(i);
-            const units::Voltage commanded = motors_[idx]->commandedVoltage();
-            const units::Voltage effective =
-                degradation_.effectiveVoltage(i, commanded, now, rng_);
-            wheelSpin_[idx] = model_.advance(wheelSpin_[idx], effective, dt);
-            motion.set(i, degradation_.wheelMotionVelocity(i, wheelSpin_[idx], now, rng_));
-        }
+        if (rigid_) {
+            advanceRigidBody(dt, now);  // 1–6 and the encoders, substep by substep (header)
+        } else {
+            // 1–4: voltage → spin → motion, per wheel, through the A3 seams.
+            kinematics::WheelSpeeds motion{n_};
+            for (int i = 0; i < n_; ++i) {
+                const auto idx = static_cast<std::size_t>(i);
+                const units::Voltage commanded = motors_[idx]->commandedVoltage();
+                const units::Voltage effective =
+                    degradation_.effectiveVoltage(i, commanded, now, rng_);
+                wheelSpin_[idx] = model_.advance(wheelSpin_[idx], effective, dt);
+                motion.set(i, degradation_.wheelMotionVelocity(i, wheelSpin_[idx], now, rng_));
+            }
 
-        // 5: the TRUE body twist, via the frozen F5 contract (header: shared on purpose).
-        bodyTwist_ = kin_.forward(motion);
+            // 5: the TRUE body twist, via the frozen F5 contract (header: shared on purpose).
+            bodyTwist_ = kin_.forward(motion);
 
-        // 6: the TRUE pose, via RK4 — NEVER arcStep (constraint 2; truth_integrator.hpp).
-        truth_ = advanceTruth(truth_, bodyTwist_, dt, cfg_.truthSubsteps);
+            // 6: the TRUE pose — NEVER arcStep (constraint 2; truth_integrator.hpp) —
+            // then field contact, which may clip the twist the encoders integrate.
+            const TruthState from = truth_;
+            truth_ = integrateTruth(from, dt);
+            inContact_ = false;
+            const std::optional<math::Twist2d> held = resolveContacts(from, dt);
+            integrateEncoders(dt);
+            if (held) {
+                bodyTwist_ = *held;
+            }
+        }
 
         // 7: time. The plant is the single time authority (header).
         clock_.advance(dt);
 
         // 8: sensors, from truth, through the seams.
-        integrateEncoders(dt);
         synthesizeSensors();
 
         // 9: one per-tick record — A1's lazy-build contract, so NullSink pays nothing.
@@ -266,10 +349,206 @@ public:
         return w;
     }
 
+    /// Per-wheel spin minus the speed its contact point moves at (toWheels of the true
+    /// twist): zero for a rolling wheel, the slide for a slipping one. Under the kinematic
+    /// plant it is what the slip seam took away.
+    [[nodiscard]] kinematics::WheelSpeeds trueWheelSlip() const {
+        const kinematics::WheelSpeeds contact = kin_.toWheels(math::ChassisSpeeds{
+            bodyTwist_.vx(), bodyTwist_.vy(), bodyTwist_.omega()});
+        kinematics::WheelSpeeds w{n_};
+        for (int i = 0; i < n_; ++i) {
+            w.set(i, units::Velocity{wheelSpin_[static_cast<std::size_t>(i)].value()
+                                     - contact[i].value()});
+        }
+        return w;
+    }
+
+    /// The last tick's body touched a wall, an obstacle or a body (header: "Field contact").
+    [[nodiscard]] bool inContact() const noexcept { return inContact_; }
+
+    /// The body's collision rectangle (DrivePlantConfig::footprint).
+    [[nodiscard]] const RobotFootprint& footprint() const noexcept { return cfg_.footprint; }
+
+    /// The other robots, as boxes this body collides with and its distance sensors see
+    /// (header: "Field contact"); empty for none. Not copied: `bodies` must stay valid
+    /// until the next call. Not plant state — a checkpoint neither holds nor restores it.
+    void setBodies(std::span<const FieldBox> bodies) noexcept { bodies_ = bodies; }
+
+    /// Synthesize `sensor` each tick from a ray cast against the field at `mount`
+    /// (field_geometry.hpp senseDistance); it is seeded now. Requires a field; at most
+    /// kMaxDistanceSensors. `sensor` must outlive the plant.
+    void attachDistanceSensor(hal::fake::FakeDistance& sensor, const DistanceMount& mount) {
+        SHULIB_PRECONDITION(cfg_.field != nullptr,
+                            "DrivePlant::attachDistanceSensor: needs DrivePlantConfig::field");
+        SHULIB_PRECONDITION(nDistance_ < kMaxDistanceSensors,
+                            "DrivePlant::attachDistanceSensor: too many distance sensors");
+        SHULIB_PRECONDITION(mount.maxRange.value() > 0.0,
+                            "DrivePlant::attachDistanceSensor: maxRange must be > 0");
+        const auto idx = static_cast<std::size_t>(nDistance_);
+        distance_[idx] = &sensor;
+        distanceMount_[idx] = mount;
+        ++nDistance_;
+        synthesizeDistances();
+    }
+
+    /// Move the truth to `pose` — a teleport, for a harness driven from outside (the sim
+    /// server's `pose`) — and re-synthesize every sensor from it, so the next reader sees
+    /// the new world. Spin, encoder shafts and the clock are kept; the synthesis draws
+    /// through its seams as a tick's does.
+    void setTruePose(const math::Pose2d& pose) {
+        truth_ = TruthState{pose.x().value(), pose.y().value(), pose.heading().radians()};
+        synthesizeSensors();
+    }
+
+    /// Which dynamics this plant runs.
+    [[nodiscard]] PlantDynamics dynamics() const noexcept { return cfg_.dynamics; }
+
     /// The run's one seeded random source (scenario generation + A3 degradation draws).
     [[nodiscard]] Rng& rng() noexcept { return rng_; }
 
+    // ── Checkpoint (SimHarness::snapshot/restore) ──────────────────────────────────
+    /// The between-tick state: truth, spin, encoder shafts and the Rng.
+    [[nodiscard]] DrivePlantState state() const noexcept {
+        DrivePlantState st;
+        st.truth = truth_;
+        st.bodyTwist = bodyTwist_;
+        st.wheelSpin = wheelSpin_;
+        st.driveShaft = driveShaft_;
+        st.trackingShaft = trackingShaft_;
+        st.bodyAccel = bodyAccel_;
+        st.inContact = inContact_;
+        st.rng = rng_;
+        st.wheelCount = n_;
+        st.trackingCount = nTracking_;
+        return st;
+    }
+
+    /// Resume from `st`, taken from a plant wired the same way. Touches neither the
+    /// clock nor the seamed fakes (a synthesis would consume draws and degradation
+    /// state): the harness restores those alongside. Distance sensors, which draw
+    /// nothing, are re-synthesized from the restored truth.
+    void restore(const DrivePlantState& st) {
+        SHULIB_PRECONDITION(st.wheelCount == n_ && st.trackingCount == nTracking_,
+                            "DrivePlant::restore: the state is from a differently wired plant");
+        truth_ = st.truth;
+        bodyTwist_ = st.bodyTwist;
+        wheelSpin_ = st.wheelSpin;
+        driveShaft_ = st.driveShaft;
+        trackingShaft_ = st.trackingShaft;
+        bodyAccel_ = st.bodyAccel;
+        inContact_ = st.inContact;
+        rng_ = st.rng;
+        synthesizeDistances();
+    }
+
 private:
+    /// The configured truth integrator over one constant-twist interval.
+    [[nodiscard]] TruthState integrateTruth(const TruthState& from, units::Time dt) const {
+        return cfg_.truthIntegrator == TruthIntegrator::FixedRk4
+                   ? advanceTruth(from, bodyTwist_, dt, cfg_.truthSubsteps)
+                   : advanceTruthAdaptive(from, bodyTwist_, dt);
+    }
+
+    /// Steps 1–6 under PlantDynamics::RigidBody (header). The seams run once per wheel per
+    /// tick in the kinematic order — voltage, then slip — so the draw stream keeps its shape.
+    void advanceRigidBody(units::Time dt, units::Time now) {
+        RigidBodyModel::Volts effective{};
+        RigidBodyModel::Grips grip{};
+        for (int i = 0; i < n_; ++i) {
+            const auto idx = static_cast<std::size_t>(i);
+            effective[idx] =
+                degradation_.effectiveVoltage(i, motors_[idx]->commandedVoltage(), now, rng_);
+            const double spin = wheelSpin_[idx].value();
+            const double motion =
+                degradation_.wheelMotionVelocity(i, wheelSpin_[idx], now, rng_).value();
+            grip[idx] = spin != 0.0 ? std::clamp(motion / spin, 0.0, 1.0) : 1.0;
+        }
+        const units::Time h{dt.value() / static_cast<double>(rigid_->substeps())};
+        inContact_ = false;
+        for (int k = 0; k < rigid_->substeps(); ++k) {
+            rigid_->substep(effective, grip, h.value(), bodyTwist_, wheelSpin_, bodyAccel_);
+            const TruthState from = truth_;
+            truth_ = integrateTruth(from, h);  // NEVER arcStep (constraint 2)
+            const std::optional<math::Twist2d> held = resolveContacts(from, h);
+            integrateEncoders(h);
+            if (held) {
+                bodyTwist_ = *held;  // the velocity the wall took is momentum gone
+            }
+        }
+    }
+
+    /// Field contact after a truth step from `from` over `dt` (header). Pushes the new truth
+    /// out of every shape it entered (deepest first), leaves bodyTwist_ as the twist that
+    /// step actually travelled — what the tracking wheels must roll this tick — and returns
+    /// the held twist for the next one: the old twist minus its velocity into each contact.
+    /// Nothing when there was no contact. Wheel spin is left alone.
+    [[nodiscard]] std::optional<math::Twist2d> resolveContacts(const TruthState& from,
+                                                               units::Time dt) {
+        if (cfg_.field == nullptr && bodies_.empty()) {
+            return std::nullopt;
+        }
+        FieldContacts hits = contactsAt(truth_.pose());
+        if (hits.count == 0) {
+            return std::nullopt;
+        }
+        inContact_ = true;
+
+        // The held twist: field-frame velocity clipped into each normal, twice (a corner's
+        // second wall can undo the first), in the frame of the heading the step ends on.
+        const double w = bodyTwist_.omega().value();
+        const double c = std::cos(truth_.theta);
+        const double s = std::sin(truth_.theta);
+        const double bx = bodyTwist_.vx().value();
+        const double by = bodyTwist_.vy().value();
+        double vx = c * bx - s * by;
+        double vy = s * bx + c * by;
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int k = 0; k < hits.count; ++k) {
+                const FieldContact& h = hits.items[static_cast<std::size_t>(k)];
+                const double into = vx * h.nx + vy * h.ny;
+                if (into < 0.0) {
+                    vx -= into * h.nx;
+                    vy -= into * h.ny;
+                }
+            }
+        }
+        const math::Twist2d held{units::Velocity{c * vx + s * vy},
+                                 units::Velocity{-s * vx + c * vy}, bodyTwist_.omega()};
+
+        for (int pass = 0; pass < 4; ++pass) {  // deepest first; a corner needs two
+            const FieldContact* deepest = &hits.items[0];
+            for (int k = 1; k < hits.count; ++k) {
+                if (hits.items[static_cast<std::size_t>(k)].depth > deepest->depth) {
+                    deepest = &hits.items[static_cast<std::size_t>(k)];
+                }
+            }
+            truth_.x += deepest->nx * deepest->depth;
+            truth_.y += deepest->ny * deepest->depth;
+            hits = contactsAt(truth_.pose());
+            if (hits.count == 0) {
+                break;
+            }
+        }
+
+        // The travelled twist: the displacement over dt in the body frame at the step's
+        // mid heading — exact for a non-turning body, second order in ω·dt otherwise.
+        const double mid = from.theta + 0.5 * w * dt.value();
+        const double dx = (truth_.x - from.x) / dt.value();
+        const double dy = (truth_.y - from.y) / dt.value();
+        bodyTwist_ = math::Twist2d{units::Velocity{std::cos(mid) * dx + std::sin(mid) * dy},
+                                   units::Velocity{-std::sin(mid) * dx + std::cos(mid) * dy},
+                                   bodyTwist_.omega()};
+        return held;
+    }
+
+    /// The field's contacts at `pose`, then the bodies'.
+    [[nodiscard]] FieldContacts contactsAt(const math::Pose2d& pose) const {
+        FieldContacts hits =
+            cfg_.field != nullptr ? cfg_.field->contacts(pose, cfg_.footprint) : FieldContacts{};
+        FieldGeometry::bodyContacts(pose, cfg_.footprint, bodies_, hits);
+        return hits;
+    }
+
     /// Advance the cumulative encoder shafts by this tick's travel (constant twist
     /// over the tick ⇒ travel = velocity·dt exactly; no quadrature needed because
     /// BODY-frame rates are constant even when the field path curves).
@@ -323,6 +602,18 @@ private:
         gps_.setHasFix(g.hasFix);
 
         battery_.setVoltage(degradation_.batteryVoltage(cfg_.batteryVoltage, now, rng_));
+        synthesizeDistances();
+    }
+
+    /// Ray-cast every attached distance sensor from the current truth (no seam, no draws).
+    void synthesizeDistances() {
+        for (int i = 0; i < nDistance_; ++i) {
+            const auto idx = static_cast<std::size_t>(i);
+            const DistanceReading d =
+                senseDistance(*cfg_.field, truth_.pose(), distanceMount_[idx], bodies_);
+            distance_[idx]->setDistance(d.distance);
+            distance_[idx]->setConfidence(d.confidence);
+        }
     }
 
     const kinematics::IKinematics& kin_;
@@ -349,6 +640,13 @@ private:
     std::array<double, static_cast<std::size_t>(kinematics::WheelSpeeds::kMaxWheels)>
         driveShaft_{};  // cumulative radians
     std::array<double, static_cast<std::size_t>(kMaxTrackingWheels)> trackingShaft_{};  // radians
+    std::optional<RigidBodyModel> rigid_;  // engaged under PlantDynamics::RigidBody
+    std::array<double, 2> bodyAccel_{};    // RigidBody: last substep's, for load transfer
+    bool inContact_ = false;               // the last tick touched the field
+    std::array<hal::fake::FakeDistance*, static_cast<std::size_t>(kMaxDistanceSensors)> distance_{};
+    std::array<DistanceMount, static_cast<std::size_t>(kMaxDistanceSensors)> distanceMount_{};
+    int nDistance_ = 0;
+    std::span<const FieldBox> bodies_{};  // the other robots (setBodies)
 };
 
 }  // namespace shulib::sim
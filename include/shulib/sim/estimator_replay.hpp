@@ -0,0 +1,281 @@
+#pragma once
+//
+// sim::replayEstimator — re-run the estimator OFFLINE over a recorded blackbox file, as
+// fast as the host can go, and measure how far a different configuration would have
+// landed from the pose the robot actually published.
+//
+// ── What a file has to carry ────────────────────────────────────────────────────────
+// A tick record says what the estimator CONCLUDED; a replay needs what it READ. Since
+// this file the Localizer keeps the raw readings each tick consumed (lastInputs():
+// the IMU's ready flag, raw heading and yaw rate, both tracking-wheel shafts, and the
+// GPS corrector's fix/pose/rms as it read them), the scheduler's stamping decorator
+// copies them onto every record, and SdSink writes them as an EstimatorInputs frame
+// right behind the tick frame (blackbox_format.hpp). loadReplayTicks() pairs the two
+// back up. A record with no inputs frame — a file from before this change, or a hand-
+// emitted record — cannot be replayed and is left out.
+//
+// ── How a replay runs ───────────────────────────────────────────────────────────────
+// The recorded readings are fed through the ordinary fakes (FakeClock, FakeImu,
+// FakeRotation, FakeGps) into a freshly built PilonsOdometry + Localizer under the
+// CANDIDATE configuration: the same code the robot ran, stepped once per recorded
+// tick with the recorded timestamps, no plant and no sleeping. Replaying a file under
+// the configuration that recorded it therefore reproduces the recorded pose stream
+// (pinned by test); any other configuration's divergence from it is the number this
+// file exists to produce.
+//
+// Seeding: the replay's odometry is baselined on the first record's shafts and its
+// fused position starts at the first record's pose, so the first replayed tick folds
+// nothing and lands exactly on the recorded pose. From there the replay is exact for
+// a recording that starts at boot, where every piece of estimator state starts as
+// empty as the replay's does. A recording that starts mid-run (a fault flight-ring
+// dump) cannot hand over the GPS corrector's history, the fusion's state or a learned
+// heading bias: its first seconds diverge by a little that is an artefact of the cut,
+// not a finding about the configuration.
+//
+// ── Honest scope ────────────────────────────────────────────────────────────────────
+//   * GPS is the one corrector replayed. AprilTagCorrector's inputs are a batch of
+//     detections per frame, not a fixed handful of numbers, and it does not capture
+//     them (ICorrector::captureInputs() defaults to nothing), so a tag-corrected run
+//     replays as if it had no tag source — its heading bias in particular.
+//   * The reference is the RECORDED estimate, not ground truth: these statistics say
+//     "how different", never "how much better". A sim recording can be scored against
+//     truth separately, with the harness that produced it.
+//   * replayGrid() runs the configurations on std::thread, one Localizer per
+//     configuration and the ticks shared read-only. tools/shulib_replay is the same call
+//     over a file and a text grid (sim/replay_grid.hpp). A toolchain without threads
+//     (__STDCPP_THREADS__ undefined — the V5's arm-none-eabi, which the ARM compile gate
+//     builds every header for) runs the same grid serially.
+//
+// Host-only: allocation, threads and exceptions are fine here; this never runs on
+// the V5.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <span>
+#include <vector>
+#if defined(__STDCPP_THREADS__)
+#include <thread>
+#endif
+
+#include "shulib/diag/blackbox_format.hpp"
+#include "shulib/diag/blackbox_reader.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/hal/fake/fake_gps.hpp"
+#include "shulib/hal/fake/fake_imu.hpp"
+#include "shulib/hal/fake/fake_rotation.hpp"
+#include "shulib/localization/complementary_fusion.hpp"
+#include "shulib/localization/correction.hpp"
+#include "shulib/localization/ekf_fusion.hpp"
+#include "shulib/localization/gps_corrector.hpp"
+#include "shulib/localization/i_corrector.hpp"
+#include "shulib/localization/i_fusion_policy.hpp"
+#include "shulib/localization/localizer.hpp"
+#include "shulib/localization/pilons_odometry.hpp"
+#include "shulib/localization/tracking_wheel.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::sim {
+
+/// Which fusion policy a replay builds.
+enum class ReplayFusion {
+    Complementary,  ///< localization::ComplementaryFusion (the default tier)
+    Ekf,            ///< localization::EkfFusion (E4)
+};
+
+/// One candidate estimator configuration: everything a replay constructs. The geometry
+/// defaults are SimHarnessConfig's, so a sim recording replays as recorded out of the box;
+/// a robot recording must be given the robot's wheel geometry.
+struct EstimatorReplayConfig {
+    units::Length trackingWheelDiameter{2.0};       ///< both tracking wheels (in)
+    units::Length forwardWheelLeftOffset{-3.0};     ///< forward wheel's +LEFT coordinate
+    units::Length lateralWheelForwardOffset{-4.5};  ///< lateral wheel's +FORWARD coordinate
+    localization::PilonsOdometryConfig odometry{};  ///< the odometry's trust gate
+    localization::LocalizerConfig localizer{};      ///< dt band, drift horizon, settle window
+    bool useGps = true;                             ///< register a GpsCorrector at all
+    localization::GpsCorrectorConfig gps{};         ///< used when useGps
+    ReplayFusion fusion = ReplayFusion::Complementary;  ///< which policy to build
+    localization::ComplementaryFusionConfig complementary{};  ///< used for Complementary
+    localization::EkfFusionConfig ekf{};                      ///< used for Ekf
+};
+
+/// How far a replay's pose stream landed from the recorded one. Position errors are
+/// planar distances (in), heading errors wrap-correct (rad); all zero for no ticks.
+struct ReplayStats {
+    std::size_t ticks = 0;              ///< ticks replayed
+    double meanPositionError = 0.0;     ///< mean |replayed − recorded| position
+    double rmsPositionError = 0.0;      ///< RMS of the same
+    double maxPositionError = 0.0;      ///< worst single tick
+    double finalPositionError = 0.0;    ///< at the last tick — where the run ended up
+    double rmsHeadingError = 0.0;       ///< RMS heading difference
+    double maxHeadingError = 0.0;       ///< worst single-tick |heading difference|
+    std::size_t acceptedTicks = 0;      ///< ticks the replay folded a correction
+    std::size_t rejectedTicks = 0;      ///< ticks a proposal was made and turned down
+};
+
+/// Pull every replayable tick out of a blackbox file (v1 or v2) into `out` (appended, in
+/// file order): each tick record that is followed by its EstimatorInputs frame, with the
+/// inputs filled in. Records without inputs are left out, as is a record whose time does
+/// not move forward — the scheduler can emit more than one record in a tick, and all of
+/// them carry the same inputs, so only the first is a tick to replay. Returns the
+/// reader's verdict; anything but Ok appends nothing.
+[[nodiscard]] inline diag::blackbox::ReadStatus loadReplayTicks(std::span<const std::byte> file,
+                                                              std::vector<diag::DebugRecord>& out) {
+    namespace bb = diag::blackbox;
+    bb::BlackboxReader reader{file};
+    bb::BlackboxReader::Frame frame;
+    diag::DebugRecord current;
+    bool pending = false;
+    bool corrupt = false;
+    while (reader.next(frame)) {
+        if (frame.type == bb::FrameType::EstimatorInputs) {
+            if (pending && bb::decodeEstimatorInputs(frame.payload, current, corrupt)
+                && (out.empty() || current.t.value() > out.back().t.value())) {
+                out.push_back(current);
+            }
+            pending = false;
+            continue;
+        }
+        // Every tick frame goes through readTick(), kept or not: compact ticks are a chain.
+        diag::DebugRecord r;
+        if (reader.readTick(frame, r, corrupt)) {
+            current = r;
+            pending = true;
+        } else {
+            pending = false;
+        }
+    }
+    return reader.status();
+}
+
+/// Replay `ticks` (loadReplayTicks() order) through a Localizer built from `cfg` and
+/// compare its pose with each record's measuredPose (file banner). Deterministic: the
+/// same ticks and config give bit-identical stats. Throws only what the estimator's
+/// constructors throw for an invalid config.
+[[nodiscard]] inline ReplayStats replayEstimator(std::span<const diag::DebugRecord> ticks,
+                                                 const EstimatorReplayConfig& cfg) {
+    ReplayStats stats;
+    if (ticks.empty()) {
+        return stats;
+    }
+    const diag::DebugRecord& first = ticks.front();
+    hal::fake::FakeClock clock{first.t};
+    hal::fake::FakeImu imu;
+    hal::fake::FakeGps gps;
+    hal::fake::FakeRotation forwardShaft;
+    hal::fake::FakeRotation lateralShaft;
+    const auto feed = [&](const diag::DebugRecord& r) {
+        clock.set(r.t);
+        imu.setReady(r.inputImuReady);
+        imu.setHeading(r.inputImuHeading);
+        imu.setYawRate(r.inputImuYawRate);
+        forwardShaft.setPosition(r.inputForwardShaft);
+        lateralShaft.setPosition(r.inputLateralShaft);
+        gps.setHasFix(r.inputGpsFix);
+        gps.setPose(r.inputGpsPose);
+        gps.setRmsError(r.inputGpsRmsError);
+    };
+    feed(first);
+
+    localization::PilonsOdometry odom{
+        imu,
+        localization::TrackingWheel::forward(forwardShaft, cfg.trackingWheelDiameter,
+                                             cfg.forwardWheelLeftOffset),
+        localization::TrackingWheel::lateral(lateralShaft, cfg.trackingWheelDiameter,
+                                             cfg.lateralWheelForwardOffset),
+        first.measuredPose, cfg.odometry};
+    localization::ComplementaryFusion complementary{cfg.complementary};
+    localization::EkfFusion ekf{cfg.ekf};
+    localization::IFusionPolicy& fusion =
+        cfg.fusion == ReplayFusion::Ekf ? static_cast<localization::IFusionPolicy&>(ekf)
+                                        : static_cast<localization::IFusionPolicy&>(complementary);
+    localization::GpsCorrector gpsCorrector{clock, gps, imu, cfg.gps};
+    const std::array<localization::ICorrector*, 1> correctors{&gpsCorrector};
+    localization::Localizer loc{
+        clock, imu, odom, fusion,
+        cfg.useGps ? std::span<localization::ICorrector* const>{correctors}
+                   : std::span<localization::ICorrector* const>{},
+        cfg.localizer};
+
+    double sumPos = 0.0;
+    double sumPos2 = 0.0;
+    double sumHead2 = 0.0;
+    for (const diag::DebugRecord& r : ticks) {
+        feed(r);
+        loc.update();
+        const math::Pose2d p = loc.pose();
+        const double pos = std::hypot(p.x().value() - r.measuredPose.x().value(),
+                                      p.y().value() - r.measuredPose.y().value());
+        const double head = std::abs(r.measuredPose.heading().errorTo(p.heading()));
+        sumPos += pos;
+        sumPos2 += pos * pos;
+        sumHead2 += head * head;
+        stats.maxPositionError = std::max(stats.maxPositionError, pos);
+        stats.maxHeadingError = std::max(stats.maxHeadingError, head);
+        stats.finalPositionError = pos;
+        const diag::GateReason reason = loc.lastCorrection().audit.reason;
+        if (reason == diag::GateReason::Accepted) {
+            ++stats.acceptedTicks;
+        } else if (reason != diag::GateReason::None) {
+            ++stats.rejectedTicks;
+        }
+        ++stats.ticks;
+    }
+    const auto n = static_cast<double>(stats.ticks);
+    stats.meanPositionError = sumPos / n;
+    stats.rmsPositionError = std::sqrt(sumPos2 / n);
+    stats.rmsHeadingError = std::sqrt(sumHead2 / n);
+    return stats;
+}
+
+/// replayEstimator() for every config in `grid` over the same ticks, spread across up
+/// to `threads` std::threads (0 → hardware_concurrency()). Result i belongs to grid[i],
+/// and each equals what a serial replayEstimator() call returns — the replays share
+/// nothing but the read-only ticks. An exception from any replay is rethrown after all
+/// threads have joined. Serial, whatever `threads` says, without __STDCPP_THREADS__.
+[[nodiscard]] inline std::vector<ReplayStats> replayGrid(std::span<const diag::DebugRecord> ticks,
+                                                         std::span<const EstimatorReplayConfig> grid,
+                                                         unsigned threads = 0) {
+    std::vector<ReplayStats> results(grid.size());
+    std::vector<std::exception_ptr> errors(grid.size());
+    std::atomic<std::size_t> nextConfig{0};
+    const auto worker = [&]() {
+        for (std::size_t i = nextConfig.fetch_add(1); i < grid.size();
+             i = nextConfig.fetch_add(1)) {
+            try {
+                results[i] = replayEstimator(ticks, grid[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+#if defined(__STDCPP_THREADS__)
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, grid.size()));
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    for (std::thread& t : pool) {
+        t.join();
+    }
+#else
+    (void)threads;
+    worker();
+#endif
+    for (const std::exception_ptr& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+    return results;
+}
+
+}  // namespace shulib::sim
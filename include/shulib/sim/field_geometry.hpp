@@ -0,0 +1,463 @@
+#pragma once
+//
+// sim::FieldGeometry — the static field the plant's body collides with and its distance
+// sensors see: the perimeter walls plus a handful of circular and rectangular obstacles.
+//
+// Without it the plant's truth drives straight through the perimeter, so nothing that
+// happens AT a wall — docking, squaring up against it, getting pinned by a defender's
+// goal — can be tested, and those are exactly the runs where OdoStallCheck and stall
+// detection earn their keep.
+//
+// ── Frames and shapes ───────────────────────────────────────────────────────────────
+// Everything is in the FIELD frame (F1: inches, origin at the field centre). The
+// perimeter is an axis-aligned square of half-size perimeterHalf (0 → no walls);
+// vexField() is the 6×6 grid of 24 in tiles, ±72 in. Obstacles are circles and oriented
+// boxes, at most kMaxObstacles, fixed at setup. The robot is its RobotFootprint: a
+// rectangle centred on the robot origin, aligned with its heading.
+//
+// ── Contacts ────────────────────────────────────────────────────────────────────────
+// contacts() reports every shape the footprint overlaps at a pose as a unit normal (world
+// frame, pointing OUT of the shape, i.e. the way to push the robot) and a depth (in):
+//   * walls: the deepest footprint corner past each wall;
+//   * circles: the closest point of the footprint to the centre;
+//   * boxes: the separating-axis test over the four edge normals, reporting the axis of
+//     least overlap.
+// BROADPHASE: obstacles are kept sorted by their bounding box's min x (sort and sweep on
+// one axis); a query walks them until one starts past the footprint's max x and skips any
+// whose box misses in y, so the narrowphase only runs on shapes that could touch. A fixed
+// handful of shapes never needs more.
+//
+// The plant owns the response (drive_plant.hpp "Field contact"): it pushes the body back
+// out along each normal — a head-on push stops at the face, an oblique one slides along
+// it — and drops the velocity into the contact. The wheels keep turning through all of
+// it, so the drive encoders count travel the tracking wheels never see.
+//
+// ── Other robots ────────────────────────────────────────────────────────────────────
+// Robots move, so they cannot sit in the sorted obstacle list. bodyContacts() tests a
+// footprint against a caller's list of FieldBoxes instead — the other robots of a
+// multi-robot world (sim_world.hpp), each its own footprint at its own pose — with the
+// box narrowphase above and no broadphase (there are at most a few). castRay() and
+// senseDistance() take the same list, so a distance sensor sees a partner robot.
+//
+// ── Distance sensors ────────────────────────────────────────────────────────────────
+// castRay() intersects a ray with the same shapes (walls from the inside; the robot itself
+// is not an obstacle). senseDistance() places a DistanceMount on a pose and reports the
+// hit, or maxRange at zero confidence on a miss — IDistance's "nothing in range" shape.
+//
+// Honest scope: shapes are static and frictionless (contact slides freely), nothing
+// rotates the body on impact (a corner strike is pushed out, not spun), and no more than
+// FieldContacts::kMax contacts are reported at once — the deepest are not preferred.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <span>
+
+#include "shulib/core/check.hpp"
+#include "shulib/math/angle.hpp"
+#include "shulib/math/pose2d.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::sim {
+
+/// The robot's collision rectangle, centred on the robot origin and aligned with its
+/// heading. The default is the 18 in starting-size cube.
+struct RobotFootprint {
+    units::Length halfLength{9.0};  ///< along the heading (in)
+    units::Length halfWidth{9.0};   ///< across it (in)
+};
+
+/// A circular obstacle (a goal base, a post).
+struct FieldCircle {
+    units::Length x{};       ///< centre, field frame
+    units::Length y{};       ///< centre, field frame
+    units::Length radius{};  ///< > 0
+};
+
+/// A rectangular obstacle, oriented by `heading` (its half-length runs along it).
+struct FieldBox {
+    units::Length x{};           ///< centre, field frame
+    units::Length y{};           ///< centre, field frame
+    units::Length halfLength{};  ///< along `heading`, > 0
+    units::Length halfWidth{};   ///< across it, > 0
+    math::Angle heading{};       ///< orientation in the field
+};
+
+/// One overlap: push the robot `depth` inches along the unit normal (nx, ny).
+struct FieldContact {
+    double nx = 0.0;     ///< unit normal, field frame, out of the shape
+    double ny = 0.0;     ///< unit normal, field frame, out of the shape
+    double depth = 0.0;  ///< penetration (in), > 0
+};
+
+/// Every contact at one pose, up to kMax.
+struct FieldContacts {
+    static constexpr int kMax = 8;
+    std::array<FieldContact, static_cast<std::size_t>(kMax)> items{};
+    int count = 0;
+
+    /// Append, dropping anything past kMax (header: honest scope).
+    void add(const FieldContact& c) noexcept {
+        if (count < kMax) {
+            items[static_cast<std::size_t>(count)] = c;
+            ++count;
+        }
+    }
+};
+
+/// Where a distance sensor sits on the robot and how far it can see.
+struct DistanceMount {
+    units::Length forward{};        ///< +FORWARD offset from the robot origin
+    units::Length left{};           ///< +LEFT offset from the robot origin
+    math::Angle heading{};          ///< beam direction relative to the robot's heading
+    units::Length maxRange{78.0};   ///< beyond this nothing is seen (V5: 2000 mm)
+};
+
+/// What a distance sensor reads (IDistance's two channels).
+struct DistanceReading {
+    units::Length distance{};  ///< to the hit, or maxRange on a miss
+    double confidence = 0.0;   ///< 1 on a hit, 0 on a miss
+};
+
+class FieldGeometry {
+public:
+    static constexpr int kMaxObstacles = 16;
+    /// The VRC field: a 6×6 grid of 24 in tiles inside the perimeter.
+    static constexpr double kVexFieldHalf = 72.0;
+
+    /// The open floor: no walls, no obstacles.
+    FieldGeometry() = default;
+
+    /// The perimeter alone, ±kVexFieldHalf.
+    [[nodiscard]] static FieldGeometry vexField() {
+        FieldGeometry f;
+        f.setPerimeter(units::Length{kVexFieldHalf});
+        return f;
+    }
+
+    /// Walls at ±half on both axes. half > 0.
+    void setPerimeter(units::Length half) {
+        SHULIB_PRECONDITION(std::isfinite(half.value()) && half.value() > 0.0,
+                            "FieldGeometry: perimeter half-size must be finite and > 0");
+        perimeterHalf_ = half.value();
+    }
+
+    void addCircle(const FieldCircle& c) {
+        SHULIB_PRECONDITION(c.radius.value() > 0.0, "FieldGeometry: circle radius must be > 0");
+        Obstacle o;
+        o.circle = true;
+        o.x = c.x.value();
+        o.y = c.y.value();
+        o.halfLength = o.halfWidth = c.radius.value();
+        add(o);
+    }
+
+    void addBox(const FieldBox& b) {
+        SHULIB_PRECONDITION(b.halfLength.value() > 0.0 && b.halfWidth.value() > 0.0,
+                            "FieldGeometry: box half-extents must be > 0");
+        add(boxObstacle(b));
+    }
+
+    [[nodiscard]] double perimeterHalf() const noexcept { return perimeterHalf_; }
+    [[nodiscard]] int obstacleCount() const noexcept { return count_; }
+
+    /// Every shape `footprint` overlaps at `pose` (header: "Contacts").
+    [[nodiscard]] FieldContacts contacts(const math::Pose2d& pose,
+                                         const RobotFootprint& footprint) const {
+        const Rect r = rectOf(pose, footprint);
+        FieldContacts out;
+        if (perimeterHalf_ > 0.0) {
+            wallContacts(r, out);
+        }
+        const double ex = r.hl * std::abs(r.c) + r.hw * std::abs(r.s);
+        const double ey = r.hl * std::abs(r.s) + r.hw * std::abs(r.c);
+        for (int i = 0; i < count_; ++i) {
+            const Obstacle& o = obstacles_[static_cast<std::size_t>(i)];
+            if (o.minX > r.x + ex) {
+                break;  // sorted by minX: nothing further can reach
+            }
+            if (o.maxX < r.x - ex || o.minY > r.y + ey || o.maxY < r.y - ey) {
+                continue;
+            }
+            if (o.circle) {
+                circleContact(r, o, out);
+            } else {
+                boxContact(r, o, out);
+            }
+        }
+        return out;
+    }
+
+    /// Append every one of `bodies` that `footprint` overlaps at `pose` to `out` (header:
+    /// "Other robots").
+    static void bodyContacts(const math::Pose2d& pose, const RobotFootprint& footprint,
+                             std::span<const FieldBox> bodies, FieldContacts& out) {
+        if (bodies.empty()) {
+            return;
+        }
+        const Rect r = rectOf(pose, footprint);
+        for (const FieldBox& b : bodies) {
+            boxContact(r, boxObstacle(b), out);
+        }
+    }
+
+    /// Distance along the ray from (x, y) at `heading` to the first shape — or to one of
+    /// `bodies` (header: "Other robots") — if within maxRange. A start inside an obstacle
+    /// hits at 0.
+    [[nodiscard]] std::optional<double> castRay(double x, double y, math::Angle heading,
+                                                double maxRange,
+                                                std::span<const FieldBox> bodies = {}) const {
+        const double dx = std::cos(heading.radians());
+        const double dy = std::sin(heading.radians());
+        double best = std::numeric_limits<double>::infinity();
+        if (perimeterHalf_ > 0.0) {
+            if (dx != 0.0) {
+                best = std::min(best, ((dx > 0.0 ? perimeterHalf_ : -perimeterHalf_) - x) / dx);
+            }
+            if (dy != 0.0) {
+                best = std::min(best, ((dy > 0.0 ? perimeterHalf_ : -perimeterHalf_) - y) / dy);
+            }
+            best = std::max(best, 0.0);
+        }
+        for (int i = 0; i < count_; ++i) {
+            const Obstacle& o = obstacles_[static_cast<std::size_t>(i)];
+            const double t = o.circle ? rayCircle(o, x, y, dx, dy) : rayBox(o, x, y, dx, dy);
+            best = std::min(best, t);
+        }
+        for (const FieldBox& b : bodies) {
+            best = std::min(best, rayBox(boxObstacle(b), x, y, dx, dy));
+        }
+        if (best <= maxRange) {
+            return best;
+        }
+        return std::nullopt;
+    }
+
+private:
+    /// One obstacle, precomputed: a circle uses halfLength as its radius; a box carries its
+    /// heading's cos/sin. Both carry their field-frame bounding box for the broadphase.
+    struct Obstacle {
+        bool circle = false;
+        double x = 0.0;
+        double y = 0.0;
+        double halfLength = 0.0;
+        double halfWidth = 0.0;
+        double c = 1.0;
+        double s = 0.0;
+        double minX = 0.0;
+        double maxX = 0.0;
+        double minY = 0.0;
+        double maxY = 0.0;
+    };
+
+    /// The footprint at a pose, in the same shape as a box obstacle.
+    struct Rect {
+        double x, y, hl, hw, c, s;
+    };
+
+    [[nodiscard]] static Rect rectOf(const math::Pose2d& pose, const RobotFootprint& fp) {
+        const double th = pose.heading().radians();
+        return Rect{pose.x().value(), pose.y().value(), fp.halfLength.value(),
+                    fp.halfWidth.value(), std::cos(th), std::sin(th)};
+    }
+
+    /// A box as an Obstacle (its bounding box is add()'s to fill).
+    [[nodiscard]] static Obstacle boxObstacle(const FieldBox& b) {
+        Obstacle o;
+        o.x = b.x.value();
+        o.y = b.y.value();
+        o.halfLength = b.halfLength.value();
+        o.halfWidth = b.halfWidth.value();
+        o.c = std::cos(b.heading.radians());
+        o.s = std::sin(b.heading.radians());
+        return o;
+    }
+
+    void add(Obstacle o) {
+        SHULIB_PRECONDITION(count_ < kMaxObstacles, "FieldGeometry: too many obstacles");
+        SHULIB_PRECONDITION(std::isfinite(o.x) && std::isfinite(o.y),
+                            "FieldGeometry: obstacle centre must be finite");
+        const double ex = o.circle ? o.halfLength
+                                   : o.halfLength * std::abs(o.c) + o.halfWidth * std::abs(o.s);
+        const double ey = o.circle ? o.halfLength
+                                   : o.halfLength * std::abs(o.s) + o.halfWidth * std::abs(o.c);
+        o.minX = o.x - ex;
+        o.maxX = o.x + ex;
+        o.minY = o.y - ey;
+        o.maxY = o.y + ey;
+        // Insertion keeps the sweep order; stable, so equal minX keep insertion order.
+        int at = count_;
+        while (at > 0 && obstacles_[static_cast<std::size_t>(at - 1)].minX > o.minX) {
+            obstacles_[static_cast<std::size_t>(at)] = obstacles_[static_cast<std::size_t>(at - 1)];
+            --at;
+        }
+        obstacles_[static_cast<std::size_t>(at)] = o;
+        ++count_;
+    }
+
+    void wallContacts(const Rect& r, FieldContacts& out) const {
+        double maxX = -std::numeric_limits<double>::infinity();
+        double minX = std::numeric_limits<double>::infinity();
+        double maxY = maxX;
+        double minY = minX;
+        for (const double a : {-1.0, 1.0}) {
+            for (const double b : {-1.0, 1.0}) {
+                const double px = r.x + a * r.hl * r.c - b * r.hw * r.s;
+                const double py = r.y + a * r.hl * r.s + b * r.hw * r.c;
+                maxX = std::max(maxX, px);
+                minX = std::min(minX, px);
+                maxY = std::max(maxY, py);
+                minY = std::min(minY, py);
+            }
+        }
+        const double h = perimeterHalf_;
+        if (maxX > h) {
+            out.add({-1.0, 0.0, maxX - h});
+        }
+        if (minX < -h) {
+            out.add({1.0, 0.0, -h - minX});
+        }
+        if (maxY > h) {
+            out.add({0.0, -1.0, maxY - h});
+        }
+        if (minY < -h) {
+            out.add({0.0, 1.0, -h - minY});
+        }
+    }
+
+    static void circleContact(const Rect& r, const Obstacle& o, FieldContacts& out) {
+        // The circle's centre in the footprint's frame, and the footprint's closest point.
+        const double wx = o.x - r.x;
+        const double wy = o.y - r.y;
+        const double lx = r.c * wx + r.s * wy;
+        const double ly = -r.s * wx + r.c * wy;
+        const double qx = std::clamp(lx, -r.hl, r.hl);
+        const double qy = std::clamp(ly, -r.hw, r.hw);
+        const double dx = lx - qx;
+        const double dy = ly - qy;
+        const double dist = std::hypot(dx, dy);
+        const double radius = o.halfLength;
+        double nlx = 0.0;
+        double nly = 0.0;
+        double depth = 0.0;
+        if (dist > 0.0) {
+            if (dist >= radius) {
+                return;
+            }
+            nlx = -dx / dist;  // from the centre toward the footprint
+            nly = -dy / dist;
+            depth = radius - dist;
+        } else {
+            // The centre is inside the footprint: leave by the nearer pair of faces.
+            const double exitX = r.hl - std::abs(lx);
+            const double exitY = r.hw - std::abs(ly);
+            if (exitX <= exitY) {
+                nlx = lx >= 0.0 ? -1.0 : 1.0;
+                depth = exitX + radius;
+            } else {
+                nly = ly >= 0.0 ? -1.0 : 1.0;
+                depth = exitY + radius;
+            }
+        }
+        out.add({r.c * nlx - r.s * nly, r.s * nlx + r.c * nly, depth});
+    }
+
+    static void boxContact(const Rect& r, const Obstacle& o, FieldContacts& out) {
+        const double axes[4][2] = {{r.c, r.s}, {-r.s, r.c}, {o.c, o.s}, {-o.s, o.c}};
+        const double cx = r.x - o.x;
+        const double cy = r.y - o.y;
+        double least = std::numeric_limits<double>::infinity();
+        double nx = 0.0;
+        double ny = 0.0;
+        for (const auto& axis : axes) {
+            const double ax = axis[0];
+            const double ay = axis[1];
+            const double ra = r.hl * std::abs(r.c * ax + r.s * ay) + r.hw * std::abs(-r.s * ax + r.c * ay);
+            const double rb = o.halfLength * std::abs(o.c * ax + o.s * ay)
+                            + o.halfWidth * std::abs(-o.s * ax + o.c * ay);
+            const double d = cx * ax + cy * ay;
+            const double overlap = ra + rb - std::abs(d);
+            if (overlap <= 0.0) {
+                return;  // a separating axis: no contact
+            }
+            if (overlap < least) {
+                least = overlap;
+                nx = d >= 0.0 ? ax : -ax;  // from the obstacle toward the robot
+                ny = d >= 0.0 ? ay : -ay;
+            }
+        }
+        out.add({nx, ny, least});
+    }
+
+    /// Ray parameter to a circle, +∞ on a miss.
+    static double rayCircle(const Obstacle& o, double x, double y, double dx, double dy) {
+        const double fx = x - o.x;
+        const double fy = y - o.y;
+        const double radius = o.halfLength;
+        const double c = fx * fx + fy * fy - radius * radius;
+        if (c <= 0.0) {
+            return 0.0;  // starts inside
+        }
+        const double b = fx * dx + fy * dy;
+        const double disc = b * b - c;
+        if (b >= 0.0 || disc < 0.0) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return -b - std::sqrt(disc);
+    }
+
+    /// Ray parameter to a box (slabs in the box's frame), +∞ on a miss.
+    static double rayBox(const Obstacle& o, double x, double y, double dx, double dy) {
+        const double wx = x - o.x;
+        const double wy = y - o.y;
+        const double p[2] = {o.c * wx + o.s * wy, -o.s * wx + o.c * wy};
+        const double d[2] = {o.c * dx + o.s * dy, -o.s * dx + o.c * dy};
+        const double half[2] = {o.halfLength, o.halfWidth};
+        double enter = 0.0;
+        double exit = std::numeric_limits<double>::infinity();
+        for (int k = 0; k < 2; ++k) {
+            if (d[k] == 0.0) {
+                if (std::abs(p[k]) > half[k]) {
+                    return std::numeric_limits<double>::infinity();
+                }
+                continue;
+            }
+            double t0 = (-half[k] - p[k]) / d[k];
+            double t1 = (half[k] - p[k]) / d[k];
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            enter = std::max(enter, t0);
+            exit = std::min(exit, t1);
+        }
+        return enter <= exit ? enter : std::numeric_limits<double>::infinity();
+    }
+
+    double perimeterHalf_ = 0.0;
+    std::array<Obstacle, static_cast<std::size_t>(kMaxObstacles)> obstacles_{};
+    int count_ = 0;
+};
+
+/// What a sensor at `mount` on a robot at `pose` reads (header: "Distance sensors"), with
+/// `bodies` (header: "Other robots") in view.
+[[nodiscard]] inline DistanceReading senseDistance(const FieldGeometry& field,
+                                                   const math::Pose2d& pose,
+                                                   const DistanceMount& mount,
+                                                   std::span<const FieldBox> bodies = {}) {
+    const double th = pose.heading().radians();
+    const double c = std::cos(th);
+    const double s = std::sin(th);
+    const double x = pose.x().value() + c * mount.forward.value() - s * mount.left.value();
+    const double y = pose.y().value() + s * mount.forward.value() + c * mount.left.value();
+    const std::optional<double> hit = field.castRay(
+        x, y, math::Angle::radians(th + mount.heading.radians()), mount.maxRange.value(), bodies);
+    if (hit) {
+        return DistanceReading{units::Length{*hit}, 1.0};
+    }
+    return DistanceReading{mount.maxRange, 0.0};
+}
+
+}  // namespace shulib::sim
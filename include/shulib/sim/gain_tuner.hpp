@@ -0,0 +1,691 @@
+#pragma once
+//
+// sim::GainTuner — search MotionConfig's PID gains against seeded hostile sim scenarios,
+// instead of hand-nudging the labelled guesses (HA-50).
+//
+// ── What one candidate costs ────────────────────────────────────────────────────────
+// A candidate is a MotionConfig: the base config with the tuned gains (GainRange) set.
+// It is scored by running EVERY scenario in the fixed set — a MoveToPose or TurnTo from a
+// start pose, on a plant seeded per scenario, behind FullHostility — through the real
+// stack: SimHarness, PilonsOdometry, ComplementaryFusion, Localizer, FaultLatch,
+// HealthMonitor and a MotionScheduler (so the D-5 pose-delta guard runs). Each run
+// measures, against TRUTH:
+//   * settle time — the scheduler's start-to-exit boundary (s);
+//   * overshoot   — the worst excursion past the target along start→target (in); for a
+//     turn, the worst rotation past the target heading, as arc length at rotationRadius;
+//   * final error — |position error| + |heading error|·rotationRadius at the exit (in).
+// cost = settleWeight·settle + overshootWeight·overshoot + finalErrorWeight·final, and a
+// candidate's cost is the mean over scenarios. The CONSTRAINTS are the run's verdict, not
+// a weight: a scenario that does not exit Settled, or that raised MOTION_TIMEOUT or
+// IMPLAUSIBLE, makes the candidate infeasible. The optimizer sees an infeasible candidate
+// as its cost plus kInfeasiblePenalty per violating scenario, so it can still climb out
+// of an infeasible start, and any feasible candidate ranks above every infeasible one
+// (while costs stay below the penalty, which realistic weights keep them).
+//
+// ── The search ──────────────────────────────────────────────────────────────────────
+// Nelder–Mead with restarts, over the gains normalized to [0, 1] by their ranges
+// (reflection 1, expansion 2, contraction ½, shrink ½; a trial point outside the box is
+// clamped back onto it). A restart rebuilds a full-size simplex around the best point so
+// far, which is what gets a collapsed simplex unstuck. A run stops when the simplex's
+// costs agree within `tolerance` or it has shrunk inside one grid cell, or after
+// maxIterations per restart. Derivative-free, because the cost is a step function of the
+// gains wherever a settle window starts or stops being met.
+//
+// ── Never simulate a candidate twice ────────────────────────────────────────────────
+// Every trial point is snapped to a grid (gridSteps cells per range) before it is
+// scored, and scores are cached by grid cell for the tuner's lifetime. Nelder–Mead
+// revisits points constantly (a rejected contraction, a restart around the incumbent);
+// each revisit is a cache hit, counted. Snapping also makes the emitted initializer the
+// EXACT config that was scored.
+//
+// ── Parallel, and still deterministic ───────────────────────────────────────────────
+// Uncached candidates are scored as a batch (the whole initial simplex, a shrink) and
+// their (candidate, scenario) runs are spread across std::threads, replayGrid's shape:
+// each run shares nothing but read-only config, and costs are summed in scenario order
+// afterwards. A tuning run is therefore bit-identical for any thread count (pinned by
+// test). Without __STDCPP_THREADS__ it runs serially.
+//
+// ── Honest scope ────────────────────────────────────────────────────────────────────
+//   * The tuned gains fit THIS plant — placeholder feedforward and invented hostility
+//     magnitudes. They are a better starting guess for R5, not a measurement: nothing
+//     here replaces tuning on the robot.
+//   * The localizer is MotionRig's: odometry and complementary fusion, no correctors.
+//   * A host function, like replayGrid(): the tool is a config, a scenario list and a
+//     call. Host-only: allocation, threads and exceptions are fine; never on the V5.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <limits>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+#if defined(__STDCPP_THREADS__)
+#include <thread>
+#endif
+
+#include "shulib/control/exit_group.hpp"
+#include "shulib/core/check.hpp"
+#include "shulib/diag/fault.hpp"
+#include "shulib/diag/health_monitor.hpp"
+#include "shulib/hal/null_sink.hpp"
+#include "shulib/kinematics/kinematics.hpp"
+#include "shulib/localization/complementary_fusion.hpp"
+#include "shulib/localization/localizer.hpp"
+#include "shulib/localization/pilons_odometry.hpp"
+#include "shulib/math/angle.hpp"
+#include "shulib/math/pose2d.hpp"
+#include "shulib/motion/motion.hpp"
+#include "shulib/motion/motion_config.hpp"
+#include "shulib/motion/motion_scheduler.hpp"
+#include "shulib/motion/move_to_pose.hpp"
+#include "shulib/motion/turn_to.hpp"
+#include "shulib/sim/hostile/composed.hpp"
+#include "shulib/sim/scenario.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::sim {
+
+/// What an infeasible scenario adds to a candidate's search cost (header). A logic
+/// constant: it only has to exceed any feasible cost.
+inline constexpr double kInfeasiblePenalty = 1000.0;
+
+/// A MotionConfig gain the tuner may move.
+enum class TunedGain {
+    TranslationKp,  ///< translation.kP
+    TranslationKi,  ///< translation.kI
+    TranslationKd,  ///< translation.kD
+    HeadingKp,      ///< heading.kP
+    HeadingKi,      ///< heading.kI
+    HeadingKd,      ///< heading.kD
+};
+
+/// The config spelling of `gain` ("translation.kP", …).
+[[nodiscard]] constexpr const char* tunedGainName(TunedGain gain) noexcept {
+    switch (gain) {
+        case TunedGain::TranslationKp: return "translation.kP";
+        case TunedGain::TranslationKi: return "translation.kI";
+        case TunedGain::TranslationKd: return "translation.kD";
+        case TunedGain::HeadingKp: return "heading.kP";
+        case TunedGain::HeadingKi: return "heading.kI";
+        case TunedGain::HeadingKd: return "heading.kD";
+    }
+    return "?";
+}
+
+/// The member of `cfg` that `gain` names.
+[[nodiscard]] inline double& tunedGainRef(motion::MotionConfig& cfg, TunedGain gain) noexcept {
+    switch (gain) {
+        case TunedGain::TranslationKp: return cfg.translation.kP;
+        case TunedGain::TranslationKi: return cfg.translation.kI;
+        case TunedGain::TranslationKd: return cfg.translation.kD;
+        case TunedGain::HeadingKp: return cfg.heading.kP;
+        case TunedGain::HeadingKi: return cfg.heading.kI;
+        case TunedGain::HeadingKd: return cfg.heading.kD;
+    }
+    return cfg.translation.kP;
+}
+
+/// One tuned gain and the closed interval it is searched over.
+struct GainRange {
+    TunedGain gain = TunedGain::TranslationKp;  ///< which gain
+    double lo = 0.0;                            ///< smallest value tried
+    double hi = 1.0;                            ///< largest value tried (> lo)
+};
+
+/// Which motion a scenario runs.
+enum class TuningMotion {
+    MoveToPose,  ///< drive to `target` (position and heading)
+    TurnTo,      ///< turn in place to `target`'s heading
+};
+
+/// One seeded scenario in the fixed evaluation set.
+struct TuningScenario {
+    TuningMotion motion = TuningMotion::MoveToPose;  ///< what to run
+    math::Pose2d start{};                             ///< true (and estimated) start pose
+    math::Pose2d target{};                            ///< the goal (TurnTo: heading only)
+    std::uint64_t seed = 1;                           ///< the plant's seed for this run
+    double timeout = 8.0;                             ///< the motion's watchdog (s)
+};
+
+/// A fixed, seeded set for a first tuning pass: four drives of 12–36 in in different
+/// directions and two turns of 90° and 170°, each on its own seed and an 8 s watchdog
+/// (the repo's default gains settle each in 3–4 s under FullHostility).
+[[nodiscard]] inline std::vector<TuningScenario> standardTuningScenarios() {
+    using math::Angle;
+    using math::Pose2d;
+    using units::Length;
+    const Pose2d origin{};
+    return {
+        {TuningMotion::MoveToPose, origin, Pose2d{Length{24.0}, Length{0.0}, Angle{}}, 11, 8.0},
+        {TuningMotion::MoveToPose, origin, Pose2d{Length{12.0}, Length{12.0}, Angle::degrees(45.0)},
+         12, 4.0},
+        {TuningMotion::MoveToPose, Pose2d{Length{10.0}, Length{-5.0}, Angle::degrees(90.0)},
+         Pose2d{Length{-20.0}, Length{20.0}, Angle::degrees(180.0)}, 13, 8.0},
+        {TuningMotion::MoveToPose, origin, Pose2d{Length{0.0}, Length{-36.0}, Angle{}}, 14, 8.0},
+        {TuningMotion::TurnTo, origin, Pose2d{Length{}, Length{}, Angle::degrees(90.0)}, 15, 8.0},
+        {TuningMotion::TurnTo, origin, Pose2d{Length{}, Length{}, Angle::degrees(-170.0)}, 16, 8.0},
+    };
+}
+
+/// How a scenario's measurements become one cost (header: "What one candidate costs").
+struct TuningObjective {
+    double settleWeight = 1.0;      ///< cost per second to settle
+    double overshootWeight = 0.5;   ///< cost per inch of overshoot
+    double finalErrorWeight = 2.0;  ///< cost per inch of final error
+};
+
+/// Everything a tuning run needs besides the kinematics.
+struct GainTunerConfig {
+    motion::MotionConfig base{};          ///< every untuned field, and the starting gains
+    std::vector<GainRange> gains{};       ///< what to tune (at least one)
+    std::vector<TuningScenario> scenarios = standardTuningScenarios();  ///< the fixed set
+    SimHarnessConfig plant{};             ///< the plant (its seed is replaced per scenario)
+    FullHostilityConfig hostility{};      ///< the hostile world every scenario runs in
+    TuningObjective objective{};          ///< the cost weights
+    int restarts = 2;                     ///< fresh simplices after the first
+    int maxIterations = 40;               ///< Nelder–Mead iterations per restart
+    double initialStep = 0.25;            ///< simplex edge, as a fraction of each range
+    double tolerance = 1e-3;              ///< stop when the simplex's costs agree this well
+    int gridSteps = 1024;                 ///< grid cells per range (the cache key)
+    double dt = 0.01;                     ///< control tick (s)
+    unsigned threads = 0;                 ///< 0 → hardware_concurrency()
+};
+
+/// What one scenario run measured.
+struct TuningScenarioResult {
+    control::ExitReason exit = control::ExitReason::Running;  ///< the motion's verdict
+    double settleTime = 0.0;     ///< start to exit (s)
+    double overshoot = 0.0;      ///< worst excursion past the target (in)
+    double finalError = 0.0;     ///< position + heading·rotationRadius at exit (in)
+    int timeoutFaults = 0;       ///< MOTION_TIMEOUT raises
+    int implausibleFaults = 0;   ///< IMPLAUSIBLE raises
+    double cost = 0.0;           ///< the objective, constraints aside
+    /// Settled, with no MOTION_TIMEOUT and no IMPLAUSIBLE fault.
+    [[nodiscard]] bool feasible() const noexcept {
+        return exit == control::ExitReason::Settled && timeoutFaults == 0
+            && implausibleFaults == 0;
+    }
+};
+
+/// A candidate's score over the whole scenario set.
+struct CandidateScore {
+    double cost = 0.0;            ///< mean scenario cost
+    int violations = 0;           ///< scenarios that were not feasible
+    double meanSettleTime = 0.0;  ///< mean settle time (s)
+    double maxOvershoot = 0.0;    ///< worst overshoot of any scenario (in)
+    double meanFinalError = 0.0;  ///< mean final error (in)
+    /// No scenario violated a constraint.
+    [[nodiscard]] bool feasible() const noexcept { return violations == 0; }
+    /// What the optimizer minimizes: cost + kInfeasiblePenalty per violation.
+    [[nodiscard]] double searchCost() const noexcept {
+        return cost + kInfeasiblePenalty * static_cast<double>(violations);
+    }
+};
+
+/// One Nelder–Mead iteration, for the convergence report.
+struct TuningStep {
+    int restart = 0;           ///< 0 for the first simplex
+    int iteration = 0;         ///< within the restart
+    double bestCost = 0.0;     ///< the best vertex's searchCost()
+    double spread = 0.0;       ///< worst − best searchCost() in the simplex
+    int candidatesScored = 0;  ///< candidates simulated so far (cache misses)
+};
+
+/// The result of GainTuner::run().
+struct TuningReport {
+    motion::MotionConfig best{};         ///< the base config with the best gains found
+    CandidateScore bestScore{};          ///< its score
+    CandidateScore startScore{};         ///< the starting gains' score (snapped to the grid)
+    std::vector<TuningStep> history{};   ///< every iteration, in order
+    int candidatesScored = 0;            ///< distinct candidates simulated
+    int cacheHits = 0;                   ///< trial points served from the cache
+    int scenarioRuns = 0;                ///< simulations run (candidates × scenarios)
+};
+
+namespace detail {
+
+/// Steps the plant one tick per pace and tracks the truth-side overshoot.
+class TuningPacer final : public motion::ITickPacer {
+public:
+    TuningPacer(SimHarness& harness, const TuningScenario& sc, double rotationRadius,
+                units::Time dt)
+        : h_{harness}, sc_{sc}, rotationRadius_{rotationRadius}, dt_{dt} {
+        const double dx = sc.target.x().value() - sc.start.x().value();
+        const double dy = sc.target.y().value() - sc.start.y().value();
+        const double len = std::hypot(dx, dy);
+        ux_ = len > 0.0 ? dx / len : 0.0;
+        uy_ = len > 0.0 ? dy / len : 0.0;
+        const double turn = sc.start.heading().errorTo(sc.target.heading());
+        turnSign_ = turn >= 0.0 ? 1.0 : -1.0;
+    }
+
+    void pace() override {
+        h_.plant().step(dt_);
+        const math::Pose2d p = h_.truePose();
+        double past = 0.0;
+        if (sc_.motion == TuningMotion::MoveToPose) {
+            past = (p.x().value() - sc_.target.x().value()) * ux_
+                 + (p.y().value() - sc_.target.y().value()) * uy_;
+        } else {
+            past = -turnSign_ * p.heading().errorTo(sc_.target.heading()) * rotationRadius_;
+        }
+        overshoot_ = std::max(overshoot_, past);
+    }
+
+    /// Worst excursion past the target so far (in, ≥ 0).
+    [[nodiscard]] double overshoot() const noexcept { return overshoot_; }
+
+private:
+    SimHarness& h_;
+    const TuningScenario& sc_;
+    double rotationRadius_;
+    units::Time dt_;
+    double ux_ = 0.0;
+    double uy_ = 0.0;
+    double turnSign_ = 1.0;
+    double overshoot_ = 0.0;
+};
+
+}  // namespace detail
+
+/// Run one scenario under `motionCfg` (header: "What one candidate costs"). A pure
+/// function of its arguments: the same inputs give bit-identical results.
+[[nodiscard]] inline TuningScenarioResult runTuningScenario(
+    const kinematics::IKinematics& kinematics, const GainTunerConfig& cfg,
+    const motion::MotionConfig& motionCfg, const TuningScenario& sc) {
+    SimHarnessConfig plant = cfg.plant;
+    plant.plant.seed = sc.seed;
+    plant.plant.initialPose = sc.start;
+    FullHostility hostility{cfg.hostility};
+    SimHarness h{kinematics, plant, nullptr, &hostility.model()};
+    localization::PilonsOdometry odom{h.imu(), h.makeForwardTrackingWheel(),
+                                      h.makeLateralTrackingWheel()};
+    localization::ComplementaryFusion fusion;
+    localization::Localizer loc{h.clock(), h.imu(), odom, fusion};
+    loc.setPose(sc.start);
+    hal::NullSink faultSink;
+    diag::FaultLatch latch{faultSink, h.clock()};
+    diag::HealthMonitor health{latch};
+    const motion::MotionDeps deps{.ctx = &h.context(),
+                                  .localizer = &loc,
+                                  .kinematics = &kinematics,
+                                  .faults = &latch,
+                                  .health = &health};
+    const double radius = motionCfg.rotationRadius.value();
+    detail::TuningPacer pacer{h, sc, radius, units::Time{cfg.dt}};
+    motion::MotionScheduler sched{deps, pacer};
+
+    TuningScenarioResult r;
+    if (sc.motion == TuningMotion::MoveToPose) {
+        motion::MoveToPose m{sched.deps(), sc.target, motionCfg, sc.timeout};
+        sched.async(m);
+        r.exit = sched.waitUntilSettled();
+    } else {
+        motion::TurnTo m{sched.deps(), sc.target.heading(), motionCfg, sc.timeout};
+        sched.async(m);
+        r.exit = sched.waitUntilSettled();
+    }
+    const motion::CompletedMotion& done = sched.lastCompleted();
+    const math::Pose2d p = h.truePose();
+    const double headingError = std::abs(p.heading().errorTo(sc.target.heading())) * radius;
+    r.settleTime = done.endTime.value() - done.startTime.value();
+    r.overshoot = pacer.overshoot();
+    r.finalError = sc.motion == TuningMotion::MoveToPose
+                       ? std::hypot(p.x().value() - sc.target.x().value(),
+                                    p.y().value() - sc.target.y().value())
+                             + headingError
+                       : headingError;
+    r.timeoutFaults = latch.raiseCount(diag::FaultCode::MotionTimeout);
+    r.implausibleFaults = latch.raiseCount(diag::FaultCode::Implausible);
+    r.cost = cfg.objective.settleWeight * r.settleTime
+           + cfg.objective.overshootWeight * r.overshoot
+           + cfg.objective.finalErrorWeight * r.finalError;
+    return r;
+}
+
+/// The tuner: holds the config, the kinematics and the score cache (header). Construct
+/// one per tuning problem; run() may be called again and reuses the cache.
+class GainTuner {
+public:
+    /// `kinematics` must outlive the tuner. Preconditions: at least one gain and one
+    /// scenario, every range lo < hi (both finite), gridSteps ≥ 2, restarts ≥ 0,
+    /// maxIterations ≥ 1, initialStep in (0, 1], dt > 0, and a valid base config.
+    GainTuner(const kinematics::IKinematics& kinematics, GainTunerConfig config)
+        : kin_{kinematics}, cfg_{std::move(config)} {
+        SHULIB_PRECONDITION(!cfg_.gains.empty(), "GainTuner: nothing to tune");
+        SHULIB_PRECONDITION(!cfg_.scenarios.empty(), "GainTuner: no scenarios");
+        for (const GainRange& g : cfg_.gains) {
+            SHULIB_PRECONDITION(std::isfinite(g.lo) && std::isfinite(g.hi) && g.lo < g.hi,
+                                "GainTuner: a gain range must be finite with lo < hi");
+        }
+        SHULIB_PRECONDITION(cfg_.gridSteps >= 2, "GainTuner: gridSteps must be >= 2");
+        SHULIB_PRECONDITION(cfg_.restarts >= 0, "GainTuner: restarts must be >= 0");
+        SHULIB_PRECONDITION(cfg_.maxIterations >= 1, "GainTuner: maxIterations must be >= 1");
+        SHULIB_PRECONDITION(cfg_.initialStep > 0.0 && cfg_.initialStep <= 1.0,
+                            "GainTuner: initialStep must be in (0, 1]");
+        SHULIB_PRECONDITION(cfg_.dt > 0.0, "GainTuner: dt must be > 0");
+        cfg_.base.validate();
+    }
+
+    /// The MotionConfig a normalized point stands for (snapped to the grid first).
+    [[nodiscard]] motion::MotionConfig configAt(std::span<const double> u) const {
+        return configFor(snap(u));
+    }
+
+    /// Score the base config's own gains (snapped to the grid), through the cache.
+    [[nodiscard]] CandidateScore scoreBase() { return scoreBatch({start()}).front(); }
+
+    /// Search (header: "The search") and report. Deterministic for any thread count.
+    [[nodiscard]] TuningReport run() {
+        TuningReport report;
+        const Key startKey = start();
+        Vertex best{startKey, scoreBatch({startKey}).front()};
+        report.startScore = best.score;
+        const std::size_t n = cfg_.gains.size();
+        for (int restart = 0; restart <= cfg_.restarts; ++restart) {
+            std::vector<Key> keys{best.key};
+            for (std::size_t i = 0; i < n; ++i) {
+                std::vector<double> u = unsnap(best.key);
+                u[i] += u[i] + cfg_.initialStep <= 1.0 ? cfg_.initialStep : -cfg_.initialStep;
+                keys.push_back(snap(u));
+            }
+            const std::vector<CandidateScore> scores = scoreBatch(keys);
+            std::vector<Vertex> simplex;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                simplex.push_back(Vertex{keys[i], scores[i]});
+            }
+            for (int it = 0; it < cfg_.maxIterations; ++it) {
+                std::stable_sort(simplex.begin(), simplex.end(), [](const Vertex& a, const Vertex& b) {
+                    return a.score.searchCost() < b.score.searchCost();
+                });
+                const double spread =
+                    simplex.back().score.searchCost() - simplex.front().score.searchCost();
+                report.history.push_back(TuningStep{restart, it, simplex.front().score.searchCost(),
+                                                    spread, candidatesScored_});
+                if (spread <= cfg_.tolerance || collapsed(simplex)) {
+                    break;
+                }
+                nelderMeadStep(simplex);
+            }
+            const Vertex& top = *std::min_element(
+                simplex.begin(), simplex.end(), [](const Vertex& a, const Vertex& b) {
+                    return a.score.searchCost() < b.score.searchCost();
+                });
+            if (top.score.searchCost() < best.score.searchCost()) {
+                best = top;
+            }
+        }
+        report.best = configFor(best.key);
+        report.bestScore = best.score;
+        report.candidatesScored = candidatesScored_;
+        report.cacheHits = cacheHits_;
+        report.scenarioRuns = candidatesScored_ * static_cast<int>(cfg_.scenarios.size());
+        return report;
+    }
+
+    /// Distinct candidates simulated over the tuner's lifetime.
+    [[nodiscard]] int candidatesScored() const noexcept { return candidatesScored_; }
+    /// Trial points served from the cache over the tuner's lifetime.
+    [[nodiscard]] int cacheHits() const noexcept { return cacheHits_; }
+    /// The tuning problem.
+    [[nodiscard]] const GainTunerConfig& config() const noexcept { return cfg_; }
+
+private:
+    using Key = std::vector<int>;  // grid cell per tuned gain
+
+    struct Vertex {
+        Key key;
+        CandidateScore score;
+    };
+
+    [[nodiscard]] Key snap(std::span<const double> u) const {
+        Key k(cfg_.gains.size());
+        for (std::size_t i = 0; i < k.size(); ++i) {
+            const double c = std::clamp(i < u.size() ? u[i] : 0.0, 0.0, 1.0);
+            k[i] = static_cast<int>(std::lround(c * cfg_.gridSteps));
+        }
+        return k;
+    }
+
+    [[nodiscard]] std::vector<double> unsnap(const Key& k) const {
+        std::vector<double> u(k.size());
+        for (std::size_t i = 0; i < k.size(); ++i) {
+            u[i] = static_cast<double>(k[i]) / static_cast<double>(cfg_.gridSteps);
+        }
+        return u;
+    }
+
+    [[nodiscard]] motion::MotionConfig configFor(const Key& k) const {
+        motion::MotionConfig m = cfg_.base;
+        for (std::size_t i = 0; i < k.size(); ++i) {
+            const GainRange& g = cfg_.gains[i];
+            tunedGainRef(m, g.gain) =
+                g.lo + (g.hi - g.lo) * static_cast<double>(k[i]) / static_cast<double>(cfg_.gridSteps);
+        }
+        return m;
+    }
+
+    /// The base config's gains as a grid point.
+    [[nodiscard]] Key start() const {
+        motion::MotionConfig base = cfg_.base;
+        std::vector<double> u(cfg_.gains.size());
+        for (std::size_t i = 0; i < u.size(); ++i) {
+            const GainRange& g = cfg_.gains[i];
+            u[i] = (tunedGainRef(base, g.gain) - g.lo) / (g.hi - g.lo);
+        }
+        return snap(u);
+    }
+
+    /// True once every vertex sits in one grid cell's neighbourhood.
+    [[nodiscard]] static bool collapsed(const std::vector<Vertex>& simplex) {
+        for (const Vertex& v : simplex) {
+            for (std::size_t i = 0; i < v.key.size(); ++i) {
+                if (std::abs(v.key[i] - simplex.front().key[i]) > 1) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /// One Nelder–Mead move on a simplex sorted best-first.
+    void nelderMeadStep(std::vector<Vertex>& simplex) {
+        const std::size_t n = simplex.size() - 1;
+        std::vector<double> centroid(n, 0.0);
+        for (std::size_t v = 0; v < n; ++v) {
+            const std::vector<double> u = unsnap(simplex[v].key);
+            for (std::size_t i = 0; i < n; ++i) {
+                centroid[i] += u[i] / static_cast<double>(n);
+            }
+        }
+        const std::vector<double> worst = unsnap(simplex.back().key);
+        const auto along = [&](double t) {  // centroid + t·(centroid − worst)
+            std::vector<double> u(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                u[i] = centroid[i] + t * (centroid[i] - worst[i]);
+            }
+            return snap(u);
+        };
+        const double fBest = simplex.front().score.searchCost();
+        const double fSecond = simplex[n - 1].score.searchCost();
+        const double fWorst = simplex.back().score.searchCost();
+
+        const Vertex reflected{along(1.0), {}};
+        const CandidateScore fr = scoreBatch({reflected.key}).front();
+        if (fr.searchCost() < fBest) {
+            const Key expanded = along(2.0);
+            const CandidateScore fe = scoreBatch({expanded}).front();
+            simplex.back() = fe.searchCost() < fr.searchCost() ? Vertex{expanded, fe}
+                                                               : Vertex{reflected.key, fr};
+            return;
+        }
+        if (fr.searchCost() < fSecond) {
+            simplex.back() = Vertex{reflected.key, fr};
+            return;
+        }
+        const bool outside = fr.searchCost() < fWorst;
+        const Key contracted = along(outside ? 0.5 : -0.5);
+        const CandidateScore fc = scoreBatch({contracted}).front();
+        if (fc.searchCost() < (outside ? fr.searchCost() : fWorst)) {
+            simplex.back() = Vertex{contracted, fc};
+            return;
+        }
+        // Shrink every vertex halfway toward the best, scored as one parallel batch.
+        const std::vector<double> bestU = unsnap(simplex.front().key);
+        std::vector<Key> keys;
+        for (std::size_t v = 1; v < simplex.size(); ++v) {
+            std::vector<double> u = unsnap(simplex[v].key);
+            for (std::size_t i = 0; i < n; ++i) {
+                u[i] = bestU[i] + 0.5 * (u[i] - bestU[i]);
+            }
+            keys.push_back(snap(u));
+        }
+        const std::vector<CandidateScore> scores = scoreBatch(keys);
+        for (std::size_t v = 1; v < simplex.size(); ++v) {
+            simplex[v] = Vertex{keys[v - 1], scores[v - 1]};
+        }
+    }
+
+    /// Score every key, simulating only the ones the cache has never seen (header).
+    [[nodiscard]] std::vector<CandidateScore> scoreBatch(const std::vector<Key>& keys) {
+        std::vector<Key> fresh;
+        for (const Key& k : keys) {
+            if (cache_.count(k) != 0 || std::find(fresh.begin(), fresh.end(), k) != fresh.end()) {
+                ++cacheHits_;
+            } else {
+                fresh.push_back(k);
+            }
+        }
+        if (!fresh.empty()) {
+            simulate(fresh);
+        }
+        std::vector<CandidateScore> out;
+        out.reserve(keys.size());
+        for (const Key& k : keys) {
+            out.push_back(cache_.at(k));
+        }
+        return out;
+    }
+
+    /// Run every (candidate, scenario) pair of `keys` across the pool, then fold each
+    /// candidate's results in scenario order into the cache.
+    void simulate(const std::vector<Key>& keys) {
+        const std::size_t nScenarios = cfg_.scenarios.size();
+        std::vector<motion::MotionConfig> configs;
+        configs.reserve(keys.size());
+        for (const Key& k : keys) {
+            configs.push_back(configFor(k));
+        }
+        const std::size_t jobs = keys.size() * nScenarios;
+        std::vector<TuningScenarioResult> results(jobs);
+        std::vector<std::exception_ptr> errors(jobs);
+        std::atomic<std::size_t> nextJob{0};
+        const auto worker = [&]() {
+            for (std::size_t j = nextJob.fetch_add(1); j < jobs; j = nextJob.fetch_add(1)) {
+                try {
+                    results[j] = runTuningScenario(kin_, cfg_, configs[j / nScenarios],
+                                                   cfg_.scenarios[j % nScenarios]);
+                } catch (...) {
+                    errors[j] = std::current_exception();
+                }
+            }
+        };
+#if defined(__STDCPP_THREADS__)
+        unsigned threads = cfg_.threads;
+        if (threads == 0) {
+            threads = std::max(1U, std::thread::hardware_concurrency());
+        }
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, jobs));
+        std::vector<std::thread> pool;
+        pool.reserve(threads);
+        for (unsigned t = 0; t < threads; ++t) {
+            pool.emplace_back(worker);
+        }
+        for (std::thread& t : pool) {
+            t.join();
+        }
+#else
+        worker();
+#endif
+        for (const std::exception_ptr& e : errors) {
+            if (e) {
+                std::rethrow_exception(e);
+            }
+        }
+        for (std::size_t c = 0; c < keys.size(); ++c) {
+            CandidateScore s;
+            for (std::size_t i = 0; i < nScenarios; ++i) {
+                const TuningScenarioResult& r = results[c * nScenarios + i];
+                s.cost += r.cost;
+                s.meanSettleTime += r.settleTime;
+                s.meanFinalError += r.finalError;
+                s.maxOvershoot = std::max(s.maxOvershoot, r.overshoot);
+                s.violations += r.feasible() ? 0 : 1;
+            }
+            const auto count = static_cast<double>(nScenarios);
+            s.cost /= count;
+            s.meanSettleTime /= count;
+            s.meanFinalError /= count;
+            cache_.emplace(keys[c], s);
+            ++candidatesScored_;
+        }
+    }
+
+    const kinematics::IKinematics& kin_;
+    GainTunerConfig cfg_;
+    std::map<Key, CandidateScore> cache_;
+    int candidatesScored_ = 0;
+    int cacheHits_ = 0;
+};
+
+/// The tuned gains as a C++ function that applies them to a base config — paste it
+/// next to the routine's config. Values print with 17 significant digits, so the
+/// function reproduces the scored config exactly.
+[[nodiscard]] inline std::string motionConfigInitializer(const TuningReport& report,
+                                                         std::span<const GainRange> gains) {
+    char line[160];
+    std::string out;
+    std::snprintf(line, sizeof line,
+                  "// GainTuner: cost %.4f (start %.4f), %d violating scenario(s)\n",
+                  report.bestScore.cost, report.startScore.cost, report.bestScore.violations);
+    out += line;
+    out += "inline shulib::motion::MotionConfig tunedMotionConfig(shulib::motion::MotionConfig cfg) {\n";
+    motion::MotionConfig best = report.best;
+    for (const GainRange& g : gains) {
+        std::snprintf(line, sizeof line, "    cfg.%s = %.17g;\n", tunedGainName(g.gain),
+                      tunedGainRef(best, g.gain));
+        out += line;
+    }
+    out += "    return cfg;\n}\n";
+    return out;
+}
+
+/// A plain-text convergence report: one line per iteration, then the totals.
+[[nodiscard]] inline std::string formatTuningReport(const TuningReport& report) {
+    char line[160];
+    std::string out;
+    for (const TuningStep& s : report.history) {
+        std::snprintf(line, sizeof line, "restart %d iter %3d  best %10.4f  spread %10.4f  scored %d\n",
+                      s.restart, s.iteration, s.bestCost, s.spread, s.candidatesScored);
+        out += line;
+    }
+    std::snprintf(line, sizeof line,
+                  "start cost %.4f (%d violating) -> best cost %.4f (%d violating): settle %.3f s, "
+                  "overshoot %.3f in, final %.3f in\n",
+                  report.startScore.cost, report.startScore.violations, report.bestScore.cost,
+                  report.bestScore.violations, report.bestScore.meanSettleTime,
+                  report.bestScore.maxOvershoot, report.bestScore.meanFinalError);
+    out += line;
+    std::snprintf(line, sizeof line, "%d candidates simulated (%d scenario runs), %d cache hits\n",
+                  report.candidatesScored, report.scenarioRuns, report.cacheHits);
+    out += line;
+    return out;
+}
+
+}  // namespace shulib::sim
@@ -155,6 +155,20 @@ public:
         return v;
     }
 
+    /// Checkpoint: each model's state, in chain order.
+    void saveState(StateWriter& out) const override {
+        for (const DegradationModel* m : models_) {
+            m->saveState(out);
+        }
+    }
+
+    /// Restore each model's state, in chain order.
+    void restoreState(StateReader& in) override {
+        for (DegradationModel* m : models_) {
+            m->restoreState(in);
+        }
+    }
+
 private:
     std::vector<DegradationModel*> models_;
 };
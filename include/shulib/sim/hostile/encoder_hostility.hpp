@@ -127,6 +127,22 @@ public:
         return units::AngleDim{out};
     }
 
+    /// Checkpoint (degradation.hpp): the call-history state, never the config.
+    void saveState(StateWriter& out) const override {
+        out.write(driveLast_);
+        out.write(driveHasLast_);
+        out.write(trackingLast_);
+        out.write(trackingHasLast_);
+    }
+
+    /// Restore what saveState wrote.
+    void restoreState(StateReader& in) override {
+        in.read(driveLast_);
+        in.read(driveHasLast_);
+        in.read(trackingLast_);
+        in.read(trackingHasLast_);
+    }
+
 private:
     [[nodiscard]] bool sentinelActive(units::Time now) const noexcept {
         return now.value() >= cfg_.sentinelAt.value()
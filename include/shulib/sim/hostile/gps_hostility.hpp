@@ -123,6 +123,22 @@ public:
         return GpsTruth{held_, cfg_.reportedRms, truth.hasFix};
     }
 
+    /// Checkpoint (degradation.hpp): the call-history state, never the config.
+    void saveState(StateWriter& out) const override {
+        out.write(held_);
+        out.write(staleEmitted_);
+        out.write(lastSampleTime_);
+        out.write(hasSample_);
+    }
+
+    /// Restore what saveState wrote.
+    void restoreState(StateReader& in) override {
+        in.read(held_);
+        in.read(staleEmitted_);
+        in.read(lastSampleTime_);
+        in.read(hasSample_);
+    }
+
 private:
     [[nodiscard]] bool inNoFixWindow(units::Time now) const {
         for (const GpsNoFixWindow& w : cfg_.noFixWindows) {
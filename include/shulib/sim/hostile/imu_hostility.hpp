@@ -151,6 +151,24 @@ public:
     /// reporting the measured drift a run was subjected to. 0 until the first draw.
     [[nodiscard]] double rateBiasRadPerS() const noexcept { return rateBias_; }
 
+    /// Checkpoint (degradation.hpp): the call-history state, never the config.
+    void saveState(StateWriter& out) const override {
+        out.write(booted_);
+        out.write(rateBias_);
+        out.write(lastHeading_);
+        out.write(hasLastHeading_);
+        out.write(lastRate_);
+    }
+
+    /// Restore what saveState wrote.
+    void restoreState(StateReader& in) override {
+        in.read(booted_);
+        in.read(rateBias_);
+        in.read(lastHeading_);
+        in.read(hasLastHeading_);
+        in.read(lastRate_);
+    }
+
 private:
     void ensureBoot(Rng& rng) {
         if (!booted_) {
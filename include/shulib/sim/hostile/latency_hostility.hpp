@@ -93,6 +93,24 @@ public:
             now.value(), trueShaft, cfg_.trackingEncoderLatency.value());
     }
 
+    /// Checkpoint (degradation.hpp): the call-history state, never the config.
+    void saveState(StateWriter& out) const override {
+        out.write(heading_);
+        out.write(yawRate_);
+        out.write(gps_);
+        out.write(drive_);
+        out.write(tracking_);
+    }
+
+    /// Restore what saveState wrote.
+    void restoreState(StateReader& in) override {
+        in.read(heading_);
+        in.read(yawRate_);
+        in.read(gps_);
+        in.read(drive_);
+        in.read(tracking_);
+    }
+
 private:
     /// One channel's history: push, then return the newest sample ≥ latency old
     /// (or the oldest kept — startup/overflow semantics in the header). The cutoff
@@ -0,0 +1,105 @@
+#pragma once
+//
+// sim::PacedJitterSchedule — the loop-dt a PACED robot loop actually sees, as a
+// reproducible dt schedule for SimHarness::runTicksVariable (the A3 loop-jitter seam).
+//
+// JitterSchedule (composed.hpp) is a shape-free hostile schedule: nominal·(1 ± frac) plus
+// spikes. It is right for survival testing and says nothing about any particular pacer.
+// This schedule is the opposite. It runs the REAL pacing arithmetic, hal::TickPll (the
+// same object ProsPllTickPacer runs on the brain), against a virtual microsecond clock.
+// Only the RTOS is modeled: a tick body of fixed length, then a coarse sleep whose wake
+// lands a drawn latency after its millisecond boundary. What comes out is the dt
+// distribution that pacer would produce under that latency. Most ticks are trimmed to the
+// exact period, a contended wake overshoots the grid, and the next tick is short by
+// the same amount. With pll.maxTrimUs = 0 it is the millisecond-quantized pacer instead,
+// so a latency scenario can compare the two from one seed.
+//
+// Determinism: a PRIVATE Rng seeded at construction (JitterSchedule's rule — timing
+// hostility never entangles with the degradation models' draws), and exactly two draws
+// per call (spike roll, then latency), whether or not the tick slept. The grid is
+// anchored at virtual t = 0 in the constructor, so the FIRST dt is already a steady-state
+// one rather than an anchoring artifact.
+//
+// ── PROVISIONAL MAGNITUDES (A4 Hardware Assumptions Register; R4 measures) ─────────
+//   * body = 3 ms, wake latency uniform 50–300 µs, a 2.5 ms contended wake with
+//     probability 0.02 — invented, HA-125 (the spike rate shares HA-34's guess).
+//   * pollUs = 1 µs per micros() read — the spin's granularity. Invented, HA-125.
+
+#include <cstdint>
+
+#include "shulib/core/check.hpp"
+#include "shulib/hal/tick_pll.hpp"
+#include "shulib/sim/rng.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::sim {
+
+/// PacedJitterSchedule's model of the RTOS under the pacer (header note for the magnitudes).
+struct PacedJitterConfig {
+    hal::TickPllConfig pll{};        ///< the pacer being modeled, exactly as on the brain
+    std::uint32_t bodyUs = 3000;     ///< tick body before pace() — PROVISIONAL (A4: HA-125)
+    std::uint32_t wakeLateMinUs = 50;    ///< PROVISIONAL (A4: HA-125)
+    std::uint32_t wakeLateMaxUs = 300;   ///< PROVISIONAL (A4: HA-125)
+    double spikeProb = 0.02;             ///< contended wake probability — PROVISIONAL (A4: HA-34)
+    std::uint32_t spikeLateUs = 2500;    ///< contended wake latency — PROVISIONAL (A4: HA-125)
+    std::uint32_t pollUs = 1;            ///< µs per spin read — PROVISIONAL (A4: HA-125)
+};
+
+/// The dt schedule of a TickPll-paced loop on a modeled RTOS (header note). Deterministic from
+/// its own seed; exactly two draws per call.
+class PacedJitterSchedule {
+public:
+    /// Preconditions: TickPll's own, plus bodyUs < pll.periodUs, wakeLateMinUs <= wakeLateMaxUs,
+    /// spikeProb in [0, 1] and pollUs >= 1.
+    explicit PacedJitterSchedule(std::uint64_t seed, const PacedJitterConfig& config = {})
+        : cfg_{config}, pll_{config.pll}, rng_{seed} {
+        SHULIB_PRECONDITION(cfg_.bodyUs < cfg_.pll.periodUs,
+                            "PacedJitterSchedule: bodyUs must be < pll.periodUs");
+        SHULIB_PRECONDITION(cfg_.wakeLateMinUs <= cfg_.wakeLateMaxUs,
+                            "PacedJitterSchedule: wakeLateMinUs must be <= wakeLateMaxUs");
+        SHULIB_PRECONDITION(cfg_.spikeProb >= 0.0 && cfg_.spikeProb <= 1.0,
+                            "PacedJitterSchedule: spikeProb must be in [0, 1]");
+        SHULIB_PRECONDITION(cfg_.pollUs >= 1U, "PacedJitterSchedule: pollUs must be >= 1");
+        (void)pll_.plan(0);  // anchor the grid at virtual t = 0 (header: first dt)
+    }
+
+    /// The next tick's dt: run one body, then one pace() of the modeled pacer.
+    [[nodiscard]] units::Time operator()(int /*tick*/) {
+        const double spikeRoll = rng_.nextUnit();  // draw 1
+        const double late = rng_.uniform(static_cast<double>(cfg_.wakeLateMinUs),
+                                         static_cast<double>(cfg_.wakeLateMaxUs));  // draw 2
+        nowUs_ += cfg_.bodyUs;
+        const hal::TickPllPlan plan = pll_.plan(nowUs_);
+        if (plan.sleep) {
+            const std::uint64_t boundaryUs = plan.wakeMs * 1000U;
+            if (boundaryUs > nowUs_) {
+                const double latency =
+                    spikeRoll < cfg_.spikeProb ? static_cast<double>(cfg_.spikeLateUs) : late;
+                nowUs_ = boundaryUs + static_cast<std::uint64_t>(latency);
+            }
+            const std::uint64_t wokeUs = nowUs_;
+            const std::uint64_t spinToUs = pll_.onWake(wokeUs);
+            if (nowUs_ < spinToUs) {  // the spin, in whole polls
+                nowUs_ += (spinToUs - nowUs_ + cfg_.pollUs - 1U) / cfg_.pollUs * cfg_.pollUs;
+            }
+            pll_.release(nowUs_, nowUs_ - wokeUs);
+        } else {
+            pll_.release(nowUs_);
+        }
+        const std::uint64_t dtUs = nowUs_ - lastReleaseUs_;
+        lastReleaseUs_ = nowUs_;
+        return units::Time{static_cast<double>(dtUs) * 1e-6};
+    }
+
+    /// The modeled pacer's own statistics — the same numbers ProsPllTickPacer::pll() reports.
+    [[nodiscard]] const hal::TickPll& pll() const noexcept { return pll_; }
+
+private:
+    PacedJitterConfig cfg_;
+    hal::TickPll pll_;
+    Rng rng_;
+    std::uint64_t nowUs_ = 0;
+    std::uint64_t lastReleaseUs_ = 0;
+};
+
+}  // namespace shulib::sim
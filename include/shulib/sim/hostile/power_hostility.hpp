@@ -158,6 +158,32 @@ public:
         return m;
     }
 
+    /// Checkpoint (degradation.hpp): the call-history state, never the config.
+    void saveState(StateWriter& out) const override {
+        out.write(temps_);
+        out.write(wheelLastNow_);
+        out.write(wheelHasLast_);
+        out.write(nominal_);
+        out.write(hasNominal_);
+        out.write(tickLoad_);
+        out.write(prevTickLoad_);
+        out.write(loadTickNow_);
+        out.write(hasLoadTick_);
+    }
+
+    /// Restore what saveState wrote.
+    void restoreState(StateReader& in) override {
+        in.read(temps_);
+        in.read(wheelLastNow_);
+        in.read(wheelHasLast_);
+        in.read(nominal_);
+        in.read(hasNominal_);
+        in.read(tickLoad_);
+        in.read(prevTickLoad_);
+        in.read(loadTickNow_);
+        in.read(hasLoadTick_);
+    }
+
 private:
     [[nodiscard]] double packVoltsAt(double t, double load) const noexcept {
         const double v0 = hasNominal_ ? nominal_ : cfg_.fallbackNominal.value();
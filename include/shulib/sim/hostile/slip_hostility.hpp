@@ -106,6 +106,20 @@ public:
         return units::Velocity{spin.value() * retain};
     }
 
+    /// Checkpoint (degradation.hpp): the call-history state, never the config.
+    void saveState(StateWriter& out) const override {
+        out.write(lastSpin_);
+        out.write(lastNow_);
+        out.write(hasLast_);
+    }
+
+    /// Restore what saveState wrote.
+    void restoreState(StateReader& in) override {
+        in.read(lastSpin_);
+        in.read(lastNow_);
+        in.read(hasLast_);
+    }
+
 private:
     static constexpr std::size_t kMaxWheels =
         static_cast<std::size_t>(kinematics::WheelSpeeds::kMaxWheels);
@@ -95,6 +95,17 @@ public:
         return units::Velocity{vss + (v0 - vss) * decay};
     }
 
+    /// The speed `effective` volts hold the wheel at once the approach has decayed: the
+    /// steady-state inversion above, zero inside the dead band. kV·(this − v) is the
+    /// model's TORQUE PROXY — the kA·v̇ volts left to accelerate a wheel at v — which the
+    /// rigid-body plant (rigid_body.hpp) turns into a force.
+    [[nodiscard]] units::Velocity steadyStateSpeed(units::Voltage effective) const noexcept {
+        return units::Velocity{steadyState(effective.value())};
+    }
+
+    /// The gains this model inverts.
+    [[nodiscard]] const control::FeedforwardGains& gains() const noexcept { return g_; }
+
 private:
     /// The exact steady-state inversion of V = kS·sign(v) + kV·v (see header).
     [[nodiscard]] double steadyState(double volts) const noexcept {
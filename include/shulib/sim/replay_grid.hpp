@@ -0,0 +1,291 @@
+#pragma once
+//
+// sim::ReplayGrid + parseReplayGrid — the estimator-replay grid as TEXT, so sweeping a
+// recorded file over candidate configurations is an edit and a rerun of the shulib_replay
+// tool (tools/shulib_replay.cpp) rather than a C++ vector of configs and a rebuild.
+//
+// ── The format ──────────────────────────────────────────────────────────────────────
+// scenario_file.hpp's conventions: one directive per line, `#` starts a comment, tokens
+// are whitespace-separated, and a field is named by its config path in the config's own
+// units (Length in inches, Time in s, AngleDim in rad, AngularVelocity in rad/s).
+//
+//     set   wheel.diameter 2.75            # every config: the robot's geometry, say
+//     set   fusion ekf                     # complementary (the default) | ekf
+//     vary  complementary.maxGain 0.05 0.1 0.15 0.2
+//     vary  gps.gateSigma 3 4 5
+//     vary  fusion complementary ekf       # fusion is a field like any other
+//
+// `set` fixes a field for every configuration; `vary` adds an AXIS. The grid is the
+// cartesian product of the axes over the `set` base, in file order, the first axis
+// slowest — the four-by-three example above is twelve configurations. A file with no
+// `vary` is a grid of one. Each configuration is labelled by its axis values as typed,
+// so a table row reads as the line that made it. Paths: wheel., odometry., localizer.,
+// complementary., ekf. and gps. (the tables below), plus useGps and fusion. Parsing
+// never throws: a bad line is reported as the first error with its line number.
+//
+// Host-only, like the replay it feeds.
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shulib/math/angle.hpp"
+#include "shulib/sim/estimator_replay.hpp"
+#include "shulib/sim/scenario_file.hpp"
+
+namespace shulib::sim {
+
+/// The most configurations one grid may expand to — a typo'd axis must not ask for a
+/// week of replays.
+inline constexpr std::size_t kMaxReplayGridConfigs = 10000;
+
+/// A parsed grid: the configurations and, for each, its label (`path=value` for every
+/// axis, space-separated; empty for a grid with no axes).
+struct ReplayGrid {
+    std::vector<EstimatorReplayConfig> configs{};  ///< the expanded product, file order
+    std::vector<std::string> labels{};             ///< labels[i] names configs[i]
+};
+
+/// parseReplayGrid()'s answer: the grid, or the first error and its line.
+struct ReplayGridParseResult {
+    ReplayGrid grid{};    ///< valid only when ok()
+    std::string error{};  ///< empty on success
+    int line = 0;         ///< 1-based line of the error (0: the file as a whole)
+    /// True when the whole text parsed.
+    [[nodiscard]] bool ok() const noexcept { return error.empty(); }
+};
+
+namespace detail {
+
+using ERC = EstimatorReplayConfig;
+using CF = localization::ComplementaryFusionConfig;
+using EF = localization::EkfFusionConfig;
+using GC = localization::GpsCorrectorConfig;
+using PO = localization::PilonsOdometryConfig;
+using LC = localization::LocalizerConfig;
+
+/// Assign `v` to cfg.fusion: 0 is complementary, 1 is EKF (parseReplayValue's mapping).
+[[nodiscard]] inline bool assignReplayFusion(ERC& cfg, double v) {
+    if (v != 0.0 && v != 1.0) {
+        return false;
+    }
+    cfg.fusion = v == 0.0 ? ReplayFusion::Complementary : ReplayFusion::Ekf;
+    return true;
+}
+
+inline constexpr ScenarioField<ERC> kReplayFields[] = {
+    {"fusion", &assignReplayFusion},
+    {"useGps", &assignScenarioScalar<ERC, &ERC::useGps>},
+    {"wheel.diameter", &assignScenarioScalar<ERC, &ERC::trackingWheelDiameter>},
+    {"wheel.forwardLeftOffset", &assignScenarioScalar<ERC, &ERC::forwardWheelLeftOffset>},
+    {"wheel.lateralForwardOffset", &assignScenarioScalar<ERC, &ERC::lateralWheelForwardOffset>},
+    {"odometry.maxTickRotation", &assignScenarioField<ERC, &ERC::odometry, &PO::maxTickRotation>},
+    {"odometry.maxTickTravel", &assignScenarioField<ERC, &ERC::odometry, &PO::maxTickTravel>},
+    {"localizer.maxDt", &assignScenarioField<ERC, &ERC::localizer, &LC::maxDt>},
+    {"localizer.minDt", &assignScenarioField<ERC, &ERC::localizer, &LC::minDt>},
+    {"localizer.driftHorizon", &assignScenarioField<ERC, &ERC::localizer, &LC::driftHorizon>},
+    {"localizer.qFloor", &assignScenarioField<ERC, &ERC::localizer, &LC::qFloor>},
+    {"localizer.bootSettleTime", &assignScenarioField<ERC, &ERC::localizer, &LC::bootSettleTime>},
+    {"complementary.maxNudgeRate",
+     &assignScenarioField<ERC, &ERC::complementary, &CF::maxNudgeRate>},
+    {"complementary.innovationGate",
+     &assignScenarioField<ERC, &ERC::complementary, &CF::innovationGate>},
+    {"complementary.maxGain", &assignScenarioField<ERC, &ERC::complementary, &CF::maxGain>},
+    {"complementary.headingGate", &assignScenarioField<ERC, &ERC::complementary, &CF::headingGate>},
+    {"complementary.maxHeadingGain",
+     &assignScenarioField<ERC, &ERC::complementary, &CF::maxHeadingGain>},
+    {"complementary.maxHeadingNudgeRate",
+     &assignScenarioField<ERC, &ERC::complementary, &CF::maxHeadingNudgeRate>},
+    {"ekf.posNoisePerInch", &assignScenarioField<ERC, &ERC::ekf, &EF::posNoisePerInch>},
+    {"ekf.posNoiseRate", &assignScenarioField<ERC, &ERC::ekf, &EF::posNoiseRate>},
+    {"ekf.headingNoisePerRad", &assignScenarioField<ERC, &ERC::ekf, &EF::headingNoisePerRad>},
+    {"ekf.headingDriftRate", &assignScenarioField<ERC, &ERC::ekf, &EF::headingDriftRate>},
+    {"ekf.velNoise", &assignScenarioField<ERC, &ERC::ekf, &EF::velNoise>},
+    {"ekf.odomStdDev", &assignScenarioField<ERC, &ERC::ekf, &EF::odomStdDev>},
+    {"ekf.odomStdDevPerInch", &assignScenarioField<ERC, &ERC::ekf, &EF::odomStdDevPerInch>},
+    {"ekf.gateSigma", &assignScenarioField<ERC, &ERC::ekf, &EF::gateSigma>},
+    {"ekf.headingStdDev", &assignScenarioField<ERC, &ERC::ekf, &EF::headingStdDev>},
+    {"ekf.initialPosStdDev", &assignScenarioField<ERC, &ERC::ekf, &EF::initialPosStdDev>},
+    {"ekf.initialHeadingStdDev", &assignScenarioField<ERC, &ERC::ekf, &EF::initialHeadingStdDev>},
+    {"ekf.initialVelStdDev", &assignScenarioField<ERC, &ERC::ekf, &EF::initialVelStdDev>},
+    {"ekf.maxNudgeRate", &assignScenarioField<ERC, &ERC::ekf, &EF::maxNudgeRate>},
+    {"ekf.maxHeadingNudgeRate", &assignScenarioField<ERC, &ERC::ekf, &EF::maxHeadingNudgeRate>},
+    {"ekf.reinitRejectCount", &assignScenarioField<ERC, &ERC::ekf, &EF::reinitRejectCount>},
+    {"ekf.reinitInnovation", &assignScenarioField<ERC, &ERC::ekf, &EF::reinitInnovation>},
+    {"ekf.reinitCooldown", &assignScenarioField<ERC, &ERC::ekf, &EF::reinitCooldown>},
+    {"ekf.maxDt", &assignScenarioField<ERC, &ERC::ekf, &EF::maxDt>},
+    {"gps.latency", &assignScenarioField<ERC, &ERC::gps, &GC::latency>},
+    {"gps.rmsTrustFactor", &assignScenarioField<ERC, &ERC::gps, &GC::rmsTrustFactor>},
+    {"gps.minPositionStdDev", &assignScenarioField<ERC, &ERC::gps, &GC::minPositionStdDev>},
+    {"gps.maxReportedRms", &assignScenarioField<ERC, &ERC::gps, &GC::maxReportedRms>},
+    {"gps.maxYawRate", &assignScenarioField<ERC, &ERC::gps, &GC::maxYawRate>},
+    {"gps.gateSigma", &assignScenarioField<ERC, &ERC::gps, &GC::gateSigma>},
+    {"gps.postFixStdDev", &assignScenarioField<ERC, &ERC::gps, &GC::postFixStdDev>},
+    {"gps.driftStdDevPerInch", &assignScenarioField<ERC, &ERC::gps, &GC::driftStdDevPerInch>},
+};
+
+/// The settable path named `path`, or nullptr.
+[[nodiscard]] inline const ScenarioField<ERC>* findReplayField(std::string_view path) {
+    for (const ScenarioField<ERC>& f : kReplayFields) {
+        if (f.path == path) {
+            return &f;
+        }
+    }
+    return nullptr;
+}
+
+/// A value token for `path`: the fusion words for `fusion`, a scenario number otherwise.
+[[nodiscard]] inline bool parseReplayValue(std::string_view path, std::string_view tok,
+                                           double& out) {
+    if (path == "fusion") {
+        if (tok == "complementary" || tok == "ekf") {
+            out = tok == "ekf" ? 1.0 : 0.0;
+            return true;
+        }
+        return false;
+    }
+    return parseScenarioNumber(tok, out);
+}
+
+/// One `vary` line, parsed.
+struct ReplayAxis {
+    const ScenarioField<ERC>* field = nullptr;
+    std::vector<double> values{};
+    std::vector<std::string> text{};  // the values as typed, for the labels
+};
+
+}  // namespace detail
+
+/// Parse a grid (header format) and expand it. Never throws for bad text; an error names
+/// the line, and the grid is then empty.
+[[nodiscard]] inline ReplayGridParseResult parseReplayGrid(std::string_view text) {
+    ReplayGridParseResult r;
+    EstimatorReplayConfig base;
+    std::vector<detail::ReplayAxis> axes;
+    std::size_t product = 1;
+    int lineNo = 0;
+    std::size_t at = 0;
+    while (at <= text.size()) {
+        const std::size_t eol = text.find('\n', at);
+        const std::string_view line =
+            text.substr(at, eol == std::string_view::npos ? std::string_view::npos : eol - at);
+        at = eol == std::string_view::npos ? text.size() + 1 : eol + 1;
+        ++lineNo;
+        const std::vector<std::string_view> tok = detail::scenarioTokens(line);
+        if (tok.empty()) {
+            continue;
+        }
+        const auto fail = [&](std::string message) {
+            r.error = std::string{tok[0]} + ": " + std::move(message);
+            r.line = lineNo;
+            return r;
+        };
+        if (tok[0] != "set" && tok[0] != "vary") {
+            return fail("unknown directive (set | vary)");
+        }
+        if (tok.size() < 3 || (tok[0] == "set" && tok.size() != 3)) {
+            return fail(tok[0] == "set" ? "expects <path> <value>"
+                                        : "expects <path> <value> [<value>...]");
+        }
+        const detail::ScenarioField<detail::ERC>* field = detail::findReplayField(tok[1]);
+        if (field == nullptr) {
+            return fail("unknown path '" + std::string{tok[1]} + "'");
+        }
+        detail::ReplayAxis axis{field, {}, {}};
+        for (std::size_t i = 2; i < tok.size(); ++i) {
+            double v = 0.0;
+            EstimatorReplayConfig probe;
+            if (!detail::parseReplayValue(tok[1], tok[i], v) || !field->assign(probe, v)) {
+                return fail("bad value '" + std::string{tok[i]} + "' for " + std::string{tok[1]});
+            }
+            axis.values.push_back(v);
+            axis.text.emplace_back(tok[i]);
+        }
+        if (tok[0] == "set") {
+            (void)field->assign(base, axis.values[0]);
+            continue;
+        }
+        product *= axis.values.size();
+        if (product > kMaxReplayGridConfigs) {
+            return fail("the grid exceeds " + std::to_string(kMaxReplayGridConfigs)
+                        + " configurations");
+        }
+        axes.push_back(std::move(axis));
+    }
+
+    r.grid.configs.reserve(product);
+    r.grid.labels.reserve(product);
+    for (std::size_t n = 0; n < product; ++n) {
+        EstimatorReplayConfig cfg = base;
+        std::string label;
+        std::size_t rest = n;
+        std::size_t stride = product;
+        for (const detail::ReplayAxis& axis : axes) {
+            stride /= axis.values.size();
+            const std::size_t k = rest / stride;
+            rest %= stride;
+            (void)axis.field->assign(cfg, axis.values[k]);
+            if (!label.empty()) {
+                label += ' ';
+            }
+            label += std::string{axis.field->path} + "=" + axis.text[k];
+        }
+        r.grid.configs.push_back(cfg);
+        r.grid.labels.push_back(std::move(label));
+    }
+    return r;
+}
+
+/// parseReplayGrid() over a file's contents. A file that cannot be opened is an error
+/// on line 0.
+[[nodiscard]] inline ReplayGridParseResult loadReplayGridFile(const char* path) {
+    ReplayGridParseResult r;
+    std::FILE* f = std::fopen(path, "rb");
+    if (f == nullptr) {
+        r.error = std::string{"cannot open "} + path;
+        return r;
+    }
+    std::string text;
+    char buf[4096];
+    for (std::size_t n = std::fread(buf, 1, sizeof buf, f); n > 0;
+         n = std::fread(buf, 1, sizeof buf, f)) {
+        text.append(buf, n);
+    }
+    std::fclose(f);
+    return parseReplayGrid(text);
+}
+
+/// The per-configuration error table: one row per grid entry, in grid order, then the
+/// row with the lowest RMS position error. `stats[i]` belongs to `grid.configs[i]`.
+[[nodiscard]] inline std::string formatReplayTable(const ReplayGrid& grid,
+                                                   const std::vector<ReplayStats>& stats) {
+    char line[200];
+    std::string out;
+    out += "  config  rms-pos(in)  max-pos(in)  final-pos(in)  rms-hdg(deg)  accepted  rejected"
+           "  label\n";
+    std::size_t best = 0;
+    for (std::size_t i = 0; i < stats.size(); ++i) {
+        const ReplayStats& s = stats[i];
+        std::snprintf(line, sizeof line, "%8zu  %11.4f  %11.4f  %13.4f  %12.4f  %8zu  %8zu  ", i,
+                      s.rmsPositionError, s.maxPositionError, s.finalPositionError,
+                      s.rmsHeadingError * 180.0 / math::Angle::kPi, s.acceptedTicks,
+                      s.rejectedTicks);
+        out += line;
+        out += i < grid.labels.size() && !grid.labels[i].empty() ? grid.labels[i] : "-";
+        out += '\n';
+        if (s.rmsPositionError < stats[best].rmsPositionError) {
+            best = i;
+        }
+    }
+    if (!stats.empty()) {
+        std::snprintf(line, sizeof line,
+                      "%zu config(s) over %zu tick(s); lowest rms-pos: config %zu\n", stats.size(),
+                      stats[0].ticks, best);
+        out += line;
+    }
+    return out;
+}
+
+}  // namespace shulib::sim
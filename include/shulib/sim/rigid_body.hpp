@@ -0,0 +1,383 @@
+#pragma once
+//
+// sim::RigidBodyModel — DrivePlant's optional dynamics mode (PlantDynamics::RigidBody):
+// per-wheel motor force → Coulomb-capped traction → body force and yaw torque → a body
+// twist integrated through mass and inertia.
+//
+// The kinematic plant (motor_model.hpp) sets each wheel's speed from its voltage and takes
+// the body twist from IKinematics::forward(), so its robot can never slide, never carries
+// momentum a wheel cannot stop, and turns no slower for being heavy about yaw. Aggressive
+// acceleration settings fail on the field exactly there. This mode integrates forces:
+//
+// ── One substep (h = dt / substeps) ─────────────────────────────────────────────────
+//   1. loads      N_i = m·g/n, plus load transfer when cgHeight > 0 (below)
+//   2. motor      each spin s_i moves toward MotorModel's steady-state speed under the
+//                 torque proxy F_i = kF·kV·(v_ss − s_i) (motor_model.hpp) acting on the
+//                 wheel's own inertia — back-EMF taken implicitly, so no h is unstable
+//   3. frame      the body-frame velocity turns by −ω·h: a body coasting straight across
+//                 the field turns underneath its own velocity
+//   4. traction   sequential impulses, a fixed number of passes in wheel order. Each
+//                 wheel's impulse drives its slip s_i − J_i·q to zero, its running total
+//                 clamped to ±μ·grip_i·N_i·h (Coulomb). The same impulse slows the wheel
+//                 and pushes the body along J_iᵀ — the virtual-work dual of the wheel's
+//                 row of toWheels(), so force and speed share ONE geometry, the frozen F5
+//                 contract the kinematic plant already uses (drive_plant.hpp)
+//   5. scrub      a drivetrain blind to a body direction (tank: sideways) holds it with
+//                 the treads' side friction, capped at μ·m·g·h
+// DrivePlant then integrates truth over h with the resulting twist (the same zero-order
+// hold as its kinematic tick) and accumulates the encoders from the substep's spin and
+// twist.
+//
+// STICK / SLIP: a wheel under its cap leaves the solve with zero slip — pure rolling, the
+// kinematic plant's world. One at its cap slides on kinetic friction: its encoder
+// overcounts (spin ≠ contact speed) and the body gets only μ·N. DrivePlant::trueWheelSlip()
+// reports the difference.
+//
+// STEADY STATE IS THE KINEMATIC PLANT'S: on a flat floor with nothing resisting, a rolling
+// wheel settles at MotorModel's steady-state speed, so Feedforward::calculate(v) still holds
+// v (test/sim_rigid_body_test.cpp pins it). Only the way there differs — and what happens
+// past the grip.
+//
+// ── Load transfer (cgHeight > 0) ────────────────────────────────────────────────────
+// Accelerating at a (body frame) with the centre of mass h_cg above the floor shifts load:
+// Σ N_i·x_i = −m·a_x·h_cg, Σ N_i·y_i = −m·a_y·h_cg, Σ N_i = m·g. More than three wheels
+// make that statically indeterminate; the model takes the least-norm split (the even share
+// plus Aᵀ(AAᵀ)⁻¹ of the moments) — the symmetric answer for a symmetric drive. a is the
+// previous substep's, a one-substep lag. A load that goes negative is a lifted wheel:
+// clamped to zero and not redistributed (tipping is outside this model). Needs the wheel
+// contact points (RigidBodyConfig::wheelX/wheelY), which the kinematics table does not
+// carry; with cgHeight = 0 they are ignored.
+//
+// ── What this is NOT ────────────────────────────────────────────────────────────────
+// Every constant is invented (A4: HA-132): the mode shows how a controller behaves WHEN
+// physics bites, not at what acceleration it does — motor_model.hpp's honesty boundary
+// still holds for the numbers. No friction circle (a wheel's rolling and the scrub grip are
+// budgeted separately), no rolling resistance, no motor current limit (HA-49), and the
+// centre of mass is the body origin. The model is linear in the kinematics, so it requires
+// a constant toWheels() matrix — every drive in the tree. Deterministic as the plant is:
+// fixed arrays, fixed order, fixed passes.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+
+#include "shulib/control/feedforward.hpp"
+#include "shulib/core/check.hpp"
+#include "shulib/kinematics/kinematics.hpp"
+#include "shulib/kinematics/wheel_speeds.hpp"
+#include "shulib/math/twist2d.hpp"
+#include "shulib/sim/motor_model.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::sim {
+
+/// Which dynamics a DrivePlant runs (DrivePlantConfig::dynamics).
+enum class PlantDynamics {
+    Kinematic,  ///< wheel speed from inverted feedforward; the body follows (motor_model.hpp)
+    RigidBody,  ///< forces, mass, inertia and Coulomb traction (this header)
+};
+
+/// Standard gravity in the plant's length unit (in/s²).
+inline constexpr double kGravityInPerS2 = 386.0886;
+
+/// The rigid-body mode's physical constants. Mass is in pounds and force in pounds-force;
+/// the model converts through kGravityInPerS2. Every default is PROVISIONAL (A4: HA-132).
+struct RigidBodyConfig {
+    static constexpr std::size_t kWheels =
+        static_cast<std::size_t>(kinematics::WheelSpeeds::kMaxWheels);
+
+    double massLb = 15.0;            ///< robot mass (lb) — PROVISIONAL (A4: HA-132)
+    double yawInertiaLbIn2 = 810.0;  ///< about the vertical axis (lb·in²) — PROVISIONAL (A4: HA-132)
+    /// Tread force per volt of torque proxy, per wheel (lbf/V). 0.23 puts an 11 V stall at
+    /// ≈ 2.5 lbf per wheel. PROVISIONAL (A4: HA-132)
+    double forcePerVoltLbf = 0.23;
+    /// A wheel's spin inertia — motor, gearing, wheel — reflected to its tread as a mass
+    /// (lb). Replaces MotorModel's kA, which this mode ignores. PROVISIONAL (A4: HA-132)
+    double wheelInertiaLb = 0.25;
+    double friction = 0.9;  ///< Coulomb μ, tread on tile (rolling and scrub) — PROVISIONAL (A4: HA-132)
+    units::Length cgHeight{0.0};                  ///< centre of mass above the floor; 0 → no load transfer
+    std::array<units::Length, kWheels> wheelX{};  ///< contact points, +FORWARD — load transfer only
+    std::array<units::Length, kWheels> wheelY{};  ///< contact points, +LEFT — load transfer only
+    int substeps = 10;                            ///< substeps per plant tick
+    int contactPasses = 8;                        ///< sequential-impulse passes per substep
+};
+
+/// The solver behind PlantDynamics::RigidBody (header). Immutable once built: the state it
+/// advances — body twist, wheel spins, last acceleration — belongs to the plant.
+class RigidBodyModel {
+public:
+    static constexpr std::size_t kWheels = RigidBodyConfig::kWheels;
+    /// Per-wheel storage, in the plant's own currency.
+    using Spins = std::array<units::Velocity, kWheels>;
+    using Volts = std::array<units::Voltage, kWheels>;
+    using Grips = std::array<double, kWheels>;
+
+    /// `kinematics` is probed once here (its toWheels() rows); it need not outlive the model.
+    /// Preconditions: every mass, inertia and force constant > 0, friction >= 0, substeps
+    /// and passes >= 1, a linear drivetrain that sees at least two body directions, and —
+    /// when cgHeight > 0 — wheel contact points that are not collinear.
+    RigidBodyModel(const kinematics::IKinematics& kinematics, const RigidBodyConfig& config,
+                   const control::FeedforwardGains& wheelFf)
+        : motor_{wheelFf}, cfg_{config} {
+        SHULIB_PRECONDITION(cfg_.massLb > 0.0 && cfg_.yawInertiaLbIn2 > 0.0,
+                            "RigidBodyModel: mass and yaw inertia must be > 0");
+        SHULIB_PRECONDITION(cfg_.forcePerVoltLbf > 0.0 && cfg_.wheelInertiaLb > 0.0,
+                            "RigidBodyModel: forcePerVolt and wheelInertia must be > 0");
+        SHULIB_PRECONDITION(cfg_.friction >= 0.0 && std::isfinite(cfg_.friction),
+                            "RigidBodyModel: friction must be finite and >= 0");
+        SHULIB_PRECONDITION(cfg_.cgHeight.value() >= 0.0, "RigidBodyModel: cgHeight must be >= 0");
+        SHULIB_PRECONDITION(cfg_.substeps >= 1 && cfg_.contactPasses >= 1,
+                            "RigidBodyModel: substeps and contactPasses must be >= 1");
+        n_ = kinematics.wheelCount();
+        SHULIB_PRECONDITION(n_ >= 1 && n_ <= kinematics::WheelSpeeds::kMaxWheels,
+                            "RigidBodyModel: wheel count must be in [1, kMaxWheels]");
+
+        invMass_ = 1.0 / cfg_.massLb;
+        invInertia_ = 1.0 / cfg_.yawInertiaLbIn2;
+        invWheel_ = 1.0 / cfg_.wheelInertiaLb;
+        motorRate_ = cfg_.forcePerVoltLbf * kGravityInPerS2 * wheelFf.kV * invWheel_;
+        probeRows(kinematics);
+        findBlindDirection();
+        if (cfg_.cgHeight.value() > 0.0) {
+            solveLoadTransfer();
+        }
+    }
+
+    [[nodiscard]] int substeps() const noexcept { return cfg_.substeps; }
+
+    /// One substep of `h` seconds (header, steps 1–5). `effective` and `grip` are the tick's
+    /// per-wheel volts and grip scale in [0, 1]; `body`, `spin` and `accel` (the body-frame
+    /// linear acceleration, in/s², that load transfer reads) are advanced in place.
+    void substep(const Volts& effective, const Grips& grip, double h, math::Twist2d& body,
+                 Spins& spin, std::array<double, 2>& accel) const {
+        const double mg = cfg_.massLb * kGravityInPerS2;
+
+        // 1. Loads → each wheel's impulse cap for this substep.
+        std::array<double, kWheels> cap{};
+        for (std::size_t i = 0; i < static_cast<std::size_t>(n_); ++i) {
+            const double transfer = cfg_.massLb * cfg_.cgHeight.value()
+                                  * (loadX_[i] * accel[0] + loadY_[i] * accel[1]);
+            const double load = std::max(0.0, mg / static_cast<double>(n_) - transfer);
+            cap[i] = cfg_.friction * grip[i] * load * h;
+        }
+
+        // 2. Motor: exact for the wheel alone, v → v_ss at rate kF·kV / wheel inertia.
+        const double beta = motorRate_ * h;
+        const double alpha = beta / (1.0 + beta);
+        std::array<double, kWheels> s{};
+        for (std::size_t i = 0; i < static_cast<std::size_t>(n_); ++i) {
+            const double vss = motor_.steadyStateSpeed(effective[i]).value();
+            s[i] = spin[i].value() + (vss - spin[i].value()) * alpha;
+        }
+
+        // 3. Frame: the body-frame velocity turns by −ω·h.
+        double q[3] = {body.vx().value(), body.vy().value(), body.omega().value()};
+        const double c = std::cos(q[2] * h);
+        const double sn = std::sin(q[2] * h);
+        const double vx = c * q[0] + sn * q[1];
+        const double vy = -sn * q[0] + c * q[1];
+        q[0] = vx;
+        q[1] = vy;
+
+        // 4–5. Traction and scrub: sequential impulses, totals clamped (Coulomb).
+        std::array<double, kWheels> impulse{};
+        double scrub = 0.0;
+        double meanGrip = 0.0;
+        for (std::size_t i = 0; i < static_cast<std::size_t>(n_); ++i) {
+            meanGrip += grip[i];
+        }
+        const double scrubCap = cfg_.friction * meanGrip / static_cast<double>(n_) * mg * h;
+        for (int pass = 0; pass < cfg_.contactPasses; ++pass) {
+            for (std::size_t i = 0; i < static_cast<std::size_t>(n_); ++i) {
+                const Row& r = rows_[i];
+                const double slip = s[i] - (r.h * q[0] + r.v * q[1] + r.turn * q[2]);
+                const double total = std::clamp(impulse[i] + slip / r.k, -cap[i], cap[i]);
+                const double d = total - impulse[i];
+                impulse[i] = total;
+                s[i] -= d * invWheel_;
+                q[0] += r.h * d * invMass_;
+                q[1] += r.v * d * invMass_;
+                q[2] += r.turn * d * invInertia_;
+            }
+            if (hasBlind_) {
+                const double along = blind_.h * q[0] + blind_.v * q[1] + blind_.turn * q[2];
+                const double total = std::clamp(scrub - along / blind_.k, -scrubCap, scrubCap);
+                const double d = total - scrub;
+                scrub = total;
+                q[0] += blind_.h * d * invMass_;
+                q[1] += blind_.v * d * invMass_;
+                q[2] += blind_.turn * d * invInertia_;
+            }
+        }
+
+        double fx = blind_.h * scrub;
+        double fy = blind_.v * scrub;
+        for (std::size_t i = 0; i < static_cast<std::size_t>(n_); ++i) {
+            fx += rows_[i].h * impulse[i];
+            fy += rows_[i].v * impulse[i];
+            spin[i] = units::Velocity{s[i]};
+        }
+        accel = {fx * invMass_ / h, fy * invMass_ / h};
+        body = math::Twist2d{units::Velocity{q[0]}, units::Velocity{q[1]},
+                             units::AngularVelocity{q[2]}};
+    }
+
+private:
+    /// One constraint direction in twist space, with its inverse effective mass.
+    struct Row {
+        double h = 0.0;     ///< multiplies vx
+        double v = 0.0;     ///< multiplies vy
+        double turn = 0.0;  ///< multiplies ω (inches)
+        double k = 0.0;     ///< slip change per unit impulse (1/lb)
+    };
+
+    /// Read each wheel's toWheels() row off three unit twists, and refuse a drive whose
+    /// rows are not constant (the model's superposition needs a matrix).
+    void probeRows(const kinematics::IKinematics& kin) {
+        using math::ChassisSpeeds;
+        const auto wx = kin.toWheels(ChassisSpeeds{units::Velocity{1.0}, units::Velocity{0.0},
+                                                   units::AngularVelocity{0.0}});
+        const auto wy = kin.toWheels(ChassisSpeeds{units::Velocity{0.0}, units::Velocity{1.0},
+                                                   units::AngularVelocity{0.0}});
+        const auto ww = kin.toWheels(ChassisSpeeds{units::Velocity{0.0}, units::Velocity{0.0},
+                                                   units::AngularVelocity{1.0}});
+        const auto mix = kin.toWheels(ChassisSpeeds{units::Velocity{2.0}, units::Velocity{-3.0},
+                                                    units::AngularVelocity{0.5}});
+        for (int i = 0; i < n_; ++i) {
+            Row& r = rows_[static_cast<std::size_t>(i)];
+            r.h = wx[i].value();
+            r.v = wy[i].value();
+            r.turn = ww[i].value();
+            const double expect = 2.0 * r.h - 3.0 * r.v + 0.5 * r.turn;
+            SHULIB_PRECONDITION(std::abs(mix[i].value() - expect)
+                                    <= 1e-9 * (1.0 + std::abs(expect)),
+                                "RigidBodyModel: the kinematics must be linear (a constant toWheels matrix)");
+            r.k = invWheel_ + (r.h * r.h + r.v * r.v) * invMass_ + r.turn * r.turn * invInertia_;
+        }
+    }
+
+    /// A twist direction no wheel's row sees (header step 5): the normal to the rows when
+    /// they span two directions, nothing when they span three. Scaled so its translational
+    /// part is a unit vector, which makes the scrub impulse a plain force·time.
+    void findBlindDirection() {
+        // Column-normalize so inches and dimensionless factors compare fairly.
+        double scale[3] = {0.0, 0.0, 0.0};
+        for (int i = 0; i < n_; ++i) {
+            const Row& r = rows_[static_cast<std::size_t>(i)];
+            scale[0] += r.h * r.h;
+            scale[1] += r.v * r.v;
+            scale[2] += r.turn * r.turn;
+        }
+        double best[3] = {0.0, 0.0, 0.0};
+        double bestNorm = 0.0;
+        int zeroColumns = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (scale[axis] == 0.0) {
+                ++zeroColumns;
+                best[0] = best[1] = best[2] = 0.0;
+                best[axis] = 1.0;
+                bestNorm = 1.0;
+            }
+            scale[axis] = scale[axis] > 0.0 ? 1.0 / std::sqrt(scale[axis]) : 0.0;
+        }
+        SHULIB_PRECONDITION(zeroColumns <= 1,
+                            "RigidBodyModel: the drivetrain must see at least two body directions");
+        if (zeroColumns == 0) {
+            // The largest cross product of two normalized rows: the rows' normal when they
+            // are coplanar. Coplanar means every row is nearly orthogonal to it.
+            for (int i = 0; i < n_; ++i) {
+                for (int j = i + 1; j < n_; ++j) {
+                    const Row& a = rows_[static_cast<std::size_t>(i)];
+                    const Row& b = rows_[static_cast<std::size_t>(j)];
+                    const double ua[3] = {a.h * scale[0], a.v * scale[1], a.turn * scale[2]};
+                    const double ub[3] = {b.h * scale[0], b.v * scale[1], b.turn * scale[2]};
+                    const double x[3] = {ua[1] * ub[2] - ua[2] * ub[1],
+                                         ua[2] * ub[0] - ua[0] * ub[2],
+                                         ua[0] * ub[1] - ua[1] * ub[0]};
+                    const double norm = std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+                    if (norm > bestNorm) {
+                        bestNorm = norm;
+                        best[0] = x[0] / norm;
+                        best[1] = x[1] / norm;
+                        best[2] = x[2] / norm;
+                    }
+                }
+            }
+            SHULIB_PRECONDITION(bestNorm > 1e-6,
+                                "RigidBodyModel: the drivetrain must see at least two body directions");
+            for (int i = 0; i < n_; ++i) {
+                const Row& r = rows_[static_cast<std::size_t>(i)];
+                const double dot =
+                    r.h * scale[0] * best[0] + r.v * scale[1] * best[1] + r.turn * scale[2] * best[2];
+                const double rowNorm = std::sqrt(r.h * r.h * scale[0] * scale[0]
+                                                 + r.v * r.v * scale[1] * scale[1]
+                                                 + r.turn * r.turn * scale[2] * scale[2]);
+                if (std::abs(dot) > 1e-9 * rowNorm) {
+                    return;  // the rows span all three directions: nothing is blind
+                }
+            }
+            // Back to twist coordinates: J·S·n = 0 ⇒ J·(S·n) = 0.
+            for (int axis = 0; axis < 3; ++axis) {
+                best[axis] *= scale[axis];
+            }
+        }
+        const double translational = std::sqrt(best[0] * best[0] + best[1] * best[1]);
+        SHULIB_PRECONDITION(translational > 0.0,
+                            "RigidBodyModel: a drivetrain blind to pure rotation cannot be scrubbed");
+        blind_.h = best[0] / translational;
+        blind_.v = best[1] / translational;
+        blind_.turn = best[2] / translational;
+        blind_.k = (blind_.h * blind_.h + blind_.v * blind_.v) * invMass_
+                 + blind_.turn * blind_.turn * invInertia_;
+        hasBlind_ = true;
+    }
+
+    /// The least-norm load split (header): per-wheel weights on a_x and a_y, from
+    /// Aᵀ(AAᵀ)⁻¹ with A's rows 1, x_i, y_i.
+    void solveLoadTransfer() {
+        double g[3][3] = {};
+        for (int i = 0; i < n_; ++i) {
+            const auto idx = static_cast<std::size_t>(i);
+            const double a[3] = {1.0, cfg_.wheelX[idx].value(), cfg_.wheelY[idx].value()};
+            for (int r = 0; r < 3; ++r) {
+                for (int c = 0; c < 3; ++c) {
+                    g[r][c] += a[r] * a[c];
+                }
+            }
+        }
+        const double det = g[0][0] * (g[1][1] * g[2][2] - g[1][2] * g[2][1])
+                         - g[0][1] * (g[1][0] * g[2][2] - g[1][2] * g[2][0])
+                         + g[0][2] * (g[1][0] * g[2][1] - g[1][1] * g[2][0]);
+        SHULIB_PRECONDITION(std::abs(det) > 1e-9 * g[0][0] * (1.0 + g[1][1]) * (1.0 + g[2][2]),
+                            "RigidBodyModel: load transfer needs wheel contact points that are not collinear");
+        // Columns 1 and 2 of G⁻¹ (the moment equations' right-hand sides), by cofactors.
+        const double inv[3][2] = {
+            {-(g[0][1] * g[2][2] - g[0][2] * g[2][1]) / det, (g[0][1] * g[1][2] - g[0][2] * g[1][1]) / det},
+            {(g[0][0] * g[2][2] - g[0][2] * g[2][0]) / det, -(g[0][0] * g[1][2] - g[0][2] * g[1][0]) / det},
+            {-(g[0][0] * g[2][1] - g[0][1] * g[2][0]) / det, (g[0][0] * g[1][1] - g[0][1] * g[1][0]) / det},
+        };
+        for (int i = 0; i < n_; ++i) {
+            const auto idx = static_cast<std::size_t>(i);
+            const double a[3] = {1.0, cfg_.wheelX[idx].value(), cfg_.wheelY[idx].value()};
+            loadX_[idx] = a[0] * inv[0][0] + a[1] * inv[1][0] + a[2] * inv[2][0];
+            loadY_[idx] = a[0] * inv[0][1] + a[1] * inv[1][1] + a[2] * inv[2][1];
+        }
+    }
+
+    MotorModel motor_;
+    RigidBodyConfig cfg_;
+    int n_ = 0;
+    double invMass_ = 0.0;
+    double invInertia_ = 0.0;
+    double invWheel_ = 0.0;
+    double motorRate_ = 0.0;  ///< kF·kV / wheel inertia (1/s)
+    std::array<Row, kWheels> rows_{};
+    Row blind_{};
+    bool hasBlind_ = false;
+    std::array<double, kWheels> loadX_{};  ///< N_i −= m·h_cg·(loadX_i·a_x + loadY_i·a_y)
+    std::array<double, kWheels> loadY_{};
+};
+
+}  // namespace shulib::sim
@@ -37,11 +37,31 @@
 // The VARIABLE-dt overload is the A3 LOOP-JITTER SEAM (degradation.hpp's note):
 // hostile timing is injected by handing it a dt schedule, not by changing the plant.
 //
+// ── Checkpoint and fork (snapshot / restore) ────────────────────────────────────────
+// A sweep whose branches share a long common prefix (drive to the goal zone, THEN try K
+// different endings) runs the prefix once: snapshot() copies every piece of between-tick
+// state into one trivially copyable SimSnapshot, and restore() puts it into another
+// harness built from the SAME config, kinematics and degradation setup. The blob holds:
+// the clock; the plant's truth, wheel spin, encoder shafts and Rng (DrivePlantState);
+// every fake the plant writes or a controller commands (motor volts, brake mode and
+// readings; IMU; GPS; battery; both tracking encoders); and the degradation model's
+// call-history state (DegradationModel::saveState — configs are not state). It does NOT
+// hold the telemetry sink (an output), the tag/vision fakes (scenario-scripted inputs
+// the plant never writes; a branch that scripts them sets them itself), or anything the
+// SCENARIO owns — a controller, a JitterSchedule, an estimator — which the fork must
+// copy alongside. A restored harness then replays BYTE-IDENTICALLY to the straight run
+// (pinned by test, under FullHostility).
+//
+// restore() never moves time backward: FakeClock's monotonic contract stands, because
+// code under test may hold timestamps from it. So a fork restores into a FRESH harness
+// (or one not yet past the checkpoint); rewinding a harness in place is refused.
+//
 // Host-test infrastructure: allocation and virtuals are fine here; this never runs
 // on the V5. Single-task by contract.
 
 #include <array>
 #include <cstddef>
+#include <type_traits>
 #include <span>
 
 #include "shulib/chassis/robot_context.hpp"
@@ -49,12 +69,14 @@
 #include "shulib/core/check.hpp"
 #include "shulib/hal/fake/fake_battery.hpp"
 #include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/hal/fake/fake_distance.hpp"
 #include "shulib/hal/fake/fake_gps.hpp"
 #include "shulib/hal/fake/fake_imu.hpp"
 #include "shulib/hal/fake/fake_motor.hpp"
 #include "shulib/hal/fake/fake_rotation.hpp"
 #include "shulib/hal/fake/fake_tag_source.hpp"
 #include "shulib/hal/fake/fake_vision.hpp"
+#include "shulib/hal/motor.hpp"
 #include "shulib/hal/null_sink.hpp"
 #include "shulib/hal/telemetry_sink.hpp"
 #include "shulib/kinematics/kinematics.hpp"
@@ -83,6 +105,47 @@ struct TruthSample {
 static_assert(sizeof(TruthSample) == 7 * sizeof(double),
               "TruthSample must stay packed doubles (memcmp-comparable)");
 
+/// A SimHarness checkpoint (header: "Checkpoint and fork"): trivially copyable, about
+/// 100 KiB — keep it on the heap, and fill it with SimHarness::snapshot().
+struct SimSnapshot {
+    /// One drive motor's fake: what was commanded and what its sensors read.
+    struct Motor {
+        units::Voltage commanded{};                            ///< post-clamp command
+        hal::BrakeMode brakeMode = hal::BrakeMode::Coast;      ///< commanded brake mode
+        units::AngleDim position{};                            ///< encoder reading
+        units::AngularVelocity velocity{};                     ///< velocity reading
+        units::Current current{};                              ///< current reading
+        double temperature = 0.0;                              ///< temperature reading (°C)
+    };
+    /// A tracking encoder's fake readings.
+    struct Rotation {
+        units::AngleDim position{};         ///< shaft reading
+        units::AngularVelocity velocity{};  ///< velocity reading
+    };
+
+    double t = 0.0;         ///< the clock (s)
+    DrivePlantState plant;  ///< truth, spin, shafts, Rng
+    /// Every motor slot (only the harness's motorCount() are meaningful).
+    std::array<Motor, static_cast<std::size_t>(kinematics::WheelSpeeds::kMaxWheels)> motors{};
+    math::Angle imuHeading{};                 ///< IMU heading reading
+    units::AngularVelocity imuYawRate{};      ///< IMU yaw-rate reading
+    bool imuReady = true;                     ///< IMU ready flag
+    math::Angle imuPitch{};                   ///< IMU pitch reading
+    math::Angle imuRoll{};                    ///< IMU roll reading
+    math::Pose2d gpsPose{};                   ///< GPS pose reading
+    units::Length gpsRmsError{};              ///< GPS rms reading
+    bool gpsHasFix = false;                   ///< GPS fix flag
+    units::Voltage batteryVoltage{};          ///< battery voltage reading
+    units::Current batteryCurrent{};          ///< battery current reading
+    double batteryCapacity = 0.0;             ///< battery capacity reading
+    Rotation forwardEncoder{};                ///< the forward tracking encoder
+    Rotation lateralEncoder{};                ///< the lateral tracking encoder
+    std::size_t degradationBytes = 0;         ///< how much of `degradation` is in use
+    DegradationStateBlob degradation{};       ///< DegradationModel::saveState's output
+};
+static_assert(std::is_trivially_copyable_v<SimSnapshot>,
+              "SimSnapshot must stay trivially copyable (a fork is a memcpy)");
+
 /// A seeded random body twist for sweep scenarios — |vx|,|vy| <= vMax (in/s),
 /// |omega| <= omegaMax (rad/s). Draw order is part of the scenario contract
 /// (vx, vy, omega), so the same Rng state always yields the same twist.
@@ -104,6 +167,11 @@ struct SimHarnessConfig {
     units::Length trackingWheelDiameter{2.0};
     units::Length forwardWheelLeftOffset{-3.0};    ///< forward wheel's +LEFT coordinate
     units::Length lateralWheelForwardOffset{-4.5};  ///< lateral wheel's +FORWARD coordinate
+    /// Distance sensors the plant ray-casts against plant.field (field_geometry.hpp): the
+    /// first `distanceSensors` mounts feed distance(0), distance(1), …. Needs a field.
+    std::array<DistanceMount, static_cast<std::size_t>(DrivePlant::kMaxDistanceSensors)>
+        distanceMounts{};
+    int distanceSensors = 0;  ///< how many of distanceMounts are wired
 };
 
 class SimHarness {
@@ -119,6 +187,7 @@ public:
           n_{kinematics.wheelCount()},
           kin_{kinematics},
           sink_{sink != nullptr ? sink : &ownNullSink_},
+          degradation_{degradation != nullptr ? degradation : &ownIdentityDegradation_},
           fakeMotorPtrs_{makePtrs<hal::fake::FakeMotor>(motorStorage_)},
           iMotorPtrs_{makePtrs<hal::IMotor>(motorStorage_)},
           trackingSpecs_{TrackingWheelSpec{&forwardEncoder_, TrackingAxis::Forward,
@@ -136,7 +205,7 @@ public:
                  gps_,
                  battery_,
                  std::span<const TrackingWheelSpec>{trackingSpecs_.data(), trackingSpecs_.size()},
-                 degradation != nullptr ? *degradation : ownIdentityDegradation_,
+                 *degradation_,
                  *sink_,
                  config.plant},
           context_{chassis::RobotContextConfig{
@@ -148,7 +217,15 @@ public:
               .battery = &battery_,
               .telemetry = sink_,
               .tags = &tags_,
-              .vision = &vision_}} {}
+              .vision = &vision_}} {
+        SHULIB_PRECONDITION(config.distanceSensors >= 0
+                                && config.distanceSensors <= DrivePlant::kMaxDistanceSensors,
+                            "SimHarness: distanceSensors must be in [0, kMaxDistanceSensors]");
+        for (int i = 0; i < config.distanceSensors; ++i) {
+            const auto idx = static_cast<std::size_t>(i);
+            plant_.attachDistanceSensor(distance_[idx], config.distanceMounts[idx]);
+        }
+    }
 
     // ── the world as the code under test sees it (constraint 1) ────────────────────
     [[nodiscard]] chassis::RobotContext& context() noexcept { return context_; }
@@ -163,6 +240,15 @@ public:
     [[nodiscard]] int motorCount() const noexcept { return n_; }
     [[nodiscard]] hal::fake::FakeRotation& forwardEncoder() noexcept { return forwardEncoder_; }
     [[nodiscard]] hal::fake::FakeRotation& lateralEncoder() noexcept { return lateralEncoder_; }
+    /// The tag source the context reads — scripted by the test (or a scenario's
+    /// synthetic camera); empty until then.
+    [[nodiscard]] hal::fake::FakeTagSource& tags() noexcept { return tags_; }
+    /// The i-th distance sensor (SimHarnessConfig::distanceMounts).
+    [[nodiscard]] hal::fake::FakeDistance& distance(int i) {
+        SHULIB_PRECONDITION(i >= 0 && i < cfg_.distanceSensors,
+                            "SimHarness::distance: index out of range");
+        return distance_[static_cast<std::size_t>(i)];
+    }
 
     /// Tracking wheels wired with the SAME geometry the plant synthesizes with —
     /// the honest configuration for an odometry under test. (For a deliberate
@@ -191,6 +277,77 @@ public:
                            tw.omega().value()};
     }
 
+    // ── checkpoint and fork (see the header) ───────────────────────────────────────
+    /// Copy every piece of between-tick state into `out`.
+    void snapshot(SimSnapshot& out) const {
+        out.t = clock_.now().value();
+        out.plant = plant_.state();
+        for (std::size_t i = 0; i < motorStorage_.size(); ++i) {
+            const hal::fake::FakeMotor& m = motorStorage_[i];
+            out.motors[i] = SimSnapshot::Motor{m.commandedVoltage(), m.brakeMode(), m.position(),
+                                               m.velocity(),         m.current(),   m.temperature()};
+        }
+        out.imuHeading = imu_.heading();
+        out.imuYawRate = imu_.yawRate();
+        out.imuReady = imu_.isReady();
+        out.imuPitch = imu_.pitch();
+        out.imuRoll = imu_.roll();
+        out.gpsPose = gps_.pose();
+        out.gpsRmsError = gps_.rmsError();
+        out.gpsHasFix = gps_.hasFix();
+        out.batteryVoltage = battery_.voltage();
+        out.batteryCurrent = battery_.current();
+        out.batteryCapacity = battery_.capacity();
+        out.forwardEncoder = SimSnapshot::Rotation{forwardEncoder_.position(),
+                                                   forwardEncoder_.velocity()};
+        out.lateralEncoder = SimSnapshot::Rotation{lateralEncoder_.position(),
+                                                   lateralEncoder_.velocity()};
+        StateWriter w{out.degradation};
+        degradation_->saveState(w);
+        out.degradationBytes = w.used();
+    }
+
+    /// Resume from `snap`, taken from a harness built the same way. Preconditions: the
+    /// wiring matches, this clock is not past the snapshot (time never moves backward),
+    /// and the degradation model consumes exactly the bytes its twin wrote.
+    void restore(const SimSnapshot& snap) {
+        SHULIB_PRECONDITION(snap.degradationBytes <= snap.degradation.size(),
+                            "SimHarness::restore: corrupt snapshot");
+        SHULIB_PRECONDITION(snap.plant.wheelCount == n_,
+                            "SimHarness::restore: the snapshot is from a differently wired harness");
+        clock_.set(units::Time{snap.t});  // refuses a rewind before anything has changed
+        plant_.restore(snap.plant);
+        for (std::size_t i = 0; i < motorStorage_.size(); ++i) {
+            hal::fake::FakeMotor& m = motorStorage_[i];
+            const SimSnapshot::Motor& sm = snap.motors[i];
+            m.setVoltage(sm.commanded);  // already clamped, so it lands unchanged
+            m.setBrakeMode(sm.brakeMode);
+            m.setPosition(sm.position);
+            m.setVelocity(sm.velocity);
+            m.setCurrent(sm.current);
+            m.setTemperature(sm.temperature);
+        }
+        imu_.setHeading(snap.imuHeading);
+        imu_.setYawRate(snap.imuYawRate);
+        imu_.setReady(snap.imuReady);
+        imu_.setPitch(snap.imuPitch);
+        imu_.setRoll(snap.imuRoll);
+        gps_.setPose(snap.gpsPose);
+        gps_.setRmsError(snap.gpsRmsError);
+        gps_.setHasFix(snap.gpsHasFix);
+        battery_.setVoltage(snap.batteryVoltage);
+        battery_.setCurrent(snap.batteryCurrent);
+        battery_.setCapacity(snap.batteryCapacity);
+        forwardEncoder_.setPosition(snap.forwardEncoder.position);
+        forwardEncoder_.setVelocity(snap.forwardEncoder.velocity);
+        lateralEncoder_.setPosition(snap.lateralEncoder.position);
+        lateralEncoder_.setVelocity(snap.lateralEncoder.velocity);
+        StateReader r{std::span<const std::byte>{snap.degradation.data(), snap.degradationBytes}};
+        degradation_->restoreState(r);
+        SHULIB_PRECONDITION(r.used() == snap.degradationBytes,
+                            "SimHarness::restore: the degradation model does not match the snapshot's");
+    }
+
     // ── commanding (mirrors what C1's motion loop will do) ─────────────────────────
     /// BODY-frame twist → per-wheel voltages via toWheels + the configured
     /// feedforward. No desaturation and no field rotation here on purpose: those are
@@ -262,6 +419,7 @@ private:
     hal::NullSink ownNullSink_{};
     DegradationModel ownIdentityDegradation_{};
     hal::ITelemetrySink* sink_;
+    DegradationModel* degradation_;
 
     std::array<hal::fake::FakeMotor, static_cast<std::size_t>(kinematics::WheelSpeeds::kMaxWheels)>
         motorStorage_{};
@@ -272,6 +430,8 @@ private:
     std::array<TrackingWheelSpec, 2> trackingSpecs_;
     hal::fake::FakeRotation forwardEncoder_{};
     hal::fake::FakeRotation lateralEncoder_{};
+    std::array<hal::fake::FakeDistance, static_cast<std::size_t>(DrivePlant::kMaxDistanceSensors)>
+        distance_{};
 
     control::Feedforward ff_;
     DrivePlant plant_;
@@ -0,0 +1,1057 @@
+#pragma once
+//
+// sim::ScenarioSpec + parseScenario + runScenarioSweep — closed-loop scenarios as TEXT, so
+// iterating on one is an edit and a rerun of the shulib_sim runner (tools/shulib_sim.cpp)
+// rather than a test-suite rebuild.
+//
+// ── The format ──────────────────────────────────────────────────────────────────────
+// One directive per line; `#` starts a comment; tokens are whitespace-separated. Lengths
+// in inches, times in seconds, headings in DEGREES (the one unit a person types).
+//
+//     name      square-under-fire      # a label for the summary and the blackbox files
+//     drive     xdrive 7               # xdrive <radius> | tank <track> | hdrive <track> <offset>
+//     seeds     1 16                   # first [last], inclusive: one run per seed
+//     start     0 0 0                  # x y heading — truth AND the estimate start here
+//     dt        0.01                   # control tick (without jitter)
+//     hostility full                   # none (the default) | full — FullHostility
+//     set       gps.noiseSigmaIn 1.5   # any scalar FullHostilityConfig field (below)
+//     jitter    on                     # off (the default) | on — JitterSchedule dt
+//     set       jitter.spikeProb 0.05  # any JitterScheduleConfig field
+//     fusion    ekf                    # complementary (the default) | ekf — EkfFusion
+//     tags      ring                   # none (the default) | ring — the synthetic tag ring
+//
+//     moveTo    24 0 90 [timeout]      # Chassis::moveTo (x y heading)
+//     strafeTo  24 24 [timeout]        # Chassis::strafeTo (x y)
+//     turnTo    -90 [timeout]          # Chassis::turnTo (heading)
+//     hold      1.0                    # Chassis::hold (seconds)
+//     wait      0.5                    # Chassis::wait (seconds)
+//     brake     [timeout]              # Chassis::brake
+//
+// A missing timeout (or 0) is MotionConfig::defaultTimeout, exactly as in MotionOptions.
+// `set` names a field by its config path — power., slip., imu., gps., encoders. and
+// latency. — with the config's own units (Time fields in s, AngularVelocity in rad/s);
+// a bool takes true/false, an int an integral value. Setting a hostility field does not
+// switch hostility on. The event WINDOWS (slip windows, GPS no-fix / bad-fix windows) are
+// lists, not scalars, and stay C++-only for now. Parsing never throws: a bad line is
+// reported as the first error with its line number, and nothing runs.
+//
+// ── A run ───────────────────────────────────────────────────────────────────────────
+// For every seed: a fresh SimHarness seeded with it, behind FullHostility if asked (and a
+// JitterSchedule seeded with it if asked); PilonsOdometry + ComplementaryFusion (or
+// EkfFusion) + Localizer (MotionRig's stack); FaultLatch + HealthMonitor; and one Chassis,
+// whose verbs run in file order. The pacer steps the plant one tick per pace. Every verb
+// records its exit and, for moveTo/strafeTo/turnTo, the TRUE position and heading error
+// to its target at the exit. A non-Settled verb does not stop the run: the next verb
+// starts from wherever the robot ended up, as a routine would.
+//
+// `tags ring` puts scenarioTagRing()'s eight tags on the perimeter walls and an
+// AprilTagCorrector on the Localizer. Every kScenarioTagFramePeriod ticks a synthetic
+// camera sees the ring from TRUTH — range, field of view and the tag's facing, nothing
+// else: no noise, no latency (the corrector is told so), no occlusion — and the corrector
+// polls it. It is there so the tag pipeline's cost and plumbing run closed-loop, not to
+// model a camera; accuracy claims about tags stay with apriltag_corrector_*_test.cpp.
+//
+// With blackbox on, the run streams every tick into an SdSink (v1 ticks plus estimator
+// inputs, so sim/estimator_replay.hpp can replay it) over an in-memory FakeBlockSink,
+// flushed every tick; the bytes land in the result and the runner writes them out.
+//
+// ── The sweep ───────────────────────────────────────────────────────────────────────
+// runScenarioSweep() runs the seeds across std::threads, replayGrid's shape: one whole
+// world per job, nothing shared but the read-only spec, result i belongs to seed
+// first + i, and the first exception is rethrown after the join. A run is a pure
+// function of (spec, seed), so the table is identical for any thread count.
+// Without __STDCPP_THREADS__ the seeds run serially.
+//
+// Host-only: allocation, strings, threads and exceptions are fine; never on the V5.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#if defined(__STDCPP_THREADS__)
+#include <thread>
+#endif
+
+#include "shulib/chassis/chassis.hpp"
+#include "shulib/control/exit_group.hpp"
+#include "shulib/diag/build_info.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/fault.hpp"
+#include "shulib/diag/health_monitor.hpp"
+#include "shulib/diag/sd_sink.hpp"
+#include "shulib/diag/session_info.hpp"
+#include "shulib/hal/fake/fake_block_sink.hpp"
+#include "shulib/hal/null_sink.hpp"
+#include "shulib/kinematics/h_drive.hpp"
+#include "shulib/kinematics/kinematics.hpp"
+#include "shulib/kinematics/tank.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/diag/zone_profiler.hpp"
+#include "shulib/hal/vision.hpp"
+#include "shulib/localization/apriltag_corrector.hpp"
+#include "shulib/localization/complementary_fusion.hpp"
+#include "shulib/localization/ekf_fusion.hpp"
+#include "shulib/localization/localizer.hpp"
+#include "shulib/localization/pilons_odometry.hpp"
+#include "shulib/localization/tag_map.hpp"
+#include "shulib/math/angle.hpp"
+#include "shulib/math/pose2d.hpp"
+#include "shulib/motion/motion.hpp"
+#include "shulib/sim/hostile/composed.hpp"
+#include "shulib/sim/scenario.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::sim {
+
+/// Which drivetrain a scenario builds.
+enum class ScenarioDrive {
+    XDrive,  ///< xDrive(radius)
+    Tank,    ///< TankKinematics(track)
+    HDrive,  ///< hDrive({track, strafe-wheel offset})
+};
+
+/// The `drive` directive.
+struct ScenarioDriveSpec {
+    ScenarioDrive kind = ScenarioDrive::XDrive;  ///< the preset
+    double size = 7.0;          ///< xdrive: drive radius; tank/hdrive: track width (in)
+    double strafeOffset = 0.0;  ///< hdrive only: strafe wheel's signed forward offset (in)
+};
+
+/// Which fusion policy the Localizer folds corrections with (the `fusion` directive).
+enum class ScenarioFusion {
+    Complementary,  ///< localization::ComplementaryFusion (MotionRig's)
+    Ekf,            ///< localization::EkfFusion
+};
+
+/// A chassis verb from the file.
+enum class ScenarioVerbKind {
+    MoveTo,    ///< moveTo x y heading
+    StrafeTo,  ///< strafeTo x y
+    TurnTo,    ///< turnTo heading
+    Hold,      ///< hold seconds
+    Wait,      ///< wait seconds
+    Brake,     ///< brake
+};
+
+/// The file's spelling of `kind`.
+[[nodiscard]] constexpr const char* scenarioVerbName(ScenarioVerbKind kind) noexcept {
+    switch (kind) {
+        case ScenarioVerbKind::MoveTo: return "moveTo";
+        case ScenarioVerbKind::StrafeTo: return "strafeTo";
+        case ScenarioVerbKind::TurnTo: return "turnTo";
+        case ScenarioVerbKind::Hold: return "hold";
+        case ScenarioVerbKind::Wait: return "wait";
+        case ScenarioVerbKind::Brake: return "brake";
+    }
+    return "?";
+}
+
+/// One verb line.
+struct ScenarioVerb {
+    ScenarioVerbKind kind = ScenarioVerbKind::MoveTo;  ///< what to do
+    math::Pose2d target{};   ///< moveTo: all three; strafeTo: x, y; turnTo: heading
+    double seconds = 0.0;    ///< hold / wait duration (s)
+    double timeout = 0.0;    ///< watchdog (s); 0 → MotionConfig::defaultTimeout
+    int line = 0;            ///< where it came from, for the summary
+};
+
+/// A parsed scenario file (header: "The format"). Every field defaults to what a file
+/// that never mentions it means.
+struct ScenarioSpec {
+    std::string name = "scenario";        ///< label for the summary and blackbox files
+    ScenarioDriveSpec drive{};            ///< the drivetrain
+    std::uint64_t seedFirst = 1;          ///< first seed (inclusive)
+    std::uint64_t seedLast = 1;           ///< last seed (inclusive, ≥ seedFirst)
+    math::Pose2d start{};                 ///< truth and estimate start here
+    double dt = 0.01;                     ///< control tick without jitter (s)
+    bool hostile = false;                 ///< run behind FullHostility
+    FullHostilityConfig hostility{};      ///< its configuration
+    bool jitter = false;                  ///< pace with a JitterSchedule
+    JitterScheduleConfig jitterConfig{};  ///< its configuration
+    ScenarioFusion fusion = ScenarioFusion::Complementary;  ///< the fusion policy
+    bool tags = false;                    ///< the synthetic tag ring and its corrector
+    std::vector<ScenarioVerb> verbs{};    ///< the routine, in order
+};
+
+/// parseScenario()'s answer: the spec, or the first error and its line.
+struct ScenarioParseResult {
+    ScenarioSpec spec{};  ///< valid only when ok()
+    std::string error{};  ///< empty on success
+    int line = 0;         ///< 1-based line of the error (0: the file as a whole)
+    /// True when the whole text parsed.
+    [[nodiscard]] bool ok() const noexcept { return error.empty(); }
+};
+
+namespace detail {
+
+/// A numeric token: a number, inf / -inf, or true / false (1 / 0).
+[[nodiscard]] inline bool parseScenarioNumber(std::string_view tok, double& out) {
+    if (tok == "true") {
+        out = 1.0;
+        return true;
+    }
+    if (tok == "false") {
+        out = 0.0;
+        return true;
+    }
+    if (tok == "inf" || tok == "-inf") {
+        out = tok.front() == '-' ? -HUGE_VAL : HUGE_VAL;
+        return true;
+    }
+    const char* end = tok.data() + tok.size();
+    const auto [ptr, ec] = std::from_chars(tok.data(), end, out);
+    return ec == std::errc{} && ptr == end;
+}
+
+template <typename T>
+[[nodiscard]] bool toField(double v, T& out) {
+    if constexpr (std::is_same_v<T, bool>) {
+        if (v != 0.0 && v != 1.0) {
+            return false;
+        }
+        out = v != 0.0;
+    } else if constexpr (std::is_integral_v<T>) {
+        if (!(std::trunc(v) == v) || std::abs(v) > 1e9) {
+            return false;
+        }
+        out = static_cast<T>(v);
+    } else if constexpr (std::is_same_v<T, double>) {
+        out = v;
+    } else {
+        out = T{v};  // a units:: quantity, in its base unit
+    }
+    return true;
+}
+
+/// Assign `v` to (cfg.*Family).*Member with that member's own type.
+template <typename Config, auto Family, auto Member>
+[[nodiscard]] bool assignScenarioField(Config& cfg, double v) {
+    return toField(v, (cfg.*Family).*Member);
+}
+
+/// Assign `v` to cfg.*Member.
+template <typename Config, auto Member>
+[[nodiscard]] bool assignScenarioScalar(Config& cfg, double v) {
+    return toField(v, cfg.*Member);
+}
+
+/// One settable `set` path.
+template <typename Config>
+struct ScenarioField {
+    std::string_view path;
+    bool (*assign)(Config&, double);
+};
+
+using FH = FullHostilityConfig;
+
+inline constexpr ScenarioField<FH> kHostilityFields[] = {
+    {"power.sagPerCommandedVolt",
+     &assignScenarioField<FH, &FH::power, &PowerHostileConfig::sagPerCommandedVolt>},
+    {"power.dischargeRatePerS",
+     &assignScenarioField<FH, &FH::power, &PowerHostileConfig::dischargeRatePerS>},
+    {"power.cutoffVolts", &assignScenarioField<FH, &FH::power, &PowerHostileConfig::cutoffVolts>},
+    {"power.ambientC", &assignScenarioField<FH, &FH::power, &PowerHostileConfig::ambientC>},
+    {"power.heatRatePerV2", &assignScenarioField<FH, &FH::power, &PowerHostileConfig::heatRatePerV2>},
+    {"power.coolRatePerS", &assignScenarioField<FH, &FH::power, &PowerHostileConfig::coolRatePerS>},
+    {"power.throttleTempC", &assignScenarioField<FH, &FH::power, &PowerHostileConfig::throttleTempC>},
+    {"power.fallbackNominal",
+     &assignScenarioField<FH, &FH::power, &PowerHostileConfig::fallbackNominal>},
+    {"slip.accelThresholdInPerS2",
+     &assignScenarioField<FH, &FH::slip, &SlipHostileConfig::accelThresholdInPerS2>},
+    {"slip.slipRetain", &assignScenarioField<FH, &FH::slip, &SlipHostileConfig::slipRetain>},
+    {"imu.calibrationEnd", &assignScenarioField<FH, &FH::imu, &ImuHostileConfig::calibrationEnd>},
+    {"imu.rateBiasMax", &assignScenarioField<FH, &FH::imu, &ImuHostileConfig::rateBiasMax>},
+    {"imu.headingNoiseSigmaRad",
+     &assignScenarioField<FH, &FH::imu, &ImuHostileConfig::headingNoiseSigmaRad>},
+    {"imu.yawRateNoiseSigmaRadPerS",
+     &assignScenarioField<FH, &FH::imu, &ImuHostileConfig::yawRateNoiseSigmaRadPerS>},
+    {"imu.dropoutAt", &assignScenarioField<FH, &FH::imu, &ImuHostileConfig::dropoutAt>},
+    {"imu.calibrationGarbageRate",
+     &assignScenarioField<FH, &FH::imu, &ImuHostileConfig::calibrationGarbageRate>},
+    {"gps.noiseSigmaIn", &assignScenarioField<FH, &FH::gps, &GpsHostileConfig::noiseSigmaIn>},
+    {"gps.headingNoiseSigmaRad",
+     &assignScenarioField<FH, &FH::gps, &GpsHostileConfig::headingNoiseSigmaRad>},
+    {"gps.updatePeriod", &assignScenarioField<FH, &FH::gps, &GpsHostileConfig::updatePeriod>},
+    {"gps.reportedRms", &assignScenarioField<FH, &FH::gps, &GpsHostileConfig::reportedRms>},
+    {"gps.noFixRms", &assignScenarioField<FH, &FH::gps, &GpsHostileConfig::noFixRms>},
+    {"gps.offStrip", &assignScenarioField<FH, &FH::gps, &GpsHostileConfig::offStrip>},
+    {"gps.dropoutAt", &assignScenarioField<FH, &FH::gps, &GpsHostileConfig::dropoutAt>},
+    {"encoders.driveTicksPerRev",
+     &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::driveTicksPerRev>},
+    {"encoders.trackingTicksPerRev",
+     &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::trackingTicksPerRev>},
+    {"encoders.driveFreezeAt",
+     &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::driveFreezeAt>},
+    {"encoders.driveFreezeWheel",
+     &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::driveFreezeWheel>},
+    {"encoders.trackingFreezeAt",
+     &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::trackingFreezeAt>},
+    {"encoders.trackingFreezeIndex",
+     &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::trackingFreezeIndex>},
+    {"encoders.sentinelOnTracking",
+     &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::sentinelOnTracking>},
+    {"encoders.sentinelIndex",
+     &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::sentinelIndex>},
+    {"encoders.sentinelAt", &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::sentinelAt>},
+    {"encoders.sentinelFor",
+     &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::sentinelFor>},
+    {"encoders.sentinelValue",
+     &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::sentinelValue>},
+    {"encoders.bumpAt", &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::bumpAt>},
+    {"encoders.bumpIndex", &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::bumpIndex>},
+    {"encoders.bumpShaftRad",
+     &assignScenarioField<FH, &FH::encoders, &EncoderHostileConfig::bumpShaftRad>},
+    {"latency.imuLatency", &assignScenarioField<FH, &FH::latency, &LatencyHostileConfig::imuLatency>},
+    {"latency.gpsLatency", &assignScenarioField<FH, &FH::latency, &LatencyHostileConfig::gpsLatency>},
+    {"latency.driveEncoderLatency",
+     &assignScenarioField<FH, &FH::latency, &LatencyHostileConfig::driveEncoderLatency>},
+    {"latency.trackingEncoderLatency",
+     &assignScenarioField<FH, &FH::latency, &LatencyHostileConfig::trackingEncoderLatency>},
+};
+
+using JS = JitterScheduleConfig;
+
+inline constexpr ScenarioField<JS> kJitterFields[] = {
+    {"jitter.nominal", &assignScenarioScalar<JS, &JS::nominal>},
+    {"jitter.jitterFrac", &assignScenarioScalar<JS, &JS::jitterFrac>},
+    {"jitter.spikeProb", &assignScenarioScalar<JS, &JS::spikeProb>},
+    {"jitter.spikeFactor", &assignScenarioScalar<JS, &JS::spikeFactor>},
+};
+
+/// Split one line into tokens, dropping a `#` comment.
+[[nodiscard]] inline std::vector<std::string_view> scenarioTokens(std::string_view line) {
+    if (const std::size_t hash = line.find('#'); hash != std::string_view::npos) {
+        line = line.substr(0, hash);
+    }
+    std::vector<std::string_view> out;
+    std::size_t i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) {
+            ++i;
+        }
+        const std::size_t begin = i;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') {
+            ++i;
+        }
+        if (i > begin) {
+            out.push_back(line.substr(begin, i - begin));
+        }
+    }
+    return out;
+}
+
+}  // namespace detail
+
+/// Apply one line of the format (header) to `s`: a setting overwrites its field, a verb is
+/// appended with `lineNo`, a blank or comment line does nothing. False with `error` set —
+/// and `s` untouched — for a bad line. `sawSeeds` is raised by a `seeds` line. The unit
+/// parseScenario() loops over, and what the sim server (sim_server.hpp) reads one command
+/// line at a time.
+[[nodiscard]] inline bool applyScenarioLine(ScenarioSpec& s, std::string_view line, int lineNo,
+                                            bool& sawSeeds, std::string& error) {
+    const std::vector<std::string_view> tok = detail::scenarioTokens(line);
+    if (tok.empty()) {
+        return true;
+    }
+    const std::string_view key = tok.front();
+    const std::size_t argc = tok.size() - 1;
+    std::vector<double> num(argc, 0.0);
+    bool numeric = true;
+    for (std::size_t i = 0; i < argc; ++i) {
+        numeric = numeric && detail::parseScenarioNumber(tok[i + 1], num[i]);
+    }
+    const auto fail = [&](std::string message) {
+        error = std::string{key} + ": " + std::move(message);
+        return false;
+    };
+    const auto counted = [&](std::size_t lo, std::size_t hi) {
+        return argc >= lo && argc <= hi && numeric;
+    };
+    if (key == "name") {
+        if (argc != 1) {
+            return fail("expects one word");
+        }
+        s.name = std::string{tok[1]};
+    } else if (key == "drive") {
+        if (argc == 0) {
+            return fail("expects xdrive <radius> | tank <track> | hdrive <track> <offset>");
+        }
+        const std::string_view kind = tok[1];
+        double a = 0.0;
+        double b = 0.0;
+        const bool aOk = argc >= 2 && detail::parseScenarioNumber(tok[2], a) && a > 0.0
+                      && std::isfinite(a);
+        if ((kind == "xdrive" || kind == "tank") && argc == 2 && aOk) {
+            s.drive = {kind == "xdrive" ? ScenarioDrive::XDrive : ScenarioDrive::Tank, a, 0.0};
+        } else if (kind == "hdrive" && argc == 3 && aOk && detail::parseScenarioNumber(tok[3], b)
+                   && std::isfinite(b)) {
+            s.drive = {ScenarioDrive::HDrive, a, b};
+        } else {
+            return fail("expects xdrive <radius> | tank <track> | hdrive <track> <offset>");
+        }
+    } else if (key == "seeds") {
+        if (!counted(1, 2) || num[0] < 0.0 || std::trunc(num[0]) != num[0]
+            || num.back() < num[0] || std::trunc(num.back()) != num.back()) {
+            return fail("expects <first> [<last>], integers with first <= last");
+        }
+        s.seedFirst = static_cast<std::uint64_t>(num[0]);
+        s.seedLast = static_cast<std::uint64_t>(num.back());
+        sawSeeds = true;
+    } else if (key == "start") {
+        if (!counted(3, 3)) {
+            return fail("expects <x> <y> <headingDeg>");
+        }
+        s.start = math::Pose2d{units::Length{num[0]}, units::Length{num[1]},
+                               math::Angle::degrees(num[2])};
+    } else if (key == "dt") {
+        if (!counted(1, 1) || !(num[0] > 0.0) || !std::isfinite(num[0])) {
+            return fail("expects one positive time (s)");
+        }
+        s.dt = num[0];
+    } else if (key == "hostility" || key == "jitter") {
+        if (argc != 1 || (tok[1] != "none" && tok[1] != "full" && tok[1] != "on"
+                          && tok[1] != "off")) {
+            return fail(key == "hostility" ? "expects none | full" : "expects on | off");
+        }
+        const bool on = tok[1] == "full" || tok[1] == "on";
+        (key == "hostility" ? s.hostile : s.jitter) = on;
+    } else if (key == "fusion") {
+        if (argc != 1 || (tok[1] != "complementary" && tok[1] != "ekf")) {
+            return fail("expects complementary | ekf");
+        }
+        s.fusion = tok[1] == "ekf" ? ScenarioFusion::Ekf : ScenarioFusion::Complementary;
+    } else if (key == "tags") {
+        if (argc != 1 || (tok[1] != "none" && tok[1] != "ring")) {
+            return fail("expects none | ring");
+        }
+        s.tags = tok[1] == "ring";
+    } else if (key == "set") {
+        double v = 0.0;
+        if (argc != 2 || !detail::parseScenarioNumber(tok[2], v)) {
+            return fail("expects <field> <value>");
+        }
+        bool found = false;
+        bool assigned = false;
+        for (const auto& f : detail::kHostilityFields) {
+            if (f.path == tok[1]) {
+                found = true;
+                assigned = f.assign(s.hostility, v);
+            }
+        }
+        for (const auto& f : detail::kJitterFields) {
+            if (f.path == tok[1]) {
+                found = true;
+                assigned = f.assign(s.jitterConfig, v);
+            }
+        }
+        if (!found) {
+            return fail("unknown field '" + std::string{tok[1]} + "'");
+        }
+        if (!assigned) {
+            return fail("'" + std::string{tok[2]} + "' is not a valid value for "
+                        + std::string{tok[1]});
+        }
+    } else if (key == "moveTo" || key == "strafeTo" || key == "turnTo") {
+        const std::size_t need = key == "moveTo" ? 3 : key == "strafeTo" ? 2 : 1;
+        if (!counted(need, need + 1) || (argc > need && !(num[need] >= 0.0))) {
+            return fail(key == "moveTo"     ? "expects <x> <y> <headingDeg> [timeout]"
+                        : key == "strafeTo" ? "expects <x> <y> [timeout]"
+                                            : "expects <headingDeg> [timeout]");
+        }
+        ScenarioVerb v;
+        v.line = lineNo;
+        v.timeout = argc > need ? num[need] : 0.0;
+        if (key == "turnTo") {
+            v.kind = ScenarioVerbKind::TurnTo;
+            v.target = math::Pose2d{units::Length{}, units::Length{},
+                                    math::Angle::degrees(num[0])};
+        } else {
+            v.kind = key == "moveTo" ? ScenarioVerbKind::MoveTo : ScenarioVerbKind::StrafeTo;
+            v.target = math::Pose2d{units::Length{num[0]}, units::Length{num[1]},
+                                    math::Angle::degrees(need == 3 ? num[2] : 0.0)};
+        }
+        s.verbs.push_back(v);
+    } else if (key == "hold" || key == "wait") {
+        if (!counted(1, 1) || !(num[0] > 0.0) || !std::isfinite(num[0])) {
+            return fail("expects one positive duration (s)");
+        }
+        ScenarioVerb v;
+        v.kind = key == "hold" ? ScenarioVerbKind::Hold : ScenarioVerbKind::Wait;
+        v.seconds = num[0];
+        v.line = lineNo;
+        s.verbs.push_back(v);
+    } else if (key == "brake") {
+        if (!counted(0, 1) || (argc == 1 && !(num[0] >= 0.0))) {
+            return fail("expects [timeout]");
+        }
+        ScenarioVerb v;
+        v.kind = ScenarioVerbKind::Brake;
+        v.timeout = argc == 1 ? num[0] : 0.0;
+        v.line = lineNo;
+        s.verbs.push_back(v);
+    } else {
+        return fail("unknown directive");
+    }
+    return true;
+}
+
+/// Parse a scenario file's text (header: "The format"). Never throws; the first bad line
+/// wins and is reported with its number.
+[[nodiscard]] inline ScenarioParseResult parseScenario(std::string_view text) {
+    ScenarioParseResult r;
+    ScenarioSpec& s = r.spec;
+    int lineNo = 0;
+    bool sawSeeds = false;
+    while (!text.empty()) {
+        ++lineNo;
+        const std::size_t nl = text.find('\n');
+        const std::string_view line = text.substr(0, nl);
+        text = nl == std::string_view::npos ? std::string_view{} : text.substr(nl + 1);
+        if (!applyScenarioLine(s, line, lineNo, sawSeeds, r.error)) {
+            r.line = lineNo;
+            return r;
+        }
+    }
+    if (s.verbs.empty()) {
+        r.error = "the scenario has no verbs";
+        r.line = 0;
+    } else if (!sawSeeds) {
+        s.seedFirst = s.seedLast = 1;
+    }
+    return r;
+}
+
+/// Read and parse the file at `path`. An unreadable file is a parse error at line 0.
+[[nodiscard]] inline ScenarioParseResult loadScenarioFile(const char* path) {
+    ScenarioParseResult r;
+    std::FILE* f = std::fopen(path, "rb");
+    if (f == nullptr) {
+        r.error = std::string{"cannot open "} + path;
+        return r;
+    }
+    std::string text;
+    char buf[4096];
+    for (std::size_t n = std::fread(buf, 1, sizeof buf, f); n > 0;
+         n = std::fread(buf, 1, sizeof buf, f)) {
+        text.append(buf, n);
+    }
+    std::fclose(f);
+    return parseScenario(text);
+}
+
+/// What one verb did.
+struct ScenarioVerbResult {
+    ScenarioVerbKind kind = ScenarioVerbKind::MoveTo;        ///< the verb
+    control::ExitReason exit = control::ExitReason::Running;  ///< its verdict (wait: Settled)
+    double positionError = -1.0;  ///< TRUE distance to the target at exit (in); -1: n/a
+    double headingError = -1.0;   ///< TRUE |heading error| at exit (deg); -1: n/a
+    double duration = 0.0;        ///< sim time the verb took (s)
+    int line = 0;                 ///< its line in the file
+};
+
+/// What one seed's run did.
+struct ScenarioRunResult {
+    std::uint64_t seed = 0;                     ///< the run's seed
+    std::vector<ScenarioVerbResult> verbs{};    ///< one per verb, in order
+    int settled = 0;                            ///< verbs that exited Settled
+    double simTime = 0.0;                       ///< sim clock at the end (s)
+    long ticks = 0;                             ///< plant steps taken
+    double estimateError = 0.0;   ///< |estimate − truth| position at the end (in)
+    int faults = 0;               ///< fault raises over the run (all codes)
+    diag::FaultCode firstFault = diag::FaultCode::None;  ///< the first code raised
+    std::vector<std::byte> blackbox{};  ///< the streamed file, when asked for
+    /// Every verb settled.
+    [[nodiscard]] bool succeeded() const noexcept {
+        return settled == static_cast<int>(verbs.size());
+    }
+};
+
+/// The kinematics `spec` names.
+[[nodiscard]] inline std::unique_ptr<kinematics::IKinematics> makeScenarioKinematics(
+    const ScenarioDriveSpec& spec) {
+    switch (spec.kind) {
+        case ScenarioDrive::Tank:
+            return std::make_unique<kinematics::TankKinematics>(units::Length{spec.size});
+        case ScenarioDrive::HDrive:
+            return std::make_unique<kinematics::MatrixKinematics>(
+                kinematics::hDrive({.trackWidth = units::Length{spec.size},
+                                    .strafeWheelOffset = units::Length{spec.strafeOffset}}));
+        case ScenarioDrive::XDrive: break;
+    }
+    return std::make_unique<kinematics::MatrixKinematics>(
+        kinematics::xDrive(units::Length{spec.size}));
+}
+
+/// `tags ring`: ticks between synthetic camera frames (≈33 Hz at the default 10 ms dt).
+inline constexpr long kScenarioTagFramePeriod = 3;
+/// `tags ring`: the synthetic camera's half field of view, about the robot's +X (deg).
+inline constexpr double kScenarioTagHalfFovDeg = 35.0;
+/// `tags ring`: tags in the ring, ids 1..kScenarioTagRingSize.
+inline constexpr int kScenarioTagRingSize = 8;
+
+/// The `tags ring` layout: two tags on each 72 in wall, at ±36 in along it, facing into
+/// the field. Invented — there is no published layout (tag_map.hpp) — and labeled so.
+[[nodiscard]] inline localization::TagMap scenarioTagRing() {
+    localization::TagMap map;
+    constexpr double kWall = 72.0;
+    constexpr double kAlong = 36.0;
+    const struct {
+        double x, y, facingDeg;
+    } ring[kScenarioTagRingSize] = {
+        {kWall, -kAlong, 180.0}, {kWall, kAlong, 180.0},  {kAlong, kWall, -90.0},
+        {-kAlong, kWall, -90.0}, {-kWall, kAlong, 0.0},   {-kWall, -kAlong, 0.0},
+        {-kAlong, -kWall, 90.0}, {kAlong, -kWall, 90.0},
+    };
+    for (int i = 0; i < kScenarioTagRingSize; ++i) {
+        const auto& t = ring[i];
+        map.add({.id = i + 1,
+                 .fieldPose = math::Pose2d{units::Length{t.x}, units::Length{t.y},
+                                           math::Angle::degrees(t.facingDeg)},
+                 .provenance = localization::TagProvenance::Invented,
+                 .source = "sim: the scenario tag ring, a benchmark layout"});
+    }
+    return map;
+}
+
+namespace detail {
+
+/// What the synthetic camera sees of `map`'s ring from `truth` (header: "A run"): every
+/// tag within the field of view, in front of the tag's face, and within the corrector's
+/// trusted range, at its exact robot-relative pose — TagMap::robotPoseFromTag's forward
+/// composition, inverted.
+inline void scenarioTagSightings(const localization::TagMap& map, const math::Pose2d& truth,
+                                 double maxRange, std::vector<hal::TagObservation>& out) {
+    out.clear();
+    const double rh = truth.heading().radians();
+    const double c = std::cos(rh);
+    const double s = std::sin(rh);
+    const double halfFov = kScenarioTagHalfFovDeg * math::Angle::kPi / 180.0;
+    for (int id = 1; id <= kScenarioTagRingSize; ++id) {
+        const localization::TagPlacement* p = map.find(id);
+        if (p == nullptr) {
+            continue;
+        }
+        const double dx = p->fieldPose.x().value() - truth.x().value();
+        const double dy = p->fieldPose.y().value() - truth.y().value();
+        const double rx = dx * c + dy * s;
+        const double ry = -dx * s + dy * c;
+        const double th = p->fieldPose.heading().radians();
+        const bool facing = -(dx * std::cos(th) + dy * std::sin(th)) > 0.0;
+        if (!facing || rx <= 0.0 || std::abs(std::atan2(ry, rx)) > halfFov
+            || std::hypot(rx, ry) > maxRange) {
+            continue;
+        }
+        out.push_back(hal::TagObservation{
+            .id = id,
+            .poseInRobot = math::Pose2d{units::Length{rx}, units::Length{ry},
+                                        math::Angle::radians(th - rh)},
+            .confidence = 0.9});
+    }
+}
+
+/// A sink that forwards every channel to `to` (nothing while it is null) — the slot a
+/// harness is built against before the sink that needs the harness's clock exists.
+struct ForwardingSink final : hal::ITelemetrySink {
+    void log(hal::LogLevel level, std::string_view sub, std::string_view msg) override {
+        if (to != nullptr) {
+            to->log(level, sub, msg);
+        }
+    }
+    void logDeferred(const diag::DeferredLog& line) override {
+        if (to != nullptr) {
+            to->logDeferred(line);
+        }
+    }
+    [[nodiscard]] bool wantsRecord() const noexcept override {
+        return to != nullptr && to->wantsRecord();
+    }
+    void emit(const diag::DebugRecord& record) override {
+        if (to != nullptr) {
+            to->emit(record);
+        }
+    }
+    void summarize(const diag::RunSummary& summary) override {
+        if (to != nullptr) {
+            to->summarize(summary);
+        }
+    }
+    hal::ITelemetrySink* to = nullptr;
+};
+
+/// Steps the plant one tick per pace — the fixed dt or the next JitterSchedule dt — then
+/// runs the sense hook (the world's synthetic camera) and the after-step hook, if any (the
+/// blackbox flush, the server's wall-clock pacing). With a profiler, the step and the
+/// sensing are zones "plant" and "sense".
+class ScenarioPacer final : public motion::ITickPacer {
+public:
+    ScenarioPacer(SimHarness& harness, const ScenarioSpec& spec, std::uint64_t seed)
+        : h_{harness}, dt_{spec.dt} {
+        if (spec.jitter) {
+            jitter_ = std::make_unique<JitterSchedule>(seed, spec.jitterConfig);
+        }
+    }
+
+    void pace() override {
+        const units::Time dt = jitter_ ? (*jitter_)(static_cast<int>(ticks_)) : units::Time{dt_};
+        {
+            SHULIB_ZONE(profiler, "plant");
+            h_.plant().step(dt);
+        }
+        ++ticks_;
+        if (sense) {
+            SHULIB_ZONE(profiler, "sense");
+            sense(ticks_);
+        }
+        if (afterStep) {
+            afterStep(dt);
+        }
+    }
+
+    /// Plant steps so far.
+    [[nodiscard]] long ticks() const noexcept { return ticks_; }
+
+    /// Called after every step with the step count, before afterStep; empty for none.
+    std::function<void(long)> sense;
+    /// Called after every step with its dt; empty for none.
+    std::function<void(units::Time)> afterStep;
+    /// Where the "plant" and "sense" zones go; nullptr for nowhere.
+    diag::ZoneProfiler* profiler = nullptr;
+
+private:
+    SimHarness& h_;
+    double dt_;
+    std::unique_ptr<JitterSchedule> jitter_;
+    long ticks_ = 0;
+};
+
+}  // namespace detail
+
+/// One seed's closed loop (header: "A run"): the harness behind FullHostility if asked,
+/// MotionRig's estimator stack, the fault latch and health monitor, and a Chassis paced
+/// one plant tick at a time. runScenario() runs a file's verbs through one; the sim server
+/// (sim_server.hpp) keeps one alive between commands. Telemetry goes through a
+/// forwarding slot, so a sink that needs the harness's clock can be attached after it.
+/// Neither copyable nor movable (the Chassis is pinned); hold it by unique_ptr.
+class ScenarioWorld {
+public:
+    /// Build the world `spec` describes with `seed`; truth and estimate start at spec.start.
+    /// With `profiler`, the scheduler's "loc"/"mot" zones (and the Localizer's below them)
+    /// and the pacer's "plant"/"sense" zones are charged to it; it must outlive the world
+    /// and run on a clock that advances during a tick (zone_profiler.hpp). With `field`,
+    /// the plant collides with it (DrivePlantConfig::field); it must outlive the world.
+    ScenarioWorld(const ScenarioSpec& spec, std::uint64_t seed,
+                  diag::ZoneProfiler* profiler = nullptr, const FieldGeometry* field = nullptr)
+        : kin_{makeScenarioKinematics(spec.drive)},
+          hostility_{spec.hostile ? std::make_unique<FullHostility>(spec.hostility) : nullptr},
+          harness_{*kin_, harnessConfig(spec, seed, field), &forward_,
+                   hostility_ ? &hostility_->model() : nullptr},
+          odom_{harness_.imu(), harness_.makeForwardTrackingWheel(),
+                harness_.makeLateralTrackingWheel()},
+          fusion_{makeFusion(spec.fusion)},
+          tagMap_{spec.tags ? scenarioTagRing() : localization::TagMap{}},
+          tagCorrector_{spec.tags ? std::make_unique<localization::AprilTagCorrector>(
+                                        harness_.clock(), harness_.tags(), harness_.imu(),
+                                        tagMap_, tagConfig())
+                                  : nullptr},
+          correctors_{tagCorrector_.get()},
+          loc_{harness_.clock(), harness_.imu(), odom_, *fusion_,
+               std::span<localization::ICorrector* const>{correctors_}.first(spec.tags ? 1U
+                                                                                       : 0U)},
+          latch_{faultSink_, harness_.clock()},
+          health_{latch_},
+          deps_{.ctx = &harness_.context(),
+                .localizer = &loc_,
+                .kinematics = kin_.get(),
+                .faults = &latch_,
+                .health = &health_},
+          pacer_{harness_, spec, seed},
+          chassis_{deps_, pacer_, chassisConfig(profiler)} {
+        loc_.setPose(spec.start);
+        loc_.setProfiler(profiler);
+        pacer_.profiler = profiler;
+        if (tagCorrector_) {
+            pacer_.sense = [this](long tick) { senseTags(tick); };
+            senseTags(0);
+        }
+    }
+
+    ScenarioWorld(const ScenarioWorld&) = delete;
+    ScenarioWorld& operator=(const ScenarioWorld&) = delete;
+
+    /// Send the world's telemetry — the plant's and the controller's records, the
+    /// chassis's log lines — to `sink` (nullptr: nowhere). `sink` must outlive the world
+    /// or be detached first.
+    void setSink(hal::ITelemetrySink* sink) noexcept { forward_.to = sink; }
+
+    /// Run `hook` after every plant step (empty: nothing).
+    void setAfterStep(std::function<void(units::Time)> hook) { pacer_.afterStep = std::move(hook); }
+
+    /// Run one verb to its exit and score it against TRUTH (header: "A run").
+    [[nodiscard]] ScenarioVerbResult run(const ScenarioVerb& v) {
+        const chassis::MotionOptions opts{.timeout = units::Time{v.timeout}};
+        const double t0 = harness_.clock().now().value();
+        ScenarioVerbResult vr;
+        vr.kind = v.kind;
+        vr.line = v.line;
+        switch (v.kind) {
+            case ScenarioVerbKind::MoveTo: vr.exit = chassis_.moveTo(v.target, opts); break;
+            case ScenarioVerbKind::StrafeTo:
+                vr.exit = chassis_.strafeTo(v.target.x(), v.target.y(), opts);
+                break;
+            case ScenarioVerbKind::TurnTo: vr.exit = chassis_.turnTo(v.target.heading(), opts); break;
+            case ScenarioVerbKind::Hold: vr.exit = chassis_.hold(units::Time{v.seconds}, opts); break;
+            case ScenarioVerbKind::Wait:
+                chassis_.wait(units::Time{v.seconds});
+                vr.exit = control::ExitReason::Settled;  // a wait has no failure mode
+                break;
+            case ScenarioVerbKind::Brake: vr.exit = chassis_.brake(opts); break;
+        }
+        const math::Pose2d truth = harness_.truePose();
+        if (v.kind == ScenarioVerbKind::MoveTo || v.kind == ScenarioVerbKind::StrafeTo) {
+            vr.positionError = std::hypot(truth.x().value() - v.target.x().value(),
+                                          truth.y().value() - v.target.y().value());
+        }
+        if (v.kind == ScenarioVerbKind::MoveTo || v.kind == ScenarioVerbKind::TurnTo) {
+            vr.headingError =
+                std::abs(truth.heading().errorTo(v.target.heading())) * 180.0 / math::Angle::kPi;
+        }
+        vr.duration = harness_.clock().now().value() - t0;
+        return vr;
+    }
+
+    /// One plant tick with the motors as they are — no controller runs.
+    void step() { pacer_.pace(); }
+
+    /// Move truth AND estimate to `pose` (DrivePlant::setTruePose, then Localizer::setPose).
+    void teleport(const math::Pose2d& pose) {
+        harness_.plant().setTruePose(pose);
+        loc_.setPose(pose);
+    }
+
+    /// The harness: truth, the clock, the fakes.
+    [[nodiscard]] SimHarness& harness() noexcept { return harness_; }
+    /// The chassis the verbs run on — for a caller that drives it directly (a Routine).
+    [[nodiscard]] chassis::Chassis& chassis() noexcept { return chassis_; }
+    /// The estimator the chassis steers by.
+    [[nodiscard]] localization::Localizer& localizer() noexcept { return loc_; }
+    /// The fault latch the health monitor feeds.
+    [[nodiscard]] diag::FaultLatch& faults() noexcept { return latch_; }
+    /// Plant steps so far.
+    [[nodiscard]] long ticks() const noexcept { return pacer_.ticks(); }
+
+private:
+    [[nodiscard]] static SimHarnessConfig harnessConfig(const ScenarioSpec& spec,
+                                                        std::uint64_t seed,
+                                                        const FieldGeometry* field) {
+        SimHarnessConfig cfg;
+        cfg.plant.seed = seed;
+        cfg.plant.initialPose = spec.start;
+        cfg.plant.field = field;
+        return cfg;
+    }
+
+    [[nodiscard]] static std::unique_ptr<localization::IFusionPolicy> makeFusion(
+        ScenarioFusion fusion) {
+        if (fusion == ScenarioFusion::Ekf) {
+            return std::make_unique<localization::EkfFusion>();
+        }
+        return std::make_unique<localization::ComplementaryFusion>();
+    }
+
+    /// The synthetic camera has no latency, and the corrector is told so.
+    [[nodiscard]] static localization::AprilTagCorrectorConfig tagConfig() {
+        localization::AprilTagCorrectorConfig cfg;
+        cfg.latency = units::Time{0.0};
+        return cfg;
+    }
+
+    [[nodiscard]] static chassis::ChassisConfig chassisConfig(diag::ZoneProfiler* profiler) {
+        chassis::ChassisConfig cfg;
+        cfg.scheduler.profiler = profiler;
+        return cfg;
+    }
+
+    /// One synthetic camera frame every kScenarioTagFramePeriod ticks (header: "A run").
+    void senseTags(long tick) {
+        if (tick % kScenarioTagFramePeriod != 0) {
+            return;
+        }
+        detail::scenarioTagSightings(tagMap_, harness_.truePose(),
+                                     tagConfig().maxRange.value(), sightings_);
+        harness_.tags().setTags(sightings_);
+        tagCorrector_->poll();
+    }
+
+    std::unique_ptr<kinematics::IKinematics> kin_;
+    std::unique_ptr<FullHostility> hostility_;
+    detail::ForwardingSink forward_;
+    SimHarness harness_;
+    localization::PilonsOdometry odom_;
+    std::unique_ptr<localization::IFusionPolicy> fusion_;
+    localization::TagMap tagMap_;
+    std::unique_ptr<localization::AprilTagCorrector> tagCorrector_;
+    std::array<localization::ICorrector*, 1> correctors_;
+    std::vector<hal::TagObservation> sightings_;
+    localization::Localizer loc_;
+    hal::NullSink faultSink_;
+    diag::FaultLatch latch_;
+    diag::HealthMonitor health_;
+    motion::MotionDeps deps_;
+    detail::ScenarioPacer pacer_;
+    chassis::Chassis chassis_;
+};
+
+/// Run `spec` once with `seed` (header: "A run"). A pure function of its arguments.
+[[nodiscard]] inline ScenarioRunResult runScenario(const ScenarioSpec& spec, std::uint64_t seed,
+                                                   bool blackbox = false) {
+    hal::fake::FakeBlockSink card;
+    std::vector<diag::DebugRecord> ring(blackbox ? 1U : 0U);
+    std::vector<std::byte> buffer(blackbox ? 64U * 1024U : 0U);
+    std::unique_ptr<diag::SdSink> sd;
+
+    ScenarioWorld world{spec, seed};
+    SimHarness& h = world.harness();
+    if (blackbox) {
+        diag::SdSinkConfig sdCfg;
+        sdCfg.streamTicks = true;
+        sdCfg.recordEstimatorInputs = true;
+        sd = std::make_unique<diag::SdSink>(card, h.clock(), diag::SdSinkStorage{ring, buffer},
+                                            sdCfg);
+        sd->open(diag::SessionInfo{.buildHash = diag::compiledBuildHash(),
+                                   .routineId = spec.name,
+                                   .alliance = "sim",
+                                   .side = "",
+                                   .portMap = ""});
+        world.setSink(sd.get());
+        world.setAfterStep([&sd](units::Time) { (void)sd->flush(); });
+    }
+
+    ScenarioRunResult out;
+    out.seed = seed;
+    for (const ScenarioVerb& v : spec.verbs) {
+        const ScenarioVerbResult vr = world.run(v);
+        out.settled += vr.exit == control::ExitReason::Settled ? 1 : 0;
+        out.verbs.push_back(vr);
+    }
+
+    const math::Pose2d truth = h.truePose();
+    const math::Pose2d est = world.localizer().pose();
+    out.estimateError = std::hypot(est.x().value() - truth.x().value(),
+                                   est.y().value() - truth.y().value());
+    out.simTime = h.clock().now().value();
+    out.ticks = world.ticks();
+    out.faults = world.faults().faultCount();
+    out.firstFault = world.faults().hasFault() ? world.faults().firstFault() : diag::FaultCode::None;
+    if (sd) {
+        sd->close();
+        world.setSink(nullptr);
+        out.blackbox = card.bytes();
+    }
+    return out;
+}
+
+/// How runScenarioSweep() runs.
+struct ScenarioSweepOptions {
+    unsigned threads = 0;   ///< 0 → hardware_concurrency(); 1 → serial
+    bool blackbox = false;  ///< stream each run into ScenarioRunResult::blackbox
+};
+
+/// Run every seed of `spec` (header: "The sweep"). Result i is seed seedFirst + i; the
+/// same for any thread count.
+[[nodiscard]] inline std::vector<ScenarioRunResult> runScenarioSweep(
+    const ScenarioSpec& spec, const ScenarioSweepOptions& options = {}) {
+    SHULIB_PRECONDITION(spec.seedLast >= spec.seedFirst,
+                        "runScenarioSweep: seedLast must be >= seedFirst");
+    const std::size_t n = static_cast<std::size_t>(spec.seedLast - spec.seedFirst) + 1U;
+    std::vector<ScenarioRunResult> results(n);
+    std::vector<std::exception_ptr> errors(n);
+    std::atomic<std::size_t> next{0};
+    const auto worker = [&]() {
+        for (std::size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+            try {
+                results[i] = runScenario(spec, spec.seedFirst + i, options.blackbox);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+#if defined(__STDCPP_THREADS__)
+    unsigned threads = options.threads;
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, n));
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    for (std::thread& t : pool) {
+        t.join();
+    }
+#else
+    worker();
+#endif
+    for (const std::exception_ptr& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+    return results;
+}
+
+/// The summary table: one row per seed (verbs settled, the first failing verb's line,
+/// worst true position and heading error, final estimate error, faults and the first
+/// one's code, sim time), then a totals line.
+[[nodiscard]] inline std::string formatScenarioSummary(const ScenarioSpec& spec,
+                                                       const std::vector<ScenarioRunResult>& runs) {
+    char line[200];
+    std::string out;
+    std::snprintf(line, sizeof line, "scenario %s: %zu verb(s), %s, %s%s%s\n", spec.name.c_str(),
+                  spec.verbs.size(), spec.hostile ? "FullHostility" : "no hostility",
+                  spec.jitter ? "jittered dt" : "fixed dt",
+                  spec.fusion == ScenarioFusion::Ekf ? ", EKF" : "", spec.tags ? ", tag ring" : "");
+    out += line;
+    out += "    seed  settled  first-fail  worst-pos(in)  worst-hdg(deg)  est-err(in)  faults  first-fault     sim(s)\n";
+    int passed = 0;
+    for (const ScenarioRunResult& r : runs) {
+        double worstPos = 0.0;
+        double worstHdg = 0.0;
+        int firstFail = 0;
+        for (const ScenarioVerbResult& v : r.verbs) {
+            worstPos = std::max(worstPos, v.positionError);
+            worstHdg = std::max(worstHdg, v.headingError);
+            if (firstFail == 0 && v.exit != control::ExitReason::Settled) {
+                firstFail = v.line;
+            }
+        }
+        char fail[16] = "-";
+        if (firstFail != 0) {
+            std::snprintf(fail, sizeof fail, "line %d", firstFail);
+        }
+        std::snprintf(line, sizeof line,
+                      "%8llu  %3d/%-3zu  %10s  %13.3f  %14.3f  %11.3f  %6d  %-14s %6.2f\n",
+                      static_cast<unsigned long long>(r.seed), r.settled, r.verbs.size(), fail,
+                      worstPos, worstHdg, r.estimateError, r.faults,
+                      r.faults > 0 ? diag::faultCodeName(r.firstFault) : "-", r.simTime);
+        out += line;
+        passed += r.succeeded() ? 1 : 0;
+    }
+    std::snprintf(line, sizeof line, "%d of %zu run(s) settled every verb\n", passed, runs.size());
+    out += line;
+    return out;
+}
+
+}  // namespace shulib::sim
@@ -0,0 +1,327 @@
+#pragma once
+//
+// sim::runSimBench — how fast the full closed loop runs on the host: plant, fakes,
+// Localizer (and EKF, and the tag corrector), scheduler and motion, one ScenarioWorld tick
+// at a time. The suite's wall time grows with every sweep and nobody could say what one
+// tick costs, or which part of it; tools/shulib_simbench.cpp prints that, and fails when it
+// regresses against a stored baseline.
+//
+// ── The cases ───────────────────────────────────────────────────────────────────────
+// simBenchCases() is three canonical scenarios over one route (a 24 in square, a turn
+// and a hold), in the scenario-file grammar so any of them can also be run, or varied,
+// with shulib_sim:
+//     clean      no hostility, ComplementaryFusion
+//     hostile    FullHostility, ComplementaryFusion
+//     ekf-tags   FullHostility, EkfFusion, the synthetic tag ring (scenario_file.hpp)
+// A case runs each of its seeds in turn, serially, on the calling thread.
+//
+// ── What is measured ────────────────────────────────────────────────────────────────
+//   * ticks/s — plant ticks over the wall time of the verbs alone, the FASTEST of
+//     `repeats` passes (a run is deterministic, so every pass does identical work and
+//     only host noise differs). World construction is outside the window: it is per-run
+//     setup, not per-tick cost.
+//   * allocations/tick — when SimBenchOptions::allocations is given (the process's
+//     operator new counter; a header cannot replace it), over the same window. Unlike
+//     time it is exact and host-independent.
+//   * the breakdown — a SECOND, profiled pass with a ZoneProfiler on a steady clock: the
+//     scheduler's "loc" (with the Localizer's "odom"/"correct"/"fuse" below it) and "mot",
+//     and the pacer's "plant" and "sense" (the synthetic camera). Zone reads cost two clock
+//     calls each, so the breakdown never shares a pass with the ticks/s it would inflate.
+//     Empty unless the build defines SHULIB_ENABLE_ZONES (zone_profiler.hpp).
+//
+// ── The baseline ────────────────────────────────────────────────────────────────────
+// A text file, one line per case — `<name> <ticks/s> <allocations/tick>`, `#` comments.
+// checkSimBench() reports a case whose ticks/s fell more than the given percentage below
+// its baseline, whose allocations/tick rose at all (beyond rounding; they are exact), or
+// that the baseline does not know. Throughput is a property of the HOST: a baseline is only
+// meaningful on the machine that wrote it, which is why this is a tool and its check a
+// build target rather than a ctest — a suite that fails on a slower laptop is a suite
+// people learn to ignore. The allocation pin, being exact, does live in the suite.
+//
+// Host-only, like everything in sim/.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shulib/diag/zone_profiler.hpp"
+#include "shulib/hal/clock.hpp"
+#include "shulib/sim/scenario_file.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::sim {
+
+/// The per-tick allocation growth checkSimBench() forgives: the baseline file's rounding.
+inline constexpr double kSimBenchAllocationSlack = 0.005;
+
+/// Zone rows one breakdown keeps (diag::kMaxZones, the profiler's own table size).
+inline constexpr std::size_t kSimBenchMaxZones = diag::kMaxZones;
+
+/// The host's monotonic clock as an IClock: the breakdown's profiler needs time that moves
+/// DURING a tick, which the sim's FakeClock never does.
+class SteadyClock final : public hal::IClock {
+public:
+    /// Seconds since this clock was constructed.
+    [[nodiscard]] units::Time now() const override {
+        return units::Time{std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch_)
+                               .count()};
+    }
+
+private:
+    std::chrono::steady_clock::time_point epoch_ = std::chrono::steady_clock::now();
+};
+
+/// How runSimBench() measures.
+struct SimBenchOptions {
+    /// Reads the process's allocation counter (operator new calls so far); nullptr: not
+    /// counted, and allocationsPerTick() is -1.
+    std::uint64_t (*allocations)() = nullptr;
+    /// Timed passes; ticks/s is the fastest (header: "What is measured"). At least 1.
+    int repeats = 3;
+    /// Run the profiled second pass (header: "What is measured").
+    bool breakdown = true;
+};
+
+/// One case's measurements.
+struct SimBenchResult {
+    std::string name;            ///< the case (the spec's name)
+    long ticks = 0;              ///< plant ticks in one timed pass, every seed
+    double wallSeconds = 0.0;    ///< the fastest timed pass's wall time (s)
+    std::int64_t allocations = -1;  ///< operator new calls in one pass; -1: not counted
+    /// The profiled pass's zones, depth-first (ZoneProfiler::snapshot order).
+    std::vector<diag::ZoneTimingRow> zones{};
+    double profiledSeconds = 0.0;  ///< the profiled pass's wall time, the zones' denominator
+    long profiledTicks = 0;        ///< its ticks (equal to `ticks`: a run is deterministic)
+
+    /// Plant ticks per wall second.
+    [[nodiscard]] double ticksPerSecond() const noexcept {
+        return wallSeconds > 0.0 ? static_cast<double>(ticks) / wallSeconds : 0.0;
+    }
+    /// Allocations per plant tick; -1 when not counted.
+    [[nodiscard]] double allocationsPerTick() const noexcept {
+        return allocations < 0 || ticks == 0
+                   ? -1.0
+                   : static_cast<double>(allocations) / static_cast<double>(ticks);
+    }
+};
+
+namespace detail {
+
+inline constexpr std::string_view kSimBenchRoute = R"(
+moveTo    24 0 0
+moveTo    24 24 90
+moveTo    0 24 180
+moveTo    0 0 -90
+turnTo    90
+hold      0.5
+)";
+
+}  // namespace detail
+
+/// The three canonical cases (header: "The cases"), each over `seeds` seeds (1..seeds).
+[[nodiscard]] inline std::vector<ScenarioSpec> simBenchCases(int seeds = 10) {
+    SHULIB_PRECONDITION(seeds >= 1, "simBenchCases: seeds must be >= 1");
+    const std::string seedLine = "seeds 1 " + std::to_string(seeds) + "\n";
+    const char* const heads[] = {
+        "name clean\n",
+        "name hostile\nhostility full\n",
+        "name ekf-tags\nhostility full\nfusion ekf\ntags ring\n",
+    };
+    std::vector<ScenarioSpec> out;
+    for (const char* head : heads) {
+        const ScenarioParseResult r =
+            parseScenario(std::string{head} + seedLine + std::string{detail::kSimBenchRoute});
+        SHULIB_PRECONDITION(r.ok(), "simBenchCases: a canonical case failed to parse");
+        out.push_back(r.spec);
+    }
+    return out;
+}
+
+/// Measure `spec` over its seeds (header: "What is measured").
+[[nodiscard]] inline SimBenchResult runSimBench(const ScenarioSpec& spec,
+                                                const SimBenchOptions& options = {}) {
+    SHULIB_PRECONDITION(spec.seedLast >= spec.seedFirst,
+                        "runSimBench: seedLast must be >= seedFirst");
+    SHULIB_PRECONDITION(options.repeats >= 1, "runSimBench: repeats must be >= 1");
+    SimBenchResult r;
+    r.name = spec.name;
+    using Steady = std::chrono::steady_clock;
+    for (int pass = 0; pass < options.repeats; ++pass) {
+        double wall = 0.0;
+        long ticks = 0;
+        std::int64_t allocations = 0;
+        for (std::uint64_t seed = spec.seedFirst; seed <= spec.seedLast; ++seed) {
+            ScenarioWorld world{spec, seed};
+            const std::uint64_t a0 = options.allocations != nullptr ? options.allocations() : 0U;
+            const Steady::time_point t0 = Steady::now();
+            for (const ScenarioVerb& v : spec.verbs) {
+                (void)world.run(v);
+            }
+            wall += std::chrono::duration<double>(Steady::now() - t0).count();
+            if (options.allocations != nullptr) {
+                allocations += static_cast<std::int64_t>(options.allocations() - a0);
+            }
+            ticks += world.ticks();
+        }
+        if (pass == 0 || wall < r.wallSeconds) {
+            r.wallSeconds = wall;
+        }
+        r.ticks = ticks;
+        r.allocations = options.allocations != nullptr ? allocations : -1;
+    }
+    if (options.breakdown) {
+        SteadyClock clock;
+        diag::ZoneProfiler profiler{clock};
+        for (std::uint64_t seed = spec.seedFirst; seed <= spec.seedLast; ++seed) {
+            ScenarioWorld world{spec, seed, &profiler};
+            const Steady::time_point t0 = Steady::now();
+            for (const ScenarioVerb& v : spec.verbs) {
+                (void)world.run(v);
+            }
+            r.profiledSeconds += std::chrono::duration<double>(Steady::now() - t0).count();
+            r.profiledTicks += world.ticks();
+        }
+        r.zones.resize(kSimBenchMaxZones);
+        r.zones.resize(profiler.snapshot(r.zones));
+    }
+    return r;
+}
+
+/// The report: one line per case, then each case's breakdown as µs per tick and share of
+/// the profiled pass ("other" is what no zone covers: the chassis's loop, the fakes'
+/// reads outside a zone, the profiler itself).
+[[nodiscard]] inline std::string formatSimBench(const std::vector<SimBenchResult>& results) {
+    char line[200];
+    std::string out = "case          ticks     ticks/s   us/tick  allocs/tick\n";
+    for (const SimBenchResult& r : results) {
+        const double perTick =
+            r.ticks > 0 ? r.wallSeconds * 1e6 / static_cast<double>(r.ticks) : 0.0;
+        std::snprintf(line, sizeof line, "%-10s %8ld %11.0f %9.2f  %11.3f\n", r.name.c_str(),
+                      r.ticks, r.ticksPerSecond(), perTick, r.allocationsPerTick());
+        out += line;
+    }
+    for (const SimBenchResult& r : results) {
+        if (r.zones.empty() || r.profiledTicks == 0 || r.profiledSeconds <= 0.0) {
+            continue;
+        }
+        std::snprintf(line, sizeof line, "\n%s breakdown (profiled pass, %.3f s):\n",
+                      r.name.c_str(), r.profiledSeconds);
+        out += line;
+        const auto ticks = static_cast<double>(r.profiledTicks);
+        double roots = 0.0;
+        for (const diag::ZoneTimingRow& z : r.zones) {
+            if (z.depth == 0) {
+                roots += z.total.value();
+            }
+            std::snprintf(line, sizeof line, "  %*s%-*s %9.2f us/tick %6.1f%%\n",
+                          2 * z.depth, "", 16 - 2 * z.depth, z.name, z.total.value() * 1e6 / ticks,
+                          100.0 * z.total.value() / r.profiledSeconds);
+            out += line;
+        }
+        const double other = r.profiledSeconds - roots;
+        std::snprintf(line, sizeof line, "  %-16s %9.2f us/tick %6.1f%%\n", "other",
+                      other * 1e6 / ticks, 100.0 * other / r.profiledSeconds);
+        out += line;
+    }
+    return out;
+}
+
+/// One baseline line (header: "The baseline").
+struct SimBenchBaselineEntry {
+    std::string name;                ///< the case
+    double ticksPerSecond = 0.0;     ///< its throughput when the baseline was written
+    double allocationsPerTick = 0.0;  ///< its allocations per tick then (-1: not counted)
+};
+
+/// A baseline file's text for `results`.
+[[nodiscard]] inline std::string formatSimBenchBaseline(const std::vector<SimBenchResult>& results) {
+    std::string out =
+        "# shulib_simbench baseline: <case> <ticks/s> <allocations/tick>. Throughput is\n"
+        "# host-specific and recorded from a CMAKE_BUILD_TYPE=Release build; rewrite with\n"
+        "# `shulib_simbench --write-baseline FILE` from such a build on the host that checks\n"
+        "# against it.\n";
+    char line[120];
+    for (const SimBenchResult& r : results) {
+        std::snprintf(line, sizeof line, "%s %.0f %.3f\n", r.name.c_str(), r.ticksPerSecond(),
+                      r.allocationsPerTick());
+        out += line;
+    }
+    return out;
+}
+
+/// Parse a baseline file. False — with the reason and its line in `error` — on a malformed
+/// line; `#` comments and blank lines are skipped.
+[[nodiscard]] inline bool parseSimBenchBaseline(std::string_view text,
+                                                std::vector<SimBenchBaselineEntry>& out,
+                                                std::string& error) {
+    out.clear();
+    int lineNo = 0;
+    while (!text.empty()) {
+        const std::size_t eol = text.find('\n');
+        const std::string_view raw = text.substr(0, eol);
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+        ++lineNo;
+        const std::vector<std::string_view> tok = detail::scenarioTokens(raw);
+        if (tok.empty()) {
+            continue;
+        }
+        SimBenchBaselineEntry e;
+        if (tok.size() != 3 || !detail::parseScenarioNumber(tok[1], e.ticksPerSecond)
+            || !detail::parseScenarioNumber(tok[2], e.allocationsPerTick)
+            || !(e.ticksPerSecond > 0.0)) {
+            error = "line " + std::to_string(lineNo)
+                  + ": expects <case> <ticks/s > 0> <allocations/tick>";
+            return false;
+        }
+        e.name = std::string{tok[0]};
+        out.push_back(e);
+    }
+    return true;
+}
+
+/// The regressions of `results` against `baseline` (header: "The baseline"), one message
+/// each; empty when every case holds. A throughput drop counts past `maxDropPercent`; an
+/// allocation rise past kSimBenchAllocationSlack, where both sides were counted.
+[[nodiscard]] inline std::vector<std::string> checkSimBench(
+    const std::vector<SimBenchResult>& results, const std::vector<SimBenchBaselineEntry>& baseline,
+    double maxDropPercent) {
+    SHULIB_PRECONDITION(maxDropPercent >= 0.0 && maxDropPercent < 100.0,
+                        "checkSimBench: maxDropPercent must be in [0, 100)");
+    std::vector<std::string> out;
+    char line[200];
+    for (const SimBenchResult& r : results) {
+        const SimBenchBaselineEntry* base = nullptr;
+        for (const SimBenchBaselineEntry& e : baseline) {
+            if (e.name == r.name) {
+                base = &e;
+            }
+        }
+        if (base == nullptr) {
+            out.push_back(r.name + ": not in the baseline");
+            continue;
+        }
+        const double floor = base->ticksPerSecond * (1.0 - maxDropPercent / 100.0);
+        if (r.ticksPerSecond() < floor) {
+            std::snprintf(line, sizeof line,
+                          "%s: %.0f ticks/s is %.1f%% below the baseline %.0f (limit %.1f%%)",
+                          r.name.c_str(), r.ticksPerSecond(),
+                          100.0 * (1.0 - r.ticksPerSecond() / base->ticksPerSecond),
+                          base->ticksPerSecond, maxDropPercent);
+            out.emplace_back(line);
+        }
+        const double allocs = r.allocationsPerTick();
+        if (allocs >= 0.0 && base->allocationsPerTick >= 0.0
+            && allocs > base->allocationsPerTick + kSimBenchAllocationSlack) {
+            std::snprintf(line, sizeof line, "%s: %.3f allocations/tick, baseline %.3f",
+                          r.name.c_str(), allocs, base->allocationsPerTick);
+            out.emplace_back(line);
+        }
+    }
+    return out;
+}
+
+}  // namespace shulib::sim
@@ -0,0 +1,299 @@
+#pragma once
+//
+// sim::SimServer — a live closed-loop world driven by text commands and answering on the
+// SHUL/2 wire: the transport-free core of tools/shulib_simd.cpp, the headless sim process
+// that stands in for the master plan's "hal/sim over the VexBuilder agent socket" until
+// that seam exists. Today the sim runs only inside doctest and the scenario runner; this
+// lets a visualiser or a notebook drive one interactively.
+//
+// ── Commands (in) ───────────────────────────────────────────────────────────────────
+// One command per line (LF; a CR is ignored), in the scenario-file grammar
+// (scenario_file.hpp "The format"), plus the server's own verbs:
+//
+//     name drive seeds start dt hostility set jitter fusion tags
+//                                STAGE a setting for the next world
+//     moveTo strafeTo turnTo hold wait brake
+//                                run that Chassis verb to its exit
+//     step <n>                   n plant ticks with the motors as they are — no controller
+//     pose <x> <y> <headingDeg>  teleport: truth AND estimate move there
+//     reset                      a fresh world from the staged settings (seed: seeds' first)
+//     pace fast | realtime [<k>] as fast as the host steps, or sim time = k × wall time
+//     truth                      report the true pose, change nothing
+//     quit                       end this connection; the world is kept for the next
+//     shutdown                   end this connection and stop the server
+//
+// Staging is deliberate: hostility, the drivetrain and the seed are fixed for a world's
+// life (FullHostility is built into the harness), so `hostility full` followed by `reset`
+// is how a client switches it on. The first command that needs a world builds one.
+//
+// ── Answers and telemetry (out) ─────────────────────────────────────────────────────
+// Everything the server writes is a SHUL/2 frame (diag/shul2_sink.hpp), through one
+// Shul2Sink over the transport, so a client decodes one stream:
+//   * every DebugRecord the plant and the controller emit, as compact tick frames;
+//   * one Log frame, tag "simd", answering each non-blank command line:
+//       Info   ok <command> t=<s> truth=<x> <y> <deg> [exit=<verdict> err=<in> <deg>]
+//              (a verb's errors are against TRUTH, as in the scenario runner; -1: n/a)
+//       Error  error <command>: <why>        (nothing changed)
+// A client knows a command is finished when its answer arrives. A local socket has no
+// link to protect, so the defaults (kSimServerWireBytes) make the byte budget a formality;
+// the controller's records carry the ESTIMATE — truth rides only in the answers, as it
+// reaches only assertions in the suite (DrivePlant, constraint 3). A transport calls
+// clientJoined() per connection, so each client's stream opens on a keyframe.
+//
+// ── Pacing ──────────────────────────────────────────────────────────────────────────
+// fast: back to back. realtime k: after each tick the server sleeps until the wall clock
+// has caught up with (sim time elapsed) / k, measured from the start of the command, so
+// a client that idles between commands is never "owed" the idle time. Pacing touches only
+// wall time: the same commands on the same seed produce the same bytes either way.
+// Without __STDCPP_THREADS__ there is no sleeping and `pace realtime` is refused.
+//
+// Host-only, single-task: a verb blocks the server until its exit, as Chassis verbs block
+// a routine, and there is one client at a time.
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#if defined(__STDCPP_THREADS__)
+#include <chrono>
+#include <thread>
+#endif
+
+#include "shulib/control/exit_group.hpp"
+#include "shulib/diag/shul2_sink.hpp"
+#include "shulib/hal/char_sink.hpp"
+#include "shulib/hal/telemetry_sink.hpp"
+#include "shulib/math/angle.hpp"
+#include "shulib/math/pose2d.hpp"
+#include "shulib/sim/scenario_file.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::sim {
+
+/// The server's byte budget per tick: far past a keyframe per record, so nothing a local
+/// socket can carry is ever dropped.
+inline constexpr std::size_t kSimServerWireBytes = 1U << 20;
+
+/// What handle() asks of the transport after a line.
+enum class SimServerStatus {
+    Continue,  ///< read the next line
+    Close,     ///< `quit`: end this connection
+    Shutdown,  ///< `shutdown`: end it and stop serving
+};
+
+/// SimServer's knobs.
+struct SimServerConfig {
+    /// The wire (header: "Answers and telemetry"): no effective budget by default.
+    diag::Shul2SinkConfig wire{.enabled = true,
+                               .bytesPerTick = kSimServerWireBytes,
+                               .burstBytes = kSimServerWireBytes,
+                               .keyframeInterval = diag::blackbox::kDefaultKeyframeInterval};
+    /// The settings the first world is built from, before any command stages others
+    /// (its verbs are ignored).
+    ScenarioSpec initial{};
+    /// Sim seconds per wall second; 0 is `pace fast`.
+    double realtime = 0.0;
+};
+
+namespace detail {
+
+[[nodiscard]] constexpr const char* simServerExitName(control::ExitReason e) noexcept {
+    switch (e) {
+        case control::ExitReason::Running: return "running";
+        case control::ExitReason::Settled: return "settled";
+        case control::ExitReason::TimedOut: return "timedOut";
+        case control::ExitReason::Cancelled: return "cancelled";
+    }
+    return "?";
+}
+
+}  // namespace detail
+
+/// The command interpreter (header). Writes every answer and record to `out` as SHUL/2
+/// frames; the transport feeds it lines and acts on the status.
+class SimServer {
+public:
+    /// `out` must outlive the server.
+    explicit SimServer(hal::ICharSink& out, const SimServerConfig& config = {})
+        : wire_{out, config.wire}, staged_{config.initial}, realtime_{config.realtime} {
+        SHULIB_PRECONDITION(std::isfinite(config.realtime) && config.realtime >= 0.0,
+                            "SimServer: realtime must be finite and >= 0");
+        staged_.verbs.clear();
+    }
+
+    SimServer(const SimServer&) = delete;
+    SimServer& operator=(const SimServer&) = delete;
+
+    /// Run one command line (header: "Commands"). Never throws for a bad command: it is
+    /// answered with an Error line and nothing changes.
+    SimServerStatus handle(std::string_view line) {
+        ++lineNo_;
+        const std::vector<std::string_view> tok = detail::scenarioTokens(line);
+        if (tok.empty()) {
+            return SimServerStatus::Continue;
+        }
+        const std::string key{tok.front()};
+        const std::size_t argc = tok.size() - 1;
+        try {
+            if (key == "quit" || key == "shutdown") {
+                answer(key, "");
+                return key == "quit" ? SimServerStatus::Close : SimServerStatus::Shutdown;
+            }
+            if (key == "reset") {
+                if (argc != 0) {
+                    return refuse(key, "takes no arguments");
+                }
+                world_.reset();
+                ensureWorld();
+                answer(key, "");
+            } else if (key == "truth") {
+                ensureWorld();
+                answer(key, "");
+            } else if (key == "step") {
+                double n = 0.0;
+                if (argc != 1 || !number(tok[1], n) || !(n >= 1.0) || n > 1e7
+                    || std::trunc(n) != n) {
+                    return refuse(key, "expects a tick count in [1, 1e7]");
+                }
+                ensureWorld();
+                startPacing();
+                for (long i = 0; i < static_cast<long>(n); ++i) {
+                    world_->step();
+                }
+                answer(key, "");
+            } else if (key == "pose") {
+                double v[3] = {};
+                if (argc != 3 || !number(tok[1], v[0]) || !number(tok[2], v[1])
+                    || !number(tok[3], v[2])) {
+                    return refuse(key, "expects <x> <y> <headingDeg>");
+                }
+                ensureWorld();
+                world_->teleport(math::Pose2d{units::Length{v[0]}, units::Length{v[1]},
+                                              math::Angle::degrees(v[2])});
+                answer(key, "");
+            } else if (key == "pace") {
+                double k = 1.0;
+                if (argc == 1 && tok[1] == "fast") {
+                    realtime_ = 0.0;
+                } else if (tok.size() >= 2 && tok[1] == "realtime"
+                           && (argc == 1 || (argc == 2 && number(tok[2], k) && k > 0.0))) {
+#if defined(__STDCPP_THREADS__)
+                    realtime_ = k;
+#else
+                    return refuse(key, "realtime pacing needs threads");
+#endif
+                } else {
+                    return refuse(key, "expects fast | realtime [<factor> > 0]");
+                }
+                answer(key, "");
+            } else {
+                // The scenario grammar: a setting is staged, a verb runs now.
+                ScenarioSpec probe = staged_;
+                bool sawSeeds = false;
+                std::string error;
+                if (!applyScenarioLine(probe, line, lineNo_, sawSeeds, error)) {
+                    return refuse(key, error);
+                }
+                if (probe.verbs.empty()) {
+                    staged_ = probe;
+                    answer(key, world_ ? " staged=next-reset" : "");
+                } else {
+                    ensureWorld();
+                    startPacing();
+                    const ScenarioVerbResult r = world_->run(probe.verbs.front());
+                    char extra[96];
+                    std::snprintf(extra, sizeof extra, " exit=%s err=%.4f %.4f",
+                                  detail::simServerExitName(r.exit), r.positionError,
+                                  r.headingError);
+                    answer(key, extra);
+                }
+            }
+        } catch (const std::exception& e) {
+            // A precondition a command tripped (a nonsense hostility value, say): the
+            // world it was building is discarded, and the client hears why.
+            world_.reset();
+            return refuse(key, e.what());
+        }
+        return SimServerStatus::Continue;
+    }
+
+    /// A client connected: restart the tick chain so its first record is a keyframe (a
+    /// joining reader otherwise waits up to a keyframe interval for one).
+    void clientJoined() noexcept { wire_.restartChain(); }
+
+    /// The live world, or null before the first command that needs one.
+    [[nodiscard]] ScenarioWorld* world() noexcept { return world_.get(); }
+    /// The settings the next world is built from.
+    [[nodiscard]] const ScenarioSpec& staged() const noexcept { return staged_; }
+    /// The wire sink (its drop and byte counters).
+    [[nodiscard]] const diag::Shul2Sink& wire() const noexcept { return wire_; }
+    /// Sim seconds per wall second; 0 is fast.
+    [[nodiscard]] double realtime() const noexcept { return realtime_; }
+
+private:
+    void ensureWorld() {
+        if (world_) {
+            return;
+        }
+        world_ = std::make_unique<ScenarioWorld>(staged_, staged_.seedFirst);
+        world_->setSink(&wire_);
+        world_->setAfterStep([this](units::Time dt) { paceTick(dt); });
+    }
+
+    /// Anchor wall-clock pacing at the start of a command (header: "Pacing").
+    void startPacing() {
+        paceSim_ = 0.0;
+#if defined(__STDCPP_THREADS__)
+        paceWall_ = std::chrono::steady_clock::now();
+#endif
+    }
+
+    void paceTick(units::Time dt) {
+        paceSim_ += dt.value();
+#if defined(__STDCPP_THREADS__)
+        if (realtime_ > 0.0) {
+            std::this_thread::sleep_until(
+                paceWall_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>{paceSim_ / realtime_}));
+        }
+#endif
+    }
+
+    [[nodiscard]] static bool number(std::string_view tok, double& out) {
+        return detail::parseScenarioNumber(tok, out) && std::isfinite(out);
+    }
+
+    void answer(const std::string& key, std::string_view extra) {
+        char line[200];
+        if (world_) {
+            const math::Pose2d p = world_->harness().truePose();
+            std::snprintf(line, sizeof line, "ok %s t=%.4f truth=%.4f %.4f %.4f", key.c_str(),
+                          world_->harness().clock().now().value(), p.x().value(), p.y().value(),
+                          p.heading().degrees());
+        } else {
+            std::snprintf(line, sizeof line, "ok %s", key.c_str());
+        }
+        wire_.log(hal::LogLevel::Info, "simd", std::string{line} + std::string{extra});
+    }
+
+    SimServerStatus refuse(const std::string& key, std::string_view why) {
+        wire_.log(hal::LogLevel::Error, "simd", "error " + key + ": " + std::string{why});
+        return SimServerStatus::Continue;
+    }
+
+    diag::Shul2Sink wire_;
+    ScenarioSpec staged_;
+    double realtime_;
+    std::unique_ptr<ScenarioWorld> world_;
+    int lineNo_ = 0;
+    double paceSim_ = 0.0;
+#if defined(__STDCPP_THREADS__)
+    std::chrono::steady_clock::time_point paceWall_{};
+#endif
+};
+
+}  // namespace shulib::sim
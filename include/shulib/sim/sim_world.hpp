@@ -0,0 +1,456 @@
+#pragma once
+//
+// sim::SimWorld — two or more closed-loop robots on one field, stepped in lockstep. This
+// is the VEX U case, where whether a routine is right depends on what the OTHER robot is
+// doing: quadrant ownership, and the cookbook's "Wait for your alliance partner"
+// (docs/cookbook/03-timing-and-partners.md). SimHarness wires one robot; this runs several
+// ScenarioWorlds (scenario_file.hpp) against each other, with a shared FieldGeometry,
+// robot-robot contact and a simulated inter-robot radio with latency and loss.
+//
+// ── The tick ────────────────────────────────────────────────────────────────────────
+// Every robot runs the same dt — a spec with jitter is refused, since it would leave
+// lockstep — so every robot's FakeClock reads the same instant after every tick: one
+// clock in all but storage. A tick has two phases:
+//   1. STEP, in parallel: each robot's program runs its controller up to its next pace,
+//      and its pacer steps that robot's plant. A robot touches only its own world, its
+//      own radio outbox and inbox, and the other robots' boxes (below), which nobody
+//      writes in this phase.
+//   2. EXCHANGE, serial, in robot order, once every robot has stepped: the boxes are
+//      rebuilt from the new truths; each outbox goes on the air and whatever is due is
+//      delivered; the afterTick hook runs.
+// run() gives each robot its own std::thread and separates the phases with a std::barrier
+// whose completion step IS the exchange. step() runs both phases on the calling thread,
+// with no program. Nothing a robot reads during STEP is written during it, and EXCHANGE
+// has one fixed order, so no result depends on how the threads interleave: a run is
+// byte-identical from one run to the next — pinned by test, under FullHostility and a
+// lossy link.
+//
+// ── Programs ────────────────────────────────────────────────────────────────────────
+// run() takes one program per robot: a function that drives that robot's chassis() — a
+// Routine, a waitFor on its radio — and returns when the robot is done. An empty program
+// runs the robot's spec verbs (verbResults()). A robot whose program has returned keeps
+// stepping with its motors as they are until every program has returned, so it still has
+// a clock, a truth and a box. SimWorldConfig::timeLimit ends a run early: each unfinished
+// program is unwound with SimWorldStopped from inside its next pace. An exception from a
+// program stops the run the same way and is rethrown from run() once every thread has
+// joined. The world owns each robot's after-step hook (ScenarioWorld::setAfterStep).
+//
+// ── Robot-robot contact ─────────────────────────────────────────────────────────────
+// Each robot's plant sees every other robot as a FieldBox of its footprint where it stood
+// at the START of the tick (DrivePlant::setBodies). It is pushed out of them as out of a
+// wall, and any distance sensor it has sees them. Honest scope: a box is where a robot
+// was, not where it is going, so two robots closing head-on can overlap by up to their
+// closing speed × dt for a tick before both are pushed apart; and nobody pushes anybody —
+// a robot meeting another stops as at a wall, and no momentum passes between them.
+//
+// ── The radio ───────────────────────────────────────────────────────────────────────
+// radio(i) is robot i's end of the inter-robot link (VEXlink's role). send() puts a
+// SimMessage in the outbox. EXCHANGE puts it on the air (one copy per receiver for a
+// broadcast), draws its loss, and delivers it to the receiver's inbox at the first tick
+// boundary at or past sentAt + latency — so even a zero-latency message is read on the
+// receiver's next tick, never on the one it was sent in. Loss draws come from the world's
+// own Rng (SimWorldConfig::seed), one per copy, in exchange order, and only when
+// lossProbability > 0. The defaults are a perfect link: the real VEXlink's latency and
+// loss are unmeasured, and a default would pretend otherwise.
+//
+// Host-only, like everything in sim/. run() needs threads (__STDCPP_THREADS__); step()
+// does not.
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+#if defined(__STDCPP_THREADS__)
+#include <barrier>
+#include <thread>
+#endif
+
+#include "shulib/core/check.hpp"
+#include "shulib/hal/clock.hpp"
+#include "shulib/math/pose2d.hpp"
+#include "shulib/sim/field_geometry.hpp"
+#include "shulib/sim/rng.hpp"
+#include "shulib/sim/scenario_file.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace shulib::sim {
+
+/// The most robots one world holds: two alliances of two.
+inline constexpr int kSimWorldMaxRobots = 4;
+
+/// One radio message (header: "The radio").
+struct SimMessage {
+    int from = -1;                   ///< the sender's robot index
+    int to = -1;                     ///< the receiver's robot index
+    std::uint32_t topic = 0;         ///< what it is about — the programs' own vocabulary
+    std::array<double, 4> values{};  ///< the payload
+    units::Time sentAt{};            ///< the sender's clock when it was sent
+};
+
+/// The inter-robot link. The defaults are a perfect link (header: "The radio").
+struct SimLinkConfig {
+    units::Time latency{0.0};      ///< air time, >= 0 (delivery is on a tick boundary)
+    double lossProbability = 0.0;  ///< the chance each copy is dropped, in [0, 1]
+};
+
+/// What the link has carried so far: one count per copy.
+struct SimLinkStats {
+    long sent = 0;       ///< copies put on the air
+    long lost = 0;       ///< copies the loss draw dropped
+    long delivered = 0;  ///< copies that reached an inbox
+};
+
+/// How a SimWorld is built.
+struct SimWorldConfig {
+    /// The walls and obstacles every robot collides with; null is the open floor. Must
+    /// outlive the world.
+    const FieldGeometry* field = nullptr;
+    SimLinkConfig link{};     ///< the radio
+    std::uint64_t seed = 1;   ///< the link's loss draws
+    units::Time timeLimit{};  ///< run() stops this long after it starts; 0 → no limit
+};
+
+/// Thrown from a robot's pace when the world stops its run (header: "Programs"). run()
+/// catches it; a program need not.
+class SimWorldStopped : public std::exception {
+public:
+    [[nodiscard]] const char* what() const noexcept override { return "SimWorld: run stopped"; }
+};
+
+/// One robot's end of the link (header: "The radio"). Use it from that robot's program
+/// only.
+class SimRadio {
+public:
+    /// `to` for every other robot.
+    static constexpr int kBroadcast = -1;
+
+    /// Queue a message for the next exchange. `to` is another robot's index or kBroadcast.
+    void send(int to, std::uint32_t topic, const std::array<double, 4>& values = {}) {
+        SHULIB_PRECONDITION(to == kBroadcast || (to >= 0 && to < robots_ && to != self_),
+                            "SimRadio::send: to must be another robot or kBroadcast");
+        outbox_.push_back(SimMessage{self_, to, topic, values, clock_->now()});
+    }
+
+    /// Take the oldest delivered message into `out`; false when there is none.
+    [[nodiscard]] bool receive(SimMessage& out) {
+        if (inbox_.empty()) {
+            return false;
+        }
+        out = inbox_.front();
+        inbox_.pop_front();
+        return true;
+    }
+
+    /// Delivered messages not yet received.
+    [[nodiscard]] std::size_t pending() const noexcept { return inbox_.size(); }
+
+private:
+    friend class SimWorld;
+
+    int self_ = 0;
+    int robots_ = 0;
+    const hal::IClock* clock_ = nullptr;
+    std::vector<SimMessage> outbox_;
+    std::deque<SimMessage> inbox_;
+};
+
+/// A robot's program (header: "Programs"); empty runs the robot's spec verbs.
+using SimProgram = std::function<void()>;
+
+/// Several ScenarioWorlds in lockstep on one field (header). Neither copyable nor movable.
+class SimWorld {
+public:
+    explicit SimWorld(const SimWorldConfig& config = {}) : cfg_{config}, rng_{config.seed} {
+        SHULIB_PRECONDITION(config.link.latency.value() >= 0.0
+                                && std::isfinite(config.link.latency.value()),
+                            "SimWorld: link latency must be finite and >= 0");
+        SHULIB_PRECONDITION(config.link.lossProbability >= 0.0
+                                && config.link.lossProbability <= 1.0,
+                            "SimWorld: link lossProbability must be in [0, 1]");
+        SHULIB_PRECONDITION(config.timeLimit.value() >= 0.0,
+                            "SimWorld: timeLimit must be >= 0");
+    }
+
+    SimWorld(const SimWorld&) = delete;
+    SimWorld& operator=(const SimWorld&) = delete;
+
+    /// Add a robot built as `spec` describes with `seed`, on the shared field; its index is
+    /// returned. Only before the first tick. Its verbs run when run() gets no program for
+    /// it; its jitter is refused, and its dt must match the other robots'.
+    int addRobot(const ScenarioSpec& spec, std::uint64_t seed) {
+        SHULIB_PRECONDITION(ticks_ == 0, "SimWorld::addRobot: the world has already ticked");
+        SHULIB_PRECONDITION(robotCount() < kSimWorldMaxRobots,
+                            "SimWorld::addRobot: at most kSimWorldMaxRobots robots");
+        SHULIB_PRECONDITION(!spec.jitter, "SimWorld::addRobot: a jittered dt leaves lockstep");
+        SHULIB_PRECONDITION(robots_.empty() || spec.dt == robots_.front()->spec.dt,
+                            "SimWorld::addRobot: every robot must run the same dt");
+        const int index = robotCount();
+        auto r = std::make_unique<Robot>();
+        r->spec = spec;
+        r->world = std::make_unique<ScenarioWorld>(spec, seed, nullptr, cfg_.field);
+        r->world->setAfterStep([this, index](units::Time) { paced(index); });
+        r->radio.self_ = index;
+        r->radio.clock_ = &r->world->harness().clock();
+        robots_.push_back(std::move(r));
+        for (const std::unique_ptr<Robot>& each : robots_) {
+            each->radio.robots_ = robotCount();
+        }
+        refreshBodies();
+        return index;
+    }
+
+    /// One tick of every robot, both phases on this thread, with no controller: each
+    /// plant steps with its motors as they are (header: "The tick").
+    void step() {
+        SHULIB_PRECONDITION(!robots_.empty(), "SimWorld::step: no robots");
+        for (const std::unique_ptr<Robot>& r : robots_) {
+            r->world->step();
+        }
+        exchange();
+    }
+
+    /// Run one program per robot to completion, each on its own thread (header:
+    /// "Programs"). `programs` is empty (every robot runs its verbs) or one per robot.
+    void run(const std::vector<SimProgram>& programs = {}) {
+        SHULIB_PRECONDITION(!robots_.empty(), "SimWorld::run: no robots");
+        SHULIB_PRECONDITION(programs.empty() || programs.size() == robots_.size(),
+                            "SimWorld::run: one program per robot, or none");
+#if defined(__STDCPP_THREADS__)
+        finished_ = false;
+        stoppedAtLimit_ = false;
+        runStart_ = now();
+        for (const std::unique_ptr<Robot>& r : robots_) {
+            r->done = false;
+            r->error = nullptr;
+        }
+        barrier_ = std::make_unique<std::barrier<Completion>>(
+            static_cast<std::ptrdiff_t>(robots_.size()), Completion{this});
+        threaded_ = true;
+        std::vector<std::thread> pool;
+        pool.reserve(robots_.size());
+        for (std::size_t i = 0; i < robots_.size(); ++i) {
+            pool.emplace_back([this, i, &programs] {
+                drive(*robots_[i], programs.empty() ? SimProgram{} : programs[i]);
+            });
+        }
+        for (std::thread& t : pool) {
+            t.join();
+        }
+        threaded_ = false;
+        barrier_.reset();
+        if (exchangeError_) {
+            std::rethrow_exception(std::exchange(exchangeError_, nullptr));
+        }
+        for (const std::unique_ptr<Robot>& r : robots_) {
+            if (r->error) {
+                std::rethrow_exception(r->error);
+            }
+        }
+#else
+        SHULIB_PRECONDITION(false, "SimWorld::run: needs threads (__STDCPP_THREADS__)");
+#endif
+    }
+
+    /// Robots added so far.
+    [[nodiscard]] int robotCount() const noexcept { return static_cast<int>(robots_.size()); }
+    /// Robot i's world: its harness, localizer and chassis. Advance it only through step()
+    /// or its program in run(): a verb run from anywhere else skips the exchange.
+    [[nodiscard]] ScenarioWorld& robot(int i) { return *at(i).world; }
+    /// Robot i's end of the link.
+    [[nodiscard]] SimRadio& radio(int i) { return at(i).radio; }
+    /// Robot i's verb results from its last run() without a program, in verb order.
+    [[nodiscard]] const std::vector<ScenarioVerbResult>& verbResults(int i) {
+        return at(i).verbs;
+    }
+    /// What the link has carried.
+    [[nodiscard]] const SimLinkStats& linkStats() const noexcept { return stats_; }
+    /// Ticks so far (exchanges).
+    [[nodiscard]] long ticks() const noexcept { return ticks_; }
+    /// The shared instant: robot 0's clock, which every robot's equals (header).
+    [[nodiscard]] units::Time now() const {
+        return robots_.empty() ? units::Time{} : robots_.front()->world->harness().clock().now();
+    }
+    /// The last run() ended at SimWorldConfig::timeLimit.
+    [[nodiscard]] bool stoppedAtLimit() const noexcept { return stoppedAtLimit_; }
+
+    /// Runs at the end of every exchange with the tick count — serially, with every robot
+    /// between ticks, so it may read any of them. Empty for nothing.
+    std::function<void(long)> afterTick;
+
+private:
+    /// A robot: its world, its radio, the other robots' boxes its plant sees, and its run
+    /// state (written by its thread before it arrives, read in the exchange after).
+    struct Robot {
+        ScenarioSpec spec;
+        std::unique_ptr<ScenarioWorld> world;
+        SimRadio radio;
+        std::array<FieldBox, static_cast<std::size_t>(kSimWorldMaxRobots - 1)> bodies{};
+        std::vector<ScenarioVerbResult> verbs;
+        bool done = false;
+        std::exception_ptr error;
+    };
+
+    /// The barrier's completion step: the exchange, which must not throw out of it.
+    struct Completion {
+        SimWorld* world;
+        void operator()() noexcept { world->completeTick(); }
+    };
+
+    [[nodiscard]] Robot& at(int i) {
+        SHULIB_PRECONDITION(i >= 0 && i < robotCount(), "SimWorld: robot index out of range");
+        return *robots_[static_cast<std::size_t>(i)];
+    }
+
+    /// Robot `index` has stepped (its after-step hook). Threaded: wait out the exchange,
+    /// then unwind a stopped run's unfinished program.
+    void paced(int index) {
+#if defined(__STDCPP_THREADS__)
+        if (!threaded_) {
+            return;  // step() runs the exchange itself
+        }
+        barrier_->arrive_and_wait();
+        if (finished_ && !robots_[static_cast<std::size_t>(index)]->done) {
+            throw SimWorldStopped{};
+        }
+#else
+        (void)index;
+#endif
+    }
+
+    /// One robot's thread: its program, then idle ticks until every robot is done.
+    void drive(Robot& r, const SimProgram& program) noexcept {
+        try {
+            if (program) {
+                program();
+            } else {
+                r.verbs.clear();
+                for (const ScenarioVerb& v : r.spec.verbs) {
+                    r.verbs.push_back(r.world->run(v));
+                }
+            }
+        } catch (const SimWorldStopped&) {
+            // The world stopped the run; not an error.
+        } catch (...) {
+            r.error = std::current_exception();
+        }
+        r.done = true;
+#if defined(__STDCPP_THREADS__)
+        while (!finished_) {
+            if (r.error) {
+                barrier_->arrive_and_wait();  // a failed robot only keeps the others' count
+                continue;
+            }
+            try {
+                r.world->step();
+            } catch (...) {
+                r.error = std::current_exception();
+            }
+        }
+#endif
+    }
+
+    void completeTick() noexcept {
+        try {
+            exchange();
+        } catch (...) {
+            exchangeError_ = std::current_exception();
+        }
+        bool allDone = true;
+        bool failed = exchangeError_ != nullptr;
+        for (const std::unique_ptr<Robot>& r : robots_) {
+            allDone = allDone && r->done;
+            failed = failed || r->error != nullptr;
+        }
+        if (cfg_.timeLimit.value() > 0.0
+            && (now() - runStart_).value() >= cfg_.timeLimit.value() - kTimeEpsilon) {
+            stoppedAtLimit_ = !allDone;
+            finished_ = true;
+        }
+        finished_ = finished_ || allDone || failed;
+    }
+
+    /// The serial phase (header: "The tick").
+    void exchange() {
+        ++ticks_;
+        refreshBodies();
+        const units::Time t = now();
+        for (const std::unique_ptr<Robot>& r : robots_) {
+            for (const SimMessage& m : r->radio.outbox_) {
+                for (int to = 0; to < robotCount(); ++to) {
+                    if (to == m.from || (m.to != SimRadio::kBroadcast && m.to != to)) {
+                        continue;
+                    }
+                    ++stats_.sent;
+                    if (cfg_.link.lossProbability > 0.0
+                        && rng_.nextUnit() < cfg_.link.lossProbability) {
+                        ++stats_.lost;
+                        continue;
+                    }
+                    SimMessage copy = m;
+                    copy.to = to;
+                    air_.push_back(copy);
+                }
+            }
+            r->radio.outbox_.clear();
+        }
+        std::size_t kept = 0;
+        for (const SimMessage& m : air_) {
+            if ((m.sentAt + cfg_.link.latency).value() <= t.value() + kTimeEpsilon) {
+                robots_[static_cast<std::size_t>(m.to)]->radio.inbox_.push_back(m);
+                ++stats_.delivered;
+            } else {
+                air_[kept++] = m;
+            }
+        }
+        air_.resize(kept);
+        if (afterTick) {
+            afterTick(ticks_);
+        }
+    }
+
+    /// Every robot's view of the others: their footprints at their current truths.
+    void refreshBodies() {
+        for (std::size_t i = 0; i < robots_.size(); ++i) {
+            Robot& r = *robots_[i];
+            std::size_t n = 0;
+            for (std::size_t j = 0; j < robots_.size(); ++j) {
+                if (j == i) {
+                    continue;
+                }
+                DrivePlant& other = robots_[j]->world->harness().plant();
+                const math::Pose2d p = other.truePose();
+                r.bodies[n++] = FieldBox{p.x(), p.y(), other.footprint().halfLength,
+                                         other.footprint().halfWidth, p.heading()};
+            }
+            r.world->harness().plant().setBodies(
+                std::span<const FieldBox>{r.bodies.data(), n});
+        }
+    }
+
+    /// Tick-boundary comparisons forgive the clock's summation rounding.
+    static constexpr double kTimeEpsilon = 1e-9;
+
+    SimWorldConfig cfg_;
+    Rng rng_;
+    std::vector<std::unique_ptr<Robot>> robots_;
+    std::vector<SimMessage> air_;
+    SimLinkStats stats_;
+    long ticks_ = 0;
+    units::Time runStart_{};
+    bool threaded_ = false;
+    bool finished_ = false;
+    bool stoppedAtLimit_ = false;
+    std::exception_ptr exchangeError_;
+#if defined(__STDCPP_THREADS__)
+    std::unique_ptr<std::barrier<Completion>> barrier_;
+#endif
+};
+
+}  // namespace shulib::sim
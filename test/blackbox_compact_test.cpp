@@ -0,0 +1,400 @@
+// Tests for the blackbox v2 COMPACT TICK STREAM — diag/blackbox_compact.hpp, and its
+// reading through diag/blackbox_reader.hpp. What each targets:
+//
+//  * LOSSLESS, BIT FOR BIT: a delta stream decodes to ticks whose v1 bytes are identical
+//    to the originals' — NaN payloads, signed zeros, infinities and wrapping integer
+//    fields included. Comparing v1 BYTES rather than fields is the stronger check: it is
+//    exactly the claim the codec's header makes.
+//  * THE BYTE-EXACT GOLDEN: one delta frame derived BY HAND from the documented layout
+//    (the same discipline as blackbox_format_test's golden). A symmetric mistake in the
+//    bitstream — a flipped control bit, a window width off by one in both halves — round
+//    trips perfectly and is caught only here.
+//  * KEYFRAMES AND BROKEN CHAINS: keyframes arrive on the configured cadence; a lost
+//    delta makes the reader REFUSE (and count) every delta until the next keyframe, never
+//    reconstruct one against the wrong predecessor; a cut file decodes up to the cut.
+//  * THE POINT, measured: on a closed-loop sim run, the compact stream's size against
+//    v1's and the host encode cost per tick — reported, and the ratio floored.
+
+#include "doctest.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "motion_test_rig.hpp"
+#include "shulib/diag/blackbox_compact.hpp"
+#include "shulib/diag/blackbox_format.hpp"
+#include "shulib/diag/blackbox_reader.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/sd_sink.hpp"
+#include "shulib/diag/session_info.hpp"
+#include "shulib/hal/fake/fake_block_sink.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/math/angle.hpp"
+#include "shulib/math/pose2d.hpp"
+#include "shulib/motion/move_to_pose.hpp"
+
+using shulib::diag::DebugRecord;
+using shulib::diag::SdSink;
+using shulib::diag::SdSinkConfig;
+using shulib::diag::SdSinkStorage;
+using shulib::hal::fake::FakeBlockSink;
+using shulib::math::Angle;
+using shulib::math::Pose2d;
+namespace bb = shulib::diag::blackbox;
+namespace units = shulib::units;
+
+namespace {
+
+/// A smoothly moving robot: what consecutive ticks of a real run look like — small
+/// changes in the pose and the commands, a few constant fields, and an integer block
+/// that changes now and then.
+DebugRecord drifting(int i) {
+    const double k = static_cast<double>(i);
+    DebugRecord r;
+    r.t = units::Time{0.01 * k};
+    r.dt = units::Time{0.01};
+    r.targetPose = Pose2d{units::Length{24.0}, units::Length{12.0}, Angle::degrees(90.0)};
+    r.measuredPose = Pose2d{units::Length{0.2 * k}, units::Length{0.1 * k},
+                            Angle::radians(0.01 * k)};
+    r.errorX = units::Length{24.0 - 0.2 * k};
+    r.errorY = units::Length{12.0 - 0.1 * k};
+    r.commanded = shulib::math::ChassisSpeeds{units::Velocity{20.0 - 0.05 * k},
+                                              units::Velocity{0.0},
+                                              units::AngularVelocity{0.3}};
+    r.wheelCount = 4;
+    for (std::size_t w = 0; w < 4; ++w) {
+        r.wheelVoltage[w] = units::Voltage{6.0 + 0.01 * k + static_cast<double>(w)};
+    }
+    r.activeCommandId = 3U + static_cast<std::uint32_t>(i / 40);
+    r.activeCommandState = 2;
+    r.quality = 0.9;
+    r.batteryVoltage = units::Voltage{12.6 - 0.0001 * k};
+    return r;
+}
+
+/// The v1 bytes of a record — the codec's own notion of "the same tick".
+std::array<std::byte, bb::kTickPayloadBytes> v1(const DebugRecord& r) {
+    std::array<std::byte, bb::kTickPayloadBytes> out{};
+    REQUIRE(bb::encodeTick(out, r) == bb::kTickPayloadBytes);
+    return out;
+}
+
+/// A double with a chosen bit pattern (NaN payloads cannot be written as literals).
+double fromBits(std::uint64_t bits) {
+    double v = 0.0;
+    std::memcpy(&v, &bits, sizeof v);
+    return v;
+}
+
+/// One encoded frame, copied out of the encoder's scratch.
+struct OwnedFrame {
+    bb::FrameType type = bb::FrameType::TickKey;
+    std::vector<std::byte> payload;
+};
+
+/// Encode and commit every record, as a sink that never drops would.
+std::vector<OwnedFrame> encodeAll(const std::vector<DebugRecord>& ticks, std::size_t interval) {
+    bb::CompactTickEncoder enc{interval};
+    std::vector<OwnedFrame> frames;
+    for (const DebugRecord& r : ticks) {
+        const auto e = enc.encode(r);
+        REQUIRE_FALSE(e.payload.empty());
+        frames.push_back(OwnedFrame{e.type, {e.payload.begin(), e.payload.end()}});
+        enc.commit();
+    }
+    return frames;
+}
+
+/// A v2 file around the given frames: the header the sink would stamp, then each frame.
+std::vector<std::byte> v2File(const std::vector<OwnedFrame>& frames) {
+    std::vector<std::byte> file(bb::kHeaderBytes);
+    REQUIRE(bb::encodeHeader(file, shulib::diag::SessionInfo{}, 0.0, 0, 0,
+                             bb::kFormatVersionCompact)
+            == bb::kHeaderBytes);
+    for (const OwnedFrame& f : frames) {
+        std::array<std::byte, bb::kFrameHeaderBytes> head{};
+        REQUIRE(bb::encodeFrameHeader(head, f.type, static_cast<std::uint16_t>(f.payload.size()))
+                == bb::kFrameHeaderBytes);
+        file.insert(file.end(), head.begin(), head.end());
+        file.insert(file.end(), f.payload.begin(), f.payload.end());
+    }
+    return file;
+}
+
+/// Every tick readTick() reconstructs, in file order.
+struct ReadBack {
+    std::vector<DebugRecord> ticks;
+    std::uint32_t unresolved = 0;
+    bool corrupt = false;
+    bool truncated = false;
+    bb::ReadStatus status = bb::ReadStatus::Empty;
+};
+
+ReadBack readBack(std::span<const std::byte> file) {
+    ReadBack out;
+    bb::BlackboxReader reader{file};
+    out.status = reader.status();
+    bb::BlackboxReader::Frame frame;
+    while (reader.next(frame)) {
+        DebugRecord r;
+        if (reader.readTick(frame, r, out.corrupt)) {
+            out.ticks.push_back(r);
+        }
+    }
+    out.unresolved = reader.unresolvedTicks();
+    out.truncated = reader.truncated();
+    return out;
+}
+
+std::uint8_t byteAt(const std::vector<std::byte>& v, std::size_t i) {
+    return static_cast<std::uint8_t>(v[i]);
+}
+
+}  // namespace
+
+// ── Lossless ────────────────────────────────────────────────────────────────────────
+
+// Would catch: any lossy step — a window that drops a low bit, a NaN canonicalised by
+// arithmetic, -0.0 collapsing to +0.0, an integer delta that does not wrap.
+TEST_CASE("compact ticks: the round trip is bit-exact, odd values included") {
+    std::vector<DebugRecord> ticks;
+    for (int i = 0; i < 120; ++i) {
+        DebugRecord r = drifting(i);
+        if (i % 7 == 3) {
+            r.quality = fromBits(0x7FF8'0000'DEAD'BEEFULL);  // a NaN with a payload
+        }
+        if (i % 11 == 5) {
+            r.errorHeading = units::AngleDim{-0.0};
+            r.covarianceTrace = std::numeric_limits<double>::infinity();
+        }
+        if (i == 60) {
+            r.activeCommandId = 0xFFFF'FFFFU;  // then wraps back to a small id
+            r.droppedLines = 0xFFFF'FFF0U;
+        }
+        r.fault = i == 90 ? shulib::diag::FaultCode::LoopOverrun : shulib::diag::FaultCode::None;
+        ticks.push_back(r);
+    }
+    const std::vector<OwnedFrame> frames = encodeAll(ticks, bb::kDefaultKeyframeInterval);
+
+    bb::CompactTickDecoder dec;
+    bool corrupt = false;
+    for (std::size_t i = 0; i < ticks.size(); ++i) {
+        DebugRecord got;
+        REQUIRE(dec.decode(frames[i].type, frames[i].payload, got, corrupt));
+        CHECK(v1(got) == v1(ticks[i]));
+    }
+    CHECK_FALSE(corrupt);
+    CHECK(dec.unresolved() == 0);
+}
+
+// ── The byte-exact golden ───────────────────────────────────────────────────────────
+
+// Would catch: a symmetric change to the delta layout. Derived by hand from the header's
+// layout: t goes 1.0 → 1.5 (bits 0x3FF0… → 0x3FF8…, XOR = bit 51 alone: 12 leading
+// zeros, 51 trailing, 1 meaningful bit) and activeCommandId 7 → 8 (zigzag(+1) = 2).
+//   seq 2                      02 00
+//   words: Δ0, +1, Δ0, Δ0, Δ0  00 02 00 00 00
+//   field 0 (t): 1 1 01100 000000 1  then 50 × '0' for the unchanged fields
+//     = 1101 1000 | 0000 0100 | 0 × 48   → D8 04 00 00 00 00 00 00
+TEST_CASE("compact golden: one delta frame, byte for byte") {
+    DebugRecord a;
+    a.t = units::Time{1.0};
+    a.activeCommandId = 7;
+    DebugRecord b = a;
+    b.t = units::Time{1.5};
+    b.activeCommandId = 8;
+
+    bb::CompactTickEncoder enc;
+    const auto key = enc.encode(a);
+    CHECK(key.type == bb::FrameType::TickKey);
+    REQUIRE(key.payload.size() == bb::kTickKeyPayloadBytes);
+    CHECK(static_cast<std::uint8_t>(key.payload[0]) == 0x01);  // the chain's first seq
+    CHECK(static_cast<std::uint8_t>(key.payload[1]) == 0x00);
+    enc.commit();
+
+    const auto delta = enc.encode(b);
+    CHECK(delta.type == bb::FrameType::TickDelta);
+    const std::vector<std::byte> got{delta.payload.begin(), delta.payload.end()};
+    const std::array<std::uint8_t, 15> want = {0x02, 0x00,                          // seq
+                                               0x00, 0x02, 0x00, 0x00, 0x00,        // words
+                                               0xD8, 0x04, 0x00, 0x00, 0x00, 0x00,  // floats
+                                               0x00, 0x00};
+    REQUIRE(got.size() == want.size());
+    for (std::size_t i = 0; i < want.size(); ++i) {
+        CAPTURE(i);
+        CHECK(byteAt(got, i) == want[i]);
+    }
+    CHECK(got.size() == bb::kTickDeltaMinPayloadBytes + 1);  // one byte over "nothing moved"
+}
+
+// ── Keyframes and broken chains ─────────────────────────────────────────────────────
+
+// Would catch: a keyframe cadence that drifts (so a lost frame costs more than promised)
+// or an encoder that never keyframes at all after the first.
+TEST_CASE("compact ticks: keyframes arrive on the configured interval") {
+    std::vector<DebugRecord> ticks;
+    for (int i = 0; i < 10; ++i) {
+        ticks.push_back(drifting(i));
+    }
+    const std::vector<OwnedFrame> frames = encodeAll(ticks, 4);
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        CAPTURE(i);
+        CHECK(frames[i].type == (i % 4 == 0 ? bb::FrameType::TickKey : bb::FrameType::TickDelta));
+    }
+    CHECK_THROWS_AS(bb::CompactTickEncoder{0}, shulib::PreconditionError);
+}
+
+// Would catch: a reader that decodes a delta against whatever it decoded last — after a
+// lost frame that is a confidently WRONG tick, and every tick after it is wrong too.
+TEST_CASE("compact ticks: a lost delta is REFUSED until the next keyframe, never misread") {
+    std::vector<DebugRecord> ticks;
+    for (int i = 0; i < 12; ++i) {
+        ticks.push_back(drifting(i));
+    }
+    std::vector<OwnedFrame> frames = encodeAll(ticks, 5);  // keys at 0, 5, 10
+    frames.erase(frames.begin() + 2);                      // lose tick 2 (a delta)
+
+    const std::vector<std::byte> file = v2File(frames);
+    const ReadBack got = readBack(file);
+    REQUIRE(got.status == bb::ReadStatus::Ok);
+    CHECK(got.unresolved == 2);  // ticks 3 and 4: present in the file, not reconstructed
+    CHECK_FALSE(got.corrupt);    // a broken chain is a gap, not corruption
+    const std::array<int, 9> expected = {0, 1, 5, 6, 7, 8, 9, 10, 11};
+    REQUIRE(got.ticks.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        CAPTURE(i);
+        CHECK(v1(got.ticks[i]) == v1(ticks[static_cast<std::size_t>(expected[i])]));
+    }
+}
+
+// Would catch: a compact file losing the v1 truncation contract — the frames before a
+// cut must still decode, and the reader must still say the story stops there.
+TEST_CASE("compact ticks: a cut file decodes up to the cut and says so") {
+    std::vector<DebugRecord> ticks;
+    for (int i = 0; i < 8; ++i) {
+        ticks.push_back(drifting(i));
+    }
+    std::vector<std::byte> file = v2File(encodeAll(ticks, bb::kDefaultKeyframeInterval));
+    file.resize(file.size() - 3);  // cut inside the last delta
+
+    const ReadBack got = readBack(file);
+    CHECK(got.truncated);
+    REQUIRE(got.ticks.size() == 7);
+    CHECK(v1(got.ticks[6]) == v1(ticks[6]));
+}
+
+// Would catch: a malformed delta decoded anyway. A payload with a trailing byte the
+// bitstream does not account for is not one this encoder wrote.
+TEST_CASE("compact ticks: a malformed delta is refused and flagged corrupt") {
+    std::vector<OwnedFrame> frames = encodeAll({drifting(0), drifting(1), drifting(2)}, 50);
+    frames[1].payload.push_back(std::byte{0});
+
+    bb::CompactTickDecoder dec;
+    bool corrupt = false;
+    DebugRecord r;
+    REQUIRE(dec.decode(frames[0].type, frames[0].payload, r, corrupt));
+    CHECK_FALSE(dec.decode(frames[1].type, frames[1].payload, r, corrupt));
+    CHECK(corrupt);
+    CHECK_FALSE(dec.decode(frames[2].type, frames[2].payload, r, corrupt));  // chain is gone
+    CHECK(dec.unresolved() == 2);
+}
+
+// Would catch: a v2 file refused by this build, or a v3 file accepted by it.
+TEST_CASE("compact ticks: the reader accepts v1 and v2 and still refuses what it does not know") {
+    std::vector<std::byte> file = v2File(encodeAll({drifting(0)}, 50));
+    CHECK(bb::BlackboxReader{file}.status() == bb::ReadStatus::Ok);
+    file[4] = std::byte{1};
+    CHECK(bb::BlackboxReader{file}.status() == bb::ReadStatus::Ok);
+    file[4] = std::byte{3};
+    CHECK(bb::BlackboxReader{file}.status() == bb::ReadStatus::UnsupportedVersion);
+}
+
+// ── The point, measured ─────────────────────────────────────────────────────────────
+
+// Would catch: a codec that is lossless but pointless. A closed-loop MoveToPose on the
+// H-bot rig records every tick, and two streams are measured. The HARNESS stream is
+// everything the sim emits — the plant's own record interleaved with the motion's, which
+// is the worst case for a delta codec (each tick's predecessor is the OTHER kind). The
+// ROBOT stream is the motion's records alone — what the blackbox sees on a real robot,
+// where no plant emits. Each is streamed through a v1 sink and a compact sink: the
+// compact file must decode to the identical v1 bytes and be a fraction of the size.
+TEST_CASE("compact ticks: compression ratio and encode cost on a closed-loop sim run") {
+    using motion_rig::MotionRig;
+    shulib::hal::fake::FakeTelemetrySink recorder;
+    const auto kin = motion_rig::hBotKinematics();
+    MotionRig rig{kin, motion_rig::plantConfig(), &recorder};
+    const Pose2d target{units::Length{30.0}, units::Length{18.0}, Angle::degrees(60.0)};
+    shulib::motion::MoveToPose m{rig.deps, target, motion_rig::motionConfig(), 8.0};
+    (void)rig.run(m, 600);
+    std::vector<DebugRecord> harness;
+    std::vector<DebugRecord> robot;
+    for (int i = 0; i < recorder.recordCount(); ++i) {
+        harness.push_back(recorder.recordAt(i));
+        if (recorder.recordAt(i).activeCommandState != 0) {
+            robot.push_back(recorder.recordAt(i));
+        }
+    }
+    REQUIRE(robot.size() > 100);
+    REQUIRE(harness.size() > robot.size());
+
+    /// Stream `ticks` through a v1 or compact sink; returns the file size, and checks the
+    /// compact file decodes to the v1 file's exact ticks.
+    auto measure = [](const std::vector<DebugRecord>& ticks) {
+        auto stream = [&](bool compact, FakeBlockSink& device) {
+            shulib::hal::fake::FakeClock clock;
+            std::vector<DebugRecord> ring(1);
+            std::vector<std::byte> buffer(1U << 20);
+            SdSink sink{device, clock, SdSinkStorage{ring, buffer},
+                        SdSinkConfig{.streamTicks = true, .compactTicks = compact}};
+            for (const DebugRecord& r : ticks) {
+                sink.emit(r);
+            }
+            sink.close();
+            CHECK(sink.droppedFrames() == 0);
+        };
+        FakeBlockSink plain;
+        FakeBlockSink compact;
+        stream(false, plain);
+        stream(true, compact);
+        const ReadBack a = readBack(plain.view());
+        const ReadBack b = readBack(compact.view());
+        REQUIRE(a.ticks.size() == ticks.size());
+        REQUIRE(b.ticks.size() == ticks.size());
+        CHECK(b.unresolved == 0);
+        for (std::size_t i = 0; i < ticks.size(); ++i) {
+            CHECK(v1(b.ticks[i]) == v1(a.ticks[i]));
+        }
+        return static_cast<double>(plain.size()) / static_cast<double>(compact.size());
+    };
+    const double harnessRatio = measure(harness);
+    const double robotRatio = measure(robot);
+
+    // Host encode cost: the codec alone, warm, over the robot stream.
+    bb::CompactTickEncoder enc;
+    std::size_t bytes = 0;
+    constexpr int kReps = 20;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < kReps; ++rep) {
+        for (const DebugRecord& r : robot) {
+            bytes += enc.encode(r).payload.size();
+            enc.commit();
+        }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const double ticks = static_cast<double>(kReps) * static_cast<double>(robot.size());
+    const double nsPerTick =
+        static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count())
+        / ticks;
+
+    MESSAGE("blackbox v2 on a closed-loop MoveToPose: robot stream ", robot.size(),
+            " ticks, ratio ", robotRatio, " (", static_cast<double>(bytes) / ticks,
+            " payload B/tick vs ", bb::kTickPayloadBytes, "); harness stream ", harness.size(),
+            " ticks, ratio ", harnessRatio, "; host encode ", nsPerTick, " ns/tick");
+    CHECK(robotRatio > 3.0);
+    CHECK(harnessRatio > 2.5);
+}
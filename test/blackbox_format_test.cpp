@@ -655,12 +655,12 @@ TEST_CASE("blackbox golden: the frame prefix") {
 TEST_CASE("blackbox: an unknown version is REFUSED, not misread") {
     FileBuilder file;
     file.addTick(groundTruth(0.0));
-    file.bytes[4] = static_cast<std::byte>(2);  // formatVersion = 2
+    file.bytes[4] = static_cast<std::byte>(3);  // formatVersion = 3 (2 is compact ticks)
 
     bb::BlackboxReader reader{file.bytes};
     CHECK(reader.status() == bb::ReadStatus::UnsupportedVersion);
     CHECK_FALSE(reader.usable());
-    CHECK(reader.header().formatVersion == 2);  // still tells you WHICH version it is
+    CHECK(reader.header().formatVersion == 3);  // still tells you WHICH version it is
     bb::BlackboxReader::Frame frame;
     CHECK_FALSE(reader.next(frame));  // and hands out NOTHING
     CHECK(reader.framesRead() == 0);
@@ -0,0 +1,334 @@
+// Tests for the host-side blackbox index and columnar export — sim/blackbox_index.hpp.
+// What each targets:
+//
+//  * SEEKS LAND ON THE RIGHT TICK: seekTime() is a lower bound (exact hit, between two
+//    ticks, past the end), seekCommand() finds a command's FIRST tick and never a
+//    between-motions 0, and a file whose times go backwards (a dump after a stream)
+//    still seeks correctly.
+//  * RANDOM ACCESS IS THE SEQUENTIAL READ: readTick(i) equals what BlackboxReader
+//    delivers for tick i, in a v1 file and in a compact (v2) file, where it must replay
+//    the chain from the right keyframe past interleaved non-tick frames.
+//  * COLUMNS ARE THE FIELDS: each column holds its field for every tick; the CSV and the
+//    binary columnar file carry the same numbers; a columnar file mapped from disk is
+//    read IN PLACE (the column spans point into the mapping), and a misaligned buffer
+//    is refused rather than copied.
+//  * THE THROUGHPUT, measured: one-pass index + column gather over a ~20 MB v1 file,
+//    reported in GB/s with a floor that only a per-tick DebugRecord round trip or a
+//    per-frame allocation would break.
+
+#include "doctest.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "shulib/diag/blackbox_format.hpp"
+#include "shulib/diag/blackbox_reader.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/sd_sink.hpp"
+#include "shulib/hal/fake/fake_block_sink.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/math/pose2d.hpp"
+#include "shulib/sim/blackbox_index.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace bb = shulib::diag::blackbox;
+
+using shulib::diag::DebugRecord;
+using shulib::diag::SdSink;
+using shulib::diag::SdSinkConfig;
+using shulib::diag::SdSinkStorage;
+using shulib::hal::fake::FakeBlockSink;
+using shulib::hal::fake::FakeClock;
+using shulib::math::Angle;
+using shulib::math::Pose2d;
+using shulib::sim::BlackboxIndex;
+using shulib::sim::ColumnarView;
+using shulib::sim::MappedFile;
+using shulib::sim::TickColumns;
+using shulib::sim::kTickColumns;
+using shulib::units::Length;
+using shulib::units::Time;
+using shulib::units::Voltage;
+
+namespace {
+
+/// Tick i of a synthetic run: 10 ms apart, command id i/100 (so ticks 0–99 are between
+/// motions), and a few fields that move so a column mix-up shows.
+DebugRecord syntheticTick(std::size_t i) {
+    DebugRecord r;
+    const auto d = static_cast<double>(i);
+    r.t = Time{0.01 * d};
+    r.dt = Time{0.01};
+    r.measuredPose = Pose2d{Length{0.5 * d}, Length{-0.25 * d}, Angle::radians(0.001 * d)};
+    r.activeCommandId = static_cast<std::uint32_t>(i / 100);
+    r.wheelCount = 4;
+    r.wheelVoltage[2] = Voltage{static_cast<double>(i % 12)};
+    r.quality = 1.0 / (1.0 + d);
+    r.droppedLines = static_cast<std::uint32_t>(i * 3);
+    return r;
+}
+
+/// A v1 file of `ticks` synthetic ticks, with `times(i)` overriding each tick's time
+/// when given, and a non-tick frame after every seventh tick (the index must step over
+/// frames it does not index).
+std::vector<std::byte> v1File(std::size_t ticks, double (*times)(std::size_t) = nullptr) {
+    std::vector<std::byte> file(bb::kHeaderBytes);
+    REQUIRE(bb::encodeHeader(file, {}, 0.0, 0, 0) == bb::kHeaderBytes);
+    const auto frame = [&](bb::FrameType type, std::size_t bytes, auto encode) {
+        const std::size_t at = file.size();
+        file.resize(at + bb::kFrameHeaderBytes + bytes);
+        const std::span<std::byte> out{file.data() + at, bb::kFrameHeaderBytes + bytes};
+        REQUIRE(bb::encodeFrameHeader(out, type, static_cast<std::uint16_t>(bytes)) != 0U);
+        REQUIRE(encode(out.subspan(bb::kFrameHeaderBytes)) == bytes);
+    };
+    for (std::size_t i = 0; i < ticks; ++i) {
+        DebugRecord r = syntheticTick(i);
+        if (times != nullptr) {
+            r.t = Time{times(i)};
+        }
+        frame(bb::FrameType::Tick, bb::kTickPayloadBytes,
+              [&](std::span<std::byte> out) { return bb::encodeTick(out, r); });
+        if (i % 7 == 6) {
+            r.hasEstimatorInputs = true;
+            frame(bb::FrameType::EstimatorInputs, bb::kEstimatorInputsPayloadBytes,
+                  [&](std::span<std::byte> out) { return bb::encodeEstimatorInputs(out, r); });
+        }
+    }
+    return file;
+}
+
+/// Every tick the sequential reader delivers, in order.
+std::vector<DebugRecord> sequentialTicks(std::span<const std::byte> file) {
+    std::vector<DebugRecord> out;
+    bb::BlackboxReader reader{file};
+    bb::BlackboxReader::Frame frame;
+    bool corrupt = false;
+    while (reader.next(frame)) {
+        DebugRecord r;
+        if (reader.readTick(frame, r, corrupt)) {
+            out.push_back(r);
+        }
+    }
+    return out;
+}
+
+/// The v1 bytes of a record — "the same tick" compared as the file compares it.
+std::vector<std::byte> rowOf(const DebugRecord& r) {
+    std::vector<std::byte> row(bb::kTickPayloadBytes);
+    REQUIRE(bb::encodeTick(row, r) == bb::kTickPayloadBytes);
+    return row;
+}
+
+/// A scratch path under the system temp directory, removed when it goes out of scope.
+struct TempPath {
+    std::filesystem::path path;
+    explicit TempPath(const char* name)
+        : path{std::filesystem::temp_directory_path() / name} {}
+    ~TempPath() {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+};
+
+}  // namespace
+
+// Would catch: seekTime() as an upper bound or an exact-match search, seekCommand()
+// returning the LAST tick of a command, or treating id 0 as a command.
+TEST_CASE("blackbox index: seeks by time and by command id") {
+    const std::vector<std::byte> file = v1File(1000);
+    const BlackboxIndex index{file};
+    REQUIRE(index.status() == bb::ReadStatus::Ok);
+    REQUIRE(index.size() == 1000);
+    CHECK_FALSE(index.compact());
+    CHECK(index.timeOrdered());
+
+    CHECK(index.seekTime(Time{0.0}) == 0);
+    CHECK(index.seekTime(Time{0.01 * 250.0}) == 250);
+    CHECK(index.seekTime(Time{0.01 * 250.0 + 0.004}) == 251);  // between ticks: the next
+    CHECK(index.seekTime(Time{100.0}) == BlackboxIndex::npos);
+
+    CHECK(index.seekCommand(1) == 100);
+    CHECK(index.seekCommand(7) == 700);
+    CHECK(index.seekCommand(0) == BlackboxIndex::npos);
+    CHECK(index.seekCommand(42) == BlackboxIndex::npos);
+
+    DebugRecord r;
+    REQUIRE(index.readTick(700, r));
+    CHECK(r.activeCommandId == 7);
+    CHECK(rowOf(r) == rowOf(syntheticTick(700)));
+    CHECK_FALSE(index.readTick(1000, r));
+}
+
+// Would catch: a binary search over times that go backwards — the dumped ring after a
+// streamed run repeats earlier times, and lower_bound over that is not a seek.
+TEST_CASE("blackbox index: a file whose times go backwards still seeks") {
+    const std::vector<std::byte> file = v1File(
+        300, [](std::size_t i) { return i < 200 ? 0.01 * static_cast<double>(i)
+                                                : 0.01 * static_cast<double>(i - 150); });
+    const BlackboxIndex index{file};
+    REQUIRE(index.size() == 300);
+    CHECK_FALSE(index.timeOrdered());
+    CHECK(index.seekTime(Time{1.0}) == 100);       // the first tick at or after 1.0 s
+    CHECK(index.seekTime(Time{1.995}) == BlackboxIndex::npos);
+}
+
+// Would catch: a compact readTick() that replays from the wrong keyframe, stops at an
+// interleaved inputs frame, or rebuilds against a stale reference row.
+TEST_CASE("blackbox index: random access equals the sequential read, v1 and compact") {
+    for (const bool compact : {false, true}) {
+        CAPTURE(compact);
+        FakeClock clock;
+        FakeBlockSink device;
+        std::vector<DebugRecord> ring(16);
+        std::vector<std::byte> buffer(16384);
+        SdSink sink{device, clock, SdSinkStorage{ring, buffer},
+                    SdSinkConfig{.streamTicks = true, .compactTicks = compact,
+                                 .keyframeInterval = 20, .recordEstimatorInputs = true}};
+        sink.open({});
+        for (std::size_t i = 0; i < 500; ++i) {
+            DebugRecord r = syntheticTick(i);
+            r.hasEstimatorInputs = (i % 3) == 0;  // interleaved non-tick frames
+            sink.emit(r);
+            (void)sink.flush();
+        }
+        sink.close();
+
+        const std::vector<DebugRecord> seq = sequentialTicks(device.view());
+        const BlackboxIndex index{device.view()};
+        REQUIRE(index.status() == bb::ReadStatus::Ok);
+        CHECK(index.compact() == compact);
+        REQUIRE(index.size() == seq.size());
+        REQUIRE(seq.size() == 500);
+        for (const std::size_t i : {std::size_t{0}, std::size_t{19}, std::size_t{20},
+                                    std::size_t{21}, std::size_t{333}, std::size_t{499}}) {
+            CAPTURE(i);
+            DebugRecord r;
+            REQUIRE(index.readTick(i, r));
+            CHECK(rowOf(r) == rowOf(seq[i]));
+        }
+        CHECK(index.seekCommand(4) == 400);
+
+        const TickColumns cols = shulib::sim::gatherColumns(index);
+        REQUIRE(cols.rows() == 500);
+        for (std::size_t i = 0; i < seq.size(); ++i) {
+            REQUIRE(cols.column("measuredX")[i] == seq[i].measuredPose.x().value());
+            REQUIRE(cols.column("activeCommandId")[i] == seq[i].activeCommandId);
+        }
+    }
+}
+
+// Would catch: a column table out of step with the layout (a field read at a neighbour's
+// offset), a CSV that loses precision, or a columnar file that copies when it claims not
+// to.
+TEST_CASE("columns: each field lands in its column, through CSV and a mapped columnar file") {
+    const std::vector<std::byte> file = v1File(250);
+    const BlackboxIndex index{file};
+    const TickColumns cols = shulib::sim::gatherColumns(index);
+    REQUIRE(cols.rows() == 250);
+    for (std::size_t i = 0; i < 250; ++i) {
+        const DebugRecord r = syntheticTick(i);
+        REQUIRE(cols.column("t")[i] == r.t.value());
+        REQUIRE(cols.column("measuredY")[i] == r.measuredPose.y().value());
+        REQUIRE(cols.column("measuredHeading")[i] == r.measuredPose.heading().radians());
+        REQUIRE(cols.column("wheelCount")[i] == 4.0);
+        REQUIRE(cols.column("wheelVoltage2")[i] == r.wheelVoltage[2].value());
+        REQUIRE(cols.column("quality")[i] == r.quality);
+        REQUIRE(cols.column("droppedLines")[i] == static_cast<double>(r.droppedLines));
+        REQUIRE(cols.column("tickPhase7")[i] == 0.0);
+    }
+    CHECK(cols.column("noSuchField").empty());
+
+    SUBCASE("CSV: a header of names, then every value at round-trip precision") {
+        std::FILE* f = std::tmpfile();
+        REQUIRE(f != nullptr);
+        REQUIRE(shulib::sim::writeCsv(f, cols));
+        std::rewind(f);
+        std::string text;
+        for (int ch = std::fgetc(f); ch != EOF; ch = std::fgetc(f)) {
+            text.push_back(static_cast<char>(ch));
+        }
+        std::fclose(f);
+        CHECK(text.rfind("t,dt,targetX,", 0) == 0);
+        std::size_t lines = 0;
+        for (const char ch : text) {
+            lines += ch == '\n' ? 1U : 0U;
+        }
+        CHECK(lines == 251);
+        CHECK(text.find("\n1.2,0.01,") != std::string::npos);  // tick 120's t and dt
+    }
+
+    SUBCASE("columnar: written, mapped back, and read in place") {
+        const TempPath tmp{"shulib_blackbox_index_test.col"};
+        std::FILE* f = std::fopen(tmp.path.c_str(), "wb");
+        REQUIRE(f != nullptr);
+        REQUIRE(shulib::sim::writeColumnar(f, cols));
+        std::fclose(f);
+
+        const MappedFile mapped{tmp.path.c_str()};
+        REQUIRE(mapped.ok());
+        const ColumnarView view{mapped.bytes()};
+        REQUIRE(view.ok());
+        CHECK(view.rows() == 250);
+        REQUIRE(view.columns() == kTickColumns.size());
+        CHECK(view.name(0) == "t");
+        CHECK(view.name(46) == "gateResidualHeading");
+        for (std::size_t c = 0; c < view.columns(); ++c) {
+            const std::span<const double> col = view.column(c);
+            REQUIRE(col.size() == 250);
+            REQUIRE(std::memcmp(col.data(), cols.column(c).data(), 250 * sizeof(double)) == 0);
+        }
+        if (mapped.mapped()) {
+            // Zero copy: the column IS the mapping.
+            const auto* lo = mapped.bytes().data();
+            const auto* p = reinterpret_cast<const std::byte*>(view.column("quality").data());
+            CHECK(p >= lo);
+            CHECK(p < lo + mapped.bytes().size());
+        }
+
+        // A misaligned buffer is refused, not quietly copied.
+        std::vector<std::byte> shifted(mapped.bytes().size() + 1);
+        std::memcpy(shifted.data() + 1, mapped.bytes().data(), mapped.bytes().size());
+        CHECK_FALSE(ColumnarView{std::span<const std::byte>{shifted}.subspan(1)}.ok());
+    }
+}
+
+// Would catch: the indexer or the gather regressing to a DebugRecord per tick or an
+// allocation per frame. Measured and REPORTED; the floor is an order of magnitude under
+// what an unoptimised build achieves, so only a structural regression trips it.
+TEST_CASE("blackbox index: one-pass index and column gather throughput (measured)") {
+    const std::vector<std::byte> file = v1File(48000);  // ≈ 21 MB
+    const TempPath tmp{"shulib_blackbox_index_bench.bin"};
+    {
+        std::FILE* f = std::fopen(tmp.path.c_str(), "wb");
+        REQUIRE(f != nullptr);
+        REQUIRE(std::fwrite(file.data(), 1, file.size(), f) == file.size());
+        std::fclose(f);
+    }
+    const MappedFile mapped{tmp.path.c_str()};
+    REQUIRE(mapped.ok());
+    REQUIRE(mapped.bytes().size() == file.size());
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const BlackboxIndex index{mapped.bytes()};
+    const auto t1 = std::chrono::steady_clock::now();
+    const TickColumns cols = shulib::sim::gatherColumns(index);
+    const auto t2 = std::chrono::steady_clock::now();
+    REQUIRE(index.size() == 48000);
+    REQUIRE(cols.rows() == 48000);
+    CHECK(cols.column("t")[47999] == doctest::Approx(479.99));
+
+    const double gb = static_cast<double>(file.size()) / 1e9;
+    const double indexS = std::chrono::duration<double>(t1 - t0).count();
+    const double gatherS = std::chrono::duration<double>(t2 - t1).count();
+    MESSAGE("blackbox index over " << file.size() / 1000000 << " MB (mmap="
+            << std::string{mapped.mapped() ? "yes" : "no"} << "): index " << gb / indexS
+            << " GB/s, index+61-column gather " << gb / (indexS + gatherS) << " GB/s");
+    CHECK(gb / (indexS + gatherS) > 0.01);
+}
@@ -375,7 +375,12 @@ TEST_CASE("introspection: a real fault reaches the record, and the flight record
     CHECK(faultTick.dt.value() > 0.1);  // the overrun is visible in the record itself
 
     int history = 0;
+    int inputs = 0;
     while (reader.next(frame)) {
+        if (frame.type == bb::FrameType::EstimatorInputs) {
+            ++inputs;
+            continue;
+        }
         CHECK(frame.type == bb::FrameType::Tick);
         DebugRecord r;
         REQUIRE(bb::decodeTick(frame.payload, r, corrupt));
@@ -383,6 +388,7 @@ TEST_CASE("introspection: a real fault reaches the record, and the flight record
         ++history;
     }
     CHECK(history == 4);
+    CHECK(inputs == 0);  // stamped by the scheduler, but recordEstimatorInputs is opt-in
 }
 
 // Would catch: D-7's post-run triage never reaching the terminal, or reaching it on a
@@ -5,6 +5,7 @@
 
 #include "doctest.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "motion_test_rig.hpp"
@@ -330,3 +331,95 @@ TEST_CASE("C4 conflict: verb → opposite drive() → verb, back to back, stays
     CHECK(c.chassis.scheduler().motionsSettled() == 2);
     CHECK(c.chassis.scheduler().motionsCancelled() == 0);  // nothing was pre-empted
 }
+
+// Bug caught: drive()'s inner wheel loop carrying one stream's integrators into the next.
+// A heavy drive winds the integrators up over a teleop stretch; after a motion has had the
+// drivetrain (a blocking verb, or one started on the scheduler directly), the next drive() must start the loop from
+// zero. With kP = 0 the first command after the motion is the feedforward plus whatever the
+// integrators still hold — and a zero command at rest has a zero feedforward.
+TEST_CASE("C4 drive stream: a motion in between resets drive()'s wheel loop") {
+    const auto kin = xDrive(Length{7.0});
+    auto pcfg = plantConfig();
+    pcfg.plant.wheelFf.kV *= 1.25;  // the drive the feedforward under-drives
+    auto ccfg = chassisConfig();
+    ccfg.motion.wheelLoop.enabled = true;
+    ccfg.motion.wheelLoop.kP = 0.0;
+    const ChassisSpeeds forward{Velocity{30.0}, Velocity{0.0}, AngularVelocity{0.0}};
+    const ChassisSpeeds still{Velocity{0.0}, Velocity{0.0}, AngularVelocity{0.0}};
+
+    const auto maxVolts = [](ChassisRig& c) {
+        double v = 0.0;
+        for (int w = 0; w < c.rig.h.motorCount(); ++w) {
+            v = std::max(v, std::abs(c.rig.h.motor(w).commandedVoltage().value()));
+        }
+        return v;
+    };
+    const auto windUp = [&](ChassisRig& c) {
+        for (int i = 0; i < 100; ++i) {
+            c.chassis.drive(forward, Frame::Body);
+            c.pacer.pace();
+        }
+    };
+
+    SUBCASE("after a blocking verb") {
+        ChassisRig c{kin, pcfg, nullptr, nullptr, ccfg};
+        windUp(c);
+        REQUIRE(c.chassis.turnTo(Angle::degrees(30.0), {.timeout = Time{4.0}})
+                == ExitReason::Settled);
+        c.chassis.drive(still, Frame::Body);
+        CHECK(maxVolts(c) < 0.05);
+    }
+    SUBCASE("after a motion started on the scheduler, past the facade's verbs") {
+        ChassisRig c{kin, pcfg, nullptr, nullptr, ccfg};
+        windUp(c);
+        MoveToPose m{c.chassis.deps(), c.rig.h.truePose(), motionConfig(), 4.0};
+        c.chassis.scheduler().async(m);
+        for (int i = 0; i < 400 && c.chassis.scheduler().hasActiveMotion(); ++i) {
+            (void)c.chassis.scheduler().tick();
+            c.pacer.pace();
+        }
+        REQUIRE(c.chassis.lastCompleted().exit == ExitReason::Settled);
+        c.chassis.drive(still, Frame::Body);
+        CHECK(maxVolts(c) < 0.05);
+    }
+}
+
+// Bug caught: drive()'s rate limiter ramping from the previous stream's output. A motion
+// shorter than the limiter's gap (kMaxLimitDt) leaves no gap to re-seed on, so without a
+// reset the first drive() after it "continues" the old cruise: the limiter's last output
+// already equals the target, and the robot the motion just stopped is commanded straight
+// back to full speed. Re-seeded, it accelerates from what the robot is measured doing.
+TEST_CASE("C4 drive stream: a motion shorter than the limiter's gap re-seeds drive()'s "
+          "limiter") {
+    const auto kin = xDrive(Length{7.0});
+    auto ccfg = chassisConfig();
+    ccfg.motion.limiter.enabled = true;
+    ChassisRig c{kin, plantConfig(), nullptr, nullptr, ccfg};
+    const ChassisSpeeds cruise{Velocity{40.0}, Velocity{0.0}, AngularVelocity{0.0}};
+    for (int i = 0; i < 150; ++i) {  // 1.5 s: the limiter has long reached the target
+        c.chassis.drive(cruise, Frame::Body);
+        c.pacer.pace();
+    }
+
+    // A 40 ms hold at the current pose: the motion brakes the robot to a crawl.
+    MoveToPose hold{c.chassis.deps(), c.rig.h.truePose(), motionConfig(), 4.0};
+    c.chassis.scheduler().async(hold);
+    for (int i = 0; i < 4; ++i) {
+        (void)c.chassis.scheduler().tick();
+        c.pacer.pace();
+    }
+    REQUIRE(c.chassis.scheduler().hasActiveMotion());
+    const auto speed = [&c] {
+        const double x0 = c.rig.h.truePose().x().value();
+        c.pacer.pace();
+        return (c.rig.h.truePose().x().value() - x0) / 0.01;
+    };
+    const double braked = speed();
+    REQUIRE(braked < 20.0);
+
+    c.chassis.drive(cruise, Frame::Body);  // pre-empts the hold: a new stream
+    const double resumed = speed();
+    // One 10 ms tick under the limiter's 100 in/s² (and its jerk ramp) adds at most 1 in/s
+    // to the measured speed; the stale output would have been the full 40.
+    CHECK(resumed < braked + 5.0);
+}
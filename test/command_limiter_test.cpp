@@ -0,0 +1,319 @@
+// Tests for motion/command_limiter.hpp and its seat at step 4' of the command pipeline. What
+// each targets:
+//  * THE PASS-THROUGH: disabled, limit() returns its target bit for bit and keeps no state.
+//  * THE LIMITS: per-axis acceleration, the jerk ramp on its onset, and the per-wheel limit,
+//    all applied as ONE uniform scale on the tick's change — direction kept, budgets kept.
+//  * THE SEED: the first tick, and the tick after a gap, command the MEASURED motion
+//    (clamped into the budgets), not a stale command and not rest.
+//  * TRACTION CONTROL: spin outrunning motion halves every limit; the scale climbs back.
+//  * THE POINT, closed-loop: under the A3 slip model, a limited MoveToPose never breaks
+//    traction, where the unlimited one slips on every launch; and a slip window it did not
+//    cause halves its wheel acceleration until the window ends.
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "motion_test_rig.hpp"
+#include "shulib/core/check.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/motion/command_limiter.hpp"
+#include "shulib/motion/move_to_pose.hpp"
+#include "shulib/sim/hostile/slip_hostility.hpp"
+#include "shulib/units/quantity.hpp"
+
+using namespace motion_rig;
+using shulib::PreconditionError;
+using shulib::control::ExitReason;
+using shulib::hal::fake::FakeClock;
+using shulib::kinematics::xDrive;
+using shulib::math::Angle;
+using shulib::math::ChassisSpeeds;
+using shulib::math::Pose2d;
+using shulib::motion::CommandLimiter;
+using shulib::motion::CommandLimiterConfig;
+using shulib::motion::LimiterBudget;
+using shulib::motion::LimiterObservation;
+using shulib::motion::MoveToPose;
+using shulib::units::AngularVelocity;
+using shulib::units::Velocity;
+
+namespace {
+ChassisSpeeds cs(double vx, double vy, double w) {
+    return ChassisSpeeds{Velocity{vx}, Velocity{vy}, AngularVelocity{w}};
+}
+
+constexpr LimiterBudget kBudget{.maxLinear = 60.0, .maxStrafe = 60.0, .maxAngular = 6.0};
+
+/// Enabled, with the per-wheel limit and the jerk ramp out of the way unless a case wants them.
+CommandLimiterConfig axisOnly() {
+    CommandLimiterConfig c;
+    c.enabled = true;
+    c.maxWheelAccel = shulib::units::Acceleration{1.0e6};
+    c.jerkTime = 0.0;
+    return c;
+}
+
+/// Observation of a robot genuinely doing `v` (spin == motion: no slip).
+LimiterObservation moving(const ChassisSpeeds& v) { return {.spin = v, .motion = v}; }
+}  // namespace
+
+// Bug caught: a disabled limiter that still perturbs the command (every bit-identity suite
+// would move), or one that keeps state and ramps from a stale command once enabled.
+TEST_CASE("CommandLimiter: disabled is a bit-identical pass-through") {
+    FakeClock clock;
+    const auto kin = xDrive(Length{7.0});
+    CommandLimiter lim{CommandLimiterConfig{}, clock, Length{7.0}};
+    const ChassisSpeeds target = cs(59.999999999999993, -0.1, 5.9);
+    const LimiterObservation garbage{
+        .spin = cs(std::numeric_limits<double>::quiet_NaN(), 0.0, 0.0), .motion = cs(0, 0, 0)};
+    for (int i = 0; i < 3; ++i) {
+        const ChassisSpeeds out = lim.limit(target, garbage, kin, kBudget);
+        CHECK(out.vx().value() == target.vx().value());
+        CHECK(out.vy().value() == target.vy().value());
+        CHECK(out.omega().value() == target.omega().value());
+        clock.advance(Time{0.01});
+    }
+    CHECK_FALSE(lim.bound());
+    CHECK_FALSE(lim.slipping());
+}
+
+// Bug caught: a ramp that starts from zero while the robot is already moving (a chained
+// motion brakes for no reason), or a seed that escapes the budgets and trips the D-5 audit.
+TEST_CASE("CommandLimiter: the first tick and a gap re-seed from measured motion, clamped") {
+    FakeClock clock;
+    const auto kin = xDrive(Length{7.0});
+    CommandLimiter lim{axisOnly(), clock, Length{7.0}};
+    ChassisSpeeds out = lim.limit(cs(60, 0, 0), moving(cs(30, 0, 0)), kin, kBudget);
+    CHECK(out.vx().value() == 30.0);  // held at what the robot does
+
+    clock.advance(Time{0.01});
+    out = lim.limit(cs(60, 0, 0), moving(cs(30, 0, 0)), kin, kBudget);
+    CHECK(out.vx().value() == doctest::Approx(31.0));  // then ramps at 100 in/s²
+
+    clock.advance(Time{0.5});  // a gap: re-seed, from a robot pushed past every budget
+    out = lim.limit(cs(60, 0, 0), moving(cs(80, 80, 9)), kin, LimiterBudget{60.0, 20.0, 6.0});
+    CHECK(std::hypot(out.vx().value(), out.vy().value()) <= 60.0 + 1e-9);
+    CHECK(std::abs(out.vy().value()) <= 20.0);
+    CHECK(out.omega().value() == 6.0);
+}
+
+// Bug caught: per-axis limits applied independently — a diagonal ramp then bends (the slower
+// axis finishes later) and can leave the norm cap. One scale keeps the change's direction.
+TEST_CASE("CommandLimiter: per-axis limits scale the change uniformly — direction and norm kept") {
+    FakeClock clock;
+    const auto kin = xDrive(Length{7.0});
+    CommandLimiter lim{axisOnly(), clock, Length{7.0}};
+    (void)lim.limit(cs(0, 0, 0), moving(cs(0, 0, 0)), kin, kBudget);
+    const ChassisSpeeds target = cs(30.0, 40.0, 0.0);  // |v| = 50
+    for (int i = 0; i < 200; ++i) {
+        clock.advance(Time{0.01});
+        const ChassisSpeeds out = lim.limit(target, moving(cs(0, 0, 0)), kin, kBudget);
+        CHECK(out.vy().value() == doctest::Approx(out.vx().value() * 40.0 / 30.0));
+        CHECK(std::hypot(out.vx().value(), out.vy().value()) <= 50.0 + 1e-9);
+        if (i == 0) {
+            CHECK(lim.bound());
+            CHECK(out.vy().value() == doctest::Approx(0.6));  // strafe (60 in/s²) binds
+        }
+    }
+    clock.advance(Time{0.01});
+    const ChassisSpeeds done = lim.limit(target, moving(cs(0, 0, 0)), kin, kBudget);
+    CHECK(done.vx().value() == 30.0);  // arrives exactly, then passes through
+    CHECK_FALSE(lim.bound());
+    const ChassisSpeeds again = lim.limit(cs(0, 0, 0), moving(cs(0, 0, 0)), kin, kBudget);
+    CHECK(again.vx().value() == 30.0);  // same instant: nothing may change
+}
+
+// Bug caught: a jerk limit that never releases, or a step in acceleration it should ramp.
+TEST_CASE("CommandLimiter: the jerk ramp bounds the onset of acceleration") {
+    FakeClock clock;
+    const auto kin = xDrive(Length{7.0});
+    CommandLimiterConfig cfg = axisOnly();
+    cfg.jerkTime = 0.05;  // 100 in/s² reached over 50 ms
+    CommandLimiter lim{cfg, clock, Length{7.0}};
+    double v = lim.limit(cs(60, 0, 0), moving(cs(0, 0, 0)), kin, kBudget).vx().value();
+    double expectedA = 0.0;
+    for (int i = 0; i < 10; ++i) {
+        clock.advance(Time{0.01});
+        const double next = lim.limit(cs(60, 0, 0), moving(cs(0, 0, 0)), kin, kBudget).vx().value();
+        expectedA = std::min(100.0, expectedA + 20.0);
+        CHECK((next - v) / 0.01 == doctest::Approx(expectedA));
+        v = next;
+    }
+}
+
+// Bug caught: a body limit that lets a spin-in-place launch past the traction threshold —
+// on an X-drive every wheel carries ω·r, so the per-WHEEL limit must bind first.
+TEST_CASE("CommandLimiter: the per-wheel limit binds a rotation the axis limits allow") {
+    FakeClock clock;
+    const auto kin = xDrive(Length{7.0});
+    CommandLimiterConfig cfg;
+    cfg.enabled = true;
+    cfg.jerkTime = 0.0;
+    CommandLimiter lim{cfg, clock, Length{7.0}};
+    ChassisSpeeds prev = lim.limit(cs(0, 0, 6), moving(cs(0, 0, 0)), kin, kBudget);
+    for (int i = 0; i < 50; ++i) {
+        clock.advance(Time{0.01});
+        const ChassisSpeeds out = lim.limit(cs(0, 0, 6), moving(cs(0, 0, 0)), kin, kBudget);
+        const auto w0 = kin.toWheels(prev);
+        const auto w1 = kin.toWheels(out);
+        for (int k = 0; k < w1.size(); ++k) {
+            CHECK(std::abs(w1[k].value() - w0[k].value()) / 0.01 <= 70.0 + 1e-6);
+        }
+        prev = out;
+    }
+    CHECK(prev.omega().value() < 12.0 * 0.5);  // slower than the 12 rad/s² axis limit
+}
+
+// Bug caught: traction control that never engages, never releases, or judges slip from two
+// noise-level speeds at a standstill.
+TEST_CASE("CommandLimiter: spin outrunning motion halves every limit, then recovers") {
+    FakeClock clock;
+    const auto kin = xDrive(Length{7.0});
+    CommandLimiter lim{axisOnly(), clock, Length{7.0}};
+    (void)lim.limit(cs(0, 0, 0), moving(cs(0, 0, 0)), kin, kBudget);
+
+    const LimiterObservation slipping{.spin = cs(40, 0, 0), .motion = cs(20, 0, 0)};
+    clock.advance(Time{0.01});
+    ChassisSpeeds a = lim.limit(cs(60, 0, 0), slipping, kin, kBudget);
+    CHECK(lim.slipping());
+    CHECK(lim.slipRatio() == doctest::Approx(0.5));
+    CHECK(lim.limitScale() == 0.5);
+    CHECK(a.vx().value() == doctest::Approx(0.5));  // 50 in/s² for this tick
+
+    for (int i = 0; i < 25; ++i) {  // 0.25 s clean: halfway back
+        clock.advance(Time{0.01});
+        a = lim.limit(cs(60, 0, 0), moving(cs(20, 0, 0)), kin, kBudget);
+    }
+    CHECK_FALSE(lim.slipping());
+    CHECK(lim.limitScale() == doctest::Approx(0.75));
+    for (int i = 0; i < 30; ++i) {
+        clock.advance(Time{0.01});
+        (void)lim.limit(cs(60, 0, 0), moving(cs(20, 0, 0)), kin, kBudget);
+    }
+    CHECK(lim.limitScale() == 1.0);
+
+    const LimiterObservation crawl{.spin = cs(3, 0, 0), .motion = cs(0, 0, 0)};
+    clock.advance(Time{0.01});
+    (void)lim.limit(cs(60, 0, 0), crawl, kin, kBudget);
+    CHECK_FALSE(lim.slipping());  // below slipMinSpeed: no verdict
+    CHECK(lim.slipRatio() == 0.0);
+}
+
+// Bug caught: limits that cannot work, accepted quietly.
+TEST_CASE("CommandLimiter: configuration preconditions are loud") {
+    FakeClock clock;
+    CommandLimiterConfig zero;
+    zero.maxAccelX = shulib::units::Acceleration{0.0};
+    CHECK_THROWS_AS((CommandLimiter{zero, clock, Length{7.0}}), PreconditionError);
+    CommandLimiterConfig ratio;
+    ratio.slipThreshold = 1.0;
+    CHECK_THROWS_AS((CommandLimiter{ratio, clock, Length{7.0}}), PreconditionError);
+    CommandLimiterConfig scale;
+    scale.slipLimitScale = 0.0;
+    CHECK_THROWS_AS((CommandLimiter{scale, clock, Length{7.0}}), PreconditionError);
+    CommandLimiterConfig jerk;
+    jerk.jerkTime = -0.1;
+    CHECK_THROWS_AS((CommandLimiter{jerk, clock, Length{7.0}}), PreconditionError);
+    CHECK_THROWS_AS((CommandLimiter{CommandLimiterConfig{}, clock, Length{0.0}}),
+                    PreconditionError);
+}
+
+namespace {
+struct LaunchResult {
+    ExitReason reason = ExitReason::Running;
+    int slipTicks = 0;       ///< ticks on which some wheel's spin accelerated past HA-37
+    double peakAccel = 0.0;  ///< worst per-wheel spin acceleration (in/s²)
+    double posMiss = 0.0;
+};
+
+/// One MoveToPose under `slip`, tick by tick, watching the plant's TRUE wheel spin for the
+/// acceleration the slip model breaks traction at.
+LaunchResult runLaunch(bool limited, const Pose2d& target, shulib::sim::SlipHostileModel& slip) {
+    const auto kin = xDrive(Length{7.0});
+    MotionRig rig{kin, plantConfig(), nullptr, &slip};
+    auto cfg = motionConfig();
+    cfg.limiter.enabled = limited;
+    MoveToPose m{rig.deps, target, cfg, 8.0};
+    m.start();
+    LaunchResult out;
+    auto prev = rig.h.plant().trueWheelSpin();
+    for (int t = 0; t < 1000 && out.reason == ExitReason::Running; ++t) {
+        out.reason = rig.resume(m, 1);
+        const auto cur = rig.h.plant().trueWheelSpin();
+        double worst = 0.0;
+        for (int i = 0; i < cur.size(); ++i) {
+            worst = std::max(worst, std::abs(cur[i].value() - prev[i].value()) / 0.01);
+        }
+        out.peakAccel = std::max(out.peakAccel, worst);
+        out.slipTicks += worst > shulib::sim::SlipHostileConfig{}.accelThresholdInPerS2 ? 1 : 0;
+        prev = cur;
+    }
+    out.posMiss = posErr(rig.h.truePose(), target);
+    return out;
+}
+}  // namespace
+
+// Bug caught: a limiter that does not reach the wheels (limits the body but not what the
+// slip model sees), or one whose slower ramps cost the motion its settle.
+TEST_CASE("CommandLimiter: closed-loop launches never break traction under the A3 slip model") {
+    const Pose2d targets[] = {Pose2d{Length{36.0}, Length{0.0}, Angle{}},
+                              Pose2d{Length{20.0}, Length{-24.0}, Angle::degrees(60.0)},
+                              Pose2d{Length{-18.0}, Length{30.0}, Angle::degrees(-120.0)},
+                              Pose2d{Length{0.0}, Length{0.0}, Angle::degrees(90.0)}};
+    for (const Pose2d& target : targets) {
+        CAPTURE(target.x().value());
+        CAPTURE(target.heading().degrees());
+        shulib::sim::SlipHostileModel slipOpen;
+        shulib::sim::SlipHostileModel slipLimited;
+        const LaunchResult open = runLaunch(false, target, slipOpen);
+        const LaunchResult limited = runLaunch(true, target, slipLimited);
+        MESSAGE("slip ticks: open " << open.slipTicks << " (peak " << open.peakAccel
+                                    << " in/s²), limited " << limited.slipTicks << " (peak "
+                                    << limited.peakAccel << ")");
+        CHECK(open.slipTicks > 0);
+        CHECK(limited.slipTicks == 0);
+        CHECK(limited.peakAccel <= 70.0 + 1e-6);
+        CHECK(limited.reason == ExitReason::Settled);
+        CHECK(limited.posMiss < 0.5);
+    }
+}
+
+// Bug caught: traction control that reads the wrong signals through the pipeline. A slip
+// window the limiter did not cause (retain 0.4 from 0.3 s to 0.8 s) must drop the wheels'
+// acceleration to half the limit while it lasts, and the full limit must come back after.
+TEST_CASE("CommandLimiter: a slip window halves the launch ramp through the pipeline") {
+    shulib::sim::SlipHostileConfig sc;
+    sc.windows.push_back(shulib::sim::SlipWindow{Time{0.3}, Time{0.8}, 0.4, 0});
+    shulib::sim::SlipHostileModel slip{sc};
+    const auto kin = xDrive(Length{7.0});
+    MotionRig rig{kin, plantConfig(), nullptr, &slip};
+    auto cfg = motionConfig();
+    cfg.limiter.enabled = true;
+    const Pose2d target{Length{60.0}, Length{0.0}, Angle{}};
+    MoveToPose m{rig.deps, target, cfg, 8.0};
+    m.start();
+    auto prev = rig.h.plant().trueWheelSpin();
+    double peakBefore = 0.0;
+    double peakInside = 0.0;
+    auto reason = ExitReason::Running;
+    for (int t = 0; t < 1000 && reason == ExitReason::Running; ++t) {
+        reason = rig.resume(m, 1);
+        const double now = rig.h.clock().now().value();
+        const auto cur = rig.h.plant().trueWheelSpin();
+        const double a = std::abs(cur[0].value() - prev[0].value()) / 0.01;
+        if (now < 0.3) {
+            peakBefore = std::max(peakBefore, a);
+        } else if (now > 0.35 && now < 0.8) {  // one tick for the estimate to see it
+            peakInside = std::max(peakInside, a);
+        }
+        prev = cur;
+    }
+    CHECK(reason == ExitReason::Settled);
+    CHECK(peakBefore == doctest::Approx(70.0));
+    CHECK(peakInside <= 35.0 + 1e-6);
+    CHECK(posErr(rig.h.truePose(), target) < 0.5);
+}
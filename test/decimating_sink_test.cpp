@@ -0,0 +1,263 @@
+// Tests for diag/decimating_sink.hpp — every Nth record, and every boundary. What each
+// targets:
+//  * THE RULE: the periodic samples land where the interval says, the interval restarts
+//    at a boundary, and a key change in either direction forces its record through —
+//    the fault tick AND the tick after it. A watch mask of 0 is plain decimation.
+//  * JITTER: timestamps wandering by less than a quarter period still give exactly one
+//    record per N ticks — counted on the clock, not by calls, and not fooled by it.
+//  * THE COST CONTRACT: with a probe, a skipped tick does not build its record at all —
+//    the builder runs exactly as often as a record is forwarded; without one, every
+//    record is built and the skipped ones are counted.
+//  * IN THE LOOP: a scheduled run through MotionScheduler's own probe forwards every
+//    boundary the full-rate stream contains, at a fraction of the records, and builds
+//    none it then throws away.
+
+#include "doctest.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "motion_test_rig.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/decimating_sink.hpp"
+#include "shulib/diag/fault.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/hal/fake/fake_telemetry_sink.hpp"
+#include "shulib/hal/null_sink.hpp"
+#include "shulib/hal/telemetry_sink.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/motion/motion_scheduler.hpp"
+#include "shulib/motion/move_to_pose.hpp"
+#include "shulib/motion/turn_to.hpp"
+#include "shulib/units/quantity.hpp"
+
+using namespace motion_rig;
+using shulib::PreconditionError;
+using shulib::diag::DebugRecord;
+using shulib::diag::DecimatingSink;
+using shulib::diag::DecimationConfig;
+using shulib::diag::FaultCode;
+using shulib::diag::IRecordKeyProbe;
+using shulib::diag::RecordKeys;
+using shulib::hal::emitRecord;
+using shulib::hal::LogLevel;
+using shulib::hal::fake::FakeClock;
+using shulib::hal::fake::FakeTelemetrySink;
+using shulib::kinematics::xDrive;
+using shulib::math::Angle;
+using shulib::math::Pose2d;
+using shulib::motion::MoveToPose;
+using shulib::motion::TurnTo;
+using shulib::units::Length;
+using shulib::units::Time;
+
+namespace {
+
+/// The test's world: one command change at tick 37 and a fault raised on tick 55.
+DebugRecord scripted(int i) {
+    DebugRecord r;
+    r.t = Time{0.01 * i};
+    r.activeCommandId = i >= 37 ? 2U : 1U;
+    r.fault = i == 55 ? FaultCode::ImuLost : FaultCode::None;
+    return r;
+}
+
+/// A probe that reports what scripted() will produce for the current tick.
+struct ScriptedProbe final : IRecordKeyProbe {
+    [[nodiscard]] RecordKeys peek() const noexcept override {
+        return shulib::diag::recordKeys(scripted(tick));
+    }
+    int tick = 0;
+};
+
+/// The tick index of every record `sink` received.
+std::vector<int> ticksOf(const FakeTelemetrySink& sink) {
+    std::vector<int> out;
+    for (int i = 0; i < sink.recordCount(); ++i) {
+        out.push_back(static_cast<int>(std::lround(sink.recordAt(i).t.value() / 0.01)));
+    }
+    return out;
+}
+
+/// Forwards everything to a target attached after construction — the harness needs its
+/// sink before the clock the decimator needs exists. While `muted`, records are neither
+/// wanted nor forwarded: the plant's own per-step truth record rides the same sink, and
+/// on a robot there is no such record.
+struct Relay final : shulib::hal::ITelemetrySink {
+    void log(LogLevel level, std::string_view tag, std::string_view msg) override {
+        target->log(level, tag, msg);
+    }
+    [[nodiscard]] bool wantsRecord() const noexcept override {
+        return !muted && target->wantsRecord();
+    }
+    void emit(const DebugRecord& r) override {
+        if (!muted) {
+            target->emit(r);
+        }
+    }
+    shulib::hal::ITelemetrySink* target = nullptr;
+    bool muted = false;
+};
+
+/// PlantPacer with the relay muted while the plant steps.
+struct MutingPacer final : shulib::motion::ITickPacer {
+    MutingPacer(shulib::sim::SimHarness& h, Relay& r) : inner{h}, relay{&r} {}
+    void pace() override {
+        relay->muted = true;
+        inner.pace();
+        relay->muted = false;
+    }
+    PlantPacer inner;
+    Relay* relay;
+};
+
+}  // namespace
+
+// Would catch: samples counted from the start instead of from the last forwarded record,
+// a boundary dropped because it fell between samples, the recovery tick after a fault
+// swallowed, or the watch mask ignored.
+TEST_CASE("DecimatingSink: every Nth record, and every record where a key changes") {
+    FakeClock clock;
+    FakeTelemetrySink inner;
+    DecimatingSink sink{inner, clock};
+    for (int i = 0; i < 100; ++i) {
+        CHECK(sink.wantsRecord());  // no probe: it must see every record
+        sink.emit(scripted(i));
+        clock.advance(Time{0.01});
+    }
+    CHECK(ticksOf(inner) == std::vector<int>{0, 10, 20, 30, 37, 47, 55, 56, 66, 76, 86, 96});
+    CHECK(sink.forwardedRecords() == 12);
+    CHECK(sink.boundaryRecords() == 4);  // the first record, the command, the fault, its end
+    CHECK(sink.skippedRecords() == 88);
+
+    SUBCASE("watch mask 0: plain decimation, boundaries not forced") {
+        FakeClock c2;
+        FakeTelemetrySink plain;
+        DecimatingSink every10{plain, c2, DecimationConfig{.watch = 0}};
+        for (int i = 0; i < 100; ++i) {
+            every10.emit(scripted(i));
+            c2.advance(Time{0.01});
+        }
+        CHECK(ticksOf(plain) == std::vector<int>{0, 10, 20, 30, 40, 50, 60, 70, 80, 90});
+    }
+
+    SUBCASE("lines and the summary pass untouched") {
+        sink.log(LogLevel::Info, "MOT", "hello");
+        sink.summarize(shulib::diag::RunSummary{});
+        CHECK(inner.size() == 1);
+        CHECK(inner.summaryCount() == 1);
+    }
+
+    CHECK_THROWS_AS((DecimatingSink{inner, clock, DecimationConfig{.every = 0}}),
+                    PreconditionError);
+    CHECK_THROWS_AS((DecimatingSink{inner, clock, DecimationConfig{.tickPeriod = Time{0.0}}}),
+                    PreconditionError);
+}
+
+// Would catch: an interval of exactly N periods (a late tick pushes every sample one
+// tick later, an early one is skipped), or counting calls instead of reading the clock.
+TEST_CASE("DecimatingSink: jittery ticks still give one record per N") {
+    FakeClock clock;
+    FakeTelemetrySink inner;
+    DecimatingSink sink{inner, clock, DecimationConfig{.every = 5, .watch = 0}};
+    double t = 0.0;
+    for (int i = 0; i < 1000; ++i) {
+        const double jitter = 0.002 * ((i * 7) % 5 - 2) / 2.0;  // within ±2 ms
+        const double target = 1.0 + 0.01 * i + jitter;
+        clock.advance(Time{target - t});
+        t = target;
+        sink.emit(DebugRecord{});
+    }
+    CHECK(inner.recordCount() == 200);
+}
+
+// Would catch: a probed wantsRecord() that still answers true on quiet ticks (the record
+// is built and thrown away), or one that answers false on a boundary tick (lost).
+TEST_CASE("DecimatingSink: with a probe, skipped ticks never build a record") {
+    FakeClock clock;
+    FakeTelemetrySink inner;
+    DecimatingSink sink{inner, clock};
+    ScriptedProbe probe;
+    sink.setKeyProbe(&probe);
+    int built = 0;
+    for (int i = 0; i < 100; ++i) {
+        probe.tick = i;
+        emitRecord(sink, [&] {
+            ++built;
+            return scripted(i);
+        });
+        clock.advance(Time{0.01});
+    }
+    CHECK(ticksOf(inner) == std::vector<int>{0, 10, 20, 30, 37, 47, 55, 56, 66, 76, 86, 96});
+    CHECK(built == 12);
+    CHECK(sink.skippedRecords() == 0);
+
+    // The inner sink's answer still wins: nothing wanted, nothing built.
+    shulib::hal::NullSink null;
+    DecimatingSink quiet{null, clock};
+    quiet.setKeyProbe(&probe);
+    CHECK_FALSE(quiet.wantsRecord());
+}
+
+// Would catch: the scheduler's probe disagreeing with the records its stamp produces — a
+// state read from the wrong motion, a stale gate reason, the fault stamp missed — any of
+// which shows up as a boundary in the full stream that the decimated stream lacks.
+TEST_CASE("DecimatingSink + MotionScheduler probe: every boundary, a fraction of the records") {
+    const auto kin = xDrive(Length{7.0});
+    const auto drive = [&](shulib::hal::ITelemetrySink& target, bool decimate,
+                           std::uint32_t& skipped) {
+        Relay relay;
+        relay.target = &target;
+        MotionRig rig{kin, plantConfig(), &relay};
+        MutingPacer pacer{rig.h, relay};
+        shulib::motion::MotionScheduler sched{rig.deps, pacer};
+        DecimatingSink decimator{target, rig.h.clock()};
+        if (decimate) {
+            decimator.setKeyProbe(&sched.recordKeyProbe());
+            relay.target = &decimator;
+        }
+        MoveToPose m1{sched.deps(), Pose2d{Length{24.0}, Length{12.0}, Angle::degrees(30.0)},
+                      motionConfig(), 8.0};
+        TurnTo m2{sched.deps(), Angle::degrees(-90.0), motionConfig(), 8.0};
+        sched.async(m1);
+        (void)sched.waitUntilSettled();
+        (void)sched.waitUntil([] { return false; }, 0.2);  // idle ticks between motions
+        sched.async(m2);
+        (void)sched.waitUntilSettled();
+        (void)sched.waitUntil([] { return false; }, 0.2);
+        skipped = decimator.skippedRecords();
+    };
+
+    FakeTelemetrySink full;
+    FakeTelemetrySink sampled;
+    std::uint32_t unused = 0;
+    std::uint32_t skipped = 0;
+    drive(full, false, unused);
+    drive(sampled, true, skipped);
+
+    // Every record of the full stream whose keys differ from the record before it.
+    std::vector<double> boundaries;
+    for (int i = 0; i < full.recordCount(); ++i) {
+        if (i == 0
+            || shulib::diag::recordKeys(full.recordAt(i))
+                   != shulib::diag::recordKeys(full.recordAt(i - 1))) {
+            boundaries.push_back(full.recordAt(i).t.value());
+        }
+    }
+    REQUIRE(boundaries.size() >= 5);  // two motions' starts, state changes and ends at least
+    int missing = 0;
+    for (const double t : boundaries) {
+        bool found = false;
+        for (int j = 0; j < sampled.recordCount() && !found; ++j) {
+            found = sampled.recordAt(j).t.value() == t;
+        }
+        missing += found ? 0 : 1;
+    }
+    CHECK(missing == 0);
+    CHECK(skipped == 0);  // nothing was built and then thrown away
+    CHECK(sampled.recordCount() * 4 < full.recordCount());
+    MESSAGE("scheduled run: " << full.recordCount() << " records at full rate, "
+                              << sampled.recordCount() << " decimated (" << boundaries.size()
+                              << " boundaries)");
+}
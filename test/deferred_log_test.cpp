@@ -0,0 +1,286 @@
+// Tests for deferred-formatting log lines — diag/deferred_log.hpp (SHULIB_LOGF), the
+// FormatDef/LogArgs frames SdSink and Shul2Sink write, and sim/deferred_log_table.hpp,
+// which renders them on the host. What each targets:
+//
+//  * THE FORMAT LANGUAGE: every argument type, precision, braces, non-finite tokens, and
+//    "{?}" for a placeholder with no argument — the reader must see damage, not a guess.
+//  * TEXT SINKS UNCHANGED: the seam's default renders a deferred line into log(), so a
+//    text sink shows exactly what formatDeferred() says; decorators forward it PACKED.
+//  * THE BLACKBOX CARRIES LOG LINES: a streamed run's deferred lines come back out of the
+//    file rendered, each format defined once however often it is used; a run that is
+//    not streaming counts them as it counts log() lines.
+//  * THE WIRE: the same frames on SHUL/2, rendered by the same host table; a host that
+//    missed a definition gets the id and raw arguments, never invented text.
+//  * THE POINT, measured: bytes per line on the wire against the rendered text, and the
+//    host cost of packing against formatting — reported, not asserted.
+
+#include "doctest.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shulib/diag/blackbox_format.hpp"
+#include "shulib/diag/blackbox_reader.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/deferred_log.hpp"
+#include "shulib/diag/level_filter_sink.hpp"
+#include "shulib/diag/sd_sink.hpp"
+#include "shulib/diag/shul2_sink.hpp"
+#include "shulib/hal/fake/fake_block_sink.hpp"
+#include "shulib/hal/fake/fake_char_sink.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/hal/fake/fake_telemetry_sink.hpp"
+#include "shulib/hal/null_sink.hpp"
+#include "shulib/hal/telemetry_sink.hpp"
+#include "shulib/sim/deferred_log_table.hpp"
+#include "shulib/units/quantity.hpp"
+
+using shulib::diag::DebugRecord;
+using shulib::diag::DeferredLog;
+using shulib::diag::SdSink;
+using shulib::diag::SdSinkConfig;
+using shulib::diag::SdSinkStorage;
+using shulib::diag::Shul2Decoder;
+using shulib::diag::Shul2FrameType;
+using shulib::diag::Shul2Sink;
+using shulib::hal::LogLevel;
+using shulib::hal::fake::FakeBlockSink;
+using shulib::hal::fake::FakeCharSink;
+using shulib::hal::fake::FakeClock;
+using shulib::hal::fake::FakeTelemetrySink;
+using shulib::sim::DeferredLogTable;
+namespace bb = shulib::diag::blackbox;
+namespace units = shulib::units;
+
+namespace {
+
+/// Render what a text sink would print for `line`.
+std::string rendered(const DeferredLog& line) {
+    std::array<char, shulib::diag::kMaxDeferredTextBytes> text{};
+    const std::size_t n = shulib::diag::formatDeferred(line, text);
+    return std::string{text.data(), n};
+}
+
+/// Captures deferred lines as they arrive, still packed — what a decorator hands on.
+class PackedSink final : public shulib::hal::ITelemetrySink {
+public:
+    void log(LogLevel /*level*/, std::string_view /*subsystem*/,
+             std::string_view /*message*/) override {
+        ++textLines;
+    }
+    void logDeferred(const DeferredLog& line) override { lines.push_back(line); }
+
+    std::vector<DeferredLog> lines;
+    int textLines = 0;
+};
+
+enum class Gear : std::uint8_t { Low = 1, High = 2 };
+
+}  // namespace
+
+// Would catch: an argument packed under the wrong type (a negative int rendered as a huge
+// unsigned), a precision ignored, an escaped brace eaten, a libc "nan" leaking through, or
+// a placeholder with no argument rendered as something plausible.
+TEST_CASE("deferred log: the format language renders every argument type") {
+    const auto line = [](auto... args) {
+        return shulib::diag::makeDeferredLog<0U, sizeof...(args), true>(
+            LogLevel::Info, "T", "", args...);
+    };
+    const auto show = [](std::string_view format, const DeferredLog& d) {
+        std::array<char, 256> text{};
+        const std::size_t n = shulib::diag::formatDeferred(format, d.packedArgs(), text);
+        return std::string{text.data(), n};
+    };
+    CHECK(show("{} {} {}", line(-42, 7U, true)) == "-42 7 true");
+    CHECK(show("{}", line(std::numeric_limits<std::int64_t>::min()))
+          == "-9223372036854775808");
+    CHECK(show("{}", line(std::numeric_limits<std::uint64_t>::max()))
+          == "18446744073709551615");
+    CHECK(show("{} {:.2} {:.0}", line(0.5, 3.14159, 2.5)) == "0.5 3.14 2");
+    CHECK(show("{} {} {}", line(std::nan(""), std::numeric_limits<double>::infinity(),
+                                -std::numeric_limits<double>::infinity()))
+          == "NaN +Inf -Inf");
+    CHECK(show("{{x}} = {}", line(1)) == "{x} = 1");
+    CHECK(show("{} {}", line(1)) == "1 {?}");
+    CHECK(show("gear {} at {:.1} in", line(Gear::High, units::Length{12.25}))
+          == "gear 2 at 12.2 in");
+    CHECK(show("no placeholders", line()) == "no placeholders");
+
+    // The macro's compile-time half: ids are constants, and distinct for distinct pairs.
+    static_assert(shulib::diag::formatId("MOT", "a {}") != shulib::diag::formatId("LOC", "a {}"));
+    static_assert(shulib::diag::formatId("MOT", "a {}") != shulib::diag::formatId("MOT", "b {}"));
+    static_assert(shulib::diag::placeholderCount("{} {:.2} {{}} {}") == 3);
+}
+
+// Would catch: a seam default that drops deferred lines (every text sink would go quiet),
+// a decorator that renders instead of forwarding (the blackbox would lose the packed
+// line), or a filter that forwards what log() would have blocked.
+TEST_CASE("deferred log: text sinks render it, decorators forward it packed") {
+    FakeTelemetrySink text;
+    SHULIB_LOGF(text, LogLevel::Warn, "MOT", "retry {}/{} after {:.1} s", 1, 3, 0.25);
+    REQUIRE(text.size() == 1);
+    CHECK(text.last().level == LogLevel::Warn);
+    CHECK(text.last().subsystem == "MOT");
+    CHECK(text.last().message == "retry 1/3 after 0.2 s");
+
+    shulib::hal::NullSink null;
+    SHULIB_LOGF(null, LogLevel::Info, "MOT", "nothing {}", 1);  // compiles, renders nothing
+
+    PackedSink packed;
+    shulib::diag::LevelFilterSink filter{packed};
+    filter.setLevel("LOC", LogLevel::Warn);
+    SHULIB_LOGF(filter, LogLevel::Info, "MOT", "passes {}", 1);
+    SHULIB_LOGF(filter, LogLevel::Info, "LOC", "blocked {}", 2);
+    REQUIRE(packed.lines.size() == 1);
+    CHECK(packed.textLines == 0);
+    CHECK(packed.lines[0].id == shulib::diag::formatId("MOT", "passes {}"));
+    CHECK(rendered(packed.lines[0]) == "passes 1");
+}
+
+// Would catch: log lines still missing from the file, a definition written per line (the
+// saving gone) or never (the lines unreadable), a line stamped with the wrong time, or a
+// non-streaming sink that starts writing bytes on a clean run.
+TEST_CASE("deferred log: a streamed blackbox carries the lines, each format defined once") {
+    FakeClock clock;
+    FakeBlockSink device;
+    std::vector<DebugRecord> ring(8);
+    std::vector<std::byte> buffer(16384);
+    SdSink sink{device, clock, SdSinkStorage{ring, buffer}, SdSinkConfig{.streamTicks = true}};
+    sink.open({});
+    for (int i = 0; i < 20; ++i) {
+        clock.advance(units::Time{0.01});
+        SHULIB_LOGF(sink, LogLevel::Info, "MOT", "tick {} err {:.2}", i, 0.5 * i);
+        if (i % 10 == 0) {
+            SHULIB_LOGF(sink, LogLevel::Warn, "LOC", "gps rejected, rms {:.1}", 3.25);
+        }
+    }
+    sink.log(LogLevel::Info, "MOT", "a plain line");  // still only counted
+    sink.close();
+    CHECK(sink.logFrames() == 22);
+    CHECK(sink.messagesSeen() == 1);
+    CHECK(sink.droppedFrames() == 0);
+
+    std::size_t defs = 0;
+    bb::BlackboxReader reader{device.view()};
+    bb::BlackboxReader::Frame frame;
+    while (reader.next(frame)) {
+        defs += frame.type == bb::FrameType::FormatDef ? 1U : 0U;
+    }
+    CHECK(defs == 2);
+    CHECK(reader.skippedFrames() == 0);
+
+    const std::vector<DeferredLogTable::Line> lines = shulib::sim::readDeferredLines(device.view());
+    REQUIRE(lines.size() == 22);
+    CHECK(lines[0].known);
+    CHECK(lines[0].tag == "MOT");
+    CHECK(lines[0].text == "tick 0 err 0.00");
+    CHECK(lines[0].t == doctest::Approx(0.01));
+    CHECK(lines[1].tag == "LOC");
+    CHECK(lines[1].level == LogLevel::Warn);
+    CHECK(lines[1].text == "gps rejected, rms 3.2");
+    CHECK(lines.back().text == "tick 19 err 9.50");
+
+    SUBCASE("not streaming: counted, and a clean run still writes nothing") {
+        FakeBlockSink quiet;
+        SdSink idle{quiet, clock, SdSinkStorage{ring, buffer}};
+        idle.open({});
+        SHULIB_LOGF(idle, LogLevel::Info, "MOT", "tick {}", 1);
+        idle.close();
+        CHECK(idle.messagesSeen() == 1);
+        CHECK(idle.logFrames() == 0);
+        CHECK(quiet.view().empty());
+    }
+}
+
+// Would catch: the wire using its own payload layout (two decoders to keep in step), a
+// definition that never goes out, or a host that renders a line it has no format for.
+TEST_CASE("deferred log: the SHUL/2 wire carries them, and a late host refuses to guess") {
+    FakeCharSink wire;
+    Shul2Sink sink{wire};
+    DebugRecord r;
+    std::size_t textBytes = 0;
+    for (int i = 0; i < 100; ++i) {
+        r.t = units::Time{0.01 * i};
+        sink.emit(r);
+        SHULIB_LOGF(sink, LogLevel::Debug, "MOT", "wheel {} at {:.3} V, target {:.3} V", i % 4,
+                    6.0 + 0.01 * i, 6.5);
+        textBytes += std::string_view{"wheel 0 at 6.000 V, target 6.500 V"}.size();
+    }
+    CHECK(sink.droppedLines() == 0);
+
+    const auto feedAll = [](std::string_view bytes, std::size_t from) {
+        Shul2Decoder d;
+        DeferredLogTable table;
+        std::vector<DeferredLogTable::Line> lines;
+        for (std::size_t i = from; i < bytes.size(); ++i) {
+            if (!d.feed(static_cast<std::byte>(bytes[i]))) {
+                continue;
+            }
+            if (d.frame().type == Shul2FrameType::FormatDef) {
+                CHECK(table.define(d.frame().payload));
+            } else if (d.frame().type == Shul2FrameType::LogArgs) {
+                DeferredLogTable::Line line;
+                REQUIRE(table.render(d.frame().payload, line));
+                lines.push_back(line);
+            }
+        }
+        return lines;
+    };
+
+    const std::vector<DeferredLogTable::Line> lines = feedAll(wire.text(), 0);
+    REQUIRE(lines.size() == 100);
+    CHECK(lines[7].text == "wheel 3 at 6.070 V, target 6.500 V");
+    CHECK(lines[7].t == doctest::Approx(0.07));
+
+    // A host that joins after the definition went by: ids and raw arguments, marked.
+    const std::vector<DeferredLogTable::Line> late = feedAll(wire.text(), wire.text().size() / 2);
+    REQUIRE_FALSE(late.empty());
+    CHECK_FALSE(late.back().known);
+    CHECK(late.back().text.find("<format ") == 0);
+
+    // Bytes per line on the wire vs the text a TermSink would have sent.
+    Shul2Sink linesOnly{wire};
+    wire.clear();
+    SHULIB_LOGF(linesOnly, LogLevel::Debug, "MOT", "wheel {} at {:.3} V, target {:.3} V", 1, 6.0,
+                6.5);
+    const std::size_t first = wire.text().size();
+    wire.clear();
+    SHULIB_LOGF(linesOnly, LogLevel::Debug, "MOT", "wheel {} at {:.3} V, target {:.3} V", 2, 6.1,
+                6.5);
+    const std::size_t steady = wire.text().size();
+    CHECK(steady < first);  // the definition went out once
+    MESSAGE("deferred line on the wire: " << steady << " bytes (first use " << first
+                                          << "), rendered text " << textBytes / 100 << " bytes");
+}
+
+// Reported, not asserted: host nanoseconds say little about the brain, but the ratio
+// between packing a line and rendering it is the point of the feature.
+TEST_CASE("deferred log: packing costs a fraction of formatting (measured)") {
+    constexpr int kLines = 20000;
+    std::uint32_t sink = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLines; ++i) {
+        const DeferredLog d = shulib::diag::makeDeferredLog<1U, 3, true>(
+            LogLevel::Info, "MOT", "wheel {} at {:.3} V, target {:.3} V", i % 4, 6.0 + 1e-4 * i, 6.5);
+        sink += static_cast<std::uint32_t>(d.argsBytes);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    std::array<char, 256> text{};
+    for (int i = 0; i < kLines; ++i) {
+        const DeferredLog d = shulib::diag::makeDeferredLog<1U, 3, true>(
+            LogLevel::Info, "MOT", "wheel {} at {:.3} V, target {:.3} V", i % 4, 6.0 + 1e-4 * i, 6.5);
+        sink += static_cast<std::uint32_t>(shulib::diag::formatDeferred(d, text));
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+    CHECK(sink > 0);
+    const double packNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / kLines;
+    const double fmtNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / kLines;
+    MESSAGE("per line: pack " << packNs << " ns, pack + format " << fmtNs << " ns (host)");
+}
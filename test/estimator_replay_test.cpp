@@ -0,0 +1,302 @@
+// Tests for offline estimator replay — sim/estimator_replay.hpp, and the estimator-inputs
+// channel it reads (Localizer::lastInputs() → CommandIdStampSink → SdSink's
+// EstimatorInputs frame → loadReplayTicks()). What each targets:
+//
+//  * EXACT REPRODUCTION: a hostile closed-loop sim run (IMU calibration, GPS dropouts,
+//    slip, latency) recorded to a blackbox file and replayed under the configuration
+//    that recorded it lands on the recorded pose stream bit for bit, through a v1 and
+//    a v2 (compact) file alike. This is the proof the channel carries everything the
+//    estimator read; a missing input shows up as divergence here and nowhere else.
+//  * A DIFFERENT CONFIG DIVERGES, and the grid is the serial replay: turning the GPS
+//    off or changing the fusion moves the replayed stream, and replayGrid()'s threaded
+//    results equal replayEstimator()'s one by one.
+//  * NO INPUTS, NO REPLAY: a record emitted without inputs writes no EstimatorInputs
+//    frame and contributes no replayable tick.
+//  * THE TEXT GRID (sim/replay_grid.hpp, shulib_replay's input): `set` and `vary` expand
+//    to the cartesian product in file order with readable labels, a bad line is
+//    reported by number with nothing expanded, and every shipped tools/grids file parses.
+
+#include "doctest.h"
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <span>
+#include <vector>
+
+#include "shulib/diag/blackbox_format.hpp"
+#include "shulib/diag/blackbox_reader.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/sd_sink.hpp"
+#include "shulib/hal/fake/fake_block_sink.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/localization/complementary_fusion.hpp"
+#include "shulib/localization/gps_corrector.hpp"
+#include "shulib/localization/i_corrector.hpp"
+#include "shulib/localization/localizer.hpp"
+#include "shulib/localization/pilons_odometry.hpp"
+#include "shulib/math/pose2d.hpp"
+#include "shulib/motion/motion_scheduler.hpp"
+#include "shulib/sim/estimator_replay.hpp"
+#include "shulib/sim/hostile/composed.hpp"
+#include "shulib/sim/replay_grid.hpp"
+#include "shulib/sim/scenario.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace bb = shulib::diag::blackbox;
+
+using shulib::diag::DebugRecord;
+using shulib::diag::SdSink;
+using shulib::diag::SdSinkConfig;
+using shulib::diag::SdSinkStorage;
+using shulib::hal::fake::FakeBlockSink;
+using shulib::kinematics::xDrive;
+using shulib::localization::ComplementaryFusion;
+using shulib::localization::GpsCorrector;
+using shulib::localization::ICorrector;
+using shulib::localization::Localizer;
+using shulib::localization::PilonsOdometry;
+using shulib::math::ChassisSpeeds;
+using shulib::motion::CommandIdStampSink;
+using shulib::sim::EstimatorReplayConfig;
+using shulib::sim::FullHostility;
+using shulib::sim::ReplayFusion;
+using shulib::sim::ReplayStats;
+using shulib::sim::SimHarness;
+using shulib::sim::SimHarnessConfig;
+using shulib::units::AngularVelocity;
+using shulib::units::Length;
+using shulib::units::Time;
+using shulib::units::Velocity;
+
+namespace {
+
+constexpr double kDt = 0.01;
+constexpr int kSettleTicks = 300;
+constexpr int kDriveTicks = 1500;
+
+/// The gps_corrector_accuracy_test script: straights, a hard spin, two arcs.
+[[nodiscard]] ChassisSpeeds scriptedTwist(int tick) {
+    switch ((tick / 100) % 10) {
+        case 3: return {Velocity{0.0}, Velocity{0.0}, AngularVelocity{-4.0}};
+        case 6: return {Velocity{20.0}, Velocity{0.0}, AngularVelocity{0.35}};
+        case 8: return {Velocity{20.0}, Velocity{0.0}, AngularVelocity{-0.35}};
+        default: return {Velocity{24.0}, Velocity{0.0}, AngularVelocity{0.0}};
+    }
+}
+
+/// One hostile run under the default estimator, every tick recorded to `device` the way
+/// the scheduler records it: update(), stamp the audit and the inputs, emit. Returns the
+/// published poses, one per tick, for the reproduction check. `stampInputs` false is a
+/// pre-replay producer.
+std::vector<shulib::math::Pose2d> recordRun(FakeBlockSink& device, bool compact,
+                                            bool stampInputs = true) {
+    const auto kin = xDrive(Length{7.0});
+    FullHostility hostile{};
+    SimHarnessConfig hcfg;
+    hcfg.plant.wheelFf = {.kS = 1.2, .kV = 0.17, .kA = 0.0};
+    hcfg.plant.seed = 7;
+    SimHarness h{kin, hcfg, nullptr, &hostile.model()};
+
+    PilonsOdometry odom{h.imu(), h.makeForwardTrackingWheel(), h.makeLateralTrackingWheel()};
+    ComplementaryFusion fusion;
+    GpsCorrector corrector{h.clock(), h.gps(), h.imu()};
+    std::array<ICorrector*, 1> correctors{&corrector};
+    Localizer loc{h.clock(), h.imu(), odom, fusion, std::span<ICorrector* const>{correctors}};
+
+    std::vector<DebugRecord> ring(32);
+    std::vector<std::byte> buffer(65536);
+    SdSink blackbox{device, h.clock(), SdSinkStorage{ring, buffer},
+                    SdSinkConfig{.streamTicks = true, .compactTicks = compact,
+                                 .recordEstimatorInputs = true}};
+    CommandIdStampSink stamp{blackbox};
+    blackbox.open({});
+
+    std::vector<shulib::math::Pose2d> published;
+    h.runTicks(kSettleTicks + kDriveTicks, Time{kDt}, [&](int tick) {
+        loc.update();
+        stamp.setEstimatorAudit(loc.lastCorrection());
+        if (stampInputs) {
+            stamp.setEstimatorInputs(loc.lastInputs());
+        }
+        DebugRecord rec;
+        rec.t = h.clock().now();
+        rec.measuredPose = loc.pose();
+        stamp.emit(rec);
+        stamp.emit(rec);  // a second record in the same tick: not a second tick to replay
+        (void)blackbox.flush();  // caller-paced, once a tick, so nothing is dropped
+        published.push_back(loc.pose());
+        h.commandBodyTwist(tick < kSettleTicks ? ChassisSpeeds{}
+                                               : scriptedTwist(tick - kSettleTicks));
+    });
+    blackbox.close();
+    return published;
+}
+
+[[nodiscard]] bool sameStats(const ReplayStats& a, const ReplayStats& b) {
+    return a.ticks == b.ticks && a.meanPositionError == b.meanPositionError
+           && a.rmsPositionError == b.rmsPositionError
+           && a.maxPositionError == b.maxPositionError
+           && a.finalPositionError == b.finalPositionError
+           && a.rmsHeadingError == b.rmsHeadingError && a.maxHeadingError == b.maxHeadingError
+           && a.acceptedTicks == b.acceptedTicks && a.rejectedTicks == b.rejectedTicks;
+}
+
+}  // namespace
+
+// Would catch: an estimator input that is read but not recorded (a corrector reading
+// the clock, a second IMU field), a frame that is staged out of order, or a compact
+// chain that drops the inputs' tick. Any of those replays to a stream that drifts away
+// from the recorded one — the hostile run exercises the boot settle window, GPS
+// dropouts and yaw-rate rejections, so each input path actually carries information.
+TEST_CASE("replay: the recording config reproduces the recorded pose stream") {
+    for (const bool compact : {false, true}) {
+        CAPTURE(compact);
+        FakeBlockSink device;
+        const std::vector<shulib::math::Pose2d> published = recordRun(device, compact);
+
+        std::vector<DebugRecord> ticks;
+        REQUIRE(shulib::sim::loadReplayTicks(device.view(), ticks) == bb::ReadStatus::Ok);
+        REQUIRE(ticks.size() == published.size());
+        CHECK(ticks.front().hasEstimatorInputs);
+
+        const ReplayStats s = shulib::sim::replayEstimator(ticks, EstimatorReplayConfig{});
+        CHECK(s.ticks == published.size());
+        // Bit-exact, not merely close: the same code over the same doubles.
+        CHECK(s.maxPositionError == 0.0);
+        CHECK(s.maxHeadingError == 0.0);
+        // Not vacuous: the run corrected AND turned fixes down, all through replayed inputs.
+        CHECK(s.acceptedTicks > 100);
+        CHECK(s.rejectedTicks > 100);
+    }
+}
+
+// Would catch: a replay that ignores its configuration (every result identical), a grid
+// that writes results to the wrong slot, or threads that share estimator state — any of
+// which makes the threaded grid disagree with the serial replay of the same config.
+TEST_CASE("replay: other configs diverge, and the threaded grid equals serial replays") {
+    FakeBlockSink device;
+    (void)recordRun(device, false);
+    std::vector<DebugRecord> ticks;
+    REQUIRE(shulib::sim::loadReplayTicks(device.view(), ticks) == bb::ReadStatus::Ok);
+
+    std::vector<EstimatorReplayConfig> grid(4);
+    grid[1].useGps = false;                     // dead reckoning alone
+    grid[2].fusion = ReplayFusion::Ekf;         // the other fusion tier
+    grid[3].gps.gateSigma = 1.0;                // a much tighter innovation gate
+
+    const std::vector<ReplayStats> parallel = shulib::sim::replayGrid(ticks, grid, 3);
+    REQUIRE(parallel.size() == grid.size());
+    for (std::size_t i = 0; i < grid.size(); ++i) {
+        CAPTURE(i);
+        CHECK(sameStats(parallel[i], shulib::sim::replayEstimator(ticks, grid[i])));
+    }
+    CHECK(parallel[0].maxPositionError == 0.0);
+    CHECK(parallel[1].maxPositionError > 0.1);
+    CHECK(parallel[1].acceptedTicks == 0);
+    CHECK(parallel[2].maxPositionError > 1e-3);
+    CHECK(parallel[3].maxPositionError > 1e-3);
+    CHECK(parallel[3].acceptedTicks < parallel[0].acceptedTicks);
+    MESSAGE("replay vs recorded, max position error (in): recorded-config "
+            << parallel[0].maxPositionError << ", no GPS " << parallel[1].maxPositionError
+            << ", EKF " << parallel[2].maxPositionError << ", gateSigma 1 "
+            << parallel[3].maxPositionError);
+}
+
+// Would catch: SdSink writing an inputs frame for a record that carries none (a
+// zero-filled frame would replay as an IMU that is never ready), or the loader pairing
+// an inputs frame with the wrong tick.
+TEST_CASE("replay: a record without inputs writes no inputs frame and is not replayable") {
+    FakeBlockSink device;
+    const std::vector<shulib::math::Pose2d> published = recordRun(device, false, false);
+    REQUIRE_FALSE(published.empty());
+
+    bb::BlackboxReader reader{device.view()};
+    bb::BlackboxReader::Frame frame;
+    std::size_t tickFrames = 0;
+    std::size_t inputFrames = 0;
+    while (reader.next(frame)) {
+        tickFrames += frame.type == bb::FrameType::Tick ? 1U : 0U;
+        inputFrames += frame.type == bb::FrameType::EstimatorInputs ? 1U : 0U;
+    }
+    CHECK(tickFrames == 2 * published.size());
+    CHECK(inputFrames == 0);
+
+    std::vector<DebugRecord> ticks;
+    REQUIRE(shulib::sim::loadReplayTicks(device.view(), ticks) == bb::ReadStatus::Ok);
+    CHECK(ticks.empty());
+    CHECK(shulib::sim::replayEstimator(ticks, EstimatorReplayConfig{}).ticks == 0);
+}
+
+// Would catch: a grid that expands in a different order than the file reads (the table's
+// labels would name the wrong rows), a `set` that only reaches the first config, or the
+// fusion words mapped backwards.
+TEST_CASE("replay grid: set and vary expand to the labelled product, in file order") {
+    const shulib::sim::ReplayGridParseResult r = shulib::sim::parseReplayGrid(
+        "# a comment line\n"
+        "set   wheel.diameter 2.75\n"
+        "vary  fusion complementary ekf\n"
+        "vary  gps.gateSigma 3 4 5   # a trailing comment\n"
+        "set   useGps true\n");
+    REQUIRE(r.ok());
+    REQUIRE(r.grid.configs.size() == 6);
+    REQUIRE(r.grid.labels.size() == 6);
+    CHECK(r.grid.labels[0] == "fusion=complementary gps.gateSigma=3");
+    CHECK(r.grid.labels[5] == "fusion=ekf gps.gateSigma=5");
+    for (std::size_t i = 0; i < 6; ++i) {
+        CAPTURE(i);
+        const EstimatorReplayConfig& c = r.grid.configs[i];
+        CHECK(c.trackingWheelDiameter.value() == 2.75);
+        CHECK(c.useGps);
+        CHECK(c.fusion == (i < 3 ? ReplayFusion::Complementary : ReplayFusion::Ekf));
+        CHECK(c.gps.gateSigma == 3.0 + static_cast<double>(i % 3));
+    }
+
+    const shulib::sim::ReplayGridParseResult none = shulib::sim::parseReplayGrid("");
+    REQUIRE(none.ok());
+    REQUIRE(none.grid.configs.size() == 1);  // no axes: the defaults alone
+    CHECK(none.grid.labels[0].empty());
+}
+
+// Would catch: a typo'd path or value silently replaying the defaults, or an error that
+// does not say where it is.
+TEST_CASE("replay grid: a bad line is the first error, with its line number") {
+    const auto error = [](const char* text) { return shulib::sim::parseReplayGrid(text); };
+
+    const shulib::sim::ReplayGridParseResult path =
+        error("set wheel.diameter 2\nvary gps.gateSgima 3 4\n");
+    CHECK_FALSE(path.ok());
+    CHECK(path.line == 2);
+    CHECK(path.error.find("gps.gateSgima") != std::string::npos);
+    CHECK(path.grid.configs.empty());
+
+    CHECK(error("vary fusion kalman\n").line == 1);           // not a fusion word
+    CHECK(error("set useGps 2\n").line == 1);                 // not a bool
+    CHECK(error("set ekf.reinitRejectCount 1.5\n").line == 1);  // not an int
+    CHECK(error("set gps.gateSigma\n").line == 1);            // no value
+    CHECK(error("set gps.gateSigma 3 4\n").line == 1);        // set takes one value
+    CHECK(error("\ntune gps.gateSigma 3\n").line == 2);       // unknown directive
+    const shulib::sim::ReplayGridParseResult huge = error(
+        "vary gps.gateSigma 1 2 3 4 5 6 7 8 9 10\nvary ekf.gateSigma 1 2 3 4 5 6 7 8 9 10\n"
+        "vary gps.latency 1 2 3 4 5 6 7 8 9 10\nvary ekf.maxDt 1 2 3 4 5 6 7 8 9 10\n"
+        "vary localizer.qFloor 1 2\n");
+    CHECK(huge.line == 5);  // past kMaxReplayGridConfigs
+}
+
+// Would catch: a shipped example grid that drifted from the format it documents.
+TEST_CASE("replay grid: every shipped tools/grids file parses") {
+    const std::filesystem::path dir = std::filesystem::path{SHULIB_SOURCE_DIR} / "tools" / "grids";
+    int files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator{dir}) {
+        if (entry.path().extension() != ".grid") {
+            continue;
+        }
+        ++files;
+        const shulib::sim::ReplayGridParseResult r =
+            shulib::sim::loadReplayGridFile(entry.path().c_str());
+        CHECK_MESSAGE(r.ok(), entry.path().string() << ":" << r.line << ": " << r.error);
+    }
+    CHECK(files >= 1);
+    CHECK_FALSE(shulib::sim::loadReplayGridFile("/nonexistent/x.grid").ok());
+}
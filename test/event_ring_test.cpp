@@ -0,0 +1,241 @@
+// Tests for diag/event_ring.hpp and the producers wired to it. What each targets:
+//  * THE RING: oldest-first reads across a wrap, the running count that says how many it
+//    no longer holds, an empty storage that only counts, and the 16-byte event.
+//  * THE EDGE PRODUCERS: FaultLatch records every raise with its per-code count; the
+//    HealthMonitor records IMU ready edges (boot window included), brownout edges with
+//    the voltage, and each episode's clear — and nothing on a tick where nothing changed.
+//  * IN THE LOOP: MotionScheduler records each motion's start and exit with its id and
+//    reason, and a GateChange only when the gate flips between accepting and rejecting —
+//    a 20 Hz fix under a 100 Hz loop (stale ticks between) is not a flip.
+// The blackbox side (the dump and close() writing EventLog frames) is in sd_sink_test.cpp.
+
+#include "doctest.h"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "motion_test_rig.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/event_ring.hpp"
+#include "shulib/diag/fault.hpp"
+#include "shulib/diag/health_monitor.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/hal/fake/fake_telemetry_sink.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/localization/correction.hpp"
+#include "shulib/localization/i_corrector.hpp"
+#include "shulib/motion/motion_scheduler.hpp"
+#include "shulib/motion/move_to_pose.hpp"
+#include "shulib/motion/turn_to.hpp"
+#include "shulib/units/quantity.hpp"
+
+using namespace motion_rig;
+using shulib::diag::Event;
+using shulib::diag::EventKind;
+using shulib::diag::EventRing;
+using shulib::diag::FaultCode;
+using shulib::diag::FaultLatch;
+using shulib::diag::GateReason;
+using shulib::diag::HealthMonitor;
+using shulib::hal::fake::FakeClock;
+using shulib::hal::fake::FakeTelemetrySink;
+using shulib::kinematics::xDrive;
+using shulib::math::Angle;
+using shulib::math::Pose2d;
+using shulib::units::Voltage;
+
+namespace {
+
+/// The kinds held by `ring`, oldest first.
+std::vector<EventKind> kinds(const EventRing& ring) {
+    std::vector<EventKind> out;
+    for (std::size_t i = 0; i < ring.size(); ++i) {
+        out.push_back(ring.at(i).kind);
+    }
+    return out;
+}
+
+/// A corrector whose verdict is scripted per call: Accepted proposals sit exactly on the
+/// prediction (zero innovation), rejected ones decline with a sensor-quality audit, and
+/// everything else is the stale fix a corrector reports between camera frames.
+struct ScriptedCorrector final : shulib::localization::ICorrector {
+    [[nodiscard]] shulib::localization::CorrectionProposal propose(
+        const Pose2d& predicted, Time /*dt*/) override {
+        shulib::localization::CorrectionProposal p;
+        const bool fresh = calls++ % 5 == 0;  // a 20 Hz source under a 100 Hz loop
+        if (fresh && accepting) {
+            p.valid = true;
+            p.fieldPose = predicted;
+            p.confidence = 1.0;
+            p.positionStdDev = Length{1.0};
+        } else {
+            p.selfAudit.reason =
+                fresh ? GateReason::RejectedSensorQuality : GateReason::RejectedStaleFix;
+        }
+        return p;
+    }
+    [[nodiscard]] const char* name() const noexcept override { return "scripted"; }
+
+    int calls = 0;
+    bool accepting = true;
+};
+
+}  // namespace
+
+// Would catch: a wrap that reads newest-first or loses the slot at the seam, an overwrite
+// count off by the held events, empty storage that indexes anyway, or a layout that grew.
+TEST_CASE("EventRing: oldest first across a wrap, and it counts what it no longer holds") {
+    static_assert(sizeof(Event) == 16);
+    FakeClock clock;
+    std::array<Event, 3> ram{};
+    EventRing ring{clock, ram};
+    for (std::uint32_t i = 1; i <= 5; ++i) {
+        clock.advance(Time{0.5});
+        ring.record(EventKind::MotionStart, 0, 0, i);
+    }
+    REQUIRE(ring.size() == 3);
+    CHECK(ring.capacity() == 3);
+    CHECK(ring.recorded() == 5);
+    CHECK(ring.overwritten() == 2);
+    CHECK(ring.at(0).value == 3);
+    CHECK(ring.at(0).t == doctest::Approx(1.5));
+    CHECK(ring.at(2).value == 5);
+    CHECK(ring.at(3) == Event{});  // past the end: an empty event, never a stale slot
+    CHECK(std::string_view{shulib::diag::eventKindName(ring.at(0).kind)} == "MOTION_START");
+
+    ring.clear();
+    CHECK(ring.size() == 0);
+    CHECK(ring.recorded() == 0);
+
+    EventRing none{clock, {}};
+    none.record(EventKind::ImuReady);
+    CHECK(none.size() == 0);
+    CHECK(none.overwritten() == 1);
+}
+
+// Would catch: a raise without its event (or with the wrong count), an IMU edge missed at
+// boot or recorded every tick, a brownout edge without its voltage or inside the
+// hysteresis band, or an episode clear that never appears.
+TEST_CASE("EventRing: the latch records raises, the monitor records edges and clears") {
+    FakeClock clock;
+    FakeTelemetrySink faultSink;
+    FaultLatch latch{faultSink, clock};
+    HealthMonitor health{latch};
+    shulib::diag::EventRingBuffer<64> ram;
+    EventRing ring{clock, ram.view()};
+    latch.setEventRing(&ring);
+    health.setEventRing(&ring);
+
+    HealthMonitor::Observations o;
+    o.imuReady = false;  // the boot window: an edge, not a fault
+    health.tick(o);
+    health.tick(o);
+    o.imuReady = true;
+    health.tick(o);
+    health.tick(o);
+    o.imuReady = false;  // a mid-run loss: the edge AND the fault
+    health.tick(o);
+    o.imuReady = true;
+    health.tick(o);
+    o.batteryVolts = Voltage{10.4};
+    health.tick(o);
+    o.batteryVolts = Voltage{10.6};  // inside the hysteresis band: nothing
+    health.tick(o);
+    o.batteryVolts = Voltage{11.0};
+    health.tick(o);
+
+    CHECK(kinds(ring) == std::vector<EventKind>{
+                             EventKind::ImuNotReady, EventKind::ImuReady, EventKind::ImuNotReady,
+                             EventKind::FaultRaised, EventKind::ImuReady, EventKind::FaultCleared,
+                             EventKind::BrownoutOn, EventKind::FaultRaised, EventKind::BrownoutOff,
+                             EventKind::FaultCleared});
+    CHECK(ring.at(3).code == static_cast<std::uint8_t>(FaultCode::ImuLost));
+    CHECK(ring.at(3).value == 1);
+    CHECK(ring.at(5).code == static_cast<std::uint8_t>(FaultCode::ImuLost));
+    CHECK(ring.at(6).value == 10400);
+    CHECK(ring.at(7).code == static_cast<std::uint8_t>(FaultCode::Brownout));
+    CHECK(ring.at(8).value == 11000);
+    CHECK(ring.at(9).code == static_cast<std::uint8_t>(FaultCode::Brownout));
+
+    latch.raise(FaultCode::ImuLost, "IMU", "again");
+    CHECK(ring.at(ring.size() - 1).value == 2);  // the per-code count rides along
+
+    health.setEventRing(nullptr);
+    latch.setEventRing(nullptr);
+    latch.raise(FaultCode::OdoStuck, "LOC", "");
+    CHECK(ring.recorded() == 11);
+}
+
+// Would catch: a motion boundary without its event, an exit that does not name its reason
+// or id, or a gate that records every fresh fix (or every stale tick) instead of the flips.
+TEST_CASE("EventRing in the loop: motion boundaries and gate flips from MotionScheduler") {
+    const auto kin = xDrive(Length{7.0});
+    shulib::sim::SimHarness h{kin, plantConfig()};
+    shulib::localization::PilonsOdometry odom{h.imu(), h.makeForwardTrackingWheel(),
+                                              h.makeLateralTrackingWheel()};
+    shulib::localization::ComplementaryFusion fusion;
+    ScriptedCorrector gps;
+    const std::array<shulib::localization::ICorrector*, 1> correctors{&gps};
+    shulib::localization::Localizer loc{h.clock(), h.imu(), odom, fusion, correctors};
+    FakeTelemetrySink faultSink;
+    FaultLatch latch{faultSink, h.clock()};
+    HealthMonitor health{latch};
+    shulib::motion::MotionDeps deps{.ctx = &h.context(),
+                                    .localizer = &loc,
+                                    .kinematics = &kin,
+                                    .faults = &latch,
+                                    .health = &health};
+    shulib::diag::EventRingBuffer<> ram;
+    EventRing ring{h.clock(), ram.view()};
+    latch.setEventRing(&ring);
+    health.setEventRing(&ring);
+    shulib::motion::MotionSchedulerConfig cfg;
+    cfg.events = &ring;
+    PlantPacer pacer{h};
+    shulib::motion::MotionScheduler sched{deps, pacer, cfg};
+
+    shulib::motion::MoveToPose m1{sched.deps(), Pose2d{Length{12.0}, Length{6.0}, Angle{}},
+                                  motionConfig(), 4.0};
+    shulib::motion::TurnTo m2{sched.deps(), Angle::degrees(90.0), motionConfig(), 4.0};
+    sched.async(m1);
+    REQUIRE(sched.waitUntilSettled() == shulib::control::ExitReason::Settled);
+    gps.accepting = false;  // the source starts lying...
+    (void)sched.waitUntil([] { return false; }, 0.3);
+    gps.accepting = true;   // ...and recovers
+    sched.async(m2);
+    REQUIRE(sched.waitUntilSettled() == shulib::control::ExitReason::Settled);
+
+    std::vector<Event> motion;
+    std::vector<Event> gate;
+    for (std::size_t i = 0; i < ring.size(); ++i) {
+        const Event e = ring.at(i);
+        if (e.kind == EventKind::MotionStart || e.kind == EventKind::MotionExit) {
+            motion.push_back(e);
+        } else if (e.kind == EventKind::GateChange) {
+            gate.push_back(e);
+        }
+    }
+    REQUIRE(motion.size() == 4);
+    CHECK(motion[0].kind == EventKind::MotionStart);
+    CHECK(motion[0].value == 1);
+    CHECK(motion[1].kind == EventKind::MotionExit);
+    CHECK(motion[1].code == static_cast<std::uint8_t>(shulib::control::ExitReason::Settled));
+    CHECK(motion[1].value == 1);
+    CHECK(motion[3].value == 2);
+    CHECK(motion[1].t > motion[0].t);
+
+    // Accepting, rejecting, accepting again: three flips, however many fixes each held.
+    REQUIRE(gate.size() == 3);
+    CHECK(gate[0].code == static_cast<std::uint8_t>(GateReason::Accepted));
+    CHECK(gate[0].aux == static_cast<std::uint16_t>(GateReason::None));
+    CHECK(gate[1].code == static_cast<std::uint8_t>(GateReason::RejectedSensorQuality));
+    CHECK(gate[1].aux == static_cast<std::uint16_t>(GateReason::Accepted));
+    CHECK(gate[2].code == static_cast<std::uint8_t>(GateReason::Accepted));
+    CHECK(gate[1].t >= motion[1].t);  // the first tick after the exit
+    CHECK(gate[2].t < motion[3].t);
+    CHECK(ring.overwritten() == 0);
+    MESSAGE("two motions and a lying source: " << ring.recorded() << " events, "
+                                               << ring.recorded() * sizeof(Event) << " bytes");
+}
@@ -11,17 +11,47 @@
 //    caller-controlled text safe to frame.
 //  * A6 — appendNum measured "pathological" against a fixed 10 bytes instead of against the
 //    column the caller asked for, so every width above 10 destroyed the column it reserved.
+//  * The fixed-point fast path — appendNum renders precisions 0–3 with integer arithmetic,
+//    and must match snprintf's %*.*f BYTE FOR BYTE: on exact binary ties, on values whose
+//    decimal spelling is a tie but whose binary value is not, on negatives that round to
+//    "-0.00", and at the edge of the path. Plus a measured, unasserted per-line speedup.
 
 #include "doctest.h"
 
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
 #include <string>
 #include <string_view>
 
 #include "shulib/diag/line_format.hpp"
 
 using shulib::diag::lineformat::appendNum;
+using shulib::diag::lineformat::appendUnsigned;
 using shulib::diag::lineformat::Line;
 
+namespace {
+
+/// What appendNum rendered before the fast path: snprintf, then the same compaction rule.
+std::string reference(double v, int width, int prec) {
+    char tmp[64];
+    int len = std::snprintf(tmp, sizeof tmp, "%*.*f", width, prec, v);
+    if (len > width && len > shulib::diag::lineformat::kCompactThresholdBytes) {
+        len = std::snprintf(tmp, sizeof tmp, "%.3g", v);
+    }
+    return std::string{tmp, static_cast<std::size_t>(len)};
+}
+
+std::string rendered(double v, int width, int prec) {
+    Line line;
+    appendNum(line, v, width, prec);
+    return std::string{line.view()};
+}
+
+}  // namespace
+
 // Bug caught (DEFECTS1 item A6): the compaction trigger was `len > kCompactThresholdBytes`
 // with the threshold a fixed 10. A `%*.*f` rendering is AT LEAST `width` bytes, so any column
 // wider than 10 tripped it for perfectly ordinary values: appendNum(line, 1.0, 12, 2)
@@ -87,3 +117,97 @@ TEST_CASE("appendSanitized: control bytes become '?', framing survives caller te
     line.appendSanitized("a\nb\tc\x1b" "d\x7f", 64);
     CHECK(line.view() == "a?b?c?d?");
 }
+
+// Would catch: rounding after scaling in floating point (2.675 → "2.68", 0.125 → "0.13"),
+// ties rounded away from zero instead of to even, a lost sign on "-0.00", a digit dropped
+// from a fraction with leading zeros ("1.05" as "1.5"), or a width miscounted by the sign.
+TEST_CASE("appendNum: the fixed-point path is byte-identical to %*.*f") {
+    // Hand-picked: the cases a plausible wrong implementation gets wrong.
+    const double picked[] = {0.0, -0.0, 0.125, 0.375, 2.5, 3.5, -2.5, 2.675, 1.005, 1.05,
+                             -0.001, -0.004, -0.0049, 0.0005, 0.0015, 9.995, 99.95, 143.9999,
+                             -143.9999, 1e-300, 5e-324, -5e-324, 999999999.9996, -999999999.4,
+                             0.1, 0.2, 0.3, 1.0 / 3.0, 2.0 / 3.0};
+    for (const double v : picked) {
+        for (int prec = 0; prec <= 3; ++prec) {
+            for (const int width : {0, 1, 6, 7, 12}) {
+                CAPTURE(v);
+                CAPTURE(prec);
+                CAPTURE(width);
+                CHECK(rendered(v, width, prec) == reference(v, width, prec));
+            }
+        }
+    }
+
+    // Every exact binary tie k/16 over a field's range, at every fast precision.
+    int mismatches = 0;
+    for (int k = -2400; k <= 2400; ++k) {
+        const double v = k / 16.0;
+        for (int prec = 0; prec <= 3; ++prec) {
+            mismatches += rendered(v, 7, prec) != reference(v, 7, prec) ? 1 : 0;
+        }
+    }
+    CHECK(mismatches == 0);
+
+    // A sweep of pseudo-random values over every magnitude the path accepts.
+    std::uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 200000; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        const double unit = static_cast<double>(x >> 11) * 0x1.0p-53;           // [0, 1)
+        const double v = (unit - 0.5) * std::pow(10.0, static_cast<double>(i % 19) - 9.0);
+        const int prec = i % 4;
+        mismatches += rendered(v, 6, prec) != reference(v, 6, prec) ? 1 : 0;
+    }
+    CHECK(mismatches == 0);
+
+    // Outside the path — precision 4+, the magnitude bound, compaction — unchanged too.
+    CHECK(rendered(1.23456789, 8, 5) == reference(1.23456789, 8, 5));
+    CHECK(rendered(2.0e9, 7, 2) == reference(2.0e9, 7, 2));
+    CHECK(rendered(123456789.0, 6, 2) == "1.23e+08");  // 12 bytes of %f: compacted
+
+    Line counts;
+    appendUnsigned(counts, 0);
+    counts.appendLiteral(" ");
+    appendUnsigned(counts, 4294967295UL);
+    CHECK(counts.view() == "0 4294967295");
+}
+
+// Reported, not asserted: the per-line cost of a TermSink-shaped tick line — 14 numeric
+// columns — through the fast path against the same line through snprintf.
+TEST_CASE("appendNum: per-line speedup of the fixed-point path (measured)") {
+    constexpr int kLines = 20000;
+    const auto build = [](int i, bool viaPrintf) {
+        Line line;
+        const double k = static_cast<double>(i);
+        const double cols[] = {0.01 * k, 12.0 + 0.003 * k, -48.25 + 0.001 * k, 0.5 * std::sin(k),
+                               90.0 - 0.01 * k, 6.2, -6.2, 0.97, 1.5e-3 * k, 3.14159,
+                               -0.0004, 144.0, 72.5, 11.9};
+        for (const double v : cols) {
+            if (viaPrintf) {
+                char tmp[40];
+                const int len = std::snprintf(tmp, sizeof tmp, "%*.*f", 7, 2, v);
+                line.appendRaw(tmp, static_cast<std::size_t>(len));
+            } else {
+                appendNum(line, v, 7, 2);
+            }
+            line.appendLiteral(" ");
+        }
+        return line.n;
+    };
+    std::size_t bytes = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLines; ++i) {
+        bytes += build(i, true);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLines; ++i) {
+        bytes += build(i, false);
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+    CHECK(bytes > 0);
+    const double printfNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / kLines;
+    const double fastNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / kLines;
+    MESSAGE("14-column line: snprintf " << printfNs << " ns, fixed-point " << fastNs
+                                        << " ns (host, " << printfNs / fastNs << "x)");
+}
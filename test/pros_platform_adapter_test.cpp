@@ -1,4 +1,4 @@
-// Adapter tests for ProsClock, ProsTickPacer, ProsBattery, ProsCharSink and
+// Adapter tests for ProsClock, ProsTickPacer, ProsPllTickPacer, ProsBattery, ProsCharSink and
 // ProsLineDisplay THROUGH THE HOST SHIM (chunk R1a). The shim tests the
 // adapter against our belief about PROS (HA-99..102, HA-57/107); hardware
 // tests the belief — the battery's units especially (the vendored source
@@ -15,6 +15,7 @@
 #include "shulib/hal/pros/char_sink.hpp"
 #include "shulib/hal/pros/clock.hpp"
 #include "shulib/hal/pros/line_display.hpp"
+#include "shulib/hal/pros/pll_tick_pacer.hpp"
 #include "shulib/hal/pros/tick_pacer.hpp"
 
 using shulib::hal::pros::DisplayController;
@@ -22,6 +23,7 @@ using shulib::hal::pros::ProsBattery;
 using shulib::hal::pros::ProsCharSink;
 using shulib::hal::pros::ProsClock;
 using shulib::hal::pros::ProsLineDisplay;
+using shulib::hal::pros::ProsPllTickPacer;
 using shulib::hal::pros::ProsTickPacer;
 
 TEST_CASE("ProsClock: µs → seconds ×1e-6, monotonic (HA-101)") {
@@ -61,6 +63,50 @@ TEST_CASE("ProsTickPacer: delay_until anchors cadence to the timeline, not the w
     CHECK(pros::shim::timeState().lastDelayUntilDelta == 10);
 }
 
+TEST_CASE("ProsPllTickPacer: RTOS wake latency is trimmed out on micros() (HA-101/102/124)") {
+    // BUG CAUGHT: a pacer that is anchored but only millisecond-precise. The scripted RTOS
+    // wakes 100 or 700 µs late, alternately: ProsTickPacer turns that into 10.6/9.4 ms
+    // periods. The PLL must wake early and spin to the exact grid — every period 10000 µs.
+    pros::shim::resetAll();
+    pros::shim::advanceUs(5'000'300);  // an unaligned start
+    auto& t = pros::shim::timeState();
+    t.wakeLatenessUs = [](int n) -> std::uint64_t { return n % 2 == 0 ? 100U : 700U; };
+    t.microsPollUs = 1;
+
+    ProsTickPacer msPacer;
+    msPacer.pace();
+    std::uint64_t last = t.nowUs;
+    msPacer.pace();
+    const std::uint64_t msPeriod = t.nowUs - last;
+    CHECK(msPeriod != 10'000U);  // the latency is visible in the ms pacer's period
+
+    ProsPllTickPacer pacer;
+    for (int i = 0; i < 100; ++i) {
+        pacer.pace();
+        pros::shim::advanceUs(3'000);  // the tick body
+    }
+    const auto& pll = pacer.pll();
+    CHECK(pll.periods() == 99);
+    CHECK(pll.lastPeriodUs() == 10'000U);
+    CHECK(pll.maxJitterUs() <= 2.0);  // a poll or two of read cost, nothing more
+    CHECK(pll.meanPeriodUs() == doctest::Approx(10'000.0).epsilon(1e-4));
+    CHECK(pll.lateTicks() == 0);
+    CHECK(pll.slips() == 0);
+    CHECK(pll.trimUs() > 0U);
+}
+
+TEST_CASE("ProsPllTickPacer: a frozen micros() cannot hang the spin (the poll cap)") {
+    // BUG CAUGHT: an unbounded `while (micros() < target)`. With the shim's reads costing
+    // nothing the clock never moves; pace() must still return after kMaxTrimPolls reads.
+    pros::shim::resetAll();
+    auto& t = pros::shim::timeState();
+    t.wakeLatenessUs = [](int) -> std::uint64_t { return 0U; };
+    ProsPllTickPacer pacer;
+    pacer.pace();  // anchors; the wake lands before the target and the spin is capped
+    CHECK(t.microsCalls <= ProsPllTickPacer::kMaxTrimPolls + 3);
+    CHECK(t.microsCalls > ProsPllTickPacer::kMaxTrimPolls);
+}
+
 TEST_CASE("ProsBattery: mV→V, mA→A, percent→[0,1] — all three scales wired (HA-99/100)") {
     // BUG CAUGHT: the ÷1000 dropped — 12600 "volts" makes brownout
     // compensation divide every motor command by ~1000 (the robot creeps), or
@@ -8,6 +8,13 @@
 //  * Task::delay_until(prev, delta) wakes at *prev + delta and updates *prev to
 //    the wake instant — constant-cadence pacing (vendored rtos.hpp:737-760; HA-102)
 //
+// Scripted imperfection, for the PLL pacer's tests (both OFF by default, so every older
+// adapter test sees the exact clock it always did):
+//  * wakeLatenessUs — a blocking delay_until() wakes this many µs AFTER its boundary
+//    (the RTOS wake latency the PLL tracks), supplied per call by a script function
+//  * microsPollUs   — each micros() read advances time by this much (the cost of a poll,
+//    and what lets a spin-wait terminate on a host clock that otherwise never moves)
+//
 // HONEST LIMIT: this shim tests the adapter against OUR BELIEF about PROS; it
 // cannot test the belief. Hardware tests the belief (bench runbook).
 
@@ -27,6 +34,11 @@ struct TimeState {
     int delayCalls = 0;
     int delayUntilCalls = 0;
     std::uint32_t lastDelayUntilDelta = 0;
+    /// Wake latency for blocking delay_until() call number `n` (0-based); null = none.
+    std::uint64_t (*wakeLatenessUs)(int n) = nullptr;
+    int blockingWakes = 0;
+    std::uint64_t microsPollUs = 0;  ///< µs each micros() read costs (0 = a frozen read)
+    int microsCalls = 0;
 };
 inline TimeState& timeState() {
     static TimeState s;
@@ -41,7 +53,13 @@ inline std::uint32_t millis() {
     return static_cast<std::uint32_t>(shim::timeState().nowUs / 1000u);
 }
 
-inline std::uint64_t micros() { return shim::timeState().nowUs; }
+inline std::uint64_t micros() {
+    auto& s = shim::timeState();
+    s.microsCalls += 1;
+    const std::uint64_t now = s.nowUs;
+    s.nowUs += s.microsPollUs;
+    return now;
+}
 
 inline void delay(const std::uint32_t milliseconds) {
     shim::timeState().delayCalls += 1;
@@ -66,6 +84,10 @@ public:
         const std::uint64_t targetUs = targetMs * 1000u;
         if (targetUs > s.nowUs) {
             s.nowUs = targetUs;  // "block" until the wake instant
+            if (s.wakeLatenessUs != nullptr) {
+                s.nowUs += s.wakeLatenessUs(s.blockingWakes);  // …and wake late (scripted)
+            }
+            s.blockingWakes += 1;
         }
         *prev_time = static_cast<std::uint32_t>(targetMs);
     }
@@ -6,6 +6,7 @@
 //    throttled — a throttled fault line is a lost root cause.
 //  * PER-CHANNEL ISOLATION: one chatty tag must not starve another.
 //  * DETERMINISM: token refill runs on the injected clock — every case is exact.
+//  * LOAD SHEDDING: an attached TickBudget gates population, counted apart from drops.
 
 #include "doctest.h"
 
@@ -14,6 +15,7 @@
 #include "shulib/diag/debug_record.hpp"
 #include "shulib/diag/rate_limit_sink.hpp"
 #include "shulib/diag/run_summary.hpp"
+#include "shulib/diag/tick_budget.hpp"
 #include "shulib/hal/fake/fake_clock.hpp"
 #include "shulib/hal/fake/fake_telemetry_sink.hpp"
 #include "shulib/hal/null_sink.hpp"
@@ -172,3 +174,41 @@ TEST_CASE("D-2: nonsense budgets are loud preconditions") {
         (RateLimitedSink{inner, clock, RateLimitConfig{.linesPerSecondPerChannel = -1.0}}),
         PreconditionError);
 }
+
+// Bug caught: load shedding that only QUIETS the terminal — population still paid on
+// a hot tick — or a shed record booked as a bandwidth drop, merging two different
+// stories into one number. And the gate must lift when the budget recovers.
+TEST_CASE("D-2 + load shedding: a shed tick skips population, counts apart, and recovers") {
+    FakeTelemetrySink inner;
+    FakeClock clock;
+    RateLimitedSink limiter{inner, clock};
+    shulib::diag::TickBudgetConfig cfg;
+    cfg.recoveryTicks = 1;
+    cfg.smoothing = 1.0;
+    shulib::diag::TickBudget budget{shulib::diag::LoopMonitorConfig{Time{0.015}}, cfg};
+    limiter.setTickBudget(&budget);
+
+    budget.observe(Time{0.015});  // overrun: RecordPopulation shed
+    int built = 0;
+    emitRecord(limiter, [&] {
+        ++built;
+        return DebugRecord{};
+    });
+    CHECK(built == 0);
+    CHECK_FALSE(limiter.wantsRecord());
+    limiter.emit(DebugRecord{});  // someone else paid for it: still not forwarded
+    CHECK(inner.recordCount() == 0);
+    CHECK(limiter.shedRecords() == 1);
+    CHECK(limiter.droppedRecords() == 0);
+
+    for (int i = 0; i < 4; ++i) {
+        budget.observe(Time{0.001});  // one class per calm tick
+    }
+    REQUIRE(budget.level() == 0);
+    emitRecord(limiter, [&] {
+        ++built;
+        return DebugRecord{};
+    });
+    CHECK(built == 1);
+    CHECK(inner.recordCount() == 1);
+}
@@ -2,7 +2,8 @@
 // What each targets:
 //  * BYTE-EXACT BLOCK: the §18.3 run summary is the one-screen answer to "how did
 //    it go" — column drift or a lost field degrades the headline deliverable.
-//  * HONESTY: n/a heading when no data; MISSING build hash; drops ALWAYS shown.
+//  * HONESTY: n/a heading when no data; MISSING build hash; drops ALWAYS shown;
+//    timing lines only for what was actually measured.
 //  * ADDITIVITY + DECORATORS: summarize() must be a no-op default (message-only
 //    sinks keep compiling) and every shipped decorator must FORWARD it — a
 //    decorator with the default body silently eats the run summary.
@@ -103,6 +104,49 @@ TEST_CASE("run summary: golden block — faulted, browned-out, throttled run") {
           "──────────────────────────────────────────────────────────\n");
 }
 
+// Bug caught: load shedding invisible on the one screen a driver reads — or, the
+// other way, a "shed 0 …" claim on a run whose TickBudget never shed anything (or
+// that had none). Shown only when something was actually shed, per-class, in order.
+TEST_CASE("run summary: load shedding is shown only when something was shed") {
+    RunSummary s = cleanSummary();
+    s.hasLoadShedData = true;  // a shedder was attached, and it never fired
+    CHECK(render(s) == render(cleanSummary()));
+    s.shedMaxLevel = 4;
+    s.shedTicks = {40, 31, 12, 6};
+    CHECK(render(s) ==
+          "── RUN SUMMARY ───────────────────────────────────────────\n"
+          " motions 7 · settled 6 · timeout 1 · cancelled 0 · aborted 0\n"
+          " heading max  0.7° final  0.3° · gating rejects 4 · brownout no\n"
+          " worst loop dt   11.2ms · first fault none · dropped 0 rec 0 ln"
+          " · shed rec 40 sd 31 vis 12 hlt 6\n"
+          " build a1b2c3d · routine \"redLeftTall\" · batt 12.4→11.6V\n"
+          "──────────────────────────────────────────────────────────\n");
+}
+
+// Bug caught: worstLoopDt being the whole timing story — a loop that is SOMETIMES 14.8 ms
+// and one that always is render identically without the distribution. And the reverse:
+// "0.00ms" printed for a phase nobody timed (attribution off, or a slot with no producer).
+TEST_CASE("run summary: tick-timing lines appear only for what was measured") {
+    using shulib::diag::TickTimingStats;
+    using units::Time;
+    RunSummary s = cleanSummary();
+    s.phaseTiming[2] = TickTimingStats{900, Time{0.0}, Time{0.0}, Time{0.0}, Time{0.0}};
+    CHECK(render(s) == render(cleanSummary()));  // samples, but no producer: no phase line
+
+    s.loopDt = TickTimingStats{1200, Time{0.0101}, Time{0.0109}, Time{0.0131}, Time{0.0148}};
+    s.phaseTiming[0] = TickTimingStats{1199, Time{0.0021}, Time{0.0030}, Time{0.0041}, Time{0.0052}};
+    s.phaseTiming[1] = TickTimingStats{1199, Time{0.0004}, Time{0.0007}, Time{0.0009}, Time{0.0013}};
+    CHECK(render(s) ==
+          "── RUN SUMMARY ───────────────────────────────────────────\n"
+          " motions 7 · settled 6 · timeout 1 · cancelled 0 · aborted 0\n"
+          " heading max  0.7° final  0.3° · gating rejects 4 · brownout no\n"
+          " worst loop dt   11.2ms · first fault none · dropped 0 rec 0 ln\n"
+          " loop dt p50  10.10 · p95  10.90 · p99  13.10 · max  14.80ms · n 1200\n"
+          " phase p99/max loc   4.10/  5.20 · mot   0.90/  1.30ms\n"
+          " build a1b2c3d · routine \"redLeftTall\" · batt 12.4→11.6V\n"
+          "──────────────────────────────────────────────────────────\n");
+}
+
 // Bug caught: heading fields fabricating " 0.0°" on a run with no heading data
 // (nothing ran / records off) — the lying-zero failure class.
 TEST_CASE("run summary: no heading data renders n/a, never a fabricated zero") {
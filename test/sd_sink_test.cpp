@@ -14,23 +14,45 @@
 //    a run that died mid-write identifies itself to a reader.
 //  * COST WHEN DISABLED: with the sink off, hal::emitRecord must not even BUILD a
 //    record (A1's cost contract) and no byte may reach the device.
+//  * LOAD SHEDDING: a shed flush() defers (counted, bytes kept), close() never does,
+//    and the run's shed tallies land in the file as a LoadShed frame.
+//  * TICK TIMING: a summary with timing digests is followed by a TickTiming frame that
+//    decodes field-for-field; one without writes none.
+//  * COMPACT TICKS (format v2): a default 200-tick dump fits the recommended buffer in
+//    ONE write, a tick dropped for want of buffer costs only itself, and a failed device
+//    write restarts the chain at a keyframe.
+//  * ESTIMATOR INPUTS: scheduler-stamped records add no dump bytes until
+//    recordEstimatorInputs asks for them, and then exactly one 72-byte frame a tick.
+//  * INCREMENTAL PUMPING: on a slow device, a per-tick pump() both shortens the worst
+//    tick and loses no frame where a boundary flush() drops them; every pumped write
+//    ends on a sector boundary of the file; the slice grows under a backlog and comes
+//    back down after it; a shed pump defers; and the pump pacer writes BEFORE it paces.
+//  * THE EVENT RING: the dump ends with the ring's events, oldest first; close() adds
+//    only the ones recorded since; a ring longer than a frame spans several.
 
 #include "doctest.h"
 
+#include <array>
 #include <cstddef>
+#include <cstdio>
 #include <string>
 #include <vector>
 
 #include "shulib/diag/blackbox_format.hpp"
 #include "shulib/diag/blackbox_reader.hpp"
 #include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/event_ring.hpp"
 #include "shulib/diag/fault.hpp"
 #include "shulib/diag/run_summary.hpp"
 #include "shulib/diag/sd_sink.hpp"
 #include "shulib/diag/session_info.hpp"
+#include "shulib/diag/tick_budget.hpp"
 #include "shulib/hal/fake/fake_block_sink.hpp"
 #include "shulib/hal/fake/fake_clock.hpp"
 #include "shulib/hal/telemetry_sink.hpp"
+#include "shulib/localization/correction.hpp"
+#include "shulib/motion/blackbox_pump_pacer.hpp"
+#include "shulib/motion/motion_scheduler.hpp"
 
 using shulib::PreconditionError;
 using shulib::diag::DebugRecord;
@@ -79,12 +101,18 @@ struct Decoded {
     bool sawEnd = false;
     bool corrupt = false;
     std::uint32_t skipped = 0;
+    std::uint32_t unresolved = 0;  ///< compact deltas the reader refused (broken chain)
     std::vector<DebugRecord> ticks;
     std::vector<bb::TriageInfo> triage;
     std::vector<DebugRecord> triageTicks;
     std::vector<RunSummary> summaries;
     std::vector<std::uint32_t> summaryDrops;
     std::vector<bb::EndInfo> ends;
+    std::vector<RunSummary> loadShed;
+    std::vector<RunSummary> tickTiming;
+    std::vector<RunSummary> zoneTiming;
+    std::vector<bb::EventLogHeader> eventLogs;
+    std::vector<shulib::diag::Event> events;  ///< every EventLog frame's events, in file order
     bb::BlackboxHeader header;
     /// Frame types in the order they appeared — the ORDER is a contract here.
     std::vector<bb::FrameType> order;
@@ -99,10 +127,13 @@ Decoded decode(const FakeBlockSink& device) {
     while (reader.next(frame)) {
         d.order.push_back(frame.type);
         switch (frame.type) {
-            case bb::FrameType::Tick: {
+            case bb::FrameType::Tick:
+            case bb::FrameType::TickKey:
+            case bb::FrameType::TickDelta: {
                 DebugRecord r;
-                REQUIRE(bb::decodeTick(frame.payload, r, d.corrupt));
-                d.ticks.push_back(r);
+                if (reader.readTick(frame, r, d.corrupt)) {
+                    d.ticks.push_back(r);
+                }
                 break;
             }
             case bb::FrameType::Triage: {
@@ -127,11 +158,46 @@ Decoded decode(const FakeBlockSink& device) {
                 d.ends.push_back(e);
                 break;
             }
+            case bb::FrameType::LoadShed: {
+                RunSummary s;
+                REQUIRE(bb::decodeLoadShed(frame.payload, s));
+                d.loadShed.push_back(s);
+                break;
+            }
+            case bb::FrameType::TickTiming: {
+                RunSummary s;
+                REQUIRE(bb::decodeTickTiming(frame.payload, s));
+                d.tickTiming.push_back(s);
+                break;
+            }
+            case bb::FrameType::ZoneTiming: {
+                RunSummary s;
+                REQUIRE(bb::decodeZoneTiming(frame.payload, s));
+                d.zoneTiming.push_back(s);
+                break;
+            }
+            case bb::FrameType::EventLog: {
+                bb::EventLogHeader h;
+                std::array<shulib::diag::Event, bb::kEventLogMaxEvents> buf{};
+                REQUIRE(bb::decodeEventLog(frame.payload, h, buf));
+                d.eventLogs.push_back(h);
+                d.events.insert(d.events.end(), buf.begin(), buf.begin() + h.count);
+                break;
+            }
+            case bb::FrameType::EstimatorInputs: {
+                REQUIRE_FALSE(d.ticks.empty());  // it belongs to the tick before it
+                REQUIRE(bb::decodeEstimatorInputs(frame.payload, d.ticks.back(), d.corrupt));
+                break;
+            }
+            case bb::FrameType::FormatDef:
+            case bb::FrameType::LogArgs:
+                break;  // deferred log lines: deferred_log_test reads them
         }
     }
     d.truncated = reader.truncated();
     d.sawEnd = reader.sawEnd();
     d.skipped = reader.skippedFrames();
+    d.unresolved = reader.unresolvedTicks();
     return d;
 }
 
@@ -668,3 +734,547 @@ TEST_CASE("SdSink: the SdSinkBuffers helper wires real storage") {
     }
     CHECK(sink.ringSize() == 16);
 }
+
+// Would catch: load shedding that LOSES bytes instead of deferring them, a deferral
+// that is not counted, or close() honouring the shed — a run that ends while the loop
+// is hot must still close its file.
+TEST_CASE("SdSink: a shed flush DEFERS — counted, bytes kept, and close() never defers") {
+    FakeBlockSink device;
+    FakeClock clock;
+    Storage storage{4, 8192};
+    SdSink sink{device, clock, storage.view(), SdSinkConfig{.streamTicks = true}};
+    shulib::diag::TickBudget budget{shulib::diag::LoopMonitorConfig{units::Time{0.01}}};
+    sink.setTickBudget(&budget);
+
+    budget.observe(units::Time{0.01});  // an overrun: everything shed, SdFlush included
+    REQUIRE(budget.shed(shulib::diag::SheddableWork::SdFlush));
+    sink.emit(tickAt(1.0));
+    CHECK(sink.flush());  // deferred is not failed
+    CHECK(sink.deferredFlushes() == 1);
+    CHECK(device.empty());
+    CHECK(sink.bytesBuffered() > 0);
+
+    sink.close();  // still shed — and it writes anyway
+    const Decoded d = decode(device);
+    CHECK(d.sawEnd);
+    REQUIRE(d.ticks.size() == 1);
+    CHECK(d.ticks[0].t.value() == 1.0);
+    CHECK(sink.droppedFrames() == 0);
+}
+
+// Would catch: deliberate degradation that never reaches the file — the summary says
+// the loop shed work, and the blackbox, which is what a competition afternoon has,
+// does not.
+TEST_CASE("SdSink: a summary with load-shed data is followed by a LoadShed frame") {
+    FakeBlockSink device;
+    FakeClock clock;
+    Storage storage{2, 8192};
+    SdSink sink{device, clock, storage.view()};
+
+    RunSummary plain;
+    sink.summarize(plain);  // no shedder attached: no LoadShed frame
+    RunSummary shed;
+    shed.hasLoadShedData = true;
+    shed.shedTicks = {40, 31, 12, 6};
+    shed.shedTicksObserved = 900;
+    shed.shedEscalations = 3;
+    shed.shedMaxLevel = 4;
+    sink.summarize(shed);
+    sink.close();
+
+    const Decoded d = decode(device);
+    REQUIRE(d.order.size() == 4);
+    CHECK(d.order[0] == bb::FrameType::Summary);
+    CHECK(d.order[1] == bb::FrameType::Summary);
+    CHECK(d.order[2] == bb::FrameType::LoadShed);
+    REQUIRE(d.loadShed.size() == 1);
+    CHECK(d.loadShed[0].hasLoadShedData);
+    CHECK(d.loadShed[0].shedTicks == shed.shedTicks);
+    CHECK(d.loadShed[0].shedTicksObserved == 900);
+    CHECK(d.loadShed[0].shedEscalations == 3);
+    CHECK(d.loadShed[0].shedMaxLevel == 4);
+    CHECK(d.skipped == 0);
+}
+
+// Would catch: the dt/phase distributions reaching the terminal but not the file — the
+// blackbox is the artifact a budget decision gets made from afterwards.
+TEST_CASE("SdSink: a summary with tick-timing data is followed by a TickTiming frame") {
+    FakeBlockSink device;
+    FakeClock clock;
+    Storage storage{2, 8192};
+    SdSink sink{device, clock, storage.view()};
+
+    RunSummary plain;
+    sink.summarize(plain);  // nothing measured: no TickTiming frame
+    RunSummary timed;
+    using units::Time;
+    timed.loopDt = {1200, Time{0.0101}, Time{0.0109}, Time{0.0131}, Time{0.0148}};
+    timed.phaseTiming[0] = {1199, Time{0.0021}, Time{0.0030}, Time{0.0041}, Time{0.0052}};
+    timed.phaseTiming[7] = {1199, Time{0.0}, Time{0.0}, Time{0.0}, Time{0.0}};  // no producer
+    sink.summarize(timed);
+    sink.close();
+
+    const Decoded d = decode(device);
+    REQUIRE(d.order.size() == 4);
+    CHECK(d.order[0] == bb::FrameType::Summary);
+    CHECK(d.order[1] == bb::FrameType::Summary);
+    CHECK(d.order[2] == bb::FrameType::TickTiming);
+    REQUIRE(d.tickTiming.size() == 1);
+    const RunSummary& got = d.tickTiming[0];
+    CHECK(got.loopDt.count == 1200);
+    CHECK(got.loopDt.p50.value() == 0.0101);
+    CHECK(got.loopDt.p95.value() == 0.0109);
+    CHECK(got.loopDt.p99.value() == 0.0131);
+    CHECK(got.loopDt.max.value() == 0.0148);
+    CHECK(got.phaseTiming[0].count == 1199);
+    CHECK(got.phaseTiming[0].p99.value() == 0.0041);
+    CHECK(got.phaseTiming[7].count == 1199);
+    CHECK(got.phaseTiming[7].max.value() == 0.0);
+    CHECK(got.phaseTiming[1].count == 0);
+    CHECK(d.skipped == 0);
+}
+
+// Would catch: the zone table reaching the terminal but not the file, a row's name or
+// depth lost on the way (the tree is unreadable without both), or a frame sized by the
+// table's capacity instead of its rows.
+TEST_CASE("SdSink: a summary with a zone table is followed by a ZoneTiming frame") {
+    FakeBlockSink device;
+    FakeClock clock;
+    Storage storage{2, 8192};
+    SdSink sink{device, clock, storage.view()};
+
+    RunSummary zoned;
+    using units::Time;
+    const auto row = [](const char* name, std::uint8_t depth, std::uint32_t calls, double total,
+                        double self) {
+        shulib::diag::ZoneTimingRow r;
+        std::snprintf(r.name, sizeof r.name, "%s", name);
+        r.depth = depth;
+        r.calls = calls;
+        r.total = Time{total};
+        r.self = Time{self};
+        r.p50 = Time{0.000512};
+        r.p99 = Time{0.001024};
+        r.max = Time{0.0013};
+        return r;
+    };
+    zoned.zones[0] = row("loc", 0, 1200, 0.91, 0.11);
+    zoned.zones[1] = row("gps", 1, 1200, 0.80, 0.80);
+    zoned.zones[2] = row("mot", 0, 1200, 0.40, 0.40);
+    zoned.zoneCount = 3;
+    zoned.zonesRefused = 2;
+    sink.summarize(zoned);
+    sink.close();
+
+    const Decoded d = decode(device);
+    REQUIRE(d.order.size() == 3);
+    CHECK(d.order[0] == bb::FrameType::Summary);
+    CHECK(d.order[1] == bb::FrameType::ZoneTiming);
+    REQUIRE(d.zoneTiming.size() == 1);
+    const RunSummary& got = d.zoneTiming[0];
+    REQUIRE(got.zoneCount == 3);
+    CHECK(got.zonesRefused == 2);
+    CHECK(got.zones[0].nameView() == "loc");
+    CHECK(got.zones[1].nameView() == "gps");
+    CHECK(got.zones[1].depth == 1);
+    CHECK(got.zones[2].nameView() == "mot");
+    CHECK(got.zones[0].calls == 1200);
+    CHECK(got.zones[0].total.value() == 0.91);
+    CHECK(got.zones[0].self.value() == 0.11);
+    CHECK(got.zones[2].p99.value() == 0.001024);
+    CHECK(got.zones[2].max.value() == 0.0013);
+    CHECK(bb::zoneTimingPayloadBytes(zoned)
+          == bb::kZoneTimingFixedBytes + 3 * bb::kZoneTimingRowBytes);
+    CHECK(d.skipped == 0);
+}
+
+// Would catch: events written before the preceding ticks (a cut would cost the ticks), an
+// overwritten event's number misreported, close() re-writing what the dump already holds,
+// a clean run's close() writing a file for the events alone, or a long ring that does not
+// split across frames.
+TEST_CASE("SdSink: the fault dump ends with the event ring, and close() adds only new events") {
+    using shulib::diag::Event;
+    using shulib::diag::EventKind;
+    using shulib::diag::EventRing;
+    FakeBlockSink device;
+    FakeClock clock;
+    Storage storage{3, 8192};
+    std::array<Event, 4> ringRam{};
+    EventRing events{clock, ringRam};
+    SdSink sink{device, clock, storage.view()};
+    sink.setEventRing(&events);
+    for (std::uint32_t i = 1; i <= 6; ++i) {
+        events.record(EventKind::MotionStart, 0, 0, i);  // 1 and 2 are overwritten
+    }
+    for (int i = 1; i <= 3; ++i) {
+        sink.emit(tickAt(i * 0.01));
+    }
+    CHECK(device.size() == 0);
+    sink.emit(tickAt(0.04, FaultCode::ImuLost));
+    events.record(EventKind::ImuReady);
+    events.record(EventKind::MotionExit, 0, 0, 6);
+    sink.close();
+
+    const Decoded d = decode(device);
+    REQUIRE(d.order.size() == 7);
+    CHECK(d.order[0] == bb::FrameType::Triage);
+    CHECK(d.order[3] == bb::FrameType::Tick);
+    CHECK(d.order[4] == bb::FrameType::EventLog);
+    CHECK(d.order[5] == bb::FrameType::EventLog);
+    CHECK(d.order[6] == bb::FrameType::End);
+    REQUIRE(d.eventLogs.size() == 2);
+    CHECK(d.eventLogs[0].firstNumber == 2);
+    CHECK(d.eventLogs[0].recorded == 6);
+    CHECK(d.eventLogs[1].firstNumber == 6);
+    CHECK(d.eventLogs[1].recorded == 8);
+    REQUIRE(d.events.size() == 6);
+    CHECK(d.events[0].value == 3);
+    CHECK(d.events[3].value == 6);
+    CHECK(d.events[4].kind == EventKind::ImuReady);
+    CHECK(d.events[5] == events.at(3));
+    CHECK(sink.eventFrames() == 2);
+    CHECK(d.skipped == 0);
+
+    SUBCASE("a clean run writes nothing, events or not") {
+        FakeBlockSink quiet;
+        SdSink clean{quiet, clock, storage.view()};
+        clean.setEventRing(&events);
+        clean.emit(tickAt(0.05));
+        clean.close();
+        CHECK(quiet.size() == 0);
+    }
+
+    SUBCASE("a ring longer than a frame spans several") {
+        std::vector<Event> bigRam(bb::kEventLogMaxEvents + 44);
+        EventRing big{clock, bigRam};
+        for (std::size_t i = 0; i < bigRam.size(); ++i) {
+            big.record(EventKind::GateChange, 1, 0, static_cast<std::uint32_t>(i));
+        }
+        FakeBlockSink dev2;
+        Storage st2{1, 16384};
+        SdSink s2{dev2, clock, st2.view()};
+        s2.setEventRing(&big);
+        s2.emit(tickAt(0.01, FaultCode::Brownout));
+        const Decoded d2 = decode(dev2);
+        REQUIRE(d2.eventLogs.size() == 2);
+        CHECK(d2.eventLogs[0].count == bb::kEventLogMaxEvents);
+        CHECK(d2.eventLogs[1].count == 44);
+        CHECK(d2.eventLogs[1].firstNumber == bb::kEventLogMaxEvents);
+        REQUIRE(d2.events.size() == bigRam.size());
+        CHECK(d2.events.back().value == bigRam.size() - 1);
+    }
+}
+
+// Would catch: the compact format not paying for itself where it matters — sd_sink.hpp's
+// own arithmetic says a default v1 dump (~87 KB) needs two writes from 64 KiB.
+TEST_CASE("SdSink: compact ticks fit a default 200-tick dump in ONE write of the 64 KiB buffer") {
+    auto dumpWrites = [](bool compact, FakeBlockSink& device) {
+        FakeClock clock;
+        Storage storage{shulib::diag::kDefaultFlightRingTicks,
+                        shulib::diag::kRecommendedBufferBytes};
+        SdSink sink{device, clock, storage.view(), SdSinkConfig{.compactTicks = compact}};
+        sink.open(demoSession());
+        for (int i = 1; i <= 250; ++i) {
+            sink.emit(tickAt(i * 0.01));
+        }
+        sink.emit(tickAt(2.51, FaultCode::Brownout));
+        CHECK(sink.droppedFrames() == 0);
+        return device.writeCalls();
+    };
+    FakeBlockSink plain;
+    FakeBlockSink compact;
+    CHECK(dumpWrites(false, plain) == 2);
+    CHECK(dumpWrites(true, compact) == 1);
+
+    const Decoded d = decode(compact);
+    REQUIRE(d.status == bb::ReadStatus::Ok);
+    CHECK(d.header.formatVersion == bb::kFormatVersionCompact);
+    REQUIRE(d.triage.size() == 1);
+    CHECK(d.triage[0].precedingTicks == 200);
+    REQUIRE(d.ticks.size() == 200);
+    CHECK(d.ticks.front().t.value() == tickAt(0.51).t.value());  // oldest first
+    CHECK(d.ticks.back().t.value() == tickAt(2.50).t.value());
+    CHECK(d.unresolved == 0);
+    MESSAGE("default dump: v1 ", plain.size(), " B, compact ", compact.size(), " B");
+}
+
+// Would catch: the replay channel's frame riding every robot blackbox by default. The
+// scheduler stamps estimator inputs onto EVERY record it passes, so an unconditional
+// inputs frame would grow each default dump by 72 bytes a tick — past the sizes
+// sd_sink.hpp and HA-59 state — without anyone having asked for a replay.
+TEST_CASE("SdSink: scheduler-stamped inputs cost no dump bytes unless recordEstimatorInputs") {
+    auto dumpBytes = [](bool compact, bool record) {
+        FakeBlockSink device;
+        FakeClock clock;
+        Storage storage{shulib::diag::kDefaultFlightRingTicks,
+                        shulib::diag::kRecommendedBufferBytes};
+        SdSink sink{device, clock, storage.view(),
+                    SdSinkConfig{.compactTicks = compact, .recordEstimatorInputs = record}};
+        shulib::motion::CommandIdStampSink stamp{sink};
+        sink.open(demoSession());
+        for (int i = 1; i <= 250; ++i) {
+            shulib::localization::EstimatorInputs in;
+            in.imuReady = true;
+            in.imuHeading = shulib::math::Angle::radians(0.001 * i);
+            in.forwardShaft = units::AngleDim{0.05 * i};
+            stamp.setEstimatorInputs(in);
+            stamp.emit(tickAt(i * 0.01));
+        }
+        stamp.emit(tickAt(2.51, FaultCode::Brownout));
+        CHECK(sink.droppedFrames() == 0);
+        const Decoded d = decode(device);
+        CHECK(d.ticks.size() == 200);
+        CHECK(d.ticks.front().hasEstimatorInputs == record);
+        return device.size();
+    };
+    const std::size_t inputsFrame = bb::kFrameHeaderBytes + bb::kEstimatorInputsPayloadBytes;
+    const std::size_t v1Dump = bb::kHeaderBytes + bb::kFrameHeaderBytes + bb::kTriagePayloadBytes
+                               + 200 * (bb::kFrameHeaderBytes + bb::kTickPayloadBytes);
+
+    const std::size_t v1Off = dumpBytes(false, false);
+    const std::size_t v1On = dumpBytes(false, true);
+    CHECK(v1Off == v1Dump);  // sd_sink.hpp's "about 87 KB", stamped records and all
+    CHECK(v1Off < 88000);
+    CHECK(v1On == v1Dump + 200 * inputsFrame);  // …and its "about 102 KB" when asked for
+    CHECK(v1On < 102000);
+
+    const std::size_t compactOff = dumpBytes(true, false);
+    const std::size_t compactOn = dumpBytes(true, true);
+    CHECK(compactOn == compactOff + 200 * inputsFrame);  // uncompressed beside the deltas
+    MESSAGE("stamped default dump: v1 ", v1Off, " B (", v1On, " B with inputs), compact ",
+            compactOff, " B (", compactOn, " B with inputs)");
+}
+
+// Would catch: an encoder that advances its chain for a frame the sink then DROPPED —
+// every later delta would be decoded against a tick the file does not contain.
+TEST_CASE("SdSink: a compact tick dropped for want of buffer costs only itself") {
+    FakeBlockSink device;
+    FakeClock clock;
+    // Room for the header, one keyframe, and a handful of deltas.
+    Storage storage{4, bb::kHeaderBytes + bb::kFrameHeaderBytes + bb::kTickKeyPayloadBytes + 200};
+    SdSink sink{device, clock, storage.view(),
+                SdSinkConfig{.streamTicks = true, .compactTicks = true}};
+    for (int i = 1; i <= 40; ++i) {
+        sink.emit(tickAt(static_cast<double>(i)));
+    }
+    CHECK(sink.droppedFrames() > 0);
+    const std::uint32_t staged = sink.tickFrames();
+    CHECK(sink.flush());
+    for (int i = 41; i <= 45; ++i) {
+        sink.emit(tickAt(static_cast<double>(i)));  // deltas against the last STAGED tick
+    }
+    CHECK(sink.flush());
+
+    const Decoded d = decode(device);
+    CHECK(d.unresolved == 0);
+    REQUIRE(d.ticks.size() == staged + 5);
+    CHECK(d.ticks.back().t.value() == 45.0);
+    CHECK(sink.compactEncoder().keyframes() == 1);  // the chain never had to restart
+}
+
+// Would catch: a chain that carries on across a failed write — the reader would refuse
+// every delta up to the next scheduled keyframe instead of just the lost ones.
+TEST_CASE("SdSink: a failed device write restarts the compact chain at a keyframe") {
+    FakeBlockSink device;
+    FakeClock clock;
+    device.setCapacity(bb::kHeaderBytes + 10);
+    Storage storage{4, 16384};
+    SdSink sink{device, clock, storage.view(),
+                SdSinkConfig{.streamTicks = true, .compactTicks = true}};
+    for (int i = 1; i <= 3; ++i) {
+        sink.emit(tickAt(static_cast<double>(i)));
+    }
+    CHECK(sink.compactEncoder().keyframes() == 1);
+    CHECK_FALSE(sink.flush());
+    sink.emit(tickAt(4.0));
+    CHECK(sink.compactEncoder().keyframes() == 2);
+    CHECK(sink.compactEncoder().deltas() == 2);
+}
+
+// ── Incremental pumping ─────────────────────────────────────────────────────────────
+
+namespace {
+
+/// A streamed 100 Hz run against a slow card (1 ms per write call plus 0.1 us per byte —
+/// HA-60's single-digit milliseconds for a full buffer), written either by a flush()
+/// every `flushEvery` ticks (a motion boundary) or by a pump() every tick. The sink's
+/// share of each tick is read straight off the clock the device advances.
+struct PumpRun {
+    double worstTickSeconds = 0.0;
+    std::uint32_t dropped = 0;
+    std::size_t ticksOnCard = 0;
+    std::vector<std::size_t> writeSizes;
+};
+
+PumpRun runSlowCard(bool pump, int ticks, int flushEvery) {
+    FakeBlockSink device;
+    FakeClock clock;
+    device.setWriteCost(clock, units::Time{1e-3}, units::Time{1e-7});
+    Storage storage{4, 32768};
+    SdSinkConfig cfg{.streamTicks = true};
+    if (pump) {
+        cfg.pumpBytesPerTick = shulib::diag::kDefaultPumpBytesPerTick;
+    }
+    SdSink sink{device, clock, storage.view(), cfg};
+    sink.open(demoSession());
+    PumpRun run;
+    for (int i = 0; i < ticks; ++i) {
+        const double t0 = clock.now().value();
+        sink.emit(tickAt(t0));
+        if (pump) {
+            (void)sink.pump();
+        } else if (i % flushEvery == flushEvery - 1) {
+            (void)sink.flush();
+        }
+        const double cost = clock.now().value() - t0;
+        run.worstTickSeconds = cost > run.worstTickSeconds ? cost : run.worstTickSeconds;
+        clock.advance(units::Time{0.01});
+    }
+    sink.close();
+    run.dropped = sink.droppedFrames();
+    run.ticksOnCard = decode(device).ticks.size();
+    run.writeSizes = device.writeSizes();
+    return run;
+}
+
+/// Counts paces and remembers how many bytes the card held when the world advanced.
+class RecordingPacer final : public shulib::motion::ITickPacer {
+public:
+    explicit RecordingPacer(const FakeBlockSink& device) : device_{&device} {}
+    void pace() override { sizesAtPace.push_back(device_->size()); }
+    std::vector<std::size_t> sizesAtPace;
+
+private:
+    const FakeBlockSink* device_;
+};
+
+}  // namespace
+
+// Would catch: a pump that is no cheaper per tick than the boundary flush it replaces,
+// or one that cannot keep up with a streamed run — the two numbers the mode exists for.
+TEST_CASE("SdSink: per-tick pump() beats boundary flushes on a slow card — shorter worst "
+          "tick, no drops") {
+    constexpr int kTicks = 600;       // 6 s at 100 Hz
+    constexpr int kFlushEvery = 150;  // a 1.5 s motion between boundaries
+    const PumpRun boundary = runSlowCard(false, kTicks, kFlushEvery);
+    const PumpRun pumped = runSlowCard(true, kTicks, kFlushEvery);
+
+    CHECK(boundary.dropped > 0);  // 1.5 s of v1 ticks does not fit 32 KiB
+    CHECK(pumped.dropped == 0);
+    CHECK(pumped.ticksOnCard == static_cast<std::size_t>(kTicks));
+    CHECK(pumped.worstTickSeconds < boundary.worstTickSeconds / 2.0);
+    CHECK(pumped.worstTickSeconds < 2e-3);
+    MESSAGE("worst sink cost per tick: boundary flush ", boundary.worstTickSeconds * 1e3,
+            " ms (", boundary.dropped, " frames dropped), pump ", pumped.worstTickSeconds * 1e3,
+            " ms (", pumped.dropped, " dropped)");
+
+    // Every pumped write ends on a sector boundary of the FILE; only close()'s tail may not.
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i + 1 < pumped.writeSizes.size(); ++i) {
+        offset += pumped.writeSizes[i];
+        CHECK(offset % shulib::diag::kSectorBytes == 0);
+        CHECK(pumped.writeSizes[i] <= shulib::diag::kDefaultPumpBytesPerTick);
+    }
+}
+
+// Would catch: a slice that never adapts (the backlog after a shed stretch drains at the
+// base rate and the buffer overflows), one that never comes back down, and a shed pump
+// that writes anyway.
+TEST_CASE("SdSink: the pump slice grows under a backlog, relaxes after it, and a shed "
+          "pump defers") {
+    FakeBlockSink device;
+    FakeClock clock;
+    Storage storage{4, 16384};
+    SdSink sink{device, clock, storage.view(),
+                SdSinkConfig{.streamTicks = true,
+                             .pumpBytesPerTick = 512,
+                             .pumpMaxBytesPerTick = 4096,
+                             .pumpHighWater = 0.5}};
+    shulib::diag::TickBudget budget{shulib::diag::LoopMonitorConfig{units::Time{0.01}}};
+    budget.observe(units::Time{0.01});
+    REQUIRE(budget.shed(shulib::diag::SheddableWork::SdFlush));
+    sink.setTickBudget(&budget);
+
+    double t = 0.0;
+    for (int i = 0; i < 25; ++i) {  // ~11 KB staged: past the 8 KiB high-water mark
+        sink.emit(tickAt(t += 0.01));
+        CHECK(sink.pump() == 0);
+    }
+    CHECK(sink.deferredPumps() == 25);
+    CHECK(device.empty());
+    CHECK(sink.pumpSliceBytes() == 512);
+
+    sink.setTickBudget(nullptr);
+    std::size_t widest = 0;
+    for (int i = 0; i < 60; ++i) {
+        sink.emit(tickAt(t += 0.01));
+        (void)sink.pump();
+        widest = sink.pumpSliceBytes() > widest ? sink.pumpSliceBytes() : widest;
+    }
+    CHECK(widest == 4096);
+    CHECK(sink.pumpSliceBytes() == 512);
+    CHECK(sink.droppedFrames() == 0);
+    CHECK(sink.peakBufferedBytes() > 8192);
+    CHECK(sink.bytesBuffered() < 1024);
+}
+
+// Would catch: a failure after pumping that charges the frames the earlier slices already
+// put on the card as drops — the count must be exactly the frames the file does not hold
+// whole, the one the last slice cut in two included (its torn prefix ends the file).
+TEST_CASE("SdSink: a write refused after pumped slices drops exactly the frames not on the "
+          "card whole") {
+    FakeBlockSink device;
+    FakeClock clock;
+    Storage storage{4, 16384};
+    SdSink sink{device, clock, storage.view(),
+                SdSinkConfig{.streamTicks = true,
+                             .pumpBytesPerTick = 1024,
+                             .pumpMaxBytesPerTick = 1024}};
+    sink.open(demoSession());
+
+    constexpr int kTicks = 20;
+    for (int i = 1; i <= kTicks; ++i) {
+        sink.emit(tickAt(static_cast<double>(i)));
+    }
+    CHECK(sink.pump() == 1024);  // the header, one tick, and most of the second
+    CHECK(sink.pump() == 1024);  // four ticks whole, the fifth cut after 64 bytes
+    device.setCapacity(device.size());
+    CHECK_FALSE(sink.flush());
+    CHECK(sink.deviceFailed());
+
+    const Decoded d = decode(device);
+    REQUIRE(d.status == bb::ReadStatus::Ok);
+    CHECK(d.truncated);  // the torn fifth frame
+    REQUIRE(d.ticks.size() == 4);
+    CHECK(d.ticks[3].t.value() == 4.0);
+    CHECK(sink.droppedFrames() == kTicks - 4);
+}
+
+// Would catch: a pump that is not sector-bounded when less than a sector is staged, and
+// a pacer that advances the world BEFORE writing (the write would land in the next tick).
+TEST_CASE("BlackboxPumpPacer: pumps before it paces, and holds back a partial sector") {
+    FakeBlockSink device;
+    FakeClock clock;
+    Storage storage{4, 8192};
+    SdSink sink{device, clock, storage.view(),
+                SdSinkConfig{.streamTicks = true,
+                             .pumpBytesPerTick = shulib::diag::kDefaultPumpBytesPerTick}};
+    RecordingPacer inner{device};
+    shulib::motion::BlackboxPumpPacer pacer{inner, sink};
+
+    pacer.pace();  // nothing staged yet: a pass-through
+    sink.emit(tickAt(0.01));  // header + one tick: 688 B, one whole sector and a tail
+    pacer.pace();
+    REQUIRE(inner.sizesAtPace.size() == 2);
+    CHECK(inner.sizesAtPace[0] == 0);
+    CHECK(inner.sizesAtPace[1] == shulib::diag::kSectorBytes);  // written before the pace
+    CHECK(sink.bytesBuffered() == bb::kHeaderBytes + bb::kFrameHeaderBytes
+                                      + bb::kTickPayloadBytes - shulib::diag::kSectorBytes);
+    CHECK(pacer.bytesPumped() == shulib::diag::kSectorBytes);
+
+    sink.close();  // the tail goes out whole at close
+    const Decoded d = decode(device);
+    CHECK(d.sawEnd);
+    REQUIRE(d.ticks.size() == 1);
+    CHECK(d.ticks[0].t.value() == 0.01);
+}
@@ -0,0 +1,312 @@
+// Tests for the SHUL/2 wire — diag/shul2_sink.hpp: Shul2Sink writing through an
+// ICharSink and Shul2Decoder reading the bytes back. What each targets:
+//
+//  * THE PRIMITIVES, against published values: the CRC-16/CCITT-FALSE check value and
+//    the COBS examples from Cheshire & Baker, so a self-consistent but wrong CRC or
+//    stuffing (which would still round trip) is caught.
+//  * LOOPBACK: ticks, log lines and the summary, written through FakeCharSink and fed
+//    back byte by byte, decode to what was sent — ticks compared as v1 BYTES, the same
+//    bit-for-bit standard as the blackbox's compact stream — with no 0x00 inside a frame
+//    and exactly one write() per frame.
+//  * THE LINK'S FAILURES: a flipped bit fails the CRC and is not decoded; a lost frame is
+//    counted from the wire sequence and its chain's deltas are refused until the next
+//    keyframe; a host joining mid-stream resynchronises at the next delimiter.
+//  * THE BUDGET: a tight budget drops frames whole and counts them, and every tick that
+//    IS sent still decodes exactly — a budget drop never breaks the chain.
+
+#include "doctest.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shulib/diag/blackbox_format.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/run_summary.hpp"
+#include "shulib/diag/shul2_sink.hpp"
+#include "shulib/hal/char_sink.hpp"
+#include "shulib/hal/fake/fake_char_sink.hpp"
+#include "shulib/hal/telemetry_sink.hpp"
+#include "shulib/math/angle.hpp"
+#include "shulib/math/pose2d.hpp"
+
+using shulib::diag::DebugRecord;
+using shulib::diag::RunSummary;
+using shulib::diag::Shul2Decoder;
+using shulib::diag::Shul2FrameType;
+using shulib::diag::Shul2Sink;
+using shulib::diag::Shul2SinkConfig;
+using shulib::hal::LogLevel;
+using shulib::hal::fake::FakeCharSink;
+using shulib::math::Angle;
+using shulib::math::Pose2d;
+namespace bb = shulib::diag::blackbox;
+namespace units = shulib::units;
+
+namespace {
+
+/// A smoothly moving robot, as blackbox_compact_test drives it: small pose and command
+/// changes, an integer block that changes now and then.
+DebugRecord drifting(int i) {
+    const double k = static_cast<double>(i);
+    DebugRecord r;
+    r.t = units::Time{0.01 * k};
+    r.dt = units::Time{0.01};
+    r.measuredPose = Pose2d{units::Length{0.3 * k}, units::Length{12.0 + 0.01 * k},
+                            Angle::radians(0.002 * k)};
+    r.targetPose = Pose2d{units::Length{48.0}, units::Length{12.0}, Angle::radians(0.0)};
+    r.errorX = units::Length{48.0 - 0.3 * k};
+    r.quality = 0.9;
+    r.activeCommandId = static_cast<std::uint32_t>(1 + i / 100);
+    r.activeCommandState = 1;
+    return r;
+}
+
+/// The v1 bytes of `r` — the exact-equality currency of the compact stream.
+std::array<std::byte, bb::kTickPayloadBytes> v1Bytes(const DebugRecord& r) {
+    std::array<std::byte, bb::kTickPayloadBytes> out{};
+    REQUIRE(bb::encodeTick(out, r) == bb::kTickPayloadBytes);
+    return out;
+}
+
+/// Records every write() separately, so the one-frame-per-write contract is checkable.
+class WriteLog final : public shulib::hal::ICharSink {
+public:
+    void write(std::string_view text) override { writes.emplace_back(text); }
+    std::vector<std::string> writes;
+};
+
+std::span<const std::byte> bytesOf(std::string_view s) {
+    return {reinterpret_cast<const std::byte*>(s.data()), s.size()};
+}
+
+/// Everything one decoder pass saw.
+struct Received {
+    std::vector<DebugRecord> ticks;
+    std::vector<std::string> logs;
+    std::vector<Shul2FrameType> types;
+    bool summary = false;
+    RunSummary summaryData{};
+    std::uint32_t summaryDropped = 0;
+    bool corrupt = false;
+};
+
+Received decodeAll(Shul2Decoder& d, std::string_view wire) {
+    Received got;
+    for (const std::byte b : bytesOf(wire)) {
+        if (!d.feed(b)) {
+            continue;
+        }
+        got.types.push_back(d.frame().type);
+        DebugRecord r;
+        Shul2Decoder::LogLine line;
+        if (d.readTick(r, got.corrupt)) {
+            got.ticks.push_back(r);
+        } else if (d.readLog(line)) {
+            got.logs.push_back(std::string{line.tag} + "|" + std::string{line.message});
+        } else if (d.readSummary(got.summaryData, got.summaryDropped)) {
+            got.summary = true;
+        }
+    }
+    return got;
+}
+
+}  // namespace
+
+// Would catch: a reflected or wrongly-initialised CRC, or COBS that places its code
+// bytes wrongly — both self-consistent, so only published vectors catch them.
+TEST_CASE("shul2: CRC-16 and COBS match their published vectors") {
+    const std::string_view check = "123456789";
+    CHECK(shulib::diag::crc16CcittFalse(bytesOf(check)) == 0x29B1U);
+
+    const auto cobs = [](std::vector<std::uint8_t> in) {
+        std::vector<std::byte> raw(in.size());
+        std::memcpy(raw.data(), in.data(), in.size());
+        std::vector<std::byte> out(in.size() + in.size() / 254 + 1);
+        const std::size_t n = shulib::diag::cobsEncode(raw, out);
+        std::vector<std::uint8_t> enc(n);
+        std::memcpy(enc.data(), out.data(), n);
+        // And back again.
+        std::vector<std::byte> back(in.size() + 1);
+        const std::size_t m = shulib::diag::cobsDecode(std::span<const std::byte>{out}.first(n), back);
+        CHECK(m == in.size());
+        CHECK(std::memcmp(back.data(), raw.data(), in.size()) == 0);
+        return enc;
+    };
+    CHECK(cobs({0x00}) == std::vector<std::uint8_t>{0x01, 0x01});
+    CHECK(cobs({0x00, 0x00}) == std::vector<std::uint8_t>{0x01, 0x01, 0x01});
+    CHECK(cobs({0x11, 0x22, 0x00, 0x33}) == std::vector<std::uint8_t>{0x03, 0x11, 0x22, 0x02, 0x33});
+    CHECK(cobs({0x11, 0x00, 0x00, 0x00}) == std::vector<std::uint8_t>{0x02, 0x11, 0x01, 0x01, 0x01});
+
+    std::vector<std::uint8_t> run(254);
+    for (std::size_t i = 0; i < run.size(); ++i) {
+        run[i] = static_cast<std::uint8_t>(i + 1);
+    }
+    const std::vector<std::uint8_t> enc = cobs(run);
+    REQUIRE(enc.size() == 256);
+    CHECK(enc.front() == 0xFF);
+    CHECK(enc.back() == 0x01);
+}
+
+// Would catch: a field the wire drops or reorders, a log line torn across writes, a
+// 0x00 leaking into a frame body, or the summary losing the sink's drop count.
+TEST_CASE("shul2: ticks, logs and the summary loop back exactly through FakeCharSink") {
+    FakeCharSink wire;
+    Shul2Sink sink{wire};
+    REQUIRE(sink.wantsRecord());
+
+    std::vector<DebugRecord> sent;
+    for (int i = 0; i < 300; ++i) {
+        sent.push_back(drifting(i));
+        sink.emit(sent.back());
+        if (i % 100 == 0) {
+            sink.log(LogLevel::Warn, "SEQ", "retry\n1/3 é");
+        }
+    }
+    RunSummary summary;
+    summary.motionsStarted = 3;
+    summary.motionsSettled = 2;
+    sink.summarize(summary);
+
+    CHECK(sink.droppedTicks() == 0);
+    CHECK(sink.droppedLines() == 0);
+    CHECK(sink.bytesSent() == wire.text().size());
+    CHECK(sink.keyframesSent() == 6);  // every 50 ticks
+
+    Shul2Decoder d;
+    const Received got = decodeAll(d, wire.text());
+    CHECK_FALSE(got.corrupt);
+    CHECK(d.frames() == sink.framesSent());
+    CHECK(d.lostFrames() == 0);
+    CHECK(d.crcErrors() == 0);
+    CHECK(d.framingErrors() == 0);
+    REQUIRE(got.ticks.size() == sent.size());
+    for (std::size_t i = 0; i < sent.size(); ++i) {
+        CAPTURE(i);
+        CHECK(v1Bytes(got.ticks[i]) == v1Bytes(sent[i]));
+    }
+    REQUIRE(got.logs.size() == 3);
+    CHECK(got.logs[0] == "SEQ|retry\n1/3 é");
+    REQUIRE(got.summary);
+    CHECK(got.summaryData.motionsStarted == 3);
+    CHECK(got.summaryData.motionsSettled == 2);
+    CHECK(got.summaryDropped == 0);
+
+    // The wire is compact: well under the 430-byte keyframe per tick on average.
+    const double perTick = static_cast<double>(sink.bytesSent()) / static_cast<double>(sent.size());
+    CHECK(perTick < 150.0);
+    MESSAGE("SHUL/2 wire: " << perTick << " bytes/tick over " << sent.size() << " ticks");
+
+    // One write() per frame, each ending in its only 0x00.
+    WriteLog writes;
+    Shul2Sink perWrite{writes};
+    for (int i = 0; i < 10; ++i) {
+        perWrite.emit(drifting(i));
+    }
+    perWrite.log(LogLevel::Info, "LOC", "hello");
+    REQUIRE(writes.writes.size() == 11);
+    for (const std::string& w : writes.writes) {
+        CHECK(w.find('\0') == w.size() - 1);
+    }
+}
+
+// Would catch: a decoder that trusts a corrupted frame, that misses a lost frame, or that
+// reconstructs a delta against the wrong predecessor after one — and one that cannot find
+// its footing when it starts listening half-way through a frame.
+TEST_CASE("shul2: corruption is refused, loss is counted, and a joining host resyncs") {
+    WriteLog writes;
+    Shul2Sink sink{writes, Shul2SinkConfig{.keyframeInterval = 10}};
+    std::vector<DebugRecord> sent;
+    for (int i = 0; i < 40; ++i) {
+        sent.push_back(drifting(i));
+        sink.emit(sent.back());
+    }
+    REQUIRE(writes.writes.size() == 40);
+
+    SUBCASE("a flipped bit fails the CRC") {
+        std::string stream;
+        for (std::size_t i = 0; i < writes.writes.size(); ++i) {
+            std::string w = writes.writes[i];
+            if (i == 5) {
+                // Flip one bit of a body byte without turning it into a delimiter.
+                const char c = w[w.size() / 2];
+                w[w.size() / 2] = static_cast<char>(c ^ (c == 0x10 ? 0x20 : 0x10));
+            }
+            stream += w;
+        }
+        Shul2Decoder d;
+        const Received got = decodeAll(d, stream);
+        CHECK(d.crcErrors() + d.framingErrors() == 1);
+        CHECK(d.lostFrames() == 1);  // the sequence sees the hole the bad frame left
+        // Tick 5's delta is gone, so 6..9 are refused; tick 10 is a keyframe.
+        CHECK(d.unresolvedTicks() == 4);
+        CHECK(got.ticks.size() == 35);
+        CHECK(v1Bytes(got.ticks[5]) == v1Bytes(sent[10]));
+    }
+    SUBCASE("a lost frame is counted and its chain refused until the keyframe") {
+        std::string stream;
+        for (std::size_t i = 0; i < writes.writes.size(); ++i) {
+            if (i != 13 && i != 14) {
+                stream += writes.writes[i];
+            }
+        }
+        Shul2Decoder d;
+        const Received got = decodeAll(d, stream);
+        CHECK(d.crcErrors() == 0);
+        CHECK(d.lostFrames() == 2);
+        CHECK(d.unresolvedTicks() == 5);  // 15..19
+        REQUIRE(got.ticks.size() == 33);
+        CHECK(v1Bytes(got.ticks.back()) == v1Bytes(sent.back()));
+    }
+    SUBCASE("a host joining mid-frame resynchronises at the next delimiter") {
+        std::string stream;
+        for (const std::string& w : writes.writes) {
+            stream += w;
+        }
+        const std::size_t join = writes.writes[0].size() + writes.writes[1].size() / 2;
+        Shul2Decoder d;
+        const Received got = decodeAll(d, std::string_view{stream}.substr(join));
+        CHECK(d.crcErrors() + d.framingErrors() == 1);  // the torn half-frame
+        CHECK(d.unresolvedTicks() == 8);               // deltas 2..9, before the keyframe
+        REQUIRE(got.ticks.size() == 30);
+        CHECK(v1Bytes(got.ticks.front()) == v1Bytes(sent[10]));
+    }
+}
+
+// Would catch: a budget that queues instead of dropping, a drop that is not counted, or a
+// dropped tick committed to the chain (every later delta would then decode wrongly).
+TEST_CASE("shul2: the per-tick budget drops whole frames and never breaks the chain") {
+    FakeCharSink wire;
+    Shul2SinkConfig cfg;
+    cfg.bytesPerTick = 40;  // below a typical delta plus a log line
+    Shul2Sink sink{wire, cfg};
+
+    for (int i = 0; i < 400; ++i) {
+        sink.emit(drifting(i));
+        sink.log(LogLevel::Debug, "MOT", "a chatty per-tick line that eats the budget");
+    }
+    CHECK(sink.droppedTicks() + sink.droppedLines() > 0);
+    CHECK(sink.bytesSent() == wire.text().size());
+    // The bucket never lends: everything sent fits the initial burst plus the refills.
+    CHECK(sink.bytesSent() <= cfg.burstBytes + 400 * cfg.bytesPerTick);
+
+    Shul2Decoder d;
+    const Received got = decodeAll(d, wire.text());
+    CHECK_FALSE(got.corrupt);
+    CHECK(d.lostFrames() == 0);  // budget drops are never sent, so never a wire gap
+    CHECK(d.unresolvedTicks() == 0);
+    CHECK(got.ticks.size() == 400 - sink.droppedTicks());
+    CHECK(got.ticks.size() >= 40);  // starved, not silenced: keyframes still get through
+    // Every tick that arrived is exactly one that was sent (ticks carry their own t).
+    for (const DebugRecord& r : got.ticks) {
+        const auto i = static_cast<int>(r.t.value() / 0.01 + 0.5);
+        CAPTURE(i);
+        CHECK(v1Bytes(r) == v1Bytes(drifting(i)));
+    }
+    MESSAGE("budget 40 B/tick: " << sink.droppedTicks() << " ticks and " << sink.droppedLines()
+                                 << " lines dropped of 400 each");
+}
@@ -0,0 +1,339 @@
+// Tests for sim::BatchPlant — N robots' DrivePlant physics in structure-of-arrays form.
+//
+// The oracle is DrivePlant itself: every robot of a batch is run beside its own SimHarness
+// under the same voltages and dt schedule, and every quantity is compared with ==, never
+// Approx — the batch's promise is BIT identity, so a reordered sum or a fused multiply-add
+// is a failure here, not a tolerance. What each case targets:
+//  * IDENTITY ROBOTS: the array motor law (dead band, kA = 0 and kA > 0), forwardBatch's
+//    sums, both truth integrators (the carried-trig RK4 loop included), the encoder shafts
+//    and the truth-derived readings — on an X-drive (the forwardBatch path) and a tank (the
+//    per-robot forward() fallback), across a dt change that must recompute the cached decay.
+//  * HOSTILE ROBOTS: a per-robot FullHostility drawing from the robot's own Rng in
+//    DrivePlant's call order, mixed with identity robots in one batch.
+//  * THROUGHPUT: robot-ticks per second against one SimHarness per robot (reported, not
+//    asserted — host timing is not a pass/fail signal in this suite).
+
+#include "doctest.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "shulib/core/check.hpp"
+#include "shulib/kinematics/kinematics.hpp"
+#include "shulib/kinematics/tank.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/math/angle.hpp"
+#include "shulib/math/pose2d.hpp"
+#include "shulib/sim/batch_plant.hpp"
+#include "shulib/sim/hostile/composed.hpp"
+#include "shulib/sim/rng.hpp"
+#include "shulib/sim/scenario.hpp"
+#include "shulib/units/quantity.hpp"
+
+using shulib::PreconditionError;
+using shulib::kinematics::TankKinematics;
+using shulib::kinematics::xDrive;
+using shulib::math::Angle;
+using shulib::math::Pose2d;
+using shulib::sim::BatchPlant;
+using shulib::sim::BatchReadings;
+using shulib::sim::BatchRobot;
+using shulib::sim::FullHostility;
+using shulib::sim::Rng;
+using shulib::sim::SimHarness;
+using shulib::sim::SimHarnessConfig;
+using shulib::sim::TrackingAxis;
+using shulib::sim::TrackingWheelSpec;
+using shulib::units::Length;
+using shulib::units::Time;
+using shulib::units::Voltage;
+
+namespace {
+
+/// Five robots that differ where the motor law branches: memoryless and lagged, a wide dead
+/// band, a different wheel, a different start pose and seed each.
+std::vector<BatchRobot> mixedRobots(std::size_t count) {
+    std::vector<BatchRobot> robots(count);
+    for (std::size_t r = 0; r < count; ++r) {
+        auto& p = robots[r].plant;
+        const double k = static_cast<double>(r);
+        p.wheelFf = {.kS = 0.5 + 0.3 * k,
+                     .kV = 12.0 / (60.0 + 5.0 * k),
+                     .kA = r % 2 == 0 ? 0.0 : 0.02 * k};
+        p.driveWheelDiameter = Length{3.25 + 0.25 * k};
+        p.initialPose = Pose2d{Length{-10.0 + 4.0 * k}, Length{3.0 * k}, Angle::degrees(25.0 * k)};
+        p.seed = 100 + r;
+    }
+    return robots;
+}
+
+/// The tracking geometry SimHarness synthesizes with, for the batch (no sensors needed).
+std::array<TrackingWheelSpec, 2> harnessTracking(const SimHarnessConfig& cfg) {
+    return {TrackingWheelSpec{nullptr, TrackingAxis::Forward, cfg.forwardWheelLeftOffset,
+                              cfg.trackingWheelDiameter},
+            TrackingWheelSpec{nullptr, TrackingAxis::Lateral, cfg.lateralWheelForwardOffset,
+                              cfg.trackingWheelDiameter}};
+}
+
+/// Every truth and reading of batch robot `r` equals harness `h`'s, bit for bit.
+void requireIdentical(const BatchPlant& batch, std::size_t r, SimHarness& h) {
+    const auto truth = batch.truthState(r);
+    const auto& ref = h.plant().truthState();
+    REQUIRE(truth.x == ref.x);
+    REQUIRE(truth.y == ref.y);
+    REQUIRE(truth.theta == ref.theta);
+    const auto twist = batch.trueBodyTwist(r);
+    CHECK(twist.vx().value() == h.plant().trueBodyTwist().vx().value());
+    CHECK(twist.omega().value() == h.plant().trueBodyTwist().omega().value());
+    const auto spin = batch.trueWheelSpin(r);
+    const auto refSpin = h.plant().trueWheelSpin();
+    const BatchReadings read = batch.readings(r);
+    for (int i = 0; i < batch.wheelCount(); ++i) {
+        CHECK(spin[i].value() == refSpin[i].value());
+        CHECK(read.driveEncoder[static_cast<std::size_t>(i)].value()
+              == h.motor(i).position().value());
+    }
+    CHECK(read.trackingEncoder[0].value() == h.forwardEncoder().position().value());
+    CHECK(read.trackingEncoder[1].value() == h.lateralEncoder().position().value());
+    CHECK(read.imuHeading.radians() == h.imu().heading().radians());
+    CHECK(read.imuYawRate.value() == h.imu().yawRate().value());
+    CHECK(read.imuReady == h.imu().isReady());
+    CHECK(read.gps.pose.x().value() == h.gps().pose().x().value());
+    CHECK(read.gps.hasFix == h.gps().hasFix());
+    CHECK(read.batteryVoltage.value() == h.battery().voltage().value());
+}
+
+/// Drive `batch` and one harness per robot with the same random voltages for `ticks` ticks
+/// (dt switching mid-run), checking identity after every tick.
+void runSideBySide(BatchPlant& batch, std::vector<std::unique_ptr<SimHarness>>& harnesses,
+                   int ticks) {
+    Rng commands{7};
+    for (int tick = 0; tick < ticks; ++tick) {
+        for (std::size_t r = 0; r < batch.robotCount(); ++r) {
+            for (int i = 0; i < batch.wheelCount(); ++i) {
+                const Voltage v{commands.uniform(-13.0, 13.0)};  // past the clamp, both ways
+                batch.setVoltage(r, i, v);
+                harnesses[r]->motor(i).setVoltage(v);
+            }
+        }
+        const Time dt{tick < ticks / 2 ? 0.01 : 0.015};
+        batch.step(dt);
+        for (std::size_t r = 0; r < batch.robotCount(); ++r) {
+            harnesses[r]->runTicks(1, dt);
+            requireIdentical(batch, r, *harnesses[r]);
+        }
+    }
+    CHECK(batch.clock().now().value() == harnesses[0]->clock().now().value());
+}
+
+}  // namespace
+
+// Would catch: any reordering of DrivePlant's arithmetic in the array passes (a reciprocal
+// multiply for a division, a hoisted sum, trig recomputed from a different heading), a
+// decay cached across a dt change, a clamp that differs from FakeMotor's, or the tank
+// fallback not taking the per-robot path.
+TEST_CASE("BatchPlant: identity robots are bit-identical to their own DrivePlant") {
+    const auto robots = mixedRobots(5);
+    SimHarnessConfig base;
+    const auto tracking = harnessTracking(base);
+
+    const auto runWith = [&](const shulib::kinematics::IKinematics& kin, BatchPlant& batch) {
+        std::vector<std::unique_ptr<SimHarness>> harnesses;
+        for (const BatchRobot& robot : robots) {
+            SimHarnessConfig cfg = base;
+            cfg.plant = robot.plant;
+            harnesses.push_back(std::make_unique<SimHarness>(kin, cfg));
+        }
+        requireIdentical(batch, 3, *harnesses[3]);  // the seeded start, before any tick
+        runSideBySide(batch, harnesses, 120);
+    };
+
+    SUBCASE("X-drive: the forwardBatch path") {
+        const auto kin = xDrive(Length{7.0});
+        BatchPlant batch{kin, robots, tracking};
+        runWith(kin, batch);
+    }
+    SUBCASE("X-drive under fixed RK4: the lockstep truth loop") {
+        auto fixed = robots;
+        for (BatchRobot& robot : fixed) {
+            robot.plant.truthIntegrator = shulib::sim::TruthIntegrator::FixedRk4;
+        }
+        const auto kin = xDrive(Length{7.0});
+        BatchPlant batch{kin, fixed, tracking};
+        std::vector<std::unique_ptr<SimHarness>> harnesses;
+        for (const BatchRobot& robot : fixed) {
+            SimHarnessConfig cfg = base;
+            cfg.plant = robot.plant;
+            harnesses.push_back(std::make_unique<SimHarness>(kin, cfg));
+        }
+        runSideBySide(batch, harnesses, 120);
+    }
+    SUBCASE("X-drive under Adaptive, every tick split across the Gauss–Legendre pass and DP") {
+        // Per robot, by r % 3: straight (±V per side, ω exactly 0), a heading hold's trim (a
+        // sweep inside kTruthQuadratureMaxSweep), and a hard turn (Dormand–Prince).
+        const auto mixed = mixedRobots(6);
+        const auto kin = xDrive(Length{7.0});
+        BatchPlant batch{kin, mixed, tracking};
+        std::vector<std::unique_ptr<SimHarness>> harnesses;
+        for (const BatchRobot& robot : mixed) {
+            SimHarnessConfig cfg = base;
+            cfg.plant = robot.plant;
+            harnesses.push_back(std::make_unique<SimHarness>(kin, cfg));
+        }
+        int turningQuadrature = 0;
+        int dormandPrince = 0;
+        for (int tick = 0; tick < 80; ++tick) {
+            for (std::size_t r = 0; r < batch.robotCount(); ++r) {
+                for (int i = 0; i < batch.wheelCount(); ++i) {
+                    const double side = i < 2 ? -1.0 : 1.0;
+                    const double trim = r % 3 == 0 ? 0.0 : (r % 3 == 1 ? 0.01 : 4.0);
+                    const Voltage v{side * 6.0 + trim * static_cast<double>(i)};
+                    batch.setVoltage(r, i, v);
+                    harnesses[r]->motor(i).setVoltage(v);
+                }
+            }
+            batch.step(Time{0.01});
+            for (std::size_t r = 0; r < batch.robotCount(); ++r) {
+                harnesses[r]->runTicks(1, Time{0.01});
+                requireIdentical(batch, r, *harnesses[r]);
+                const auto t = batch.trueBodyTwist(r);
+                const double w = t.omega().value();
+                if (!shulib::sim::truthQuadratureCovers(t.vx().value(), t.vy().value(), w, 0.01,
+                                                        shulib::sim::kTruthTolerance)) {
+                    ++dormandPrince;
+                } else if (w != 0.0) {
+                    ++turningQuadrature;
+                }
+            }
+        }
+        CHECK(turningQuadrature > 0);
+        CHECK(dormandPrince > 0);
+    }
+    SUBCASE("tank: the per-robot forward() fallback") {
+        const TankKinematics kin{Length{12.0}};
+        BatchPlant batch{kin, robots, tracking};
+        runWith(kin, batch);
+    }
+    SUBCASE("the batch rejects what DrivePlant rejects, and robots that cannot share a loop") {
+        const auto kin = xDrive(Length{7.0});
+        auto bad = robots;
+        bad[2].plant.truthSubsteps = 8;
+        CHECK_THROWS_AS(BatchPlant(kin, bad, tracking), PreconditionError);
+        bad = robots;
+        bad[1].plant.wheelFf.kV = 0.0;
+        CHECK_THROWS_AS(BatchPlant(kin, bad, tracking), PreconditionError);
+        BatchPlant batch{kin, robots};
+        CHECK_THROWS_AS(batch.setVoltage(5, 0, Voltage{1.0}), PreconditionError);
+        batch.setVoltage(0, 0, Voltage{40.0});
+        CHECK(batch.commandedVoltage(0, 0).value() == 12.0);
+    }
+}
+
+// Would catch: a hostile robot whose seams are called out of DrivePlant's order (or skipped
+// because the batch has no fakes), draws taken from a shared stream instead of the robot's
+// own, or a hostile robot's scratch written back to the wrong slot among identity robots.
+TEST_CASE("BatchPlant: hostile robots draw their own streams in DrivePlant's order") {
+    const auto kin = xDrive(Length{7.0});
+    auto robots = mixedRobots(4);
+    std::vector<std::unique_ptr<FullHostility>> batchWorlds;
+    std::vector<std::unique_ptr<FullHostility>> harnessWorlds;
+    for (const std::size_t r : {std::size_t{0}, std::size_t{2}}) {
+        batchWorlds.push_back(std::make_unique<FullHostility>());
+        robots[r].degradation = &batchWorlds.back()->model();
+    }
+    SimHarnessConfig base;
+    BatchPlant batch{kin, robots, harnessTracking(base)};
+
+    std::vector<std::unique_ptr<SimHarness>> harnesses;
+    for (const BatchRobot& robot : robots) {
+        SimHarnessConfig cfg = base;
+        cfg.plant = robot.plant;
+        shulib::sim::DegradationModel* world = nullptr;
+        if (robot.degradation != nullptr) {
+            harnessWorlds.push_back(std::make_unique<FullHostility>());
+            world = &harnessWorlds.back()->model();
+        }
+        harnesses.push_back(std::make_unique<SimHarness>(kin, cfg, nullptr, world));
+    }
+    runSideBySide(batch, harnesses, 150);
+
+    // The hostility is live: the hostile robot's IMU no longer reads its truth.
+    const BatchReadings read = batch.readings(0);
+    CHECK(read.imuHeading.radians() != batch.truePose(0).heading().radians());
+}
+
+// Would catch: nothing functional — it REPORTS robot-ticks per second for the batch against
+// one SimHarness per robot (the workload a sweep replaces), turning and driving straight, and
+// proves the timed runs agree. Adaptive truth first: it is the default, so it is what a sweep
+// runs; FixedRk4 after it, for runs pinned to the pre-adaptive numbers.
+TEST_CASE("BatchPlant: robot-ticks per second against one SimHarness per robot") {
+    constexpr std::size_t kRobots = 64;
+    constexpr int kTicks = 200;
+    const auto kin = xDrive(Length{7.0});
+    SimHarnessConfig base;
+    const auto tracking = harnessTracking(base);
+
+    const auto measure = [&](shulib::sim::TruthIntegrator integrator, bool straight) {
+        auto robots = mixedRobots(kRobots);
+        for (BatchRobot& robot : robots) {
+            robot.plant.truthIntegrator = integrator;
+        }
+        std::vector<std::unique_ptr<SimHarness>> harnesses;
+        for (const BatchRobot& robot : robots) {
+            SimHarnessConfig cfg = base;
+            cfg.plant = robot.plant;
+            harnesses.push_back(std::make_unique<SimHarness>(kin, cfg));
+        }
+        BatchPlant batch{kin, robots, tracking};
+        // Straight: ±V per side, so the X-drive's ω is exactly 0. Turning: every wheel differs.
+        const auto volts = [straight](std::size_t r, int i, int tick) {
+            const double side = i < 2 ? -1.0 : 1.0;
+            if (straight) {
+                return Voltage{side * (6.0 + 0.02 * static_cast<double>(r))};
+            }
+            return Voltage{8.0 * side + 0.01 * static_cast<double>(r)
+                           - 0.002 * static_cast<double>(tick % 50) * static_cast<double>(i)};
+        };
+
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < kTicks; ++tick) {
+            for (std::size_t r = 0; r < kRobots; ++r) {
+                for (int i = 0; i < 4; ++i) {
+                    harnesses[r]->motor(i).setVoltage(volts(r, i, tick));
+                }
+                harnesses[r]->runTicks(1, Time{0.01});
+            }
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < kTicks; ++tick) {
+            for (std::size_t r = 0; r < kRobots; ++r) {
+                for (int i = 0; i < 4; ++i) {
+                    batch.setVoltage(r, i, volts(r, i, tick));
+                }
+            }
+            batch.step(Time{0.01});
+        }
+        const auto t2 = std::chrono::steady_clock::now();
+
+        for (std::size_t r = 0; r < kRobots; ++r) {
+            CHECK(batch.truthState(r).x == harnesses[r]->plant().truthState().x);
+            CHECK(batch.truthState(r).theta == harnesses[r]->plant().truthState().theta);
+        }
+        const double robotTicks = static_cast<double>(kRobots) * kTicks;
+        const double plantRate = robotTicks / std::chrono::duration<double>(t1 - t0).count();
+        const double batchRate = robotTicks / std::chrono::duration<double>(t2 - t1).count();
+        const bool adaptive = integrator == shulib::sim::TruthIntegrator::Adaptive;
+        MESSAGE(kRobots << " robots " << std::string{straight ? "straight" : "turning"} << ", "
+                        << std::string{adaptive ? "Adaptive" : "FixedRk4"} << ": DrivePlant "
+                        << plantRate << " robot-ticks/s, BatchPlant " << batchRate
+                        << " robot-ticks/s (host, " << batchRate / plantRate << "x)");
+    };
+    measure(shulib::sim::TruthIntegrator::Adaptive, false);
+    measure(shulib::sim::TruthIntegrator::Adaptive, true);
+    measure(shulib::sim::TruthIntegrator::FixedRk4, false);
+    measure(shulib::sim::TruthIntegrator::FixedRk4, true);
+}
@@ -0,0 +1,182 @@
+// Tests for sim/sim_bench.hpp (the engine of tools/shulib_simbench). Throughput itself is
+// host-specific and is only reported here, never asserted (the header's "The baseline").
+// What each targets:
+//  * CASES: the three canonical cases parse, with the hostility, fusion and tags they name.
+//  * BASELINE: format → parse round-trips; a malformed line is refused with its line; the
+//    check flags a drop past the limit, any allocation rise and an unknown case, and
+//    nothing else.
+//  * ALLOCATION PIN: the clean and hostile loops allocate NOTHING per tick; the ekf-tags
+//    loop allocates only the fake camera's frame copies. Exact, so it lives in the suite.
+//  * BREAKDOWN: the profiled pass names the zones the header promises, over the same ticks.
+
+#include "doctest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "shulib/diag/zone_profiler.hpp"
+#include "shulib/sim/scenario_file.hpp"
+#include "shulib/sim/sim_bench.hpp"
+
+// The counters live in `apriltag_corrector_cost_test.cpp`, behind the global operator
+// new/delete replacements defined there.
+namespace shulib_alloc_probe {
+extern std::size_t allocations;
+extern bool counting;
+}  // namespace shulib_alloc_probe
+
+using shulib::sim::ScenarioFusion;
+using shulib::sim::ScenarioSpec;
+using shulib::sim::SimBenchBaselineEntry;
+using shulib::sim::SimBenchOptions;
+using shulib::sim::SimBenchResult;
+
+namespace {
+
+std::uint64_t probeAllocations() { return shulib_alloc_probe::allocations; }
+
+/// One seed, one pass — the pin and the breakdown need the work, not the best time.
+SimBenchResult runOnce(const ScenarioSpec& spec, bool breakdown) {
+    SimBenchOptions options;
+    options.allocations = &probeAllocations;
+    options.repeats = 1;
+    options.breakdown = breakdown;
+    shulib_alloc_probe::allocations = 0;
+    shulib_alloc_probe::counting = true;
+    SimBenchResult r = shulib::sim::runSimBench(spec, options);
+    shulib_alloc_probe::counting = false;
+    return r;
+}
+
+SimBenchResult fakeResult(const char* name, long ticks, double wallSeconds,
+                          std::int64_t allocations) {
+    SimBenchResult r;
+    r.name = name;
+    r.ticks = ticks;
+    r.wallSeconds = wallSeconds;
+    r.allocations = allocations;
+    return r;
+}
+
+[[maybe_unused]] bool hasZone(const SimBenchResult& r, const char* name) {
+    for (const shulib::diag::ZoneTimingRow& z : r.zones) {
+        if (std::strcmp(z.name, name) == 0) {
+            return z.calls > 0;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+// Would catch: a canonical case that no longer parses (the tool would abort), or one that
+// silently lost its hostility, its EKF or its tags — a bench of the wrong loop.
+TEST_CASE("sim bench: the three canonical cases name their loop") {
+    const std::vector<ScenarioSpec> cases = shulib::sim::simBenchCases(4);
+    REQUIRE(cases.size() == 3);
+    CHECK(cases[0].name == "clean");
+    CHECK(cases[1].name == "hostile");
+    CHECK(cases[2].name == "ekf-tags");
+    for (const ScenarioSpec& s : cases) {
+        CHECK(s.seedFirst == 1);
+        CHECK(s.seedLast == 4);
+        CHECK(s.verbs.size() == 6);
+    }
+    CHECK(cases[0].fusion == ScenarioFusion::Complementary);
+    CHECK_FALSE(cases[0].tags);
+    CHECK(cases[1].fusion == ScenarioFusion::Complementary);
+    CHECK_FALSE(cases[1].tags);
+    CHECK(cases[2].fusion == ScenarioFusion::Ekf);
+    CHECK(cases[2].tags);
+}
+
+// Would catch: a baseline the tool writes but cannot read back, a malformed line accepted
+// as zero throughput (every run would then "pass"), or a check that flags noise inside the
+// limit, misses a real drop, forgives an allocation or skips a case it does not know.
+TEST_CASE("sim bench: baseline round trip and the regression check") {
+    const std::vector<SimBenchResult> base = {fakeResult("clean", 1000, 0.01, 0),
+                                              fakeResult("ekf-tags", 1000, 0.04, 160)};
+    std::vector<SimBenchBaselineEntry> parsed;
+    std::string error;
+    REQUIRE(shulib::sim::parseSimBenchBaseline(shulib::sim::formatSimBenchBaseline(base),
+                                               parsed, error));
+    REQUIRE(parsed.size() == 2);
+    CHECK(parsed[0].name == "clean");
+    CHECK(parsed[0].ticksPerSecond == doctest::Approx(100000.0));
+    CHECK(parsed[0].allocationsPerTick == 0.0);
+    CHECK(parsed[1].ticksPerSecond == doctest::Approx(25000.0));
+    CHECK(parsed[1].allocationsPerTick == doctest::Approx(0.16));
+
+    CHECK_FALSE(shulib::sim::parseSimBenchBaseline("# ok\nclean 100 0\nhostile 0 0\n", parsed,
+                                                   error));
+    CHECK(error.rfind("line 3:", 0) == 0);
+    CHECK_FALSE(shulib::sim::parseSimBenchBaseline("clean fast 0\n", parsed, error));
+    REQUIRE(shulib::sim::parseSimBenchBaseline(shulib::sim::formatSimBenchBaseline(base),
+                                               parsed, error));
+
+    // 5% slower: inside a 20% limit. 25% slower: outside it.
+    CHECK(shulib::sim::checkSimBench({fakeResult("clean", 1000, 0.0105, 0)}, parsed, 20.0)
+              .empty());
+    CHECK(shulib::sim::checkSimBench({fakeResult("clean", 1000, 0.01 / 0.75, 0)}, parsed, 20.0)
+              .size() == 1);
+    // Faster is never a regression; one allocation more per ten ticks is.
+    CHECK(shulib::sim::checkSimBench({fakeResult("clean", 1000, 0.005, 0)}, parsed, 20.0)
+              .empty());
+    const std::vector<std::string> allocs =
+        shulib::sim::checkSimBench({fakeResult("clean", 1000, 0.01, 100)}, parsed, 20.0);
+    REQUIRE(allocs.size() == 1);
+    CHECK(allocs[0].find("allocations/tick") != std::string::npos);
+    // Uncounted allocations are not compared; an unknown case is.
+    CHECK(shulib::sim::checkSimBench({fakeResult("ekf-tags", 1000, 0.04, -1)}, parsed, 20.0)
+              .empty());
+    const std::vector<std::string> unknown =
+        shulib::sim::checkSimBench({fakeResult("hostile", 1000, 0.01, 0)}, parsed, 20.0);
+    REQUIRE(unknown.size() == 1);
+    CHECK(unknown[0] == "hostile: not in the baseline");
+}
+
+// Would catch: a per-tick allocation creeping into the plant, a fake, the Localizer, the
+// scheduler or motion (a vector grown in a hot path, a std::function rebuilt each tick),
+// or the tag path allocating far beyond the fake camera's frame copy.
+TEST_CASE("sim bench: the closed loop does not allocate per tick") {
+    const std::vector<ScenarioSpec> cases = shulib::sim::simBenchCases(1);
+    for (const ScenarioSpec& spec : cases) {
+        const SimBenchResult r = runOnce(spec, false);
+        CAPTURE(r.name);
+        REQUIRE(r.ticks > 0);
+        REQUIRE(r.allocations >= 0);
+        MESSAGE(r.name << ": " << r.ticks << " ticks, " << r.ticksPerSecond()
+                       << " ticks/s, " << r.allocationsPerTick()
+                       << " allocations/tick (host, 1x)");
+        if (spec.tags) {
+            // FakeTagSource copies a frame's observations on each setTags/poll.
+            CHECK(r.allocationsPerTick() > 0.0);
+            CHECK(r.allocationsPerTick() <= 0.2);
+        } else {
+            CHECK(r.allocations == 0);
+        }
+    }
+}
+
+// Would catch: a zone the pacer or the scheduler stopped opening (the breakdown would
+// quietly lose a row), or a profiled pass that runs different work from the timed one.
+TEST_CASE("sim bench: the breakdown names the loop's zones over the same ticks") {
+    const ScenarioSpec spec = shulib::sim::simBenchCases(1)[2];
+    const SimBenchResult r = runOnce(spec, true);
+    CHECK(r.profiledTicks == r.ticks);
+    CHECK(r.profiledSeconds > 0.0);
+#if defined(SHULIB_ENABLE_ZONES)
+    CHECK(hasZone(r, "plant"));
+    CHECK(hasZone(r, "sense"));
+    CHECK(hasZone(r, "loc"));
+    CHECK(hasZone(r, "fuse"));
+    CHECK(hasZone(r, "tags"));
+    CHECK(hasZone(r, "mot"));
+    CHECK(shulib::sim::formatSimBench({r}).find("  other ") != std::string::npos);
+#else
+    CHECK(r.zones.empty());
+#endif
+}
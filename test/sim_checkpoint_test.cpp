@@ -0,0 +1,254 @@
+// Tests for SimHarness::snapshot/restore (scenario.hpp, "Checkpoint and fork"). What each
+// targets:
+//  * DETERMINISM: a branch restored from a checkpoint into a fresh harness replays the
+//    straight run BYTE-FOR-BYTE — TruthSample stream and every fake reading — under the
+//    identity model and under FullHostility (latency rings, held GPS samples, thermal and
+//    slip history, the drawn IMU bias, the Rng mid-stream), over a jittered dt schedule.
+//  * THE BLOB: a snapshot memcpy'd to another buffer restores the same way.
+//  * PRECONDITIONS: a rewind, a differently wired harness and a different degradation
+//    chain are refused.
+//  * THE POINT: a K-branch sweep that forks from the checkpoint instead of re-running the
+//    prefix, measured (host, report-only).
+
+#include "doctest.h"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "shulib/core/check.hpp"
+#include "shulib/kinematics/tank.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/math/twist2d.hpp"
+#include "shulib/sim/hostile/composed.hpp"
+#include "shulib/sim/scenario.hpp"
+#include "shulib/units/quantity.hpp"
+
+using shulib::PreconditionError;
+using shulib::kinematics::TankKinematics;
+using shulib::kinematics::xDrive;
+using shulib::math::ChassisSpeeds;
+using shulib::sim::FullHostility;
+using shulib::sim::randomBodyTwist;
+using shulib::sim::SimHarness;
+using shulib::sim::SimHarnessConfig;
+using shulib::sim::SimSnapshot;
+using shulib::sim::TruthSample;
+using shulib::units::Length;
+using shulib::units::Time;
+
+namespace {
+
+[[nodiscard]] SimHarnessConfig harnessConfig() {
+    SimHarnessConfig cfg;
+    cfg.plant.wheelFf = {.kS = 1.2, .kV = 0.17, .kA = 0.051};
+    cfg.plant.seed = 43;
+    return cfg;
+}
+
+/// A jittered tick: the dt schedule is part of the scenario, so a branch must see it too.
+[[nodiscard]] Time dtFor(int tick) { return Time{tick % 3 == 0 ? 0.012 : 0.01}; }
+
+/// Everything the code under test can read, as raw doubles (memcmp-comparable).
+struct Readings {
+    double imuHeading;
+    double imuYawRate;
+    double gpsX;
+    double gpsY;
+    double gpsRms;
+    double motor0;
+    double motor3;
+    double forward;
+    double lateral;
+    double battery;
+};
+
+[[nodiscard]] Readings readings(SimHarness& h) {
+    return Readings{h.imu().heading().radians(),
+                    h.imu().yawRate().value(),
+                    h.gps().pose().x().value(),
+                    h.gps().pose().y().value(),
+                    h.gps().rmsError().value(),
+                    h.motor(0).position().value(),
+                    h.motor(3).position().value(),
+                    h.forwardEncoder().position().value(),
+                    h.lateralEncoder().position().value(),
+                    h.battery().voltage().value()};
+}
+
+/// What one stretch of a run produced.
+struct Trace {
+    std::vector<TruthSample> truth;
+    std::vector<Readings> sensed;
+};
+
+/// `ticks` ticks from tick `first` on: a twist redrawn from the harness's own Rng every
+/// 20 ticks (so the Rng's position matters), scaled per branch so branches differ.
+Trace drive(SimHarness& h, int first, int ticks, double branchScale) {
+    Trace out;
+    ChassisSpeeds cmd{};
+    h.runTicksVariable(
+        ticks, [&](int i) { return dtFor(first + i); },
+        [&](int i) {
+            if ((first + i) % 20 == 0) {
+                const ChassisSpeeds c = randomBodyTwist(h.rng(), 30.0, 2.0);
+                cmd = ChassisSpeeds{c.vx() * branchScale, c.vy() * branchScale, c.omega()};
+            }
+            h.commandBodyTwist(cmd);
+            out.truth.push_back(h.sample());
+            out.sensed.push_back(readings(h));
+        });
+    out.truth.push_back(h.sample());
+    out.sensed.push_back(readings(h));
+    return out;
+}
+
+[[nodiscard]] bool byteIdentical(const Trace& a, const Trace& b) {
+    return a.truth.size() == b.truth.size() && a.sensed.size() == b.sensed.size()
+        && std::memcmp(a.truth.data(), b.truth.data(), a.truth.size() * sizeof(TruthSample)) == 0
+        && std::memcmp(a.sensed.data(), b.sensed.data(), a.sensed.size() * sizeof(Readings))
+               == 0;
+}
+
+constexpr int kPrefix = 300;
+constexpr int kSuffix = 150;
+
+/// The determinism proof for one world: `makeWorld` builds a fresh world for every
+/// harness, as a real fork would (its get() is the degradation model; nullptr: identity).
+template <typename MakeWorld>
+void checkForksReplayStraightRuns(MakeWorld&& makeWorld) {
+    const auto kin = xDrive(Length{7.0});
+    for (const double scale : {1.0, 0.5, -0.8}) {
+        auto straightWorld = makeWorld();
+        SimHarness straight{kin, harnessConfig(), nullptr, straightWorld->get()};
+        (void)drive(straight, 0, kPrefix, 1.0);
+        const Trace expected = drive(straight, kPrefix, kSuffix, scale);
+
+        auto prefixWorld = makeWorld();
+        SimHarness prefix{kin, harnessConfig(), nullptr, prefixWorld->get()};
+        (void)drive(prefix, 0, kPrefix, 1.0);
+        const auto snap = std::make_unique<SimSnapshot>();
+        prefix.snapshot(*snap);
+
+        auto branchWorld = makeWorld();
+        SimHarness branch{kin, harnessConfig(), nullptr, branchWorld->get()};
+        branch.restore(*snap);
+        const TruthSample atFork = prefix.sample();
+        const TruthSample restored = branch.sample();
+        CHECK(std::memcmp(&restored, &atFork, sizeof(TruthSample)) == 0);
+        CHECK(byteIdentical(drive(branch, kPrefix, kSuffix, scale), expected));
+
+        // The blob is the whole state: a memcpy of it forks just as well.
+        const auto copy = std::make_unique<SimSnapshot>();
+        std::memcpy(copy.get(), snap.get(), sizeof(SimSnapshot));
+        auto copyWorld = makeWorld();
+        SimHarness fromCopy{kin, harnessConfig(), nullptr, copyWorld->get()};
+        fromCopy.restore(*copy);
+        CHECK(byteIdentical(drive(fromCopy, kPrefix, kSuffix, scale), expected));
+    }
+}
+
+/// Adapts FullHostility to the "fresh model per harness" shape (model() is what the
+/// harness takes; the owner must outlive it).
+struct HostileWorld {
+    FullHostility full;
+    [[nodiscard]] shulib::sim::DegradationModel* get() { return &full.model(); }
+};
+
+struct IdentityWorld {
+    [[nodiscard]] shulib::sim::DegradationModel* get() { return nullptr; }
+};
+
+}  // namespace
+
+// Would catch: any between-tick state left out of the snapshot — the Rng position, the
+// motor model's spin, an encoder shaft, a fake the plant wrote, the commanded volts, or
+// any hostile model's history (a latency ring restarted empty, a GPS sample re-drawn, an
+// IMU bias drawn twice) — because each shows up in the suffix's bytes.
+TEST_CASE("SimHarness snapshot: restore-then-run is byte-identical to a straight run") {
+    SUBCASE("identity model") {
+        checkForksReplayStraightRuns([] { return std::make_unique<IdentityWorld>(); });
+    }
+    SUBCASE("FullHostility") {
+        checkForksReplayStraightRuns([] { return std::make_unique<HostileWorld>(); });
+    }
+}
+
+// Would catch: a restore that rewinds the clock under code holding its timestamps, one
+// that silently accepts a snapshot from a different drivetrain, or a degradation chain
+// that reads fewer (or more) bytes than its twin wrote.
+TEST_CASE("SimHarness restore: rewinds, other wiring and other models are refused") {
+    const auto kin = xDrive(Length{7.0});
+    SimHarness h{kin, harnessConfig()};
+    (void)drive(h, 0, 50, 1.0);
+    const auto snap = std::make_unique<SimSnapshot>();
+    h.snapshot(*snap);
+    CHECK(snap->degradationBytes == 0);  // the identity model has no state
+
+    (void)drive(h, 50, 10, 1.0);
+    CHECK_THROWS_AS(h.restore(*snap), PreconditionError);  // already past the checkpoint
+
+    const TankKinematics tankKin{Length{12.0}};
+    SimHarness other{tankKin, harnessConfig()};
+    CHECK_THROWS_AS(other.restore(*snap), PreconditionError);
+
+    HostileWorld hostile;
+    SimHarness withModel{kin, harnessConfig(), nullptr, hostile.get()};
+    (void)drive(withModel, 0, 50, 1.0);
+    const auto hostileSnap = std::make_unique<SimSnapshot>();
+    withModel.snapshot(*hostileSnap);
+    CHECK(hostileSnap->degradationBytes > 0);
+    CHECK(hostileSnap->degradationBytes <= shulib::sim::kDegradationStateBytes);
+    SimHarness identity{kin, harnessConfig()};
+    CHECK_THROWS_AS(identity.restore(*hostileSnap), PreconditionError);
+    HostileWorld fresh;
+    SimHarness twin{kin, harnessConfig(), nullptr, fresh.get()};
+    CHECK_NOTHROW(twin.restore(*hostileSnap));
+}
+
+// Report-only (host timing): K branches that share a prefix, run straight (prefix + suffix
+// per branch) versus forked (prefix once, then restore + suffix per branch). The answers
+// must agree byte for byte; only the cost may differ.
+TEST_CASE("SimHarness snapshot: a forked sweep skips the shared prefix (measured)") {
+    const auto kin = xDrive(Length{7.0});
+    constexpr int kBranches = 8;
+    constexpr int kLongPrefix = 3000;
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<Trace> straightTraces;
+    const auto s0 = Clock::now();
+    for (int b = 0; b < kBranches; ++b) {
+        HostileWorld world;
+        SimHarness h{kin, harnessConfig(), nullptr, world.get()};
+        (void)drive(h, 0, kLongPrefix, 1.0);
+        straightTraces.push_back(drive(h, kLongPrefix, kSuffix, 0.25 * (b + 1)));
+    }
+    const double straightS = std::chrono::duration<double>(Clock::now() - s0).count();
+
+    std::vector<Trace> forkedTraces;
+    const auto f0 = Clock::now();
+    const auto snap = std::make_unique<SimSnapshot>();
+    {
+        HostileWorld world;
+        SimHarness h{kin, harnessConfig(), nullptr, world.get()};
+        (void)drive(h, 0, kLongPrefix, 1.0);
+        h.snapshot(*snap);
+    }
+    for (int b = 0; b < kBranches; ++b) {
+        HostileWorld world;
+        SimHarness h{kin, harnessConfig(), nullptr, world.get()};
+        h.restore(*snap);
+        forkedTraces.push_back(drive(h, kLongPrefix, kSuffix, 0.25 * (b + 1)));
+    }
+    const double forkedS = std::chrono::duration<double>(Clock::now() - f0).count();
+
+    for (int b = 0; b < kBranches; ++b) {
+        CHECK(byteIdentical(forkedTraces[static_cast<std::size_t>(b)],
+                            straightTraces[static_cast<std::size_t>(b)]));
+    }
+    MESSAGE(kBranches << " branches, " << kLongPrefix << "-tick prefix, " << kSuffix
+                      << "-tick suffix: straight " << straightS * 1e3 << " ms, forked "
+                      << forkedS * 1e3 << " ms (host, " << straightS / forkedS << "x; "
+                      << sizeof(SimSnapshot) << "-byte snapshot)");
+}
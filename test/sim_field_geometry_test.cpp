@@ -0,0 +1,384 @@
+// Tests for the field geometry (sim/field_geometry.hpp) and the plant's contact response
+// (DrivePlant "Field contact"). Every stopping point is hand geometry — wall or face minus
+// the footprint's half-size — never read back from the solver. Targets:
+//  * HEAD-ON: driving into the perimeter stops the body AT the wall, while the wheels keep
+//    spinning (drive encoders count on) and the tracking wheels stop.
+//  * SLIDE: an oblique push keeps its tangential component — contact is frictionless.
+//  * OBSTACLES: a circle, an axis-aligned box and a rotated box (the separating-axis
+//    path) each stop the body at their face.
+//  * BROADPHASE: the sort-and-sweep never drops a contact — a field of many shapes reports
+//    exactly what the shapes report one at a time.
+//  * RAYS: distance sensors read the face distance, and maxRange at zero confidence on a
+//    miss; the harness's fakes follow the pose and survive a restore.
+//  * STALL: pinned against a wall, OdoStallCheck trips; the same drive on the open floor
+//    never does.
+//  * RIGID BODY: the contact is momentum lost; pinned, the wheels stall on a grippy floor
+//    and scrub on a slick one.
+//  * DETERMINISM and CHECKPOINT: a restored harness replays a wall contact bit for bit.
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <numbers>
+#include <vector>
+
+#include "shulib/core/check.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/math/twist2d.hpp"
+#include "shulib/motion/odo_stall_check.hpp"
+#include "shulib/sim/batch_plant.hpp"
+#include "shulib/sim/field_geometry.hpp"
+#include "shulib/sim/rng.hpp"
+#include "shulib/sim/scenario.hpp"
+#include "shulib/units/quantity.hpp"
+
+using shulib::PreconditionError;
+using shulib::kinematics::xDrive;
+using shulib::math::Angle;
+using shulib::math::Pose2d;
+using shulib::sim::DistanceMount;
+using shulib::sim::FieldBox;
+using shulib::sim::FieldCircle;
+using shulib::sim::FieldContacts;
+using shulib::sim::FieldGeometry;
+using shulib::sim::PlantDynamics;
+using shulib::sim::RobotFootprint;
+using shulib::sim::SimHarness;
+using shulib::sim::SimHarnessConfig;
+using shulib::sim::SimSnapshot;
+using shulib::units::Length;
+using shulib::units::Time;
+using shulib::units::Voltage;
+
+namespace {
+
+constexpr double kS = 1.0;
+constexpr double kV = 12.0 / 70.0;
+
+[[nodiscard]] SimHarnessConfig fieldConfig(const FieldGeometry& field, const Pose2d& start) {
+    SimHarnessConfig cfg;
+    cfg.plant.wheelFf = {.kS = kS, .kV = kV, .kA = 0.0};  // kA = 0: wheel speeds are exact
+    cfg.plant.field = &field;
+    cfg.plant.initialPose = start;
+    return cfg;
+}
+
+/// Command the body twist (vx, vy) in/s through the drive's own inverse kinematics and the
+/// feedforward, so the kA = 0 plant runs it exactly.
+void drive(SimHarness& h, const shulib::kinematics::IKinematics& kin, double vx, double vy) {
+    const auto wheels = kin.toWheels(shulib::math::ChassisSpeeds{
+        shulib::units::Velocity{vx}, shulib::units::Velocity{vy},
+        shulib::units::AngularVelocity{0.0}});
+    for (int i = 0; i < wheels.size(); ++i) {
+        const double v = wheels[i].value();
+        h.motor(i).setVoltage(Voltage{v == 0.0 ? 0.0 : std::copysign(kS, v) + kV * v});
+    }
+}
+
+/// X-drive forward at `volts` (canonical FL, BL, BR, FR: the left pair runs negative).
+void driveForward(SimHarness& h, double volts) {
+    h.motor(0).setVoltage(Voltage{-volts});
+    h.motor(1).setVoltage(Voltage{-volts});
+    h.motor(2).setVoltage(Voltage{volts});
+    h.motor(3).setVoltage(Voltage{volts});
+}
+
+[[nodiscard]] Pose2d at(double x, double y, double headingDeg = 0.0) {
+    return Pose2d{Length{x}, Length{y}, Angle::degrees(headingDeg)};
+}
+
+}  // namespace
+
+// Would catch: no collision at all (the body leaves the field), a response that also zeroes
+// the wheel spin (the encoders stop with the body — OdoStallCheck would be blind), or
+// tracking wheels fed the unclipped twist.
+TEST_CASE("field contact: driving into the wall stops the body, not the wheels") {
+    const auto kin = xDrive(Length{7.0});
+    const FieldGeometry field = FieldGeometry::vexField();
+    SimHarness h{kin, fieldConfig(field, at(50.0, 0.0))};
+    drive(h, kin, 40.0, 0.0);
+    h.runTicks(100, Time{0.01});  // 13 in to the wall at 40 in/s: there by 0.33 s
+    CHECK(h.truePose().x().value() == doctest::Approx(72.0 - 9.0).epsilon(1e-9));
+    CHECK(std::abs(h.truePose().y().value()) < 1e-9);
+    CHECK(h.plant().inContact());
+
+    const double drive0 = h.motor(2).position().value();
+    const double tracking0 = h.forwardEncoder().position().value();
+    h.runTicks(100, Time{0.01});
+    CHECK(h.truePose().x().value() == doctest::Approx(63.0).epsilon(1e-9));
+    // The wheels still turn at the commanded speed: 40/√2 in/s for 1 s on a 1.625 in radius.
+    CHECK(h.motor(2).position().value() - drive0
+          == doctest::Approx(40.0 / std::numbers::sqrt2 / 1.625).epsilon(1e-9));
+    CHECK(h.forwardEncoder().position().value() == doctest::Approx(tracking0).epsilon(1e-12));
+    CHECK(h.plant().trueBodyTwist().vx().value() == doctest::Approx(0.0));
+
+    drive(h, kin, -20.0, 0.0);  // backing off releases the contact
+    h.runTicks(10, Time{0.01});
+    CHECK_FALSE(h.plant().inContact());
+    CHECK(h.truePose().x().value() == doctest::Approx(61.0).epsilon(1e-9));
+}
+
+// Would catch: a response that zeroes the whole velocity (the body sticks to the wall) or
+// clips along the wrong axis.
+TEST_CASE("field contact: an oblique push slides along the wall") {
+    const auto kin = xDrive(Length{7.0});
+    const FieldGeometry field = FieldGeometry::vexField();
+    SimHarness h{kin, fieldConfig(field, at(40.0, -30.0))};
+    drive(h, kin, 40.0, 20.0);
+    h.runTicks(100, Time{0.01});
+    CHECK(h.plant().inContact());
+    CHECK(h.truePose().x().value() == doctest::Approx(63.0).epsilon(1e-9));
+    const double y0 = h.truePose().y().value();
+    h.runTicks(50, Time{0.01});
+    CHECK(h.truePose().x().value() == doctest::Approx(63.0).epsilon(1e-9));
+    CHECK(h.truePose().y().value() - y0 == doctest::Approx(10.0).epsilon(1e-9));
+
+    h.runTicks(500, Time{0.01});  // …into the corner, where both walls hold it
+    CHECK(h.truePose().x().value() == doctest::Approx(63.0).epsilon(1e-9));
+    CHECK(h.truePose().y().value() == doctest::Approx(63.0).epsilon(1e-9));
+}
+
+// Would catch: a circle test against the footprint's centre instead of its face, a box
+// normal pointing into the box, or a separating-axis test that picks the wrong axis.
+TEST_CASE("field contact: circles and boxes stop the body at their face") {
+    const auto kin = xDrive(Length{7.0});
+    SUBCASE("circle") {
+        FieldGeometry field;
+        field.addCircle(FieldCircle{Length{30.0}, Length{0.0}, Length{5.0}});
+        SimHarness h{kin, fieldConfig(field, at(0.0, 0.0))};
+        drive(h, kin, 40.0, 0.0);
+        h.runTicks(150, Time{0.01});
+        CHECK(h.truePose().x().value() == doctest::Approx(30.0 - 5.0 - 9.0).epsilon(1e-9));
+    }
+    SUBCASE("axis-aligned box, robot turned 90°") {
+        FieldGeometry field;
+        field.addBox(FieldBox{Length{0.0}, Length{30.0}, Length{6.0}, Length{3.0}, Angle{}});
+        SimHarness h{kin, fieldConfig(field, at(0.0, 0.0, 90.0))};
+        drive(h, kin, 40.0, 0.0);  // forward is +y now
+        h.runTicks(150, Time{0.01});
+        CHECK(h.truePose().y().value() == doctest::Approx(30.0 - 3.0 - 9.0).epsilon(1e-9));
+        CHECK(std::abs(h.truePose().x().value()) < 1e-9);
+    }
+    SUBCASE("box rotated 45°: its corner meets the robot's face") {
+        FieldGeometry field;
+        field.addBox(FieldBox{Length{30.0}, Length{0.0}, Length{5.0}, Length{5.0},
+                              Angle::degrees(45.0)});
+        SimHarness h{kin, fieldConfig(field, at(0.0, 0.0))};
+        drive(h, kin, 40.0, 0.0);
+        h.runTicks(150, Time{0.01});
+        CHECK(h.truePose().x().value()
+              == doctest::Approx(30.0 - 5.0 * std::numbers::sqrt2 - 9.0).epsilon(1e-9));
+    }
+}
+
+// Would catch: a sweep that stops early (a shape missed because the order went stale on
+// insert), a y-reject with a sign error, or a bounding box too small for a rotated shape.
+TEST_CASE("FieldGeometry: the broadphase reports exactly what each shape reports alone") {
+    shulib::sim::Rng rng{2026};
+    FieldGeometry all;
+    all.setPerimeter(Length{72.0});
+    std::vector<FieldGeometry> singles;
+    FieldGeometry walls;
+    walls.setPerimeter(Length{72.0});
+    singles.push_back(walls);
+    for (int i = 0; i < FieldGeometry::kMaxObstacles; ++i) {
+        FieldGeometry one;
+        const Length x{rng.uniform(-60.0, 60.0)};
+        const Length y{rng.uniform(-60.0, 60.0)};
+        if (i % 2 == 0) {
+            const FieldCircle c{x, y, Length{rng.uniform(2.0, 8.0)}};
+            all.addCircle(c);
+            one.addCircle(c);
+        } else {
+            const FieldBox b{x, y, Length{rng.uniform(2.0, 12.0)}, Length{rng.uniform(1.0, 4.0)},
+                             Angle::radians(rng.uniform(-3.0, 3.0))};
+            all.addBox(b);
+            one.addBox(b);
+        }
+        singles.push_back(one);
+    }
+    CHECK_THROWS_AS(all.addCircle(FieldCircle{Length{0.0}, Length{0.0}, Length{1.0}}),
+                    PreconditionError);
+
+    const RobotFootprint fp{Length{9.0}, Length{7.0}};
+    int touching = 0;
+    for (int k = 0; k < 2000; ++k) {
+        const Pose2d pose{Length{rng.uniform(-75.0, 75.0)}, Length{rng.uniform(-75.0, 75.0)},
+                          Angle::radians(rng.uniform(-3.2, 3.2))};
+        const FieldContacts got = all.contacts(pose, fp);
+        std::vector<double> want;
+        for (const FieldGeometry& g : singles) {
+            const FieldContacts c = g.contacts(pose, fp);
+            for (int i = 0; i < c.count; ++i) {
+                want.push_back(c.items[static_cast<std::size_t>(i)].depth);
+            }
+        }
+        std::vector<double> have;
+        for (int i = 0; i < got.count; ++i) {
+            have.push_back(got.items[static_cast<std::size_t>(i)].depth);
+        }
+        if (want.size() > static_cast<std::size_t>(FieldContacts::kMax)) {
+            continue;  // past the reported cap (header: honest scope)
+        }
+        std::sort(want.begin(), want.end());
+        std::sort(have.begin(), have.end());
+        CAPTURE(k);
+        CHECK(have == want);
+        touching += want.empty() ? 0 : 1;
+    }
+    CHECK(touching > 200);  // the sample actually exercises contact
+}
+
+// Would catch: a ray cast from the robot centre instead of the mount, a mount heading
+// ignored, a miss that reports a confident distance, or a restore that leaves the fake
+// reading the forked run's last pose.
+TEST_CASE("distance sensors: ray casts against the same geometry") {
+    FieldGeometry field = FieldGeometry::vexField();
+    field.addCircle(FieldCircle{Length{30.0}, Length{0.0}, Length{5.0}});
+    field.addBox(FieldBox{Length{0.0}, Length{30.0}, Length{6.0}, Length{3.0}, Angle{}});
+    const Pose2d origin = at(0.0, 0.0);
+
+    const auto front = shulib::sim::senseDistance(
+        field, origin, DistanceMount{Length{9.0}, Length{0.0}, Angle{}, Length{78.0}});
+    CHECK(front.distance.value() == doctest::Approx(30.0 - 5.0 - 9.0));
+    CHECK(front.confidence == 1.0);
+    const auto back = shulib::sim::senseDistance(
+        field, origin, DistanceMount{Length{-9.0}, Length{0.0}, Angle::degrees(180.0), Length{78.0}});
+    CHECK(back.distance.value() == doctest::Approx(72.0 - 9.0));
+    const auto left = shulib::sim::senseDistance(
+        field, origin, DistanceMount{Length{0.0}, Length{4.0}, Angle::degrees(90.0), Length{78.0}});
+    CHECK(left.distance.value() == doctest::Approx(30.0 - 3.0 - 4.0));
+    const auto shortSighted = shulib::sim::senseDistance(
+        field, origin, DistanceMount{Length{-9.0}, Length{0.0}, Angle::degrees(180.0), Length{40.0}});
+    CHECK(shortSighted.distance.value() == 40.0);
+    CHECK(shortSighted.confidence == 0.0);
+    CHECK_FALSE(FieldGeometry{}.castRay(0.0, 0.0, Angle{}, 1e6).has_value());  // open floor
+
+    const auto kin = xDrive(Length{7.0});
+    SimHarnessConfig cfg = fieldConfig(field, at(0.0, -30.0));
+    cfg.distanceMounts[0] = DistanceMount{Length{9.0}, Length{0.0}, Angle{}, Length{78.0}};
+    cfg.distanceSensors = 1;
+    SimHarness h{kin, cfg};
+    CHECK(h.distance(0).distance().value() == doctest::Approx(63.0));  // seeded at construction
+    drive(h, kin, 40.0, 0.0);
+    h.runTicks(25, Time{0.01});
+    const auto snap = std::make_unique<SimSnapshot>();
+    h.snapshot(*snap);
+    h.runTicks(25, Time{0.01});
+    CHECK(h.distance(0).distance().value() == doctest::Approx(43.0).epsilon(1e-9));
+    SimHarness fork{kin, cfg};
+    CHECK(fork.distance(0).distance().value() == doctest::Approx(63.0));
+    fork.restore(*snap);
+    CHECK(fork.distance(0).distance().value() == doctest::Approx(53.0).epsilon(1e-9));
+    CHECK_THROWS_AS((void)h.distance(1), PreconditionError);
+}
+
+// Would catch: a contact response that leaves the tracking wheels rolling (no
+// disagreement for the check to see), or a check that trips on the open floor.
+TEST_CASE("field contact: pinned against the wall, OdoStallCheck trips") {
+    const auto kin = xDrive(Length{7.0});
+    const auto run = [&](const FieldGeometry& field) {
+        SimHarness h{kin, fieldConfig(field, at(40.0, 0.0))};
+        shulib::motion::OdoStallCheck check;
+        drive(h, kin, 40.0, 0.0);
+        bool stalledBeforeWall = false;
+        bool stalled = false;
+        for (int tick = 0; tick < 200; ++tick) {
+            h.runTicks(1, Time{0.01});
+            stalled = check.update(h.clock().now(), h.context().driveMotors(), h.truePose());
+            if (h.truePose().x().value() < 62.0) {
+                stalledBeforeWall = stalledBeforeWall || stalled;
+            }
+        }
+        CHECK_FALSE(stalledBeforeWall);
+        return stalled;
+    };
+    CHECK(run(FieldGeometry::vexField()));
+    CHECK_FALSE(run(FieldGeometry{}));
+}
+
+// Would catch: contact resolved once per tick in rigid mode (the body overshoots the
+// face), momentum that survives the wall, or wheels that neither stall on a grippy floor
+// nor scrub on a slick one.
+TEST_CASE("field contact: under the rigid-body plant the wall takes the momentum") {
+    const auto kin = xDrive(Length{7.0});
+    const FieldGeometry field = FieldGeometry::vexField();
+    // 15 lb on four wheels is 3.75 lbf each. At μ 0.9 a wheel holds 3.4 lbf, more than the
+    // 0.23 lbf/V motor can push at 12 V (2.8 lbf): pinned, the motors stall. At μ 0.2 it
+    // holds only 0.75 lbf, so the wheels break loose and scrub against the floor.
+    for (const double friction : {0.9, 0.2}) {
+        CAPTURE(friction);
+        SimHarnessConfig cfg = fieldConfig(field, at(40.0, 0.0));
+        cfg.plant.dynamics = PlantDynamics::RigidBody;
+        cfg.plant.rigidBody.friction = friction;
+        SimHarness h{kin, cfg};
+        driveForward(h, 12.0);
+        double furthest = 0.0;
+        for (int tick = 0; tick < 300; ++tick) {
+            h.runTicks(1, Time{0.01});
+            furthest = std::max(furthest, h.truePose().x().value());
+        }
+        CHECK(furthest <= 63.0 + 1e-9);
+        CHECK(h.truePose().x().value() == doctest::Approx(63.0).epsilon(1e-9));
+        CHECK(h.plant().inContact());
+        CHECK(std::abs(h.plant().trueBodyTwist().vx().value()) < 1e-9);
+        const auto slip = h.plant().trueWheelSlip();
+        const auto spin = h.plant().trueWheelSpin();
+        for (int i = 0; i < slip.size(); ++i) {
+            if (friction > 0.5) {
+                CHECK(std::abs(spin[i].value()) < 1.0);  // stalled
+            } else {
+                CHECK(std::abs(spin[i].value()) > 10.0);  // scrubbing: slip is the whole spin
+                CHECK(std::abs(slip[i].value()) > 10.0);
+            }
+        }
+    }
+}
+
+// Would catch: contact state outside the snapshot, run-to-run nondeterminism in the
+// response, a batch silently ignoring a field, or a distance sensor with nothing to see.
+TEST_CASE("field contact: a checkpoint replays a wall contact bit for bit; misuse refused") {
+    const auto kin = xDrive(Length{7.0});
+    const FieldGeometry field = FieldGeometry::vexField();
+    const SimHarnessConfig cfg = fieldConfig(field, at(30.0, 20.0, 30.0));
+    const auto script = [&](SimHarness& h, int from, int to) {
+        for (int tick = from; tick < to; ++tick) {
+            const double phase = 0.05 * tick;
+            h.motor(0).setVoltage(Voltage{-12.0 * std::cos(phase)});
+            h.motor(1).setVoltage(Voltage{-9.0 + 4.0 * std::sin(phase)});
+            h.motor(2).setVoltage(Voltage{12.0});
+            h.motor(3).setVoltage(Voltage{11.0 * std::sin(0.3 * phase)});
+            h.runTicks(1, Time{0.01});
+        }
+    };
+    SimHarness a{kin, cfg};
+    script(a, 0, 150);
+    const auto snap = std::make_unique<SimSnapshot>();
+    a.snapshot(*snap);
+    script(a, 150, 400);
+    SimHarness fork{kin, cfg};
+    fork.restore(*snap);
+    script(fork, 150, 400);
+    const auto straight = a.plant().state();
+    const auto forked = fork.plant().state();
+    CHECK(std::memcmp(&forked.truth, &straight.truth, sizeof straight.truth) == 0);
+    CHECK(std::memcmp(&forked.trackingShaft, &straight.trackingShaft,
+                      sizeof straight.trackingShaft) == 0);
+    CHECK(forked.inContact == straight.inContact);
+
+    SimHarnessConfig noField;
+    noField.distanceSensors = 1;
+    CHECK_THROWS_AS(SimHarness(kin, noField), PreconditionError);
+    std::vector<shulib::sim::BatchRobot> robots(1);
+    robots[0].plant = cfg.plant;
+    const shulib::sim::TrackingWheelSpec tracking[] = {
+        {nullptr, shulib::sim::TrackingAxis::Forward, Length{0.0}, Length{2.0}}};
+    CHECK_THROWS_AS(shulib::sim::BatchPlant(kin, robots, tracking), PreconditionError);
+    FieldGeometry bad;
+    CHECK_THROWS_AS(bad.setPerimeter(Length{0.0}), PreconditionError);
+    CHECK_THROWS_AS(bad.addBox(FieldBox{Length{0.0}, Length{0.0}, Length{1.0}, Length{0.0}, Angle{}}),
+                    PreconditionError);
+}
@@ -0,0 +1,199 @@
+// Tests for sim/gain_tuner.hpp. What each targets:
+//  * ONE SCENARIO: the measured run is a pure function of its inputs, a well-tuned
+//    config settles feasibly, and a watchdog too short to finish is reported as the
+//    MOTION_TIMEOUT violation it is.
+//  * THE SEARCH: from deliberately sluggish gains the tuner finds a cheaper feasible
+//    config, the report's history never gets worse, and the initializer reproduces the
+//    exact config that was scored.
+//  * THE CACHE: re-running a tuner simulates nothing new, and the counts add up.
+//  * THREADS: a serial and a parallel tuning run agree bit for bit.
+// Kept small on purpose (two scenarios, a few iterations): the test build is unoptimized.
+
+#include "doctest.h"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "motion_test_rig.hpp"
+#include "shulib/core/check.hpp"
+#include "shulib/diag/fault.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/math/angle.hpp"
+#include "shulib/math/pose2d.hpp"
+#include "shulib/sim/gain_tuner.hpp"
+
+using motion_rig::Length;
+using motion_rig::motionConfig;
+using motion_rig::plantConfig;
+using shulib::PreconditionError;
+using shulib::control::ExitReason;
+using shulib::kinematics::xDrive;
+using shulib::math::Angle;
+using shulib::math::Pose2d;
+using shulib::sim::CandidateScore;
+using shulib::sim::GainRange;
+using shulib::sim::GainTuner;
+using shulib::sim::GainTunerConfig;
+using shulib::sim::TunedGain;
+using shulib::sim::TuningMotion;
+using shulib::sim::TuningReport;
+using shulib::sim::TuningScenario;
+using shulib::sim::TuningScenarioResult;
+
+namespace {
+
+/// A drive and a turn, each on its own seed, behind the default FullHostility.
+[[nodiscard]] GainTunerConfig smallProblem() {
+    GainTunerConfig cfg;
+    cfg.base = motionConfig();
+    cfg.plant = plantConfig();
+    cfg.scenarios = {
+        {TuningMotion::MoveToPose, Pose2d{}, Pose2d{Length{20.0}, Length{0.0}, Angle{}}, 7, 8.0},
+        {TuningMotion::TurnTo, Pose2d{}, Pose2d{Length{}, Length{}, Angle::degrees(90.0)}, 8, 8.0},
+    };
+    cfg.gains = {{TunedGain::TranslationKp, 0.5, 8.0}, {TunedGain::HeadingKp, 0.5, 8.0}};
+    cfg.restarts = 1;
+    cfg.maxIterations = 6;
+    cfg.threads = 1;
+    return cfg;
+}
+
+/// smallProblem() starting from gains well below the repo's defaults.
+[[nodiscard]] GainTunerConfig sluggishStart() {
+    GainTunerConfig cfg = smallProblem();
+    cfg.base.translation.kP = 1.0;
+    cfg.base.heading.kP = 1.0;
+    return cfg;
+}
+
+}  // namespace
+
+// Would catch: a measurement graded on the estimate instead of truth, hidden shared state
+// between runs (a second run that differs), or a timed-out motion counted as feasible.
+TEST_CASE("runTuningScenario: deterministic, feasible when tuned, a timeout is a violation") {
+    const auto kin = xDrive(Length{7.0});
+    const GainTunerConfig cfg = smallProblem();
+    for (const TuningScenario& sc : cfg.scenarios) {
+        const TuningScenarioResult a = shulib::sim::runTuningScenario(kin, cfg, cfg.base, sc);
+        const TuningScenarioResult b = shulib::sim::runTuningScenario(kin, cfg, cfg.base, sc);
+        CHECK(std::memcmp(&a, &b, sizeof a) == 0);
+        CHECK(a.feasible());
+        CHECK(a.settleTime > 0.0);
+        CHECK(a.settleTime < sc.timeout);
+        CHECK(a.overshoot >= 0.0);
+        CHECK(a.finalError < 2.0);
+        CHECK(a.cost == doctest::Approx(a.settleTime + 0.5 * a.overshoot + 2.0 * a.finalError));
+    }
+
+    TuningScenario rushed = cfg.scenarios.front();
+    rushed.timeout = 0.3;  // 20 in cannot be covered in 0.3 s
+    const TuningScenarioResult r = shulib::sim::runTuningScenario(kin, cfg, cfg.base, rushed);
+    CHECK(r.exit == ExitReason::TimedOut);
+    CHECK(r.timeoutFaults == 1);
+    CHECK_FALSE(r.feasible());
+}
+
+// Would catch: a search that returns the start (or something worse), a history that
+// regresses, an initializer that prints rounded gains, or a report missing its totals.
+TEST_CASE("GainTuner: finds cheaper feasible gains than a sluggish start") {
+    const auto kin = xDrive(Length{7.0});
+    const GainTunerConfig cfg = sluggishStart();
+    GainTuner tuner{kin, cfg};
+    const TuningReport report = tuner.run();
+
+    CHECK(report.startScore.feasible());
+    CHECK(report.bestScore.feasible());
+    CHECK(report.bestScore.cost < report.startScore.cost);
+    CHECK(report.bestScore.meanSettleTime < report.startScore.meanSettleTime);
+    REQUIRE_FALSE(report.history.empty());
+    for (std::size_t i = 1; i < report.history.size(); ++i) {
+        if (report.history[i].restart == report.history[i - 1].restart) {
+            CHECK(report.history[i].bestCost <= report.history[i - 1].bestCost);
+        }
+    }
+    // The untuned fields ride through untouched.
+    CHECK(report.best.wheelFf.kS == cfg.base.wheelFf.kS);
+    CHECK(report.best.translation.kI == cfg.base.translation.kI);
+
+    const std::string init = shulib::sim::motionConfigInitializer(report, cfg.gains);
+    CHECK(init.find("cfg.translation.kP = ") != std::string::npos);
+    CHECK(init.find("cfg.heading.kP = ") != std::string::npos);
+    CHECK(init.find("cfg.heading.kD") == std::string::npos);  // only what was tuned
+    const std::size_t at = init.find("cfg.translation.kP = ") + std::strlen("cfg.translation.kP = ");
+    CHECK(std::stod(init.substr(at)) == report.best.translation.kP);  // exact, not rounded
+
+    const std::string text = shulib::sim::formatTuningReport(report);
+    CHECK(text.find("restart 0 iter   0") != std::string::npos);
+    CHECK(text.find("cache hits") != std::string::npos);
+    MESSAGE(init << text);
+}
+
+// Would catch: a cache keyed on unsnapped doubles (revisits re-simulated), counts that do
+// not add up, or a second run() that re-simulates what the first already scored.
+TEST_CASE("GainTuner: a candidate is never simulated twice") {
+    const auto kin = xDrive(Length{7.0});
+    GainTunerConfig cfg = sluggishStart();
+    cfg.restarts = 0;
+    cfg.maxIterations = 3;
+    GainTuner tuner{kin, cfg};
+    const TuningReport first = tuner.run();
+    CHECK(first.candidatesScored > 0);
+    CHECK(first.scenarioRuns == first.candidatesScored * 2);
+
+    const int hitsBefore = tuner.cacheHits();
+    const TuningReport again = tuner.run();
+    CHECK(again.candidatesScored == first.candidatesScored);  // nothing new simulated
+    CHECK(tuner.cacheHits() > hitsBefore);
+    CHECK(again.bestScore.cost == first.bestScore.cost);
+
+    const CandidateScore base = tuner.scoreBase();
+    CHECK(base.cost == first.startScore.cost);
+    CHECK(tuner.candidatesScored() == first.candidatesScored);
+}
+
+// Would catch: results summed in completion order, a job scored against the wrong
+// candidate or scenario, or any state shared between concurrent runs.
+TEST_CASE("GainTuner: serial and parallel tuning runs are bit-identical (measured)") {
+    const auto kin = xDrive(Length{7.0});
+    GainTunerConfig serialCfg = sluggishStart();
+    serialCfg.scenarios = shulib::sim::standardTuningScenarios();  // six jobs per candidate
+    serialCfg.restarts = 0;
+    serialCfg.maxIterations = 3;
+    GainTunerConfig parallelCfg = serialCfg;
+    parallelCfg.threads = 4;
+
+    using Clock = std::chrono::steady_clock;
+    const auto s0 = Clock::now();
+    const TuningReport serial = GainTuner{kin, serialCfg}.run();
+    const double serialS = std::chrono::duration<double>(Clock::now() - s0).count();
+    const auto p0 = Clock::now();
+    const TuningReport parallel = GainTuner{kin, parallelCfg}.run();
+    const double parallelS = std::chrono::duration<double>(Clock::now() - p0).count();
+
+    CHECK(std::memcmp(&parallel.bestScore, &serial.bestScore, sizeof(CandidateScore)) == 0);
+    CHECK(parallel.best.translation.kP == serial.best.translation.kP);
+    CHECK(parallel.best.heading.kP == serial.best.heading.kP);
+    REQUIRE(parallel.history.size() == serial.history.size());
+    for (std::size_t i = 0; i < serial.history.size(); ++i) {
+        CHECK(parallel.history[i].bestCost == serial.history[i].bestCost);
+    }
+    MESSAGE(serial.scenarioRuns << " scenario runs: serial " << serialS * 1e3 << " ms, 4 threads "
+                                << parallelS * 1e3 << " ms (host, " << serialS / parallelS
+                                << "x)");
+}
+
+// Would catch: an empty or inverted range, or nothing to tune, reaching the search.
+TEST_CASE("GainTuner: a malformed problem is refused") {
+    const auto kin = xDrive(Length{7.0});
+    GainTunerConfig cfg = smallProblem();
+    cfg.gains = {};
+    CHECK_THROWS_AS(GainTuner(kin, cfg), PreconditionError);
+    cfg = smallProblem();
+    cfg.gains.front().hi = cfg.gains.front().lo;
+    CHECK_THROWS_AS(GainTuner(kin, cfg), PreconditionError);
+    cfg = smallProblem();
+    cfg.scenarios = {};
+    CHECK_THROWS_AS(GainTuner(kin, cfg), PreconditionError);
+}
@@ -0,0 +1,269 @@
+// Tests for the rigid-body plant mode (sim/rigid_body.hpp, PlantDynamics::RigidBody).
+//
+// Every bound below is derived by hand from the config's constants and the drive's
+// geometry — never read back from the solver. Targets:
+//  * STEADY STATE: a rolling drive settles at the kinematic plant's steady-state speed
+//    (the feedforward contract survives), but gets there through mass, not instantly.
+//  * COULOMB: a full-speed reversal breaks traction — the wheels slide, and the body
+//    decelerates at the friction limit μ·g·(geometry), no harder; with grip to spare the
+//    same reversal rolls.
+//  * INERTIA: more yaw inertia turns slower, to the same steady rate.
+//  * SCRUB: a tank drive's treads hold its blind (sideways) direction in an arc until
+//    the side friction runs out, and then it skids.
+//  * LOAD TRANSFER: accelerating forward unloads the front wheels, so they break loose
+//    first — a flipped sign in the least-norm split shows up as the rear slipping.
+//  * DETERMINISM and CHECKPOINT: two runs are bit-identical, and a restored harness
+//    replays the straight run bit for bit (the acceleration load transfer reads is state).
+
+#include "doctest.h"
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <numbers>
+#include <vector>
+
+#include "shulib/core/check.hpp"
+#include "shulib/kinematics/tank.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/sim/batch_plant.hpp"
+#include "shulib/sim/rigid_body.hpp"
+#include "shulib/sim/scenario.hpp"
+#include "shulib/units/quantity.hpp"
+
+using shulib::PreconditionError;
+using shulib::kinematics::TankKinematics;
+using shulib::kinematics::xDrive;
+using shulib::sim::kGravityInPerS2;
+using shulib::sim::PlantDynamics;
+using shulib::sim::SimHarness;
+using shulib::sim::SimHarnessConfig;
+using shulib::sim::SimSnapshot;
+using shulib::units::Length;
+using shulib::units::Time;
+using shulib::units::Voltage;
+
+namespace {
+
+constexpr double kS = 1.0;
+constexpr double kV = 12.0 / 70.0;
+
+[[nodiscard]] SimHarnessConfig rigidConfig() {
+    SimHarnessConfig cfg;
+    cfg.plant.wheelFf = {.kS = kS, .kV = kV, .kA = 0.0};
+    cfg.plant.dynamics = PlantDynamics::RigidBody;
+    return cfg;
+}
+
+/// X-drive forward at `volts` (canonical FL, BL, BR, FR: the left pair runs negative).
+void driveForward(SimHarness& h, double volts) {
+    h.motor(0).setVoltage(Voltage{-volts});
+    h.motor(1).setVoltage(Voltage{-volts});
+    h.motor(2).setVoltage(Voltage{volts});
+    h.motor(3).setVoltage(Voltage{volts});
+}
+
+/// X-drive turning in place (every wheel the same sign).
+void turnInPlace(SimHarness& h, double volts) {
+    for (int i = 0; i < 4; ++i) {
+        h.motor(i).setVoltage(Voltage{volts});
+    }
+}
+
+[[nodiscard]] double maxAbsSlip(SimHarness& h) {
+    const auto slip = h.plant().trueWheelSlip();
+    double worst = 0.0;
+    for (int i = 0; i < slip.size(); ++i) {
+        worst = std::max(worst, std::abs(slip[i].value()));
+    }
+    return worst;
+}
+
+}  // namespace
+
+// Would catch: a torque proxy that does not vanish at MotorModel's steady state (the
+// feedforward contract broken), a missing mass (an instant jump), or wheels that slip on
+// a gentle launch.
+TEST_CASE("rigid-body plant: settles at the kinematic steady state, through mass") {
+    const auto kin = xDrive(Length{7.0});
+    SimHarness h{kin, rigidConfig()};
+    const double volts = 8.0;
+    const double vss = std::numbers::sqrt2 * (volts - kS) / kV;  // √2·u, as the kinematic plant
+    driveForward(h, volts);
+    h.runTicks(5, Time{0.01});
+    CHECK(h.plant().trueBodyTwist().vx().value() > 0.0);
+    CHECK(h.plant().trueBodyTwist().vx().value() < 0.5 * vss);  // 50 ms in: mass, not a step
+    CHECK(maxAbsSlip(h) < 1e-6);                                 // 7 V of launch stays rolling
+
+    h.runTicks(995, Time{0.01});  // 10 s: ≈ 20 time constants of m/2 per wheel (τ ≈ 0.5 s)
+    CHECK(h.plant().trueBodyTwist().vx().value() == doctest::Approx(vss).epsilon(1e-6));
+    CHECK(std::abs(h.plant().trueBodyTwist().vy().value()) < 1e-9);
+    CHECK(std::abs(h.plant().trueBodyTwist().omega().value()) < 1e-9);
+    CHECK(maxAbsSlip(h) < 1e-6);
+}
+
+// Would catch: a cap that is not Coulomb (decel above the friction limit), a cap that is
+// never reached (no slide), or a slide that pushes the body the wrong way.
+TEST_CASE("rigid-body plant: a full-speed reversal slides at the friction limit") {
+    const auto kin = xDrive(Length{7.0});
+    SimHarness h{kin, rigidConfig()};
+    driveForward(h, 12.0);
+    h.runTicks(300, Time{0.01});
+    const double cruise = h.plant().trueBodyTwist().vx().value();
+
+    // Each X-drive wheel rolls at vx/√2, so its force reaches the body scaled by 1/√2:
+    // the most four wheels at μ·(m·g/4) can do is a_x = μ·g/√2.
+    const double limit = 0.9 * kGravityInPerS2 / std::numbers::sqrt2;
+    driveForward(h, -12.0);
+    double before = cruise;
+    double hardest = 0.0;
+    double worstSlip = 0.0;
+    for (int tick = 0; tick < 10; ++tick) {
+        h.runTicks(1, Time{0.01});
+        const double vx = h.plant().trueBodyTwist().vx().value();
+        hardest = std::max(hardest, (before - vx) / 0.01);
+        worstSlip = std::max(worstSlip, maxAbsSlip(h));
+        before = vx;
+    }
+    CHECK(worstSlip > 10.0);              // the wheels are sliding, not rolling
+    CHECK(hardest <= limit * (1.0 + 1e-9));  // and Coulomb holds the line
+    CHECK(hardest > 0.95 * limit);        // kinetic friction, saturated
+    CHECK(before < cruise);
+
+    // With grip to spare the same reversal rolls and brakes harder than the slick floor.
+    SimHarnessConfig grippy = rigidConfig();
+    grippy.plant.rigidBody.friction = 10.0;
+    SimHarness g{kin, grippy};
+    driveForward(g, 12.0);
+    g.runTicks(300, Time{0.01});
+    driveForward(g, -12.0);
+    g.runTicks(1, Time{0.01});
+    CHECK(maxAbsSlip(g) < 1e-6);
+    CHECK((cruise - g.plant().trueBodyTwist().vx().value()) / 0.01 > limit);
+}
+
+// Would catch: yaw inertia ignored (both turns identical) or applied to the steady state.
+TEST_CASE("rigid-body plant: more yaw inertia turns slower, to the same rate") {
+    const auto kin = xDrive(Length{7.0});
+    SimHarnessConfig heavy = rigidConfig();
+    heavy.plant.rigidBody.yawInertiaLbIn2 *= 4.0;
+    SimHarness light{kin, rigidConfig()};
+    SimHarness slow{kin, heavy};
+    turnInPlace(light, 6.0);
+    turnInPlace(slow, 6.0);
+    light.runTicks(15, Time{0.01});
+    slow.runTicks(15, Time{0.01});
+    CHECK(slow.plant().truthState().theta > 0.0);
+    CHECK(slow.plant().truthState().theta < 0.8 * light.plant().truthState().theta);
+
+    light.runTicks(1485, Time{0.01});  // 15 s: the heavy robot's τ is ≈ 1.1 s
+    slow.runTicks(1485, Time{0.01});
+    const double rate = (6.0 - kS) / kV / 7.0;  // wheel speed over the drive radius
+    CHECK(light.plant().trueBodyTwist().omega().value() == doctest::Approx(rate).epsilon(1e-5));
+    CHECK(slow.plant().trueBodyTwist().omega().value() == doctest::Approx(rate).epsilon(1e-5));
+}
+
+// Would catch: a tank with no side friction (drifts in every arc) or an unbounded one
+// (never skids): the blind direction is found and held by a Coulomb cap.
+TEST_CASE("rigid-body plant: a tank's treads hold an arc until the side friction runs out") {
+    const TankKinematics kin{Length{6.0}};
+    const auto arc = [&](double friction) {
+        SimHarnessConfig cfg = rigidConfig();
+        cfg.plant.rigidBody.friction = friction;
+        auto h = std::make_unique<SimHarness>(kin, cfg);
+        h->motor(0).setVoltage(Voltage{6.0});
+        h->motor(1).setVoltage(Voltage{12.0});
+        h->runTicks(200, Time{0.01});
+        return std::abs(h->plant().trueBodyTwist().vy().value());
+    };
+    // Centripetal need at ≈ 48 in/s and ≈ 2.9 rad/s is ≈ 140 in/s² — 0.36 g.
+    CHECK(arc(0.9) < 1e-9);  // held: the arc is a pure roll
+    CHECK(arc(0.1) > 1.0);   // 0.1 g cannot hold it: the robot skids outward
+}
+
+// Would catch: load transfer with its sign flipped (the rear unloaded under forward
+// acceleration) or not applied at all (front and rear slip alike).
+TEST_CASE("rigid-body plant: accelerating forward unloads the front wheels first") {
+    const auto kin = xDrive(Length{7.0});
+    SimHarnessConfig cfg = rigidConfig();
+    const double c = 7.0 / std::numbers::sqrt2;
+    cfg.plant.rigidBody.friction = 0.6;
+    cfg.plant.rigidBody.cgHeight = Length{6.0};
+    cfg.plant.rigidBody.wheelX = {Length{c}, Length{-c}, Length{-c}, Length{c}};  // FL BL BR FR
+    cfg.plant.rigidBody.wheelY = {Length{c}, Length{c}, Length{-c}, Length{-c}};
+    SimHarness h{kin, cfg};
+    driveForward(h, 12.0);
+    h.runTicks(3, Time{0.01});
+    const auto slip = h.plant().trueWheelSlip();
+    const double front = std::abs(slip[0].value()) + std::abs(slip[3].value());
+    const double rear = std::abs(slip[1].value()) + std::abs(slip[2].value());
+    CHECK(front > 1.0);          // the unloaded front breaks loose
+    CHECK(rear < 0.5 * front);   // the loaded rear keeps more of its grip
+
+    SimHarnessConfig flat = cfg;
+    flat.plant.rigidBody.cgHeight = Length{0.0};
+    SimHarness even{kin, flat};
+    driveForward(even, 12.0);
+    even.runTicks(3, Time{0.01});
+    const auto evenSlip = even.plant().trueWheelSlip();
+    CHECK(std::abs(evenSlip[0].value()) == doctest::Approx(std::abs(evenSlip[1].value())));
+}
+
+// Would catch: hidden state outside DrivePlantState (the acceleration load transfer reads),
+// or any run-to-run nondeterminism in the solver.
+TEST_CASE("rigid-body plant: deterministic, and a checkpoint replays bit for bit") {
+    const auto kin = xDrive(Length{7.0});
+    SimHarnessConfig cfg = rigidConfig();
+    const double c = 7.0 / std::numbers::sqrt2;
+    cfg.plant.rigidBody.cgHeight = Length{5.0};
+    cfg.plant.rigidBody.wheelX = {Length{c}, Length{-c}, Length{-c}, Length{c}};
+    cfg.plant.rigidBody.wheelY = {Length{c}, Length{c}, Length{-c}, Length{-c}};
+    const auto script = [](SimHarness& h, int from, int to) {
+        for (int tick = from; tick < to; ++tick) {
+            const double phase = 0.05 * tick;
+            h.motor(0).setVoltage(Voltage{-12.0 * std::cos(phase)});
+            h.motor(1).setVoltage(Voltage{-9.0 + 4.0 * std::sin(phase)});
+            h.motor(2).setVoltage(Voltage{12.0 * std::cos(0.7 * phase)});
+            h.motor(3).setVoltage(Voltage{11.0 * std::sin(phase)});
+            h.runTicks(1, Time{0.01});
+        }
+    };
+    SimHarness a{kin, cfg};
+    SimHarness b{kin, cfg};
+    script(a, 0, 150);
+    script(b, 0, 150);
+    CHECK(std::memcmp(&a.plant().truthState(), &b.plant().truthState(), sizeof(a.plant().truthState())) == 0);
+
+    const auto snap = std::make_unique<SimSnapshot>();
+    a.snapshot(*snap);
+    script(a, 150, 300);
+    SimHarness fork{kin, cfg};
+    fork.restore(*snap);
+    script(fork, 150, 300);
+    CHECK(std::memcmp(&fork.plant().truthState(), &a.plant().truthState(), sizeof(a.plant().truthState())) == 0);
+    const auto st = fork.plant().state();
+    const auto straight = a.plant().state();
+    CHECK(std::memcmp(&st.bodyAccel, &straight.bodyAccel, sizeof st.bodyAccel) == 0);
+    CHECK(std::memcmp(&st.wheelSpin, &straight.wheelSpin, sizeof st.wheelSpin) == 0);
+}
+
+// Would catch: nonsense constants reaching the solver, collinear contact points accepted
+// for load transfer, or a batch silently running the kinematic plant for a RigidBody robot.
+TEST_CASE("rigid-body plant: a malformed configuration is refused") {
+    const auto kin = xDrive(Length{7.0});
+    SimHarnessConfig cfg = rigidConfig();
+    cfg.plant.rigidBody.massLb = 0.0;
+    CHECK_THROWS_AS(SimHarness(kin, cfg), PreconditionError);
+    cfg = rigidConfig();
+    cfg.plant.rigidBody.substeps = 0;
+    CHECK_THROWS_AS(SimHarness(kin, cfg), PreconditionError);
+    cfg = rigidConfig();
+    cfg.plant.rigidBody.cgHeight = Length{4.0};  // wheel positions left at zero
+    CHECK_THROWS_AS(SimHarness(kin, cfg), PreconditionError);
+
+    std::vector<shulib::sim::BatchRobot> robots(1);
+    robots[0].plant = rigidConfig().plant;
+    const shulib::sim::TrackingWheelSpec tracking[] = {
+        {nullptr, shulib::sim::TrackingAxis::Forward, Length{0.0}, Length{2.0}}};
+    CHECK_THROWS_AS(shulib::sim::BatchPlant(kin, robots, tracking), PreconditionError);
+}
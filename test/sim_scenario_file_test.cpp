@@ -0,0 +1,225 @@
+// Tests for sim/scenario_file.hpp (the text scenarios behind tools/shulib_sim). What each
+// targets:
+//  * THE FORMAT: every directive lands in the field it names, with the config's own type
+//    (a Time, a bool, an int), degrees become radians, and comments and blank lines are
+//    nothing.
+//  * ERRORS: an unknown directive or field, a non-integral int, a missing argument and a
+//    file with no verbs are each refused with the line that caused them — never run.
+//  * THE SHIPPED FILES: every tools/scenarios/*.scn parses, so the examples cannot rot.
+//  * THE SWEEP: a run is a pure function of (spec, seed) — serial and threaded sweeps agree
+//    to the byte, blackbox included — a blackbox decodes, and a verb that cannot finish is
+//    named in the summary by its line.
+
+#include "doctest.h"
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "shulib/control/exit_group.hpp"
+#include "shulib/diag/blackbox_format.hpp"
+#include "shulib/diag/blackbox_reader.hpp"
+#include "shulib/sim/scenario_file.hpp"
+
+namespace bb = shulib::diag::blackbox;
+
+using shulib::control::ExitReason;
+using shulib::sim::parseScenario;
+using shulib::sim::ScenarioDrive;
+using shulib::sim::ScenarioParseResult;
+using shulib::sim::ScenarioRunResult;
+using shulib::sim::ScenarioSpec;
+using shulib::sim::ScenarioVerbKind;
+
+namespace {
+
+constexpr const char* kFull = R"(# every directive once
+name      probe
+drive     hdrive 11 -4
+seeds     3 5
+start     1 2 90
+dt        0.005
+
+hostility full
+set       gps.noiseSigmaIn 1.5
+set       gps.offStrip true
+set       imu.calibrationEnd 0.25
+set       encoders.driveFreezeWheel 2
+set       latency.gpsLatency 0.02
+jitter    on
+set       jitter.spikeProb 0.1
+fusion    ekf
+tags      ring
+
+moveTo    24 0 90 3     # with a timeout
+strafeTo  10 -5
+turnTo    -45
+hold      0.5
+wait      0.25
+brake     2
+)";
+
+/// A short, clean, fast scenario for the sweep tests.
+constexpr const char* kShort = R"(name short
+seeds 1 3
+hostility full
+set imu.calibrationEnd 0
+moveTo 12 0 0
+turnTo 90
+)";
+
+}  // namespace
+
+// Would catch: a directive that parses into the wrong field, a Time or bool assigned as a
+// raw double, degrees left as degrees, or a comment that leaks into the tokens.
+TEST_CASE("parseScenario: every directive lands where it says") {
+    const ScenarioParseResult r = parseScenario(kFull);
+    REQUIRE_MESSAGE(r.ok(), r.error);
+    const ScenarioSpec& s = r.spec;
+    CHECK(s.name == "probe");
+    CHECK(s.drive.kind == ScenarioDrive::HDrive);
+    CHECK(s.drive.size == 11.0);
+    CHECK(s.drive.strafeOffset == -4.0);
+    CHECK(s.seedFirst == 3);
+    CHECK(s.seedLast == 5);
+    CHECK(s.start.y().value() == 2.0);
+    CHECK(s.start.heading().radians() == doctest::Approx(shulib::math::Angle::kPi / 2.0));
+    CHECK(s.dt == 0.005);
+    CHECK(s.hostile);
+    CHECK(s.hostility.gps.noiseSigmaIn == 1.5);
+    CHECK(s.hostility.gps.offStrip);
+    CHECK(s.hostility.imu.calibrationEnd.value() == 0.25);
+    CHECK(s.hostility.encoders.driveFreezeWheel == 2);
+    CHECK(s.hostility.latency.gpsLatency.value() == 0.02);
+    CHECK(s.hostility.power.cutoffVolts.value() == 10.5);  // untouched fields keep defaults
+    CHECK(s.jitter);
+    CHECK(s.jitterConfig.spikeProb == 0.1);
+    CHECK(s.fusion == shulib::sim::ScenarioFusion::Ekf);
+    CHECK(s.tags);
+
+    REQUIRE(s.verbs.size() == 6);
+    CHECK(s.verbs[0].kind == ScenarioVerbKind::MoveTo);
+    CHECK(s.verbs[0].timeout == 3.0);
+    CHECK(s.verbs[0].line == 19);
+    CHECK(s.verbs[1].kind == ScenarioVerbKind::StrafeTo);
+    CHECK(s.verbs[1].target.y().value() == -5.0);
+    CHECK(s.verbs[1].timeout == 0.0);  // → MotionConfig::defaultTimeout
+    CHECK(s.verbs[2].target.heading().radians() == doctest::Approx(-shulib::math::Angle::kPi / 4.0));
+    CHECK(s.verbs[3].kind == ScenarioVerbKind::Hold);
+    CHECK(s.verbs[3].seconds == 0.5);
+    CHECK(s.verbs[4].kind == ScenarioVerbKind::Wait);
+    CHECK(s.verbs[5].kind == ScenarioVerbKind::Brake);
+    CHECK(s.verbs[5].timeout == 2.0);
+}
+
+// Would catch: a typo that silently does nothing, an int field that truncates 1.5, a bool
+// that accepts 2, a verb short of arguments, or an empty routine that "passes".
+TEST_CASE("parseScenario: a bad line is refused with its line number") {
+    struct Case {
+        const char* text;
+        int line;
+        const char* mentions;
+    };
+    const Case cases[] = {
+        {"moveTo 1 2 3\nfly 3\n", 2, "unknown directive"},
+        {"set gps.noiseSigma 1\nmoveTo 1 2 3\n", 1, "unknown field"},
+        {"\n\nset encoders.driveFreezeWheel 1.5\n", 3, "not a valid value"},
+        {"set gps.offStrip 2\n", 1, "not a valid value"},
+        {"moveTo 1 2\n", 1, "expects"},
+        {"turnTo north\n", 1, "expects"},
+        {"seeds 5 2\nmoveTo 1 2 3\n", 1, "first <= last"},
+        {"drive mecanum 7\nmoveTo 1 2 3\n", 1, "expects"},
+        {"hold 0\n", 1, "positive"},
+        {"fusion kalman\nmoveTo 1 2 3\n", 1, "complementary | ekf"},
+        {"moveTo 1 2 3\ntags on\n", 2, "none | ring"},
+        {"# nothing but config\nseeds 1 4\n", 0, "no verbs"},
+    };
+    for (const Case& c : cases) {
+        CAPTURE(c.text);
+        const ScenarioParseResult r = parseScenario(c.text);
+        CHECK_FALSE(r.ok());
+        CHECK(r.line == c.line);
+        CHECK(r.error.find(c.mentions) != std::string::npos);
+    }
+}
+
+// Would catch: a shipped example that drifted from the format it documents.
+TEST_CASE("parseScenario: every shipped tools/scenarios file parses") {
+    const std::filesystem::path dir = std::filesystem::path{SHULIB_SOURCE_DIR} / "tools" / "scenarios";
+    int files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator{dir}) {
+        if (entry.path().extension() != ".scn") {
+            continue;
+        }
+        ++files;
+        const ScenarioParseResult r = shulib::sim::loadScenarioFile(entry.path().c_str());
+        CHECK_MESSAGE(r.ok(), entry.path().string() << ":" << r.line << ": " << r.error);
+    }
+    CHECK(files >= 1);
+    CHECK_FALSE(shulib::sim::loadScenarioFile("/nonexistent/x.scn").ok());
+}
+
+// Would catch: shared state between concurrent runs, results stored out of seed order,
+// seeds that do not reach the plant (identical rows), or a blackbox that does not decode.
+TEST_CASE("runScenarioSweep: serial and threaded sweeps agree, blackboxes decode") {
+    const ScenarioParseResult parsed = parseScenario(kShort);
+    REQUIRE_MESSAGE(parsed.ok(), parsed.error);
+    const std::vector<ScenarioRunResult> serial =
+        shulib::sim::runScenarioSweep(parsed.spec, {.threads = 1, .blackbox = true});
+    const std::vector<ScenarioRunResult> threaded =
+        shulib::sim::runScenarioSweep(parsed.spec, {.threads = 3, .blackbox = true});
+    REQUIRE(serial.size() == 3);
+    REQUIRE(threaded.size() == 3);
+    for (std::size_t i = 0; i < serial.size(); ++i) {
+        const ScenarioRunResult& a = serial[i];
+        const ScenarioRunResult& b = threaded[i];
+        CHECK(a.seed == 1 + i);
+        CHECK(b.seed == a.seed);
+        CHECK(a.succeeded());
+        CHECK(b.simTime == a.simTime);
+        CHECK(b.estimateError == a.estimateError);
+        REQUIRE(b.verbs.size() == a.verbs.size());
+        for (std::size_t v = 0; v < a.verbs.size(); ++v) {
+            CHECK(b.verbs[v].positionError == a.verbs[v].positionError);
+            CHECK(b.verbs[v].headingError == a.verbs[v].headingError);
+        }
+        CHECK(b.blackbox == a.blackbox);
+    }
+    CHECK(serial[0].estimateError != serial[1].estimateError);  // the seed reaches the world
+
+    bb::BlackboxReader reader{serial[0].blackbox};
+    REQUIRE(reader.status() == bb::ReadStatus::Ok);
+    bb::BlackboxReader::Frame frame;
+    long ticks = 0;
+    long inputs = 0;
+    bool sawEnd = false;
+    while (reader.next(frame)) {
+        ticks += frame.type == bb::FrameType::Tick ? 1 : 0;
+        inputs += frame.type == bb::FrameType::EstimatorInputs ? 1 : 0;
+        sawEnd = sawEnd || frame.type == bb::FrameType::End;
+    }
+    CHECK(inputs > 0);  // the sim blackbox opts in to the replay channel
+    // Per tick the plant and the controller each emit one record; a verb may add an exit one.
+    CHECK(ticks >= serial[0].ticks);
+    CHECK(ticks <= 2 * serial[0].ticks + static_cast<long>(parsed.spec.verbs.size()));
+    CHECK(sawEnd);  // close() ran: the file says the run ended cleanly
+}
+
+// Would catch: a timed-out verb counted as settled, a failure that stops the routine, or a
+// summary that hides which line failed.
+TEST_CASE("runScenario: a verb that cannot finish is reported by line, and the run goes on") {
+    const ScenarioParseResult parsed = parseScenario("moveTo 48 0 0 0.5\nturnTo 90\n");
+    REQUIRE(parsed.ok());
+    const ScenarioRunResult r = shulib::sim::runScenario(parsed.spec, 1);
+    REQUIRE(r.verbs.size() == 2);
+    CHECK(r.verbs[0].exit == ExitReason::TimedOut);
+    CHECK(r.verbs[0].positionError > 10.0);
+    CHECK(r.verbs[1].exit == ExitReason::Settled);  // the routine continued
+    CHECK(r.settled == 1);
+    CHECK_FALSE(r.succeeded());
+    const std::string table = shulib::sim::formatScenarioSummary(parsed.spec, {r});
+    CHECK(table.find("line 1") != std::string::npos);
+    CHECK(table.find("MOTION_TIMEOUT") != std::string::npos);
+    CHECK(table.find("0 of 1 run(s)") != std::string::npos);
+}
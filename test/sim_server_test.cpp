@@ -0,0 +1,193 @@
+// Tests for sim/sim_server.hpp (the command core of tools/shulib_simd), driven through a
+// FakeCharSink and read back with Shul2Decoder, exactly as a client would. What each
+// targets:
+//  * ANSWERS: every command line gets one "simd" Log frame — ok with the clock and truth,
+//    or error with the reason — and a refused command changes nothing.
+//  * STAGING: a setting waits for `reset`; a verb runs now and reports its exit.
+//  * STEP AND POSE: `step n` advances exactly n ticks and streams their records; `pose`
+//    moves truth and estimate together; a joining client's stream opens on a keyframe.
+//  * DETERMINISM: the same commands produce the same bytes, paced or not.
+//  * PACING: `pace realtime` holds sim time to wall time (a lower bound only — a loaded
+//    host may be slower, never faster).
+
+#include "doctest.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/shul2_sink.hpp"
+#include "shulib/hal/fake/fake_char_sink.hpp"
+#include "shulib/hal/telemetry_sink.hpp"
+#include "shulib/sim/sim_server.hpp"
+
+using shulib::diag::DebugRecord;
+using shulib::diag::Shul2Decoder;
+using shulib::hal::LogLevel;
+using shulib::hal::fake::FakeCharSink;
+using shulib::sim::SimServer;
+using shulib::sim::SimServerStatus;
+
+namespace {
+
+/// Everything a client would have seen.
+struct Seen {
+    std::vector<DebugRecord> ticks;
+    std::vector<std::string> answers;  ///< "I|ok …" or "E|error …"
+};
+
+Seen decode(std::string_view wire) {
+    Seen got;
+    Shul2Decoder d;
+    for (const char c : wire) {
+        if (!d.feed(static_cast<std::byte>(c))) {
+            continue;
+        }
+        DebugRecord r;
+        bool corrupt = false;
+        Shul2Decoder::LogLine line;
+        if (d.readTick(r, corrupt)) {
+            got.ticks.push_back(r);
+        } else if (d.readLog(line) && line.tag == "simd") {
+            got.answers.push_back(std::string{line.level == LogLevel::Error ? "E|" : "I|"}
+                                  + std::string{line.message});
+        }
+        REQUIRE_FALSE(corrupt);
+    }
+    return got;
+}
+
+bool startsWith(const std::string& s, std::string_view p) { return s.rfind(p, 0) == 0; }
+
+}  // namespace
+
+// Would catch: a command that is silently swallowed (the client would wait forever), a
+// refused command that half-applies, or a quit/shutdown the transport cannot tell apart.
+TEST_CASE("sim server: every command line is answered once, and a refusal changes nothing") {
+    FakeCharSink out;
+    SimServer server{out};
+    CHECK(server.handle("") == SimServerStatus::Continue);
+    CHECK(server.handle("   # a comment") == SimServerStatus::Continue);
+    CHECK(server.handle("truth") == SimServerStatus::Continue);
+    CHECK(server.handle("step 0") == SimServerStatus::Continue);
+    CHECK(server.handle("step 2.5") == SimServerStatus::Continue);
+    CHECK(server.handle("pose 1 2") == SimServerStatus::Continue);
+    CHECK(server.handle("set gps.nope 3") == SimServerStatus::Continue);
+    CHECK(server.handle("frobnicate") == SimServerStatus::Continue);
+    CHECK(server.handle("pace slow") == SimServerStatus::Continue);
+    CHECK(server.world()->ticks() == 0);
+    CHECK(server.handle("quit") == SimServerStatus::Close);
+    CHECK(server.handle("shutdown") == SimServerStatus::Shutdown);
+
+    const Seen got = decode(out.text());
+    REQUIRE(got.answers.size() == 9);
+    CHECK(startsWith(got.answers[0], "I|ok truth t=0.0000 truth=0.0000 0.0000 0.0000"));
+    for (std::size_t i = 1; i <= 6; ++i) {
+        CAPTURE(got.answers[i]);
+        CHECK(startsWith(got.answers[i], "E|error "));
+    }
+    CHECK(startsWith(got.answers[7], "I|ok quit"));
+    CHECK(startsWith(got.answers[8], "I|ok shutdown"));
+    CHECK(got.ticks.empty());
+}
+
+// Would catch: a setting applied to the live world mid-life (a hostility the harness was
+// not built with), or a verb run without reporting its verdict.
+TEST_CASE("sim server: settings are staged until reset; verbs run now and report their exit") {
+    FakeCharSink out;
+    SimServer server{out};
+    REQUIRE(server.handle("truth") == SimServerStatus::Continue);
+    REQUIRE(server.handle("start 10 -5 90") == SimServerStatus::Continue);
+    CHECK(std::abs(server.world()->harness().truePose().x().value()) < 1e-12);
+    REQUIRE(server.handle("reset") == SimServerStatus::Continue);
+    CHECK(server.world()->harness().truePose().x().value() == doctest::Approx(10.0));
+    CHECK(server.world()->harness().truePose().y().value() == doctest::Approx(-5.0));
+
+    out.clear();
+    REQUIRE(server.handle("moveTo 22 -5 90 3") == SimServerStatus::Continue);
+    const Seen got = decode(out.text());
+    REQUIRE(got.answers.size() == 1);
+    CAPTURE(got.answers[0]);
+    CHECK(startsWith(got.answers[0], "I|ok moveTo t="));
+    CHECK(got.answers[0].find(" exit=settled err=") != std::string::npos);
+    CHECK(server.world()->harness().truePose().x().value() == doctest::Approx(22.0).epsilon(0.05));
+    CHECK_FALSE(got.ticks.empty());
+    CHECK(server.wire().droppedTicks() == 0);
+}
+
+// Would catch: an off-by-one in step, records that stop streaming without a controller,
+// a teleport that moves truth but leaves the estimate behind (the next verb would then
+// drive from the wrong place), or a reconnect whose first records are undecodable deltas.
+TEST_CASE("sim server: step advances exactly n ticks; pose moves truth and estimate together") {
+    FakeCharSink out;
+    SimServer server{out};
+    REQUIRE(server.handle("step 25") == SimServerStatus::Continue);
+    CHECK(server.world()->ticks() == 25);
+    const Seen got = decode(out.text());
+    CHECK(got.ticks.size() >= 25);
+    REQUIRE(got.answers.size() == 1);
+    CHECK(startsWith(got.answers[0], "I|ok step t=0.2500 "));
+
+    REQUIRE(server.handle("pose -30 12 45") == SimServerStatus::Continue);
+    const auto truth = server.world()->harness().truePose();
+    const auto est = server.world()->localizer().pose();
+    CHECK(truth.x().value() == doctest::Approx(-30.0));
+    CHECK(truth.heading().degrees() == doctest::Approx(45.0));
+    CHECK(est.x().value() == doctest::Approx(-30.0));
+    CHECK(est.y().value() == doctest::Approx(12.0));
+    CHECK(est.heading().degrees() == doctest::Approx(45.0));
+
+    // A reconnecting client decodes from its first tick: the chain restarts on a keyframe.
+    const std::uint32_t keys = server.wire().keyframesSent();
+    server.clientJoined();
+    out.clear();
+    REQUIRE(server.handle("step 3") == SimServerStatus::Continue);
+    CHECK(server.wire().keyframesSent() == keys + 1);
+    CHECK(decode(out.text()).ticks.size() >= 3);
+}
+
+// Would catch: pacing or wall time leaking into the stream (a timestamp, a sleep-dependent
+// branch), or a reset that does not return the world to the same start.
+TEST_CASE("sim server: the same commands produce the same bytes, paced or not") {
+    const char* const script[] = {"hostility full", "reset", "moveTo 12 6 30 2",
+                                  "turnTo -90 2", "step 10", "reset", "wait 0.2"};
+    const auto run = [&](bool paced) {
+        FakeCharSink out;
+        SimServer server{out};
+        // Both answer a pace line, so only the pacing differs.
+        REQUIRE(server.handle(paced ? "pace realtime 50" : "pace fast")
+                == SimServerStatus::Continue);
+        out.clear();
+        for (const char* line : script) {
+            REQUIRE(server.handle(line) == SimServerStatus::Continue);
+        }
+        return out.text();
+    };
+    const std::string a = run(false);
+    CHECK(a == run(false));
+    CHECK(a == run(true));
+    const Seen got = decode(a);
+    CHECK(got.answers.size() == 7);
+}
+
+// Would catch: pacing that anchors at the server's start (so an idle client is "owed"
+// a burst of unpaced ticks) or that never sleeps.
+TEST_CASE("sim server: pace realtime holds sim time to wall time") {
+    FakeCharSink out;
+    SimServer server{out};
+    REQUIRE(server.handle("pace realtime 2") == SimServerStatus::Continue);
+    CHECK(server.realtime() == doctest::Approx(2.0));
+    const auto t0 = std::chrono::steady_clock::now();
+    REQUIRE(server.handle("step 20") == SimServerStatus::Continue);  // 0.2 s of sim
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    MESSAGE("step 20 at realtime 2: " << wall << " s wall (host, 1x; floor 0.1 s)");
+    CHECK(wall >= 0.099);
+    REQUIRE(server.handle("pace fast") == SimServerStatus::Continue);
+    CHECK(server.realtime() == 0.0);
+}
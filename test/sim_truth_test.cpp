@@ -17,9 +17,18 @@
 // arcStep receives wrapped Angles, so 270° aliases to −90° before it even runs, while
 // the unwrapped RK4 truth handles it exactly. Mutation check #1 (truth → arcStep) must
 // turn "beyond arcStep's wrap horizon" red.
+//
+// THE ADAPTIVE INTEGRATOR (advanceTruthAdaptive, the plant's default) is held to the same
+// bar at the end of this file: the oracle at large ω, the converged RK4 at plant-sized
+// ticks (the Richardson pair above says where RK4 has converged), the arcStep sweep across
+// its Gauss–Legendre and Dormand–Prince paths, the Gauss–Legendre path against that
+// converged RK4 near ω = 0 (where the oracle's 1/ω is ill-conditioned), the tripwire, and
+// its cost against 32 RK4 substeps.
 
 #include "doctest.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <limits>
 
@@ -39,6 +48,9 @@ using shulib::math::ChassisSpeeds;
 using shulib::math::Twist2d;
 using shulib::math::robotToField;
 using shulib::sim::advanceTruth;
+using shulib::sim::advanceTruthAdaptive;
+using shulib::sim::kTruthTolerance;
+using shulib::sim::TruthStepStats;
 using shulib::sim::TruthState;
 using shulib::units::AngularVelocity;
 using shulib::units::Length;
@@ -217,3 +229,172 @@ TEST_CASE("sim truth: zero twist and zero dt change nothing; bad inputs are reje
     CHECK_THROWS_AS((void)advanceTruth(s, twist(1.0, 0.0, 0.0), Time{0.1}, 0),
                     PreconditionError);
 }
+
+// ── The adaptive integrator against the analytic oracle, across plant-sized and hard ticks.
+// The 1e-12 in/tick budget is demanded against the direct integral (consulted only at
+// |ω| ≥ 0.5, where its conditioning is good) and against RK4 at 1024 substeps, converged by
+// the Richardson test above to far below the budget at these sweeps. ──
+TEST_CASE("sim truth: the adaptive integrator holds the 1e-12 in/tick budget") {
+    for (double w : {0.5, -2.0, 6.0, 12.0}) {
+        for (double dt : {0.005, 0.01, 0.02, 0.05}) {
+            for (double th0 : {0.3, -2.5}) {
+                TruthStepStats st;
+                const TruthState end = advanceTruthAdaptive(TruthState{0.0, 0.0, th0},
+                                                            twist(70.0, -25.0, w), Time{dt},
+                                                            kTruthTolerance, &st);
+                const Endpoint exact = oracle(70.0, -25.0, w, th0, dt);
+                CHECK(std::hypot(end.x - exact.dx, end.y - exact.dy) < 1e-12);
+                const TruthState fine = advanceTruth(TruthState{0.0, 0.0, th0},
+                                                     twist(70.0, -25.0, w), Time{dt}, 1024);
+                CHECK(std::hypot(end.x - fine.x, end.y - fine.y) < 1e-12);
+                CHECK(end.theta == th0 + w * dt);
+                CHECK(!st.quadrature);
+                CHECK(st.steps >= 1);
+                if (std::abs(w * dt) <= 0.12) {  // a plant tick: ≤ 12 rad/s at 100 Hz
+                    CHECK(st.steps < 16);         // a fraction of the fixed 32 substeps
+                }
+            }
+        }
+    }
+    // A deliberately hard tick (the RK4 order test's): many steps, same budget.
+    TruthStepStats st;
+    const TruthState end = advanceTruthAdaptive(TruthState{0.0, 0.0, 0.3},
+                                                twist(40.0, -15.0, 3.0), Time{1.0},
+                                                kTruthTolerance, &st);
+    const Endpoint exact = oracle(40.0, -15.0, 3.0, 0.3, 1.0);
+    CHECK(std::hypot(end.x - exact.dx, end.y - exact.dy) < 1e-12);
+    CHECK(st.steps > 16);
+}
+
+// ── The Gauss–Legendre path: exact straight lines, and near-zero ω agreeing with arcStep
+// across the sweep the RK4 truth is held to above (both sides well-conditioned). The path
+// samples the ODE's rate like RK4 does, so this is as independent a check as RK4's. ──
+TEST_CASE("sim truth: adaptive quadrature is exact when straight and agrees with arcStep") {
+    TruthStepStats st;
+    const TruthState straight = advanceTruthAdaptive(TruthState{1.0, 2.0, 0.7},
+                                                     twist(20.0, -8.0, 0.0), Time{0.5},
+                                                     kTruthTolerance, &st);
+    CHECK(st.quadrature);
+    CHECK(st.steps == 0);
+    CHECK(straight.x == 1.0 + (20.0 * std::cos(0.7) + 8.0 * std::sin(0.7)) * 0.5);
+    CHECK(straight.y == 2.0 + (20.0 * std::sin(0.7) - 8.0 * std::cos(0.7)) * 0.5);
+    CHECK(straight.theta == 0.7);
+
+    int compared = 0;
+    for (double th0 : {0.0, 0.7, kPi / 2.0, 2.5, -2.0}) {
+        for (double vx : {0.0, -12.0, 25.0}) {
+            for (double vy : {0.0, 9.0, -18.0}) {
+                for (double w : {0.0, 1e-12, 1e-8, 1e-4, -9e-4, 0.05, -0.4, 1.5, -2.7}) {
+                    const TruthState end = advanceTruthAdaptive(TruthState{0.0, 0.0, th0},
+                                                                twist(vx, vy, w), Time{1.0},
+                                                                kTruthTolerance, &st);
+                    CHECK(st.quadrature
+                          == (std::abs(w) <= shulib::sim::kTruthQuadratureMaxSweep));
+                    const FieldDelta d = arcStep(
+                        {.forward = Length{vx}, .lateral = Length{vy}}, Angle::radians(th0),
+                        Angle::radians(th0 + w));
+                    CHECK(d.dx.value() == doctest::Approx(end.x).epsilon(1e-12).scale(1.0));
+                    CHECK(d.dy.value() == doctest::Approx(end.y).epsilon(1e-12).scale(1.0));
+                    ++compared;
+                }
+            }
+        }
+    }
+    CHECK(compared == 5 * 3 * 3 * 9);
+}
+
+// ── The Gauss–Legendre path against RK4 at 1024 substeps, converged far below the budget at
+// these sweeps — a second sampler of the same rate, with different nodes and weights. A
+// tick whose error BOUND exceeds the tolerance despite a small sweep (hundreds of inches in
+// one tick) must leave the path for Dormand–Prince and still agree. ──
+TEST_CASE("sim truth: the adaptive quadrature path agrees with RK4 at 1024 substeps") {
+    int compared = 0;
+    for (double th0 : {0.0, 0.7, kPi / 2.0, 2.5, -2.0}) {
+        for (double dt : {0.005, 0.01, 0.5}) {
+            for (double sweep : {0.0, 1e-12, 1e-8, 3e-5, -4e-4, 9e-4}) {
+                TruthStepStats st;
+                const double w = sweep / dt;
+                const TruthState end = advanceTruthAdaptive(TruthState{0.0, 0.0, th0},
+                                                            twist(70.0, -25.0, w), Time{dt},
+                                                            kTruthTolerance, &st);
+                REQUIRE(st.quadrature);
+                const TruthState fine = advanceTruth(TruthState{0.0, 0.0, th0},
+                                                     twist(70.0, -25.0, w), Time{dt}, 1024);
+                // RK4's own rounding over 1024 substeps grows with the distance covered.
+                const double budget = 1e-12 * std::max(1.0, std::hypot(fine.x, fine.y));
+                CHECK(std::hypot(end.x - fine.x, end.y - fine.y) < budget);
+                CHECK(end.theta == doctest::Approx(fine.theta).epsilon(1e-13));
+                ++compared;
+            }
+        }
+    }
+    CHECK(compared == 5 * 3 * 6);
+
+    TruthStepStats st;
+    const TruthState far = advanceTruthAdaptive(TruthState{0.0, 0.0, 0.7},
+                                                twist(4000.0, 0.0, 9e-4), Time{1.0},
+                                                kTruthTolerance, &st);
+    CHECK(!st.quadrature);
+    CHECK(st.steps >= 1);
+    const TruthState fine =
+        advanceTruth(TruthState{0.0, 0.0, 0.7}, twist(4000.0, 0.0, 9e-4), Time{1.0}, 1024);
+    CHECK(std::hypot(far.x - fine.x, far.y - fine.y) < 1e-12 * std::hypot(fine.x, fine.y));
+}
+
+// ── The tripwire again: a 270° tick is exact under the adaptive integrator too. Neither of
+// its paths shares algebra with arcStep, and a 270° tick runs Dormand–Prince. ──
+TEST_CASE("sim truth: the adaptive integrator handles a rotation beyond arcStep's wrap horizon") {
+    const double rho = 8.0;
+    const double w = 3.0 * kPi / 2.0;
+    const TruthState end =
+        advanceTruthAdaptive(TruthState{}, twist(rho * w, 0.0, w), Time{1.0});
+    CHECK(end.x == doctest::Approx(-rho).epsilon(1e-12));
+    CHECK(end.y == doctest::Approx(rho).epsilon(1e-12));
+    CHECK(end.theta == doctest::Approx(3.0 * kPi / 2.0));
+}
+
+// ── Degenerates and the contract, as for advanceTruth; then the cost against the fixed 32
+// substeps on a plant-like tick mix (reported — host timing is not a pass/fail signal). ──
+TEST_CASE("sim truth: adaptive degenerates, contract, and cost against 32 RK4 substeps") {
+    const TruthState s{1.0, 2.0, 3.0};
+    const TruthState zt = advanceTruthAdaptive(s, twist(0.0, 0.0, 0.0), Time{5.0});
+    CHECK(zt.x == 1.0);
+    CHECK(zt.y == 2.0);
+    CHECK(zt.theta == 3.0);
+    TruthStepStats st;
+    st.steps = 99;
+    const TruthState zdt = advanceTruthAdaptive(s, twist(9.0, 9.0, 9.0), Time{0.0},
+                                                kTruthTolerance, &st);
+    CHECK(zdt.x == 1.0);
+    CHECK(st.steps == 0);  // overwritten, even for the no-op
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    CHECK_THROWS_AS((void)advanceTruthAdaptive(s, twist(1.0, 0.0, 0.0), Time{nan}),
+                    PreconditionError);
+    CHECK_THROWS_AS((void)advanceTruthAdaptive(s, twist(1.0, 0.0, 0.0), Time{0.01}, 0.0),
+                    PreconditionError);
+
+    // A non-physical spin still terminates, at the step floor.
+    (void)advanceTruthAdaptive(s, twist(10.0, 0.0, 1e6), Time{0.01}, kTruthTolerance, &st);
+    CHECK(st.steps <= shulib::sim::kTruthMaxSteps + 1);
+
+    constexpr int kTicks = 20000;
+    double sink = 0.0;
+    const auto twistAt = [](int i) {  // straight, gentle and hard turns, as a drive mixes them
+        const double w = i % 3 == 0 ? 0.0 : (i % 3 == 1 ? 0.4 : 4.0);
+        return twist(60.0, 5.0, w + 1e-6 * static_cast<double>(i % 7));
+    };
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kTicks; ++i) {
+        sink += advanceTruth(s, twistAt(i), Time{0.01}, 32).x;
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kTicks; ++i) {
+        sink -= advanceTruthAdaptive(s, twistAt(i), Time{0.01}).x;
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+    CHECK(std::abs(sink) < 1e-12 * kTicks);  // the same ticks, within budget of each other
+    const double rk4Ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / kTicks;
+    const double adaptiveNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / kTicks;
+    MESSAGE("truth tick: RK4x32 " << rk4Ns << " ns, adaptive " << adaptiveNs << " ns (host, "
+                                  << rk4Ns / adaptiveNs << "x)");
+}
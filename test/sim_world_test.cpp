@@ -0,0 +1,286 @@
+// Tests for the multi-robot world (sim/sim_world.hpp). Every stopping point is hand
+// geometry, and every delivery time is the link config plus the tick rule. Targets:
+//  * LOCKSTEP AND CONTACT: robots share one instant every tick; two robots driving at each
+//    other stop face to face instead of passing through, and the shared field's wall
+//    still holds a third.
+//  * PARTNERS: the cookbook's "wait for your alliance partner" over the radio — the second
+//    robot moves only after the first's all-clear arrives, no earlier than the link's
+//    latency; with a dead link its waitFor times out and it never moves.
+//  * DETERMINISM: a threaded run under FullHostility, a lossy delayed link and contact is
+//    byte-identical run to run.
+//  * STOPPING: the time limit unwinds an unfinished program; a program's exception stops
+//    every robot and comes out of run().
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "shulib/chassis/routine.hpp"
+#include "shulib/math/angle.hpp"
+#include "shulib/math/pose2d.hpp"
+#include "shulib/math/twist2d.hpp"
+#include "shulib/sim/field_geometry.hpp"
+#include "shulib/sim/scenario.hpp"
+#include "shulib/sim/scenario_file.hpp"
+#include "shulib/sim/sim_world.hpp"
+#include "shulib/units/quantity.hpp"
+
+using shulib::chassis::Routine;
+using shulib::chassis::RoutineResult;
+using shulib::chassis::RoutineStopCause;
+using shulib::math::Angle;
+using shulib::math::ChassisSpeeds;
+using shulib::math::Pose2d;
+using shulib::sim::FieldGeometry;
+using shulib::sim::ScenarioSpec;
+using shulib::sim::SimMessage;
+using shulib::sim::SimWorld;
+using shulib::sim::SimWorldConfig;
+using shulib::sim::TruthSample;
+using shulib::units::AngularVelocity;
+using shulib::units::Length;
+using shulib::units::Time;
+using shulib::units::Velocity;
+
+namespace {
+
+constexpr std::uint32_t kClear = 7;
+
+Pose2d pose(double x, double y, double deg) {
+    return Pose2d{Length{x}, Length{y}, Angle::degrees(deg)};
+}
+
+/// A robot that starts at (x, y, deg) and has no verbs: its program drives it.
+ScenarioSpec startAt(double x, double y, double deg) {
+    ScenarioSpec s;
+    s.start = pose(x, y, deg);
+    return s;
+}
+
+ScenarioSpec hostileAt(double x, double y, double deg) {
+    ScenarioSpec s = startAt(x, y, deg);
+    s.hostile = true;
+    return s;
+}
+
+ScenarioSpec parsed(const std::string& text) {
+    const shulib::sim::ScenarioParseResult r = shulib::sim::parseScenario(text);
+    REQUIRE(r.ok());
+    return r.spec;
+}
+
+double truthX(SimWorld& w, int i) { return w.robot(i).harness().truePose().x().value(); }
+double truthY(SimWorld& w, int i) { return w.robot(i).harness().truePose().y().value(); }
+
+/// The partner drill: robot 0 clears the lane and says so; robot 1 waits for it, then
+/// takes the lane. Returns robot 1's routine verdict.
+struct PartnerDrill {
+    double sentAt = -1.0;
+    double heardAt = -1.0;
+    RoutineResult second{};
+
+    void run(SimWorld& w) {
+        w.run({[&] {
+                   Routine r{w.robot(0).chassis(), "first"};
+                   r.moveTo(pose(-24.0, 24.0, 0.0), {.timeout = Time{4.0}});
+                   sentAt = w.now().value();
+                   w.radio(0).send(1, kClear);
+               },
+               [&] {
+                   Routine r{w.robot(1).chassis(), "second"};
+                   r.waitFor(
+                        [&] {
+                            SimMessage m;
+                            if (w.radio(1).receive(m) && m.topic == kClear) {
+                                heardAt = w.robot(1).harness().clock().now().value();
+                                return true;
+                            }
+                            return false;
+                        },
+                        Time{6.0}, "partner-clear")
+                       .moveTo(pose(-24.0, -24.0, 0.0), {.timeout = Time{4.0}});
+                   second = r.result();
+               }});
+    }
+};
+
+}  // namespace
+
+// Would catch: robots whose clocks drift apart, a plant that ignores the other robots'
+// boxes (the two would pass through each other), contact against a box where the robot
+// WILL be rather than where it was (an overlap larger than one tick's closing), or a
+// world that drops the shared field.
+TEST_CASE("sim world: robots tick in lockstep and stop against each other") {
+    const FieldGeometry field = FieldGeometry::vexField();
+    SimWorld w{SimWorldConfig{.field = &field}};
+    REQUIRE(w.addRobot(startAt(-30.0, 0.0, 0.0), 1) == 0);
+    REQUIRE(w.addRobot(startAt(30.0, 0.0, 180.0), 2) == 1);
+    REQUIRE(w.addRobot(startAt(40.0, 48.0, 0.0), 3) == 2);  // alone, bound for the wall
+    const ChassisSpeeds forward{Velocity{20.0}, Velocity{0.0}, AngularVelocity{0.0}};
+    for (int i = 0; i < 3; ++i) {
+        w.robot(i).harness().commandBodyTwist(forward);
+    }
+    bool lockstep = true;
+    double closest = 1e9;
+    w.afterTick = [&](long) {
+        const double t = w.now().value();
+        for (int i = 1; i < 3; ++i) {
+            lockstep = lockstep && w.robot(i).harness().clock().now().value() == t;
+        }
+        closest = std::min(closest, truthX(w, 1) - truthX(w, 0));
+    };
+    for (int k = 0; k < 300; ++k) {
+        w.step();
+    }
+    CHECK(w.ticks() == 300);
+    CHECK(lockstep);
+    CHECK(w.now().value() == doctest::Approx(3.0));
+    // Face to face at x = ±9 (footprint half-length 9); never closer than 18 in minus one
+    // tick of closing (2 × 20 in/s × 0.01 s).
+    CHECK(truthX(w, 0) == doctest::Approx(-9.0).epsilon(0.01));
+    CHECK(truthX(w, 1) == doctest::Approx(9.0).epsilon(0.01));
+    CHECK(closest >= 18.0 - 0.4 - 1e-9);
+    CHECK(w.robot(0).harness().plant().inContact());
+    CHECK(w.robot(1).harness().plant().inContact());
+    // The third robot met the shared perimeter: 72 − 9.
+    CHECK(truthX(w, 2) == doctest::Approx(63.0).epsilon(0.01));
+    CHECK(std::abs(truthY(w, 2) - 48.0) < 1e-6);
+}
+
+// Would catch: a message read on the tick it was sent (faster than any radio), latency
+// ignored or added twice, a lost message that arrives anyway, or a partner that moves
+// before — or without — its all-clear.
+TEST_CASE("sim world: a partner waits for the radio's all-clear, latency and loss included") {
+    SUBCASE("a delayed link: the lane is taken after the all-clear, not before") {
+        SimWorld w{SimWorldConfig{.link = {.latency = Time{0.25}}}};
+        (void)w.addRobot(startAt(-48.0, 24.0, 0.0), 1);
+        (void)w.addRobot(startAt(-48.0, -24.0, 0.0), 2);
+        PartnerDrill drill;
+        drill.run(w);
+        REQUIRE(drill.sentAt > 0.0);
+        CAPTURE(drill.sentAt);
+        CAPTURE(drill.heardAt);
+        CHECK(drill.heardAt >= drill.sentAt + 0.25 - 1e-9);
+        CHECK(drill.heardAt <= drill.sentAt + 0.25 + 0.02 + 1e-9);
+        CHECK(drill.second.ok);
+        CHECK(w.linkStats().sent == 1);
+        CHECK(w.linkStats().delivered == 1);
+        CHECK(std::hypot(truthX(w, 1) + 24.0, truthY(w, 1) + 24.0) < 1.0);
+    }
+    SUBCASE("a dead link: the wait times out and the partner never moves") {
+        SimWorld w{SimWorldConfig{.link = {.lossProbability = 1.0}}};
+        (void)w.addRobot(startAt(-48.0, 24.0, 0.0), 1);
+        (void)w.addRobot(startAt(-48.0, -24.0, 0.0), 2);
+        PartnerDrill drill;
+        drill.run(w);
+        CHECK(drill.heardAt < 0.0);
+        CHECK_FALSE(drill.second.ok);
+        CHECK(drill.second.cause == RoutineStopCause::WaitTimedOut);
+        CHECK(w.linkStats().lost == 1);
+        CHECK(w.linkStats().delivered == 0);
+        CHECK(std::hypot(truthX(w, 1) + 48.0, truthY(w, 1) + 24.0) < 0.5);
+    }
+}
+
+// Would catch: anything the robots' threads share during the step phase (a race would
+// show as a run that differs from its twin), a loss draw taken in thread order, or a
+// delivery order that depends on which robot arrived at the barrier first.
+TEST_CASE("sim world: a threaded hostile run is byte-identical run to run") {
+    const auto once = [] {
+        const FieldGeometry field = FieldGeometry::vexField();
+        SimWorld w{SimWorldConfig{.field = &field,
+                                  .link = {.latency = Time{0.05}, .lossProbability = 0.3},
+                                  .seed = 11,
+                                  .timeLimit = Time{4.0}}};
+        (void)w.addRobot(hostileAt(-36.0, 0.0, 0.0), 5);
+        ScenarioSpec ekf = hostileAt(36.0, 0.0, 180.0);
+        ekf.fusion = shulib::sim::ScenarioFusion::Ekf;
+        (void)w.addRobot(ekf, 6);
+        std::vector<TruthSample> trace;
+        std::vector<double> heard;
+        w.afterTick = [&](long) {
+            trace.push_back(w.robot(0).harness().sample());
+            trace.push_back(w.robot(1).harness().sample());
+        };
+        // Both drive for the middle and report their progress every leg; each listens to
+        // the other between legs. They meet near x = 0.
+        const auto program = [&](int self, double sign) {
+            return [&w, &heard, self, sign] {
+                for (int leg = 1; leg <= 4; ++leg) {
+                    const double x = sign * (36.0 - 9.0 * leg);
+                    (void)w.robot(self).chassis().moveTo(
+                        pose(x, 0.0, sign > 0 ? 180.0 : 0.0),
+                        {.timeout = Time{0.8}});
+                    w.radio(self).send(1 - self, static_cast<std::uint32_t>(leg),
+                                       {w.robot(self).harness().truePose().x().value()});
+                    SimMessage m;
+                    while (w.radio(self).receive(m)) {
+                        heard.push_back(m.values[0]);
+                    }
+                }
+            };
+        };
+        w.run({program(0, -1.0), program(1, 1.0)});
+        struct Out {
+            std::vector<TruthSample> trace;
+            long sent, lost, delivered, ticks;
+        };
+        return Out{trace, w.linkStats().sent, w.linkStats().lost, w.linkStats().delivered,
+                   w.ticks()};
+    };
+    const auto a = once();
+    const auto b = once();
+    REQUIRE(a.ticks > 100);
+    REQUIRE(a.trace.size() == b.trace.size());
+    CHECK(std::memcmp(a.trace.data(), b.trace.data(), a.trace.size() * sizeof(TruthSample)) == 0);
+    CHECK(a.sent == 8);
+    CHECK(a.lost == b.lost);
+    CHECK(a.delivered == b.delivered);
+    CHECK(a.lost + a.delivered <= a.sent);
+    MESSAGE("hostile pair: " << a.ticks << " ticks, " << a.lost << " of " << a.sent
+                             << " messages lost");
+}
+
+// Would catch: a time limit that waits for every program anyway (a stuck partner would
+// hang the suite), a program exception swallowed or rethrown before the other threads
+// join (a crash), or a limit that reports a run that simply finished.
+TEST_CASE("sim world: the time limit and a program's exception stop every robot") {
+    SUBCASE("the limit unwinds an unfinished program") {
+        SimWorld w{SimWorldConfig{.timeLimit = Time{0.5}}};
+        (void)w.addRobot(startAt(0.0, 0.0, 0.0), 1);
+        (void)w.addRobot(startAt(0.0, 48.0, 0.0), 2);
+        w.run({[&] { w.robot(0).chassis().wait(Time{100.0}); }, [] {}});
+        CHECK(w.stoppedAtLimit());
+        CHECK(w.now().value() == doctest::Approx(0.5).epsilon(0.03));
+        CHECK(w.robot(1).harness().clock().now().value() == w.now().value());
+    }
+    SUBCASE("an exception stops the run and comes out of run()") {
+        SimWorld w;
+        (void)w.addRobot(startAt(0.0, 0.0, 0.0), 1);
+        (void)w.addRobot(startAt(0.0, 48.0, 0.0), 2);
+        CHECK_THROWS_AS(w.run({[&] { w.robot(0).chassis().wait(Time{100.0}); },
+                               [&] {
+                                   w.robot(1).chassis().wait(Time{0.2});
+                                   throw std::runtime_error{"boom"};
+                               }}),
+                        std::runtime_error);
+        CHECK_FALSE(w.stoppedAtLimit());
+        CHECK(w.now().value() < 0.3);
+    }
+    SUBCASE("a finished run is not a stopped one; an empty program runs the verbs") {
+        SimWorld w{SimWorldConfig{.timeLimit = Time{10.0}}};
+        (void)w.addRobot(parsed("start 0 0 0\nmoveTo 12 0 0 3\n"), 1);
+        (void)w.addRobot(parsed("start 0 48 0\nwait 0.3\n"), 2);
+        w.run();
+        CHECK_FALSE(w.stoppedAtLimit());
+        REQUIRE(w.verbResults(0).size() == 1);
+        CHECK(w.verbResults(0)[0].exit == shulib::control::ExitReason::Settled);
+        CHECK(truthX(w, 0) == doctest::Approx(12.0).epsilon(0.05));
+    }
+}
@@ -0,0 +1,265 @@
+// Tests for diag/tick_budget.hpp — deadline-aware load shedding. What each targets:
+//  * THE LEVEL: thresholds are INCLUSIVE fractions of the budget, pinned with exact
+//    binary values so a '>' where '>=' belongs turns red; the shed order is the
+//    declared one (a level of N sheds exactly the first N classes).
+//  * ESCALATE FAST, RECOVER SLOW: an overrun sheds everything on the tick it happens;
+//    recovery steps down ONE class per `recoveryTicks` calm ticks, and a tick back at
+//    the level restarts the count — a loop hovering at a threshold must not flap.
+//  * HEALTH IS DECIMATED, NEVER SKIPPED: at full shed one tick in N still runs, and an
+//    IMU dropout on a hot scheduled loop is still raised.
+//  * COUNTED, NOT SILENT: per-class shed ticks, escalations and the peak level reach
+//    RunSummary through RunReporter, and the scheduler logs every level change. The
+//    queries count nothing, however often they are asked.
+//  * OFF MEANS OFF: with no TickBudget the scheduler routes none into its deps.
+
+#include "doctest.h"
+
+#include <limits>
+#include <string>
+
+#include "motion_test_rig.hpp"
+#include "shulib/core/check.hpp"
+#include "shulib/diag/loop_monitor.hpp"
+#include "shulib/diag/tick_budget.hpp"
+#include "shulib/hal/fake/fake_telemetry_sink.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/motion/motion_scheduler.hpp"
+#include "shulib/motion/run_reporter.hpp"
+#include "shulib/sim/hostile/composed.hpp"
+#include "shulib/units/quantity.hpp"
+
+using namespace motion_rig;
+using shulib::PreconditionError;
+using shulib::diag::FaultCode;
+using shulib::diag::LoopMonitorConfig;
+using shulib::diag::SheddableWork;
+using shulib::diag::TickBudget;
+using shulib::diag::TickBudgetConfig;
+using shulib::hal::LogLevel;
+using shulib::hal::fake::FakeTelemetrySink;
+using shulib::kinematics::xDrive;
+using shulib::motion::MotionScheduler;
+using shulib::motion::MotionSchedulerConfig;
+using shulib::motion::RunReporter;
+using shulib::motion::WaitResult;
+using shulib::sim::ImuHostileConfig;
+using shulib::sim::ImuHostileModel;
+
+namespace {
+
+/// A 1 s budget with binary-exact thresholds and no smoothing: every level below is a
+/// hand-checkable function of the last observed cost.
+TickBudget exactBudget(int recoveryTicks = 3, int healthDecimation = 4) {
+    TickBudgetConfig cfg;
+    cfg.shedAt = {0.5, 0.625, 0.75, 0.875};
+    cfg.smoothing = 1.0;
+    cfg.recoveryTicks = recoveryTicks;
+    cfg.healthDecimation = healthDecimation;
+    return TickBudget{LoopMonitorConfig{Time{1.0}}, cfg};
+}
+
+bool anyLineContains(const FakeTelemetrySink& sink, LogLevel level, const std::string& text) {
+    for (int i = 0; i < sink.size(); ++i) {
+        if (sink.at(i).level == level && sink.at(i).message.find(text) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+// Bug caught: a threshold compared with '>' (the exact-threshold tick sheds nothing), or
+// a level that sheds classes out of the declared order.
+TEST_CASE("TickBudget: each threshold is inclusive and sheds the next class in order") {
+    TickBudget b = exactBudget();
+    b.observe(Time{0.25});
+    CHECK(b.level() == 0);
+    CHECK_FALSE(b.shed(SheddableWork::RecordPopulation));
+
+    b.observe(Time{0.5});  // exactly at shedAt[0]
+    CHECK(b.level() == 1);
+    CHECK(b.shed(SheddableWork::RecordPopulation));
+    CHECK_FALSE(b.shed(SheddableWork::SdFlush));
+
+    b.observe(Time{0.75});  // exactly at shedAt[2]: two more classes at once
+    CHECK(b.level() == 3);
+    CHECK(b.shed(SheddableWork::SdFlush));
+    CHECK(b.shed(SheddableWork::VisionPoll));
+    CHECK_FALSE(b.shed(SheddableWork::HealthCheck));
+    CHECK(b.escalations() == 2);
+    CHECK(b.maxLevel() == 3);
+}
+
+// Bug caught: an overrun waiting for the smoother — several more late ticks before the
+// loop starts shedding, each one a corrupted dt.
+TEST_CASE("TickBudget: an overrun sheds everything on the tick it happens") {
+    TickBudgetConfig cfg;
+    cfg.smoothing = 0.1;  // heavy smoothing: the average alone would take many ticks
+    TickBudget b{LoopMonitorConfig{Time{0.015}}, cfg};
+    for (int i = 0; i < 20; ++i) {
+        b.observe(Time{0.002});
+    }
+    REQUIRE(b.level() == 0);
+
+    b.observe(Time{0.015});  // AT the budget — LoopMonitor's inclusive boundary
+    CHECK(b.level() == shulib::diag::kSheddableWorkCount);
+    CHECK(b.smoothedCost().value() < 0.015 * cfg.shedAt[0]);  // the smoother never saw it
+    CHECK(b.escalations() == 1);  // a multi-class jump is ONE escalation
+}
+
+// Bug caught: recovery that is immediate (flapping at a threshold) or that never
+// happens (a single bad tick sheds for the rest of the run).
+TEST_CASE("TickBudget: recovery steps down one class per recoveryTicks calm ticks") {
+    TickBudget b = exactBudget(3);
+    b.observe(Time{1.0});
+    REQUIRE(b.level() == 4);
+
+    b.observe(Time{0.0});
+    b.observe(Time{0.0});
+    CHECK(b.level() == 4);
+    b.observe(Time{0.0});
+    CHECK(b.level() == 3);
+
+    // A tick back AT the level restarts the count: calm must be consecutive.
+    b.observe(Time{0.0});
+    b.observe(Time{0.0});
+    b.observe(Time{0.75});
+    b.observe(Time{0.0});
+    b.observe(Time{0.0});
+    CHECK(b.level() == 3);
+    b.observe(Time{0.0});
+    CHECK(b.level() == 2);
+
+    for (int i = 0; i < 6; ++i) {
+        b.observe(Time{0.0});
+    }
+    CHECK(b.level() == 0);
+    CHECK(b.maxLevel() == 4);
+    CHECK(b.escalations() == 1);
+    CHECK(b.everShed());
+}
+
+// Bug caught: health shed outright at the top level (a pathology never detected), or
+// decimation that runs health on the wrong count of ticks.
+TEST_CASE("TickBudget: health is decimated — one tick in N still runs") {
+    TickBudget b = exactBudget(3, 4);
+    int healthRan = 0;
+    for (int i = 0; i < 12; ++i) {
+        b.observe(Time{1.0});
+        if (!b.shed(SheddableWork::HealthCheck)) {
+            ++healthRan;
+        }
+    }
+    CHECK(healthRan == 3);
+    CHECK(b.shedTicks(SheddableWork::HealthCheck) == 9);
+    CHECK(b.shedTicks(SheddableWork::RecordPopulation) == 12);
+    CHECK(b.ticksObserved() == 12);
+}
+
+// Bug caught: counting inside the query — a shed() asked by three consumers would then
+// triple-count, the RateLimitedSink query-must-not-mutate rule.
+TEST_CASE("TickBudget: queries are const and count nothing") {
+    TickBudget b = exactBudget();
+    b.observe(Time{1.0});
+    for (int i = 0; i < 50; ++i) {
+        (void)b.shed(SheddableWork::RecordPopulation);
+        (void)b.shed(SheddableWork::SdFlush);
+    }
+    CHECK(b.shedTicks(SheddableWork::RecordPopulation) == 1);
+    CHECK(b.shedTicks(SheddableWork::SdFlush) == 1);
+}
+
+// Bug caught: a NaN cost from a broken clock spiking the loop into full shed, or
+// poisoning the smoother so it never recovers.
+TEST_CASE("TickBudget: a non-finite or negative cost reads as zero") {
+    TickBudget b = exactBudget(1);
+    b.observe(Time{std::numeric_limits<double>::quiet_NaN()});
+    b.observe(Time{-5.0});
+    CHECK(b.level() == 0);
+    CHECK(b.smoothedCost().value() == 0.0);
+}
+
+// Bug caught: a config that reorders the declared shed order, or makes health
+// skippable ("decimate by 1"), accepted silently.
+TEST_CASE("TickBudget: preconditions guard the declared order and the config") {
+    const LoopMonitorConfig loop{};
+    TickBudgetConfig reordered;
+    reordered.shedAt = {0.9, 0.8, 0.87, 0.93};
+    CHECK_THROWS_AS((TickBudget{loop, reordered}), PreconditionError);
+    TickBudgetConfig over;
+    over.shedAt = {0.75, 0.8, 0.9, 1.5};
+    CHECK_THROWS_AS((TickBudget{loop, over}), PreconditionError);
+    TickBudgetConfig noSmoothing;
+    noSmoothing.smoothing = 0.0;
+    CHECK_THROWS_AS((TickBudget{loop, noSmoothing}), PreconditionError);
+    TickBudgetConfig noDecimation;
+    noDecimation.healthDecimation = 1;
+    CHECK_THROWS_AS((TickBudget{loop, noDecimation}), PreconditionError);
+    TickBudgetConfig noRecovery;
+    noRecovery.recoveryTicks = 0;
+    CHECK_THROWS_AS((TickBudget{loop, noRecovery}), PreconditionError);
+    CHECK_NOTHROW((TickBudget{loop}));
+}
+
+// ═══ Scheduler integration ═══════════════════════════════════════════════════════════
+
+// Bug caught: the shedder and the overrun detector disagreeing about the deadline.
+TEST_CASE("TickBudget + scheduler: the budget must match loopMonitor.budget; off means off") {
+    const auto kin = xDrive(Length{7.0});
+    MotionRig rig{kin};
+    PlantPacer pacer{rig.h};
+    TickBudget wrong{LoopMonitorConfig{Time{0.02}}};
+    CHECK_THROWS_AS((MotionScheduler{rig.deps, pacer, MotionSchedulerConfig{.tickBudget = &wrong}}),
+                    PreconditionError);
+
+    MotionScheduler off{rig.deps, pacer};
+    CHECK(off.tickBudget() == nullptr);
+    CHECK(off.deps().budget == nullptr);
+
+    TickBudget right{LoopMonitorConfig{}};
+    MotionScheduler on{rig.deps, pacer, MotionSchedulerConfig{.tickBudget = &right}};
+    CHECK(on.tickBudget() == &right);
+    CHECK(on.deps().budget == &right);
+}
+
+// Bug caught: the whole feature dead in the loop that matters — a hot scheduled loop
+// that never sheds, sheds without saying so, never recovers, or sheds health so hard an
+// IMU dropout is never raised. Then the run summary must carry the story.
+TEST_CASE("TickBudget + scheduler: a hot loop sheds, logs it, still raises IMU_LOST, "
+          "recovers, and reports") {
+    ImuHostileConfig imuCfg;
+    imuCfg.calibrationEnd = Time{0.0};
+    imuCfg.dropoutAt = Time{0.5};
+    ImuHostileModel imu{imuCfg};
+    FakeTelemetrySink sink;
+    TickBudget budget{LoopMonitorConfig{}};
+    const auto kin = xDrive(Length{7.0});
+    SchedulerRig s{kin, plantConfig(), &sink, &imu, MotionSchedulerConfig{.tickBudget = &budget}};
+    FakeTelemetrySink report;
+    RunReporter reporter{report, s.sched};
+
+    s.pacer.tickDt = Time{0.02};  // every tick past the 15 ms budget
+    CHECK(s.sched.waitUntil([] { return false; }, 1.0) == WaitResult::TimedOut);
+    CHECK(budget.level() == shulib::diag::kSheddableWorkCount);
+    CHECK(anyLineContains(sink, LogLevel::Warn, "load shed: level 0→4"));
+    const std::uint32_t healthSkipped = budget.shedTicks(SheddableWork::HealthCheck);
+    CHECK(healthSkipped > 0);
+    CHECK(healthSkipped < budget.ticksObserved());
+    CHECK(s.rig.latch.raiseCount(FaultCode::ImuLost) == 1);  // decimated, not blinded
+
+    s.pacer.tickDt = Time{0.01};  // the load goes away
+    CHECK(s.sched.waitUntil([] { return false; }, 2.0) == WaitResult::TimedOut);
+    CHECK(budget.level() == 0);
+    CHECK(anyLineContains(sink, LogLevel::Info, "load shed: level 1→0"));
+
+    reporter.finishRun();
+    REQUIRE(report.summaryCount() == 1);
+    const auto& summary = report.lastSummary();
+    CHECK(summary.hasLoadShedData);
+    CHECK(summary.shedMaxLevel == 4);
+    CHECK(summary.shedEscalations == budget.escalations());
+    CHECK(summary.shedTicksObserved == budget.ticksObserved());
+    CHECK(summary.shedTicks[0] == budget.shedTicks(SheddableWork::RecordPopulation));
+    CHECK(summary.shedTicks[3] == budget.shedTicks(SheddableWork::HealthCheck));
+}
@@ -0,0 +1,228 @@
+// Tests for diag/tick_histogram.hpp and its two feeds (LoopMonitor's dt, TickAttribution's
+// phases). What each targets:
+//  * THE PERCENTILE PROMISE: a reported percentile is never BELOW the true nearest-rank
+//    value and at most one bin ratio above it — checked against an exact sort over a
+//    swept sample set, because a histogram that understates its tail sets a budget that
+//    overruns.
+//  * THE QUESTION IT EXISTS FOR: "sometimes 14.9 ms" and "always 14.9 ms" have the same
+//    worstDt and must have different distributions.
+//  * BIN EDGES: half-open bins, underflow/overflow, and the exact max.
+//  * HONEST INPUT HANDLING: non-finite/negative samples are refused and counted, never
+//    binned; preconditions on the range and on q are loud.
+//  * THE FEEDS: baseline ticks and abandoned ticks are not samples; LoopMonitor::reset()
+//    keeps the record, TickAttribution::reset() forgets it.
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "shulib/core/check.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/fault.hpp"
+#include "shulib/diag/loop_monitor.hpp"
+#include "shulib/diag/tick_attribution.hpp"
+#include "shulib/diag/tick_histogram.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/hal/fake/fake_telemetry_sink.hpp"
+#include "shulib/units/quantity.hpp"
+
+using shulib::PreconditionError;
+using shulib::diag::FaultLatch;
+using shulib::diag::kTickHistogramBins;
+using shulib::diag::LoopMonitor;
+using shulib::diag::LoopMonitorConfig;
+using shulib::diag::TickAttribution;
+using shulib::diag::TickHistogram;
+using shulib::diag::TickHistogramRange;
+using shulib::diag::TickPhase;
+using shulib::diag::TickTimingStats;
+using shulib::hal::fake::FakeClock;
+using shulib::hal::fake::FakeTelemetrySink;
+using shulib::units::Time;
+
+namespace {
+/// One bin's width as a ratio over the default 5–50 ms range.
+const double kBinRatio = std::pow(10.0, 1.0 / kTickHistogramBins);
+
+/// The exact nearest-rank q-quantile of `xs` (the definition the histogram approximates).
+double nearestRank(std::vector<double> xs, double q) {
+    std::sort(xs.begin(), xs.end());
+    const auto rank = static_cast<std::size_t>(std::ceil(q * static_cast<double>(xs.size())));
+    return xs[std::max<std::size_t>(rank, 1U) - 1U];
+}
+}  // namespace
+
+// Bug caught: an estimator that reports the bin's LOWER edge or midpoint — it would
+// understate the tail, and a budget set from it overruns. Swept over a deterministic
+// spread that crosses many bins, against an exact sort.
+TEST_CASE("TickHistogram: percentiles bound the true value from above, within one bin") {
+    TickHistogram h;
+    std::vector<double> xs;
+    for (int i = 0; i < 997; ++i) {
+        // A deterministic, irregular spread over ~6–40 ms.
+        const double x = 0.006 + 0.034 * std::fmod(static_cast<double>(i) * 0.618034, 1.0);
+        xs.push_back(x);
+        h.record(Time{x});
+    }
+    REQUIRE(h.count() == 997);
+    for (const double q : {0.01, 0.25, 0.50, 0.90, 0.95, 0.99, 1.0}) {
+        const double truth = nearestRank(xs, q);
+        const double got = h.percentile(q).value();
+        CAPTURE(q);
+        CHECK(got >= truth);
+        CHECK(got <= truth * kBinRatio * (1.0 + 1e-12));
+    }
+    CHECK(h.max().value() == *std::max_element(xs.begin(), xs.end()));
+    CHECK(h.percentile(1.0).value() == h.max().value());
+}
+
+// Bug caught: the distribution collapsing to the worst case — the reason this exists.
+// Both loops have worstDt 14.9 ms; only the histogram tells them apart.
+TEST_CASE("TickHistogram: 'sometimes 14.9 ms' and 'always 14.9 ms' are different runs") {
+    TickHistogram sometimes;
+    TickHistogram always;
+    for (int i = 0; i < 1000; ++i) {
+        sometimes.record(Time{i % 100 < 2 ? 0.0149 : 0.0100});  // 2% slow
+        always.record(Time{0.0149});
+    }
+    CHECK(sometimes.max().value() == always.max().value());
+
+    const TickTimingStats s = sometimes.stats();
+    CHECK(s.p50.value() >= 0.0100);
+    CHECK(s.p50.value() <= 0.0100 * kBinRatio);
+    CHECK(s.p95.value() <= 0.0100 * kBinRatio);
+    CHECK(s.p99.value() == 0.0149);  // rank 990 is a slow tick: its bin clamps to the max
+
+    const TickTimingStats a = always.stats();
+    CHECK(a.p50.value() == 0.0149);  // one bin, clamped to the exact max
+    CHECK(a.p95.value() == 0.0149);
+    CHECK(a.p99.value() == 0.0149);
+}
+
+// Bug caught: an off-by-one at the edges — lo falling into underflow, hi into the last
+// log bin, or the overflow percentile reporting an edge of +inf.
+TEST_CASE("TickHistogram: half-open bins, under/overflow, and the exact max") {
+    TickHistogram h;
+    const auto& c = h.counts();
+    h.record(Time{0.00499});
+    CHECK(c.front() == 1);
+    h.record(Time{0.005});  // exactly lo: the first log bin, not underflow
+    CHECK(c[1] == 1);
+    h.record(Time{0.050});  // exactly hi: overflow
+    CHECK(c.back() == 1);
+    h.record(Time{0.200});
+    CHECK(c.back() == 2);
+    CHECK(h.count() == 4);
+    CHECK(h.max().value() == 0.200);
+    CHECK(h.percentile(1.0).value() == 0.200);  // overflow reports the exact max
+
+    CHECK(h.slotUpperEdge(0).value() == doctest::Approx(0.005));
+    CHECK(h.slotUpperEdge(static_cast<std::size_t>(kTickHistogramBins)).value()
+          == doctest::Approx(0.050));
+    CHECK(std::isinf(h.slotUpperEdge(TickHistogram::kSlots - 1).value()));
+    CHECK_THROWS_AS((void)h.slotUpperEdge(TickHistogram::kSlots), PreconditionError);
+
+    TickHistogram low;
+    low.record(Time{0.0});
+    low.record(Time{0.001});
+    CHECK(low.percentile(0.5).value() == 0.001);  // underflow: lo, clamped to the max
+}
+
+// Bug caught: a NaN from a bad clock read landing in a bin (or in max) and poisoning
+// the whole run's tail; and the empty histogram inventing numbers.
+TEST_CASE("TickHistogram: bad samples are refused and counted; empty means zeros") {
+    TickHistogram h;
+    CHECK(h.stats().count == 0);
+    CHECK(h.stats().p99.value() == 0.0);
+    CHECK(h.percentile(0.5).value() == 0.0);
+
+    h.record(Time{std::numeric_limits<double>::quiet_NaN()});
+    h.record(Time{std::numeric_limits<double>::infinity()});
+    h.record(Time{-0.001});
+    CHECK(h.count() == 0);
+    CHECK(h.rejected() == 3);
+    CHECK(h.max().value() == 0.0);
+
+    h.record(Time{0.010});
+    h.reset();
+    CHECK(h.count() == 0);
+    CHECK(h.rejected() == 0);
+    CHECK(h.max().value() == 0.0);
+}
+
+// Bug caught: a range that makes the bin arithmetic divide by zero or take log of a
+// negative, accepted quietly; a quantile outside (0, 1] answered anyway.
+TEST_CASE("TickHistogram: range and quantile preconditions are loud") {
+    CHECK_THROWS_AS((TickHistogram{TickHistogramRange{Time{0.0}, Time{0.05}}}), PreconditionError);
+    CHECK_THROWS_AS((TickHistogram{TickHistogramRange{Time{0.05}, Time{0.05}}}), PreconditionError);
+    CHECK_THROWS_AS((TickHistogram{TickHistogramRange{
+                        Time{0.005}, Time{std::numeric_limits<double>::infinity()}}}),
+                    PreconditionError);
+    const TickHistogram h;
+    CHECK_THROWS_AS((void)h.percentile(0.0), PreconditionError);
+    CHECK_THROWS_AS((void)h.percentile(1.5), PreconditionError);
+}
+
+// Bug caught: the baseline tick's dt = 0 counted as a sample (every run would show a
+// phantom 0 ms tick), or reset() wiping the run's record at a deliberate pause.
+TEST_CASE("LoopMonitor: every measured dt is binned; baselines are not; reset keeps it") {
+    FakeTelemetrySink sink;
+    FakeClock clock;
+    FaultLatch latch{sink, clock};
+    LoopMonitor mon{clock, latch, LoopMonitorConfig{Time{0.015}}};
+
+    (void)mon.tick();  // baseline
+    for (int i = 0; i < 50; ++i) {
+        clock.advance(Time{0.010});
+        (void)mon.tick();
+    }
+    CHECK(mon.dtHistogram().count() == 50);
+    CHECK(mon.dtHistogram().max().value() == doctest::Approx(0.010));
+
+    mon.reset();
+    clock.advance(Time{3.0});  // a deliberate pause
+    (void)mon.tick();          // re-baseline: not a sample
+    clock.advance(Time{0.012});
+    (void)mon.tick();
+    CHECK(mon.dtHistogram().count() == 51);
+    CHECK(mon.dtHistogram().max().value() == doctest::Approx(0.012));
+    CHECK(mon.dtHistogram().max().value() == mon.worstDt().value());
+}
+
+// Bug caught: a half-measured (abandoned) tick entering the distribution, or the
+// phase histograms surviving a run-boundary reset().
+TEST_CASE("TickAttribution: completed ticks feed the phase histograms; abandoned ones don't") {
+    FakeClock clock;
+    TickAttribution att{clock};
+    for (int i = 0; i < 20; ++i) {
+        att.beginTick();
+        {
+            const auto scope = att.phase(TickPhase::Localization);
+            clock.advance(Time{i == 19 ? 0.006 : 0.002});
+        }
+        att.endTick();
+    }
+    att.beginTick();
+    {
+        const auto scope = att.phase(TickPhase::Localization);
+        clock.advance(Time{0.040});
+    }
+    att.abandonTick();
+
+    const TickHistogram& loc = att.phaseHistogram(TickPhase::Localization);
+    CHECK(loc.count() == 20);
+    CHECK(loc.max().value() == doctest::Approx(0.006));  // the abandoned 40 ms is absent
+    CHECK(loc.percentile(0.5).value() >= 0.002);
+    CHECK(loc.percentile(0.5).value() <= 0.0025);
+    const TickHistogram& usr = att.phaseHistogram(TickPhase::User);
+    CHECK(usr.count() == 20);         // every slot is sampled each completed tick…
+    CHECK(usr.max().value() == 0.0);  // …and a slot with no producer keeps max 0
+
+    att.reset();
+    CHECK(att.phaseHistogram(TickPhase::Localization).count() == 0);
+}
@@ -0,0 +1,196 @@
+// Tests for hal/tick_pll.hpp (the PLL pacing arithmetic) and sim/hostile/pacer_jitter.hpp
+// (the same arithmetic as a reproducible sim dt schedule). The PROS binding is pinned
+// separately, through the shim, in pros_platform_adapter_test.cpp. What each targets:
+//  * THE LOCK: with the RTOS waking late by a constant or bounded latency, the release
+//    lands on the absolute grid every tick — zero period error, not "about 10 ms".
+//  * THE LEAD: the learned lateness converges on the real one, so the coarse wake lands
+//    BEFORE the target and the spin covers the remainder, within maxTrimUs.
+//  * LATE vs SLIP: under a period late keeps the grid and counts as jitter; a whole period
+//    late re-anchors (no catch-up burst) and stays OUT of the statistics.
+//  * TRIM OFF: maxTrimUs = 0 is a phase-locked millisecond pacer, mean period still exact.
+//  * THE SIM SCHEDULE: seed-deterministic, two draws per call, exact dt without spikes, a
+//    grid-exact MEAN with them.
+
+#include "doctest.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "shulib/core/check.hpp"
+#include "shulib/hal/tick_pll.hpp"
+#include "shulib/sim/hostile/pacer_jitter.hpp"
+#include "shulib/units/quantity.hpp"
+
+using shulib::PreconditionError;
+using shulib::hal::TickPll;
+using shulib::hal::TickPllConfig;
+using shulib::hal::TickPllPlan;
+using shulib::sim::PacedJitterConfig;
+using shulib::sim::PacedJitterSchedule;
+
+namespace {
+/// A virtual loop around a TickPll: a fixed body, then a sleep that wakes `late(i)` µs after
+/// the requested boundary, then an exact spin. Returns each release instant.
+template <typename LateFn>
+std::vector<std::uint64_t> runLoop(TickPll& pll, int ticks, std::uint64_t bodyUs, LateFn late) {
+    std::vector<std::uint64_t> releases;
+    std::uint64_t now = 7'777;  // pacing starts at an arbitrary, unaligned instant
+    for (int i = 0; i < ticks; ++i) {
+        const TickPllPlan plan = pll.plan(now);
+        if (plan.sleep) {
+            if (plan.wakeMs * 1000U > now) {
+                now = plan.wakeMs * 1000U + late(i);
+            }
+            const std::uint64_t woke = now;
+            const std::uint64_t spinTo = pll.onWake(woke);
+            if (now < spinTo) {
+                now = spinTo;
+            }
+            pll.release(now, now - woke);
+        } else {
+            pll.release(now);
+        }
+        releases.push_back(now);
+        now += bodyUs;
+    }
+    return releases;
+}
+}  // namespace
+
+// Bug caught: a pacer whose period drifts with the wake latency or the body, or one that
+// only averages out to 10 ms. Alternating 100/700 µs latency is exactly what makes a
+// millisecond pacer jitter ±300 µs; the PLL must absorb it to the microsecond.
+TEST_CASE("TickPll: alternating RTOS wake latency is trimmed out — every period exact") {
+    TickPll pll;
+    const auto releases =
+        runLoop(pll, 200, 3'000, [](int i) -> std::uint64_t { return i % 2 == 0 ? 100U : 700U; });
+    for (std::size_t i = 1; i < releases.size(); ++i) {
+        CAPTURE(i);
+        CHECK(releases[i] - releases[i - 1] == 10'000U);
+    }
+    CHECK(pll.periods() == 199);
+    CHECK(pll.meanPeriodUs() == 10'000.0);
+    CHECK(pll.jitterRmsUs() == 0.0);
+    CHECK(pll.maxJitterUs() == 0.0);
+    CHECK(pll.lateTicks() == 0);
+    CHECK(pll.slips() == 0);
+    CHECK(pll.leadUs() > 100.0);  // the learned lateness sits inside the script's range
+    CHECK(pll.leadUs() < 700.0);
+    CHECK(pll.trimUs() <= 200U * pll.config().maxTrimUs);
+}
+
+// Bug caught: a lead that never learns (every wake lands past the target and the loop
+// runs late by the latency) or learns the wrong sign.
+TEST_CASE("TickPll: the lead converges on a constant latency and the wake lands early") {
+    TickPll pll;
+    (void)runLoop(pll, 100, 2'000, [](int) -> std::uint64_t { return 400U; });
+    CHECK(pll.leadUs() == doctest::Approx(400.0).epsilon(0.01));
+
+    // After convergence, the coarse wake must land before the target: a positive spin.
+    const std::uint64_t now = pll.targetUs() - 8'000;
+    const TickPllPlan plan = pll.plan(now);
+    REQUIRE(plan.sleep);
+    const std::uint64_t woke = plan.wakeMs * 1000U + 400U;
+    CHECK(woke < pll.targetUs());
+    const std::uint64_t spinTo = pll.onWake(woke);
+    CHECK(spinTo == pll.targetUs());
+    CHECK(spinTo - woke <= pll.config().maxTrimUs);
+}
+
+// Bug caught: (a) a slightly-late tick re-anchoring the grid, which loses phase forever; and
+// (b) a whole-period overrun NOT re-anchoring, so the next ticks fire back-to-back to catch
+// up, exactly ProsTickPacer's R1a hazard. (b)'s long period must not enter the RMS.
+TEST_CASE("TickPll: under a period late keeps the grid; a whole period late re-anchors") {
+    TickPll pll;
+    auto releases = runLoop(pll, 10, 3'000, [](int) -> std::uint64_t { return 0U; });
+    const std::uint64_t grid = pll.targetUs();
+
+    // (a) body finishes 2.5 ms past the target: release now, grid kept.
+    (void)pll.plan(grid + 2'500);
+    pll.release(grid + 2'500);
+    CHECK(pll.lateTicks() == 1);
+    CHECK(pll.slips() == 0);
+    CHECK(pll.targetUs() == grid + 10'000);  // still on the old grid
+    CHECK(pll.lastPeriodUs() == 12'500U);    // …and the long period IS jitter
+    CHECK(pll.maxJitterUs() == 2'500.0);
+
+    // (b) a 3 s pause: re-anchor, no statistics.
+    const std::uint32_t periodsBefore = pll.periods();
+    const std::uint64_t resume = grid + 3'000'000;
+    const TickPllPlan plan = pll.plan(resume);
+    CHECK_FALSE(plan.sleep);
+    pll.release(resume);
+    CHECK(pll.slips() == 1);
+    CHECK(pll.periods() == periodsBefore);
+    CHECK(pll.maxJitterUs() == 2'500.0);
+    CHECK(pll.targetUs() == resume + 10'000);  // one full period after the resume instant
+}
+
+// Bug caught: maxTrimUs = 0 still spinning, or losing the phase lock without the trim —
+// the millisecond pacer must keep an exact mean even though it cannot trim.
+TEST_CASE("TickPll: trim off is a phase-locked millisecond pacer with an exact mean") {
+    TickPllConfig cfg;
+    cfg.maxTrimUs = 0;
+    TickPll pll{cfg};
+    const auto releases = runLoop(pll, 401, 3'000, [](int i) -> std::uint64_t {
+        return 50U + static_cast<std::uint64_t>((i * 37) % 250);
+    });
+    CHECK(pll.trimUs() == 0U);
+    CHECK(pll.jitterRmsUs() > 0.0);         // the latency now shows as jitter…
+    CHECK(pll.maxJitterUs() < 1'000.0);     // …bounded under a millisecond
+    const double span = static_cast<double>(releases.back() - releases[1]);
+    CHECK(span / 399.0 == doctest::Approx(10'000.0).epsilon(1e-4));  // …and the grid holds
+}
+
+// Bug caught: configurations whose arithmetic cannot work, accepted quietly.
+TEST_CASE("TickPll: configuration preconditions are loud") {
+    TickPllConfig shortPeriod;
+    shortPeriod.periodUs = 999;
+    CHECK_THROWS_AS(TickPll{shortPeriod}, PreconditionError);
+    TickPllConfig wideTrim;
+    wideTrim.maxTrimUs = wideTrim.periodUs;
+    CHECK_THROWS_AS(TickPll{wideTrim}, PreconditionError);
+    TickPllConfig badGain;
+    badGain.leadGain = 0.0;
+    CHECK_THROWS_AS(TickPll{badGain}, PreconditionError);
+}
+
+// Bug caught: a sim schedule that is not reproducible from its seed (a latency scenario
+// that cannot be re-run is a flake), or whose first dt is an anchoring artifact.
+TEST_CASE("PacedJitterSchedule: seed-deterministic; exact dt when every wake is on time") {
+    PacedJitterConfig quiet;
+    quiet.spikeProb = 0.0;
+    PacedJitterSchedule a{42, quiet};
+    PacedJitterSchedule b{42, quiet};
+    for (int i = 0; i < 500; ++i) {
+        const double dt = a(i).value();
+        CHECK(dt == b(i).value());
+        CHECK(dt == doctest::Approx(0.010).epsilon(1e-12));
+    }
+    CHECK(a.pll().jitterRmsUs() == 0.0);
+}
+
+// Bug caught: contended wakes drifting the loop slow (the whole point of the grid), or a
+// schedule that shows no jitter at all with spikes on. And the comparison a latency
+// scenario exists to make: the trimmed pacer's jitter is a fraction of the ms pacer's.
+TEST_CASE("PacedJitterSchedule: spikes jitter individual ticks, never the mean") {
+    PacedJitterConfig cfg;
+    cfg.spikeProb = 0.05;
+    PacedJitterSchedule pll{7, cfg};
+    PacedJitterConfig msCfg = cfg;
+    msCfg.pll.maxTrimUs = 0;
+    PacedJitterSchedule ms{7, msCfg};
+
+    double sum = 0.0;
+    double worst = 0.0;
+    constexpr int kTicks = 2000;
+    for (int i = 0; i < kTicks; ++i) {
+        const double dt = pll(i).value();
+        sum += dt;
+        worst = dt > worst ? dt : worst;
+        (void)ms(i);
+    }
+    CHECK(worst > 0.011);  // a spike is visible
+    CHECK(sum / kTicks == doctest::Approx(0.010).epsilon(1e-4));
+    CHECK(pll.pll().jitterRmsUs() < ms.pll().jitterRmsUs());
+}
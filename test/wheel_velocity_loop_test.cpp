@@ -0,0 +1,319 @@
+// Tests for control/wheel_velocity_loop.hpp and its seat in the command pipeline. What each
+// targets:
+//  * THE PASS-THROUGH: disabled, the loop hands back the feedforward BIT-IDENTICALLY — the
+//    property that lets it live inside the one shared pipeline without moving any suite.
+//  * THE LAW: P on the first tick, kI·e·dt after, nothing integrated across a gap.
+//  * ANTI-WINDUP, both halves: the battery band (an integrator never stores undeliverable
+//    volts, never flips sign by saturation) and the desaturation freeze (one starved wheel
+//    stops EVERY integrator, so the wheel ratios hold).
+//  * DAMAGE BOUNDS: a dead encoder costs at most correctionLimit; a NaN costs nothing.
+//  * THE POINT, measured against an honest floor: a mismatched feedforward tracks markedly
+//    better closed, and under PowerHostility's droop plus slip, where the open-loop pipeline
+//    parks short of the goal, every closed-loop run still settles.
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "motion_test_rig.hpp"
+#include "shulib/control/feedforward.hpp"
+#include "shulib/control/wheel_velocity_loop.hpp"
+#include "shulib/core/check.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/hal/fake/fake_telemetry_sink.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/motion/move_to_pose.hpp"
+#include "shulib/sim/hostile/composed.hpp"
+#include "shulib/units/quantity.hpp"
+
+using namespace motion_rig;
+using shulib::PreconditionError;
+using shulib::control::ExitReason;
+using shulib::control::WheelVelocityLoop;
+using shulib::control::WheelVelocityLoopConfig;
+using shulib::hal::fake::FakeClock;
+using shulib::hal::fake::FakeTelemetrySink;
+using shulib::kinematics::xDrive;
+using shulib::math::Angle;
+using shulib::math::Pose2d;
+using shulib::motion::MotionState;
+using shulib::motion::MoveToPose;
+using shulib::units::Velocity;
+using shulib::units::Voltage;
+
+namespace {
+/// Two wheels' worth of loop I/O, so each case reads as the numbers it is about.
+struct Io {
+    std::array<Velocity, 2> target{};
+    std::array<Velocity, 2> measured{};
+    std::array<Voltage, 2> ff{};
+    std::array<Voltage, 2> out{};
+    void run(WheelVelocityLoop& loop, double battery = 12.0) {
+        loop.update(target, measured, ff, Voltage{battery}, out);
+    }
+};
+
+WheelVelocityLoopConfig enabled() {
+    WheelVelocityLoopConfig c;
+    c.enabled = true;
+    return c;
+}
+}  // namespace
+
+// Bug caught: a disabled loop that still perturbs the volts (even by an ulp) — every
+// existing bit-identity suite would move — or one that stops measuring the error.
+TEST_CASE("WheelVelocityLoop: disabled is a bit-identical pass-through that still measures") {
+    FakeClock clock;
+    WheelVelocityLoop loop{WheelVelocityLoopConfig{}, clock};
+    Io io;
+    io.target = {Velocity{30.0}, Velocity{-12.5}};
+    io.measured = {Velocity{20.0}, Velocity{-10.0}};
+    io.ff = {Voltage{6.3}, Voltage{-3.0000000000000004}};
+    for (int i = 0; i < 5; ++i) {
+        io.run(loop);
+        clock.advance(Time{0.01});
+        CHECK(io.out[0].value() == io.ff[0].value());
+        CHECK(io.out[1].value() == io.ff[1].value());
+    }
+    CHECK(loop.trackingError(0).value() == 10.0);
+    CHECK(loop.trackingError(1).value() == -2.5);
+    CHECK(loop.integral(0).value() == 0.0);
+}
+
+// Bug caught: integrating on the first tick (dt from the epoch), or across a gap — the
+// facade's drive() resuming after a 3 s blocking motion would dump kI·e·3 V in one tick.
+TEST_CASE("WheelVelocityLoop: P on the first tick, kI·e·dt after, nothing across a gap") {
+    FakeClock clock;
+    WheelVelocityLoop loop{enabled(), clock};
+    Io io;
+    io.target = {Velocity{40.0}, Velocity{40.0}};
+    io.measured = {Velocity{30.0}, Velocity{40.0}};
+    io.ff = {Voltage{8.0}, Voltage{8.0}};
+
+    io.run(loop);
+    CHECK(io.out[0].value() == doctest::Approx(8.0 + 0.05 * 10.0));  // P only
+    CHECK(io.out[1].value() == 8.0);
+    CHECK(loop.integral(0).value() == 0.0);
+
+    clock.advance(Time{0.01});
+    io.run(loop);
+    CHECK(loop.integral(0).value() == doctest::Approx(1.0 * 10.0 * 0.01));
+    CHECK(io.out[0].value() == doctest::Approx(8.0 + 0.5 + 0.1));
+
+    clock.advance(Time{3.0});  // a gap
+    io.run(loop);
+    CHECK(loop.integral(0).value() == doctest::Approx(0.1));  // unchanged
+
+    loop.reset();
+    CHECK(loop.integral(0).value() == 0.0);
+    CHECK(loop.trackingError(0).value() == 0.0);
+}
+
+// Bug caught: an integrator that keeps charging while the pack cannot deliver — on recovery
+// it overshoots by everything it stored. The band must clamp it, and contain 0.
+TEST_CASE("WheelVelocityLoop: the integrator is back-calculated into the battery band") {
+    FakeClock clock;
+    WheelVelocityLoop loop{enabled(), clock};
+    Io io;
+    io.target = {Velocity{60.0}, Velocity{0.0}};
+    io.measured = {Velocity{40.0}, Velocity{0.0}};
+    io.ff = {Voltage{10.5}, Voltage{0.0}};
+    for (int i = 0; i < 200; ++i) {
+        io.run(loop, 11.0);
+        clock.advance(Time{0.01});
+    }
+    // ff + P already reach 11.5 V > 11 V: the band's top is max(0, 11 − 10.5 − 1.0) = 0.
+    CHECK(loop.integral(0).value() == 0.0);
+    CHECK(loop.saturated());
+
+    // An integrator that charged BEFORE saturation is shrunk to the band, not flipped.
+    WheelVelocityLoop loop2{enabled(), clock};
+    io.ff = {Voltage{6.0}, Voltage{0.0}};
+    for (int i = 0; i < 100; ++i) {
+        io.run(loop2, 12.0);
+        clock.advance(Time{0.01});
+    }
+    REQUIRE(loop2.integral(0).value() > 2.0);
+    io.ff = {Voltage{11.5}, Voltage{0.0}};
+    io.run(loop2, 12.0);
+    CHECK(loop2.integral(0).value() == 0.0);  // 12 − 11.5 − 1.0 < 0 ⇒ the band top is 0
+    CHECK(io.out[0].value() == doctest::Approx(12.5));  // P rides over; the pipeline clamps
+}
+
+// Bug caught: one starved wheel's neighbours integrating on — the wheel-speed RATIOS skew
+// and the robot curves. Any saturation must freeze every wheel's integrator.
+TEST_CASE("WheelVelocityLoop: one wheel at the ceiling freezes every integrator (desaturation)") {
+    FakeClock clock;
+    WheelVelocityLoop loop{enabled(), clock};
+    Io io;
+    io.target = {Velocity{60.0}, Velocity{30.0}};
+    io.measured = {Velocity{50.0}, Velocity{25.0}};
+    io.ff = {Voltage{11.9}, Voltage{6.0}};
+    io.run(loop);
+    clock.advance(Time{0.01});
+    io.run(loop);
+    CHECK(loop.saturated());
+    CHECK(loop.integral(1).value() == 0.0);  // wheel 1 had headroom and still froze
+
+    io.ff = {Voltage{9.0}, Voltage{6.0}};  // the ceiling releases
+    clock.advance(Time{0.01});
+    io.run(loop);
+    CHECK_FALSE(loop.saturated());
+    CHECK(loop.integral(1).value() == doctest::Approx(5.0 * 0.01));
+}
+
+// Bug caught: a dead encoder (reads 0 forever) winding the wheel to the rail; a NaN read
+// poisoning the integrator for the rest of the run.
+TEST_CASE("WheelVelocityLoop: a dead encoder costs at most correctionLimit; a NaN costs nothing") {
+    FakeClock clock;
+    WheelVelocityLoop loop{enabled(), clock};
+    Io io;
+    io.target = {Velocity{40.0}, Velocity{40.0}};
+    io.measured = {Velocity{0.0}, Velocity{std::numeric_limits<double>::quiet_NaN()}};
+    io.ff = {Voltage{7.0}, Voltage{7.0}};
+    for (int i = 0; i < 500; ++i) {
+        io.run(loop);
+        clock.advance(Time{0.01});
+    }
+    CHECK(io.out[0].value() == doctest::Approx(7.0 + 3.0));  // ff + correctionLimit
+    CHECK(io.out[1].value() == 7.0);                         // feedforward alone
+    CHECK(loop.integral(1).value() == 0.0);
+    CHECK(loop.trackingError(1).value() == 0.0);
+}
+
+// Bug caught: gains or limits that cannot work, accepted quietly.
+TEST_CASE("WheelVelocityLoop: configuration and span preconditions are loud") {
+    FakeClock clock;
+    WheelVelocityLoopConfig neg = enabled();
+    neg.kI = -1.0;
+    CHECK_THROWS_AS((WheelVelocityLoop{neg, clock}), PreconditionError);
+    WheelVelocityLoopConfig nan = enabled();
+    nan.kP = std::numeric_limits<double>::quiet_NaN();
+    CHECK_THROWS_AS((WheelVelocityLoop{nan, clock}), PreconditionError);
+    WheelVelocityLoopConfig lim = enabled();
+    lim.correctionLimit = Voltage{-1.0};
+    CHECK_THROWS_AS((WheelVelocityLoop{lim, clock}), PreconditionError);
+
+    WheelVelocityLoop loop{enabled(), clock};
+    std::array<Velocity, 2> two{};
+    std::array<Velocity, 1> one{};
+    std::array<Voltage, 2> ff{};
+    std::array<Voltage, 2> out{};
+    CHECK_THROWS_AS(loop.update(two, one, ff, Voltage{12.0}, out), PreconditionError);
+
+    auto cfg = motionConfig();
+    cfg.wheelLoop.kP = -0.1;
+    CHECK_THROWS_AS(cfg.validate(), PreconditionError);
+}
+
+namespace {
+struct TrackingResult {
+    double rmsError = 0.0;  ///< RMS wheel-speed tracking error over Running records (in/s)
+    double posMiss = 0.0;   ///< |truth − target| at exit (in)
+    ExitReason reason = ExitReason::Running;
+};
+
+/// The hostile world every closed-loop case drives in: PowerHostility with its first thermal
+/// step pulled down to just above ambient (so a short motion reaches it) composed with launch
+/// slip. Owns its models, so one instance is one run.
+struct HostileWorld {
+    shulib::sim::PowerHostileModel power{[] {
+        shulib::sim::PowerHostileConfig pc;
+        pc.throttleTempC = 25.5;
+        pc.heatRatePerV2 = 0.01;
+        return pc;
+    }()};
+    shulib::sim::SlipHostileModel slip{};
+    shulib::sim::ChainedDegradation chain{{&power, &slip}};
+};
+
+/// One MoveToPose in a fresh HostileWorld, with the plant's kV scaled by `plantKvScale` (a
+/// drive whose feedforward no longer matches it), graded on the loop's own per-wheel record.
+TrackingResult runTracking(bool loopOn, double plantKvScale, const Pose2d& target) {
+    const auto kin = xDrive(Length{7.0});
+    auto pcfg = plantConfig();
+    pcfg.plant.wheelFf.kV *= plantKvScale;
+    FakeTelemetrySink sink;
+    HostileWorld world;
+    MotionRig rig{kin, pcfg, &sink, &world.chain};
+    auto mcfg = motionConfig();
+    mcfg.wheelLoop.enabled = loopOn;
+    MoveToPose m{rig.deps, target, mcfg, 8.0};
+    TrackingResult out;
+    out.reason = rig.run(m, 1000);
+    double sumSq = 0.0;
+    int n = 0;
+    for (int i = 0; i < sink.recordCount(); ++i) {
+        const auto& r = sink.recordAt(i);
+        if (r.activeCommandState != static_cast<std::uint8_t>(MotionState::Running)) {
+            continue;  // the plant's own records share the sink; they carry no tracking error
+        }
+        for (int w = 0; w < r.wheelCount; ++w) {
+            const double e = r.wheelSpeedError[static_cast<std::size_t>(w)].value();
+            REQUIRE(std::isfinite(e));
+            sumSq += e * e;
+            ++n;
+        }
+    }
+    REQUIRE(n > 0);
+    out.rmsError = std::sqrt(sumSq / n);
+    out.posMiss = posErr(rig.h.truePose(), target);
+    return out;
+}
+}  // namespace
+
+// Bug caught: an inner loop that does not close. A straight drive keeps the wheels near one
+// speed long enough for a feedforward mismatch to show as a steady error. The floor here is
+// NOT zero: kA = 0 makes the measured speed the previous tick's command, so a changing
+// target always shows a one-tick lag no loop can remove (≈ 3 in/s RMS on this profile with a
+// matched feedforward). Against a 25%-heavy and a 20%-light drive the loop must cut the RMS
+// by a quarter; with nothing to fix it must not add more than a tenth.
+TEST_CASE("WheelVelocityLoop: a mismatched feedforward tracks markedly better closed") {
+    const Pose2d target{Length{36.0}, Length{0.0}, Angle{}};
+    for (const double kvScale : {1.25, 0.8}) {
+        CAPTURE(kvScale);
+        const TrackingResult open = runTracking(false, kvScale, target);
+        const TrackingResult closed = runTracking(true, kvScale, target);
+        MESSAGE("kV×" << kvScale << " rms open " << open.rmsError << " closed " << closed.rmsError
+                      << " in/s");
+        CHECK(closed.reason == ExitReason::Settled);
+        CHECK(closed.rmsError < 0.75 * open.rmsError);
+    }
+    const TrackingResult open = runTracking(false, 1.0, target);
+    const TrackingResult closed = runTracking(true, 1.0, target);
+    CHECK(closed.rmsError < 1.1 * open.rmsError);
+}
+
+// Bug caught: a loop that helps the wheels but destabilizes the outer loops, or one that
+// does not reach the failure it exists for. Under droop and sag, kS alone no longer breaks
+// static friction near the goal: the open-loop pipeline parks short of the target and times
+// out, while the integrator supplies the missing volts. Swept over targets and over a
+// matched, a heavy and a light drive: every closed-loop run must settle close, and the
+// worst closed-loop miss must beat the worst open-loop miss.
+TEST_CASE("WheelVelocityLoop: hostile sweep — power droop + slip: every closed run settles") {
+    const Pose2d targets[] = {Pose2d{Length{36.0}, Length{0.0}, Angle{}},
+                              Pose2d{Length{20.0}, Length{-24.0}, Angle::degrees(60.0)},
+                              Pose2d{Length{-18.0}, Length{30.0}, Angle::degrees(-120.0)}};
+    double worstOpen = 0.0;
+    double worstClosed = 0.0;
+    for (const double kvScale : {1.0, 1.25, 0.8}) {
+        for (const Pose2d& target : targets) {
+            CAPTURE(kvScale);
+            CAPTURE(target.x().value());
+            const TrackingResult open = runTracking(false, kvScale, target);
+            const TrackingResult closed = runTracking(true, kvScale, target);
+            CHECK(closed.reason == ExitReason::Settled);
+            CHECK(closed.posMiss < 0.5);
+            worstOpen = std::max(worstOpen, open.posMiss);
+            worstClosed = std::max(worstClosed, closed.posMiss);
+        }
+    }
+    MESSAGE("hostile worst miss: open " << worstOpen << " in, closed " << worstClosed << " in");
+    CHECK(worstClosed < worstOpen);
+}
@@ -0,0 +1,60 @@
+// Tests for diag/zone_profiler.hpp in its DEFAULT (competition) configuration. The suite
+// defines SHULIB_ENABLE_ZONES for every TU (test/CMakeLists.txt), so this one #undefs it
+// before its first include — and includes NOTHING that uses SHULIB_ZONE inside an inline
+// function (Localizer, MotionScheduler), which would give that function two definitions
+// across the binary. What this targets:
+//  * THE ZERO-COST PROOF: a stripped zone evaluates neither argument, reads no clock, and
+//    records nothing.
+//  * Arguments remain TYPE-CHECKED (and the name validated) in the stripped form — this
+//    file compiling is that proof.
+// The enabled counterpart lives in zone_profiler_test.cpp.
+
+#undef SHULIB_ENABLE_ZONES
+#include "doctest.h"
+
+#include "shulib/diag/zone_profiler.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/units/quantity.hpp"
+
+using shulib::diag::ZoneProfiler;
+using shulib::units::Time;
+
+namespace {
+
+/// Counts its reads, so a stripped zone that touched the clock would show.
+class CountingClock final : public shulib::hal::IClock {
+public:
+    [[nodiscard]] Time now() const override {
+        ++reads;
+        return Time{0.0};
+    }
+    mutable int reads = 0;
+};
+
+int g_profilerLookups = 0;
+ZoneProfiler* lookupProfiler(ZoneProfiler& p) {
+    ++g_profilerLookups;  // stands in for any side effect in the argument
+    return &p;
+}
+
+}  // namespace
+
+TEST_CASE("SHULIB_ZONE (stripped): no object, no clock read, no argument evaluated") {
+    CountingClock clock;
+    ZoneProfiler prof{clock};
+    g_profilerLookups = 0;
+    {
+        SHULIB_ZONE(lookupProfiler(prof), "loc");
+        SHULIB_ZONE_DYNAMIC(lookupProfiler(prof), "dynamic");
+    }
+    CHECK(g_profilerLookups == 0);
+    CHECK(clock.reads == 0);
+    CHECK(prof.zoneCount() == 0);
+
+    // The profiler itself still works when used directly (it is the macro that strips).
+    {
+        const ZoneProfiler::Scope direct{&prof, shulib::diag::zoneId("direct"), "direct"};
+    }
+    CHECK(prof.zoneCount() == 1);
+    CHECK(clock.reads == 2);
+}
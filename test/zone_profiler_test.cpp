@@ -0,0 +1,272 @@
+// Tests for diag/zone_profiler.hpp in the DEV configuration (the suite defines
+// SHULIB_ENABLE_ZONES for every TU — test/CMakeLists.txt says why). What each targets:
+//  * THE TREE: nested zones land under their parent, a repeated zone accumulates, the same
+//    name under two parents is two rows, and self time is total minus the children.
+//  * THE HISTOGRAM: p50/p99 are slot upper edges clamped to the exact max.
+//  * THE LIMITS: a zone past kMaxZoneDepth, a new path with the table full, and everything
+//    nested under either is refused and counted, never charged to a neighbour.
+//  * IN THE LOOP: MotionScheduler's "loc"/"mot" zones and the Localizer's own nest as one
+//    tree, RunReporter copies it into the summary, and TermSink renders it.
+// The stripped counterpart lives in zone_profiler_strip_test.cpp.
+
+#include "doctest.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "motion_test_rig.hpp"
+#include "shulib/core/check.hpp"
+#include "shulib/diag/run_summary.hpp"
+#include "shulib/diag/term_sink.hpp"
+#include "shulib/diag/zone_profiler.hpp"
+#include "shulib/hal/clock.hpp"
+#include "shulib/hal/fake/fake_char_sink.hpp"
+#include "shulib/hal/fake/fake_clock.hpp"
+#include "shulib/hal/fake/fake_telemetry_sink.hpp"
+#include "shulib/kinematics/x_drive.hpp"
+#include "shulib/motion/motion_scheduler.hpp"
+#include "shulib/motion/move_to_pose.hpp"
+#include "shulib/motion/run_reporter.hpp"
+#include "shulib/units/quantity.hpp"
+
+using namespace motion_rig;
+using shulib::PreconditionError;
+using shulib::diag::kMaxZoneDepth;
+using shulib::diag::kMaxZones;
+using shulib::diag::RunSummary;
+using shulib::diag::TermSink;
+using shulib::diag::ZoneProfiler;
+using shulib::diag::ZoneTimingRow;
+using shulib::hal::fake::FakeCharSink;
+using shulib::hal::fake::FakeClock;
+using shulib::hal::fake::FakeTelemetrySink;
+using shulib::kinematics::xDrive;
+using shulib::math::Angle;
+using shulib::math::Pose2d;
+using shulib::motion::MotionScheduler;
+using shulib::motion::MotionSchedulerConfig;
+using shulib::motion::MoveToPose;
+using shulib::motion::RunReporter;
+using shulib::units::Length;
+using shulib::units::Time;
+
+namespace {
+
+/// A clock that advances by a fixed quantum on EVERY read — time that passes during a tick,
+/// which is what a zone measures (the run_report_e2e_test clock).
+class AutoAdvanceClock final : public shulib::hal::IClock {
+public:
+    explicit AutoAdvanceClock(double quantum) noexcept : quantum_{quantum} {}
+    [[nodiscard]] Time now() const override {
+        const double t = t_;
+        t_ += quantum_;
+        return Time{t};
+    }
+
+private:
+    double quantum_;
+    mutable double t_ = 0.0;
+};
+
+/// `n` seconds of work inside whatever zone is open.
+void work(FakeClock& clock, double n) { clock.advance(Time{n}); }
+
+/// The zone reached by `path` from the root; fails the test if there is none.
+const ZoneProfiler::Zone& at(const ZoneProfiler& p, std::initializer_list<std::string_view> path) {
+    const std::array<std::string_view, 4> steps = [&] {
+        std::array<std::string_view, 4> a{};
+        std::size_t i = 0;
+        for (const std::string_view s : path) {
+            a[i++] = s;
+        }
+        return a;
+    }();
+    const ZoneProfiler::Zone* z = p.find(std::span{steps.data(), path.size()});
+    REQUIRE(z != nullptr);
+    return *z;
+}
+
+}  // namespace
+
+// Would catch: a child charged to the wrong parent, self time that forgets the children (or
+// double-subtracts them), repeated calls that replace instead of accumulate, one row shared
+// by the same name under two parents, or a snapshot that is not depth-first.
+TEST_CASE("ZoneProfiler: nested zones form a tree with calls, total, self and max") {
+    FakeClock clock;
+    ZoneProfiler prof{clock};
+    for (int tick = 0; tick < 3; ++tick) {
+        SHULIB_ZONE(&prof, "loc");
+        work(clock, 0.0001);
+        {
+            SHULIB_ZONE(&prof, "odom");
+            work(clock, 0.0002);
+        }
+        {
+            SHULIB_ZONE(&prof, "fuse");
+            work(clock, tick == 2 ? 0.0030 : 0.0003);
+        }
+        {
+            SHULIB_ZONE(&prof, "odom");  // a second entry in one tick accumulates
+            work(clock, 0.0002);
+        }
+    }
+    {
+        SHULIB_ZONE(&prof, "mot");
+        SHULIB_ZONE(&prof, "fuse");  // same name, different parent: its own row
+        work(clock, 0.0005);
+    }
+    CHECK(prof.openDepth() == 0);
+    CHECK(prof.zoneCount() == 5);
+    CHECK(prof.refusedScopes() == 0);
+
+    const auto& loc = at(prof, {"loc"});
+    CHECK(loc.calls == 3);
+    CHECK(loc.total == doctest::Approx(3 * 0.0008 + 0.0027));
+    CHECK(loc.total - loc.inChildren == doctest::Approx(3 * 0.0001));
+    CHECK(at(prof, {"loc", "odom"}).calls == 6);
+    CHECK(at(prof, {"loc", "odom"}).depth == 1);
+    CHECK(at(prof, {"loc", "fuse"}).max == doctest::Approx(0.0030));
+    CHECK(at(prof, {"mot", "fuse"}).calls == 1);
+    CHECK(prof.find(std::array<std::string_view, 1>{"odom"}) == nullptr);  // never a root
+
+    std::array<ZoneTimingRow, kMaxZones> rows{};
+    REQUIRE(prof.snapshot(rows) == 5);
+    CHECK(rows[0].nameView() == "loc");
+    CHECK(rows[1].nameView() == "odom");
+    CHECK(rows[2].nameView() == "fuse");
+    CHECK(rows[3].nameView() == "mot");
+    CHECK(rows[4].nameView() == "fuse");
+    CHECK(rows[4].depth == 1);
+    CHECK(rows[0].self.value() == doctest::Approx(0.0003));
+    CHECK(rows[1].self.value() == doctest::Approx(rows[1].total.value()));  // a leaf
+
+    // Percentiles: odom's six 200 µs calls share the [128, 256) µs slot, so both read
+    // its upper edge clamped to the max; fuse's 3 ms outlier is its p99, exactly.
+    CHECK(rows[1].p50.value() == doctest::Approx(0.0002));
+    CHECK(rows[1].p99.value() == doctest::Approx(0.0002));
+    CHECK(rows[2].p50.value() == doctest::Approx(0.000512));
+    CHECK(rows[2].p99.value() == doctest::Approx(0.0030));
+
+    // A snapshot into fewer rows stops at the capacity, parents first.
+    std::array<ZoneTimingRow, 2> two{};
+    CHECK(prof.snapshot(two) == 2);
+    CHECK(two[1].nameView() == "odom");
+
+    prof.reset();
+    CHECK(prof.zoneCount() == 0);
+}
+
+// Would catch: a too-deep zone silently charged to its parent, a full table merging a new
+// zone into an existing row, a child of a refused zone attaching to its grandparent, or a
+// refused scope that still pops the stack on exit (which would corrupt the tree after it).
+TEST_CASE("ZoneProfiler: zones past the depth or the table are refused and counted") {
+    FakeClock clock;
+    ZoneProfiler prof{clock};
+
+    SUBCASE("depth") {
+        const auto nest = [&](auto& self, std::size_t level) -> void {
+            SHULIB_ZONE(&prof, "lvl");
+            work(clock, 0.0001);
+            if (level + 1 < kMaxZoneDepth + 2) {
+                self(self, level + 1);
+            }
+        };
+        nest(nest, 0);
+        CHECK(prof.zoneCount() == kMaxZoneDepth);
+        CHECK(prof.refusedScopes() == 2);
+        CHECK(prof.openDepth() == 0);
+    }
+
+    SUBCASE("table") {
+        // kMaxZones distinct roots fill the table (a hashed runtime name per root).
+        std::array<std::string, kMaxZones + 1> names;
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            // snprintf, not "z" + std::to_string(i): GCC 12 at -O2 misreads that inlined
+            // concatenation as an overlapping memcpy (-Werror=restrict).
+            char name[24];  // "z" + 20 digits + NUL
+            std::snprintf(name, sizeof name, "z%zu", i);
+            names[i] = name;
+        }
+        for (std::size_t i = 0; i < kMaxZones; ++i) {
+            SHULIB_ZONE_DYNAMIC(&prof, names[i].c_str());
+            work(clock, 0.0001);
+        }
+        CHECK(prof.zoneCount() == kMaxZones);
+        {
+            SHULIB_ZONE_DYNAMIC(&prof, names[kMaxZones].c_str());  // no room: refused...
+            SHULIB_ZONE(&prof, "child");                            // ...and so is this
+            work(clock, 0.0001);
+        }
+        CHECK(prof.refusedScopes() == 2);
+        {
+            SHULIB_ZONE_DYNAMIC(&prof, names[0].c_str());  // an existing path still works
+            work(clock, 0.0001);
+        }
+        CHECK(prof.zone(0).calls == 2);
+        CHECK(prof.openDepth() == 0);
+    }
+
+    SUBCASE("a null profiler is inert, and reset() refuses an open zone") {
+        {
+            SHULIB_ZONE(static_cast<ZoneProfiler*>(nullptr), "off");
+            work(clock, 0.0001);
+        }
+        CHECK(prof.zoneCount() == 0);
+        SHULIB_ZONE(&prof, "open");
+        CHECK_THROWS_AS(prof.reset(), PreconditionError);
+    }
+}
+
+// Would catch: the scheduler's zones not bracketing the same work as its phases, the
+// Localizer's zones not nesting under "loc", RunReporter leaving the table out of the
+// summary, or TermSink dropping it.
+TEST_CASE("ZoneProfiler in the loop: scheduler and Localizer zones reach the summary") {
+    const auto kin = xDrive(Length{7.0});
+    AutoAdvanceClock profClock{0.00001};  // 10 µs per now()
+    ZoneProfiler prof{profClock};
+    MotionSchedulerConfig cfg;
+    cfg.profiler = &prof;
+    SchedulerRig s{kin, plantConfig(), nullptr, nullptr, cfg};
+    s.rig.loc.setProfiler(&prof);
+    REQUIRE(s.sched.profiler() == &prof);
+
+    FakeTelemetrySink out;
+    RunReporter reporter{out, s.sched};
+    MoveToPose m{s.sched.deps(), Pose2d{Length{12.0}, Length{6.0}, Angle::degrees(0.0)},
+                 motionConfig(), 4.0};
+    (void)s.run(m);
+    reporter.finishRun();
+
+    // Every tick entered "loc" once and "mot" once. Each zone reads the clock once on entry
+    // and once on exit, so "loc" spans seven quanta, three of them inside its children.
+    const auto& loc = at(prof, {"loc"});
+    CHECK(loc.calls > 50);
+    CHECK(at(prof, {"mot"}).calls == loc.calls);
+    CHECK(at(prof, {"loc", "odom"}).calls == loc.calls);
+    CHECK(at(prof, {"loc", "fuse"}).calls == loc.calls);
+    CHECK(at(prof, {"loc", "correct"}).calls > 0);  // entered whenever the fold is open
+    CHECK(loc.total - loc.inChildren
+          == doctest::Approx(0.00004 * static_cast<double>(loc.calls)));
+
+    REQUIRE(out.summaryCount() == 1);
+    const RunSummary& sum = out.lastSummary();
+    REQUIRE(sum.hasZoneData());
+    REQUIRE(sum.zoneCount == 5);
+    CHECK(sum.zones[0].nameView() == "loc");
+    CHECK(sum.zones[1].nameView() == "odom");
+    CHECK(sum.zones[1].depth == 1);
+    CHECK(sum.zones[4].nameView() == "mot");
+    CHECK(sum.zones[0].calls == loc.calls);
+
+    FakeCharSink chars;
+    FakeClock termClock;
+    TermSink term{termClock, chars};
+    term.summarize(sum);
+    const std::string& text = chars.text();
+    CHECK(text.find(" zone loc                 n ") != std::string::npos);
+    CHECK(text.find(" zone   odom              n ") != std::string::npos);
+    CHECK(text.find("zones refused") == std::string::npos);  // none refused: no line
+}
@@ -0,0 +1,192 @@
+// shulib_bbx — index, seek into and export blackbox files on the host
+// (sim/blackbox_index.hpp).
+//
+//     shulib_bbx <file.bbx>... [--seek-time T] [--seek-command ID] [--csv DIR]
+//                [--columnar DIR]
+//
+// Maps and indexes every file named — a weekend's runs in one call — and prints one
+// line per file: format, ticks, time span, commands, and anything the index could not
+// account for (a truncated tail, unresolved compact ticks). --seek-time and
+// --seek-command print the tick each file's index lands on. --csv and --columnar write
+// each file's tick columns as DIR/<stem>.csv or DIR/<stem>.col (ColumnarView reads the
+// latter in place). The last line is the throughput over all files: bytes indexed, and
+// the index, gather and export rates. Exit status: 0 when every file indexed, 1 when any
+// was refused by the reader, 2 for a usage, open or write error.
+//
+// Host-only, like everything it includes.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "shulib/diag/blackbox_reader.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/diag/fault.hpp"
+#include "shulib/sim/blackbox_index.hpp"
+#include "shulib/units/quantity.hpp"
+
+namespace {
+
+int usage() {
+    std::fprintf(stderr,
+                 "usage: shulib_bbx <file.bbx>... [--seek-time T] [--seek-command ID] "
+                 "[--csv DIR] [--columnar DIR]\n");
+    return 2;
+}
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double>(to - from).count();
+}
+
+/// `n` bytes over `s` seconds in MB/s, or 0 when nothing was timed.
+double mbPerS(double n, double s) { return s > 0.0 ? n / 1e6 / s : 0.0; }
+
+void printTick(const shulib::sim::BlackboxIndex& index, std::size_t i, const char* what) {
+    shulib::diag::DebugRecord r;
+    if (i == shulib::sim::BlackboxIndex::npos || !index.readTick(i, r)) {
+        std::printf("    %s: no such tick\n", what);
+        return;
+    }
+    std::printf("    %s: tick %zu  t=%.3f  cmd=%u  pose=(%.2f, %.2f, %.1f deg)  fault=%s\n", what,
+                i, r.t.value(), r.activeCommandId, r.measuredPose.x().value(),
+                r.measuredPose.y().value(), r.measuredPose.heading().degrees(),
+                shulib::diag::faultCodeName(r.fault));
+}
+
+bool exportColumns(const std::string& path, const shulib::sim::TickColumns& cols, bool csv) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    const bool ok = csv ? shulib::sim::writeCsv(f, cols) : shulib::sim::writeColumnar(f, cols);
+    return std::fclose(f) == 0 && ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<const char*> files;
+    const char* csvDir = nullptr;
+    const char* columnarDir = nullptr;
+    bool seekTime = false;
+    bool seekCommand = false;
+    double seekT = 0.0;
+    unsigned long seekId = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        char* end = nullptr;
+        if (arg == "--seek-time" && i + 1 < argc) {
+            seekT = std::strtod(argv[++i], &end);
+            if (*end != '\0') {
+                return usage();
+            }
+            seekTime = true;
+        } else if (arg == "--seek-command" && i + 1 < argc) {
+            seekId = std::strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || seekId > UINT32_MAX) {
+                return usage();
+            }
+            seekCommand = true;
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csvDir = argv[++i];
+        } else if (arg == "--columnar" && i + 1 < argc) {
+            columnarDir = argv[++i];
+        } else if (arg.starts_with("--")) {
+            return usage();
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.empty()) {
+        return usage();
+    }
+
+    const bool gather = csvDir != nullptr || columnarDir != nullptr;
+    double bytes = 0.0;
+    double indexS = 0.0;
+    double gatherS = 0.0;
+    double exportS = 0.0;
+    std::size_t ticks = 0;
+    bool allOk = true;
+    for (const char* path : files) {
+        const shulib::sim::MappedFile mapped{path};
+        if (!mapped.ok()) {
+            std::fprintf(stderr, "cannot open %s\n", path);
+            return 2;
+        }
+        const Clock::time_point t0 = Clock::now();
+        const shulib::sim::BlackboxIndex index{mapped.bytes()};
+        const Clock::time_point t1 = Clock::now();
+        bytes += static_cast<double>(mapped.bytes().size());
+        indexS += seconds(t0, t1);
+        if (index.status() != shulib::diag::blackbox::ReadStatus::Ok) {
+            std::printf("%s: %s\n", path, shulib::diag::blackbox::readStatusName(index.status()));
+            allOk = false;
+            continue;
+        }
+        ticks += index.size();
+
+        std::vector<std::uint32_t> ids;
+        for (const shulib::sim::TickIndexEntry& e : index.entries()) {
+            if (e.commandId != 0U) {
+                ids.push_back(e.commandId);
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        const auto commands =
+            static_cast<std::size_t>(std::unique(ids.begin(), ids.end()) - ids.begin());
+        const std::span<const shulib::sim::TickIndexEntry> entries = index.entries();
+        const double span = entries.empty() ? 0.0 : entries.back().t - entries.front().t;
+        std::printf("%s: %s, %zu tick(s) over %.2f s, %zu command(s)%s%s%s\n", path,
+                    index.compact() ? "v2" : "v1", index.size(), span, commands,
+                    index.timeOrdered() ? "" : ", not time-ordered",
+                    index.truncated() ? ", TRUNCATED" : "",
+                    index.unresolvedTicks() != 0U ? ", unresolved compact ticks" : "");
+        if (seekTime) {
+            printTick(index, index.seekTime(shulib::units::Time{seekT}), "--seek-time");
+        }
+        if (seekCommand) {
+            printTick(index, index.seekCommand(static_cast<std::uint32_t>(seekId)),
+                      "--seek-command");
+        }
+        if (!gather) {
+            continue;
+        }
+
+        const Clock::time_point t2 = Clock::now();
+        const shulib::sim::TickColumns cols = shulib::sim::gatherColumns(index);
+        const Clock::time_point t3 = Clock::now();
+        gatherS += seconds(t2, t3);
+        const std::string stem = std::filesystem::path{path}.stem().string();
+        for (const auto& [dir, csv] : {std::pair{csvDir, true}, std::pair{columnarDir, false}}) {
+            if (dir == nullptr) {
+                continue;
+            }
+            const std::string out = std::string{dir} + "/" + stem + (csv ? ".csv" : ".col");
+            if (!exportColumns(out, cols, csv)) {
+                std::fprintf(stderr, "cannot write %s\n", out.c_str());
+                return 2;
+            }
+        }
+        exportS += seconds(t3, Clock::now());
+    }
+
+    std::printf("%zu file(s), %.1f MB, %zu tick(s): index %.0f MB/s", files.size(), bytes / 1e6,
+                ticks, mbPerS(bytes, indexS));
+    if (gather) {
+        std::printf(", gather %.0f MB/s, export %.0f MB/s", mbPerS(bytes, gatherS),
+                    mbPerS(bytes, exportS));
+    }
+    std::printf("\n");
+    return allOk ? 0 : 1;
+}
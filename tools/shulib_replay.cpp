@@ -0,0 +1,120 @@
+// shulib_replay — re-run the estimator over one blackbox file (sim/estimator_replay.hpp)
+// under a grid of configurations (sim/replay_grid.hpp) and print the error table.
+//
+//     shulib_replay <file.bbx> [<grid file>] [--threads N]
+//
+// Loads the file's replayable ticks — a file recorded with
+// SdSinkConfig::recordEstimatorInputs, as shulib_sim --blackbox writes them — expands the
+// grid, runs replayGrid() across N threads (0 or absent: every core), and prints one row
+// per configuration: RMS, worst and final position error against the recorded pose, RMS
+// heading error, and the corrector's accepted/rejected ticks. No grid file replays the
+// defaults alone. Exit status: 0 after a table, 2 for a usage, file, parse or replay error
+// (a file with no replayable ticks included).
+//
+// Host-only, like everything it includes.
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shulib/diag/blackbox_reader.hpp"
+#include "shulib/diag/debug_record.hpp"
+#include "shulib/sim/estimator_replay.hpp"
+#include "shulib/sim/replay_grid.hpp"
+
+namespace {
+
+int usage() {
+    std::fprintf(stderr, "usage: shulib_replay <file.bbx> [<grid file>] [--threads N]\n");
+    return 2;
+}
+
+bool parseCount(const char* text, unsigned long long& out) {
+    char* end = nullptr;
+    out = std::strtoull(text, &end, 10);
+    return end != text && *end == '\0';
+}
+
+bool readFile(const char* path, std::vector<std::byte>& out) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (f == nullptr) {
+        return false;
+    }
+    char buf[65536];
+    for (std::size_t n = std::fread(buf, 1, sizeof buf, f); n > 0;
+         n = std::fread(buf, 1, sizeof buf, f)) {
+        const auto* bytes = reinterpret_cast<const std::byte*>(buf);
+        out.insert(out.end(), bytes, bytes + n);
+    }
+    const bool ok = std::ferror(f) == 0;
+    std::fclose(f);
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return usage();
+    }
+    const char* gridPath = nullptr;
+    unsigned threads = 0;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        unsigned long long n = 0;
+        if (arg == "--threads" && i + 1 < argc && parseCount(argv[i + 1], n)) {
+            threads = static_cast<unsigned>(n);
+            ++i;
+        } else if (gridPath == nullptr && !arg.starts_with("--")) {
+            gridPath = argv[i];
+        } else {
+            return usage();
+        }
+    }
+
+    shulib::sim::ReplayGrid grid;
+    if (gridPath != nullptr) {
+        shulib::sim::ReplayGridParseResult parsed = shulib::sim::loadReplayGridFile(gridPath);
+        if (!parsed.ok()) {
+            std::fprintf(stderr, "%s:%d: %s\n", gridPath, parsed.line, parsed.error.c_str());
+            return 2;
+        }
+        grid = std::move(parsed.grid);
+    } else {
+        grid.configs.emplace_back();
+        grid.labels.emplace_back();
+    }
+
+    std::vector<std::byte> file;
+    if (!readFile(argv[1], file)) {
+        std::fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 2;
+    }
+    std::vector<shulib::diag::DebugRecord> ticks;
+    const shulib::diag::blackbox::ReadStatus status = shulib::sim::loadReplayTicks(file, ticks);
+    if (status != shulib::diag::blackbox::ReadStatus::Ok) {
+        std::fprintf(stderr, "%s: %s\n", argv[1], shulib::diag::blackbox::readStatusName(status));
+        return 2;
+    }
+    if (ticks.empty()) {
+        std::fprintf(stderr,
+                     "%s: no replayable ticks (record with SdSinkConfig::recordEstimatorInputs)\n",
+                     argv[1]);
+        return 2;
+    }
+
+    std::vector<shulib::sim::ReplayStats> stats;
+    try {
+        stats = shulib::sim::replayGrid(ticks, grid.configs, threads);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s: %s\n", argv[1], e.what());
+        return 2;
+    }
+    std::printf("%s: %zu replayable tick(s), %.2f s\n", argv[1], ticks.size(),
+                ticks.back().t.value() - ticks.front().t.value());
+    std::fputs(shulib::sim::formatReplayTable(grid, stats).c_str(), stdout);
+    return 0;
+}
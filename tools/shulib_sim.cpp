@@ -0,0 +1,108 @@
+// shulib_sim — run a text scenario file (sim/scenario_file.hpp) and print its summary.
+//
+//     shulib_sim <file.scn> [--threads N] [--seeds FIRST LAST] [--blackbox DIR]
+//
+// Every seed runs through the full closed loop on the host; the table goes to stdout.
+// --seeds overrides the file's range; --blackbox writes one streamed blackbox per seed
+// as DIR/<name>-seed<N>.bbx (readable by BlackboxReader, replayable by
+// sim/estimator_replay.hpp). Exit status: 0 when every verb of every seed settled, 1 when
+// any did not, 2 for a usage, parse or write error.
+//
+// Host-only, like everything it includes.
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shulib/sim/scenario_file.hpp"
+
+namespace {
+
+int usage() {
+    std::fprintf(stderr,
+                 "usage: shulib_sim <file.scn> [--threads N] [--seeds FIRST LAST] "
+                 "[--blackbox DIR]\n");
+    return 2;
+}
+
+bool parseCount(const char* text, unsigned long long& out) {
+    char* end = nullptr;
+    out = std::strtoull(text, &end, 10);
+    return end != text && *end == '\0';
+}
+
+bool writeFile(const std::string& path, const std::vector<std::byte>& bytes) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return usage();
+    }
+    shulib::sim::ScenarioSweepOptions options;
+    const char* blackboxDir = nullptr;
+    unsigned long long seedFirst = 0;
+    unsigned long long seedLast = 0;
+    bool seedOverride = false;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        unsigned long long n = 0;
+        if (arg == "--threads" && i + 1 < argc && parseCount(argv[i + 1], n)) {
+            options.threads = static_cast<unsigned>(n);
+            ++i;
+        } else if (arg == "--seeds" && i + 2 < argc && parseCount(argv[i + 1], seedFirst)
+                   && parseCount(argv[i + 2], seedLast) && seedFirst <= seedLast) {
+            seedOverride = true;
+            i += 2;
+        } else if (arg == "--blackbox" && i + 1 < argc) {
+            blackboxDir = argv[i + 1];
+            options.blackbox = true;
+            ++i;
+        } else {
+            return usage();
+        }
+    }
+
+    shulib::sim::ScenarioParseResult parsed = shulib::sim::loadScenarioFile(argv[1]);
+    if (!parsed.ok()) {
+        std::fprintf(stderr, "%s:%d: %s\n", argv[1], parsed.line, parsed.error.c_str());
+        return 2;
+    }
+    if (seedOverride) {
+        parsed.spec.seedFirst = seedFirst;
+        parsed.spec.seedLast = seedLast;
+    }
+
+    std::vector<shulib::sim::ScenarioRunResult> runs;
+    try {
+        runs = shulib::sim::runScenarioSweep(parsed.spec, options);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s: %s\n", argv[1], e.what());
+        return 2;
+    }
+    std::fputs(shulib::sim::formatScenarioSummary(parsed.spec, runs).c_str(), stdout);
+
+    bool allSettled = true;
+    for (const shulib::sim::ScenarioRunResult& r : runs) {
+        allSettled = allSettled && r.succeeded();
+        if (blackboxDir != nullptr) {
+            const std::string path = std::string{blackboxDir} + "/" + parsed.spec.name + "-seed"
+                                   + std::to_string(r.seed) + ".bbx";
+            if (!writeFile(path, r.blackbox)) {
+                std::fprintf(stderr, "cannot write %s\n", path.c_str());
+                return 2;
+            }
+        }
+    }
+    return allSettled ? 0 : 1;
+}
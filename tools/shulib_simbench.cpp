@@ -0,0 +1,143 @@
+// shulib_simbench — closed-loop sim throughput (sim/sim_bench.hpp), with a regression check.
+//
+//     shulib_simbench [--seeds N] [--case NAME] [--no-breakdown]
+//                     [--baseline FILE [--max-drop PCT]] [--write-baseline FILE]
+//
+// Runs the canonical cases (simBenchCases: clean, hostile, ekf-tags; --case picks one),
+// N seeds each (default 10), best of three passes, and prints ticks/s, allocations/tick
+// and the per-zone breakdown. --baseline checks the run against a stored baseline: a
+// throughput drop of more than PCT percent (default 20 — best-of-three still moves ~10%
+// run to run on a shared host) or any rise in allocations/tick fails it.
+// --write-baseline records this run as the new baseline. tools/simbench_baseline.txt is
+// the stored one; the `simbench-check` build target runs the check against it. Exit
+// status: 0 when the check holds (or none was asked), 1 on a regression, 2 for a usage
+// or file error.
+//
+// shulib_simbench_alloc.cpp beside it replaces the global operator new to count
+// allocations — the one thing a header cannot do; the target is built with
+// SHULIB_ENABLE_ZONES so the breakdown exists. Throughput means an optimized build:
+// tools/simbench_baseline.txt is recorded from CMAKE_BUILD_TYPE=Release, and
+// `simbench-check` compares like with like only in one. Host-only, like everything it
+// includes.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shulib/sim/sim_bench.hpp"
+
+namespace {
+
+int usage() {
+    std::fprintf(stderr,
+                 "usage: shulib_simbench [--seeds N] [--case NAME] [--no-breakdown]\n"
+                 "                       [--baseline FILE [--max-drop PCT]] "
+                 "[--write-baseline FILE]\n");
+    return 2;
+}
+
+bool readFile(const char* path, std::string& out) {
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        return false;
+    }
+    std::ostringstream text;
+    text << in.rdbuf();
+    out = text.str();
+    return true;
+}
+
+}  // namespace
+
+/// The process's allocation count (shulib_simbench_alloc.cpp, which owns operator new).
+std::uint64_t simbenchAllocationsSoFar();
+
+int main(int argc, char** argv) {
+    int seeds = 10;
+    std::string only;
+    bool breakdown = true;
+    const char* baselinePath = nullptr;
+    const char* writePath = nullptr;
+    double maxDrop = 20.0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        char* end = nullptr;
+        if (arg == "--seeds" && i + 1 < argc) {
+            const long n = std::strtol(argv[++i], &end, 10);
+            if (*end != '\0' || n < 1 || n > 1000) {
+                return usage();
+            }
+            seeds = static_cast<int>(n);
+        } else if (arg == "--case" && i + 1 < argc) {
+            only = argv[++i];
+        } else if (arg == "--no-breakdown") {
+            breakdown = false;
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (arg == "--max-drop" && i + 1 < argc) {
+            maxDrop = std::strtod(argv[++i], &end);
+            if (*end != '\0' || !(maxDrop >= 0.0 && maxDrop < 100.0)) {
+                return usage();
+            }
+        } else if (arg == "--write-baseline" && i + 1 < argc) {
+            writePath = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+
+    std::vector<shulib::sim::SimBenchBaselineEntry> baseline;
+    if (baselinePath != nullptr) {
+        std::string text;
+        std::string error;
+        if (!readFile(baselinePath, text)) {
+            std::fprintf(stderr, "cannot read %s\n", baselinePath);
+            return 2;
+        }
+        if (!shulib::sim::parseSimBenchBaseline(text, baseline, error)) {
+            std::fprintf(stderr, "%s: %s\n", baselinePath, error.c_str());
+            return 2;
+        }
+    }
+
+    shulib::sim::SimBenchOptions options;
+    options.allocations = &simbenchAllocationsSoFar;
+    options.breakdown = breakdown;
+    std::vector<shulib::sim::SimBenchResult> results;
+    for (const shulib::sim::ScenarioSpec& spec : shulib::sim::simBenchCases(seeds)) {
+        if (only.empty() || spec.name == only) {
+            results.push_back(shulib::sim::runSimBench(spec, options));
+        }
+    }
+    if (results.empty()) {
+        std::fprintf(stderr, "no case named '%s' (clean, hostile, ekf-tags)\n", only.c_str());
+        return 2;
+    }
+    std::fputs(shulib::sim::formatSimBench(results).c_str(), stdout);
+
+    if (writePath != nullptr) {
+        std::ofstream out{writePath, std::ios::binary};
+        out << shulib::sim::formatSimBenchBaseline(results);
+        if (!out) {
+            std::fprintf(stderr, "cannot write %s\n", writePath);
+            return 2;
+        }
+    }
+    if (baselinePath == nullptr) {
+        return 0;
+    }
+    const std::vector<std::string> regressions =
+        shulib::sim::checkSimBench(results, baseline, maxDrop);
+    for (const std::string& r : regressions) {
+        std::fprintf(stderr, "REGRESSION %s\n", r.c_str());
+    }
+    if (regressions.empty()) {
+        std::printf("\nbaseline %s: every case within %.1f%%\n", baselinePath, maxDrop);
+    }
+    return regressions.empty() ? 0 : 1;
+}
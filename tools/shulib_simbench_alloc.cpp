@@ -0,0 +1,38 @@
+// shulib_simbench's allocation counter: the global operator new/delete replacements that
+// count every allocation the benchmark's cases make.
+//
+// A translation unit of its own on purpose. With the replacements beside code that
+// allocates, GCC inlines both into one body at -O2 and flags the free() of a new'd
+// pointer (-Wmismatched-new-delete) — right for a mismatched pair, wrong for a matched
+// replacement. Here nothing allocates, so there is nothing to inline against, and the
+// benchmark builds at the optimization level its numbers are meant for.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+
+}  // namespace
+
+/// Allocations made so far by the whole process (declared in shulib_simbench.cpp).
+std::uint64_t simbenchAllocationsSoFar() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size != 0 ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc{};
+    }
+    return p;
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
@@ -0,0 +1,178 @@
+// shulib_simd — the headless sim server (sim/sim_server.hpp) on a Unix-domain socket.
+//
+//     shulib_simd <socket path> [--realtime K] [--scenario FILE.scn]
+//
+// Listens on <socket path>, takes one client at a time, and feeds it a SimServer: the
+// client writes command lines, the server answers and streams DebugRecords as SHUL/2
+// frames on the same socket. A stale socket at the path is replaced; any other existing
+// file is refused, so a mistyped `shulib_simd scenario.scn` cannot delete the scenario.
+// A client's disconnect or `quit` keeps the world for the next one; `shutdown` stops
+// the process. --realtime starts paced (sim time = K × wall time); --scenario takes the
+// first world's settings from a scenario file (its verbs are ignored — send them).
+// tools/shulib_simd_client.py is the reference client. Exit status: 0 after `shutdown`,
+// 2 for a usage, file or socket error.
+//
+// Host-only and POSIX-only, like the stand-in it is: the robot never runs this.
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "shulib/hal/char_sink.hpp"
+#include "shulib/sim/scenario_file.hpp"
+#include "shulib/sim/sim_server.hpp"
+
+namespace {
+
+int usage() {
+    std::fprintf(stderr, "usage: shulib_simd <socket path> [--realtime K] [--scenario FILE]\n");
+    return 2;
+}
+
+/// The connected socket as the server's byte sink. A failed send (the client went away)
+/// latches `broken`, and every later write is dropped: ICharSink::write must not throw.
+/// main() ignores SIGPIPE, so a send to a closed peer fails with EPIPE instead of killing
+/// the process — portably, where MSG_NOSIGNAL is Linux-only.
+class SocketSink final : public shulib::hal::ICharSink {
+public:
+    void attach(int fd) noexcept {
+        fd_ = fd;
+        broken_ = false;
+    }
+    [[nodiscard]] bool broken() const noexcept { return broken_; }
+
+    void write(std::string_view text) override {
+        while (!broken_ && !text.empty()) {
+            const ssize_t n = ::send(fd_, text.data(), text.size(), 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                broken_ = true;
+                return;
+            }
+            text.remove_prefix(static_cast<std::size_t>(n));
+        }
+    }
+
+private:
+    int fd_ = -1;
+    bool broken_ = true;
+};
+
+/// Serve one client until it leaves or asks to; true when it asked for `shutdown`.
+bool serve(int fd, shulib::sim::SimServer& server, SocketSink& sink) {
+    sink.attach(fd);
+    server.clientJoined();
+    std::string pending;
+    char buf[4096];
+    while (!sink.broken()) {
+        const ssize_t n = ::recv(fd, buf, sizeof buf, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        pending.append(buf, static_cast<std::size_t>(n));
+        std::size_t eol = 0;
+        while ((eol = pending.find('\n')) != std::string::npos) {
+            std::string line = pending.substr(0, eol);
+            pending.erase(0, eol + 1);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            const shulib::sim::SimServerStatus s = server.handle(line);
+            if (s == shulib::sim::SimServerStatus::Close) {
+                return false;
+            }
+            if (s == shulib::sim::SimServerStatus::Shutdown) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return usage();
+    }
+    const std::string path = argv[1];
+    shulib::sim::SimServerConfig config;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--realtime" && i + 1 < argc) {
+            char* end = nullptr;
+            config.realtime = std::strtod(argv[++i], &end);
+            if (*end != '\0' || !(config.realtime > 0.0)) {
+                return usage();
+            }
+        } else if (arg == "--scenario" && i + 1 < argc) {
+            const shulib::sim::ScenarioParseResult parsed =
+                shulib::sim::loadScenarioFile(argv[++i]);
+            if (!parsed.ok()) {
+                std::fprintf(stderr, "%s:%d: %s\n", argv[i], parsed.line, parsed.error.c_str());
+                return 2;
+            }
+            config.initial = parsed.spec;
+        } else {
+            return usage();
+        }
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof addr.sun_path) {
+        std::fprintf(stderr, "shulib_simd: socket path too long\n");
+        return 2;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    struct stat existing{};
+    if (::lstat(path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            std::fprintf(stderr, "shulib_simd: %s exists and is not a socket; not replacing it\n",
+                         path.c_str());
+            return 2;
+        }
+        ::unlink(path.c_str());  // a stale socket from an earlier run
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || ::bind(listener, reinterpret_cast<const sockaddr*>(&addr), sizeof addr) != 0
+        || ::listen(listener, 1) != 0) {
+        std::fprintf(stderr, "shulib_simd: %s: %s\n", path.c_str(), std::strerror(errno));
+        return 2;
+    }
+    std::fprintf(stderr, "shulib_simd: listening on %s\n", path.c_str());
+
+    SocketSink sink;
+    shulib::sim::SimServer server{sink, config};
+    bool shutdown = false;
+    while (!shutdown) {
+        const int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::fprintf(stderr, "shulib_simd: accept: %s\n", std::strerror(errno));
+            break;
+        }
+        shutdown = serve(fd, server, sink);
+        ::close(fd);
+    }
+    ::close(listener);
+    ::unlink(path.c_str());
+    return shutdown ? 0 : 2;
+}
@@ -0,0 +1,271 @@
+#!/usr/bin/env python3
+"""Reference client for shulib_simd, the headless sim server (sim/sim_server.hpp).
+
+WHY THIS EXISTS
+---------------
+The server answers on the SHUL/2 wire (diag/shul2_sink.hpp), not in text, so that a
+visualiser sees exactly what a robot's telemetry link would carry. That is only useful
+if a script can read it without linking C++; this is the decoder, in plain Python with
+no dependencies, and a small command line on top of it.
+
+It is a PORT, and the C++ headers stay the specification:
+  * framing  - COBS + 0x00, CRC-16/CCITT-FALSE (diag/shul2_sink.hpp);
+  * ticks    - TickKey carries the v1 tick verbatim, TickDelta the compact delta
+               (diag/blackbox_compact.hpp); a delta decodes only when its chain sequence
+               is exactly one past the last tick, otherwise it is refused until the next
+               keyframe - refuse, never misread;
+  * fields   - offsets of the v1 tick payload (diag/blackbox_format.hpp).
+Only the fields a plot usually wants are exposed on Tick; Tick.raw holds all 428 bytes.
+
+USAGE
+  python3 tools/shulib_simd_client.py SOCKET 'moveTo 24 0 0' 'turnTo 90'
+  python3 tools/shulib_simd_client.py SOCKET --csv 'step 100' > ticks.csv
+
+Each command's answer goes to stderr ("ok ..." / "error ..."); --csv writes one row per
+decoded tick (t, estimated pose, wheel voltages) to stdout. From a script:
+
+  with SimdClient(path) as sim:
+      answer, ticks = sim.command("moveTo 24 0 0")
+"""
+
+import socket
+import struct
+import sys
+
+WIRE_VERSION = 1
+TICK_KEY, TICK_DELTA, LOG = 1, 2, 3
+
+TICK_BYTES = 428
+WORD_BLOCK = 112          # compact_detail::kWordBlockOffset
+WORD_FIELDS = 5           # kCompactWordFields
+FLOAT_FIELDS = 51         # kCompactFloatFields
+FLOATS_BEFORE_WORDS = 14  # compact_detail::kFloatsBeforeWords
+
+
+def crc16_ccitt_false(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def float_offset(i):
+    if i < FLOATS_BEFORE_WORDS:
+        return 8 * i
+    return WORD_BLOCK + 4 * WORD_FIELDS + 8 * (i - FLOATS_BEFORE_WORDS)
+
+
+class _Bits:
+    """MSB-first bit reader (compact_detail::BitReader)."""
+
+    def __init__(self, data):
+        self.data, self.pos = data, 0
+
+    def read(self, n):
+        if self.pos + n > 8 * len(self.data):
+            raise ValueError("bitstream overrun")
+        v = 0
+        for _ in range(n):
+            byte = self.data[self.pos >> 3]
+            v = (v << 1) | ((byte >> (7 - (self.pos & 7))) & 1)
+            self.pos += 1
+        return v
+
+
+class Tick:
+    """One decoded tick: the fields a plot wants, and the v1 bytes for the rest."""
+
+    def __init__(self, raw):
+        self.raw = raw
+
+        def d(off):
+            return struct.unpack_from("<d", raw, off)[0]
+
+        self.t = d(0)
+        self.target = (d(16), d(24), d(32))
+        self.pose = (d(40), d(48), d(56))   # the ESTIMATE (measuredPose); truth is not streamed
+        self.commanded = (d(88), d(96), d(104))
+        self.wheel_count = raw[112]
+        self.command_id = struct.unpack_from("<I", raw, 116)[0]
+        self.fault = struct.unpack_from("<H", raw, 120)[0]
+        self.wheel_voltage = struct.unpack_from("<8d", raw, 132)  # the first wheel_count are live
+        self.imu_yaw = d(260)
+        self.battery_voltage = d(348)
+
+
+class TickChain:
+    """The compact tick chain (CompactTickDecoder)."""
+
+    def __init__(self):
+        self.ref, self.seq, self.chained = None, 0, False
+        self.lead, self.trail = [None] * FLOAT_FIELDS, [None] * FLOAT_FIELDS
+        self.unresolved = 0
+
+    def key(self, payload):
+        if len(payload) != 2 + TICK_BYTES:
+            self.chained = False
+            return None
+        self.seq = struct.unpack_from("<H", payload, 0)[0]
+        self.ref = bytearray(payload[2:])
+        self.lead, self.trail = [None] * FLOAT_FIELDS, [None] * FLOAT_FIELDS
+        self.chained = True
+        return Tick(bytes(self.ref))
+
+    def delta(self, payload):
+        seq = struct.unpack_from("<H", payload, 0)[0] if len(payload) >= 2 else None
+        if not self.chained or seq != (self.seq + 1) & 0xFFFF:
+            self.chained = False
+            self.unresolved += 1
+            return None
+        try:
+            nxt, lead, trail = self._apply(payload)
+        except ValueError:
+            self.chained = False
+            self.unresolved += 1
+            return None
+        self.ref, self.lead, self.trail, self.seq = nxt, lead, trail, seq
+        return Tick(bytes(self.ref))
+
+    def _apply(self, payload):
+        nxt, lead, trail = bytearray(self.ref), list(self.lead), list(self.trail)
+        pos = 2
+        for j in range(WORD_FIELDS):
+            z, shift = 0, 0
+            while True:
+                if pos >= len(payload) or shift > 28:
+                    raise ValueError("bad varint")
+                b = payload[pos]
+                pos += 1
+                z |= (b & 0x7F) << shift
+                shift += 7
+                if not b & 0x80:
+                    break
+            diff = (z >> 1) ^ (-(z & 1) & 0xFFFFFFFF)
+            off = WORD_BLOCK + 4 * j
+            was = struct.unpack_from("<I", nxt, off)[0]
+            struct.pack_into("<I", nxt, off, (was + diff) & 0xFFFFFFFF)
+        stream = payload[pos:]
+        bits = _Bits(stream)
+        for i in range(FLOAT_FIELDS):
+            if bits.read(1) == 0:
+                continue
+            if bits.read(1) == 0:
+                if lead[i] is None:
+                    raise ValueError("window reuse with no window")
+                x = bits.read(64 - lead[i] - trail[i]) << trail[i]
+            else:
+                ld = bits.read(5)
+                ln = bits.read(6) + 1
+                if ld + ln > 64:
+                    raise ValueError("bad window")
+                lead[i], trail[i] = ld, 64 - ld - ln
+                x = bits.read(ln) << trail[i]
+            off = float_offset(i)
+            was = struct.unpack_from("<Q", nxt, off)[0]
+            struct.pack_into("<Q", nxt, off, was ^ x)
+        if (bits.pos + 7) // 8 != len(stream):
+            raise ValueError("trailing bytes")
+        return nxt, lead, trail
+
+
+class SimdClient:
+    """A connection to shulib_simd. command() blocks until the server's answer."""
+
+    def __init__(self, path):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(path)
+        self.buf = bytearray()
+        self.chain = TickChain()
+        self.crc_errors = 0
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def close(self):
+        self.sock.close()
+
+    def frames(self):
+        """Yield (type, payload) for every intact frame, reading as needed."""
+        while True:
+            end = self.buf.find(0)
+            if end < 0:
+                chunk = self.sock.recv(65536)
+                if not chunk:
+                    return
+                self.buf += chunk
+                continue
+            enc = bytes(self.buf[:end])
+            del self.buf[:end + 1]
+            raw = cobs_decode(enc) if enc else None
+            if raw is None or len(raw) < 6:
+                continue
+            if crc16_ccitt_false(raw[:-2]) != struct.unpack_from("<H", raw, len(raw) - 2)[0]:
+                self.crc_errors += 1
+                continue
+            if raw[0] == WIRE_VERSION:
+                yield raw[1], raw[4:-2]
+
+    def command(self, line):
+        """Send one command; return (answer, ticks): the "simd" answer line ("ok ..." or
+        "error ..."; None if the server closed first) and every tick decoded meanwhile."""
+        self.sock.sendall(line.encode() + b"\n")
+        ticks = []
+        for kind, payload in self.frames():
+            if kind == TICK_KEY:
+                tick = self.chain.key(payload)
+            elif kind == TICK_DELTA:
+                tick = self.chain.delta(payload)
+            elif kind == LOG and len(payload) >= 2:
+                tag = payload[2:2 + payload[1]].decode(errors="replace")
+                if tag == "simd":
+                    return payload[2 + payload[1]:].decode(errors="replace"), ticks
+                continue
+            else:
+                continue
+            if tick is not None:
+                ticks.append(tick)
+        return None, ticks
+
+
+def main(argv):
+    args = argv[1:]
+    csv = "--csv" in args
+    args = [a for a in args if a != "--csv"]
+    if not args:
+        print(__doc__.split("USAGE")[1].split("Each")[0].rstrip(), file=sys.stderr)
+        return 2
+    with SimdClient(args[0]) as sim:
+        if csv:
+            print("t,x,y,heading," + ",".join(f"v{i}" for i in range(8)))
+        failed = False
+        for line in args[1:]:
+            answer, ticks = sim.command(line)
+            print(answer if answer is not None else "closed", file=sys.stderr)
+            failed = failed or answer is None or answer.startswith("error")
+            if csv:
+                for k in ticks:
+                    print(",".join(f"{v:.6g}" for v in (k.t, *k.pose, *k.wheel_voltage)))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))